@@ -0,0 +1,1164 @@
+// main.cpp                                                          -*-C++-*-
+//
+// 'sjt_bench' runs repeatable micro-benchmarks of the interpreter, the
+// engine, and the utilities around them, and reports for each the time, the
+// number of allocations, and the number of bytes allocated per operation.
+//
+// Usage: sjt_bench [--json] [--iterations N] [--min-time-ms N]
+//                  [--repetitions N] [FILTER]
+//
+// Only the benchmarks whose names contain 'FILTER' are run.  Unless
+// '--iterations' is given, the number of iterations of each benchmark is
+// calibrated so that one repetition takes at least '--min-time-ms'
+// milliseconds (100 by default); the benchmark is then run
+// '--repetitions' times (5 by default), and the fastest and the median
+// repetitions are reported.  Allocations are counted by an allocator that is
+// both the default allocator and the allocator given to the objects under
+// test, and are those of the last repetition.  '--json' writes the results
+// as a JSON object instead of a table.
+
+#include <sjtm_engine.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_executionarena.h>
+#include <sjtt_executioncontext.h>
+#include <sjtt_object.h>
+#include <sjtt_program.h>
+#include <sjtt_propertycache.h>
+#include <sjtt_shape.h>
+#include <sjtt_typefeedback.h>
+#include <sjtu_bindutil.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_interpretutil.h>
+#include <sjtu_registercode.h>
+#include <sjtu_verifyutil.h>
+
+#include <bdld_datum.h>
+#include <bdlma_localsequentialallocator.h>
+#include <bdlma_sequentialallocator.h>
+
+#include <bslma_allocator.h>
+#include <bslma_default.h>
+#include <bslma_newdeleteallocator.h>
+
+#include <bsls_timeutil.h>
+#include <bsls_types.h>
+
+#include <bslstl_stringref.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_cstdlib.h>
+#include <bsl_cstring.h>
+#include <bsl_iomanip.h>
+#include <bsl_iostream.h>
+#include <bsl_sstream.h>
+#include <bsl_string.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+
+namespace {
+
+typedef bsls::Types::Int64 Int64;
+
+using sjtt::Bytecode;
+using sjtu::InterpretUtil;
+
+volatile double g_sink;  // defeats the elimination of unused results
+
+                          // =======================
+                          // class CountingAllocator
+                          // =======================
+
+class CountingAllocator : public bslma::Allocator {
+    // This class provides an allocator counting the allocations it forwards
+    // to another allocator, and the number of bytes they request.
+
+    // DATA
+    bslma::Allocator *d_upstream_p;      // supplies memory (held)
+    Int64             d_numAllocations;  // allocations so far
+    Int64             d_numBytes;        // bytes requested so far
+
+  public:
+    // CREATORS
+    explicit CountingAllocator(bslma::Allocator *upstream)
+    : d_upstream_p(upstream)
+    , d_numAllocations(0)
+    , d_numBytes(0) {
+    }
+        // Create an allocator obtaining memory from the specified 'upstream'
+        // allocator.
+
+    // MANIPULATORS
+    void *allocate(size_type size) {
+        ++d_numAllocations;
+        d_numBytes += size;
+        return d_upstream_p->allocate(size);
+    }
+        // Return memory of the specified 'size' obtained from the upstream
+        // allocator, and count it.
+
+    void deallocate(void *address) {
+        d_upstream_p->deallocate(address);
+    }
+        // Return the memory at the specified 'address' to the upstream
+        // allocator.
+
+    // ACCESSORS
+    Int64 numAllocations() const { return d_numAllocations; }
+        // Return the number of allocations made so far.
+
+    Int64 numBytes() const { return d_numBytes; }
+        // Return the number of bytes requested so far.
+};
+
+                              // ===============
+                              // class Benchmark
+                              // ===============
+
+class Benchmark {
+    // This protocol provides an operation to measure.  State that is not
+    // part of the operation is prepared when a benchmark is created.
+
+  public:
+    // CREATORS
+    virtual ~Benchmark() {}
+        // Destroy this object.
+
+    // MANIPULATORS
+    virtual void run(Int64 numIterations) = 0;
+        // Perform the measured operation the specified 'numIterations' times.
+
+    // ACCESSORS
+    virtual Int64 opsPerIteration() const { return 1; }
+        // Return the number of operations reported for one iteration, e.g.,
+        // the number of instructions interpreted.
+};
+
+                               // ============
+                               // class Runner
+                               // ============
+
+class Runner {
+    // This class provides a mechanism running benchmarks as described at the
+    // top of this file, and reporting their results.
+
+    struct Result {
+        bsl::string d_name;
+        Int64       d_numIterations;  // iterations in a repetition
+        Int64       d_numOps;         // operations in a repetition
+        double      d_bestNsPerOp;    // fastest repetition
+        double      d_medianNsPerOp;  // median repetition
+        double      d_allocsPerOp;    // allocations, last repetition
+        double      d_bytesPerOp;     // bytes requested, last repetition
+    };
+
+    // DATA
+    CountingAllocator   *d_allocator_p;     // counts allocations (held)
+    bsl::string          d_filter;          // substring of the names to run
+    Int64                d_numIterations;   // fixed iterations, or 0
+    Int64                d_minTime;         // nanoseconds, if calibrating
+    int                  d_numRepetitions;  // repetitions measured
+    bsl::vector<Result>  d_results;
+
+  public:
+    // CREATORS
+    Runner(CountingAllocator        *allocator,
+           const bsl::string&        filter,
+           Int64                     numIterations,
+           Int64                     minTime,
+           int                       numRepetitions)
+    : d_allocator_p(allocator)
+    , d_filter(filter)
+    , d_numIterations(numIterations)
+    , d_minTime(minTime)
+    , d_numRepetitions(numRepetitions) {
+    }
+        // Create a runner of the benchmarks whose names contain the
+        // specified 'filter', counting allocations with the specified
+        // 'allocator', running each the specified 'numIterations' times per
+        // repetition, or, if 'numIterations' is 0, as many times as take the
+        // specified 'minTime' nanoseconds, and measuring the specified
+        // 'numRepetitions' repetitions.
+
+    // MANIPULATORS
+    bool isSelected(const bsl::string& name) const {
+        return bsl::string::npos != name.find(d_filter);
+    }
+        // Return 'true' if the benchmark having the specified 'name' is to be
+        // run, and 'false' otherwise.
+
+    void run(const bsl::string& name, Benchmark *benchmark);
+        // Run the specified 'benchmark' under the specified 'name' if it is
+        // selected, and record its result.
+
+    // ACCESSORS
+    void printTable(bsl::ostream& stream) const;
+        // Write the results to the specified 'stream' as a table.
+
+    void printJson(bsl::ostream& stream) const;
+        // Write the results to the specified 'stream' as a JSON object having
+        // a "benchmarks" array.
+};
+
+void Runner::run(const bsl::string& name, Benchmark *benchmark)
+{
+    if (!isSelected(name)) {
+        return;                                                       // RETURN
+    }
+
+    Int64 numIterations = d_numIterations;
+    if (0 == numIterations) {
+        numIterations = 1;
+        while (true) {
+            const Int64 start = bsls::TimeUtil::getTimer();
+            benchmark->run(numIterations);
+            const Int64 elapsed = bsls::TimeUtil::getTimer() - start;
+            if (elapsed >= d_minTime || numIterations >= (Int64(1) << 40)) {
+                break;
+            }
+            // Aim 20% past the minimum, growing by at most 100 times.
+
+            Int64 next = elapsed
+                       ? Int64(1.2 * numIterations * d_minTime / elapsed)
+                       : numIterations * 100;
+            next = bsl::min(next, numIterations * 100);
+            numIterations = bsl::max(next, numIterations + 1);
+        }
+    }
+    else {
+        benchmark->run(numIterations);                             // warm up
+    }
+
+    const Int64         numOps = numIterations * benchmark->opsPerIteration();
+    bsl::vector<double> nsPerOp;
+    Int64               numAllocations = 0;
+    Int64               numBytes       = 0;
+    for (int i = 0; i < d_numRepetitions; ++i) {
+        const Int64 allocations = d_allocator_p->numAllocations();
+        const Int64 bytes       = d_allocator_p->numBytes();
+        const Int64 start       = bsls::TimeUtil::getTimer();
+        benchmark->run(numIterations);
+        const Int64 elapsed     = bsls::TimeUtil::getTimer() - start;
+        numAllocations = d_allocator_p->numAllocations() - allocations;
+        numBytes       = d_allocator_p->numBytes() - bytes;
+        nsPerOp.push_back(static_cast<double>(elapsed) / numOps);
+    }
+    bsl::sort(nsPerOp.begin(), nsPerOp.end());
+
+    Result result;
+    result.d_name          = name;
+    result.d_numIterations = numIterations;
+    result.d_numOps        = numOps;
+    result.d_bestNsPerOp   = nsPerOp.front();
+    result.d_medianNsPerOp = nsPerOp[nsPerOp.size() / 2];
+    result.d_allocsPerOp   = static_cast<double>(numAllocations) / numOps;
+    result.d_bytesPerOp    = static_cast<double>(numBytes) / numOps;
+    d_results.push_back(result);
+}
+
+void Runner::printTable(bsl::ostream& stream) const
+{
+    stream << bsl::left << bsl::setw(36) << "benchmark"
+           << bsl::right << bsl::setw(12) << "iterations"
+           << bsl::setw(10) << "ns/op"
+           << bsl::setw(10) << "median"
+           << bsl::setw(11) << "allocs/op"
+           << bsl::setw(11) << "bytes/op" << '\n';
+    for (bsl::size_t i = 0; i < d_results.size(); ++i) {
+        const Result& result = d_results[i];
+        stream << bsl::left << bsl::setw(36) << result.d_name
+               << bsl::right << bsl::setw(12) << result.d_numIterations
+               << bsl::fixed << bsl::setprecision(2)
+               << bsl::setw(10) << result.d_bestNsPerOp
+               << bsl::setw(10) << result.d_medianNsPerOp
+               << bsl::setprecision(3)
+               << bsl::setw(11) << result.d_allocsPerOp
+               << bsl::setprecision(1)
+               << bsl::setw(11) << result.d_bytesPerOp << '\n';
+    }
+}
+
+void Runner::printJson(bsl::ostream& stream) const
+{
+    // The names are plain ASCII without quotes, so they need no escaping.
+
+    stream << "{\"repetitions\":" << d_numRepetitions << ",\"benchmarks\":[";
+    for (bsl::size_t i = 0; i < d_results.size(); ++i) {
+        const Result& result = d_results[i];
+        stream << (i ? "," : "") << "\n{\"name\":\"" << result.d_name
+               << "\",\"iterations\":" << result.d_numIterations
+               << ",\"ops\":" << result.d_numOps
+               << ",\"ns_per_op\":" << result.d_bestNsPerOp
+               << ",\"median_ns_per_op\":" << result.d_medianNsPerOp
+               << ",\"allocs_per_op\":" << result.d_allocsPerOp
+               << ",\"bytes_per_op\":" << result.d_bytesPerOp << '}';
+    }
+    stream << "\n]}\n";
+}
+
+                        // ==========================
+                        // class InterpreterBenchmark
+                        // ==========================
+
+class InterpreterBenchmark : public Benchmark {
+    // This class measures the dispatch of the interpreter on a synthetic
+    // program, reporting one operation per 'Bytecode' instruction of the
+    // program, also when it is run in its register form.
+
+  public:
+    // TYPES
+    enum Shape {
+        e_AddChain,      // 'Push', then pairs of 'Push' and 'AddDoubles'
+        e_FusedChain,    // 'Push', then 'PushAddDoubles'
+        e_PushPop,       // 'Push', then pairs of 'Push' and 'Pop'
+        e_IntegerChain   // 'Push', then pairs of 'Push' and 'AddIntegers'
+    };
+
+    enum Form {
+        e_Bytecode,      // array of 'Bytecode' objects, growable stack
+        e_Program,       // packed 'Program', growable stack
+        e_Verified,      // array of 'Bytecode' objects, reserved stack
+        e_Register       // translated to 'sjtu::RegisterCode'
+    };
+
+  private:
+    // DATA
+    bsl::vector<Bytecode>   d_code;
+    sjtt::Program           d_program;
+    sjtu::RegisterCode      d_registers;
+    sjtt::TypeFeedback      d_feedback;
+    bsl::size_t             d_maxDepth;
+    Form                    d_form;
+    bsl::vector<bdld::Datum> d_stack;
+    sjtt::ExecutionContext  d_context;
+
+  public:
+    // CREATORS
+    InterpreterBenchmark(Shape              shape,
+                         int                length,
+                         Form               form,
+                         bslma::Allocator  *allocator)
+    : d_code(allocator)
+    , d_program(allocator)
+    , d_registers(allocator)
+    , d_maxDepth(0)
+    , d_form(form)
+    , d_stack(allocator)
+    , d_context(allocator, &d_stack) {
+        const bool        INT  = e_IntegerChain == shape;
+        const bdld::Datum ONE  = INT ? bdld::Datum::createInteger(1)
+                                     : bdld::Datum::createDouble(1);
+        const bdld::Datum ZERO = INT ? bdld::Datum::createInteger(0)
+                                     : bdld::Datum::createDouble(0);
+        d_code.push_back(Bytecode::createPush(ZERO));
+        for (int i = 0; i < length; ++i) {
+            switch (shape) {
+              case e_AddChain: {
+                d_code.push_back(Bytecode::createPush(ONE));
+                d_code.push_back(
+                             Bytecode::createOpcode(Bytecode::e_AddDoubles));
+              } break;
+              case e_FusedChain: {
+                d_code.push_back(Bytecode::create(Bytecode::e_PushAddDoubles,
+                                                  ONE));
+              } break;
+              case e_PushPop: {
+                d_code.push_back(Bytecode::createPush(ONE));
+                d_code.push_back(Bytecode::createOpcode(Bytecode::e_Pop));
+              } break;
+              case e_IntegerChain: {
+                d_code.push_back(Bytecode::createPush(ONE));
+                d_code.push_back(Bytecode::create(
+                            Bytecode::e_AddIntegers,
+                            sjtu::DatumUtil::createTypeFeedback(&d_feedback)));
+              } break;
+            }
+        }
+        d_code.push_back(Bytecode::createOpcode(Bytecode::e_Return));
+
+        sjtt::ProgramBuilder builder(allocator);
+        builder.append(d_code.data(), d_code.size());
+        builder.build(&d_program);
+
+        bsl::size_t errorIndex = 0;
+        sjtu::VerifyUtil::verify(&d_maxDepth,
+                                 &errorIndex,
+                                 d_code.data(),
+                                 d_code.size());
+        d_registers.translate(d_code.data());
+    }
+        // Create a benchmark interpreting the program having the specified
+        // 'shape' and 'length' in the specified 'form', using the specified
+        // 'allocator' to supply memory.
+
+    // MANIPULATORS
+    void run(Int64 numIterations) {
+        bdld::Datum result;
+        for (Int64 i = 0; i < numIterations; ++i) {
+            switch (d_form) {
+              case e_Bytecode: {
+                InterpretUtil::interpret(&result, &d_context, d_code.data());
+              } break;
+              case e_Program: {
+                InterpretUtil::interpret(&result, &d_context, d_program);
+              } break;
+              case e_Verified: {
+                InterpretUtil::interpret(&result,
+                                         &d_context,
+                                         d_code.data(),
+                                         d_maxDepth);
+              } break;
+              case e_Register: {
+                d_registers.execute(&result, &d_context);
+              } break;
+            }
+        }
+        g_sink = result.isInteger() ? result.theInteger()
+                                    : result.theDouble();
+    }
+
+    // ACCESSORS
+    Int64 opsPerIteration() const { return d_code.size(); }
+};
+
+                          // =====================
+                          // class GlobalBenchmark
+                          // =====================
+
+class GlobalBenchmark : public Benchmark {
+    // This class measures the access of an engine to its globals, cycling
+    // through a number of keys.
+
+  public:
+    // TYPES
+    enum Mode {
+        e_GetByName,  // 'findGlobalSlot', then 'getGlobal'
+        e_GetBySlot,  // 'getGlobal' with a slot found beforehand
+        e_SetByName,  // 'setGlobal' with a name
+        e_SetBySlot   // 'setGlobal' with a slot found beforehand
+    };
+
+  private:
+    // DATA
+    sjtm::Engine             d_engine;
+    bsl::vector<bsl::string> d_names;
+    bsl::vector<int>         d_slots;
+    Mode                     d_mode;
+
+  public:
+    // CREATORS
+    GlobalBenchmark(int numKeys, Mode mode, bslma::Allocator *allocator)
+    : d_engine(allocator)
+    , d_names(allocator)
+    , d_slots(allocator)
+    , d_mode(mode) {
+        for (int i = 0; i < numKeys; ++i) {
+            bsl::ostringstream name;
+            name << "global" << i;
+            d_names.push_back(name.str());
+            d_engine.setGlobal(d_names.back(), bdld::Datum::createDouble(i));
+            d_slots.push_back(d_engine.findGlobalSlot(d_names.back()));
+        }
+    }
+        // Create a benchmark accessing the specified 'numKeys' globals, which
+        // must be a power of 2, in the specified 'mode', using the specified
+        // 'allocator' to supply memory.
+
+    // MANIPULATORS
+    void run(Int64 numIterations) {
+        const bsl::size_t mask = d_names.size() - 1;
+        double            sum  = 0;
+        for (Int64 i = 0; i < numIterations; ++i) {
+            const bsl::size_t key = static_cast<bsl::size_t>(i) & mask;
+            switch (d_mode) {
+              case e_GetByName: {
+                const int slot = d_engine.findGlobalSlot(d_names[key]);
+                sum += d_engine.getGlobal(slot).theDouble();
+              } break;
+              case e_GetBySlot: {
+                sum += d_engine.getGlobal(d_slots[key]).theDouble();
+              } break;
+              case e_SetByName: {
+                d_engine.setGlobal(d_names[key],
+                                   bdld::Datum::createDouble(double(i)));
+              } break;
+              case e_SetBySlot: {
+                d_engine.setGlobal(d_slots[key],
+                                   bdld::Datum::createDouble(double(i)));
+              } break;
+            }
+        }
+        g_sink = sum;
+    }
+};
+
+                           // ====================
+                           // class StackBenchmark
+                           // ====================
+
+class StackBenchmark : public Benchmark {
+    // This class measures the growth of the stack of an 'ExecutionContext'
+    // by a program pushing a number of values before adding them up.
+
+  public:
+    // TYPES
+    enum Mode {
+        e_Fresh,     // new stack for each run, growing as needed
+        e_Reused,    // one stack for all runs, keeping its capacity
+        e_Reserved   // new stack for each run, reserved from 'VerifyUtil'
+    };
+
+  private:
+    // DATA
+    bsl::vector<Bytecode>     d_code;
+    bsl::size_t               d_maxDepth;
+    Mode                      d_mode;
+    bslma::Allocator         *d_allocator_p;  // held
+    bsl::vector<bdld::Datum>  d_stack;        // used if 'e_Reused'
+
+  public:
+    // CREATORS
+    StackBenchmark(int depth, Mode mode, bslma::Allocator *allocator)
+    : d_code(allocator)
+    , d_maxDepth(0)
+    , d_mode(mode)
+    , d_allocator_p(allocator)
+    , d_stack(allocator) {
+        for (int i = 0; i < depth; ++i) {
+            d_code.push_back(
+                         Bytecode::createPush(bdld::Datum::createDouble(i)));
+        }
+        for (int i = 1; i < depth; ++i) {
+            d_code.push_back(Bytecode::createOpcode(Bytecode::e_AddDoubles));
+        }
+        d_code.push_back(Bytecode::createOpcode(Bytecode::e_Return));
+
+        bsl::size_t errorIndex = 0;
+        sjtu::VerifyUtil::verify(&d_maxDepth,
+                                 &errorIndex,
+                                 d_code.data(),
+                                 d_code.size());
+    }
+        // Create a benchmark of a program reaching the specified 'depth' in
+        // the specified 'mode', using the specified 'allocator' to supply
+        // memory.
+
+    // MANIPULATORS
+    void run(Int64 numIterations) {
+        bdld::Datum result;
+        for (Int64 i = 0; i < numIterations; ++i) {
+            if (e_Reused == d_mode) {
+                sjtt::ExecutionContext context(d_allocator_p, &d_stack);
+                InterpretUtil::interpret(&result, &context, d_code.data());
+                continue;                                           // CONTINUE
+            }
+            bsl::vector<bdld::Datum> stack(d_allocator_p);
+            sjtt::ExecutionContext   context(d_allocator_p, &stack);
+            if (e_Reserved == d_mode) {
+                InterpretUtil::interpret(&result,
+                                         &context,
+                                         d_code.data(),
+                                         d_maxDepth);
+            }
+            else {
+                InterpretUtil::interpret(&result, &context, d_code.data());
+            }
+        }
+        g_sink = result.isInteger() ? result.theInteger()
+                                    : result.theDouble();
+    }
+};
+
+                          // ======================
+                          // class MarshalBenchmark
+                          // ======================
+
+double scale(double value, int factor)
+    // Return the specified 'value' multiplied by the specified 'factor'.
+{
+    return value * factor;
+}
+
+bslstl::StringRef identity(bslstl::StringRef value)
+    // Return the specified 'value'.
+{
+    return value;
+}
+
+void square(const double *input, double *output, bsl::size_t length)
+    // Load the squares of the specified 'length' elements of 'input' into
+    // the specified 'output'.
+{
+    for (bsl::size_t i = 0; i < length; ++i) {
+        output[i] = input[i] * input[i];
+    }
+}
+
+void nothing(sjtt::ExecutionContext *)
+    // Do nothing.
+{
+}
+
+class MarshalBenchmark : public Benchmark {
+    // This class measures the boxing of external functions into 'Datum'
+    // objects and the marshalling of the arguments and results of functions
+    // bound by 'BindUtil'.
+
+  public:
+    // TYPES
+    enum Mode {
+        e_Box,       // 'DatumUtil::createExternalFunction' and back
+        e_Numbers,   // call 'double(double, int)'
+        e_String,    // call 'StringRef(StringRef)', copying the result
+        e_Batch      // call a kernel on an array of 64 doubles
+    };
+
+  private:
+    // PRIVATE TYPES
+    typedef sjtu::DatumUtil::ExternalFunction ExternalFunction;
+
+    // DATA
+    Mode                      d_mode;
+    ExternalFunction volatile d_function;  // boxed if 'e_Box'; 'volatile'
+                                           // so that it is read every time
+    bsl::vector<Bytecode>     d_code;
+    sjtt::ExecutionArena      d_arena;
+    sjtt::ExecutionContext    d_context;
+    bsl::vector<bdld::Datum>  d_elements;
+
+  public:
+    // CREATORS
+    MarshalBenchmark(Mode mode, bslma::Allocator *allocator)
+    : d_mode(mode)
+    , d_function(&nothing)
+    , d_code(allocator)
+    , d_arena(allocator)
+    , d_context(&d_arena)
+    , d_elements(allocator) {
+        switch (mode) {
+          case e_Box: {
+          } break;
+          case e_Numbers: {
+            d_code.push_back(
+                         Bytecode::createPush(bdld::Datum::createDouble(2)));
+            d_code.push_back(
+                        Bytecode::createPush(bdld::Datum::createInteger(3)));
+            d_code.push_back(Bytecode::createPush(
+                 sjtu::BindUtil::bind<double(double, int), &scale>()));
+          } break;
+          case e_String: {
+            d_code.push_back(Bytecode::createPush(
+                    bdld::Datum::createStringRef(
+                        "a string too long to be stored inside a Datum",
+                        allocator)));
+            d_code.push_back(Bytecode::createPush(
+                 sjtu::BindUtil::bind<
+                     bslstl::StringRef(bslstl::StringRef),
+                     &identity>()));
+          } break;
+          case e_Batch: {
+            for (int i = 0; i < 64; ++i) {
+                d_elements.push_back(bdld::Datum::createDouble(i));
+            }
+            d_code.push_back(Bytecode::createPush(
+                    bdld::Datum::createArrayReference(d_elements.data(),
+                                                      d_elements.size(),
+                                                      allocator)));
+            d_code.push_back(Bytecode::createPush(
+                                  sjtu::BindUtil::bindBatch<&square>()));
+          } break;
+        }
+        d_code.push_back(Bytecode::createOpcode(Bytecode::e_Execute));
+        d_code.push_back(Bytecode::createOpcode(Bytecode::e_Return));
+    }
+        // Create a benchmark of the specified 'mode', using the specified
+        // 'allocator' to supply memory.
+
+    // MANIPULATORS
+    void run(Int64 numIterations) {
+        if (e_Box == d_mode) {
+            bsl::size_t count = 0;
+            for (Int64 i = 0; i < numIterations; ++i) {
+                using sjtu::DatumUtil;
+
+                const ExternalFunction function = d_function;
+                const bdld::Datum      boxed    =
+                                   DatumUtil::createExternalFunction(function);
+                count += DatumUtil::isExternalFunction(boxed)
+                      && function == DatumUtil::theExternalFunction(boxed);
+            }
+            g_sink = static_cast<double>(count);
+            return;                                                   // RETURN
+        }
+        bdld::Datum result;
+        int         status = 0;
+        for (Int64 i = 0; i < numIterations; ++i) {
+            status |= InterpretUtil::interpret(&result,
+                                               &d_context,
+                                               d_code.data());
+            d_arena.rewind();
+        }
+        g_sink = status;
+    }
+};
+
+                            // ===================
+                            // class CallBenchmark
+                            // ===================
+
+class CallBenchmark : public Benchmark {
+    // This class measures the calls of a function bound by 'BindUtil' made
+    // by a program holding a number of values below their arguments,
+    // reporting the time of each call.  Those values are copied to the
+    // stack of the context by the first call only, so that the depth adds
+    // to the time of each call only the cost of pushing and copying them
+    // once, spread over all the calls.
+
+    // DATA
+    bsl::vector<Bytecode>  d_code;
+    sjtt::ExecutionArena   d_arena;
+    sjtt::ExecutionContext d_context;
+
+  public:
+    // TYPES
+    enum { k_NUM_CALLS = 1024 };
+
+    // CREATORS
+    CallBenchmark(int depth, bslma::Allocator *allocator)
+    : d_code(allocator)
+    , d_arena(allocator)
+    , d_context(&d_arena) {
+        for (int i = 0; i < depth; ++i) {
+            d_code.push_back(
+                         Bytecode::createPush(bdld::Datum::createDouble(i)));
+        }
+        for (int i = 0; i < k_NUM_CALLS; ++i) {
+            d_code.push_back(
+                        Bytecode::createPush(bdld::Datum::createInteger(1)));
+            d_code.push_back(Bytecode::createPush(
+                 sjtu::BindUtil::bind<double(double, int), &scale>()));
+            d_code.push_back(Bytecode::createOpcode(Bytecode::e_Execute));
+        }
+        d_code.push_back(Bytecode::createOpcode(Bytecode::e_Return));
+    }
+        // Create a benchmark of a program holding the specified 'depth'
+        // values, using the specified 'allocator' to supply memory.
+
+    // MANIPULATORS
+    void run(Int64 numIterations) {
+        bdld::Datum result;
+        int         status = 0;
+        for (Int64 i = 0; i < numIterations; ++i) {
+            status |= InterpretUtil::interpret(&result,
+                                               &d_context,
+                                               d_code.data());
+            d_arena.rewind();
+        }
+        g_sink = status;
+    }
+
+    // ACCESSORS
+    Int64 opsPerIteration() const {
+        return k_NUM_CALLS;
+    }
+};
+
+                           // ====================
+                           // class ChurnBenchmark
+                           // ====================
+
+class ChurnBenchmark : public Benchmark {
+    // This class measures the allocation of the short-lived values a script
+    // creates, an array of strings, from different allocators, reporting
+    // the allocations that reach the upstream allocator.
+
+  public:
+    // TYPES
+    enum Mode {
+        e_Default,     // counting allocator itself, freeing each value
+        e_Sequential,  // 'bdlma::SequentialAllocator', released
+        e_Local,       // 'bdlma::LocalSequentialAllocator', released
+        e_Arena        // 'sjtt::ExecutionArena', rewound
+    };
+
+  private:
+    // PRIVATE CONSTANTS
+    enum { k_NUM_STRINGS = 8 };
+
+    // DATA
+    Mode                                d_mode;
+    bslma::Allocator                   *d_allocator_p;  // held
+    bdlma::SequentialAllocator          d_sequential;
+    bdlma::LocalSequentialAllocator<4096>
+                                        d_local;
+    sjtt::ExecutionArena                d_arena;
+
+    // PRIVATE MANIPULATORS
+    double churn(bslma::Allocator *allocator) {
+        static const char TEXT[] =
+                          "a string too long to be stored inside a Datum";
+        bdld::DatumMutableArrayRef array;
+        bdld::Datum::createUninitializedArray(&array,
+                                              k_NUM_STRINGS,
+                                              allocator);
+        for (int i = 0; i < k_NUM_STRINGS; ++i) {
+            array.data()[i] = bdld::Datum::copyString(TEXT,
+                                                      sizeof TEXT - 1 - i,
+                                                      allocator);
+        }
+        *array.length() = k_NUM_STRINGS;
+        const bdld::Datum value  = bdld::Datum::adoptArray(array);
+        const double      length = value.theArray()[k_NUM_STRINGS - 1]
+                                                       .theString().length();
+        if (e_Default == d_mode) {
+            bdld::Datum::destroy(value, allocator);
+        }
+        return length;
+    }
+        // Create an array of strings using the specified 'allocator', free
+        // it if the mode is 'e_Default', and return the length of its last
+        // element.
+
+  public:
+    // CREATORS
+    ChurnBenchmark(Mode mode, bslma::Allocator *allocator)
+    : d_mode(mode)
+    , d_allocator_p(allocator)
+    , d_sequential(allocator)
+    , d_local(allocator)
+    , d_arena(allocator) {
+    }
+        // Create a benchmark of the specified 'mode' obtaining memory from
+        // the specified 'allocator'.
+
+    // MANIPULATORS
+    void run(Int64 numIterations) {
+        double sum = 0;
+        for (Int64 i = 0; i < numIterations; ++i) {
+            switch (d_mode) {
+              case e_Default: {
+                sum += churn(d_allocator_p);
+              } break;
+              case e_Sequential: {
+                sum += churn(&d_sequential);
+                d_sequential.release();
+              } break;
+              case e_Local: {
+                sum += churn(&d_local);
+                d_local.release();
+              } break;
+              case e_Arena: {
+                sum += churn(d_arena.allocator());
+                d_arena.rewind();
+              } break;
+            }
+        }
+        g_sink = sum;
+    }
+};
+
+                          // =======================
+                          // class PropertyBenchmark
+                          // =======================
+
+class PropertyBenchmark : public Benchmark {
+    // This class measures the reads of the properties of an object by a
+    // program summing all of them, reporting one operation per property
+    // read, either through warm property caches, or through megamorphic
+    // caches, which look each property up by name in the shape of the
+    // object.
+
+  public:
+    // TYPES
+    enum Mode {
+        e_Cached,      // caches holding the shape of the object
+        e_Megamorphic  // caches that have seen too many shapes
+    };
+
+  private:
+    // DATA
+    sjtt::ShapeTable                   d_shapes;
+    sjtt::Object                      *d_object_p;  // owned
+    bsl::vector<sjtt::PropertyCache *> d_caches;    // owned
+    bsl::vector<Bytecode>              d_code;
+    bsl::vector<bdld::Datum>           d_stack;
+    sjtt::ExecutionContext             d_context;
+    bslma::Allocator                  *d_allocator_p;  // held
+
+  public:
+    // CREATORS
+    PropertyBenchmark(int               numProperties,
+                      Mode              mode,
+                      bslma::Allocator *allocator)
+    : d_shapes(allocator)
+    , d_object_p(sjtt::Object::create(d_shapes.root(), allocator))
+    , d_caches(allocator)
+    , d_code(allocator)
+    , d_stack(allocator)
+    , d_context(allocator, &d_stack)
+    , d_allocator_p(allocator) {
+        d_context.setShapes(&d_shapes);
+        const bdld::Datum object = sjtu::DatumUtil::createObject(d_object_p);
+        d_code.push_back(Bytecode::createPush(bdld::Datum::createDouble(0)));
+        for (int i = 0; i < numProperties; ++i) {
+            bsl::ostringstream name;
+            name << "property" << i;
+            d_object_p->set(&d_shapes,
+                            name.str(),
+                            bdld::Datum::createDouble(i),
+                            allocator);
+
+            d_caches.reserve(d_caches.size() + 1);
+            d_caches.push_back(new (*allocator) sjtt::PropertyCache(
+                                                                  name.str(),
+                                                                  allocator));
+            if (e_Megamorphic == mode) {
+                // Shape identifiers are positive, so that these are never
+                // those of an object.
+
+                const int numShapes = sjtt::PropertyCache::k_MAX_ENTRIES + 1;
+                for (int j = 1; j <= numShapes; ++j) {
+                    d_caches.back()->insert(-j, -1);
+                }
+            }
+            d_code.push_back(Bytecode::createPush(object));
+            d_code.push_back(Bytecode::create(
+                       Bytecode::e_GetProperty,
+                       sjtu::DatumUtil::createPropertyCache(d_caches.back())));
+            d_code.push_back(Bytecode::createOpcode(Bytecode::e_AddDoubles));
+        }
+        d_code.push_back(Bytecode::createOpcode(Bytecode::e_Return));
+    }
+        // Create a benchmark reading the properties of an object having the
+        // specified 'numProperties' through caches of the specified 'mode',
+        // using the specified 'allocator' to supply memory.
+
+    ~PropertyBenchmark() {
+        for (bsl::size_t i = 0; i < d_caches.size(); ++i) {
+            d_allocator_p->deleteObject(d_caches[i]);
+        }
+        sjtt::Object::destroy(d_object_p, d_allocator_p);
+    }
+        // Destroy this object.
+
+    // MANIPULATORS
+    void run(Int64 numIterations) {
+        bdld::Datum result;
+        for (Int64 i = 0; i < numIterations; ++i) {
+            InterpretUtil::interpret(&result, &d_context, d_code.data());
+        }
+        g_sink = result.isInteger() ? result.theInteger()
+                                    : result.theDouble();
+    }
+
+    // ACCESSORS
+    Int64 opsPerIteration() const { return d_caches.size(); }
+};
+
+bsl::string join(const char *prefix, const char *name, int size)
+    // Return the name of a benchmark made of the specified 'prefix', 'name',
+    // and, unless it is negative, 'size'.
+{
+    bsl::ostringstream stream;
+    stream << prefix << '/' << name;
+    if (0 <= size) {
+        stream << '/' << size;
+    }
+    return stream.str();
+}
+
+void runAll(Runner *runner, bslma::Allocator *allocator)
+    // Run the benchmarks selected by the specified 'runner', using the
+    // specified 'allocator' to supply memory.
+{
+    static const char *const SHAPES[] = { "add_chain",
+                                          "fused_chain",
+                                          "push_pop",
+                                          "integer_chain" };
+    static const char *const FORMS[]  = { "bytecode",
+                                          "program",
+                                          "verified",
+                                          "register" };
+    static const int         LENGTHS[] = { 16, 1024 };
+
+    for (int s = 0; s < 4; ++s) {
+        for (int f = 0; f < 4; ++f) {
+            for (int l = 0; l < 2; ++l) {
+                const bsl::string name = join(
+                             "interpret",
+                             (bsl::string(SHAPES[s]) + '/' + FORMS[f]).c_str(),
+                             LENGTHS[l]);
+                if (!runner->isSelected(name)) {
+                    continue;                                       // CONTINUE
+                }
+                InterpreterBenchmark benchmark(
+                               static_cast<InterpreterBenchmark::Shape>(s),
+                               LENGTHS[l],
+                               static_cast<InterpreterBenchmark::Form>(f),
+                               allocator);
+                runner->run(name, &benchmark);
+            }
+        }
+    }
+
+    static const char *const GLOBAL_MODES[] = { "get_by_name",
+                                                "get_by_slot",
+                                                "set_by_name",
+                                                "set_by_slot" };
+    static const int         NUM_KEYS[]     = { 1, 16, 256, 4096 };
+
+    for (int m = 0; m < 4; ++m) {
+        for (int k = 0; k < 4; ++k) {
+            const bsl::string name = join("globals",
+                                          GLOBAL_MODES[m],
+                                          NUM_KEYS[k]);
+            if (!runner->isSelected(name)) {
+                continue;                                           // CONTINUE
+            }
+            GlobalBenchmark benchmark(NUM_KEYS[k],
+                                      static_cast<GlobalBenchmark::Mode>(m),
+                                      allocator);
+            runner->run(name, &benchmark);
+        }
+    }
+
+    static const char *const STACK_MODES[] = { "fresh", "reused", "reserved" };
+    static const int         DEPTHS[]      = { 16, 256, 4096 };
+
+    for (int m = 0; m < 3; ++m) {
+        for (int d = 0; d < 3; ++d) {
+            const bsl::string name = join("stack", STACK_MODES[m], DEPTHS[d]);
+            if (!runner->isSelected(name)) {
+                continue;                                           // CONTINUE
+            }
+            StackBenchmark benchmark(DEPTHS[d],
+                                     static_cast<StackBenchmark::Mode>(m),
+                                     allocator);
+            runner->run(name, &benchmark);
+        }
+    }
+
+    static const char *const MARSHAL_MODES[] = { "box_function",
+                                                 "bind_numbers",
+                                                 "bind_string",
+                                                 "bind_batch" };
+
+    for (int m = 0; m < 4; ++m) {
+        const bsl::string name = join("marshal", MARSHAL_MODES[m], -1);
+        if (!runner->isSelected(name)) {
+            continue;                                               // CONTINUE
+        }
+        MarshalBenchmark benchmark(static_cast<MarshalBenchmark::Mode>(m),
+                                   allocator);
+        runner->run(name, &benchmark);
+    }
+
+    static const int CALL_DEPTHS[] = { 1, 16, 256, 4096 };
+
+    for (int d = 0; d < 4; ++d) {
+        const bsl::string name = join("marshal", "call_depth", CALL_DEPTHS[d]);
+        if (!runner->isSelected(name)) {
+            continue;                                               // CONTINUE
+        }
+        CallBenchmark benchmark(CALL_DEPTHS[d], allocator);
+        runner->run(name, &benchmark);
+    }
+
+    static const char *const CHURN_MODES[] = { "default",
+                                               "sequential",
+                                               "local_sequential",
+                                               "arena" };
+
+    for (int m = 0; m < 4; ++m) {
+        const bsl::string name = join("churn", CHURN_MODES[m], -1);
+        if (!runner->isSelected(name)) {
+            continue;                                               // CONTINUE
+        }
+        ChurnBenchmark benchmark(static_cast<ChurnBenchmark::Mode>(m),
+                                 allocator);
+        runner->run(name, &benchmark);
+    }
+
+    static const char *const PROPERTY_MODES[]  = { "cached", "megamorphic" };
+    static const int         NUM_PROPERTIES[] = { 4, 16 };
+
+    for (int m = 0; m < 2; ++m) {
+        for (int p = 0; p < 2; ++p) {
+            const bsl::string name = join("properties",
+                                          PROPERTY_MODES[m],
+                                          NUM_PROPERTIES[p]);
+            if (!runner->isSelected(name)) {
+                continue;                                           // CONTINUE
+            }
+            PropertyBenchmark benchmark(
+                                   NUM_PROPERTIES[p],
+                                   static_cast<PropertyBenchmark::Mode>(m),
+                                   allocator);
+            runner->run(name, &benchmark);
+        }
+    }
+}
+
+int usage(const char *program)
+    // Write the usage of the specified 'program' to the standard error and
+    // return a non-zero value.
+{
+    bsl::cerr << "usage: " << program << " [--json] [--iterations N]"
+              << " [--min-time-ms N] [--repetitions N] [FILTER]\n";
+    return 1;
+}
+
+}  // close unnamed namespace
+
+int main(int argc, char* argv[]) {
+    bool        json           = false;
+    Int64       numIterations  = 0;
+    Int64       minTimeMs      = 100;
+    int         numRepetitions = 5;
+    bsl::string filter;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (0 == bsl::strcmp(argv[i], "--json")) {
+            json = true;
+        }
+        else if (0 == bsl::strcmp(argv[i], "--iterations") && hasValue) {
+            numIterations = bsl::atoi(argv[++i]);
+        }
+        else if (0 == bsl::strcmp(argv[i], "--min-time-ms") && hasValue) {
+            minTimeMs = bsl::atoi(argv[++i]);
+        }
+        else if (0 == bsl::strcmp(argv[i], "--repetitions") && hasValue) {
+            numRepetitions = bsl::atoi(argv[++i]);
+        }
+        else if ('-' != argv[i][0] && filter.empty()) {
+            filter = argv[i];
+        }
+        else {
+            return usage(argv[0]);                                    // RETURN
+        }
+    }
+    if (numIterations < 0 || minTimeMs < 0 || numRepetitions < 1) {
+        return usage(argv[0]);                                        // RETURN
+    }
+
+    CountingAllocator allocator(&bslma::NewDeleteAllocator::singleton());
+    bslma::Default::setDefaultAllocatorRaw(&allocator);
+
+    {
+        Runner runner(&allocator,
+                      filter,
+                      numIterations,
+                      minTimeMs * 1000 * 1000,
+                      numRepetitions);
+        runAll(&runner, &allocator);
+        if (json) {
+            runner.printJson(bsl::cout);
+        }
+        else {
+            runner.printTable(bsl::cout);
+        }
+    }
+    return 0;
+}
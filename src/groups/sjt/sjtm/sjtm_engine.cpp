@@ -1,21 +1,338 @@
 #include <sjtm_engine.h>
 
+#include <sjtt_executioncontext.h>
+#include <sjtt_snapshotimage.h>
+#include <sjtt_tieruppolicy.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_interpretutil.h>
+#include <sjtu_jitcode.h>
+#include <sjtu_profile.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_limits.h>
+#include <bsl_new.h>
+#include <bsl_utility.h>
+
 namespace sjtm {
 
+namespace {
+
+class LimitProctor {
+    // This class enforces the memory limit of a 'sjtt::MemoryMeter' for its
+    // lifetime.
+
+    // DATA
+    sjtt::MemoryMeter *d_meter_p;  // meter enforcing its limit (held)
+
+  public:
+    // CREATORS
+    explicit LimitProctor(sjtt::MemoryMeter *meter)
+    : d_meter_p(meter) {
+        d_meter_p->setLimitEnforced(true);
+    }
+        // Enforce the limit of the specified 'meter' until this proctor is
+        // destroyed.
+
+    ~LimitProctor() {
+        d_meter_p->setLimitEnforced(false);
+    }
+        // Stop enforcing the limit of the meter of this proctor.
+};
+
+}  // close unnamed namespace
+
 Engine::Engine(BloombergLP::bslma::Allocator *allocator)
-    : d_globals(allocator) {
+    : d_meter(allocator)
+    , d_globalNames(d_meter.allocator(sjtt::MemoryMeter::e_Globals))
+    , d_snapshotBuffer(d_meter.allocator(sjtt::MemoryMeter::e_Globals))
+    , d_globals(d_meter.allocator(sjtt::MemoryMeter::e_Globals))
+    , d_arena(d_meter.allocator(sjtt::MemoryMeter::e_Stacks))
+    , d_heap(&d_arena, d_meter.allocator(sjtt::MemoryMeter::e_Heap))
+    , d_shapes(d_meter.allocator(sjtt::MemoryMeter::e_Other))
+    , d_jitEnabled(sjtu::JitCode::isSupported())
+    , d_jitThreshold(k_DEFAULT_JIT_THRESHOLD)
+    , d_jitProfiles(d_meter.allocator(sjtt::MemoryMeter::e_Other))
+    , d_profile_p(0)
+    , d_tierUpPolicy_p(0)
+    , d_loopThreshold(k_DEFAULT_LOOP_THRESHOLD) {
+    d_heap.addRoots(&d_globals);
+    d_heap.addRoots(d_arena.stack());
+}
+
+Engine::Engine(char                          *arenaBuffer,
+               int                            arenaBufferSize,
+               BloombergLP::bslma::Allocator *allocator)
+    : d_meter(allocator)
+    , d_globalNames(d_meter.allocator(sjtt::MemoryMeter::e_Globals))
+    , d_snapshotBuffer(d_meter.allocator(sjtt::MemoryMeter::e_Globals))
+    , d_globals(d_meter.allocator(sjtt::MemoryMeter::e_Globals))
+    , d_arena(arenaBuffer,
+              arenaBufferSize,
+              d_meter.allocator(sjtt::MemoryMeter::e_Stacks))
+    , d_heap(&d_arena, d_meter.allocator(sjtt::MemoryMeter::e_Heap))
+    , d_shapes(d_meter.allocator(sjtt::MemoryMeter::e_Other))
+    , d_jitEnabled(sjtu::JitCode::isSupported())
+    , d_jitThreshold(k_DEFAULT_JIT_THRESHOLD)
+    , d_jitProfiles(d_meter.allocator(sjtt::MemoryMeter::e_Other))
+    , d_profile_p(0)
+    , d_tierUpPolicy_p(0)
+    , d_loopThreshold(k_DEFAULT_LOOP_THRESHOLD) {
+    d_heap.addRoots(&d_globals);
+    d_heap.addRoots(d_arena.stack());
 }
 
 Engine::~Engine() {
 }
 
+void Engine::adoptGlobal(const BloombergLP::bslstl::StringRef&  name,
+                         const BloombergLP::bdld::Datum&        value,
+                         BloombergLP::bslma::Allocator         *owner) {
+    adoptGlobal(globalSlot(name), value, owner);
+}
+
+void Engine::discardProgram(const sjtt::Bytecode *code) {
+    BSLS_ASSERT(0 != code);
+
+    d_jitProfiles.erase(code);
+}
+
+int Engine::fromSnapshot(const char *snapshot, bsl::size_t size) {
+    BSLS_ASSERT(0 != snapshot || 0 == size);
+
+    BloombergLP::bslma::Allocator *allocator = d_meter.allocator(
+                                                 sjtt::MemoryMeter::e_Globals);
+
+    bsl::vector<char> buffer(snapshot, snapshot + size, allocator);
+    bsl::shared_ptr<sjtt::SnapshotImage> image(new (*allocator)
+                                             sjtt::SnapshotImage(allocator),
+                                               allocator);
+    const int rc = image->load(buffer.data(), buffer.size());
+    if (0 != rc) {
+        return rc;                                                    // RETURN
+    }
+    restoreSnapshot(image);
+    d_snapshotBuffer.swap(buffer);
+    return 0;
+}
+
+int Engine::fromSnapshotFile(const char *path) {
+    BSLS_ASSERT(0 != path);
+
+    BloombergLP::bslma::Allocator *allocator = d_meter.allocator(
+                                                 sjtt::MemoryMeter::e_Globals);
+
+    bsl::shared_ptr<sjtt::SnapshotImage> image(new (*allocator)
+                                             sjtt::SnapshotImage(allocator),
+                                               allocator);
+    const int rc = image->mapFile(path);
+    if (0 != rc) {
+        return rc;                                                    // RETURN
+    }
+    restoreSnapshot(image);
+    d_snapshotBuffer.clear();
+    return 0;
+}
+
+int Engine::globalSlot(const BloombergLP::bslstl::StringRef& name) {
+    const int slot = d_globalNames.intern(name);
+    if (slot == numGlobals()) {
+        d_globals.resize(slot + 1);
+        d_globals.back().clone(sjtu::DatumUtil::s_Undefined);
+    }
+    return slot;
+}
+
+int Engine::interpret(BloombergLP::bdld::Datum *result,
+                      sjtt::ExecutionContext   *context,
+                      const sjtt::Bytecode     *code) {
+    bsl::vector<BloombergLP::bdld::Datum> *stack = context->stack();
+    const bsl::size_t                      depth = stack->size();
+
+    LimitProctor proctor(&d_meter);
+    int          rc;
+    try {
+        rc = d_profile_p ? sjtu::InterpretUtil::interpretProfiled(result,
+                                                                  context,
+                                                                  code,
+                                                                  d_profile_p)
+                         : sjtu::InterpretUtil::interpret(result,
+                                                          context,
+                                                          code);
+    }
+    catch (const bsl::bad_alloc&) {
+        // The memory limit was reached.  The temporaries of the program are
+        // released by the next minor collection, but the values it left on
+        // the stack, which is a root, must be dropped now.
+
+        stack->resize(depth);
+        rc = sjtu::InterpretUtil::e_OutOfMemory;
+    }
+    return rc;
+}
+
+void Engine::evictJitProfiles() {
+    // Selecting the profiles to discard is linear in their number, but is
+    // done once every quarter of 'k_MAX_JIT_PROFILES' new programs.  A
+    // program whose compilation was rejected stopped counting at the
+    // threshold, so it is kept over those that have not reached it.
+
+    typedef bsl::pair<int, const sjtt::Bytecode *> Heat;
+
+    bsl::vector<Heat> heats(d_meter.allocator(sjtt::MemoryMeter::e_Other));
+    heats.reserve(d_jitProfiles.size());
+    for (JitProfiles::const_iterator it = d_jitProfiles.begin();
+         it != d_jitProfiles.end();
+         ++it) {
+        const Engine_JitProfile& profile = it->second;
+        heats.push_back(Heat(profile.d_jitCode
+                                 ? bsl::numeric_limits<int>::max()
+                                 : profile.d_numExecutions,
+                             it->first));
+    }
+    const bsl::size_t numEvicted = heats.size() / 4;
+    bsl::nth_element(heats.begin(), heats.begin() + numEvicted, heats.end());
+    for (bsl::size_t i = 0; i < numEvicted; ++i) {
+        d_jitProfiles.erase(heats[i].second);
+    }
+}
+
+void Engine::restoreSnapshot(
+                        const bsl::shared_ptr<sjtt::SnapshotImage>& snapshot) {
+    // Release the old globals before the snapshot they may refer to.
+
+    d_globals.clear();
+    d_globalNames.clear();
+    d_jitProfiles.clear();
+    d_globals.reserve(snapshot->numGlobals());
+    for (bsl::size_t i = 0; i < snapshot->numGlobals(); ++i) {
+        const int slot = globalSlot(snapshot->name(i));
+        d_globals[slot].adopt(snapshot->value(i), snapshot->owner());
+    }
+    d_snapshot = snapshot;
+}
+
+void Engine::updateJitProfile(Engine_JitProfile    *profile,
+                              const sjtt::Bytecode *code) {
+    if (profile->d_jitCode) {
+        if (profile->d_jitCode->matches(code)) {
+            return;                                                   // RETURN
+        }
+
+        // Another program was created at the address of the compiled one
+        // without being discarded: never run the old native code for it.
+
+        *profile = Engine_JitProfile();
+    }
+    if (profile->d_rejected || ++profile->d_numExecutions < d_jitThreshold) {
+        return;                                                       // RETURN
+    }
+    if (d_tierUpPolicy_p && d_jitThreshold == profile->d_numExecutions) {
+        d_tierUpPolicy_p->onHotProgram(code);
+    }
+    if (!d_jitEnabled || !sjtu::JitCode::canCompile(code)) {
+        profile->d_rejected = true;
+        return;                                                       // RETURN
+    }
+    BloombergLP::bslma::Allocator *allocator = d_meter.allocator(
+                                                   sjtt::MemoryMeter::e_Other);
+
+    bsl::shared_ptr<sjtu::JitCode> jitCode(new (*allocator)
+                                               sjtu::JitCode(allocator),
+                                           allocator);
+    if (0 == jitCode->compile(code)) {
+        profile->d_jitCode = jitCode;
+    }
+    else {
+        profile->d_rejected = true;
+    }
+}
+
 void Engine::setGlobal(const BloombergLP::bslstl::StringRef& name,
                        const BloombergLP::bdld::Datum&       value) {
-    d_globals[name].clone(value);
+    setGlobal(globalSlot(name), value);
+}
+
+void Engine::shareGlobal(const BloombergLP::bslstl::StringRef& name,
+                         const SharedDatum&                    value) {
+    shareGlobal(globalSlot(name), value);
+}
+
+int Engine::execute(BloombergLP::bdld::Datum *result,
+                    const sjtt::Bytecode     *code) {
+    d_heap.collectMinor();
+    d_heap.step();
+    sjtt::ExecutionContext context(&d_arena);
+    context.setGlobals(&d_globals);
+    context.setHeap(&d_heap);
+    context.setShapes(&d_shapes);
+    if (d_tierUpPolicy_p) {
+        context.setTierUpPolicy(d_tierUpPolicy_p, d_loopThreshold);
+    }
+    if (d_profile_p) {
+        return interpret(result, &context, code);                     // RETURN
+    }
+    if (d_jitEnabled || d_tierUpPolicy_p) {
+        JitProfiles::iterator it = d_jitProfiles.find(code);
+        if (d_jitProfiles.end() == it) {
+            if (k_MAX_JIT_PROFILES <= d_jitProfiles.size()) {
+                evictJitProfiles();
+            }
+            it = d_jitProfiles.insert(
+                          bsl::make_pair(code, Engine_JitProfile())).first;
+        }
+        Engine_JitProfile& profile = it->second;
+        updateJitProfile(&profile, code);
+        if (profile.d_jitCode) {
+            const int rc = profile.d_jitCode->execute(result, &d_globals);
+            if (sjtu::JitCode::e_Success == rc) {
+                return 0;                                             // RETURN
+            }
+
+            // A guard failed.  Compiled programs have no side effects, so
+            // the program can simply be interpreted instead.
+
+            profile = Engine_JitProfile();
+        }
+    }
+    return interpret(result, &context, code);
+}
+
+void Engine::setJitEnabled(bool enabled) {
+    // Programs counted while the JIT compiler was disabled were rejected, so
+    // profiling starts again whenever it is toggled.
+
+    const bool jitEnabled = enabled && sjtu::JitCode::isSupported();
+    if (!jitEnabled || jitEnabled != d_jitEnabled) {
+        d_jitProfiles.clear();
+    }
+    d_jitEnabled = jitEnabled;
+}
+
+int Engine::findGlobalSlot(const BloombergLP::bslstl::StringRef& name) const {
+    return d_globalNames.find(name);
+}
+
+int Engine::saveSnapshot(bsl::vector<char> *result) const {
+    BSLS_ASSERT(0 != result);
+
+    return sjtt::SnapshotImage::encode(result, d_globalNames, d_globals);
 }
 
 const BloombergLP::bdld::Datum&
-Engine::getGlobal(const BloombergLP::bslstl::StringRef& name) {
-    return d_globals[name].datum();
+Engine::getGlobal(const BloombergLP::bslstl::StringRef& name) const {
+    const int slot = findGlobalSlot(name);
+    return 0 > slot ? sjtu::DatumUtil::s_Undefined : getGlobal(slot);
+}
+
+int Engine::numCompiledPrograms() const {
+    int count = 0;
+    for (JitProfiles::const_iterator it = d_jitProfiles.begin();
+         it != d_jitProfiles.end();
+         ++it) {
+        if (it->second.d_jitCode) {
+            ++count;
+        }
+    }
+    return count;
 }
 }
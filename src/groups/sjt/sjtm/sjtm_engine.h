@@ -1,12 +1,40 @@
 #ifndef INCLUDED_SJTM_ENGINE
 #define INCLUDED_SJTM_ENGINE
 
+#ifndef INCLUDED_SJTT_EXECUTIONARENA
+#include <sjtt_executionarena.h>
+#endif
+
+#ifndef INCLUDED_SJTT_GLOBALVALUE
+#include <sjtt_globalvalue.h>
+#endif
+
+#ifndef INCLUDED_SJTT_HEAP
+#include <sjtt_heap.h>
+#endif
+
+#ifndef INCLUDED_SJTT_MEMORYMETER
+#include <sjtt_memorymeter.h>
+#endif
+
+#ifndef INCLUDED_SJTT_SHAPE
+#include <sjtt_shape.h>
+#endif
+
+#ifndef INCLUDED_SJTT_SYMBOLTABLE
+#include <sjtt_symboltable.h>
+#endif
+
 #ifndef INCLUDED_BDLD_DATUM
 #include <bdld_datum.h>
 #endif
 
-#ifndef INCLUDED_BDLD_MANAGEDDATUM
-#include <bdld_manageddatum.h>
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_MEMORY
+#include <bsl_memory.h>
 #endif
 
 #ifndef INCLUDED_BSL_STRING
@@ -17,35 +45,557 @@
 #include <bsl_unordered_map.h>
 #endif
 
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
 namespace BloombergLP {
 namespace bslma { class Allocator; }
 }
 
+namespace sjtt { class Bytecode; }
+namespace sjtt { class ExecutionContext; }
+namespace sjtt { class SnapshotImage; }
+namespace sjtt { class TierUpPolicy; }
+namespace sjtu { class JitCode; }
+namespace sjtu { class Profile; }
+
 namespace sjtm {
+
+                          // ========================
+                          // struct Engine_JitProfile
+                          // ========================
+
+struct Engine_JitProfile {
+    // This component-private struct holds what an 'Engine' knows about a
+    // program for deciding whether to compile it, or to notify its tier-up
+    // policy that the program is hot.
+
+    // DATA
+    int                            d_numExecutions;  // since last compiled
+    bool                           d_rejected;       // not compiled, and no
+                                                     // longer counted
+    bsl::shared_ptr<sjtu::JitCode> d_jitCode;        // native code, if any
+
+    // CREATORS
+    Engine_JitProfile()
+    : d_numExecutions(0)
+    , d_rejected(false) {
+    }
+};
+
+                                // ============
+                                // class Engine
+                                // ============
+
 class Engine {
+    // This class provides the top-level mechanism for running Scramjet
+    // programs.  Globals are identified by name, and each name is assigned a
+    // slot, an index into the storage of the values of globals, the first
+    // time it is used.  Programs should resolve global names to slots once,
+    // when they are loaded (see 'globalSlot'), and then refer to globals by
+    // slot, e.g., with 'e_GetGlobalSlot' and 'e_SetGlobalSlot'.
+    //
+    // A value can be given to a global in three ways: 'setGlobal' copies it
+    // into the allocator of the engine, 'adoptGlobal' takes ownership of an
+    // already-allocated value without copying it, and 'shareGlobal' refers to
+    // an immutable, reference-counted value (see
+    // 'sjtt::GlobalValue::createShared') that may be shared, without copying,
+    // by any number of engines.
+    //
+    // Values created by programs are managed by a generational garbage
+    // collector (see 'sjtt::Heap').  All temporaries of an invocation of
+    // 'execute', including its result, are allocated from the execution
+    // arena of the engine (see 'sjtt::ExecutionArena'), which is the nursery
+    // of the collector, and globals assigned by programs refer to them
+    // without copying them.  Each call to 'execute' first performs a minor
+    // collection, which promotes the values still referred to by globals
+    // into the tenured space and resets the arena, and then a bounded amount
+    // of incremental major collection work (see 'setGcPauseBudget').  An
+    // engine can be given an initial buffer for its arena so that, in the
+    // steady state, executing a program that does not assign globals does
+    // not allocate memory at all.
+    //
+    // Objects created by programs ('e_NewObject') are temporaries like any
+    // other, but their shapes (see 'sjtt::ShapeTable') are owned by the
+    // engine and kept across executions, so that the property caches of a
+    // program executed repeatedly keep hitting once warmed up.  Objects are
+    // not values of globals: a program assigning one to a global fails with
+    // 'sjtu::InterpretUtil::e_TypeError'.
+    //
+    // Programs executed often are compiled to native code by a baseline JIT
+    // compiler, where the platform supports it (see 'sjtu::JitCode').  Once
+    // a program, identified by its address, has been executed
+    // 'jitThreshold()' times, it is compiled, if it is of the simple form
+    // the compiler accepts, and subsequent executions run the native code.
+    // When a guard of the native code fails, e.g., because a global it reads
+    // no longer holds a double, the native code is discarded and the
+    // program is interpreted, and profiling starts again.  Before native
+    // code is run, the instructions it was compiled from are compared with
+    // those of the program, so that a program modified, or replaced by
+    // another at the same address, is never run as the native code of the
+    // old one; 'discardProgram' should still be called in that case, so that
+    // the rest of the profile of the old program, e.g., the finding that it
+    // cannot be compiled, is not applied to the new one.  At most
+    // 'k_MAX_JIT_PROFILES' programs are profiled at a time; when that many
+    // are and another program is executed, the profiles of the quarter of
+    // the programs executed the fewest times are discarded, native code
+    // last, so that an engine executing many short-lived programs does not
+    // accumulate profiles, but still compiles the programs it executes often
+    // among them.  The JIT compiler can be disabled with 'setJitEnabled'.
+    //
+    // An engine can be given a 'sjtt::TierUpPolicy' ('setTierUpPolicy'),
+    // which is notified when a program has been executed 'jitThreshold()'
+    // times, and when a loop of a program has iterated 'loopThreshold()'
+    // times (see 'sjtt::LoopCounter'), so that it can, for example, optimize
+    // hot code or stop runaway loops.  The policy is
+    // notified whether or not the JIT compiler is enabled.
+    //
+    // An engine can be given a 'sjtu::Profile' ('setProfile'), in which case
+    // every program is interpreted with instrumentation, recording the
+    // cycles of each opcode and external function and the invocations of
+    // each program, and none is run as native code.
+    //
+    // The globals of an engine can be saved, with 'saveSnapshot', in a
+    // relocatable image (see 'sjtt::SnapshotImage') from which another
+    // engine can be started with 'fromSnapshot' or 'fromSnapshotFile'.
+    // Restoring a snapshot does not copy values one by one: the image is
+    // read with one copy, or mapped into memory, and the values of the
+    // globals are made in place, referring to the strings of the image, and
+    // adopted by the globals.  The image is held by the engine until another
+    // snapshot is restored or the engine is destroyed.
+    //
+    // All memory of an engine is obtained through a 'sjtt::MemoryMeter'
+    // ('memoryMeter'), which counts the bytes in use, their peak, and the
+    // allocations, separately for the globals, the execution stacks (the
+    // arena), the script heap (the tenured space of the collector), and
+    // everything else, such as compiled code.  The counters can be read from
+    // any thread, e.g., to export them as metrics.  An engine can be given a
+    // limit on the memory it uses ('setMemoryLimit'): a program whose
+    // allocations would exceed it is stopped, and 'execute' returns
+    // 'sjtu::InterpretUtil::e_OutOfMemory', leaving the engine usable.
+    // Memory allocated outside of programs, e.g., by 'setGlobal', counts
+    // against the limit but is never refused.
 
-    // ACCESSORS
+  public:
+    // TYPES
+    typedef sjtt::GlobalValue::SharedDatum SharedDatum;
+
+    enum {
+        k_DEFAULT_JIT_THRESHOLD = 100,
+            // executions of a program before it is compiled, by default
+
+        k_DEFAULT_LOOP_THRESHOLD = 1000,
+            // iterations of a loop before it is hot, by default
+
+        k_MAX_JIT_PROFILES = 1024
+            // programs profiled at a time
+    };
 
-    bsl::unordered_map<bsl::string, BloombergLP::bdld::ManagedDatum> d_globals;
+  private:
+    // PRIVATE TYPES
+    typedef bsl::unordered_map<const sjtt::Bytecode *, Engine_JitProfile>
+                                                               JitProfiles;
+
+    // DATA
+
+    sjtt::MemoryMeter                      d_meter;  // must outlive all
+                                                     // other members
+    sjtt::SymbolTable                      d_globalNames;
+    bsl::vector<char>                      d_snapshotBuffer;
+    bsl::shared_ptr<sjtt::SnapshotImage>   d_snapshot;  // must outlive
+                                                        // 'd_globals'
+    bsl::vector<sjtt::GlobalValue>         d_globals;
+    sjtt::ExecutionArena                   d_arena;
+    sjtt::Heap                             d_heap;
+    sjtt::ShapeTable                       d_shapes;  // of created objects
+    bool                                   d_jitEnabled;
+    int                                    d_jitThreshold;
+    JitProfiles                            d_jitProfiles;
+    sjtu::Profile                         *d_profile_p;  // held, or 0
+    sjtt::TierUpPolicy                    *d_tierUpPolicy_p;  // held, or 0
+    BloombergLP::bsls::Types::Int64        d_loopThreshold;
 
     Engine(const Engine&) = delete;
     Engine& operator=(const Engine&) = delete;
 
+    // PRIVATE MANIPULATORS
+
+    int interpret(BloombergLP::bdld::Datum *result,
+                  sjtt::ExecutionContext   *context,
+                  const sjtt::Bytecode     *code);
+        // Interpret the specified 'code' with the specified 'context',
+        // recording it in the profile if one is set, and load the returned
+        // value into the specified 'result'.  Return 0 on success, and a
+        // non-zero 'sjtu::InterpretUtil::Status' value, e.g.,
+        // 'e_OutOfMemory' if the program exceeded the memory limit,
+        // otherwise.
+
+    void evictJitProfiles();
+        // Discard the profiles of the quarter of the programs profiled by
+        // this engine that were executed the fewest times since they were
+        // last compiled, discarding native code only if more than three
+        // quarters of the programs have been compiled.
+
+    void restoreSnapshot(
+                       const bsl::shared_ptr<sjtt::SnapshotImage>& snapshot);
+        // Replace the globals of this engine with those of the specified
+        // 'snapshot', and hold 'snapshot' while they refer to it.
+
+    void updateJitProfile(Engine_JitProfile    *profile,
+                          const sjtt::Bytecode *code);
+        // Count an execution of the program beginning at the specified
+        // 'code' in the specified 'profile', notifying the tier-up policy and
+        // compiling the program if it has become hot.
+
   public:
     // CREATORS
 
     explicit Engine(BloombergLP::bslma::Allocator *allocator);
 
+    Engine(char                          *arenaBuffer,
+           int                            arenaBufferSize,
+           BloombergLP::bslma::Allocator *allocator);
+        // Create an engine that allocates the temporaries of each execution
+        // from the specified 'arenaBuffer' of the specified 'arenaBufferSize'
+        // bytes, before using memory supplied by the specified 'allocator'.
+        // The behavior is undefined unless '0 != arenaBuffer',
+        // '0 < arenaBufferSize', and 'arenaBuffer' outlives this engine.
+
     ~Engine();
 
     // MANIPULATORS
 
+    void adoptGlobal(int                            slot,
+                     const BloombergLP::bdld::Datum& value,
+                     BloombergLP::bslma::Allocator  *owner);
+        // Give the global in the specified 'slot' the specified 'value',
+        // taking ownership of it without copying it.  'value' will be
+        // destroyed with the specified 'owner' allocator when it is replaced
+        // or this engine is destroyed, so 'owner' must outlive this engine.
+        // The behavior is undefined unless 'value' was allocated with 'owner'
+        // and '0 <= slot < numGlobals()'.  Note that the value held by a
+        // 'bdld::ManagedDatum', 'm', can be moved into a global with
+        // 'adoptGlobal(slot, m.release(), m.allocator())'.
+
+    void adoptGlobal(const BloombergLP::bslstl::StringRef& name,
+                     const BloombergLP::bdld::Datum&       value,
+                     BloombergLP::bslma::Allocator         *owner);
+        // Give the global having the specified 'name', creating it if it
+        // does not exist, the specified 'value', taking ownership of it
+        // without copying it.  The behavior is undefined unless 'value' was
+        // allocated with the specified 'owner' allocator, which must outlive
+        // this engine.
+
+    void discardProgram(const sjtt::Bytecode *code);
+        // Discard the profile and the native code of the program beginning
+        // at the specified 'code', if any, so that the next execution of a
+        // program at that address is profiled from the start.  This function
+        // should be called before a program that has been executed by this
+        // engine is modified, or before it is destroyed if another program
+        // may later be created at the same address, so that the new program
+        // is not profiled as the old one (see 'execute').
+
+    int fromSnapshot(const char *snapshot, bsl::size_t size);
+        // Replace the globals of this engine with those saved in the
+        // specified 'snapshot' image of the specified 'size' bytes (see
+        // 'saveSnapshot'), copying the image once.  Return 0 on success, and
+        // a non-zero 'sjtt::SnapshotImage::Status' value, with no effect on
+        // this engine, if the image is invalid.  Globals are given the slots
+        // they had in the engine that saved them, and native code compiled
+        // for programs is discarded.
+
+    int fromSnapshotFile(const char *path);
+        // Replace the globals of this engine with those saved in the file at
+        // the specified 'path', which is mapped into memory rather than
+        // read.  Return 0 on success, and a non-zero
+        // 'sjtt::SnapshotImage::Status' value, with no effect on this engine,
+        // if the file cannot be mapped or is invalid.  See 'fromSnapshot'.
+
+    int globalSlot(const BloombergLP::bslstl::StringRef& name);
+        // Return the slot of the global having the specified 'name', creating
+        // it, with an undefined value, if it does not exist.
+
+    void setGlobal(int slot, const BloombergLP::bdld::Datum& value);
+        // Assign a copy of the specified 'value' to the global in the
+        // specified 'slot'.  The behavior is undefined unless
+        // '0 <= slot < numGlobals()'.
+
     void setGlobal(const BloombergLP::bslstl::StringRef& name,
                    const BloombergLP::bdld::Datum& value);
+        // Assign a copy of the specified 'value' to the global having the
+        // specified 'name', creating it if it does not exist.
+
+    void shareGlobal(int slot, const SharedDatum& value);
+        // Give the global in the specified 'slot' the specified shared
+        // 'value' without copying it.  The behavior is undefined unless
+        // 'value' is not empty and '0 <= slot < numGlobals()'.
+
+    void shareGlobal(const BloombergLP::bslstl::StringRef& name,
+                     const SharedDatum&                    value);
+        // Give the global having the specified 'name', creating it if it
+        // does not exist, the specified shared 'value' without copying it.
+        // The behavior is undefined unless 'value' is not empty.
+
+    int execute(BloombergLP::bdld::Datum *result,
+                const sjtt::Bytecode     *code);
+        // Interpret the specified 'code', or run its native code if it has
+        // been compiled, with access to the globals of this engine and load
+        // the returned value into the specified 'result'.  Return 0 on
+        // success, and a non-zero value otherwise.  See
+        // 'sjtu::InterpretUtil'.  Memory referred to by 'result' is valid
+        // until the next call to 'execute' or 'resetArena'.  Note that if
+        // the program at 'code' has been modified, or replaced by another at
+        // the same address, since it was last executed by this engine, and
+        // 'discardProgram(code)' was not called in between, the new program
+        // is still run correctly, but its compilation may be delayed, or
+        // skipped if the old program could not be compiled.
+
+    void collectGarbage();
+        // Perform a complete collection of the values created by programs,
+        // without regard to the pause budget.
+
+    void resetArena();
+        // Perform a minor collection, releasing all temporaries of the last
+        // execution that are not referred to by globals.  Note that this is
+        // done implicitly by 'execute'.
+
+    void setGcPauseBudget(BloombergLP::bsls::Types::Int64 nanoseconds);
+        // Limit the incremental major collection work done by each call to
+        // 'execute' to about the specified 'nanoseconds'.  The default is
+        // 'sjtt::Heap::k_DEFAULT_PAUSE_BUDGET' (1 millisecond).  The behavior
+        // is undefined unless '0 <= nanoseconds'.
+
+    void setJitEnabled(bool enabled);
+        // Compile hot programs to native code if the specified 'enabled' is
+        // 'true', and only interpret programs otherwise, releasing all native
+        // code and profiles.  The JIT compiler is enabled by default if the
+        // platform supports it.  Enabling it on a platform that does not has
+        // no effect.
+
+    void setJitThreshold(int numExecutions);
+        // Compile programs when they have been executed the specified
+        // 'numExecutions' times.  The default is 'k_DEFAULT_JIT_THRESHOLD'.
+        // The behavior is undefined unless '0 < numExecutions'.
+
+    void setLoopThreshold(BloombergLP::bsls::Types::Int64 numIterations);
+        // Notify the tier-up policy of each loop that has iterated the
+        // specified 'numIterations' times.  The default is
+        // 'k_DEFAULT_LOOP_THRESHOLD'.  The behavior is undefined unless
+        // '0 < numIterations'.
+
+    void setMemoryLimit(BloombergLP::bsls::Types::Int64 numBytes);
+        // Stop any program whose allocations would take the memory used by
+        // this engine past the specified 'numBytes', or remove the limit if
+        // 'numBytes' is 0.  There is no limit by default.  The behavior is
+        // undefined unless '0 <= numBytes'.
+
+    void setProfile(sjtu::Profile *profile);
+        // Record the execution of programs in the specified 'profile', or
+        // stop profiling if 'profile' is 0.  Profiled programs are always
+        // interpreted.  The behavior is undefined unless 'profile' remains
+        // valid until profiling stops or this engine is destroyed.
+
+    void setTierUpPolicy(sjtt::TierUpPolicy *policy);
+        // Notify the specified 'policy' of hot programs and loops, or stop
+        // notifying any policy if 'policy' is 0.  The behavior is undefined
+        // unless 'policy' remains valid until it is replaced or this engine
+        // is destroyed.
+
+    // ACCESSORS
+
+    int findGlobalSlot(const BloombergLP::bslstl::StringRef& name) const;
+        // Return the slot of the global having the specified 'name', or -1 if
+        // there is no such global.
+
+    const BloombergLP::bdld::Datum& getGlobal(int slot) const;
+        // Return a reference to the value of the global in the specified
+        // 'slot'.  The behavior is undefined unless
+        // '0 <= slot < numGlobals()'.
 
     const BloombergLP::bdld::Datum&
-        getGlobal(const BloombergLP::bslstl::StringRef& name);
+        getGlobal(const BloombergLP::bslstl::StringRef& name) const;
+        // Return a reference to the value of the global having the specified
+        // 'name', or to 'sjtu::DatumUtil::s_Undefined' if there is no such
+        // global.
+
+    int saveSnapshot(bsl::vector<char> *result) const;
+        // Load into the specified 'result' an image of the globals of this
+        // engine, their names, and their values, from which an engine can be
+        // restored with 'fromSnapshot'.  Return 0 on success, and a non-zero
+        // value, with no effect on 'result', if the value of a global cannot
+        // be saved, i.e., is not null, a double, an integer, a boolean, a
+        // string, undefined, or an array or a map of such values.
+
+    const sjtt::HeapStats& heapStats() const;
+        // Return the statistics of the garbage collector of this engine.
+
+    bool isJitEnabled() const;
+        // Return 'true' if this engine compiles hot programs to native code,
+        // and 'false' otherwise.
+
+    int jitThreshold() const;
+        // Return the number of executions after which a program is compiled.
+
+    BloombergLP::bsls::Types::Int64 loopThreshold() const;
+        // Return the number of iterations after which a loop is hot.
+
+    BloombergLP::bsls::Types::Int64 memoryLimit() const;
+        // Return the limit on the memory used by this engine, in bytes, or 0
+        // if there is none.
+
+    const sjtt::MemoryMeter& memoryMeter() const;
+        // Return the meter counting the memory used by this engine.  It may
+        // be read from any thread while this engine is in use.
+
+    sjtu::Profile *profile() const;
+        // Return the profile in which the execution of programs is recorded,
+        // or 0 if none is.
+
+    int numCompiledPrograms() const;
+        // Return the number of programs for which this engine holds native
+        // code.
+
+    int numGlobals() const;
+        // Return the number of globals (and slots) in this engine.
+
+    sjtt::TierUpPolicy *tierUpPolicy() const;
+        // Return the policy notified of hot programs and loops, or 0 if none
+        // is.
 };
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+// MANIPULATORS
+inline
+void Engine::adoptGlobal(int                              slot,
+                         const BloombergLP::bdld::Datum&  value,
+                         BloombergLP::bslma::Allocator   *owner) {
+    BSLS_ASSERT_SAFE(0 <= slot);
+    BSLS_ASSERT_SAFE(slot < numGlobals());
+    d_globals[slot].adopt(value, owner);
+}
+
+inline
+void Engine::collectGarbage() {
+    d_heap.collect();
+}
+
+inline
+void Engine::resetArena() {
+    d_heap.collectMinor();
+}
+
+inline
+void Engine::setGlobal(int slot, const BloombergLP::bdld::Datum& value) {
+    BSLS_ASSERT_SAFE(0 <= slot);
+    BSLS_ASSERT_SAFE(slot < numGlobals());
+    d_globals[slot].clone(value);
+}
+
+inline
+void Engine::setGcPauseBudget(BloombergLP::bsls::Types::Int64 nanoseconds) {
+    d_heap.setPauseBudget(nanoseconds);
+}
+
+inline
+void Engine::setJitThreshold(int numExecutions) {
+    BSLS_ASSERT(0 < numExecutions);
+    d_jitThreshold = numExecutions;
+}
+
+inline
+void Engine::setLoopThreshold(BloombergLP::bsls::Types::Int64 numIterations)
+{
+    BSLS_ASSERT(0 < numIterations);
+    d_loopThreshold = numIterations;
+}
+
+inline
+void Engine::setMemoryLimit(BloombergLP::bsls::Types::Int64 numBytes) {
+    BSLS_ASSERT(0 <= numBytes);
+    d_meter.setLimit(numBytes);
+}
+
+inline
+void Engine::setProfile(sjtu::Profile *profile) {
+    d_profile_p = profile;
+}
+
+inline
+void Engine::setTierUpPolicy(sjtt::TierUpPolicy *policy) {
+    d_tierUpPolicy_p = policy;
+}
+
+inline
+void Engine::shareGlobal(int slot, const SharedDatum& value) {
+    BSLS_ASSERT_SAFE(0 <= slot);
+    BSLS_ASSERT_SAFE(slot < numGlobals());
+    d_globals[slot].share(value);
+}
+
+// ACCESSORS
+inline
+const BloombergLP::bdld::Datum& Engine::getGlobal(int slot) const {
+    BSLS_ASSERT_SAFE(0 <= slot);
+    BSLS_ASSERT_SAFE(slot < numGlobals());
+    return d_globals[slot].datum();
+}
+
+inline
+const sjtt::HeapStats& Engine::heapStats() const {
+    return d_heap.stats();
+}
+
+inline
+bool Engine::isJitEnabled() const {
+    return d_jitEnabled;
+}
+
+inline
+int Engine::jitThreshold() const {
+    return d_jitThreshold;
+}
+
+inline
+BloombergLP::bsls::Types::Int64 Engine::loopThreshold() const {
+    return d_loopThreshold;
+}
+
+inline
+BloombergLP::bsls::Types::Int64 Engine::memoryLimit() const {
+    return d_meter.limit();
+}
+
+inline
+const sjtt::MemoryMeter& Engine::memoryMeter() const {
+    return d_meter;
+}
+
+inline
+sjtu::Profile *Engine::profile() const {
+    return d_profile_p;
+}
+
+inline
+int Engine::numGlobals() const {
+    return static_cast<int>(d_globals.size());
+}
+
+inline
+sjtt::TierUpPolicy *Engine::tierUpPolicy() const {
+    return d_tierUpPolicy_p;
+}
 }
 
 #endif /* INCLUDED_SJTM_ENGINE */
@@ -2,8 +2,26 @@
 
 #include <sjtm_engine.h>
 
+#include <sjtt_bytecode.h>
+#include <sjtt_executioncontext.h>
+#include <sjtt_loopcounter.h>
+#include <sjtt_memorymeter.h>
+#include <sjtt_propertycache.h>
+#include <sjtt_snapshotimage.h>
+#include <sjtt_tieruppolicy.h>
+#include <sjtt_typefeedback.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_interpretutil.h>
+#include <sjtu_profile.h>
+
+#include <bslma_testallocator.h>
+
 #include <bdls_testutil.h>
 
+#include <bsl_algorithm.h>
+#include <bsl_cstdio.h>
+#include <bsl_vector.h>
+
 using namespace BloombergLP;
 using namespace bsl;
 
@@ -52,6 +70,70 @@ void aSsErT(bool condition, const char *message, int line)
 #define L_           BDLS_TESTUTIL_L_  // current Line number
 
 
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+void greet(sjtt::ExecutionContext *context)
+    // Replace the string on the top of the stack of the specified 'context'
+    // with a longer one allocated from the allocator of 'context'.
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    const bsl::string greeting = "hello, " + bsl::string(
+                                                stack.back().theString());
+    stack.back() = bdld::Datum::copyString(greeting, context->allocator());
+}
+
+void fill(sjtt::ExecutionContext *context)
+    // Replace the integer on the top of the stack of the specified 'context'
+    // with a string of that many characters allocated from the allocator of
+    // 'context'.
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    const bsl::string text(stack.back().theInteger(), 'x');
+    stack.back() = bdld::Datum::copyString(text, context->allocator());
+}
+
+class TestPolicy : public sjtt::TierUpPolicy {
+    // This class counts the notifications it receives, and interrupts hot
+    // loops if so configured.
+
+  public:
+    // DATA
+    int                   d_numHotLoops;
+    int                   d_numHotPrograms;
+    const sjtt::Bytecode *d_lastProgram_p;
+    bool                  d_interrupt;
+
+    // CREATORS
+    TestPolicy()
+    : d_numHotLoops(0)
+    , d_numHotPrograms(0)
+    , d_lastProgram_p(0)
+    , d_interrupt(false)
+    {
+    }
+
+    // MANIPULATORS
+    void onHotLoop(sjtt::ExecutionContext *context, sjtt::LoopCounter *)
+    {
+        ++d_numHotLoops;
+        if (d_interrupt) {
+            context->setStatus(sjtu::InterpretUtil::e_Interrupted);
+        }
+    }
+
+    void onHotProgram(const sjtt::Bytecode *code)
+    {
+        ++d_numHotPrograms;
+        d_lastProgram_p = code;
+    }
+};
+
+}  // close unnamed namespace
+
 // ============================================================================
 //                               MAIN PROGRAM
 // ----------------------------------------------------------------------------
@@ -65,6 +147,800 @@ int main(int argc, char *argv[])
     cout << "TEST " << __FILE__ << " CASE " << test << endl;
 
     switch (test) { case 0:
+      case 12: {
+        if (verbose) cout << endl
+                          << "tier-up policy" << endl
+                          << "==============" << endl;
+
+        typedef sjtt::Bytecode Bytecode;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtm::Engine engine(&ta);
+            ASSERT(0 == engine.tierUpPolicy());
+            ASSERT(sjtm::Engine::k_DEFAULT_LOOP_THRESHOLD ==
+                                                      engine.loopThreshold());
+
+            TestPolicy policy;
+            engine.setTierUpPolicy(&policy);
+            engine.setJitThreshold(3);
+            engine.setLoopThreshold(4);
+            ASSERT(&policy == engine.tierUpPolicy());
+            ASSERT(4 == engine.loopThreshold());
+
+            // A program is hot once, whether or not it can be compiled.
+
+            const Bytecode simple[] = {
+                Bytecode::createPush(bdld::Datum::createInteger(1)),
+                Bytecode::createOpcode(Bytecode::e_Return),
+            };
+            for (int i = 0; i < 5; ++i) {
+                bdld::Datum result;
+                ASSERTV(i, 0 == engine.execute(&result, simple));
+                ASSERTV(i, bdld::Datum::createInteger(1) == result);
+                ASSERTV(i, (2 <= i) == policy.d_numHotPrograms);
+            }
+            ASSERT(simple == policy.d_lastProgram_p);
+
+            // 'i = 0; while (i < 10) { i = i + 1; } return i;'
+
+            sjtt::LoopCounter  counter;
+            sjtt::TypeFeedback feedback;
+            const bdld::Datum  SLOT = bdld::Datum::createInteger(
+                                                     engine.globalSlot("i"));
+            const bdld::Datum  FB   =
+                            sjtu::DatumUtil::createTypeFeedback(&feedback);
+            const Bytecode loop[] = {
+                Bytecode::createPush(bdld::Datum::createInteger(0)),
+                Bytecode::create(Bytecode::e_SetGlobalSlot, SLOT),
+                Bytecode::create(Bytecode::e_LoopHeader,
+                                 sjtu::DatumUtil::createLoopCounter(&counter)),
+                Bytecode::create(Bytecode::e_GetGlobalSlot, SLOT),
+                Bytecode::createPush(bdld::Datum::createInteger(10)),
+                Bytecode::create(Bytecode::e_LessIntegers, FB),
+                Bytecode::create(Bytecode::e_JumpIfFalse,
+                                 bdld::Datum::createInteger(6)),
+                Bytecode::create(Bytecode::e_GetGlobalSlot, SLOT),
+                Bytecode::createPush(bdld::Datum::createInteger(1)),
+                Bytecode::create(Bytecode::e_AddIntegers, FB),
+                Bytecode::create(Bytecode::e_SetGlobalSlot, SLOT),
+                Bytecode::create(Bytecode::e_Loop,
+                                 bdld::Datum::createInteger(-9)),
+                Bytecode::create(Bytecode::e_GetGlobalSlot, SLOT),
+                Bytecode::createOpcode(Bytecode::e_Return),
+            };
+
+            // A loop is hot once, when its counter reaches the threshold.
+
+            bdld::Datum result;
+            ASSERT(0 == engine.execute(&result, loop));
+            ASSERTV(result, bdld::Datum::createInteger(10) == result);
+            ASSERT(10 == counter.count());
+            ASSERT(1  == policy.d_numHotLoops);
+
+            // The policy can stop a loop.
+
+            counter.reset();
+            policy.d_interrupt = true;
+            ASSERT(sjtu::InterpretUtil::e_Interrupted ==
+                                                engine.execute(&result, loop));
+            ASSERT(2 == policy.d_numHotLoops);
+            ASSERT(4 == counter.count());
+            ASSERTV(engine.getGlobal("i"),
+                    bdld::Datum::createInteger(4) == engine.getGlobal("i"));
+
+            // Without a policy, loops are counted but nothing is notified.
+
+            engine.setTierUpPolicy(0);
+            counter.reset();
+            ASSERT(0 == engine.execute(&result, loop));
+            ASSERT(10 == counter.count());
+            ASSERT(2  == policy.d_numHotLoops);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 11: {
+        if (verbose) cout << endl
+                          << "objects" << endl
+                          << "=======" << endl;
+
+        typedef sjtt::Bytecode Bytecode;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtm::Engine        engine(&ta);
+            sjtt::PropertyCache setPrice("price", &ta);
+            sjtt::PropertyCache setSize("size", &ta);
+            sjtt::PropertyCache getSize("size", &ta);
+
+            // '{ price: 1.5, size: 100 }.size'
+
+            const Bytecode code[] = {
+                Bytecode::createOpcode(Bytecode::e_NewObject),
+                Bytecode::createPush(bdld::Datum::createDouble(1.5)),
+                Bytecode::create(
+                           Bytecode::e_SetProperty,
+                           sjtu::DatumUtil::createPropertyCache(&setPrice)),
+                Bytecode::createPush(bdld::Datum::createDouble(100)),
+                Bytecode::create(
+                            Bytecode::e_SetProperty,
+                            sjtu::DatumUtil::createPropertyCache(&setSize)),
+                Bytecode::create(
+                            Bytecode::e_GetProperty,
+                            sjtu::DatumUtil::createPropertyCache(&getSize)),
+                Bytecode::createOpcode(Bytecode::e_Return),
+            };
+
+            // The shapes of the engine outlive each execution, so the caches
+            // miss only on the first.
+
+            for (int i = 0; i < 5; ++i) {
+                bdld::Datum result;
+                ASSERTV(i, 0 == engine.execute(&result, code));
+                ASSERTV(i, bdld::Datum::createDouble(100) == result);
+            }
+            ASSERT(1 == setPrice.numMisses());
+            ASSERT(1 == setSize.numMisses());
+            ASSERT(1 == getSize.numMisses());
+
+            // Objects cannot be assigned to globals.
+
+            const Bytecode assign[] = {
+                Bytecode::createOpcode(Bytecode::e_NewObject),
+                Bytecode::create(Bytecode::e_SetGlobalSlot,
+                                 bdld::Datum::createInteger(
+                                                   engine.globalSlot("o"))),
+                Bytecode::createPush(bdld::Datum::createDouble(1)),
+                Bytecode::createOpcode(Bytecode::e_Return),
+            };
+            bdld::Datum result;
+            ASSERT(sjtu::InterpretUtil::e_TypeError ==
+                                              engine.execute(&result, assign));
+            ASSERT(sjtu::DatumUtil::s_Undefined == engine.getGlobal("o"));
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 10: {
+        if (verbose) cout << endl
+                          << "memory accounting" << endl
+                          << "=================" << endl;
+
+        typedef sjtt::MemoryMeter Meter;
+
+        enum { k_SIZE = 100 * 1000 };
+
+        bslma::TestAllocator ta(veryVerbose);
+        const bdld::Datum    NAME = bdld::Datum::copyString(
+                                          "a name too long to fit in a Datum",
+                                          &ta);
+        const bdld::Datum    BIG  = bdld::Datum::copyString(
+                                              bsl::string(k_SIZE, 'y'), &ta);
+        {
+            sjtm::Engine engine(&ta);
+            const Meter& meter = engine.memoryMeter();
+            ASSERT(0 == engine.memoryLimit());
+
+            // Every allocation of the engine is counted, by category.
+
+            ASSERT(meter.totalStats().d_numBytesInUse <= ta.numBytesInUse());
+            engine.setGlobal("name", NAME);
+            ASSERT(0 < meter.stats(Meter::e_Globals).d_numBytesInUse);
+
+            const bdld::Datum FILL =
+                               sjtu::DatumUtil::createExternalFunction(&fill);
+            const bdld::Datum SLOT =
+                            bdld::Datum::createInteger(engine.globalSlot("s"));
+
+            // 's = fill(k_SIZE); return s;'
+
+            const sjtt::Bytecode code[] = {
+                sjtt::Bytecode::createPush(
+                                         bdld::Datum::createInteger(k_SIZE)),
+                sjtt::Bytecode::createPush(FILL),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Execute),
+                sjtt::Bytecode::create(sjtt::Bytecode::e_SetGlobalSlot, SLOT),
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, SLOT),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+            const sjtt::Bytecode twice[] = {
+                sjtt::Bytecode::createPush(
+                                     bdld::Datum::createInteger(2 * k_SIZE)),
+                sjtt::Bytecode::createPush(FILL),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Execute),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+            const sjtt::Bytecode small[] = {
+                sjtt::Bytecode::createPush(bdld::Datum::createInteger(40)),
+                sjtt::Bytecode::createPush(FILL),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Execute),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+
+            bdld::Datum result;
+            ASSERT(0 == engine.execute(&result, code));
+            ASSERT(k_SIZE == result.theString().length());
+            ASSERT(k_SIZE <=
+                           meter.stats(Meter::e_Stacks).d_peakNumBytesInUse);
+
+            // The string assigned to 's' outlives the run: it is promoted
+            // into the script heap.
+
+            engine.resetArena();
+            ASSERT(k_SIZE <= meter.stats(Meter::e_Heap).d_numBytesInUse);
+
+            // A program exceeding the limit is stopped, and the engine
+            // remains usable.
+
+            ASSERT(0 == engine.execute(&result, code));
+            const bsls::Types::Int64 used =
+                                         meter.totalStats().d_numBytesInUse;
+            engine.setMemoryLimit(used + k_SIZE / 2);
+            ASSERT(used + k_SIZE / 2 == engine.memoryLimit());
+
+            result = bdld::Datum::createNull();
+            ASSERT(sjtu::InterpretUtil::e_OutOfMemory ==
+                                               engine.execute(&result, twice));
+            ASSERT(result.isNull());
+            ASSERT(1 == meter.numRefusals());
+            ASSERT(!meter.isLimitEnforced());
+            ASSERT(meter.totalStats().d_numBytesInUse <= used + k_SIZE / 2);
+
+            ASSERT(0 == engine.execute(&result, small));
+            ASSERT(40 == result.theString().length());
+
+            // Memory allocated outside of programs is never refused.
+
+            engine.setGlobal("big", BIG);
+            ASSERT(1 == meter.numRefusals());
+
+            engine.setMemoryLimit(0);
+            ASSERT(0 == engine.execute(&result, twice));
+            ASSERT(2 * k_SIZE == result.theString().length());
+            ASSERT(1 == meter.numRefusals());
+        }
+        bdld::Datum::destroy(NAME, &ta);
+        bdld::Datum::destroy(BIG, &ta);
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 9: {
+        if (verbose) cout << endl
+                          << "profiling" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        sjtm::Engine engine(&ta);
+        engine.setJitThreshold(1);
+        sjtu::Profile profile(&ta);
+        ASSERT(0 == engine.profile());
+        engine.setProfile(&profile);
+        ASSERT(&profile == engine.profile());
+
+        const sjtt::Bytecode code[] = {
+            sjtt::Bytecode::createPush(bdld::Datum::createDouble(1)),
+            sjtt::Bytecode::create(sjtt::Bytecode::e_PushAddDoubles,
+                                   bdld::Datum::createDouble(2)),
+            sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+        };
+        bdld::Datum result;
+        for (int i = 0; i < 5; ++i) {
+            ASSERT(0 == engine.execute(&result, code));
+            ASSERT(bdld::Datum::createDouble(3) == result);
+        }
+
+        // Profiled programs are not compiled.
+
+        ASSERT(0 == engine.numCompiledPrograms());
+        ASSERT(5 == profile.numInvocations(code));
+        ASSERT(5 == profile.numExecutions(sjtt::Bytecode::e_PushAddDoubles));
+
+        engine.setProfile(0);
+        ASSERT(0 == engine.execute(&result, code));
+        ASSERT(5 == profile.numInvocations(code));
+      } break;
+      case 8: {
+        if (verbose) cout << endl
+                          << "snapshots" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtm::Engine e(&ta);
+            e.setGlobal("pi", bdld::Datum::createDouble(3.25));
+            e.adoptGlobal("name",
+                          bdld::Datum::copyString(
+                                          "a name too long to fit in a Datum",
+                                          &ta),
+                          &ta);
+            {
+                bdld::DatumMutableMapRef map;
+                bdld::Datum::createUninitializedMap(&map, 1, &ta);
+                map.data()[0] = bdld::DatumMapEntry(
+                                             "e",
+                                             bdld::Datum::createDouble(2.5));
+                *map.size() = 1;
+                e.adoptGlobal("constants", bdld::Datum::adoptMap(map), &ta);
+            }
+            const bdld::Datum NAME =
+                              bdld::Datum::createInteger(e.globalSlot("name"));
+            const bdld::Datum LAST =
+                              bdld::Datum::createInteger(e.globalSlot("last"));
+
+            // 'last = greet(name); return last;'
+
+            const sjtt::Bytecode code[] = {
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, NAME),
+                sjtt::Bytecode::createPush(
+                             sjtu::DatumUtil::createExternalFunction(&greet)),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Execute),
+                sjtt::Bytecode::create(sjtt::Bytecode::e_SetGlobalSlot, LAST),
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, LAST),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+
+            bdld::Datum result;
+            ASSERT(0 == e.execute(&result, code));
+            e.globalSlot("unset");
+
+            bsl::vector<char> snapshot(&ta);
+            ASSERT(0 == e.saveSnapshot(&snapshot));
+
+            // A restored engine has the same globals, in the same slots, and
+            // none of its own.
+
+            sjtm::Engine f(&ta);
+            f.setGlobal("old", bdld::Datum::createInteger(1));
+            ASSERT(0 == f.fromSnapshot(snapshot.data(), snapshot.size()));
+            ASSERT(e.numGlobals() == f.numGlobals());
+            ASSERT(-1 == f.findGlobalSlot("old"));
+            for (int i = 0; i < e.numGlobals(); ++i) {
+                ASSERTV(i, e.getGlobal(i) == f.getGlobal(i));
+            }
+            ASSERT(e.globalSlot("last") == f.findGlobalSlot("last"));
+            ASSERT(sjtu::DatumUtil::s_Undefined == f.getGlobal("unset"));
+            const bdld::Datum *E = f.getGlobal("constants").theMap().find("e");
+            ASSERT(0 != E && bdld::Datum::createDouble(2.5) == *E);
+
+            // The image was copied, and the restored values refer to the
+            // copy.
+
+            const bsl::vector<char> original(snapshot, &ta);
+            bsl::fill(snapshot.begin(), snapshot.end(), 0);
+            ASSERT("hello, a name too long to fit in a Datum" ==
+                                             f.getGlobal("last").theString());
+
+            // Programs resolved against the saving engine run unchanged, and
+            // restored globals can be reassigned.
+
+            ASSERT(0 == f.execute(&result, code));
+            ASSERT("hello, a name too long to fit in a Datum" ==
+                                                        result.theString());
+            f.setGlobal("pi", bdld::Datum::createDouble(1));
+            f.collectGarbage();
+            ASSERT(bdld::Datum::createDouble(1) == f.getGlobal("pi"));
+
+            // An invalid image leaves the engine unchanged.
+
+            snapshot = original;
+            snapshot[snapshot.size() / 2] ^= 1;
+            ASSERT(sjtt::SnapshotImage::e_BadChecksum ==
+                             f.fromSnapshot(snapshot.data(), snapshot.size()));
+            ASSERT(e.numGlobals() == f.numGlobals());
+            ASSERT(bdld::Datum::createDouble(1) == f.getGlobal("pi"));
+
+            // Values that cannot be saved are reported.
+
+            snapshot = original;
+            e.setGlobal("greet",
+                        sjtu::DatumUtil::createExternalFunction(&greet));
+            ASSERT(0 != e.saveSnapshot(&snapshot));
+            ASSERT(original == snapshot);
+
+            // A snapshot can be restored from a mapped file.
+
+            const char *const PATH = "sjtm_engine.t.tmp";
+            FILE *file = bsl::fopen(PATH, "wb");
+            ASSERT(0 != file);
+            ASSERT(original.size() ==
+                      bsl::fwrite(original.data(), 1, original.size(), file));
+            ASSERT(0 == bsl::fclose(file));
+
+            sjtm::Engine g(&ta);
+            ASSERT(0 == g.fromSnapshotFile(PATH));
+            ASSERT(0 == bsl::remove(PATH));
+            ASSERT(bdld::Datum::createDouble(3.25) == g.getGlobal("pi"));
+            ASSERT(0 == g.execute(&result, code));
+            ASSERT("hello, a name too long to fit in a Datum" ==
+                                                        result.theString());
+            ASSERT(0 == g.fromSnapshot(original.data(), original.size()));
+            ASSERT(bdld::Datum::createDouble(3.25) == g.getGlobal("pi"));
+
+            ASSERT(sjtt::SnapshotImage::e_FileError ==
+                                  g.fromSnapshotFile("sjtm_engine.t.none"));
+            ASSERT(bdld::Datum::createDouble(3.25) == g.getGlobal("pi"));
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 7: {
+        if (verbose) cout << endl
+                          << "JIT compilation" << endl
+                          << "===============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtm::Engine e(&ta);
+            ASSERT(sjtm::Engine::k_DEFAULT_JIT_THRESHOLD == e.jitThreshold());
+            const bool SUPPORTED = e.isJitEnabled();
+            e.setJitThreshold(3);
+            ASSERT(3 == e.jitThreshold());
+
+            e.setGlobal("x", bdld::Datum::createDouble(10));
+            const bdld::Datum X = bdld::Datum::createInteger(
+                                                         e.globalSlot("x"));
+
+            // 'x + 1.5'
+
+            sjtt::Bytecode code[] = {
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, X),
+                sjtt::Bytecode::createPush(bdld::Datum::createDouble(1.5)),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_AddDoubles),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+
+            bdld::Datum result;
+            for (int i = 1; i <= 5; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, code));
+                ASSERTV(i, bdld::Datum::createDouble(11.5) == result);
+                ASSERTV(i, (SUPPORTED && 3 <= i) == e.numCompiledPrograms());
+            }
+
+            // A failed guard falls back to the interpreter and discards the
+            // native code.
+
+            e.setGlobal("x", sjtu::DatumUtil::s_Undefined);
+            ASSERT(0 != e.execute(&result, code));
+            ASSERT(0 == e.numCompiledPrograms());
+
+            e.setGlobal("x", bdld::Datum::createDouble(20));
+            for (int i = 1; i <= 3; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, code));
+                ASSERTV(i, bdld::Datum::createDouble(21.5) == result);
+            }
+            ASSERT(SUPPORTED == e.numCompiledPrograms());
+
+            // A program is discarded before it is changed.
+
+            e.discardProgram(code);
+            ASSERT(0 == e.numCompiledPrograms());
+            code[1] = sjtt::Bytecode::createPush(
+                                              bdld::Datum::createDouble(2.5));
+            ASSERT(0 == e.execute(&result, code));
+            ASSERT(bdld::Datum::createDouble(22.5) == result);
+            ASSERT(0 == e.numCompiledPrograms());
+
+            // The native code of a program changed without being discarded
+            // is not run.
+
+            for (int i = 0; i < 2; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, code));
+            }
+            ASSERT(SUPPORTED == e.numCompiledPrograms());
+            code[1] = sjtt::Bytecode::createPush(
+                                              bdld::Datum::createDouble(3.5));
+            ASSERT(0 == e.execute(&result, code));
+            ASSERT(bdld::Datum::createDouble(23.5) == result);
+            ASSERT(0 == e.numCompiledPrograms());
+            code[1] = sjtt::Bytecode::createPush(
+                                              bdld::Datum::createDouble(2.5));
+            e.discardProgram(code);
+
+            // Programs the compiler does not accept are interpreted.
+
+            const sjtt::Bytecode unsupported[] = {
+                sjtt::Bytecode::createPush(bdld::Datum::createInteger(1)),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+            for (int i = 0; i < 5; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, unsupported));
+                ASSERTV(i, bdld::Datum::createInteger(1) == result);
+            }
+
+            // Disabling the compiler releases all native code.
+
+            for (int i = 0; i < 3; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, code));
+            }
+            ASSERT(SUPPORTED == e.numCompiledPrograms());
+            e.setJitEnabled(false);
+            ASSERT(!e.isJitEnabled());
+            ASSERT(0 == e.numCompiledPrograms());
+            for (int i = 0; i < 5; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, code));
+                ASSERTV(i, bdld::Datum::createDouble(22.5) == result);
+            }
+            ASSERT(0 == e.numCompiledPrograms());
+            e.setJitEnabled(true);
+            ASSERT(SUPPORTED == e.isJitEnabled());
+
+            // At most 'k_MAX_JIT_PROFILES' programs are profiled at a time.
+
+            const int MAX = sjtm::Engine::k_MAX_JIT_PROFILES;
+            const int SIZE = sizeof code / sizeof *code;
+
+            bsl::vector<sjtt::Bytecode> programs(&ta);
+            for (int i = 0; i <= MAX; ++i) {
+                programs.insert(programs.end(), code, code + SIZE);
+            }
+            e.setJitThreshold(1);
+            for (int i = 0; i < MAX; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, &programs[i * SIZE]));
+                ASSERTV(i, bdld::Datum::createDouble(22.5) == result);
+            }
+            ASSERT(SUPPORTED * MAX == e.numCompiledPrograms());
+            ASSERT(0 == e.execute(&result, &programs[MAX * SIZE]));
+            ASSERT(bdld::Datum::createDouble(22.5) == result);
+            ASSERT(SUPPORTED * (MAX - MAX / 4 + 1) == e.numCompiledPrograms());
+            ASSERT(0 == e.execute(&result, code));
+            ASSERT(SUPPORTED * (MAX - MAX / 4 + 2) == e.numCompiledPrograms());
+
+            // A program executed often is still compiled while more than
+            // 'k_MAX_JIT_PROFILES' others are executed around it: the
+            // profiles of the others are discarded before its own.
+
+            e.setJitEnabled(false);
+            e.setJitEnabled(true);
+            e.setJitThreshold(sjtm::Engine::k_DEFAULT_JIT_THRESHOLD);
+
+            const int NUM_COLD = 4 * MAX;
+            const int PERIOD   = 16;  // too rare to get hot within MAX others
+
+            programs.clear();
+            for (int i = 0; i < NUM_COLD; ++i) {
+                programs.insert(programs.end(), code, code + SIZE);
+            }
+            sjtt::Bytecode hot[SIZE];
+            bsl::copy(code, code + SIZE, hot);
+            for (int i = 0; i < NUM_COLD; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, &programs[i * SIZE]));
+                if (0 == i % PERIOD) {
+                    ASSERTV(i, 0 == e.execute(&result, hot));
+                    ASSERTV(i, bdld::Datum::createDouble(22.5) == result);
+                }
+            }
+            ASSERT(NUM_COLD / PERIOD >= sjtm::Engine::k_DEFAULT_JIT_THRESHOLD);
+            ASSERT(MAX / PERIOD < sjtm::Engine::k_DEFAULT_JIT_THRESHOLD);
+            ASSERT(SUPPORTED == e.numCompiledPrograms());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 6: {
+        if (verbose) cout << endl
+                          << "garbage collection" << endl
+                          << "==================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtm::Engine e(&ta);
+            e.setGcPauseBudget(0);
+            e.adoptGlobal("name",
+                          bdld::Datum::copyString(
+                                          "a name too long to fit in a Datum",
+                                          &ta),
+                          &ta);
+            {
+                bdld::DatumMutableMapRef map;
+                bdld::Datum::createUninitializedMap(&map, 1, &ta);
+                map.data()[0] = bdld::DatumMapEntry(
+                                             "e",
+                                             bdld::Datum::createDouble(2.5));
+                *map.size() = 1;
+                e.adoptGlobal("constants", bdld::Datum::adoptMap(map), &ta);
+            }
+            const bdld::Datum NAME =
+                              bdld::Datum::createInteger(e.globalSlot("name"));
+            const bdld::Datum LAST =
+                              bdld::Datum::createInteger(e.globalSlot("last"));
+
+            // 'last = greet(name); return last;'
+
+            const sjtt::Bytecode code[] = {
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, NAME),
+                sjtt::Bytecode::createPush(
+                             sjtu::DatumUtil::createExternalFunction(&greet)),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Execute),
+                sjtt::Bytecode::create(sjtt::Bytecode::e_SetGlobalSlot, LAST),
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, LAST),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+
+            bdld::Datum result;
+            for (int i = 0; i < 10; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, code));
+                ASSERTV(i, "hello, a name too long to fit in a Datum" ==
+                                             e.getGlobal("last").theString());
+            }
+
+            // Each execution promoted the previous value of 'last'.
+
+            ASSERT(10 == e.heapStats().d_numMinorCollections);
+            ASSERT(0 < e.heapStats().d_numBytesPromoted);
+            ASSERT(e.heapStats().d_numBytesPromoted ==
+                                             e.heapStats().d_numBytesTenured);
+
+            // The values no longer referred to are collected.
+
+            e.collectGarbage();
+            ASSERT(1 == e.heapStats().d_numMajorCollections);
+            ASSERT(0 < e.heapStats().d_numBytesTenured);
+            ASSERT(9 * e.heapStats().d_numBytesTenured ==
+                                            e.heapStats().d_numBytesCollected);
+            ASSERT("hello, a name too long to fit in a Datum" ==
+                                             e.getGlobal("last").theString());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 5: {
+        if (verbose) cout << endl
+                          << "execution arena" << endl
+                          << "===============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            char buffer[512];
+            sjtm::Engine e(buffer, sizeof buffer, &ta);
+            e.adoptGlobal("name",
+                          bdld::Datum::copyString(
+                                          "a name too long to fit in a Datum",
+                                          &ta),
+                          &ta);
+            {
+                bdld::DatumMutableMapRef map;
+                bdld::Datum::createUninitializedMap(&map, 1, &ta);
+                map.data()[0] = bdld::DatumMapEntry(
+                                             "e",
+                                             bdld::Datum::createDouble(2.5));
+                *map.size() = 1;
+                e.adoptGlobal("constants", bdld::Datum::adoptMap(map), &ta);
+            }
+            const bdld::Datum NAME =
+                              bdld::Datum::createInteger(e.globalSlot("name"));
+            const sjtt::Bytecode code[] = {
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, NAME),
+                sjtt::Bytecode::createPush(
+                                 sjtu::DatumUtil::createExternalFunction(&greet)),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Execute),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+
+            bdld::Datum result;
+            ASSERT(0 == e.execute(&result, code));
+            ASSERT("hello, a name too long to fit in a Datum" ==
+                                                          result.theString());
+
+            // Temporaries come from the arena, so repeated executions do not
+            // allocate.
+
+            const long long numAllocations = ta.numAllocations();
+            for (int i = 0; i < 100; ++i) {
+                ASSERTV(i, 0 == e.execute(&result, code));
+            }
+            ASSERT(numAllocations == ta.numAllocations());
+            ASSERT(buffer <= result.theString().data());
+            ASSERT(result.theString().data() < buffer + sizeof buffer);
+            e.resetArena();
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "adopting and sharing globals" << endl
+                          << "============================" << endl;
+
+        const char *const TEXT = "a string long enough to need an allocation";
+
+        bslma::TestAllocator ta(veryVerbose);
+        bslma::TestAllocator tb(veryVerbose);
+        bslma::TestAllocator tc(veryVerbose);
+        {
+            sjtm::Engine e(&ta);
+            sjtm::Engine f(&tb);
+            const int slot = e.globalSlot("table");
+            e.setGlobal("copied", bdld::Datum::createDouble(1));
+            e.globalSlot("config");
+
+            // Adopting a value hands it over without copying it.
+
+            const long long numAllocations = ta.numAllocations();
+            bdld::ManagedDatum config(bdld::Datum::copyString(TEXT, &tc),
+                                      &tc);
+            const char *data = config->theString().data();
+            e.adoptGlobal("config", config.release(), config.allocator());
+            ASSERT(data == e.getGlobal("config").theString().data());
+            e.adoptGlobal(e.findGlobalSlot("config"),
+                          bdld::Datum::copyString(TEXT, &tc),
+                          &tc);
+            ASSERT(TEXT == e.getGlobal("config").theString());
+            ASSERT(numAllocations == ta.numAllocations());
+
+            // A shared value is referred to by any number of engines.
+
+            const sjtm::Engine::SharedDatum table =
+                sjtt::GlobalValue::createShared(e.getGlobal("config"), &tc);
+            e.shareGlobal(slot, table);
+            f.shareGlobal("table", table);
+            ASSERT(table->datum().theString().data() ==
+                                      e.getGlobal(slot).theString().data());
+            ASSERT(table->datum().theString().data() ==
+                                  f.getGlobal("table").theString().data());
+            ASSERT(3 == table.use_count());
+
+            // Copying assignment is still available.
+
+            e.setGlobal("copied", f.getGlobal("table"));
+            ASSERT(TEXT == e.getGlobal("copied").theString());
+            ASSERT(e.getGlobal("copied").theString().data() !=
+                                    table->datum().theString().data());
+        }
+        ASSERT(0 == tc.numBytesInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "executing with globals" << endl
+                          << "======================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        sjtm::Engine e(&ta);
+        const int count = e.globalSlot("count");
+        e.setGlobal(count, bdld::Datum::createDouble(1));
+
+        const bdld::Datum COUNT = bdld::Datum::createInteger(count);
+        const sjtt::Bytecode code[] = {
+            sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, COUNT),
+            sjtt::Bytecode::createPush(bdld::Datum::createDouble(1)),
+            sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_AddDoubles),
+            sjtt::Bytecode::create(sjtt::Bytecode::e_SetGlobalSlot, COUNT),
+            sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, COUNT),
+            sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+        };
+        bdld::Datum result;
+        ASSERT(0 == e.execute(&result, code));
+        ASSERTV(result, bdld::Datum::createDouble(2) == result);
+        ASSERT(0 == e.execute(&result, code));
+        ASSERTV(result, bdld::Datum::createDouble(3) == result);
+        ASSERT(bdld::Datum::createDouble(3) == e.getGlobal("count"));
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "global slots" << endl
+                          << "============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        sjtm::Engine e(&ta);
+        ASSERT(0 == e.numGlobals());
+        ASSERT(-1 == e.findGlobalSlot("x"));
+
+        // Looking up a missing global does not create it.
+
+        ASSERT(sjtu::DatumUtil::s_Undefined == e.getGlobal("x"));
+        ASSERT(0 == e.numGlobals());
+
+        const int x = e.globalSlot("x");
+        const int y = e.globalSlot("y");
+        ASSERT(0 == x);
+        ASSERT(1 == y);
+        ASSERT(x == e.globalSlot("x"));
+        ASSERT(x == e.findGlobalSlot("x"));
+        ASSERT(2 == e.numGlobals());
+        ASSERT(sjtu::DatumUtil::s_Undefined == e.getGlobal(x));
+
+        e.setGlobal(x, bdld::Datum::createDouble(1));
+        e.setGlobal("y", bdld::Datum::createDouble(2));
+        e.setGlobal("z", bdld::Datum::createDouble(3));
+        ASSERT(3 == e.numGlobals());
+        ASSERT(bdld::Datum::createDouble(1) == e.getGlobal("x"));
+        ASSERT(bdld::Datum::createDouble(2) == e.getGlobal(y));
+        ASSERT(bdld::Datum::createDouble(3) ==
+                                          e.getGlobal(e.findGlobalSlot("z")));
+      } break;
       case 1: {
         if (verbose) cout << endl
                           << "breathing tet" << endl
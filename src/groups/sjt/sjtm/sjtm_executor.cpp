@@ -0,0 +1,271 @@
+#include <sjtm_executor.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_globalvalue.h>
+
+#include <bslma_default.h>
+#include <bslmt_lockguard.h>
+
+namespace sjtm {
+
+namespace {
+
+struct WorkerRunner {
+    // This 'struct' runs a worker of an executor on a thread created by
+    // 'Executor::start'.
+
+    // DATA
+    Executor *d_executor_p;  // executor of the worker
+    int       d_index;       // index of the worker
+
+    // MANIPULATORS
+    void operator()() {
+        d_executor_p->runWorker(d_index);
+    }
+};
+
+bool writesInstructions(const sjtt::Bytecode *code)
+    // Return 'true' if the program beginning at the specified 'code' has an
+    // instruction whose data the interpreter modifies, and 'false'
+    // otherwise.  The instructions are scanned in order up to the first one
+    // that does not continue with the next, e.g., an 'e_Return', and that is
+    // beyond every forward branch or call seen, so that only instructions of
+    // the program are read.
+{
+    typedef sjtt::Bytecode Bytecode;
+
+    bsl::size_t end = 0;  // furthest target of the branches and calls seen
+    for (bsl::size_t i = 0;; ++i) {
+        const Bytecode::Opcode opcode = code[i].opcode();
+        if (Bytecode::e_GetProperty == opcode
+         || Bytecode::e_SetProperty == opcode) {
+            return true;                                              // RETURN
+        }
+        if ((Bytecode::isBranch(opcode) || Bytecode::isCall(opcode))
+         && code[i].data().isInteger()
+         && 0 < code[i].data().theInteger()) {
+            const bsl::size_t target = i + code[i].data().theInteger();
+            end = target > end ? target : end;
+        }
+        if ((Bytecode::e_Return   == opcode
+          || Bytecode::e_Jump     == opcode
+          || Bytecode::e_Loop     == opcode
+          || Bytecode::e_TailCall == opcode)
+         && end <= i) {
+            return false;                                             // RETURN
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+                               // --------------
+                               // class Executor
+                               // --------------
+
+// PRIVATE MANIPULATORS
+void Executor::finish(Executor_Job *job) {
+    d_allocator_p->deleteObject(job);
+    if (0 == d_numPending.add(-1)) {
+        BloombergLP::bslmt::LockGuard<BloombergLP::bslmt::Mutex> guard(
+                                                                    &d_mutex);
+        d_allDone.broadcast();
+    }
+}
+
+Executor_Job *Executor::steal(Executor_Worker *worker) {
+    const unsigned int numWorkers = static_cast<unsigned int>(
+                                                            d_workers.size());
+
+    // Start from a random victim (xorshift), so that thieves spread out.
+
+    unsigned int random = worker->d_random;
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    worker->d_random = random;
+
+    for (unsigned int i = 0; i < numWorkers; ++i) {
+        Executor_Worker *victim = d_workers[(random + i) % numWorkers];
+        if (victim == worker) {
+            continue;                                               // CONTINUE
+        }
+        Executor_Job *job = victim->d_deque.steal();
+        if (job) {
+            worker->d_numStolen.addRelaxed(1);
+            return job;                                               // RETURN
+        }
+    }
+    return 0;
+}
+
+Executor_Job *Executor::takeQueued(Executor_Worker *worker) {
+    if (d_queue.empty()) {
+        return 0;                                                     // RETURN
+    }
+    Executor_Job *job = d_queue.front();
+    d_queue.pop_front();
+
+    // Take a fair share of the queue, so that other workers are left some,
+    // and can steal the rest of the batch if this worker is slow.
+
+    bsl::size_t batch = d_queue.size() / d_workers.size() + 1;
+    if (batch > k_MAX_BATCH - 1) {
+        batch = k_MAX_BATCH - 1;
+    }
+    bsl::size_t numMoved = 0;
+    while (numMoved < batch
+        && !d_queue.empty()
+        && 0 == worker->d_deque.push(d_queue.front())) {
+        d_queue.pop_front();
+        ++numMoved;
+    }
+    if (0 < numMoved && 0 < d_numSleeping) {
+        d_workReady.signal();
+    }
+    return job;
+}
+
+// CREATORS
+Executor::Executor(int numWorkers, BloombergLP::bslma::Allocator *allocator)
+    : d_workers(allocator)
+    , d_threads(allocator)
+    , d_queue(allocator)
+    , d_numSleeping(0)
+    , d_stopping(false)
+    , d_numPending(0)
+    , d_allocator_p(BloombergLP::bslma::Default::allocator(allocator)) {
+    BSLS_ASSERT(0 < numWorkers);
+
+    d_workers.reserve(numWorkers);
+    for (int i = 0; i < numWorkers; ++i) {
+        d_workers.push_back(new (*d_allocator_p) Executor_Worker(
+                                                        k_DEQUE_CAPACITY,
+                                                        2654435761u * (i + 1),
+                                                        d_allocator_p));
+    }
+}
+
+Executor::~Executor() {
+    stop();
+    join();
+    for (bsl::size_t i = 0; i < d_queue.size(); ++i) {
+        d_allocator_p->deleteObject(d_queue[i]);
+    }
+    for (bsl::size_t i = 0; i < d_workers.size(); ++i) {
+        d_allocator_p->deleteObject(d_workers[i]);
+    }
+}
+
+// MANIPULATORS
+int Executor::globalSlot(const BloombergLP::bslstl::StringRef& name) {
+    int slot = -1;
+    for (bsl::size_t i = 0; i < d_workers.size(); ++i) {
+        slot = d_workers[i]->d_engine.globalSlot(name);
+    }
+    return slot;
+}
+
+void Executor::setGlobal(const BloombergLP::bslstl::StringRef& name,
+                         const BloombergLP::bdld::Datum&       value) {
+    shareGlobal(name, sjtt::GlobalValue::createShared(value, d_allocator_p));
+}
+
+void Executor::shareGlobal(const BloombergLP::bslstl::StringRef& name,
+                           const SharedDatum&                    value) {
+    for (bsl::size_t i = 0; i < d_workers.size(); ++i) {
+        d_workers[i]->d_engine.shareGlobal(name, value);
+    }
+}
+
+int Executor::submit(const sjtt::Bytecode *code, const Callback& callback) {
+    BSLS_ASSERT(0 != code);
+
+    if (writesInstructions(code)) {
+        return 1;                                                     // RETURN
+    }
+    Executor_Job *job = new (*d_allocator_p) Executor_Job(code, callback);
+    BloombergLP::bslmt::LockGuard<BloombergLP::bslmt::Mutex> guard(&d_mutex);
+    if (d_stopping) {
+        d_allocator_p->deleteObject(job);
+        return 1;                                                     // RETURN
+    }
+    d_queue.push_back(job);
+    d_numPending.add(1);
+    if (0 < d_numSleeping) {
+        d_workReady.signal();
+    }
+    return 0;
+}
+
+void Executor::wait() {
+    BloombergLP::bslmt::LockGuard<BloombergLP::bslmt::Mutex> guard(&d_mutex);
+    while (0 != d_numPending.load()) {
+        d_allDone.wait(&d_mutex);
+    }
+}
+
+int Executor::start() {
+    BSLS_ASSERT(d_threads.empty());
+
+    d_threads.reserve(d_workers.size());
+    for (bsl::size_t i = 0; i < d_workers.size(); ++i) {
+        const WorkerRunner runner = { this, static_cast<int>(i) };
+        ThreadHandle       handle;
+        if (0 != BloombergLP::bslmt::ThreadUtil::create(&handle, runner)) {
+            return 1;                                                 // RETURN
+        }
+        d_threads.push_back(handle);
+    }
+    return 0;
+}
+
+void Executor::runWorker(int index) {
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < numWorkers());
+
+    Executor_Worker *worker = d_workers[index];
+    while (true) {
+        Executor_Job *job = worker->d_deque.pop();
+        if (!job) {
+            job = steal(worker);
+        }
+        if (!job) {
+            BloombergLP::bslmt::LockGuard<BloombergLP::bslmt::Mutex> guard(
+                                                                    &d_mutex);
+            job = takeQueued(worker);
+            if (!job) {
+                if (d_stopping) {
+                    // Jobs left in the deques of other workers will be run
+                    // by their owners, which are not waiting.
+
+                    return;                                           // RETURN
+                }
+                ++d_numSleeping;
+                d_workReady.wait(&d_mutex);
+                --d_numSleeping;
+                continue;                                           // CONTINUE
+            }
+        }
+
+        BloombergLP::bdld::Datum result;
+        const int rc = worker->d_engine.execute(&result, job->d_code_p);
+        job->d_callback(rc, result);
+        worker->d_numExecuted.addRelaxed(1);
+        finish(job);
+    }
+}
+
+void Executor::stop() {
+    BloombergLP::bslmt::LockGuard<BloombergLP::bslmt::Mutex> guard(&d_mutex);
+    d_stopping = true;
+    d_workReady.broadcast();
+}
+
+void Executor::join() {
+    for (bsl::size_t i = 0; i < d_threads.size(); ++i) {
+        BloombergLP::bslmt::ThreadUtil::join(d_threads[i]);
+    }
+    d_threads.clear();
+}
+}
@@ -0,0 +1,310 @@
+#ifndef INCLUDED_SJTM_EXECUTOR
+#define INCLUDED_SJTM_EXECUTOR
+
+#ifndef INCLUDED_SJTM_ENGINE
+#include <sjtm_engine.h>
+#endif
+
+#ifndef INCLUDED_SJTT_WORKDEQUE
+#include <sjtt_workdeque.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_CONDITION
+#include <bslmt_condition.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_MUTEX
+#include <bslmt_mutex.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_THREADUTIL
+#include <bslmt_threadutil.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ATOMIC
+#include <bsls_atomic.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+#ifndef INCLUDED_BSL_DEQUE
+#include <bsl_deque.h>
+#endif
+
+#ifndef INCLUDED_BSL_FUNCTIONAL
+#include <bsl_functional.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt { class Bytecode; }
+
+namespace sjtm {
+
+                            // ===================
+                            // struct Executor_Job
+                            // ===================
+
+struct Executor_Job {
+    // This component-private struct describes a program submitted to an
+    // 'Executor' and what to do with its result.
+
+    // TYPES
+    typedef bsl::function<void(int, const BloombergLP::bdld::Datum&)>
+                                                                    Callback;
+
+    // DATA
+    const sjtt::Bytecode *d_code_p;    // program to execute
+    Callback              d_callback;  // receives the result
+
+    // CREATORS
+    Executor_Job(const sjtt::Bytecode *code, const Callback& callback)
+    : d_code_p(code)
+    , d_callback(callback) {
+    }
+};
+
+                           // ======================
+                           // struct Executor_Worker
+                           // ======================
+
+struct Executor_Worker {
+    // This component-private struct holds the state owned by one worker of
+    // an 'Executor'.
+
+    // DATA
+    Engine                          d_engine;       // globals, arena, heap,
+                                                    // and native code
+    sjtt::WorkDeque<Executor_Job>   d_deque;        // jobs of this worker
+    unsigned int                    d_random;       // state for choosing
+                                                    // victims to steal from
+    BloombergLP::bsls::AtomicInt64  d_numExecuted;  // jobs run
+    BloombergLP::bsls::AtomicInt64  d_numStolen;    // jobs taken from others
+
+    // CREATORS
+    Executor_Worker(bsl::size_t                    dequeCapacity,
+                    unsigned int                   seed,
+                    BloombergLP::bslma::Allocator *allocator)
+    : d_engine(allocator)
+    , d_deque(dequeCapacity, allocator)
+    , d_random(seed)
+    , d_numExecuted(0)
+    , d_numStolen(0) {
+    }
+};
+
+                               // ==============
+                               // class Executor
+                               // ==============
+
+class Executor {
+    // This class provides a mechanism for executing Scramjet programs on a
+    // fixed number of workers in parallel.  Each worker has an 'Engine' of
+    // its own, and therefore its own execution arena, heap, and native code,
+    // so that workers share no mutable state while running programs.  What
+    // is shared is read-only: the programs themselves, which must not be
+    // modified while they may be executing, and the globals, which are
+    // given to all workers, with the same slots, before they start (see
+    // 'globalSlot', 'setGlobal', and 'shareGlobal'), as shared, immutable
+    // values that workers read without locks or copies.  A program that
+    // assigns a global changes it only in the engine of the worker running
+    // it, so programs run by an executor should treat globals as constants.
+    // Since the instructions of a program are shared, 'submit' rejects
+    // programs accessing properties, whose inline caches
+    // ('sjtt::PropertyCache') the interpreter modifies in place.  The type
+    // feedback of arithmetic instructions ('sjtt::TypeFeedback') and the
+    // counters of loops ('sjtt::LoopCounter') are updated atomically, so
+    // that the workers may share them.
+    //
+    // Jobs are scheduled by work stealing.  Each worker has a bounded,
+    // lock-free deque of jobs (see 'sjtt::WorkDeque'); a worker runs the
+    // jobs in its own deque first and, when it is empty, steals from the
+    // deques of other workers, chosen at random.  Jobs submitted from outside
+    // go to a shared queue, from which an idle worker takes a batch at a
+    // time into its deque, where other workers may steal them, so that the
+    // lock of the queue is taken about once per batch rather than once per
+    // job.  Workers with nothing to do sleep until jobs are submitted.
+    //
+    // The number of workers is fixed at construction, so embedders can cap
+    // the threads used by scripts.  The workers can be run on threads
+    // created by the executor ('start') or on threads supplied by the
+    // embedder, each of which calls 'runWorker' with a distinct index.
+    // Either way, workers return once 'stop' has been called and all
+    // submitted jobs have been run.
+    //
+    // The allocator of an executor is used by all workers concurrently and
+    // must therefore be thread-safe.
+
+  public:
+    // TYPES
+    typedef Executor_Job::Callback Callback;
+        // Invoked, on the thread of the worker that ran a job, with the
+        // status returned by 'Engine::execute' and the result of the
+        // program, which is valid only until the callback returns.
+
+    typedef Engine::SharedDatum    SharedDatum;
+
+    enum {
+        k_DEQUE_CAPACITY = 256,  // jobs held by the deque of a worker
+        k_MAX_BATCH      = 32    // jobs taken from the shared queue at once
+    };
+
+  private:
+    // PRIVATE TYPES
+    typedef BloombergLP::bslmt::ThreadUtil::Handle ThreadHandle;
+
+    // DATA
+    bsl::vector<Executor_Worker *>  d_workers;      // owned
+    bsl::vector<ThreadHandle>       d_threads;      // created by 'start'
+    bsl::deque<Executor_Job *>      d_queue;        // submitted jobs, owned
+    BloombergLP::bslmt::Mutex       d_mutex;        // guards the state below
+    BloombergLP::bslmt::Condition   d_workReady;    // jobs queued, or stopping
+    BloombergLP::bslmt::Condition   d_allDone;      // no jobs pending
+    int                             d_numSleeping;  // workers waiting
+    bool                            d_stopping;     // 'stop' was called
+    BloombergLP::bsls::AtomicInt64  d_numPending;   // submitted, unfinished
+    BloombergLP::bslma::Allocator  *d_allocator_p;  // memory allocator (held)
+
+    // NOT IMPLEMENTED
+    Executor(const Executor&);
+    Executor& operator=(const Executor&);
+
+    // PRIVATE MANIPULATORS
+    void finish(Executor_Job *job);
+        // Destroy the specified 'job', which has been run, and notify
+        // 'wait' if it was the last pending one.
+
+    Executor_Job *steal(Executor_Worker *worker);
+        // Return a job stolen by the specified 'worker' from another worker,
+        // or 0 if none was found.
+
+    Executor_Job *takeQueued(Executor_Worker *worker);
+        // Return a job from the shared queue, moving up to 'k_MAX_BATCH - 1'
+        // more into the deque of the specified 'worker', or return 0 if the
+        // queue is empty.  The behavior is undefined unless 'd_mutex' is
+        // locked by the calling thread.
+
+  public:
+    // CREATORS
+    explicit Executor(int                            numWorkers,
+                      BloombergLP::bslma::Allocator *allocator = 0);
+        // Create an executor having the specified 'numWorkers' workers, none
+        // of which is running.  Optionally specify a thread-safe 'allocator'
+        // used to supply memory.  If 'allocator' is 0, the currently
+        // installed default allocator is used.  The behavior is undefined
+        // unless '0 < numWorkers'.
+
+    ~Executor();
+        // Stop this executor, wait for the threads created by 'start', if
+        // any, to finish the submitted jobs, and destroy it.  Jobs not run,
+        // because no worker was ever run, are discarded.  The behavior is
+        // undefined if a worker run by 'runWorker' has not returned.
+
+    // MANIPULATORS
+    int globalSlot(const BloombergLP::bslstl::StringRef& name);
+        // Return the slot of the global having the specified 'name' in all
+        // workers, creating it, with an undefined value, if it does not
+        // exist.  The behavior is undefined if a worker is running.
+
+    void setGlobal(const BloombergLP::bslstl::StringRef& name,
+                   const BloombergLP::bdld::Datum&       value);
+        // Give the global having the specified 'name', creating it if it
+        // does not exist, a shared, immutable copy of the specified 'value'
+        // in all workers.  The behavior is undefined if a worker is running.
+
+    void shareGlobal(const BloombergLP::bslstl::StringRef& name,
+                     const SharedDatum&                    value);
+        // Give the global having the specified 'name', creating it if it
+        // does not exist, the specified shared 'value' in all workers,
+        // without copying it.  The behavior is undefined unless 'value' is
+        // not empty, and if a worker is running.
+
+    int submit(const sjtt::Bytecode *code, const Callback& callback);
+        // Schedule the program beginning at the specified 'code' to be
+        // executed by a worker, which then invokes the specified 'callback'
+        // with the result.  Return 0 on success, and a non-zero value, with
+        // no effect, if 'stop' has been called or if the program has an
+        // 'e_GetProperty' or 'e_SetProperty' instruction, whose cache would
+        // be modified by several workers at once.  This method is
+        // thread-safe.  The behavior is undefined unless every path through
+        // 'code' ends with 'e_Return', and unless 'code' remains valid and
+        // unmodified until 'callback' has been invoked.
+
+    void wait();
+        // Block until all jobs submitted so far have been run.  This method
+        // is thread-safe.  The behavior is undefined unless workers are
+        // running or will be run.
+
+    int start();
+        // Create one thread for each worker, which runs it as if by
+        // 'runWorker'.  Return 0 on success, and a non-zero value otherwise.
+        // The behavior is undefined if this method has been called before,
+        // or if 'runWorker' is used.
+
+    void runWorker(int index);
+        // Run the worker having the specified 'index' on the calling thread,
+        // returning once 'stop' has been called and no jobs are left.  The
+        // behavior is undefined unless '0 <= index < numWorkers()' and no
+        // other thread is running the same worker.
+
+    void stop();
+        // Reject further jobs, and make the workers return once all
+        // submitted jobs have been run.  This method is thread-safe.
+
+    void join();
+        // Wait for the threads created by 'start', if any, to return.  The
+        // behavior is undefined unless 'stop' has been called.
+
+    // ACCESSORS
+    int numWorkers() const;
+        // Return the number of workers of this executor.
+
+    BloombergLP::bsls::Types::Int64 numJobsExecuted(int index) const;
+        // Return the number of jobs run by the worker having the specified
+        // 'index'.  The behavior is undefined unless
+        // '0 <= index < numWorkers()'.
+
+    BloombergLP::bsls::Types::Int64 numJobsStolen(int index) const;
+        // Return the number of jobs the worker having the specified 'index'
+        // stole from other workers.  The behavior is undefined unless
+        // '0 <= index < numWorkers()'.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+// ACCESSORS
+inline
+int Executor::numWorkers() const {
+    return static_cast<int>(d_workers.size());
+}
+
+inline
+BloombergLP::bsls::Types::Int64 Executor::numJobsExecuted(int index) const {
+    BSLS_ASSERT_SAFE(0 <= index);
+    BSLS_ASSERT_SAFE(index < numWorkers());
+    return d_workers[index]->d_numExecuted.loadRelaxed();
+}
+
+inline
+BloombergLP::bsls::Types::Int64 Executor::numJobsStolen(int index) const {
+    BSLS_ASSERT_SAFE(0 <= index);
+    BSLS_ASSERT_SAFE(index < numWorkers());
+    return d_workers[index]->d_numStolen.loadRelaxed();
+}
+}
+
+#endif
@@ -0,0 +1,401 @@
+// sjtm_executor.t.cpp                                   -*-C++-*-
+
+#include <sjtm_executor.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_globalvalue.h>
+#include <sjtt_propertycache.h>
+#include <sjtu_datumutil.h>
+
+#include <bslma_testallocator.h>
+#include <bslmt_threadutil.h>
+#include <bsls_atomic.h>
+
+#include <bdls_testutil.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+struct Checker {
+    // This 'struct' counts the results of jobs equal to an expected double.
+
+    // DATA
+    double           d_expected;  // expected result
+    bsls::AtomicInt *d_count_p;   // number of expected results received
+
+    // MANIPULATORS
+    void operator()(int status, const bdld::Datum& result) const {
+        if (0 == status
+         && result.isDouble()
+         && d_expected == result.theDouble()) {
+            d_count_p->add(1);
+        }
+    }
+};
+
+struct WorkerThread {
+    // This 'struct' runs a worker of an executor on a thread supplied by the
+    // test, as an embedder would.
+
+    // DATA
+    sjtm::Executor *d_executor_p;  // executor of the worker
+    int             d_index;       // index of the worker
+
+    // MANIPULATORS
+    void operator()() {
+        d_executor_p->runWorker(d_index);
+    }
+};
+
+struct Submitter {
+    // This 'struct' submits jobs to an executor from a thread of its own.
+
+    // DATA
+    sjtm::Executor       *d_executor_p;  // executor to submit to
+    const sjtt::Bytecode *d_code_p;      // program to submit
+    Checker               d_checker;     // checks the results
+    int                   d_numJobs;     // number of jobs to submit
+
+    // MANIPULATORS
+    void operator()() {
+        for (int i = 0; i < d_numJobs; ++i) {
+            ASSERTV(i, 0 == d_executor_p->submit(d_code_p, d_checker));
+        }
+    }
+};
+
+bsls::Types::Int64 totalExecuted(const sjtm::Executor& executor)
+    // Return the number of jobs run by all workers of the specified
+    // 'executor'.
+{
+    bsls::Types::Int64 total = 0;
+    for (int i = 0; i < executor.numWorkers(); ++i) {
+        total += executor.numJobsExecuted(i);
+    }
+    return total;
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 5: {
+        if (verbose) cout << endl
+                          << "shared instructions" << endl
+                          << "===================" << endl;
+
+        typedef sjtt::Bytecode Bytecode;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtt::PropertyCache cache("x", &ta);
+            const Bytecode      NEW  = Bytecode::createOpcode(
+                                                      Bytecode::e_NewObject);
+            const Bytecode      GETP = Bytecode::create(
+                                 Bytecode::e_GetProperty,
+                                 sjtu::DatumUtil::createPropertyCache(&cache));
+            const Bytecode      RET  = Bytecode::createOpcode(
+                                                         Bytecode::e_Return);
+            const Bytecode      ONE  = Bytecode::createPush(
+                                              bdld::Datum::createDouble(1));
+            const Bytecode      TRUE = Bytecode::createPush(
+                                           bdld::Datum::createBoolean(true));
+
+            const struct {
+                int      d_line;
+                Bytecode d_code[8];
+                bool     d_isAccepted;
+            } DATA[] = {
+                { L_, { ONE, RET },                                 true  },
+                { L_, { NEW, GETP, RET },                           false },
+                { L_, { NEW,
+                        Bytecode::create(
+                                Bytecode::e_SetProperty,
+                                sjtu::DatumUtil::createPropertyCache(&cache)),
+                        RET },                                      false },
+
+                // Instructions after the end of the program are not read.
+
+                { L_, { ONE, RET, NEW, GETP, RET },                 true  },
+
+                // Instructions reached by a branch or call are.
+
+                { L_, { TRUE,
+                        Bytecode::create(Bytecode::e_JumpIfFalse,
+                                         bdld::Datum::createInteger(3)),
+                        ONE, RET, NEW, GETP, RET },                 false },
+                { L_, { ONE,
+                        Bytecode::create(Bytecode::e_Call,
+                                         bdld::Datum::createInteger(2)),
+                        RET,
+                        Bytecode::create(Bytecode::e_Function,
+                                         bdld::Datum::createInteger(1)),
+                        NEW, GETP, RET },                           false },
+            };
+            const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+            sjtm::Executor  mX(1, &ta);
+            bsls::AtomicInt count(0);
+            const Checker   checker = { 1, &count };
+            for (int ti = 0; ti < NUM_DATA; ++ti) {
+                const int LINE = DATA[ti].d_line;
+                const int rc   = mX.submit(DATA[ti].d_code, checker);
+                ASSERTV(LINE, rc, DATA[ti].d_isAccepted == (0 == rc));
+            }
+            ASSERT(0 == mX.start());
+            mX.stop();
+            mX.join();
+            ASSERT(2 == count);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "concurrent submitters" << endl
+                          << "=====================" << endl;
+
+        enum { k_NUM_SUBMITTERS = 4, k_NUM_JOBS = 2000 };
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtm::Executor mX(4, &ta);
+            mX.setGlobal("x", bdld::Datum::createDouble(1));
+            const bdld::Datum X =
+                            bdld::Datum::createInteger(mX.globalSlot("x"));
+            const sjtt::Bytecode code[] = {
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot, X),
+                sjtt::Bytecode::createPush(bdld::Datum::createDouble(2)),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_AddDoubles),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+            ASSERT(0 == mX.start());
+
+            bsls::AtomicInt count(0);
+            Submitter submitters[k_NUM_SUBMITTERS];
+            bslmt::ThreadUtil::Handle handles[k_NUM_SUBMITTERS];
+            for (int i = 0; i < k_NUM_SUBMITTERS; ++i) {
+                const Submitter submitter = {
+                    &mX, code, { 3, &count }, k_NUM_JOBS
+                };
+                submitters[i] = submitter;
+                ASSERT(0 == bslmt::ThreadUtil::create(&handles[i],
+                                                      submitters[i]));
+            }
+            for (int i = 0; i < k_NUM_SUBMITTERS; ++i) {
+                ASSERT(0 == bslmt::ThreadUtil::join(handles[i]));
+            }
+            mX.wait();
+            ASSERTV(count.load(), k_NUM_SUBMITTERS * k_NUM_JOBS == count);
+            ASSERT(k_NUM_SUBMITTERS * k_NUM_JOBS == totalExecuted(mX));
+            if (verbose) {
+                for (int i = 0; i < mX.numWorkers(); ++i) {
+                    cout << "worker " << i << ": "
+                         << mX.numJobsExecuted(i) << " executed, "
+                         << mX.numJobsStolen(i) << " stolen" << endl;
+                }
+            }
+            mX.stop();
+            mX.join();
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "stopping" << endl
+                          << "========" << endl;
+
+        const sjtt::Bytecode code[] = {
+            sjtt::Bytecode::createPush(bdld::Datum::createDouble(1)),
+            sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+        };
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            // Jobs submitted before 'stop' are run before the workers
+            // return, and later ones are rejected.
+
+            sjtm::Executor mX(2, &ta);
+            bsls::AtomicInt count(0);
+            const Checker checker = { 1, &count };
+            for (int i = 0; i < 100; ++i) {
+                ASSERTV(i, 0 == mX.submit(code, checker));
+            }
+            mX.stop();
+            ASSERT(0 != mX.submit(code, checker));
+            ASSERT(0 == mX.start());
+            mX.join();
+            ASSERT(100 == count);
+            ASSERT(100 == totalExecuted(mX));
+        }
+        {
+            // Jobs never run are discarded.
+
+            sjtm::Executor mX(2, &ta);
+            bsls::AtomicInt count(0);
+            const Checker checker = { 1, &count };
+            for (int i = 0; i < 10; ++i) {
+                ASSERTV(i, 0 == mX.submit(code, checker));
+            }
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "embedder threads" << endl
+                          << "================" << endl;
+
+        enum { k_NUM_WORKERS = 3, k_NUM_JOBS = 5000 };
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtm::Executor mX(k_NUM_WORKERS, &ta);
+            const sjtt::Bytecode code[] = {
+                sjtt::Bytecode::createPush(bdld::Datum::createDouble(1)),
+                sjtt::Bytecode::createPush(bdld::Datum::createDouble(2)),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_AddDoubles),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+
+            bslmt::ThreadUtil::Handle handles[k_NUM_WORKERS];
+            for (int i = 0; i < k_NUM_WORKERS; ++i) {
+                const WorkerThread worker = { &mX, i };
+                ASSERT(0 == bslmt::ThreadUtil::create(&handles[i], worker));
+            }
+
+            bsls::AtomicInt count(0);
+            const Checker checker = { 3, &count };
+            for (int i = 0; i < k_NUM_JOBS; ++i) {
+                ASSERTV(i, 0 == mX.submit(code, checker));
+            }
+            mX.wait();
+            ASSERT(k_NUM_JOBS == count);
+            ASSERT(k_NUM_JOBS == totalExecuted(mX));
+
+            mX.stop();
+            for (int i = 0; i < k_NUM_WORKERS; ++i) {
+                ASSERT(0 == bslmt::ThreadUtil::join(handles[i]));
+            }
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtm::Executor mX(2, &ta);  const sjtm::Executor& X = mX;
+            ASSERT(2 == X.numWorkers());
+            ASSERT(0 == X.numJobsExecuted(0));
+            ASSERT(0 == X.numJobsStolen(1));
+
+            // Globals have the same slots in all workers, and are shared.
+
+            mX.setGlobal("x", bdld::Datum::createDouble(10));
+            ASSERT(0 == mX.globalSlot("x"));
+            ASSERT(1 == mX.globalSlot("y"));
+            const sjtm::Executor::SharedDatum Y =
+                                            sjtt::GlobalValue::createShared(
+                                          bdld::Datum::createDouble(1.5), &ta);
+            mX.shareGlobal("y", Y);
+            ASSERT(3 == Y.use_count());
+
+            // 'x + y'
+
+            const sjtt::Bytecode code[] = {
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot,
+                                       bdld::Datum::createInteger(0)),
+                sjtt::Bytecode::create(sjtt::Bytecode::e_GetGlobalSlot,
+                                       bdld::Datum::createInteger(1)),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_AddDoubles),
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Return),
+            };
+
+            ASSERT(0 == mX.start());
+            bsls::AtomicInt count(0);
+            const Checker checker = { 11.5, &count };
+            for (int i = 0; i < 200; ++i) {
+                ASSERTV(i, 0 == mX.submit(code, checker));
+            }
+            mX.wait();
+            ASSERT(200 == count);
+            ASSERT(200 == totalExecuted(X));
+            mX.stop();
+            mX.join();
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -5,5 +5,50 @@ namespace sjtt {
 BSLMF_ASSERT(bsl::is_trivially_copyable<Bytecode>::value);
 BSLMF_ASSERT(bsl::is_trivially_default_constructible<Bytecode>::value);
 BSLMF_ASSERT(BloombergLP::bslmf::IsBitwiseMoveable<Bytecode>::value);
+
+                               // --------------
+                               // class Bytecode
+                               // --------------
+
+// CLASS METHODS
+const char *Bytecode::toAscii(Opcode opcode) {
+#define CASE(NAME) case e_##NAME: return #NAME;
+
+    switch (opcode) {
+      CASE(Push)
+      CASE(AddDoubles)
+      CASE(Execute)
+      CASE(Return)
+      CASE(Pop)
+      CASE(PushAddDoubles)
+      CASE(GetGlobalSlot)
+      CASE(SetGlobalSlot)
+      CASE(AddArrays)
+      CASE(MultiplyArrays)
+      CASE(MultiplyAddArrays)
+      CASE(SumArray)
+      CASE(DotArrays)
+      CASE(NewObject)
+      CASE(GetProperty)
+      CASE(SetProperty)
+      CASE(AddIntegers)
+      CASE(SubtractIntegers)
+      CASE(MultiplyIntegers)
+      CASE(LessIntegers)
+      CASE(Jump)
+      CASE(JumpIfFalse)
+      CASE(LoopHeader)
+      CASE(Loop)
+      CASE(Function)
+      CASE(Call)
+      CASE(TailCall)
+      CASE(GetLocal)
+      CASE(SetLocal)
+    }
+
+#undef CASE
+
+    return "(* UNKNOWN *)";
+}
 }
 
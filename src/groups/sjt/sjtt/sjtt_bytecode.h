@@ -52,8 +52,153 @@ class Bytecode {
         e_Execute,
              // pop and evaluate the item at the top of the stack
 
-        e_Return
-            // stop evaluation and return the value on the top of the stack
+        e_Return,
+            // return the value on the top of the stack from the script
+            // function being run (see 'e_Call'), or, outside of any function,
+            // stop evaluation and return it
+
+        e_Pop,
+            // pop and discard the item at the top of the stack
+
+        e_PushAddDoubles,
+            // Replace the double on the top of the stack with its sum with
+            // the double in this opcode; equivalent to 'e_Push' followed by
+            // 'e_AddDoubles'.
+
+        e_GetGlobalSlot,
+            // Push the value of the global, installed with
+            // 'ExecutionContext::setGlobals', whose slot is the integer in
+            // this opcode.  The value remains valid until that global is next
+            // assigned.
+
+        e_SetGlobalSlot,
+            // Pop the item at the top of the stack and assign it to the
+            // global whose slot is the integer in this opcode: copy it into
+            // the allocator of the global or, if the context has a heap (see
+            // 'ExecutionContext::setHeap'), refer to it and record the write
+            // with the heap.  Assigning an object is a type error.
+
+        e_AddArrays,
+            // Pop the top two arrays of doubles on the stack and push the
+            // array of the sums of their elements.  As for every array
+            // opcode, applying it to values other than arrays of doubles, or
+            // to arrays of different lengths, is a type error.
+
+        e_MultiplyArrays,
+            // Pop the top two arrays of doubles on the stack and push the
+            // array of the products of their elements.
+
+        e_MultiplyAddArrays,
+            // Pop the top three arrays of doubles on the stack and push the
+            // array of the products of the elements of the lower two plus
+            // the elements of the top one.
+
+        e_SumArray,
+            // Replace the array of doubles on the top of the stack with the
+            // sum of its elements.
+
+        e_DotArrays,
+            // Pop the top two arrays of doubles on the stack and push their
+            // dot product.
+
+        e_NewObject,
+            // Push a new object having no properties and the root shape of
+            // the 'ShapeTable' installed with 'ExecutionContext::setShapes'.
+            // The object is a temporary, released with the allocator of the
+            // context.
+
+        e_GetProperty,
+            // Replace the object on the top of the stack with the value of
+            // its property named by the 'PropertyCache' in this opcode, or
+            // with undefined if it has no such property.  An object whose
+            // shape is in the cache is read at the cached slot; otherwise the
+            // property is looked up by name and its slot is recorded in the
+            // cache.  Applying it to a value that is not an object is a type
+            // error.
+
+        e_SetProperty,
+            // Pop the item at the top of the stack and assign it to the
+            // property, named by the 'PropertyCache' in this opcode, of the
+            // object below it, which remains on the stack, using the cache as
+            // for 'e_GetProperty'.
+
+        e_AddIntegers,
+            // Pop the top two numbers on the stack and push their sum: an
+            // integer if both are integers and the sum fits in an 'int', and
+            // a double otherwise.  Record the kind of the operation in the
+            // 'TypeFeedback' in this opcode.  Applying it to values other
+            // than numbers is a type error.
+
+        e_SubtractIntegers,
+            // Pop the top two numbers on the stack and push the difference of
+            // the lower and the top one, as for 'e_AddIntegers'.
+
+        e_MultiplyIntegers,
+            // Pop the top two numbers on the stack and push their product, as
+            // for 'e_AddIntegers'.
+
+        e_LessIntegers,
+            // Pop the top two numbers on the stack and push 'true' if the
+            // lower one is less than the top one, and 'false' otherwise.
+            // Record the kind of the comparison in the 'TypeFeedback' in this
+            // opcode.
+
+        e_Jump,
+            // Continue with the bytecode whose offset from this one is the
+            // positive integer in this opcode.
+
+        e_JumpIfFalse,
+            // Pop the boolean at the top of the stack and, if it is 'false',
+            // continue with the bytecode whose offset from this one is the
+            // positive integer in this opcode.  Applying it to a value that
+            // is not a boolean is a type error.
+
+        e_LoopHeader,
+            // Mark the head of a loop, whose iterations are counted by the
+            // 'LoopCounter' in this opcode; do nothing when executed.
+
+        e_Loop,
+            // Continue with the 'e_LoopHeader' whose offset from this one is
+            // the negative integer in this opcode, and increment the
+            // 'LoopCounter' of that header.  When the counter reaches the loop
+            // threshold of the context, notify the 'TierUpPolicy' installed
+            // with 'ExecutionContext::setTierUpPolicy', if any, which may stop
+            // the program.
+
+        e_Function,
+            // Mark the entry of a script function whose number of arguments
+            // is the non-negative integer in this opcode; do nothing when
+            // executed.  A script function is entered only by 'e_Call' and
+            // 'e_TailCall'.
+
+        e_Call,
+            // Call the script function whose 'e_Function' is at the offset,
+            // the integer in this opcode, from this one, with the top items
+            // on the stack as its arguments, the top one last, and replace
+            // them with the value the function returns.
+
+        e_TailCall,
+            // Return from the script function being run the value returned
+            // by the script function called as for 'e_Call', which replaces
+            // the function being run rather than returning to it, so that a
+            // chain of tail calls runs in constant space.
+
+        e_GetLocal,
+            // Push the value of the slot, in the frame of the script function
+            // being run, whose index is the integer in this opcode: the
+            // arguments of a function taking 'n' of them are the slots '-n'
+            // (the first) to '-1', and the values the function has pushed are
+            // the slots '0' and up.
+
+        e_SetLocal
+            // Pop the item at the top of the stack and assign it to the slot,
+            // in the frame of the script function being run, whose index is
+            // the integer in this opcode.
+    };
+
+    enum {
+        k_NUM_OPCODES = e_SetLocal + 1
+                                       // number of enumerators in 'Opcode'
     };
   private:
     // DATA
@@ -63,12 +208,38 @@ class Bytecode {
     // CLASS METHODS
     static Bytecode createOpcode(Opcode opcode);
         // Return a new 'Bytecode' object having the specified 'opcode'.  The
-        // behavior is unless 'e_ExternalFunction != opcode'.
+        // behavior is undefined unless '!hasData(opcode)'.
 
     static Bytecode createPush(const Datum& data);
         // Return a new 'Bytecode' object having the code of 'e_Push' and the
         // specified 'data'.
 
+    static Bytecode create(Opcode opcode, const Datum& data);
+        // Return a new 'Bytecode' object having the specified 'opcode' and
+        // 'data'.  The behavior is undefined unless 'hasData(opcode)'.
+
+    static bool hasData(Opcode opcode);
+        // Return 'true' if the specified 'opcode' uses the data of its
+        // 'Bytecode', and 'false' otherwise.
+
+    static bool isBranch(Opcode opcode);
+        // Return 'true' if the specified 'opcode' may continue with another
+        // bytecode than the next one, i.e., is 'e_Jump', 'e_JumpIfFalse' or
+        // 'e_Loop', and 'false' otherwise.  Note that the data of a branch is
+        // the offset of its target from the branch, so that a sequence of
+        // bytecodes can be copied without changing its branches.
+
+    static bool isCall(Opcode opcode);
+        // Return 'true' if the specified 'opcode' calls a script function,
+        // i.e., is 'e_Call' or 'e_TailCall', and 'false' otherwise.  Note
+        // that, as for a branch, the data of a call is the offset of the
+        // 'e_Function' of the called function from the call.
+
+    static const char *toAscii(Opcode opcode);
+        // Return the non-modifiable string representation of the name of the
+        // specified 'opcode', without its 'e_' prefix, e.g., "Push" for
+        // 'e_Push', or "(* UNKNOWN *)" if 'opcode' is not an 'Opcode'.
+
     // TRAITS
     BSLMF_NESTED_TRAIT_DECLARATION(Bytecode, bsl::is_trivially_copyable);
     BSLMF_NESTED_TRAIT_DECLARATION(Bytecode,
@@ -112,7 +283,7 @@ class Bytecode {
 // CLASS METHODS
 inline
 Bytecode Bytecode::createOpcode(Opcode opcode) {
-    BSLS_ASSERT(e_Push != opcode);
+    BSLS_ASSERT(!hasData(opcode));
     Bytecode result;
     result.d_opcode = opcode;
     return result;
@@ -126,6 +297,48 @@ Bytecode Bytecode::createPush(const Datum& data) {
     return result;
 }
 
+inline
+Bytecode Bytecode::create(Opcode opcode, const Datum& data) {
+    BSLS_ASSERT(hasData(opcode));
+    Bytecode result;
+    result.d_data = data;
+    result.d_opcode = opcode;
+    return result;
+}
+
+inline
+bool Bytecode::hasData(Opcode opcode) {
+    return e_Push             == opcode
+        || e_PushAddDoubles   == opcode
+        || e_GetGlobalSlot    == opcode
+        || e_SetGlobalSlot    == opcode
+        || e_GetProperty      == opcode
+        || e_SetProperty      == opcode
+        || e_AddIntegers      == opcode
+        || e_SubtractIntegers == opcode
+        || e_MultiplyIntegers == opcode
+        || e_LessIntegers     == opcode
+        || isBranch(opcode)
+        || e_LoopHeader       == opcode
+        || e_Function         == opcode
+        || isCall(opcode)
+        || e_GetLocal         == opcode
+        || e_SetLocal         == opcode;
+}
+
+inline
+bool Bytecode::isBranch(Opcode opcode) {
+    return e_Jump        == opcode
+        || e_JumpIfFalse == opcode
+        || e_Loop        == opcode;
+}
+
+inline
+bool Bytecode::isCall(Opcode opcode) {
+    return e_Call     == opcode
+        || e_TailCall == opcode;
+}
+
 // ACCESSORS
 inline
 const BloombergLP::bdld::Datum& Bytecode::data() const {
@@ -4,6 +4,8 @@
 
 #include <bdls_testutil.h>
 
+#include <bsl_cstring.h>
+
 using namespace BloombergLP;
 using namespace bsl;
 using namespace sjtt;
@@ -65,6 +67,80 @@ int main(int argc, char *argv[])
     cout << "TEST " << __FILE__ << " CASE " << test << endl;
 
     switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "toAscii" << endl
+                          << "=======" << endl;
+
+        ASSERT(0 == strcmp("Push", Bytecode::toAscii(Bytecode::e_Push)));
+        ASSERT(0 == strcmp("DotArrays",
+                           Bytecode::toAscii(Bytecode::e_DotArrays)));
+        ASSERT(0 == strcmp("SetProperty",
+                           Bytecode::toAscii(Bytecode::e_SetProperty)));
+        ASSERT(0 == strcmp("LessIntegers",
+                           Bytecode::toAscii(Bytecode::e_LessIntegers)));
+        ASSERT(0 == strcmp("Loop", Bytecode::toAscii(Bytecode::e_Loop)));
+        ASSERT(0 == strcmp("TailCall",
+                           Bytecode::toAscii(Bytecode::e_TailCall)));
+        ASSERT(0 == strcmp("SetLocal",
+                           Bytecode::toAscii(Bytecode::e_SetLocal)));
+        for (int i = 0; i < Bytecode::k_NUM_OPCODES; ++i) {
+            ASSERTV(i, 0 != strcmp("(* UNKNOWN *)",
+                       Bytecode::toAscii(static_cast<Bytecode::Opcode>(i))));
+        }
+        ASSERT(0 == strcmp("(* UNKNOWN *)",
+                           Bytecode::toAscii(static_cast<Bytecode::Opcode>(
+                                                   Bytecode::k_NUM_OPCODES))));
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "create" << endl
+                          << "======" << endl;
+
+        const bdld::Datum d = bdld::Datum::createDouble(3);
+        const Bytecode code = Bytecode::create(Bytecode::e_PushAddDoubles, d);
+        ASSERT(Bytecode::e_PushAddDoubles == code.opcode());
+        ASSERT(d == code.data());
+
+        ASSERT( Bytecode::hasData(Bytecode::e_Push));
+        ASSERT( Bytecode::hasData(Bytecode::e_PushAddDoubles));
+        ASSERT( Bytecode::hasData(Bytecode::e_GetGlobalSlot));
+        ASSERT( Bytecode::hasData(Bytecode::e_SetGlobalSlot));
+        ASSERT( Bytecode::hasData(Bytecode::e_GetProperty));
+        ASSERT( Bytecode::hasData(Bytecode::e_SetProperty));
+        ASSERT( Bytecode::hasData(Bytecode::e_AddIntegers));
+        ASSERT( Bytecode::hasData(Bytecode::e_SubtractIntegers));
+        ASSERT( Bytecode::hasData(Bytecode::e_MultiplyIntegers));
+        ASSERT( Bytecode::hasData(Bytecode::e_LessIntegers));
+        ASSERT( Bytecode::hasData(Bytecode::e_Jump));
+        ASSERT( Bytecode::hasData(Bytecode::e_JumpIfFalse));
+        ASSERT( Bytecode::hasData(Bytecode::e_LoopHeader));
+        ASSERT( Bytecode::hasData(Bytecode::e_Loop));
+        ASSERT( Bytecode::hasData(Bytecode::e_Function));
+        ASSERT( Bytecode::hasData(Bytecode::e_Call));
+        ASSERT( Bytecode::hasData(Bytecode::e_TailCall));
+        ASSERT( Bytecode::hasData(Bytecode::e_GetLocal));
+        ASSERT( Bytecode::hasData(Bytecode::e_SetLocal));
+        ASSERT(!Bytecode::hasData(Bytecode::e_AddDoubles));
+        ASSERT(!Bytecode::hasData(Bytecode::e_Execute));
+        ASSERT(!Bytecode::hasData(Bytecode::e_Return));
+        ASSERT(!Bytecode::hasData(Bytecode::e_Pop));
+        ASSERT(!Bytecode::hasData(Bytecode::e_NewObject));
+
+        ASSERT( Bytecode::isBranch(Bytecode::e_Jump));
+        ASSERT( Bytecode::isBranch(Bytecode::e_JumpIfFalse));
+        ASSERT( Bytecode::isBranch(Bytecode::e_Loop));
+        ASSERT(!Bytecode::isBranch(Bytecode::e_LoopHeader));
+        ASSERT(!Bytecode::isBranch(Bytecode::e_Return));
+        ASSERT(!Bytecode::isBranch(Bytecode::e_LessIntegers));
+        ASSERT(!Bytecode::isBranch(Bytecode::e_Call));
+
+        ASSERT( Bytecode::isCall(Bytecode::e_Call));
+        ASSERT( Bytecode::isCall(Bytecode::e_TailCall));
+        ASSERT(!Bytecode::isCall(Bytecode::e_Function));
+        ASSERT(!Bytecode::isCall(Bytecode::e_Execute));
+        ASSERT(!Bytecode::isCall(Bytecode::e_Jump));
+      } break;
       case 2: {
         if (verbose) cout << endl
                           << "createPush" << endl
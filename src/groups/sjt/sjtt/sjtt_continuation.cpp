@@ -0,0 +1,4 @@
+// sjtt_continuation.cpp
+#include <sjtt_continuation.h>
+
+// This component is implemented entirely in its header.
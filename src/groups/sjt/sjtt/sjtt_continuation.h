@@ -0,0 +1,286 @@
+// sjtt_continuation.h
+
+#ifndef INCLUDED_SJTT_CONTINUATION
+#define INCLUDED_SJTT_CONTINUATION
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+class Bytecode;
+class Program;
+class ProgramImage;
+
+                             // ==================
+                             // class Continuation
+                             // ==================
+
+class Continuation {
+    // This class provides a mechanism holding the state of a program whose
+    // interpretation was suspended by an external function (see
+    // 'sjtu::InterpretUtil::start'): the position of the instruction
+    // following the suspended call, the values the program had on its stack
+    // below the result of that call, the position among them of the frame of
+    // the script function being run, if any, and the maximum depth of the
+    // stack if the program was verified.  A continuation does not refer to the
+    // context the program was interpreted with, so it can be resumed with
+    // any context, on any thread.  Note that, like 'ExecutionContext', a
+    // continuation does not own memory referred to by the values it holds.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum      Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    enum Kind {
+        // Enumeration used to describe the form of the suspended program.
+
+        e_Empty,         // no program is suspended
+        e_Bytecode,      // an array of 'Bytecode' objects
+        e_Program,       // a 'Program'
+        e_ProgramImage   // a 'ProgramImage'
+    };
+
+  private:
+    // DATA
+    bsl::vector<Datum>  d_stack;      // values below the result of the call
+    Kind                d_kind;       // form of the suspended program
+    const Bytecode     *d_code_p;     // program, if 'e_Bytecode'
+    const Program      *d_program_p;  // program, if 'e_Program'
+    const ProgramImage *d_image_p;    // image, if 'e_ProgramImage'
+    bsl::size_t         d_pc;         // index of the next instruction
+    int                 d_frame;      // index of the frame, or -1
+    bsl::size_t         d_maxDepth;   // depth reserved, or 0 if the stack
+                                      // grows as needed
+
+    // NOT IMPLEMENTED
+    Continuation(const Continuation&);
+    Continuation& operator=(const Continuation&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(Continuation,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CREATORS
+    explicit Continuation(Allocator *basicAllocator = 0);
+        // Create an empty continuation.  Optionally specify a
+        // 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.
+
+    //! ~Continuation() = default;
+        // Destroy this object.
+
+    // MANIPULATORS
+    void setPosition(const Bytecode *code, bsl::size_t pc);
+    void setPosition(const Program *program, bsl::size_t pc);
+    void setPosition(const ProgramImage *image, bsl::size_t pc);
+        // Make this continuation resume the array of 'Bytecode' objects
+        // beginning at the specified 'code', the specified 'program', or the
+        // program held by the specified 'image', at the instruction having
+        // the specified 'pc' index.
+
+    void setFrame(int frame);
+        // Make this continuation resume in the script function whose frame
+        // begins at the specified 'frame' index of the saved values, or
+        // outside of any function if 'frame' is -1.
+
+    void setMaxDepth(bsl::size_t maxDepth);
+        // Set the depth of the stack to reserve on resumption to the
+        // specified 'maxDepth', or make the stack grow as needed if
+        // 'maxDepth' is 0.
+
+    bsl::vector<Datum> *stack();
+        // Return the values saved from the stack of the suspended program,
+        // from the bottom up.
+
+    void reset();
+        // Make this continuation empty, discarding the saved values without
+        // destroying them.
+
+    // ACCESSORS
+    Kind kind() const;
+        // Return the form of the suspended program, or 'e_Empty' if none is.
+
+    bool isSuspended() const;
+        // Return 'true' if this continuation holds a suspended program, and
+        // 'false' otherwise.
+
+    const Bytecode *code() const;
+        // Return the first instruction of the array of 'Bytecode' objects to
+        // resume.  The behavior is undefined unless 'e_Bytecode == kind()'.
+
+    const Program *program() const;
+        // Return the program to resume.  The behavior is undefined unless
+        // 'e_Program == kind()'.
+
+    const ProgramImage *image() const;
+        // Return the image holding the program to resume.  The behavior is
+        // undefined unless 'e_ProgramImage == kind()'.
+
+    bsl::size_t pc() const;
+        // Return the index of the instruction at which to resume.  The
+        // behavior is undefined unless 'isSuspended()'.
+
+    int frame() const;
+        // Return the index, among the saved values, at which the frame of the
+        // script function to resume begins, or -1 if the program was
+        // suspended outside of any function.
+
+    bsl::size_t maxDepth() const;
+        // Return the depth of the stack to reserve on resumption, or 0 if the
+        // stack grows as needed.
+
+    const bsl::vector<Datum>& stack() const;
+        // Return the values saved from the stack of the suspended program,
+        // from the bottom up.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // ------------------
+                             // class Continuation
+                             // ------------------
+
+// CREATORS
+inline
+Continuation::Continuation(Allocator *basicAllocator)
+: d_stack(basicAllocator)
+, d_kind(e_Empty)
+, d_code_p(0)
+, d_program_p(0)
+, d_image_p(0)
+, d_pc(0)
+, d_frame(-1)
+, d_maxDepth(0) {
+}
+
+// MANIPULATORS
+inline
+void Continuation::setPosition(const Bytecode *code, bsl::size_t pc) {
+    BSLS_ASSERT_SAFE(0 != code);
+    d_kind   = e_Bytecode;
+    d_code_p = code;
+    d_pc     = pc;
+}
+
+inline
+void Continuation::setPosition(const Program *program, bsl::size_t pc) {
+    BSLS_ASSERT_SAFE(0 != program);
+    d_kind      = e_Program;
+    d_program_p = program;
+    d_pc        = pc;
+}
+
+inline
+void Continuation::setPosition(const ProgramImage *image, bsl::size_t pc) {
+    BSLS_ASSERT_SAFE(0 != image);
+    d_kind    = e_ProgramImage;
+    d_image_p = image;
+    d_pc      = pc;
+}
+
+inline
+void Continuation::setFrame(int frame) {
+    BSLS_ASSERT_SAFE(-1 <= frame);
+    d_frame = frame;
+}
+
+inline
+void Continuation::setMaxDepth(bsl::size_t maxDepth) {
+    d_maxDepth = maxDepth;
+}
+
+inline
+bsl::vector<BloombergLP::bdld::Datum> *Continuation::stack() {
+    return &d_stack;
+}
+
+inline
+void Continuation::reset() {
+    d_stack.clear();
+    d_kind      = e_Empty;
+    d_code_p    = 0;
+    d_program_p = 0;
+    d_image_p   = 0;
+    d_pc        = 0;
+    d_frame     = -1;
+    d_maxDepth  = 0;
+}
+
+// ACCESSORS
+inline
+Continuation::Kind Continuation::kind() const {
+    return d_kind;
+}
+
+inline
+bool Continuation::isSuspended() const {
+    return e_Empty != d_kind;
+}
+
+inline
+const Bytecode *Continuation::code() const {
+    BSLS_ASSERT_SAFE(e_Bytecode == d_kind);
+    return d_code_p;
+}
+
+inline
+const Program *Continuation::program() const {
+    BSLS_ASSERT_SAFE(e_Program == d_kind);
+    return d_program_p;
+}
+
+inline
+const ProgramImage *Continuation::image() const {
+    BSLS_ASSERT_SAFE(e_ProgramImage == d_kind);
+    return d_image_p;
+}
+
+inline
+bsl::size_t Continuation::pc() const {
+    BSLS_ASSERT_SAFE(e_Empty != d_kind);
+    return d_pc;
+}
+
+inline
+int Continuation::frame() const {
+    return d_frame;
+}
+
+inline
+bsl::size_t Continuation::maxDepth() const {
+    return d_maxDepth;
+}
+
+inline
+const bsl::vector<BloombergLP::bdld::Datum>& Continuation::stack() const {
+    return d_stack;
+}
+}
+
+#endif
@@ -0,0 +1,148 @@
+// sjtt_continuation.t.cpp                                        -*-C++-*-
+
+#include <sjtt_continuation.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_program.h>
+
+#include <bdls_testutil.h>
+#include <bslma_testallocator.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "saved stack" << endl
+                          << "===========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            Continuation mX(&ta);
+            const Continuation& X = mX;
+
+            const Bytecode code[] = {
+                Bytecode::createOpcode(Bytecode::e_Return),
+            };
+            mX.setPosition(code, 0);
+            mX.stack()->push_back(bdld::Datum::createInteger(1));
+            mX.stack()->push_back(bdld::Datum::createDouble(2));
+            ASSERT(2 == X.stack().size());
+            ASSERT(bdld::Datum::createInteger(1) == X.stack()[0]);
+            ASSERT(0 < ta.numBlocksInUse());
+
+            mX.reset();
+            ASSERT(!X.isSuspended());
+            ASSERT(X.stack().empty());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        Continuation mX(&ta);
+        const Continuation& X = mX;
+        ASSERT(Continuation::e_Empty == X.kind());
+        ASSERT(!X.isSuspended());
+        ASSERT(0 == X.maxDepth());
+        ASSERT(-1 == X.frame());
+        ASSERT(X.stack().empty());
+
+        const Bytecode code[] = {
+            Bytecode::createOpcode(Bytecode::e_Pop),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        mX.setPosition(code, 1);
+        mX.setMaxDepth(3);
+        mX.setFrame(2);
+        ASSERT(Continuation::e_Bytecode == X.kind());
+        ASSERT(X.isSuspended());
+        ASSERT(code == X.code());
+        ASSERT(1 == X.pc());
+        ASSERT(3 == X.maxDepth());
+        ASSERT(2 == X.frame());
+
+        Program program(&ta);
+        mX.setPosition(&program, 4);
+        ASSERT(Continuation::e_Program == X.kind());
+        ASSERT(&program == X.program());
+        ASSERT(4 == X.pc());
+        ASSERT(3 == X.maxDepth());
+
+        mX.reset();
+        ASSERT(Continuation::e_Empty == X.kind());
+        ASSERT(0 == X.maxDepth());
+        ASSERT(-1 == X.frame());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,31 @@
+// sjtt_executionarena.cpp
+#include <sjtt_executionarena.h>
+
+#include <bslma_default.h>
+#include <bsls_assert.h>
+
+namespace sjtt {
+
+                            // --------------------
+                            // class ExecutionArena
+                            // --------------------
+
+// CREATORS
+ExecutionArena::ExecutionArena(Allocator *basicAllocator)
+: d_allocator(d_defaultBuffer,
+              k_DEFAULT_BUFFER_SIZE,
+              BloombergLP::bslma::Default::allocator(basicAllocator))
+, d_stack(basicAllocator) {
+}
+
+ExecutionArena::ExecutionArena(char      *buffer,
+                               int        size,
+                               Allocator *basicAllocator)
+: d_allocator(buffer,
+              size,
+              BloombergLP::bslma::Default::allocator(basicAllocator))
+, d_stack(basicAllocator) {
+    BSLS_ASSERT(0 != buffer);
+    BSLS_ASSERT(0 < size);
+}
+}
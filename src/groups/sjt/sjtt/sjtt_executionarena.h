@@ -0,0 +1,136 @@
+// sjtt_executionarena.h
+
+#ifndef INCLUDED_SJTT_EXECUTIONARENA
+#define INCLUDED_SJTT_EXECUTIONARENA
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BDLMA_BUFFEREDSEQUENTIALALLOCATOR
+#include <bdlma_bufferedsequentialallocator.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                            // ====================
+                            // class ExecutionArena
+                            // ====================
+
+class ExecutionArena {
+    // This class provides the memory used by one invocation of bytecode: a
+    // value stack and a sequential allocator for temporaries, e.g., the
+    // 'Datum' objects created by external functions.  Temporaries are never
+    // freed individually; all of them are released at once by 'reset'.
+    // Memory obtained by the allocator from its underlying allocator is kept
+    // across resets and reused, as is the capacity of the stack, so once an
+    // arena has grown to fit an invocation, repeating that invocation
+    // allocates nothing from the underlying allocator.  An arena can be
+    // given an initial buffer, e.g., one on the program stack, from which
+    // temporaries are allocated before any other memory is used.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    enum {
+        k_DEFAULT_BUFFER_SIZE = 256  // size of the buffer used if none is
+                                     // supplied
+    };
+
+  private:
+    // DATA
+    char                                             d_defaultBuffer[
+                                                       k_DEFAULT_BUFFER_SIZE];
+    BloombergLP::bdlma::BufferedSequentialAllocator  d_allocator;
+    bsl::vector<Datum>                               d_stack;
+
+    // NOT IMPLEMENTED
+    ExecutionArena(const ExecutionArena&);
+    ExecutionArena& operator=(const ExecutionArena&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(ExecutionArena,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CREATORS
+    explicit ExecutionArena(Allocator *basicAllocator = 0);
+        // Create an arena that allocates temporaries from a small internal
+        // buffer and then from memory supplied by the optionally specified
+        // 'basicAllocator'.  If 'basicAllocator' is 0, the currently
+        // installed default allocator is used.
+
+    ExecutionArena(char      *buffer,
+                   int        size,
+                   Allocator *basicAllocator = 0);
+        // Create an arena that allocates temporaries from the specified
+        // 'buffer' of the specified 'size' bytes and then from memory
+        // supplied by the optionally specified 'basicAllocator'.  If
+        // 'basicAllocator' is 0, the currently installed default allocator is
+        // used.  The behavior is undefined unless '0 != buffer', '0 < size',
+        // and 'buffer' outlives this object.
+
+    // MANIPULATORS
+    Allocator *allocator();
+        // Return the allocator supplying temporaries.  Memory obtained from
+        // it is valid until the next call to 'reset' or 'rewind'.
+
+    void reset();
+        // Release, at once, all temporaries allocated from this arena and
+        // empty its stack, keeping memory for reuse.  Note that no 'Datum'
+        // is destroyed.
+
+    void rewind();
+        // Release, at once, all temporaries allocated from this arena,
+        // keeping memory for reuse, but leave the stack unchanged.
+
+    bsl::vector<Datum> *stack();
+        // Return the value stack of this arena.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                            // --------------------
+                            // class ExecutionArena
+                            // --------------------
+
+// MANIPULATORS
+inline
+ExecutionArena::Allocator *ExecutionArena::allocator() {
+    return &d_allocator;
+}
+
+inline
+void ExecutionArena::reset() {
+    d_stack.clear();
+    rewind();
+}
+
+inline
+void ExecutionArena::rewind() {
+    d_allocator.rewind();
+}
+
+inline
+bsl::vector<BloombergLP::bdld::Datum> *ExecutionArena::stack() {
+    return &d_stack;
+}
+}
+
+#endif
@@ -0,0 +1,139 @@
+// sjtt_executionarena.t.cpp                               -*-C++-*-
+
+#include <sjtt_executionarena.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "initial buffer" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            char buffer[1024];
+            ExecutionArena arena(buffer, sizeof buffer, &ta);
+            arena.stack()->reserve(8);
+            const long long numAllocations = ta.numAllocations();
+
+            for (int i = 0; i < 100; ++i) {
+                arena.reset();
+                for (int j = 0; j < 8; ++j) {
+                    const bdld::Datum text = bdld::Datum::copyString(
+                                  "a string long enough to need an allocation",
+                                  arena.allocator());
+                    arena.stack()->push_back(text);
+                    ASSERTV(i, j, buffer <= text.theString().data());
+                    ASSERTV(i, j, text.theString().data() <
+                                                     buffer + sizeof buffer);
+                }
+            }
+            ASSERT(numAllocations == ta.numAllocations());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            ExecutionArena arena(&ta);
+            ASSERT(0 != arena.allocator());
+            ASSERT(arena.stack()->empty());
+
+            for (int i = 0; i < 100; ++i) {
+                arena.stack()->push_back(bdld::Datum::copyString(
+                                  "a string long enough to need an allocation",
+                                  arena.allocator()));
+            }
+            ASSERT(100 == arena.stack()->size());
+            ASSERT(0 < ta.numBytesInUse());
+
+            // Temporaries are released at once, without being destroyed.
+
+            arena.reset();
+            ASSERT(arena.stack()->empty());
+            ASSERT(100 <= arena.stack()->capacity());
+
+            void *memory = arena.allocator()->allocate(16);
+            ASSERT(0 != memory);
+            arena.allocator()->deallocate(memory);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -3,10 +3,22 @@
 #ifndef INCLUDED_SJTT_EXECUTIONCONTEXT
 #define INCLUDED_SJTT_EXECUTIONCONTEXT
 
+#ifndef INCLUDED_SJTT_EXECUTIONARENA
+#include <sjtt_executionarena.h>
+#endif
+
+#ifndef INCLUDED_SJTT_GLOBALVALUE
+#include <sjtt_globalvalue.h>
+#endif
+
 #ifndef INCLUDED_BDLD_DATUM
 #include <bdld_datum.h>
 #endif
 
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
 #ifndef INCLUDED_BSL_VECTOR
 #include <bsl_vector.h>
 #endif
@@ -17,6 +29,10 @@ namespace bslma { class Allocator; }
 
 namespace sjtt {
 
+class Heap;
+class ShapeTable;
+class TierUpPolicy;
+
                           // ======================
                            // class ExecutionContext
                            // ======================
@@ -24,17 +40,28 @@ class ExecutionContext {
     // This class is an in-core, value-semantic type representing the context
     // of bytecode interpretation.  Note that 'ExecutionContext' objects do not
     // clean up the 'Datum' object (i.e., with 'Datum::destroy') in their
-    // stacks.
+    // stacks.  A context created from an 'ExecutionArena' uses the stack and
+    // the allocator of the arena, so that all temporaries created through
+    // the context are released at once by 'ExecutionArena::reset'.
 
   public:
     // TYPES
     typedef BloombergLP::bdld::Datum Datum;
     typedef BloombergLP::bslma::Allocator Allocator;
+    typedef bsl::vector<GlobalValue> Globals;
+    typedef BloombergLP::bsls::Types::Int64 Int64;
 
   private:
     // DATA
     Allocator          *d_allocator_p;
     bsl::vector<Datum> *d_stack_p;
+    Globals            *d_globals_p;    // values of globals, indexed by slot
+    Heap               *d_heap_p;       // collector of assigned values
+    ShapeTable         *d_shapes_p;     // shapes of created objects
+    TierUpPolicy       *d_tierUpPolicy_p;  // told of hot loops, or 0
+    Int64               d_loopThreshold;   // back edges making a loop hot
+    int                 d_status;       // failure reported by an external
+                                        // function, or 0
 
   public:
     // CREATORS
@@ -42,18 +69,76 @@ class ExecutionContext {
         // Create a new 'ExecutionContext' object that allocates memory from
         // the specified 'allocator'.
 
+    explicit ExecutionContext(ExecutionArena *arena);
+        // Create a new 'ExecutionContext' object that uses the stack of the
+        // specified 'arena' and allocates memory from the arena.
+
     ExecutionContext(Allocator *allocator, bsl::vector<Datum> *stack);
 
     ExecutionContext& operator=(const ExecutionContext& rhs) = default;
         // Assign to this object the value of the specified 'rhs' object and
         // return a reference to this object.
 
+    // MANIPULATORS
+    void setGlobals(Globals *globals);
+        // Use the specified 'globals' as the values of the globals accessed
+        // by 'e_GetGlobalSlot' and 'e_SetGlobalSlot', indexed by slot.
+
+    void setHeap(Heap *heap);
+        // Use the specified 'heap' to manage the values assigned to globals
+        // by 'e_SetGlobalSlot', which then refer to the assigned values
+        // instead of copying them.  The behavior is undefined unless the
+        // globals of this context are roots of 'heap' and the allocator of
+        // this context is the nursery of 'heap'.
+
+    void setShapes(ShapeTable *shapes);
+        // Use the specified 'shapes' for the objects created and extended by
+        // 'e_NewObject' and 'e_SetProperty'.  The shapes should outlive the
+        // programs run with this context, so that the caches of their
+        // property accesses are reused across runs.
+
+    void setTierUpPolicy(TierUpPolicy *policy, Int64 loopThreshold);
+        // Notify the specified 'policy' of each loop whose 'LoopCounter'
+        // reaches the specified 'loopThreshold' in the programs run with this
+        // context, or notify no policy if 'policy' is 0.  The behavior is
+        // undefined unless '0 < loopThreshold'.
+
+    void setStatus(int status);
+        // Set the status of this context to the specified 'status'.  An
+        // external function sets a non-zero status, e.g., one of the
+        // 'sjtu::InterpretUtil::Status' values, to report that it has failed,
+        // in which case the interpreter stops and returns 'status' once the
+        // function returns, and resets the status of this context to 0.
+
     // ACCESSORS
     Allocator *allocator() const;
         // Return the allocator associated with this object.
 
     bsl::vector<Datum>* stack() const;
         // Return the value stack for this context.
+
+    Globals *globals() const;
+        // Return the values of globals for this context, or 0 if none have
+        // been set.
+
+    Heap *heap() const;
+        // Return the heap managing the values assigned to globals, or 0 if
+        // none has been set.
+
+    ShapeTable *shapes() const;
+        // Return the shapes of the objects created by programs, or 0 if none
+        // have been set.
+
+    TierUpPolicy *tierUpPolicy() const;
+        // Return the policy notified of hot loops, or 0 if none has been set.
+
+    Int64 loopThreshold() const;
+        // Return the number of back edges making a loop hot, or 0 if no
+        // policy has been set.
+
+    int status() const;
+        // Return the status set by the last call to 'setStatus', or 0 if
+        // there is none pending.
 };
 
 // ============================================================================
@@ -65,15 +150,63 @@ class ExecutionContext {
                            // ----------------------
 
 // CREATORS
+inline
+ExecutionContext::ExecutionContext(ExecutionArena *arena)
+: d_allocator_p(arena->allocator())
+, d_stack_p(arena->stack())
+, d_globals_p(0)
+, d_heap_p(0)
+, d_shapes_p(0)
+, d_tierUpPolicy_p(0)
+, d_loopThreshold(0)
+, d_status(0) {
+}
+
 inline
 ExecutionContext::ExecutionContext(Allocator          *allocator,
                                    bsl::vector<Datum> *stack)
 : d_allocator_p(allocator)
-, d_stack_p(stack) {
+, d_stack_p(stack)
+, d_globals_p(0)
+, d_heap_p(0)
+, d_shapes_p(0)
+, d_tierUpPolicy_p(0)
+, d_loopThreshold(0)
+, d_status(0) {
     BSLS_ASSERT(0 != allocator);
     BSLS_ASSERT(0 != stack);
 }
 
+// MANIPULATORS
+inline
+void ExecutionContext::setGlobals(Globals *globals) {
+    d_globals_p = globals;
+}
+
+inline
+void ExecutionContext::setHeap(Heap *heap) {
+    d_heap_p = heap;
+}
+
+inline
+void ExecutionContext::setShapes(ShapeTable *shapes) {
+    d_shapes_p = shapes;
+}
+
+inline
+void ExecutionContext::setTierUpPolicy(TierUpPolicy *policy,
+                                       Int64         loopThreshold) {
+    BSLS_ASSERT(0 < loopThreshold);
+
+    d_tierUpPolicy_p = policy;
+    d_loopThreshold  = policy ? loopThreshold : 0;
+}
+
+inline
+void ExecutionContext::setStatus(int status) {
+    d_status = status;
+}
+
 // ACCESSORS
 inline
 BloombergLP::bslma::Allocator *ExecutionContext::allocator() const {
@@ -84,5 +217,35 @@ inline
 bsl::vector<BloombergLP::bdld::Datum>* ExecutionContext::stack() const {
     return d_stack_p;
 }
+
+inline
+ExecutionContext::Globals *ExecutionContext::globals() const {
+    return d_globals_p;
+}
+
+inline
+Heap *ExecutionContext::heap() const {
+    return d_heap_p;
+}
+
+inline
+ShapeTable *ExecutionContext::shapes() const {
+    return d_shapes_p;
+}
+
+inline
+TierUpPolicy *ExecutionContext::tierUpPolicy() const {
+    return d_tierUpPolicy_p;
+}
+
+inline
+ExecutionContext::Int64 ExecutionContext::loopThreshold() const {
+    return d_loopThreshold;
+}
+
+inline
+int ExecutionContext::status() const {
+    return d_status;
+}
 }
 #endif
@@ -2,8 +2,12 @@
 
 #include <sjtt_executioncontext.h>
 
+#include <sjtt_shape.h>
+#include <sjtt_tieruppolicy.h>
+
 #include <bdls_testutil.h>
 #include <bdlma_localsequentialallocator.h>
+#include <bslma_testallocator.h>
 
 using namespace BloombergLP;
 using namespace bsl;
@@ -52,6 +56,27 @@ void aSsErT(bool condition, const char *message, int line)
 #define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
 #define L_           BDLS_TESTUTIL_L_  // current Line number
 
+// ============================================================================
+//                       GLOBAL TEST CLASSES AND FUNCTIONS
+// ----------------------------------------------------------------------------
+
+namespace {
+
+class NoopPolicy : public sjtt::TierUpPolicy {
+    // This class ignores the events it is notified of.
+
+  public:
+    // MANIPULATORS
+    void onHotLoop(sjtt::ExecutionContext *, sjtt::LoopCounter *)
+    {
+    }
+
+    void onHotProgram(const sjtt::Bytecode *)
+    {
+    }
+};
+
+}  // close unnamed namespace
 
 // ============================================================================
 //                               MAIN PROGRAM
@@ -66,6 +91,18 @@ int main(int argc, char *argv[])
     cout << "TEST " << __FILE__ << " CASE " << test << endl;
 
     switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "arena" << endl
+                          << "=====" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        sjtt::ExecutionArena arena(&ta);
+        sjtt::ExecutionContext context(&arena);
+        ASSERT(arena.allocator() == context.allocator());
+        ASSERT(arena.stack() == context.stack());
+        ASSERT(0 == context.globals());
+      } break;
       case 1: {
         if (verbose) cout << endl
                           << "breathing" << endl
@@ -76,6 +113,30 @@ int main(int argc, char *argv[])
         sjtt::ExecutionContext context(&alloc, &v);
         ASSERT(&alloc == context.allocator());
         ASSERT(&v == context.stack());
+        ASSERT(0 == context.globals());
+
+        sjtt::ExecutionContext::Globals globals(&alloc);
+        context.setGlobals(&globals);
+        ASSERT(&globals == context.globals());
+
+        ASSERT(0 == context.shapes());
+        sjtt::ShapeTable shapes(&alloc);
+        context.setShapes(&shapes);
+        ASSERT(&shapes == context.shapes());
+
+        ASSERT(0 == context.tierUpPolicy());
+        ASSERT(0 == context.loopThreshold());
+        NoopPolicy policy;
+        context.setTierUpPolicy(&policy, 50);
+        ASSERT(&policy == context.tierUpPolicy());
+        ASSERT(50      == context.loopThreshold());
+        context.setTierUpPolicy(0, 50);
+        ASSERT(0 == context.tierUpPolicy());
+        ASSERT(0 == context.loopThreshold());
+
+        ASSERT(0 == context.status());
+        context.setStatus(3);
+        ASSERT(3 == context.status());
       } break;
       default: {
         cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
@@ -0,0 +1,56 @@
+// sjtt_globalvalue.cpp
+#include <sjtt_globalvalue.h>
+
+#include <bslma_allocator.h>
+#include <bslma_default.h>
+
+namespace sjtt {
+using BloombergLP::bdld::ManagedDatum;
+
+                             // -----------------
+                             // class GlobalValue
+                             // -----------------
+
+// CLASS METHODS
+GlobalValue::SharedDatum GlobalValue::createShared(
+                                              const Datum&  value,
+                                              Allocator    *basicAllocator) {
+    Allocator *allocator = BloombergLP::bslma::Default::allocator(
+                                                              basicAllocator);
+    bsl::shared_ptr<ManagedDatum> result(new (*allocator)
+                                                    ManagedDatum(allocator),
+                                         allocator);
+    result->clone(value);
+    return result;
+}
+
+// CREATORS
+GlobalValue::GlobalValue(Allocator *basicAllocator)
+: d_value(Datum::createNull())
+, d_owner_p(0)
+, d_shared()
+, d_allocator_p(BloombergLP::bslma::Default::allocator(basicAllocator)) {
+}
+
+GlobalValue::GlobalValue(const GlobalValue&  original,
+                         Allocator          *basicAllocator)
+: d_value(Datum::createNull())
+, d_owner_p(0)
+, d_shared()
+, d_allocator_p(BloombergLP::bslma::Default::allocator(basicAllocator)) {
+    *this = original;
+}
+
+// MANIPULATORS
+GlobalValue& GlobalValue::operator=(const GlobalValue& rhs) {
+    if (this != &rhs) {
+        if (rhs.isShared()) {
+            share(rhs.d_shared);
+        }
+        else {
+            clone(rhs.d_value);
+        }
+    }
+    return *this;
+}
+}
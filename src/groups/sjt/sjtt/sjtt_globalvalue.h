@@ -0,0 +1,247 @@
+// sjtt_globalvalue.h
+
+#ifndef INCLUDED_SJTT_GLOBALVALUE
+#define INCLUDED_SJTT_GLOBALVALUE
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BDLD_MANAGEDDATUM
+#include <bdld_manageddatum.h>
+#endif
+
+#ifndef INCLUDED_BSL_MEMORY
+#include <bsl_memory.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLMF_ISBITWISEMOVEABLE
+#include <bslmf_isbitwisemoveable.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                             // =================
+                             // class GlobalValue
+                             // =================
+
+class GlobalValue {
+    // This class holds the value of a global.  The value is either owned, in
+    // which case it is destroyed, with the allocator that supplied its
+    // memory, when it is replaced or when this object is destroyed, or
+    // shared, in which case this object refers to an immutable, reference
+    // counted 'SharedDatum' and keeps it alive while the value is held.  A
+    // value is owned when it is copied in with 'clone' (which allocates from
+    // the allocator of this object) or handed over with 'adopt' (which
+    // allocates nothing), and shared when assigned with 'share' (which
+    // allocates nothing and copies nothing).  A value assigned with 'refer'
+    // is neither owned nor shared: its lifetime is managed elsewhere, e.g.,
+    // by an 'sjtt::Heap'.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef bsl::shared_ptr<const BloombergLP::bdld::ManagedDatum> SharedDatum;
+
+  private:
+    // DATA
+    Datum        d_value;        // current value
+    Allocator   *d_owner_p;      // allocator to destroy 'd_value' with, or 0
+                                 // if 'd_value' is not owned
+    SharedDatum  d_shared;       // holder of 'd_value' if shared
+    Allocator   *d_allocator_p;  // allocator used by 'clone' (held)
+
+    // PRIVATE MANIPULATORS
+    void reset();
+        // Release the current value of this object, destroying it if it is
+        // owned, and leave 'd_value' unspecified.
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(GlobalValue,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+    BSLMF_NESTED_TRAIT_DECLARATION(GlobalValue,
+                                   BloombergLP::bslmf::IsBitwiseMoveable);
+
+    // CLASS METHODS
+    static SharedDatum createShared(const Datum&  value,
+                                    Allocator    *basicAllocator = 0);
+        // Return a shared, immutable copy of the specified 'value'.
+        // Optionally specify a 'basicAllocator' used to supply memory for the
+        // copy and its reference count.  If 'basicAllocator' is 0, the
+        // currently installed default allocator is used.  The returned value
+        // may be shared by any number of 'GlobalValue' objects, including
+        // ones belonging to different engines and threads, and is destroyed
+        // when the last of them releases it.
+
+    // CREATORS
+    explicit GlobalValue(Allocator *basicAllocator = 0);
+        // Create an object holding a null value.  Optionally specify a
+        // 'basicAllocator' used to supply memory for values copied in with
+        // 'clone'.  If 'basicAllocator' is 0, the currently installed default
+        // allocator is used.
+
+    GlobalValue(const GlobalValue& original, Allocator *basicAllocator = 0);
+        // Create an object holding the value of the specified 'original'
+        // object: a copy of it if it is owned, and the same shared value if
+        // it is shared.  Optionally specify a 'basicAllocator' used to supply
+        // memory.  If 'basicAllocator' is 0, the currently installed default
+        // allocator is used.
+
+    ~GlobalValue();
+        // Destroy this object, destroying its value if it is owned.
+
+    // MANIPULATORS
+    GlobalValue& operator=(const GlobalValue& rhs);
+        // Assign to this object the value of the specified 'rhs' object,
+        // with the same ownership as in the copy constructor, and return a
+        // reference to this object.
+
+    void adopt(const Datum& value, Allocator *owner);
+        // Take ownership of the specified 'value', whose memory was supplied
+        // by the specified 'owner' allocator, without copying it.  'value'
+        // will be destroyed with 'owner', which must therefore outlive this
+        // object.  The behavior is undefined unless 'value' was allocated
+        // with 'owner'.
+
+    void clone(const Datum& value);
+        // Hold a copy of the specified 'value', allocated with the allocator
+        // of this object.
+
+    void makeNull();
+        // Hold a null value.
+
+    void refer(const Datum& value);
+        // Hold the specified 'value' without owning it.  The behavior is
+        // undefined unless the memory of 'value' remains valid while it is
+        // held.
+
+    void share(const SharedDatum& value);
+        // Hold the specified shared 'value' without copying it.  The behavior
+        // is undefined unless 'value' is not empty.
+
+    // ACCESSORS
+    Allocator *allocator() const;
+        // Return the allocator used by this object to supply memory.
+
+    const Datum& datum() const;
+        // Return a reference to the value held by this object.
+
+    bool isOwned() const;
+        // Return 'true' if the value of this object is owned, and 'false'
+        // otherwise.
+
+    bool isShared() const;
+        // Return 'true' if the value of this object is shared, and 'false'
+        // otherwise.
+
+    const SharedDatum& shared() const;
+        // Return the shared value held by this object, or an empty pointer if
+        // its value is not shared.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // -----------------
+                             // class GlobalValue
+                             // -----------------
+
+// PRIVATE MANIPULATORS
+inline
+void GlobalValue::reset() {
+    if (0 != d_owner_p) {
+        Datum::destroy(d_value, d_owner_p);
+        d_owner_p = 0;
+    }
+    if (d_shared) {
+        d_shared.reset();
+    }
+}
+
+// CREATORS
+inline
+GlobalValue::~GlobalValue() {
+    reset();
+}
+
+// MANIPULATORS
+inline
+void GlobalValue::adopt(const Datum& value, Allocator *owner) {
+    BSLS_ASSERT(0 != owner);
+    reset();
+    d_value   = value;
+    d_owner_p = owner;
+}
+
+inline
+void GlobalValue::clone(const Datum& value) {
+    const Datum copy = value.clone(d_allocator_p);
+    reset();
+    d_value   = copy;
+    d_owner_p = d_allocator_p;
+}
+
+inline
+void GlobalValue::makeNull() {
+    reset();
+    d_value = Datum::createNull();
+}
+
+inline
+void GlobalValue::refer(const Datum& value) {
+    reset();
+    d_value = value;
+}
+
+inline
+void GlobalValue::share(const SharedDatum& value) {
+    BSLS_ASSERT(value);
+    SharedDatum held(value);
+    reset();
+    d_value = held->datum();
+    d_shared.swap(held);
+}
+
+// ACCESSORS
+inline
+BloombergLP::bslma::Allocator *GlobalValue::allocator() const {
+    return d_allocator_p;
+}
+
+inline
+const BloombergLP::bdld::Datum& GlobalValue::datum() const {
+    return d_value;
+}
+
+inline
+bool GlobalValue::isOwned() const {
+    return 0 != d_owner_p;
+}
+
+inline
+bool GlobalValue::isShared() const {
+    return static_cast<bool>(d_shared);
+}
+
+inline
+const GlobalValue::SharedDatum& GlobalValue::shared() const {
+    return d_shared;
+}
+}
+
+#endif
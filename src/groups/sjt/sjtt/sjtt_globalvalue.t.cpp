@@ -0,0 +1,230 @@
+// sjtt_globalvalue.t.cpp                                  -*-C++-*-
+
+#include <sjtt_globalvalue.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    // Long enough not to be stored inside the 'Datum'.
+
+    const char *const TEXT = "a string long enough to need an allocation";
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "copying" << endl
+                          << "=======" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        bslma::TestAllocator tb(veryVerbose);
+        const bdld::Datum        text   = bdld::Datum::copyString(TEXT, &tb);
+        GlobalValue::SharedDatum shared = GlobalValue::createShared(text,
+                                                                    &tb);
+        bdld::Datum::destroy(text, &tb);
+        {
+            GlobalValue owned(&ta);
+            owned.clone(bdld::Datum::createDouble(1));
+            GlobalValue mX(owned, &ta);
+            ASSERT(!mX.isShared());
+            ASSERT(bdld::Datum::createDouble(1) == mX.datum());
+
+            GlobalValue sharing(&ta);
+            sharing.share(shared);
+            const long long numAllocations = ta.numAllocations();
+            GlobalValue mY(sharing, &ta);
+            ASSERT(mY.isShared());
+            ASSERT(shared == mY.shared());
+            ASSERT(numAllocations == ta.numAllocations());
+
+            mY = owned;
+            ASSERT(!mY.isShared());
+            ASSERT(bdld::Datum::createDouble(1) == mY.datum());
+            mX = sharing;
+            ASSERT(mX.isShared());
+            ASSERT(3 == shared.use_count());
+        }
+        ASSERT(1 == shared.use_count());
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "sharing" << endl
+                          << "=======" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        bslma::TestAllocator tb(veryVerbose);
+        bslma::TestAllocator tc(veryVerbose);
+        {
+            bdld::Datum text = bdld::Datum::copyString(TEXT, &tc);
+            GlobalValue::SharedDatum shared = GlobalValue::createShared(text,
+                                                                        &tc);
+            bdld::Datum::destroy(text, &tc);
+            ASSERT(0 < tc.numBytesInUse());
+            ASSERT(TEXT == shared->datum().theString());
+
+            // Any number of values share the same data, without copying it.
+
+            GlobalValue mX(&ta);
+            GlobalValue mY(&tb);
+            mX.share(shared);
+            mY.share(shared);
+            ASSERT(0 == ta.numAllocations());
+            ASSERT(0 == tb.numAllocations());
+            ASSERT(mX.isShared());
+            ASSERT(shared == mX.shared());
+            ASSERT(mX.datum().theString().data() ==
+                                          mY.datum().theString().data());
+            ASSERT(3 == shared.use_count());
+
+            // The data lives until the last reference is released.
+
+            shared.reset();
+            mX.makeNull();
+            ASSERT(!mX.isShared());
+            ASSERT(mX.datum().isNull());
+            ASSERT(0 < tc.numBytesInUse());
+            ASSERT(TEXT == mY.datum().theString());
+        }
+        ASSERT(0 == tc.numBytesInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "adopting" << endl
+                          << "========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        bslma::TestAllocator owner(veryVerbose);
+        {
+            GlobalValue mX(&ta);
+            const bdld::Datum text = bdld::Datum::copyString(TEXT, &owner);
+            const long long numBytes = owner.numBytesInUse();
+            mX.adopt(text, &owner);
+            ASSERT(0 == ta.numAllocations());
+            ASSERT(numBytes == owner.numBytesInUse());
+            ASSERT(mX.datum().theString().data() ==
+                                                 text.theString().data());
+            ASSERT(!mX.isShared());
+
+            // Replacing an adopted value destroys it with its owner.
+
+            mX.clone(bdld::Datum::createDouble(3));
+            ASSERT(0 == owner.numBytesInUse());
+
+            mX.adopt(bdld::Datum::copyString(TEXT, &owner), &owner);
+            ASSERT(numBytes == owner.numBytesInUse());
+        }
+        ASSERT(0 == owner.numBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        bslma::TestAllocator tb(veryVerbose);
+        {
+            GlobalValue mX(&ta);
+            ASSERT(&ta == mX.allocator());
+            ASSERT(mX.datum().isNull());
+            ASSERT(!mX.isShared());
+            ASSERT(!mX.shared());
+
+            const bdld::Datum text = bdld::Datum::copyString(TEXT, &tb);
+            mX.clone(text);
+            bdld::Datum::destroy(text, &tb);
+            ASSERT(0 == tb.numBytesInUse());
+            ASSERT(0 < ta.numBytesInUse());
+            ASSERT(TEXT == mX.datum().theString());
+
+            mX.clone(bdld::Datum::createDouble(2));
+            ASSERT(bdld::Datum::createDouble(2) == mX.datum());
+            ASSERT(0 == ta.numBytesInUse());
+
+            mX.adopt(bdld::Datum::copyString(TEXT, &ta), &ta);
+            mX.makeNull();
+            ASSERT(mX.datum().isNull());
+            ASSERT(0 == ta.numBytesInUse());
+            mX.adopt(bdld::Datum::copyString(TEXT, &ta), &ta);
+
+            bsl::vector<GlobalValue> values(&ta);
+            values.resize(3);
+            values[1].clone(bdld::Datum::createDouble(1));
+            values.push_back(mX);
+            ASSERT(TEXT == values[3].datum().theString());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,332 @@
+// sjtt_heap.cpp
+#include <sjtt_heap.h>
+
+#include <bslma_default.h>
+#include <bsls_assert.h>
+#include <bsls_timeutil.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_limits.h>
+
+namespace sjtt {
+using BloombergLP::bdld::Datum;
+using BloombergLP::bsls::TimeUtil;
+
+namespace {
+
+enum {
+    k_WORK_GRANULE = 32  // units of work between reads of the timer
+};
+
+}  // close unnamed namespace
+
+                                 // ----------
+                                 // class Heap
+                                 // ----------
+
+// PRIVATE MANIPULATORS
+void Heap::evacuate() {
+    {
+        // The forwarding table is a temporary like any other, so it comes
+        // from the nursery, and goes with it.
+
+        Forwarded forwarded(nursery());
+        if (d_written) {
+            for (bsl::size_t i = 0; i < d_globals.size(); ++i) {
+                bsl::vector<GlobalValue>& globals = *d_globals[i];
+                for (bsl::size_t j = 0; j < globals.size(); ++j) {
+                    GlobalValue& global = globals[j];
+                    if (!global.isOwned() && !global.isShared()) {
+                        global.refer(promote(global.datum(), &forwarded));
+                    }
+                }
+            }
+            d_written = false;
+        }
+        for (bsl::size_t i = 0; i < d_stacks.size(); ++i) {
+            bsl::vector<Datum>& stack = *d_stacks[i];
+            for (bsl::size_t j = 0; j < stack.size(); ++j) {
+                stack[j] = promote(stack[j], &forwarded);
+            }
+        }
+    }
+    d_nursery_p->rewind();
+    ++d_stats.d_numMinorCollections;
+}
+
+void Heap::finishPause(Int64 start) {
+    const Int64 pause = TimeUtil::getTimer() - start;
+    ++d_stats.d_numPauses;
+    d_stats.d_lastPause   = pause;
+    d_stats.d_totalPause += pause;
+    if (d_stats.d_maxPause < pause) {
+        d_stats.d_maxPause = pause;
+    }
+}
+
+bool Heap::mark(const Datum& value) {
+    const void *memory = address(value);
+    if (0 == memory) {
+        return false;                                                 // RETURN
+    }
+    const Index::const_iterator it = d_index.find(memory);
+    if (d_index.end() == it) {
+        return false;                                                 // RETURN
+    }
+    d_entries[it->second].d_epoch = d_epoch;
+    return true;
+}
+
+Datum Heap::promote(const Datum& value, Forwarded *forwarded) {
+    const void *memory = address(value);
+    if (0 == memory || d_index.end() != d_index.find(memory)) {
+        return value;                                                 // RETURN
+    }
+    const Forwarded::const_iterator it = forwarded->find(memory);
+    if (forwarded->end() != it) {
+        return it->second;                                            // RETURN
+    }
+
+    int entry;
+    if (d_freeEntries.empty()) {
+        entry = static_cast<int>(d_entries.size());
+        d_entries.resize(d_entries.size() + 1);
+    }
+    else {
+        entry = d_freeEntries.back();
+        d_freeEntries.pop_back();
+    }
+
+    const Int64 before = d_tenured.numBytesInUse();
+    Entry&      e      = d_entries[entry];
+    e.d_value    = value.clone(&d_tenured);
+    e.d_numBytes = d_tenured.numBytesInUse() - before;
+    e.d_epoch    = d_epoch;  // promoted values survive the current cycle
+    e.d_live     = true;
+    registerEntry(e.d_value, entry);
+    (*forwarded)[memory] = e.d_value;
+
+    d_stats.d_numBytesPromoted += e.d_numBytes;
+    d_stats.d_numBytesTenured  += e.d_numBytes;
+    return e.d_value;
+}
+
+void Heap::registerEntry(const Datum& value, int entry) {
+    const void *memory = address(value);
+    if (0 == memory) {
+        return;                                                       // RETURN
+    }
+    d_index[memory] = entry;
+    if (value.isArray()) {
+        const BloombergLP::bdld::DatumArrayRef array = value.theArray();
+        for (bsl::size_t i = 0; i < array.length(); ++i) {
+            registerEntry(array[i], entry);
+        }
+    }
+    else if (value.isMap()) {
+        const BloombergLP::bdld::DatumMapRef map = value.theMap();
+        for (bsl::size_t i = 0; i < map.size(); ++i) {
+            registerEntry(map[i].value(), entry);
+        }
+    }
+}
+
+void Heap::unregisterEntry(const Datum& value) {
+    const void *memory = address(value);
+    if (0 == memory) {
+        return;                                                       // RETURN
+    }
+    d_index.erase(memory);
+    if (value.isArray()) {
+        const BloombergLP::bdld::DatumArrayRef array = value.theArray();
+        for (bsl::size_t i = 0; i < array.length(); ++i) {
+            unregisterEntry(array[i]);
+        }
+    }
+    else if (value.isMap()) {
+        const BloombergLP::bdld::DatumMapRef map = value.theMap();
+        for (bsl::size_t i = 0; i < map.size(); ++i) {
+            unregisterEntry(map[i].value());
+        }
+    }
+}
+
+bool Heap::work(Int64 deadline) {
+    // Do at least one granule of work, then stop at the first granule
+    // boundary past 'deadline'.
+
+    for (int units = 0;; ++units) {
+        if (k_WORK_GRANULE <= units) {
+            if (deadline <= TimeUtil::getTimer()) {
+                return false;                                         // RETURN
+            }
+            units = 0;
+        }
+
+        if (e_Marking == d_phase) {
+            if (d_rootSet < d_globals.size()) {
+                const bsl::vector<GlobalValue>& globals =
+                                                        *d_globals[d_rootSet];
+                if (d_cursor < globals.size()) {
+                    const GlobalValue& global = globals[d_cursor++];
+                    if (!global.isOwned() && !global.isShared()) {
+                        mark(global.datum());
+                    }
+                }
+                else {
+                    ++d_rootSet;
+                    d_cursor = 0;
+                }
+                continue;
+            }
+
+            // Stacks change constantly, so they are scanned in one step, at
+            // the end of marking.
+
+            for (bsl::size_t i = 0; i < d_stacks.size(); ++i) {
+                const bsl::vector<Datum>& stack = *d_stacks[i];
+                for (bsl::size_t j = 0; j < stack.size(); ++j) {
+                    mark(stack[j]);
+                }
+            }
+            d_phase  = e_Sweeping;
+            d_cursor = 0;
+        }
+        else {
+            BSLS_ASSERT(e_Sweeping == d_phase);
+            if (d_cursor < d_entries.size()) {
+                Entry& e = d_entries[d_cursor];
+                if (e.d_live && d_epoch != e.d_epoch) {
+                    unregisterEntry(e.d_value);
+                    Datum::destroy(e.d_value, &d_tenured);
+                    e.d_value = Datum::createNull();
+                    e.d_live  = false;
+                    d_freeEntries.push_back(static_cast<int>(d_cursor));
+                    d_stats.d_numBytesCollected += e.d_numBytes;
+                    d_stats.d_numBytesTenured   -= e.d_numBytes;
+                }
+                ++d_cursor;
+                continue;
+            }
+            d_phase          = e_Idle;
+            d_majorThreshold = bsl::max<Int64>(k_MIN_MAJOR_THRESHOLD,
+                                               2 * d_tenured.numBytesInUse());
+            ++d_stats.d_numMajorCollections;
+            return true;                                              // RETURN
+        }
+    }
+}
+
+// CLASS METHODS
+const void *Heap::address(const Datum& value) {
+    const void *memory;
+    switch (value.type()) {
+      case Datum::e_STRING: {
+        memory = value.theString().data();
+      } break;
+      case Datum::e_ARRAY: {
+        memory = value.theArray().data();
+      } break;
+      case Datum::e_MAP: {
+        memory = value.theMap().data();
+      } break;
+      default: {
+        return 0;                                                     // RETURN
+      }
+    }
+
+    // Short strings may be stored within the 'Datum' itself.
+
+    const char *bytes = static_cast<const char *>(memory);
+    const char *self  = reinterpret_cast<const char *>(&value);
+    return bytes >= self && bytes < self + sizeof value ? 0 : memory;
+}
+
+// CREATORS
+Heap::Heap(ExecutionArena *nursery, Allocator *basicAllocator)
+: d_nursery_p(nursery)
+, d_tenured(basicAllocator)
+, d_entries(basicAllocator)
+, d_freeEntries(basicAllocator)
+, d_index(basicAllocator)
+, d_globals(basicAllocator)
+, d_stacks(basicAllocator)
+, d_written(false)
+, d_phase(e_Idle)
+, d_epoch(0)
+, d_rootSet(0)
+, d_cursor(0)
+, d_pauseBudget(k_DEFAULT_PAUSE_BUDGET)
+, d_majorThreshold(k_MIN_MAJOR_THRESHOLD) {
+    BSLS_ASSERT(0 != nursery);
+
+    HeapStats stats = {};
+    d_stats = stats;
+}
+
+Heap::~Heap() {
+    for (bsl::size_t i = 0; i < d_entries.size(); ++i) {
+        if (d_entries[i].d_live) {
+            Datum::destroy(d_entries[i].d_value, &d_tenured);
+        }
+    }
+}
+
+// MANIPULATORS
+void Heap::addRoots(bsl::vector<GlobalValue> *globals) {
+    BSLS_ASSERT(0 != globals);
+    d_globals.push_back(globals);
+    d_written = true;
+}
+
+void Heap::addRoots(bsl::vector<Datum> *stack) {
+    BSLS_ASSERT(0 != stack);
+    d_stacks.push_back(stack);
+}
+
+void Heap::collect() {
+    const Int64 start = TimeUtil::getTimer();
+    evacuate();
+    if (e_Idle == d_phase) {
+        ++d_epoch;
+        d_phase   = e_Marking;
+        d_rootSet = 0;
+        d_cursor  = 0;
+    }
+    work(bsl::numeric_limits<Int64>::max());
+    finishPause(start);
+}
+
+void Heap::collectMinor() {
+    const Int64 start = TimeUtil::getTimer();
+    evacuate();
+    finishPause(start);
+}
+
+void Heap::setPauseBudget(Int64 nanoseconds) {
+    BSLS_ASSERT(0 <= nanoseconds);
+    d_pauseBudget = nanoseconds;
+}
+
+bool Heap::step() {
+    if (e_Idle == d_phase) {
+        if (d_tenured.numBytesInUse() < d_majorThreshold) {
+            return false;                                             // RETURN
+        }
+        ++d_epoch;
+        d_phase   = e_Marking;
+        d_rootSet = 0;
+        d_cursor  = 0;
+    }
+    const Int64 start = TimeUtil::getTimer();
+    const bool  done  = work(start + d_pauseBudget);
+    finishPause(start);
+    return !done;
+}
+
+// ACCESSORS
+bool Heap::isTenured(const Datum& value) const {
+    const void *memory = address(value);
+    return 0 != memory && d_index.end() != d_index.find(memory);
+}
+}
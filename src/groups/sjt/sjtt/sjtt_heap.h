@@ -0,0 +1,309 @@
+// sjtt_heap.h
+
+#ifndef INCLUDED_SJTT_HEAP
+#define INCLUDED_SJTT_HEAP
+
+#ifndef INCLUDED_SJTT_EXECUTIONARENA
+#include <sjtt_executionarena.h>
+#endif
+
+#ifndef INCLUDED_SJTT_GLOBALVALUE
+#include <sjtt_globalvalue.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BDLMA_COUNTINGALLOCATOR
+#include <bdlma_countingallocator.h>
+#endif
+
+#ifndef INCLUDED_BSL_UNORDERED_MAP
+#include <bsl_unordered_map.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                              // ===============
+                              // class HeapStats
+                              // ===============
+
+struct HeapStats {
+    // This 'struct' reports the work done by a 'Heap'.  Times are in
+    // nanoseconds; a pause is one call to 'Heap::collectMinor', 'Heap::step',
+    // or 'Heap::collect'.
+
+    // TYPES
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+
+    // PUBLIC DATA
+    Int64 d_numMinorCollections;  // nursery evacuations
+    Int64 d_numMajorCollections;  // completed major cycles
+    Int64 d_numBytesPromoted;     // copied to the tenured space
+    Int64 d_numBytesCollected;    // freed from the tenured space
+    Int64 d_numBytesTenured;      // in the tenured space now
+    Int64 d_numPauses;            // calls that did any work
+    Int64 d_lastPause;            // duration of the last pause
+    Int64 d_maxPause;             // longest pause
+    Int64 d_totalPause;           // sum of all pauses
+};
+
+                                 // ==========
+                                 // class Heap
+                                 // ==========
+
+class Heap {
+    // This class provides a generational, incremental garbage collector for
+    // the values created by scripts.  Values are first allocated from the
+    // nursery, an 'ExecutionArena', by bumping a pointer.  A minor
+    // collection evacuates the nursery: every root referring to a value not
+    // yet in the tenured space (i.e., a value in the nursery, or one whose
+    // memory is owned by somebody else, such as a bytecode constant) is
+    // replaced by a copy of that value promoted into the tenured space, and
+    // the nursery is then reset in one step.  Roots referring to the same
+    // value share the same promoted copy.
+    //
+    // The tenured space is collected by major cycles of incremental marking
+    // followed by incremental sweeping, performed by calls to 'step' that
+    // each stop once the pause budget is exhausted.  A major cycle starts
+    // when the tenured space has grown past a threshold, which is reset to
+    // twice the size of the live data at the end of each cycle.  During a
+    // cycle, values promoted are allocated already marked, and values
+    // written into globals are marked by 'recordWrite' (an insertion write
+    // barrier); the stacks are scanned again, atomically, at the end of
+    // marking.
+    //
+    // Roots are the values of registered globals (see 'addRoots') that are
+    // neither owned nor shared by their 'GlobalValue' (see
+    // 'GlobalValue::refer'), and all values on registered stacks, typically
+    // those of 'ExecutionContext' objects.  Each promoted value is copied
+    // whole and tracked as a unit, together with the addresses of the
+    // strings, arrays, and maps it contains, so that a root referring to any
+    // part of a tenured value keeps all of it alive.  Note that a tenured
+    // value contained in a newly promoted one is therefore copied again.
+    //
+    // Collections must only be run when no interpreter is executing with the
+    // nursery of the heap, or from an external function, whose callers hold
+    // all their values on the stack; values referred to by anything other
+    // than registered roots are not updated or kept alive.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+
+    enum {
+        k_DEFAULT_PAUSE_BUDGET     = 1000 * 1000,  // nanoseconds
+        k_MIN_MAJOR_THRESHOLD      = 1024 * 1024   // bytes
+    };
+
+  private:
+    // PRIVATE TYPES
+    enum Phase { e_Idle, e_Marking, e_Sweeping };
+
+    struct Entry {
+        // A value in the tenured space.
+
+        Datum    d_value;     // the value, allocated from 'd_tenured'
+        Int64    d_numBytes;  // memory used by 'd_value'
+        unsigned d_epoch;     // cycle in which the entry was last marked
+        bool     d_live;      // 'false' if this entry is free
+    };
+
+    typedef bsl::unordered_map<const void *, int>   Index;
+    typedef bsl::unordered_map<const void *, Datum> Forwarded;
+
+    // DATA
+    ExecutionArena                          *d_nursery_p;     // held
+    BloombergLP::bdlma::CountingAllocator    d_tenured;       // tenured space
+    bsl::vector<Entry>                       d_entries;       // tenured values
+    bsl::vector<int>                         d_freeEntries;   // reusable
+    Index                                    d_index;         // entry of each
+                                                              // string, array,
+                                                              // and map
+    bsl::vector<bsl::vector<GlobalValue> *>  d_globals;       // roots (held)
+    bsl::vector<bsl::vector<Datum> *>        d_stacks;        // roots (held)
+    bool                                     d_written;       // globals
+                                                              // written since
+                                                              // last minor
+                                                              // collection
+    Phase                                    d_phase;
+    unsigned                                 d_epoch;         // current cycle
+    bsl::size_t                              d_rootSet;       // progress of
+    bsl::size_t                              d_cursor;        // marking or
+                                                              // sweeping
+    Int64                                    d_pauseBudget;   // nanoseconds
+    Int64                                    d_majorThreshold;  // bytes
+    HeapStats                                d_stats;
+
+    // NOT IMPLEMENTED
+    Heap(const Heap&);
+    Heap& operator=(const Heap&);
+
+    // PRIVATE MANIPULATORS
+    void evacuate();
+        // Promote the values in the nursery reachable from the roots, update
+        // the roots, and reset the nursery.
+
+    void finishPause(Int64 start);
+        // Record in the statistics a pause that started at the specified
+        // 'start' time.
+
+    bool mark(const Datum& value);
+        // Mark the tenured entry containing the specified 'value', if any.
+        // Return 'true' if 'value' is in the tenured space, and 'false'
+        // otherwise.
+
+    Datum promote(const Datum& value, Forwarded *forwarded);
+        // Return the tenured copy of the specified 'value', creating it
+        // unless 'value' is already tenured, does not use memory, or has
+        // already been copied during this collection, as recorded in the
+        // specified 'forwarded' map.
+
+    void registerEntry(const Datum& value, int entry);
+        // Map the addresses of the strings, arrays, and maps in the specified
+        // 'value' to the specified 'entry'.
+
+    void unregisterEntry(const Datum& value);
+        // Remove the addresses of the strings, arrays, and maps in the
+        // specified 'value' from the index.
+
+    bool work(Int64 deadline);
+        // Perform major collection work until the specified 'deadline' or
+        // until the current cycle is complete.  Return 'true' if the cycle
+        // is complete, and 'false' otherwise.
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(Heap,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CLASS METHODS
+    static const void *address(const Datum& value);
+        // Return the address of the memory allocated for the specified
+        // 'value' if it is a string, array, or map not stored within the
+        // 'Datum' itself, and 0 otherwise.
+
+    // CREATORS
+    explicit Heap(ExecutionArena *nursery, Allocator *basicAllocator = 0);
+        // Create a heap using the specified 'nursery' for new values.
+        // Optionally specify a 'basicAllocator' used to supply memory for the
+        // tenured space.  If 'basicAllocator' is 0, the currently installed
+        // default allocator is used.
+
+    ~Heap();
+        // Destroy this heap and all the values in its tenured space.
+
+    // MANIPULATORS
+    void addRoots(bsl::vector<GlobalValue> *globals);
+        // Treat the values in the specified 'globals' that are neither owned
+        // nor shared as roots.  The behavior is undefined unless 'globals'
+        // outlives this heap.
+
+    void addRoots(bsl::vector<Datum> *stack);
+        // Treat the values in the specified 'stack' as roots.  The behavior
+        // is undefined unless 'stack' outlives this heap.
+
+    void collect();
+        // Perform a minor collection and a complete major collection, without
+        // regard to the pause budget.
+
+    void collectMinor();
+        // Promote into the tenured space all values in the nursery that are
+        // reachable from the roots, update the roots to refer to the copies,
+        // and reset the nursery.
+
+    Allocator *nursery();
+        // Return the allocator of the nursery.
+
+    void recordWrite(const Datum& value);
+        // Note that the specified 'value' is being written into a registered
+        // global with 'GlobalValue::refer'.  The behavior is undefined
+        // unless this is called for every such write.
+
+    void setPauseBudget(Int64 nanoseconds);
+        // Make each call to 'step' return once it has worked for the
+        // specified 'nanoseconds'.  The behavior is undefined unless
+        // '0 <= nanoseconds'.
+
+    bool step();
+        // Perform major collection work, if a cycle is in progress or the
+        // tenured space has reached the threshold, for at most about the
+        // pause budget.  Return 'true' if a cycle is in progress after this
+        // call, and 'false' otherwise.  Note that at least one unit of work
+        // is done per call, so that a cycle always completes.
+
+    // ACCESSORS
+    bool isCollecting() const;
+        // Return 'true' if a major cycle is in progress, and 'false'
+        // otherwise.
+
+    bool isTenured(const Datum& value) const;
+        // Return 'true' if the memory of the specified 'value' is in the
+        // tenured space, and 'false' otherwise.
+
+    Int64 pauseBudget() const;
+        // Return the pause budget, in nanoseconds.
+
+    const HeapStats& stats() const;
+        // Return the statistics of this heap.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                                 // ----------
+                                 // class Heap
+                                 // ----------
+
+// MANIPULATORS
+inline
+Heap::Allocator *Heap::nursery() {
+    return d_nursery_p->allocator();
+}
+
+inline
+void Heap::recordWrite(const Datum& value) {
+    d_written = true;
+    if (e_Marking == d_phase) {
+        mark(value);
+    }
+}
+
+// ACCESSORS
+inline
+bool Heap::isCollecting() const {
+    return e_Idle != d_phase;
+}
+
+inline
+Heap::Int64 Heap::pauseBudget() const {
+    return d_pauseBudget;
+}
+
+inline
+const HeapStats& Heap::stats() const {
+    return d_stats;
+}
+}
+
+#endif
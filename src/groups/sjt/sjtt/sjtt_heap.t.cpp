@@ -0,0 +1,348 @@
+// sjtt_heap.t.cpp                                         -*-C++-*-
+
+#include <sjtt_heap.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+const char *const TEXT = "a string long enough to need an allocation";
+
+bdld::Datum makeArray(const bdld::Datum&  first,
+                      const bdld::Datum&  second,
+                      bslma::Allocator   *allocator)
+    // Return an array holding the specified 'first' and 'second' values,
+    // allocated with the specified 'allocator'.
+{
+    bdld::DatumMutableArrayRef array;
+    bdld::Datum::createUninitializedArray(&array, 2, allocator);
+    array.data()[0] = first;
+    array.data()[1] = second;
+    *array.length() = 2;
+    return bdld::Datum::adoptArray(array);
+}
+
+bool inBuffer(const void *address, const char *buffer, bsl::size_t size)
+    // Return 'true' if the specified 'address' is in the specified 'buffer'
+    // of the specified 'size', and 'false' otherwise.
+{
+    const char *bytes = static_cast<const char *>(address);
+    return buffer <= bytes && bytes < buffer + size;
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "incremental collection" << endl
+                          << "======================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            ExecutionArena           arena(&ta);
+            bsl::vector<GlobalValue> globals(&ta);
+            Heap                     heap(&arena, &ta);
+            heap.addRoots(&globals);
+            heap.addRoots(arena.stack());
+            heap.setPauseBudget(0);
+            ASSERT(0 == heap.pauseBudget());
+
+            // Tenure enough data to start a major cycle.
+
+            const bsl::string big(4096, 'x');
+            const int         NUM_GLOBALS = 2 * Heap::k_MIN_MAJOR_THRESHOLD
+                                          / static_cast<int>(big.size());
+            globals.resize(NUM_GLOBALS);
+            for (int i = 0; i < NUM_GLOBALS; ++i) {
+                const bdld::Datum value = bdld::Datum::copyString(
+                                                           big,
+                                                           arena.allocator());
+                heap.recordWrite(value);
+                globals[i].refer(value);
+            }
+            heap.collectMinor();
+
+            // Drop all but one global, keeping the first element of an array
+            // on the stack only.
+
+            const bdld::Datum array = makeArray(globals[0].datum(),
+                                                globals[1].datum(),
+                                                arena.allocator());
+            globals[0].refer(array);
+            heap.recordWrite(array);
+            heap.collectMinor();
+            arena.stack()->push_back(globals[0].datum().theArray()[0]);
+            for (int i = 0; i < NUM_GLOBALS; ++i) {
+                if (i != NUM_GLOBALS / 2) {
+                    heap.recordWrite(bdld::Datum::createNull());
+                    globals[i].makeNull();
+                }
+            }
+
+            const HeapStats::Int64 numPauses = heap.stats().d_numPauses;
+            int numSteps = 0;
+            while (heap.step()) {
+                ++numSteps;
+                ASSERT(heap.isCollecting());
+            }
+            ASSERT(!heap.isCollecting());
+            ASSERTV(numSteps, 1 < numSteps);
+            ASSERT(numPauses + numSteps + 1 == heap.stats().d_numPauses);
+            ASSERT(1 == heap.stats().d_numMajorCollections);
+            ASSERT(0 < heap.stats().d_numBytesCollected);
+            ASSERT(0 <= heap.stats().d_maxPause);
+            ASSERT(heap.stats().d_maxPause <= heap.stats().d_totalPause);
+
+            ASSERT(heap.isTenured(globals[NUM_GLOBALS / 2].datum()));
+            ASSERT(big == globals[NUM_GLOBALS / 2].datum().theString());
+            ASSERT(heap.isTenured(arena.stack()->back()));
+            ASSERT(big == arena.stack()->back().theString());
+            ASSERT(heap.stats().d_numBytesTenured < 4 * 4096 + 1024);
+
+            // Below the threshold, no cycle starts.
+
+            ASSERT(!heap.step());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "major collection" << endl
+                          << "================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            ExecutionArena           arena(&ta);
+            bsl::vector<GlobalValue> globals(&ta);
+            Heap                     heap(&arena, &ta);
+            heap.addRoots(&globals);
+            globals.resize(3);
+            for (int i = 0; i < 3; ++i) {
+                const bdld::Datum value = bdld::Datum::copyString(
+                                                           TEXT,
+                                                           arena.allocator());
+                heap.recordWrite(value);
+                globals[i].refer(value);
+            }
+            heap.collectMinor();
+            const HeapStats::Int64 tenured = heap.stats().d_numBytesTenured;
+            ASSERT(0 < tenured);
+
+            // Values no longer referred to are freed by a major collection;
+            // the others are left in place.
+
+            const char *kept = globals[2].datum().theString().data();
+            globals[0].makeNull();
+            heap.recordWrite(globals[2].datum());
+            globals[1].refer(globals[2].datum());
+            heap.collect();
+            ASSERT(1 == heap.stats().d_numMajorCollections);
+            ASSERT(2 * tenured / 3 == heap.stats().d_numBytesCollected);
+            ASSERT(tenured / 3 == heap.stats().d_numBytesTenured);
+            ASSERT(kept == globals[1].datum().theString().data());
+            ASSERT(kept == globals[2].datum().theString().data());
+            ASSERT(heap.isTenured(globals[1].datum()));
+
+            // Globals owning their values are not roots.
+
+            globals[1].clone(globals[2].datum());
+            globals[2].clone(bdld::Datum::createInteger(2));
+            heap.collect();
+            ASSERT(0 == heap.stats().d_numBytesTenured);
+            ASSERT(TEXT == globals[1].datum().theString());
+            ASSERT(!heap.isCollecting());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "minor collection" << endl
+                          << "================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            char                     buffer[1024];
+            ExecutionArena           arena(buffer, sizeof buffer, &ta);
+            bsl::vector<GlobalValue> globals(&ta);
+            bsl::vector<bdld::Datum> stack(&ta);
+            Heap                     heap(&arena, &ta);
+            heap.addRoots(&globals);
+            heap.addRoots(&stack);
+            globals.resize(4);
+
+            const bdld::Datum text = bdld::Datum::copyString(
+                                                           TEXT,
+                                                           arena.allocator());
+            const bdld::Datum array = makeArray(text,
+                                                bdld::Datum::createDouble(1),
+                                                arena.allocator());
+            ASSERT(inBuffer(text.theString().data(), buffer, sizeof buffer));
+            ASSERT(!heap.isTenured(text));
+
+            heap.recordWrite(text);
+            globals[0].refer(text);
+            heap.recordWrite(text);
+            globals[1].refer(text);
+            heap.recordWrite(array);
+            globals[2].refer(array);
+            globals[3].clone(text);
+            stack.push_back(array);
+            stack.push_back(bdld::Datum::createDouble(2));
+
+            heap.collectMinor();
+            ASSERT(1 == heap.stats().d_numMinorCollections);
+            ASSERT(0 < heap.stats().d_numBytesPromoted);
+            ASSERT(heap.stats().d_numBytesPromoted ==
+                                             heap.stats().d_numBytesTenured);
+
+            // Roots now refer to tenured copies, and roots that referred to
+            // the same value share the same copy.
+
+            const bdld::Datum& promoted = globals[0].datum();
+            ASSERT(TEXT == promoted.theString());
+            ASSERT(!inBuffer(promoted.theString().data(),
+                             buffer,
+                             sizeof buffer));
+            ASSERT(heap.isTenured(promoted));
+            ASSERT(promoted.theString().data() ==
+                                    globals[1].datum().theString().data());
+            ASSERT(globals[2].datum().theArray().data() ==
+                                                stack[0].theArray().data());
+            ASSERT(heap.isTenured(stack[0]));
+            ASSERT(heap.isTenured(stack[0].theArray()[0]));
+            ASSERT(TEXT == stack[0].theArray()[0].theString());
+            ASSERT(bdld::Datum::createDouble(2) == stack[1]);
+            ASSERT(!heap.isTenured(globals[3].datum()));
+            ASSERT(globals[3].isOwned());
+
+            // The nursery is reset.
+
+            const bdld::Datum next = bdld::Datum::copyString(
+                                                           TEXT,
+                                                           arena.allocator());
+            ASSERT(inBuffer(next.theString().data(), buffer, sizeof buffer));
+
+            // Values already tenured are not copied again.
+
+            const HeapStats::Int64 promotedBytes =
+                                              heap.stats().d_numBytesPromoted;
+            heap.collectMinor();
+            ASSERT(promotedBytes == heap.stats().d_numBytesPromoted);
+            ASSERT(2 == heap.stats().d_numMinorCollections);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            ExecutionArena arena(&ta);
+            Heap           heap(&arena, &ta);
+            ASSERT(arena.allocator() == heap.nursery());
+            ASSERT(!heap.isCollecting());
+            ASSERT(Heap::k_DEFAULT_PAUSE_BUDGET == heap.pauseBudget());
+            ASSERT(0 == heap.stats().d_numMinorCollections);
+            ASSERT(0 == heap.stats().d_numBytesTenured);
+
+            // Only strings, arrays, and maps that are not stored within the
+            // 'Datum' use memory.
+
+            const bdld::Datum text = bdld::Datum::copyString(TEXT, &ta);
+            ASSERT(text.theString().data() == Heap::address(text));
+            ASSERT(0 == Heap::address(bdld::Datum::createDouble(1)));
+            ASSERT(0 == Heap::address(bdld::Datum::createNull()));
+            ASSERT(!heap.isTenured(text));
+            bdld::Datum::destroy(text, &ta);
+
+            heap.collectMinor();
+            ASSERT(1 == heap.stats().d_numMinorCollections);
+            ASSERT(0 == heap.stats().d_numBytesPromoted);
+            ASSERT(!heap.step());
+            heap.collect();
+            ASSERT(1 == heap.stats().d_numMajorCollections);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
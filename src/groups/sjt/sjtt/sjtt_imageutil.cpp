@@ -0,0 +1,107 @@
+// sjtt_imageutil.cpp
+#include <sjtt_imageutil.h>
+
+#include <bsls_assert.h>
+#include <bsls_platform.h>
+
+#ifdef BSLS_PLATFORM_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sjtt {
+
+namespace {
+
+struct Crc32Table {
+    // This 'struct' holds the remainder of each byte value for the
+    // (reflected) CRC-32 polynomial.
+
+    // DATA
+    unsigned int d_entries[256];
+
+    // CREATORS
+    Crc32Table() {
+        for (unsigned int i = 0; i < 256; ++i) {
+            unsigned int c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            d_entries[i] = c;
+        }
+    }
+};
+
+}  // close unnamed namespace
+
+                              // ----------------
+                              // struct ImageUtil
+                              // ----------------
+
+// CLASS METHODS
+unsigned int ImageUtil::crc32(const char   *data,
+                              bsl::size_t   length,
+                              unsigned int  crc)
+{
+    BSLS_ASSERT(0 != data || 0 == length);
+
+    static const Crc32Table table;
+
+    crc = ~crc;
+    for (bsl::size_t i = 0; i < length; ++i) {
+        crc = table.d_entries[(crc ^ static_cast<unsigned char>(data[i]))
+                                                                      & 0xFF]
+            ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+int ImageUtil::mapFile(const char  **data,
+                       bsl::size_t  *size,
+                       const char   *path)
+{
+    BSLS_ASSERT(0 != data);
+    BSLS_ASSERT(0 != size);
+    BSLS_ASSERT(0 != path);
+
+#ifdef BSLS_PLATFORM_OS_UNIX
+    const int fd = open(path, O_RDONLY);
+    if (0 > fd) {
+        return 1;                                                     // RETURN
+    }
+    struct stat info;
+    if (0 != fstat(fd, &info)) {
+        close(fd);
+        return 1;                                                     // RETURN
+    }
+    if (0 == info.st_size) {
+        close(fd);
+        *data = 0;
+        *size = 0;
+        return 0;                                                     // RETURN
+    }
+    const bsl::size_t length  = static_cast<bsl::size_t>(info.st_size);
+    void             *mapping = mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == mapping) {
+        return 1;                                                     // RETURN
+    }
+    *data = static_cast<const char *>(mapping);
+    *size = length;
+    return 0;
+#else
+    return 1;
+#endif
+}
+
+void ImageUtil::unmapFile(const char *data, bsl::size_t size)
+{
+#ifdef BSLS_PLATFORM_OS_UNIX
+    if (0 != size) {
+        munmap(const_cast<char *>(data), size);
+    }
+#endif
+}
+}
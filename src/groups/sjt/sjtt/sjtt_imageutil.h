@@ -0,0 +1,47 @@
+// sjtt_imageutil.h
+
+#ifndef INCLUDED_SJTT_IMAGEUTIL
+#define INCLUDED_SJTT_IMAGEUTIL
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+namespace sjtt {
+
+                              // ================
+                              // struct ImageUtil
+                              // ================
+
+struct ImageUtil {
+    // This 'struct' provides a namespace for the operations shared by the
+    // binary images of programs and engines (see 'ProgramImage' and
+    // 'SnapshotImage'): checksums, and read-only mappings of files.
+
+    // CLASS METHODS
+    static unsigned int crc32(const char   *data,
+                              bsl::size_t   length,
+                              unsigned int  crc = 0);
+        // Return the CRC-32 (as used by zlib) of the specified 'length' bytes
+        // at the specified 'data'.  Optionally specify the 'crc' of preceding
+        // bytes to continue from; the default is that of no bytes.
+
+    static int mapFile(const char  **data,
+                       bsl::size_t  *size,
+                       const char   *path);
+        // Map the file at the specified 'path' into memory, read-only, and
+        // load its address into the specified 'data' and its length into
+        // the specified 'size'.  Return 0 on success, and a non-zero value,
+        // with no effect on 'data' and 'size', if the file cannot be opened
+        // or mapped.  If the file is empty, 0 is loaded into 'data' and
+        // 'size'.  Files can be mapped only on Unix platforms.
+
+    static void unmapFile(const char *data, bsl::size_t size);
+        // Release the mapping of the specified 'size' bytes at the specified
+        // 'data' obtained with 'mapFile'.  The behavior is undefined unless
+        // 'data' and 'size' were loaded by a call to 'mapFile' and have not
+        // been released since.
+};
+}
+
+#endif
@@ -0,0 +1,137 @@
+// sjtt_imageutil.t.cpp                                    -*-C++-*-
+
+#include <sjtt_imageutil.h>
+
+#include <bdls_testutil.h>
+
+#include <bsl_cstdio.h>
+#include <bsl_cstring.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "mapFile" << endl
+                          << "=======" << endl;
+
+        const char *const PATH     = "sjtt_imageutil.t.tmp";
+        const char        CONTENTS[] = "mapped contents";
+
+        FILE *file = bsl::fopen(PATH, "wb");
+        ASSERT(0 != file);
+        ASSERT(sizeof CONTENTS ==
+                              bsl::fwrite(CONTENTS, 1, sizeof CONTENTS, file));
+        ASSERT(0 == bsl::fclose(file));
+
+        const char  *data = 0;
+        bsl::size_t  size = 0;
+        ASSERT(0 == ImageUtil::mapFile(&data, &size, PATH));
+        ASSERT(sizeof CONTENTS == size);
+        ASSERT(0 != data);
+        ASSERT(0 == bsl::memcmp(CONTENTS, data, size));
+        ImageUtil::unmapFile(data, size);
+
+        // An empty file maps to nothing, and a missing file is an error that
+        // leaves the results unchanged.
+
+        file = bsl::fopen(PATH, "wb");
+        ASSERT(0 != file);
+        ASSERT(0 == bsl::fclose(file));
+        ASSERT(0 == ImageUtil::mapFile(&data, &size, PATH));
+        ASSERT(0 == data);
+        ASSERT(0 == size);
+        ImageUtil::unmapFile(data, size);
+        ASSERT(0 == bsl::remove(PATH));
+
+        size = 7;
+        ASSERT(0 != ImageUtil::mapFile(&data, &size, PATH));
+        ASSERT(0 == data);
+        ASSERT(7 == size);
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "crc32" << endl
+                          << "=====" << endl;
+
+        // The check value of CRC-32 is that of "123456789".
+
+        ASSERT(0xCBF43926u == ImageUtil::crc32("123456789", 9));
+        ASSERT(0 == ImageUtil::crc32(0, 0));
+
+        // A checksum can be computed piecewise.
+
+        for (bsl::size_t i = 0; i <= 9; ++i) {
+            const unsigned int crc = ImageUtil::crc32("123456789", i);
+            ASSERTV(i, 0xCBF43926u ==
+                             ImageUtil::crc32("123456789" + i, 9 - i, crc));
+        }
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,11 @@
+// sjtt_loopcounter.cpp
+#include <sjtt_loopcounter.h>
+
+namespace sjtt {
+
+                             // -----------------
+                             // class LoopCounter
+                             // -----------------
+
+// All functions of 'LoopCounter' are defined inline.
+}
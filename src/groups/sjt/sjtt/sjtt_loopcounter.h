@@ -0,0 +1,105 @@
+// sjtt_loopcounter.h
+
+#ifndef INCLUDED_SJTT_LOOPCOUNTER
+#define INCLUDED_SJTT_LOOPCOUNTER
+
+#ifndef INCLUDED_BSLS_ATOMIC
+#include <bsls_atomic.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+namespace sjtt {
+
+                             // =================
+                             // class LoopCounter
+                             // =================
+
+class LoopCounter {
+    // This class provides the hotness counter of a loop: the number of times
+    // the back edge of the loop was taken since the counter was created or
+    // reset.  The counter is carried by the 'e_LoopHeader' instruction at the
+    // head of the loop, and incremented by each 'e_Loop' jumping back to that
+    // instruction, so that the number of iterations of each loop is known
+    // without profiling, and a 'TierUpPolicy' can be told when a loop
+    // becomes hot.
+    //
+    // A counter may be used by several threads at once, e.g., by the
+    // workers of an 'sjtm::Executor' running the same program.  To keep the
+    // back edge as cheap as a plain increment, 'increment' is a relaxed
+    // atomic load followed by a relaxed atomic store rather than an atomic
+    // read-modify-write, so that increments made by several threads at
+    // once may be lost: the count is then a lower bound of the back edges
+    // taken, and, since every value up to the count is returned by some
+    // call to 'increment', a value may be returned to more than one thread.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+
+  private:
+    // DATA
+    BloombergLP::bsls::AtomicInt64 d_count;  // back edges taken
+
+    // NOT IMPLEMENTED
+    LoopCounter(const LoopCounter&);
+    LoopCounter& operator=(const LoopCounter&);
+
+  public:
+    // CREATORS
+    LoopCounter();
+        // Create a counter of a loop whose back edge was never taken.
+
+    // MANIPULATORS
+    Int64 increment();
+        // Record that the back edge of the loop was taken, and return the
+        // number of times it was.
+
+    void reset();
+        // Forget the back edges taken, e.g., so that a 'TierUpPolicy' is
+        // told again when the loop becomes hot.
+
+    // ACCESSORS
+    Int64 count() const;
+        // Return the number of times the back edge of the loop was taken
+        // since this counter was created or reset.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // -----------------
+                             // class LoopCounter
+                             // -----------------
+
+// CREATORS
+inline
+LoopCounter::LoopCounter()
+: d_count(0)
+{
+}
+
+// MANIPULATORS
+inline
+LoopCounter::Int64 LoopCounter::increment() {
+    const Int64 count = d_count.loadRelaxed() + 1;
+    d_count.storeRelaxed(count);
+    return count;
+}
+
+inline
+void LoopCounter::reset() {
+    d_count.storeRelaxed(0);
+}
+
+// ACCESSORS
+inline
+LoopCounter::Int64 LoopCounter::count() const {
+    return d_count.loadRelaxed();
+}
+}
+
+#endif
@@ -0,0 +1,144 @@
+// sjtt_loopcounter.t.cpp                                 -*-C++-*-
+
+#include <sjtt_loopcounter.h>
+
+#include <bdls_testutil.h>
+#include <bslmt_threadutil.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+enum { k_NUM_INCREMENTS = 100000 };
+
+struct Incrementer {
+    // This 'struct' increments a counter 'k_NUM_INCREMENTS' times, as one of
+    // several threads running the same loop.
+
+    // DATA
+    LoopCounter *d_counter_p;  // counter to increment
+
+    // MANIPULATORS
+    void operator()() {
+        for (int i = 0; i < k_NUM_INCREMENTS; ++i) {
+            d_counter_p->increment();
+        }
+    }
+};
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "concurrent increments" << endl
+                          << "=====================" << endl;
+
+        // Increments may be lost, but each thread sees its own.
+
+        enum { k_NUM_THREADS = 4 };
+
+        LoopCounter               counter;
+        bslmt::ThreadUtil::Handle handles[k_NUM_THREADS];
+        for (int i = 0; i < k_NUM_THREADS; ++i) {
+            const Incrementer incrementer = { &counter };
+            ASSERT(0 == bslmt::ThreadUtil::create(&handles[i], incrementer));
+        }
+        for (int i = 0; i < k_NUM_THREADS; ++i) {
+            ASSERT(0 == bslmt::ThreadUtil::join(handles[i]));
+        }
+        ASSERTV(counter.count(), k_NUM_INCREMENTS <= counter.count());
+        ASSERTV(counter.count(),
+                k_NUM_THREADS * k_NUM_INCREMENTS >= counter.count());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        LoopCounter counter;
+        ASSERT(0 == counter.count());
+
+        ASSERT(1 == counter.increment());
+        ASSERT(2 == counter.increment());
+        ASSERT(2 == counter.count());
+
+        for (int i = 0; i < 1000; ++i) {
+            counter.increment();
+        }
+        ASSERT(1002 == counter.count());
+
+        counter.reset();
+        ASSERT(0 == counter.count());
+        ASSERT(1 == counter.increment());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,87 @@
+// sjtt_memorymeter.cpp
+#include <sjtt_memorymeter.h>
+
+#include <bslma_default.h>
+#include <bsls_alignmentutil.h>
+#include <bsls_bslexceptionutil.h>
+
+namespace sjtt {
+
+namespace {
+
+enum {
+    k_HEADER_SIZE = BloombergLP::bsls::AlignmentUtil::BSLS_MAX_ALIGNMENT
+        // bytes in front of each allocation, holding its size and keeping
+        // the memory returned maximally aligned
+};
+
+}  // close unnamed namespace
+
+                         // ---------------------------
+                         // class MemoryMeter_Allocator
+                         // ---------------------------
+
+// MANIPULATORS
+void *MemoryMeter_Allocator::allocate(size_type size)
+{
+    BSLS_ASSERT_SAFE(0 != d_meter_p);
+    return d_meter_p->allocate(d_category, size);
+}
+
+void MemoryMeter_Allocator::deallocate(void *address)
+{
+    BSLS_ASSERT_SAFE(0 != d_meter_p);
+    d_meter_p->deallocate(d_category, address);
+}
+
+                             // -----------------
+                             // class MemoryMeter
+                             // -----------------
+
+// CREATORS
+MemoryMeter::MemoryMeter(Allocator *basicAllocator)
+: d_allocator_p(BloombergLP::bslma::Default::allocator(basicAllocator))
+, d_limit(0)
+, d_numRefusals(0)
+, d_enforced(false)
+{
+    for (int i = 0; i < k_NUM_CATEGORIES; ++i) {
+        d_allocators[i].init(this, i);
+    }
+}
+
+// PRIVATE MANIPULATORS
+void *MemoryMeter::allocate(int category, Allocator::size_type size)
+{
+    if (0 == size) {
+        return 0;                                                     // RETURN
+    }
+    const Int64 numBytes = static_cast<Int64>(size);
+    const Int64 limit    = d_limit.loadRelaxed();
+    if (d_enforced && 0 != limit
+     && d_total.numBytesInUse() + numBytes > limit) {
+        d_numRefusals.addRelaxed(1);
+        BloombergLP::bsls::BslExceptionUtil::throwBadAlloc();
+    }
+
+    char *block = static_cast<char *>(
+                                d_allocator_p->allocate(k_HEADER_SIZE + size));
+    *reinterpret_cast<Allocator::size_type *>(block) = size;
+    d_categories[category].recordAllocation(numBytes);
+    d_total.recordAllocation(numBytes);
+    return block + k_HEADER_SIZE;
+}
+
+void MemoryMeter::deallocate(int category, void *address)
+{
+    if (0 == address) {
+        return;                                                       // RETURN
+    }
+    char        *block    = static_cast<char *>(address) - k_HEADER_SIZE;
+    const Int64  numBytes = static_cast<Int64>(
+                             *reinterpret_cast<Allocator::size_type *>(block));
+    d_categories[category].recordDeallocation(numBytes);
+    d_total.recordDeallocation(numBytes);
+    d_allocator_p->deallocate(block);
+}
+}
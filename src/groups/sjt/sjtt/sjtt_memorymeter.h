@@ -0,0 +1,351 @@
+// sjtt_memorymeter.h
+
+#ifndef INCLUDED_SJTT_MEMORYMETER
+#define INCLUDED_SJTT_MEMORYMETER
+
+#ifndef INCLUDED_BSLMA_ALLOCATOR
+#include <bslma_allocator.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ATOMIC
+#include <bsls_atomic.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+namespace sjtt {
+
+class MemoryMeter;
+
+                             // =================
+                             // class MemoryStats
+                             // =================
+
+struct MemoryStats {
+    // This 'struct' reports the memory used by one category of a
+    // 'MemoryMeter', or by all of them.  Sizes are in bytes, as requested
+    // from the meter, excluding its own overhead.
+
+    // TYPES
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+
+    // PUBLIC DATA
+    Int64 d_numBytesInUse;      // allocated and not yet deallocated
+    Int64 d_peakNumBytesInUse;  // highest 'd_numBytesInUse' so far
+    Int64 d_numAllocations;     // allocations so far
+    Int64 d_numDeallocations;   // deallocations so far
+};
+
+                         // ==========================
+                         // class MemoryMeter_Counters
+                         // ==========================
+
+class MemoryMeter_Counters {
+    // This component-private class holds the counters of one category of a
+    // 'MemoryMeter'.  Counters are updated and read with relaxed atomic
+    // operations: each is exact, but a set of them read while memory is
+    // being allocated need not be consistent with each other.
+
+    // PRIVATE TYPES
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+
+    // DATA
+    BloombergLP::bsls::AtomicInt64 d_numBytesInUse;
+    BloombergLP::bsls::AtomicInt64 d_peakNumBytesInUse;
+    BloombergLP::bsls::AtomicInt64 d_numAllocations;
+    BloombergLP::bsls::AtomicInt64 d_numDeallocations;
+
+  public:
+    // MANIPULATORS
+    void recordAllocation(Int64 numBytes);
+        // Count an allocation of the specified 'numBytes'.
+
+    void recordDeallocation(Int64 numBytes);
+        // Count a deallocation of the specified 'numBytes'.
+
+    // ACCESSORS
+    Int64 numBytesInUse() const;
+        // Return the number of bytes allocated and not yet deallocated.
+
+    MemoryStats stats() const;
+        // Return the current values of the counters.
+};
+
+                         // ===========================
+                         // class MemoryMeter_Allocator
+                         // ===========================
+
+class MemoryMeter_Allocator : public BloombergLP::bslma::Allocator {
+    // This component-private class provides the allocator of one category of
+    // a 'MemoryMeter'.
+
+    // DATA
+    MemoryMeter *d_meter_p;   // meter of the category (held)
+    int          d_category;  // 'MemoryMeter::Category' counted
+
+  public:
+    // CREATORS
+    MemoryMeter_Allocator();
+        // Create an allocator that must be given a category with 'init'
+        // before it is used.
+
+    // MANIPULATORS
+    void init(MemoryMeter *meter, int category);
+        // Count the memory supplied by this allocator in the specified
+        // 'category' of the specified 'meter'.
+
+    void *allocate(size_type size);
+        // Return memory of the specified 'size' from the meter of this
+        // allocator.  See 'MemoryMeter'.
+
+    void deallocate(void *address);
+        // Return the memory at the specified 'address' to the meter of this
+        // allocator.
+};
+
+                             // =================
+                             // class MemoryMeter
+                             // =================
+
+class MemoryMeter {
+    // This class provides a mechanism accounting for the memory used by an
+    // engine.  It supplies one allocator per 'Category', each forwarding to
+    // a common underlying allocator and counting, for its category and for
+    // the total, the bytes in use, their peak, and the numbers of allocations
+    // and deallocations.  The size of each allocation is stored in front of
+    // it, so that a deallocation can be counted too.
+    //
+    // A meter can have a limit on the total number of bytes in use.  While
+    // the limit is enforced (see 'setLimitEnforced'), an allocation that
+    // would take the total past it is refused: it is counted in
+    // 'numRefusals', and the allocator fails as 'bslma' allocators do when
+    // memory is exhausted, by throwing 'bsl::bad_alloc'.  Enforcement is
+    // meant to be turned on only while a script runs, whose caller recovers
+    // from the failure; memory allocated otherwise is counted against the
+    // limit but never refused.
+    //
+    // The counters may be read from any thread, e.g., to export them as
+    // metrics, without synchronizing with the thread allocating.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+    typedef BloombergLP::bslma::Allocator   Allocator;
+
+    enum Category {
+        // Enumeration of the uses of memory that are counted separately.
+
+        e_Globals,  // globals, their names, and the snapshots they refer to
+        e_Stacks,   // value stacks and temporaries of running scripts
+        e_Heap,     // values created by scripts that outlived their run
+        e_Other     // everything else, e.g., compiled code
+    };
+
+    enum {
+        k_NUM_CATEGORIES = e_Other + 1
+    };
+
+  private:
+    // DATA
+    Allocator                      *d_allocator_p;  // memory supplier (held)
+    MemoryMeter_Counters            d_categories[k_NUM_CATEGORIES];
+    MemoryMeter_Counters            d_total;
+    BloombergLP::bsls::AtomicInt64  d_limit;        // bytes, or 0 if none
+    BloombergLP::bsls::AtomicInt64  d_numRefusals;
+    bool                            d_enforced;     // limit in effect
+    MemoryMeter_Allocator           d_allocators[k_NUM_CATEGORIES];
+
+    // FRIENDS
+    friend class MemoryMeter_Allocator;
+
+    // NOT IMPLEMENTED
+    MemoryMeter(const MemoryMeter&);
+    MemoryMeter& operator=(const MemoryMeter&);
+
+    // PRIVATE MANIPULATORS
+    void *allocate(int category, Allocator::size_type size);
+        // Return memory of the specified 'size' counted in the specified
+        // 'category', or throw 'bsl::bad_alloc' if the limit is enforced and
+        // would be exceeded.
+
+    void deallocate(int category, void *address);
+        // Return the memory at the specified 'address', counted in the
+        // specified 'category', to the underlying allocator.
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(MemoryMeter,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CREATORS
+    explicit MemoryMeter(Allocator *basicAllocator = 0);
+        // Create a meter with no limit.  Optionally specify a
+        // 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.
+
+    //! ~MemoryMeter() = default;
+        // Destroy this object.  The behavior is undefined unless all memory
+        // supplied by its allocators has been deallocated.
+
+    // MANIPULATORS
+    Allocator *allocator(Category category);
+        // Return the allocator counting memory in the specified 'category'.
+        // It remains valid as long as this meter.
+
+    void setLimit(Int64 numBytes);
+        // Limit the total number of bytes in use to the specified 'numBytes',
+        // or remove the limit if 'numBytes' is 0.  Memory already in use is
+        // not affected.  The behavior is undefined unless '0 <= numBytes'.
+
+    void setLimitEnforced(bool enforced);
+        // Refuse allocations exceeding the limit if the specified 'enforced'
+        // is 'true', and allow them otherwise.  The limit is not enforced by
+        // default.  The behavior is undefined unless this method is called
+        // by the thread allocating from this meter.
+
+    // ACCESSORS
+    bool isLimitEnforced() const;
+        // Return 'true' if allocations exceeding the limit are refused, and
+        // 'false' otherwise.
+
+    Int64 limit() const;
+        // Return the limit on the total number of bytes in use, or 0 if
+        // there is none.
+
+    Int64 numRefusals() const;
+        // Return the number of allocations refused so far.
+
+    MemoryStats stats(Category category) const;
+        // Return the statistics of the specified 'category'.
+
+    MemoryStats totalStats() const;
+        // Return the statistics of all categories together.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                         // --------------------------
+                         // class MemoryMeter_Counters
+                         // --------------------------
+
+// MANIPULATORS
+inline
+void MemoryMeter_Counters::recordAllocation(Int64 numBytes) {
+    d_numAllocations.addRelaxed(1);
+    const Int64 inUse = d_numBytesInUse.addRelaxed(numBytes);
+    Int64       peak  = d_peakNumBytesInUse.loadRelaxed();
+    while (peak < inUse) {
+        const Int64 previous = d_peakNumBytesInUse.testAndSwap(peak, inUse);
+        if (previous == peak) {
+            break;
+        }
+        peak = previous;
+    }
+}
+
+inline
+void MemoryMeter_Counters::recordDeallocation(Int64 numBytes) {
+    d_numDeallocations.addRelaxed(1);
+    d_numBytesInUse.addRelaxed(-numBytes);
+}
+
+// ACCESSORS
+inline
+MemoryMeter_Counters::Int64 MemoryMeter_Counters::numBytesInUse() const {
+    return d_numBytesInUse.loadRelaxed();
+}
+
+inline
+MemoryStats MemoryMeter_Counters::stats() const {
+    MemoryStats result;
+    result.d_numBytesInUse     = d_numBytesInUse.loadRelaxed();
+    result.d_peakNumBytesInUse = d_peakNumBytesInUse.loadRelaxed();
+    result.d_numAllocations    = d_numAllocations.loadRelaxed();
+    result.d_numDeallocations  = d_numDeallocations.loadRelaxed();
+    return result;
+}
+
+                         // ---------------------------
+                         // class MemoryMeter_Allocator
+                         // ---------------------------
+
+// CREATORS
+inline
+MemoryMeter_Allocator::MemoryMeter_Allocator()
+: d_meter_p(0)
+, d_category(0) {
+}
+
+// MANIPULATORS
+inline
+void MemoryMeter_Allocator::init(MemoryMeter *meter, int category) {
+    BSLS_ASSERT_SAFE(0 != meter);
+    d_meter_p  = meter;
+    d_category = category;
+}
+
+                             // -----------------
+                             // class MemoryMeter
+                             // -----------------
+
+// MANIPULATORS
+inline
+MemoryMeter::Allocator *MemoryMeter::allocator(Category category) {
+    BSLS_ASSERT_SAFE(0 <= category);
+    BSLS_ASSERT_SAFE(static_cast<int>(category) < k_NUM_CATEGORIES);
+    return &d_allocators[category];
+}
+
+inline
+void MemoryMeter::setLimit(Int64 numBytes) {
+    BSLS_ASSERT(0 <= numBytes);
+    d_limit.storeRelaxed(numBytes);
+}
+
+inline
+void MemoryMeter::setLimitEnforced(bool enforced) {
+    d_enforced = enforced;
+}
+
+// ACCESSORS
+inline
+bool MemoryMeter::isLimitEnforced() const {
+    return d_enforced;
+}
+
+inline
+MemoryMeter::Int64 MemoryMeter::limit() const {
+    return d_limit.loadRelaxed();
+}
+
+inline
+MemoryMeter::Int64 MemoryMeter::numRefusals() const {
+    return d_numRefusals.loadRelaxed();
+}
+
+inline
+MemoryStats MemoryMeter::stats(Category category) const {
+    BSLS_ASSERT_SAFE(0 <= category);
+    BSLS_ASSERT_SAFE(static_cast<int>(category) < k_NUM_CATEGORIES);
+    return d_categories[category].stats();
+}
+
+inline
+MemoryStats MemoryMeter::totalStats() const {
+    return d_total.stats();
+}
+}
+
+#endif
@@ -0,0 +1,300 @@
+// sjtt_memorymeter.t.cpp                                  -*-C++-*-
+
+#include <sjtt_memorymeter.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+#include <bslmt_threadutil.h>
+#include <bsls_atomic.h>
+
+#include <bsl_functional.h>
+#include <bsl_new.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef MemoryMeter Obj;
+
+struct Reader {
+    // This 'struct' reads the statistics of a meter until told to stop,
+    // checking that they are consistent with what the allocating thread
+    // does.
+
+    // DATA
+    const Obj               *d_meter_p;   // meter to read
+    const bsls::AtomicBool  *d_done_p;    // set when the allocator is done
+    int                      d_numReads;  // statistics read
+    int                      d_numErrors; // inconsistencies seen
+
+    // MANIPULATORS
+    void operator()() {
+        MemoryStats::Int64 lastAllocations = 0;
+        while (!d_done_p->load()) {
+            const MemoryStats stats = d_meter_p->totalStats();
+            if (stats.d_numAllocations < lastAllocations
+             || stats.d_numBytesInUse < 0
+             || stats.d_peakNumBytesInUse > 64 * 1024) {
+                ++d_numErrors;
+            }
+            lastAllocations = stats.d_numAllocations;
+            ++d_numReads;
+        }
+    }
+};
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "concurrent reading" << endl
+                          << "==================" << endl;
+
+        // Statistics are read by another thread while memory is allocated
+        // and deallocated; each counter read must be plausible.
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            Obj              mX(&ta);  const Obj& X = mX;
+            bsls::AtomicBool done(false);
+
+            Reader                    reader = { &X, &done, 0, 0 };
+            bslmt::ThreadUtil::Handle handle;
+            ASSERT(0 == bslmt::ThreadUtil::create(&handle,
+                                                  bsl::ref(reader)));
+
+            bslma::Allocator *allocator = mX.allocator(Obj::e_Stacks);
+            for (int i = 0; i < 100000; ++i) {
+                void *a = allocator->allocate(1024);
+                void *b = allocator->allocate(2048);
+                allocator->deallocate(a);
+                allocator->deallocate(b);
+            }
+            done.store(true);
+            ASSERT(0 == bslmt::ThreadUtil::join(handle));
+
+            ASSERTV(reader.d_numErrors, 0 == reader.d_numErrors);
+            if (verbose) {
+                P(reader.d_numReads);
+            }
+
+            const MemoryStats stats = X.totalStats();
+            ASSERT(0 == stats.d_numBytesInUse);
+            ASSERT(3072 == stats.d_peakNumBytesInUse);
+            ASSERT(200000 == stats.d_numAllocations);
+            ASSERT(200000 == stats.d_numDeallocations);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "limit" << endl
+                          << "=====" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            Obj mX(&ta);  const Obj& X = mX;
+            ASSERT(0 == X.limit());
+            ASSERT(!X.isLimitEnforced());
+
+            bslma::Allocator *globals = mX.allocator(Obj::e_Globals);
+            bslma::Allocator *stacks  = mX.allocator(Obj::e_Stacks);
+
+            mX.setLimit(1000);
+            ASSERT(1000 == X.limit());
+
+            // The limit is not enforced by default: memory is counted
+            // against it but never refused.
+
+            void *a = globals->allocate(800);
+            ASSERT(0 != a);
+            void *b = stacks->allocate(400);
+            ASSERT(0 != b);
+            ASSERT(1200 == X.totalStats().d_numBytesInUse);
+            stacks->deallocate(b);
+
+            // Once enforced, the total, across categories, is limited.
+
+            mX.setLimitEnforced(true);
+            ASSERT(X.isLimitEnforced());
+            b = stacks->allocate(200);
+            ASSERT(0 != b);
+            ASSERT(1000 == X.totalStats().d_numBytesInUse);
+
+            bool refused = false;
+            try {
+                stacks->allocate(1);
+            }
+            catch (const bsl::bad_alloc&) {
+                refused = true;
+            }
+            ASSERT(refused);
+            ASSERT(1 == X.numRefusals());
+
+            // A refused allocation is not counted.
+
+            MemoryStats stats = X.stats(Obj::e_Stacks);
+            ASSERT(200 == stats.d_numBytesInUse);
+            ASSERT(2 == stats.d_numAllocations);
+
+            // Freeing memory makes room again.
+
+            stacks->deallocate(b);
+            b = stacks->allocate(150);
+            ASSERT(0 != b);
+
+            // Removing the limit allows any allocation.
+
+            mX.setLimit(0);
+            void *c = stacks->allocate(10000);
+            ASSERT(0 != c);
+            ASSERT(1 == X.numRefusals());
+
+            mX.setLimitEnforced(false);
+            globals->deallocate(a);
+            stacks->deallocate(b);
+            stacks->deallocate(c);
+            ASSERT(0 == X.totalStats().d_numBytesInUse);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            Obj mX(&ta);  const Obj& X = mX;
+
+            for (int i = 0; i < Obj::k_NUM_CATEGORIES; ++i) {
+                const MemoryStats stats =
+                                    X.stats(static_cast<Obj::Category>(i));
+                ASSERTV(i, 0 == stats.d_numBytesInUse);
+                ASSERTV(i, 0 == stats.d_peakNumBytesInUse);
+                ASSERTV(i, 0 == stats.d_numAllocations);
+                ASSERTV(i, 0 == stats.d_numDeallocations);
+            }
+            ASSERT(0 == X.numRefusals());
+
+            bslma::Allocator *heap  = mX.allocator(Obj::e_Heap);
+            bslma::Allocator *other = mX.allocator(Obj::e_Other);
+            ASSERT(heap != other);
+
+            void *a = heap->allocate(100);
+            void *b = heap->allocate(28);
+            void *c = other->allocate(13);
+            ASSERT(0 == reinterpret_cast<bsls::Types::UintPtr>(a) % 16);
+            ASSERT(0 == reinterpret_cast<bsls::Types::UintPtr>(c) % 16);
+            ASSERT(ta.numBytesInUse() > 141);
+
+            MemoryStats stats = X.stats(Obj::e_Heap);
+            ASSERT(128 == stats.d_numBytesInUse);
+            ASSERT(128 == stats.d_peakNumBytesInUse);
+            ASSERT(2   == stats.d_numAllocations);
+            ASSERT(0   == stats.d_numDeallocations);
+
+            heap->deallocate(a);
+            stats = X.stats(Obj::e_Heap);
+            ASSERT(28  == stats.d_numBytesInUse);
+            ASSERT(128 == stats.d_peakNumBytesInUse);
+            ASSERT(1   == stats.d_numDeallocations);
+
+            stats = X.totalStats();
+            ASSERT(41  == stats.d_numBytesInUse);
+            ASSERT(141 == stats.d_peakNumBytesInUse);
+            ASSERT(3   == stats.d_numAllocations);
+            ASSERT(1   == stats.d_numDeallocations);
+
+            ASSERT(0 == X.stats(Obj::e_Globals).d_numAllocations);
+
+            // Allocating nothing and deallocating 0 are not counted.
+
+            ASSERT(0 == heap->allocate(0));
+            heap->deallocate(0);
+            ASSERT(3 == X.totalStats().d_numAllocations);
+            ASSERT(1 == X.totalStats().d_numDeallocations);
+
+            heap->deallocate(b);
+            other->deallocate(c);
+            ASSERT(0 == X.totalStats().d_numBytesInUse);
+            ASSERT(0 == ta.numBytesInUse());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,96 @@
+// sjtt_object.cpp
+#include <sjtt_object.h>
+
+#include <bslma_allocator.h>
+
+#include <bsl_algorithm.h>
+
+namespace sjtt {
+
+namespace {
+
+enum {
+    k_INITIAL_CAPACITY = 4  // slots allocated for the first property
+};
+
+}  // close unnamed namespace
+
+                                // ------------
+                                // class Object
+                                // ------------
+
+// PRIVATE CREATORS
+Object::Object(const Shape *shape)
+: d_shapeId(shape->id())
+, d_shape_p(shape)
+, d_slots_p(0)
+, d_capacity(0)
+{
+    BSLS_ASSERT(0 == shape->numSlots());
+}
+
+// CLASS METHODS
+Object *Object::create(const Shape *root, Allocator *allocator)
+{
+    BSLS_ASSERT(0 != root);
+    BSLS_ASSERT(0 != allocator);
+
+    return new (*allocator) Object(root);
+}
+
+void Object::destroy(Object *object, Allocator *allocator)
+{
+    BSLS_ASSERT(0 != object);
+    BSLS_ASSERT(0 != allocator);
+
+    allocator->deallocate(object->d_slots_p);
+    allocator->deallocate(object);
+}
+
+// MANIPULATORS
+void Object::addProperty(const Shape  *shape,
+                         const Datum&  value,
+                         Allocator    *allocator)
+{
+    BSLS_ASSERT(0 != shape);
+    BSLS_ASSERT(shape->parent() == d_shape_p);
+    BSLS_ASSERT(0 != allocator);
+
+    const int size = numSlots();
+    if (size == d_capacity) {
+        const int capacity = d_capacity ? 2 * d_capacity : k_INITIAL_CAPACITY;
+        Datum *slots = static_cast<Datum *>(
+                             allocator->allocate(capacity * sizeof(Datum)));
+        bsl::copy(d_slots_p, d_slots_p + size, slots);
+        allocator->deallocate(d_slots_p);
+        d_slots_p  = slots;
+        d_capacity = capacity;
+    }
+    d_slots_p[size] = value;
+    d_shape_p       = shape;
+    d_shapeId       = shape->id();
+}
+
+void Object::set(ShapeTable       *shapes,
+                 const StringRef&  name,
+                 const Datum&      value,
+                 Allocator        *allocator)
+{
+    BSLS_ASSERT(0 != shapes);
+
+    const int slot = d_shape_p->findSlot(name);
+    if (0 <= slot) {
+        d_slots_p[slot] = value;
+    }
+    else {
+        addProperty(shapes->addProperty(d_shape_p, name), value, allocator);
+    }
+}
+
+// ACCESSORS
+const BloombergLP::bdld::Datum *Object::find(const StringRef& name) const
+{
+    const int slot = d_shape_p->findSlot(name);
+    return 0 <= slot ? d_slots_p + slot : 0;
+}
+}
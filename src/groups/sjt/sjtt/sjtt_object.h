@@ -0,0 +1,163 @@
+// sjtt_object.h
+
+#ifndef INCLUDED_SJTT_OBJECT
+#define INCLUDED_SJTT_OBJECT
+
+#ifndef INCLUDED_SJTT_SHAPE
+#include <sjtt_shape.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                                // ============
+                                // class Object
+                                // ============
+
+class Object {
+    // This class provides the objects created by scripts: a set of named
+    // properties whose values are held in a flat array of slots, laid out
+    // as described by the 'Shape' of the object, which is shared with every
+    // object having the same properties.  Reading or writing a property
+    // whose slot is known, e.g., from a 'PropertyCache', is therefore a load
+    // or a store into the slot array, once the shape has been checked.
+    //
+    // Objects are temporaries like any other value created by a program:
+    // they are allocated from the allocator of its context, and released
+    // with that allocator, e.g., when an 'ExecutionArena' is reset, or by
+    // 'destroy'.  An object does not own the memory referred to by the
+    // values of its properties.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum       Datum;
+    typedef BloombergLP::bslma::Allocator  Allocator;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+  private:
+    // DATA
+    Shape::Int64  d_shapeId;   // identifier of 'd_shape_p', checked by caches
+    const Shape  *d_shape_p;   // layout of 'd_slots_p' (held)
+    Datum        *d_slots_p;   // value of each property
+    int           d_capacity;  // number of slots allocated
+
+    // PRIVATE CREATORS
+    explicit Object(const Shape *shape);
+        // Create an object having the specified 'shape', which must have no
+        // properties.
+
+    // NOT IMPLEMENTED
+    Object(const Object&);
+    Object& operator=(const Object&);
+
+  public:
+    // CLASS METHODS
+    static Object *create(const Shape *root, Allocator *allocator);
+        // Return a new object having no properties and the specified 'root'
+        // shape, allocated from the specified 'allocator'.  The behavior is
+        // undefined unless 'root' has no slots.
+
+    static void destroy(Object *object, Allocator *allocator);
+        // Release the memory of the specified 'object', which was created
+        // from the specified 'allocator'.
+
+    // MANIPULATORS
+    void addProperty(const Shape  *shape,
+                     const Datum&  value,
+                     Allocator    *allocator);
+        // Move this object to the specified 'shape', storing the specified
+        // 'value' into the new slot, and using the specified 'allocator',
+        // from which this object was created, to grow its slots.  The
+        // behavior is undefined unless 'shape->parent() == this->shape()'.
+
+    void set(ShapeTable       *shapes,
+             const StringRef&  name,
+             const Datum&      value,
+             Allocator        *allocator);
+        // Assign the specified 'value' to the property having the specified
+        // 'name', adding it, with its shape from the specified 'shapes' and
+        // memory from the specified 'allocator', if this object does not
+        // have it.  The behavior is undefined unless 'shapes' owns the shape
+        // of this object and this object was created from 'allocator'.
+
+    void setSlot(int slot, const Datum& value);
+        // Assign the specified 'value' to the property held by the specified
+        // 'slot'.  The behavior is undefined unless
+        // '0 <= slot < numSlots()'.
+
+    // ACCESSORS
+    const Datum *find(const StringRef& name) const;
+        // Return the address of the value of the property having the
+        // specified 'name', or 0 if this object has no such property.
+
+    int numSlots() const;
+        // Return the number of properties of this object.
+
+    const Shape *shape() const;
+        // Return the shape of this object.
+
+    Shape::Int64 shapeId() const;
+        // Return the identifier of the shape of this object.
+
+    const Datum& slot(int slot) const;
+        // Return a reference to the value of the property held by the
+        // specified 'slot'.  The behavior is undefined unless
+        // '0 <= slot < numSlots()'.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                                // ------------
+                                // class Object
+                                // ------------
+
+// MANIPULATORS
+inline
+void Object::setSlot(int slot, const Datum& value) {
+    BSLS_ASSERT_SAFE(0 <= slot);
+    BSLS_ASSERT_SAFE(slot < numSlots());
+    d_slots_p[slot] = value;
+}
+
+// ACCESSORS
+inline
+int Object::numSlots() const {
+    return d_shape_p->numSlots();
+}
+
+inline
+const Shape *Object::shape() const {
+    return d_shape_p;
+}
+
+inline
+Shape::Int64 Object::shapeId() const {
+    return d_shapeId;
+}
+
+inline
+const BloombergLP::bdld::Datum& Object::slot(int slot) const {
+    BSLS_ASSERT_SAFE(0 <= slot);
+    BSLS_ASSERT_SAFE(slot < numSlots());
+    return d_slots_p[slot];
+}
+}
+
+#endif
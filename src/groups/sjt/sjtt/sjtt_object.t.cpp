@@ -0,0 +1,149 @@
+// sjtt_object.t.cpp                                      -*-C++-*-
+
+#include <sjtt_object.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "growth" << endl
+                          << "======" << endl;
+
+        bslma::TestAllocator sa(veryVerbose);
+        bslma::TestAllocator oa(veryVerbose);
+        ShapeTable table(&sa);
+        Object *object = Object::create(table.root(), &oa);
+
+        const char *NAMES[] = { "a", "b", "c", "d", "e", "f", "g", "h", "i" };
+        const int   NUM_NAMES = sizeof NAMES / sizeof *NAMES;
+        for (int i = 0; i < NUM_NAMES; ++i) {
+            object->set(&table, NAMES[i], bdld::Datum::createInteger(i), &oa);
+            ASSERTV(i, i + 1 == object->numSlots());
+        }
+        for (int i = 0; i < NUM_NAMES; ++i) {
+            ASSERTV(i, 0 != object->find(NAMES[i]));
+            ASSERTV(i, i == object->find(NAMES[i])->theInteger());
+            ASSERTV(i, i == object->slot(i).theInteger());
+        }
+
+        // Slots are reallocated as the object grows, and the old ones
+        // released.
+
+        ASSERT(1 < oa.numAllocations());
+        ASSERT(2 == oa.numBlocksInUse());
+        Object::destroy(object, &oa);
+        ASSERT(0 == oa.numBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        ShapeTable table(&ta);
+        Object *a = Object::create(table.root(), &ta);
+        Object *b = Object::create(table.root(), &ta);
+        ASSERT(0 == a->numSlots());
+        ASSERT(table.root() == a->shape());
+        ASSERT(table.root()->id() == a->shapeId());
+        ASSERT(0 == a->find("x"));
+
+        a->set(&table, "x", bdld::Datum::createDouble(1), &ta);
+        a->set(&table, "y", bdld::Datum::createDouble(2), &ta);
+        ASSERT(2 == a->numSlots());
+        ASSERT(a->shape()->id() == a->shapeId());
+        ASSERT(1 == a->find("x")->theDouble());
+        ASSERT(2 == a->find("y")->theDouble());
+        ASSERT(0 == a->find("z"));
+
+        a->set(&table, "x", bdld::Datum::createDouble(3), &ta);
+        ASSERT(2 == a->numSlots());
+        ASSERT(3 == a->slot(a->shape()->findSlot("x")).theDouble());
+
+        // Objects built alike share a shape.
+
+        const Shape *x = table.addProperty(table.root(), "x");
+        b->addProperty(x, bdld::Datum::createDouble(4), &ta);
+        b->set(&table, "y", bdld::Datum::createDouble(5), &ta);
+        ASSERT(a->shape() == b->shape());
+        ASSERT(a->shapeId() == b->shapeId());
+
+        b->setSlot(1, bdld::Datum::createDouble(6));
+        ASSERT(6 == b->find("y")->theDouble());
+        ASSERT(2 == a->find("y")->theDouble());
+
+        Object::destroy(a, &ta);
+        Object::destroy(b, &ta);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,161 @@
+// sjtt_program.cpp
+#include <sjtt_program.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_cstring.h>
+
+namespace sjtt {
+using BloombergLP::bdld::Datum;
+using BloombergLP::bsls::Types;
+
+namespace {
+
+enum ScalarKind {
+    // Enumeration used to discriminate between the kinds of constants that
+    // are shared within the constant pool of a program.
+
+    e_Double = 1,
+    e_Integer,
+    e_Boolean,
+    e_Null,
+    e_Udt
+};
+
+bool scalarKey(Types::Uint64 *kind, Types::Uint64 *payload, const Datum& value)
+    // Load into the specified 'kind' and 'payload' a representation of the
+    // specified 'value' that is equal for two values if and only if they can
+    // share a slot in a constant pool.  Return 'true' on success, and 'false'
+    // (with no effect on 'kind' and 'payload') if 'value' is never shared.
+{
+    if (value.isDouble()) {
+        const double d = value.theDouble();
+        bsl::memcpy(payload, &d, sizeof d);
+        *kind = e_Double;
+    }
+    else if (value.isInteger()) {
+        *payload = static_cast<unsigned int>(value.theInteger());
+        *kind    = e_Integer;
+    }
+    else if (value.isBoolean()) {
+        *payload = value.theBoolean();
+        *kind    = e_Boolean;
+    }
+    else if (value.isNull()) {
+        *payload = 0;
+        *kind    = e_Null;
+    }
+    else if (value.isUdt()) {
+        const unsigned int type = value.theUdt().type();
+        *payload = reinterpret_cast<Types::Uint64>(value.theUdt().data());
+        *kind    = static_cast<Types::Uint64>(type) << 8 | e_Udt;
+    }
+    else {
+        return false;                                                 // RETURN
+    }
+    return true;
+}
+
+}  // close unnamed namespace
+
+                               // -------------
+                               // class Program
+                               // -------------
+
+// ACCESSORS
+Bytecode Program::instruction(bsl::size_t index) const {
+    const Bytecode::Opcode code = opcode(index);
+    if (Bytecode::hasData(code)) {
+        return Bytecode::create(code, d_constants[d_operands[index]]);
+                                                                      // RETURN
+    }
+    return Bytecode::createOpcode(code);
+}
+
+                            // --------------------
+                            // class ProgramBuilder
+                            // --------------------
+
+// PRIVATE MANIPULATORS
+int ProgramBuilder::addConstant(Program::Operand *index, const Datum& value) {
+    Types::Uint64 kind    = 0;
+    Types::Uint64 payload = 0;
+    const bool    shared  = scalarKey(&kind, &payload, value);
+    if (shared) {
+        bsl::map<ScalarKey, Program::Operand>::const_iterator it =
+                                    d_scalars.find(ScalarKey(kind, payload));
+        if (d_scalars.end() != it) {
+            *index = it->second;
+            return 0;                                                 // RETURN
+        }
+    }
+    const bsl::size_t next = d_program.d_constants.size();
+    if (Program::k_MAX_CONSTANTS <= next) {
+        return 1;                                                     // RETURN
+    }
+    *index = static_cast<Program::Operand>(next);
+    d_program.d_constants.push_back(value);
+    if (shared) {
+        d_scalars[ScalarKey(kind, payload)] = *index;
+    }
+    return 0;
+}
+
+// CREATORS
+ProgramBuilder::ProgramBuilder(Allocator *basicAllocator)
+: d_program(basicAllocator)
+, d_scalars(basicAllocator) {
+}
+
+// MANIPULATORS
+int ProgramBuilder::append(const Bytecode& code) {
+    Program::Operand operand = 0;
+    if (Bytecode::hasData(code.opcode())) {
+        if (0 != addConstant(&operand, code.data())) {
+            return 1;                                                 // RETURN
+        }
+    }
+    d_program.d_opcodes.push_back(
+                               static_cast<Program::OpcodeType>(code.opcode()));
+    d_program.d_operands.push_back(operand);
+    return 0;
+}
+
+int ProgramBuilder::append(const Bytecode *code, bsl::size_t numCodes) {
+    BSLS_ASSERT(0 != code || 0 == numCodes);
+    d_program.d_opcodes.reserve(d_program.d_opcodes.size() + numCodes);
+    d_program.d_operands.reserve(d_program.d_operands.size() + numCodes);
+    for (bsl::size_t i = 0; i < numCodes; ++i) {
+        if (0 != append(code[i])) {
+            return 1;                                                 // RETURN
+        }
+    }
+    return 0;
+}
+
+void ProgramBuilder::build(Program *result) {
+    BSLS_ASSERT(0 != result);
+    Program empty(d_program.allocator());
+    result->swap(d_program);
+    d_program.swap(empty);
+    d_scalars.clear();
+}
+}
+
+// FREE OPERATORS
+bool sjtt::operator==(const Program& lhs, const Program& rhs) {
+    if (lhs.numInstructions() != rhs.numInstructions()
+     || lhs.numConstants()    != rhs.numConstants()) {
+        return false;                                                 // RETURN
+    }
+    const bsl::size_t n = lhs.numInstructions();
+    return 0 == n
+        || (0 == bsl::memcmp(lhs.opcodes(),
+                             rhs.opcodes(),
+                             n * sizeof(Program::OpcodeType))
+         && 0 == bsl::memcmp(lhs.operands(),
+                             rhs.operands(),
+                             n * sizeof(Program::Operand))
+         && bsl::equal(lhs.constants(),
+                       lhs.constants() + lhs.numConstants(),
+                       rhs.constants()));
+}
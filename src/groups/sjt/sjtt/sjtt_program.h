@@ -0,0 +1,314 @@
+// sjtt_program.h
+
+#ifndef INCLUDED_SJTT_PROGRAM
+#define INCLUDED_SJTT_PROGRAM
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_MAP
+#include <bsl_map.h>
+#endif
+
+#ifndef INCLUDED_BSL_UTILITY
+#include <bsl_utility.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                               // =============
+                               // class Program
+                               // =============
+
+class Program {
+    // This class is an in-core, value-semantic type holding a sequence of
+    // operations in a packed, structure-of-arrays form.  Each instruction is
+    // represented by one byte of opcode and a parallel 16-bit operand; the
+    // operand of an opcode that has data (see 'Bytecode::hasData') is the
+    // index of that data in a per-program pool of constants, in which each
+    // distinct value is stored once.  Note that, like 'Bytecode', a 'Program'
+    // does not own memory referred to by its constants.
+
+    friend class ProgramBuilder;
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum       Datum;
+    typedef BloombergLP::bslma::Allocator  Allocator;
+    typedef unsigned char                  OpcodeType;
+    typedef unsigned short                 Operand;
+
+    enum {
+        k_MAX_CONSTANTS = 65536  // maximum number of constants in a program
+    };
+
+  private:
+    // DATA
+    bsl::vector<OpcodeType> d_opcodes;     // opcode of each instruction
+    bsl::vector<Operand>    d_operands;    // operand of each instruction
+    bsl::vector<Datum>      d_constants;   // values referred to by operands
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(Program,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CREATORS
+    explicit Program(Allocator *basicAllocator = 0);
+        // Create an empty program.  Optionally specify a 'basicAllocator'
+        // used to supply memory.  If 'basicAllocator' is 0, the currently
+        // installed default allocator is used.
+
+    Program(const Program& original, Allocator *basicAllocator = 0);
+        // Create a program having the value of the specified 'original'.
+        // Optionally specify a 'basicAllocator' used to supply memory.  If
+        // 'basicAllocator' is 0, the currently installed default allocator is
+        // used.
+
+    //! ~Program() = default;
+        // Destroy this object.
+
+    // MANIPULATORS
+    //! Program& operator=(const Program& rhs) = default;
+        // Assign to this object the value of the specified 'rhs' object, and
+        // return a reference to this object.
+
+    void swap(Program& other);
+        // Efficiently exchange the value of this object with the value of the
+        // specified 'other' object.  The behavior is undefined unless this
+        // object and 'other' use the same allocator.
+
+    // ACCESSORS
+    const OpcodeType *opcodes() const;
+        // Return the address of the opcode of the first instruction, or 0 if
+        // this program is empty.
+
+    const Operand *operands() const;
+        // Return the address of the operand of the first instruction, or 0 if
+        // this program is empty.
+
+    const Datum *constants() const;
+        // Return the address of the first constant, or 0 if this program has
+        // no constants.
+
+    bsl::size_t numInstructions() const;
+        // Return the number of instructions in this program.
+
+    bsl::size_t numConstants() const;
+        // Return the number of distinct constants in this program.
+
+    Bytecode::Opcode opcode(bsl::size_t index) const;
+        // Return the opcode of the instruction at the specified 'index'.  The
+        // behavior is undefined unless 'index < numInstructions()'.
+
+    Operand operand(bsl::size_t index) const;
+        // Return the operand of the instruction at the specified 'index'.  The
+        // behavior is undefined unless 'index < numInstructions()'.
+
+    const Datum& constant(bsl::size_t index) const;
+        // Return a reference to the constant at the specified 'index'.  The
+        // behavior is undefined unless 'index < numConstants()'.
+
+    Bytecode instruction(bsl::size_t index) const;
+        // Return the 'Bytecode' equivalent to the instruction at the specified
+        // 'index'.  The behavior is undefined unless
+        // 'index < numInstructions()'.
+
+    Allocator *allocator() const;
+        // Return the allocator used by this object to supply memory.
+};
+
+                            // ====================
+                            // class ProgramBuilder
+                            // ====================
+
+class ProgramBuilder {
+    // This class provides a mechanism for converting sequences of 'Bytecode'
+    // objects to a 'Program'.  Equal constants are stored once; doubles are
+    // compared by their representation, so that, e.g., '0.0' and '-0.0' are
+    // kept distinct.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum       Datum;
+    typedef BloombergLP::bslma::Allocator  Allocator;
+
+  private:
+    // PRIVATE TYPES
+    typedef bsl::pair<BloombergLP::bsls::Types::Uint64,
+                      BloombergLP::bsls::Types::Uint64> ScalarKey;
+
+    // DATA
+    Program                              d_program;  // program being built
+    bsl::map<ScalarKey, Program::Operand> d_scalars;  // pool index of each
+                                                     // scalar constant
+
+    // NOT IMPLEMENTED
+    ProgramBuilder(const ProgramBuilder&);
+    ProgramBuilder& operator=(const ProgramBuilder&);
+
+    // PRIVATE MANIPULATORS
+    int addConstant(Program::Operand *index, const Datum& value);
+        // Load into the specified 'index' the position of the specified
+        // 'value' in the constant pool, adding it if necessary.  Return 0 on
+        // success, and a non-zero value if the pool is full.
+
+  public:
+    // CREATORS
+    explicit ProgramBuilder(Allocator *basicAllocator = 0);
+        // Create a builder for an initially empty program.  Optionally specify
+        // a 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.
+
+    // MANIPULATORS
+    int append(const Bytecode& code);
+        // Append the specified 'code' to the program being built.  Return 0
+        // on success, and a non-zero value, with no effect, if the program
+        // already holds 'Program::k_MAX_CONSTANTS' constants and 'code'
+        // requires a new one.
+
+    int append(const Bytecode *code, bsl::size_t numCodes);
+        // Append the specified 'numCodes' instructions starting at the
+        // specified 'code' to the program being built.  Return 0 on success,
+        // and a non-zero value if the constant pool overflows, in which case
+        // the instructions before the one that failed have been appended.
+
+    void build(Program *result);
+        // Load the program being built into the specified 'result', and reset
+        // this builder to build an empty program.  The behavior is undefined
+        // unless 'result' uses the same allocator as this builder.
+
+    // ACCESSORS
+    const Program& program() const;
+        // Return a reference to the program being built.
+};
+
+// FREE OPERATORS
+bool operator==(const Program& lhs, const Program& rhs);
+    // Return 'true' if the specified 'lhs' and 'rhs' have the same
+    // instructions and constants, and 'false' otherwise.
+
+bool operator!=(const Program& lhs, const Program& rhs);
+    // Return 'true' if the specified 'lhs' and 'rhs' do not have the same
+    // value, and 'false' otherwise.
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                               // -------------
+                               // class Program
+                               // -------------
+
+// CREATORS
+inline
+Program::Program(Allocator *basicAllocator)
+: d_opcodes(basicAllocator)
+, d_operands(basicAllocator)
+, d_constants(basicAllocator) {
+}
+
+inline
+Program::Program(const Program& original, Allocator *basicAllocator)
+: d_opcodes(original.d_opcodes, basicAllocator)
+, d_operands(original.d_operands, basicAllocator)
+, d_constants(original.d_constants, basicAllocator) {
+}
+
+// MANIPULATORS
+inline
+void Program::swap(Program& other) {
+    BSLS_ASSERT(allocator() == other.allocator());
+    d_opcodes.swap(other.d_opcodes);
+    d_operands.swap(other.d_operands);
+    d_constants.swap(other.d_constants);
+}
+
+// ACCESSORS
+inline
+const Program::OpcodeType *Program::opcodes() const {
+    return d_opcodes.empty() ? 0 : d_opcodes.data();
+}
+
+inline
+const Program::Operand *Program::operands() const {
+    return d_operands.empty() ? 0 : d_operands.data();
+}
+
+inline
+const BloombergLP::bdld::Datum *Program::constants() const {
+    return d_constants.empty() ? 0 : d_constants.data();
+}
+
+inline
+bsl::size_t Program::numInstructions() const {
+    return d_opcodes.size();
+}
+
+inline
+bsl::size_t Program::numConstants() const {
+    return d_constants.size();
+}
+
+inline
+Bytecode::Opcode Program::opcode(bsl::size_t index) const {
+    BSLS_ASSERT_SAFE(index < d_opcodes.size());
+    return static_cast<Bytecode::Opcode>(d_opcodes[index]);
+}
+
+inline
+Program::Operand Program::operand(bsl::size_t index) const {
+    BSLS_ASSERT_SAFE(index < d_operands.size());
+    return d_operands[index];
+}
+
+inline
+const BloombergLP::bdld::Datum& Program::constant(bsl::size_t index) const {
+    BSLS_ASSERT_SAFE(index < d_constants.size());
+    return d_constants[index];
+}
+
+inline
+BloombergLP::bslma::Allocator *Program::allocator() const {
+    return d_opcodes.get_allocator().mechanism();
+}
+
+                            // --------------------
+                            // class ProgramBuilder
+                            // --------------------
+
+// ACCESSORS
+inline
+const Program& ProgramBuilder::program() const {
+    return d_program;
+}
+}
+
+// FREE OPERATORS
+inline
+bool sjtt::operator!=(const Program& lhs, const Program& rhs) {
+    return !(lhs == rhs);
+}
+
+#endif
@@ -0,0 +1,201 @@
+// sjtt_program.t.cpp                                      -*-C++-*-
+
+#include <sjtt_program.h>
+
+#include <sjtt_bytecode.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_cmath.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "copy, swap and equality" << endl
+                          << "=======================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        const Bytecode code[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        ProgramBuilder builder(&ta);
+        ASSERT(0 == builder.append(code, 2));
+        Program x(&ta);
+        builder.build(&x);
+
+        const Program y(x, &ta);
+        ASSERT(x == y);
+        ASSERT(&ta == y.allocator());
+
+        Program z(&ta);
+        ASSERT(x != z);
+        z.swap(x);
+        ASSERT(y == z);
+        ASSERT(0 == x.numInstructions());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "constant pool overflow" << endl
+                          << "======================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        ProgramBuilder builder(&ta);
+        for (int i = 0; i < Program::k_MAX_CONSTANTS; ++i) {
+            ASSERT(0 == builder.append(
+                        Bytecode::createPush(bdld::Datum::createInteger(i))));
+        }
+        ASSERT(0 != builder.append(
+                Bytecode::createPush(bdld::Datum::createInteger(-1))));
+        ASSERT(0 == builder.append(
+                Bytecode::createPush(bdld::Datum::createInteger(7))));
+        ASSERT(Program::k_MAX_CONSTANTS + 1 ==
+                                        builder.program().numInstructions());
+        ASSERT(Program::k_MAX_CONSTANTS == builder.program().numConstants());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "constant sharing" << endl
+                          << "================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        const double NEG_ZERO = -0.0;
+        const Bytecode code[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(0)),
+            Bytecode::createPush(bdld::Datum::createDouble(NEG_ZERO)),
+            Bytecode::createPush(bdld::Datum::createDouble(0)),
+            Bytecode::createPush(bdld::Datum::createInteger(0)),
+            Bytecode::createPush(bdld::Datum::createBoolean(false)),
+            Bytecode::createPush(bdld::Datum::createNull()),
+            Bytecode::createPush(bdld::Datum::createNull()),
+            Bytecode::createPush(bdld::Datum::createUdt(0, 1)),
+            Bytecode::createPush(bdld::Datum::createUdt(0, 2)),
+            Bytecode::createPush(bdld::Datum::createUdt(0, 1)),
+        };
+        const bsl::size_t NUM_CODES = sizeof code / sizeof *code;
+
+        ProgramBuilder builder(&ta);
+        ASSERT(0 == builder.append(code, NUM_CODES));
+        Program program(&ta);
+        builder.build(&program);
+
+        ASSERT(NUM_CODES == program.numInstructions());
+        ASSERTV(program.numConstants(), 7 == program.numConstants());
+        ASSERT(program.operand(0) == program.operand(2));
+        ASSERT(program.operand(0) != program.operand(1));
+        ASSERT(program.operand(5) == program.operand(6));
+        ASSERT(program.operand(7) == program.operand(9));
+        ASSERT(program.operand(7) != program.operand(8));
+        ASSERT(bsl::signbit(program.instruction(1).data().theDouble()));
+
+        ASSERT(0 == builder.program().numInstructions());
+        ASSERT(0 == builder.program().numConstants());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        const Bytecode code[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createPush(bdld::Datum::createDouble(2)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        const bsl::size_t NUM_CODES = sizeof code / sizeof *code;
+
+        ProgramBuilder builder(&ta);
+        ASSERT(0 == builder.append(code, NUM_CODES));
+        Program program(&ta);
+        builder.build(&program);
+
+        ASSERT(NUM_CODES == program.numInstructions());
+        ASSERT(2 == program.numConstants());
+        for (bsl::size_t i = 0; i < NUM_CODES; ++i) {
+            const Bytecode instruction = program.instruction(i);
+            ASSERTV(i, code[i].opcode() == instruction.opcode());
+            ASSERTV(i, code[i].opcode() == program.opcode(i));
+            if (Bytecode::e_Push == code[i].opcode()) {
+                ASSERTV(i, code[i].data() == instruction.data());
+            }
+        }
+        ASSERT(program.operand(0) == program.operand(3));
+        ASSERT(sizeof(Program::OpcodeType) + sizeof(Program::Operand) <
+                                                            sizeof(Bytecode));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
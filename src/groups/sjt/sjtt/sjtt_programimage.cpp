@@ -0,0 +1,452 @@
+// sjtt_programimage.cpp
+#include <sjtt_programimage.h>
+
+#include <sjtt_imageutil.h>
+
+#include <bslma_default.h>
+#include <bslmf_assert.h>
+#include <bsls_platform.h>
+#include <bsls_types.h>
+
+#include <bsl_cstddef.h>
+#include <bsl_cstring.h>
+
+namespace sjtt {
+using BloombergLP::bdld::Datum;
+using BloombergLP::bsls::Types;
+
+namespace {
+
+enum ConstantType {
+    // Enumeration used to tag the constants of an image.
+
+    e_Null,
+    e_Double,
+    e_Integer,
+    e_Boolean,
+    e_String
+};
+
+struct Header {
+    // This 'struct' describes the header at the start of an image.
+
+    char           d_magic[4];         // "SJTB"
+    unsigned short d_version;          // 'ProgramImage::k_VERSION'
+    unsigned short d_reserved;         // 0
+    unsigned int   d_numInstructions;  // length of opcodes and operands
+    unsigned int   d_numConstants;     // number of constant records
+    unsigned int   d_opcodesOffset;    // offsets from the start of the image
+    unsigned int   d_operandsOffset;
+    unsigned int   d_constantsOffset;
+    unsigned int   d_stringsOffset;
+    unsigned int   d_size;             // size of the whole image
+    unsigned int   d_checksum;         // CRC-32 of all other bytes
+};
+
+struct Constant {
+    // This 'struct' describes the record of a constant in an image.
+
+    unsigned int  d_type;     // 'ConstantType'
+    unsigned int  d_length;   // length of a string, and 0 otherwise
+    Types::Uint64 d_payload;  // value, or offset of a string in its section
+};
+
+BSLMF_ASSERT(40 == sizeof(Header));
+BSLMF_ASSERT(16 == sizeof(Constant));
+
+const char k_MAGIC[4] = { 'S', 'J', 'T', 'B' };
+
+bsl::size_t alignUp(bsl::size_t offset, bsl::size_t alignment)
+    // Return the smallest multiple of the specified 'alignment' that is not
+    // less than the specified 'offset'.
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+unsigned int checksum(const char *image, bsl::size_t size)
+    // Return the checksum of the specified 'image' of the specified 'size'
+    // bytes, which covers every byte except those of the checksum itself.
+{
+    const bsl::size_t  at  = offsetof(Header, d_checksum);
+    const unsigned int crc = ImageUtil::crc32(image, at);
+    return ImageUtil::crc32(image + sizeof(Header),
+                            size - sizeof(Header),
+                            crc);
+}
+
+bool isTarget(const Datum& offset,
+              bsl::size_t  index,
+              bsl::size_t  numInstructions)
+    // Return 'true' if the specified 'offset' is an integer offset from the
+    // instruction at the specified 'index' to one of the specified
+    // 'numInstructions' instructions of a program, and 'false' otherwise.
+{
+    if (!offset.isInteger()) {
+        return false;                                                 // RETURN
+    }
+    const Types::Int64 target = static_cast<Types::Int64>(index)
+                              + offset.theInteger();
+    return 0 <= target
+        && target < static_cast<Types::Int64>(numInstructions);
+}
+
+bool isRunnable(const ProgramImage::OpcodeType *opcodes,
+                const ProgramImage::Operand    *operands,
+                const bsl::vector<Datum>&       constants,
+                bsl::size_t                     numInstructions,
+                bsl::size_t                     index)
+    // Return 'true' if the instruction at the specified 'index' of the
+    // program having the specified 'numInstructions' 'opcodes' and
+    // 'operands', and the specified 'constants', can be run from an image,
+    // i.e., its opcode does not need data created at run time, its data has
+    // the type the opcode requires, and, if it is a branch or call, it
+    // targets an instruction of the program, an 'e_Function' for a call,
+    // and 'false' otherwise.  The behavior is undefined unless every opcode
+    // is valid and every operand of an opcode having data indexes
+    // 'constants'.
+{
+    const Bytecode::Opcode opcode =
+                                 static_cast<Bytecode::Opcode>(opcodes[index]);
+    const Datum           *data   = Bytecode::hasData(opcode)
+                                  ? &constants[operands[index]]
+                                  : 0;
+    switch (opcode) {
+      case Bytecode::e_GetGlobalSlot:
+      case Bytecode::e_SetGlobalSlot: {
+        return data->isInteger() && 0 <= data->theInteger();          // RETURN
+      }
+      case Bytecode::e_NewObject:
+      case Bytecode::e_GetProperty:
+      case Bytecode::e_SetProperty: {
+        // Objects need the shapes of an engine, and property accesses a
+        // cache, which an image cannot hold.
+
+        return false;                                                 // RETURN
+      }
+      case Bytecode::e_AddIntegers:
+      case Bytecode::e_SubtractIntegers:
+      case Bytecode::e_MultiplyIntegers:
+      case Bytecode::e_LessIntegers: {
+        // The data of these opcodes is the 'TypeFeedback' they record into.
+
+        return false;                                                 // RETURN
+      }
+      case Bytecode::e_Jump:
+      case Bytecode::e_JumpIfFalse: {
+        return isTarget(*data, index, numInstructions);               // RETURN
+      }
+      case Bytecode::e_LoopHeader:
+      case Bytecode::e_Loop: {
+        // The data of a header is the 'LoopCounter' of its loop, which
+        // 'e_Loop' increments, so loops cannot be stored.
+
+        return false;                                                 // RETURN
+      }
+      case Bytecode::e_Function: {
+        return data->isInteger() && 0 <= data->theInteger();          // RETURN
+      }
+      case Bytecode::e_Call:
+      case Bytecode::e_TailCall: {
+        if (!isTarget(*data, index, numInstructions)) {
+            return false;                                             // RETURN
+        }
+        const bsl::size_t target = index + data->theInteger();
+        return Bytecode::e_Function == opcodes[target]
+            && isRunnable(opcodes,
+                          operands,
+                          constants,
+                          numInstructions,
+                          target);                                    // RETURN
+      }
+      case Bytecode::e_GetLocal:
+      case Bytecode::e_SetLocal: {
+        return data->isInteger();                                     // RETURN
+      }
+      default: {
+        return true;                                                  // RETURN
+      }
+    }
+}
+
+}  // close unnamed namespace
+
+                            // ------------------
+                            // class ProgramImage
+                            // ------------------
+
+// CLASS METHODS
+int ProgramImage::encode(bsl::vector<char> *result, const Program& program)
+{
+    BSLS_ASSERT(0 != result);
+
+    const bsl::size_t numInstructions = program.numInstructions();
+    const bsl::size_t numConstants    = program.numConstants();
+
+    bsl::size_t stringsLength = 0;
+    for (bsl::size_t i = 0; i < numConstants; ++i) {
+        const Datum& value = program.constant(i);
+        if (value.isString()) {
+            stringsLength += value.theString().length();
+        }
+        else if (!value.isNull()
+              && !value.isDouble()
+              && !value.isInteger()
+              && !value.isBoolean()) {
+            return 1;                                                 // RETURN
+        }
+    }
+
+    Header header;
+    bsl::memcpy(header.d_magic, k_MAGIC, sizeof k_MAGIC);
+    header.d_version         = k_VERSION;
+    header.d_reserved        = 0;
+    header.d_numInstructions = static_cast<unsigned int>(numInstructions);
+    header.d_numConstants    = static_cast<unsigned int>(numConstants);
+
+    bsl::size_t offset = sizeof header;
+    header.d_opcodesOffset   = static_cast<unsigned int>(offset);
+    offset = alignUp(offset + numInstructions, sizeof(Operand));
+    header.d_operandsOffset  = static_cast<unsigned int>(offset);
+    offset = alignUp(offset + numInstructions * sizeof(Operand),
+                     k_ALIGNMENT);
+    header.d_constantsOffset = static_cast<unsigned int>(offset);
+    offset += numConstants * sizeof(Constant);
+    header.d_stringsOffset   = static_cast<unsigned int>(offset);
+    offset += stringsLength;
+    header.d_size            = static_cast<unsigned int>(offset);
+    header.d_checksum        = 0;
+
+    bsl::vector<char> image(offset, 0, result->get_allocator());
+    char *data = image.data();
+    if (numInstructions) {
+        bsl::memcpy(data + header.d_opcodesOffset,
+                    program.opcodes(),
+                    numInstructions);
+        bsl::memcpy(data + header.d_operandsOffset,
+                    program.operands(),
+                    numInstructions * sizeof(Operand));
+    }
+
+    bsl::size_t stringOffset = 0;
+    for (bsl::size_t i = 0; i < numConstants; ++i) {
+        const Datum& value = program.constant(i);
+        Constant     record = { e_Null, 0, 0 };
+        if (value.isDouble()) {
+            const double d = value.theDouble();
+            record.d_type = e_Double;
+            bsl::memcpy(&record.d_payload, &d, sizeof d);
+        }
+        else if (value.isInteger()) {
+            record.d_type    = e_Integer;
+            record.d_payload = static_cast<unsigned int>(value.theInteger());
+        }
+        else if (value.isBoolean()) {
+            record.d_type    = e_Boolean;
+            record.d_payload = value.theBoolean();
+        }
+        else if (value.isString()) {
+            const BloombergLP::bslstl::StringRef string = value.theString();
+            record.d_type    = e_String;
+            record.d_length  = static_cast<unsigned int>(string.length());
+            record.d_payload = stringOffset;
+            bsl::memcpy(data + header.d_stringsOffset + stringOffset,
+                        string.data(),
+                        string.length());
+            stringOffset += string.length();
+        }
+        bsl::memcpy(data + header.d_constantsOffset + i * sizeof record,
+                    &record,
+                    sizeof record);
+    }
+
+    bsl::memcpy(data, &header, sizeof header);
+    header.d_checksum = checksum(data, image.size());
+    bsl::memcpy(data, &header, sizeof header);
+
+    result->swap(image);
+    return 0;
+}
+
+// CREATORS
+ProgramImage::ProgramImage(Allocator *basicAllocator)
+: d_opcodes_p(0)
+, d_operands_p(0)
+, d_numInstructions(0)
+, d_constants(basicAllocator)
+, d_mapping_p(0)
+, d_mappingSize(0)
+, d_allocator_p(BloombergLP::bslma::Default::allocator(basicAllocator))
+{
+}
+
+ProgramImage::~ProgramImage()
+{
+    reset();
+}
+
+// MANIPULATORS
+int ProgramImage::load(const char *image, bsl::size_t size)
+{
+    BSLS_ASSERT(0 != image || 0 == size);
+
+    reset();
+#ifdef BSLS_PLATFORM_IS_BIG_ENDIAN
+    return e_Malformed;                                               // RETURN
+#endif
+    if (0 != reinterpret_cast<Types::UintPtr>(image) % k_ALIGNMENT) {
+        return e_Misaligned;                                          // RETURN
+    }
+    if (size < sizeof(Header)) {
+        return e_Truncated;                                           // RETURN
+    }
+
+    Header header;
+    bsl::memcpy(&header, image, sizeof header);
+    if (0 != bsl::memcmp(header.d_magic, k_MAGIC, sizeof k_MAGIC)) {
+        return e_BadMagic;                                            // RETURN
+    }
+    if (k_VERSION != header.d_version) {
+        return e_BadVersion;                                          // RETURN
+    }
+    if (size < header.d_size || header.d_size < sizeof header) {
+        return e_Truncated;                                           // RETURN
+    }
+    if (checksum(image, header.d_size) != header.d_checksum) {
+        return e_BadChecksum;                                         // RETURN
+    }
+
+    // Check that the sections are in order, aligned, and within the image.
+    // The arithmetic is done on 64 bits so that it cannot overflow.
+
+    const Types::Uint64 numInstructions = header.d_numInstructions;
+    const Types::Uint64 numConstants    = header.d_numConstants;
+    if (sizeof header != header.d_opcodesOffset
+     || header.d_opcodesOffset + numInstructions > header.d_operandsOffset
+     || 0 != header.d_operandsOffset % sizeof(Operand)
+     || header.d_operandsOffset + numInstructions * sizeof(Operand)
+                                                 > header.d_constantsOffset
+     || 0 != header.d_constantsOffset % k_ALIGNMENT
+     || header.d_constantsOffset + numConstants * sizeof(Constant)
+                                                   > header.d_stringsOffset
+     || header.d_stringsOffset > header.d_size
+     || Program::k_MAX_CONSTANTS < numConstants) {
+        return e_Malformed;                                           // RETURN
+    }
+
+    const OpcodeType *opcodes  = reinterpret_cast<const OpcodeType *>(
+                                            image + header.d_opcodesOffset);
+    const Operand    *operands = reinterpret_cast<const Operand *>(
+                                           image + header.d_operandsOffset);
+    for (bsl::size_t i = 0; i < numInstructions; ++i) {
+        if (Bytecode::k_NUM_OPCODES <= opcodes[i]) {
+            return e_Malformed;                                       // RETURN
+        }
+        if (Bytecode::hasData(static_cast<Bytecode::Opcode>(opcodes[i]))
+         && numConstants <= operands[i]) {
+            return e_Malformed;                                       // RETURN
+        }
+    }
+
+    const char        *strings       = image + header.d_stringsOffset;
+    const Types::Uint64 stringsLength = header.d_size - header.d_stringsOffset;
+    d_constants.reserve(header.d_numConstants);
+    for (bsl::size_t i = 0; i < numConstants; ++i) {
+        Constant record;
+        bsl::memcpy(&record,
+                    image + header.d_constantsOffset + i * sizeof record,
+                    sizeof record);
+        switch (record.d_type) {
+          case e_Null: {
+            d_constants.push_back(Datum::createNull());
+          } break;
+          case e_Double: {
+            double value;
+            bsl::memcpy(&value, &record.d_payload, sizeof value);
+            d_constants.push_back(Datum::createDouble(value));
+          } break;
+          case e_Integer: {
+            const unsigned int value =
+                                static_cast<unsigned int>(record.d_payload);
+            d_constants.push_back(Datum::createInteger(
+                                                static_cast<int>(value)));
+          } break;
+          case e_Boolean: {
+            d_constants.push_back(Datum::createBoolean(0 != record.d_payload));
+          } break;
+          case e_String: {
+            if (record.d_payload > stringsLength
+             || record.d_length > stringsLength - record.d_payload) {
+                reset();
+                return e_Malformed;                                   // RETURN
+            }
+            d_constants.push_back(Datum::createStringRef(
+                                            strings + record.d_payload,
+                                            record.d_length,
+                                            d_allocator_p));
+          } break;
+          default: {
+            reset();
+            return e_Malformed;                                       // RETURN
+          }
+        }
+    }
+
+    for (bsl::size_t i = 0; i < numInstructions; ++i) {
+        if (!isRunnable(opcodes, operands, d_constants, numInstructions, i)) {
+            reset();
+            return e_Malformed;                                       // RETURN
+        }
+    }
+
+    d_opcodes_p       = opcodes;
+    d_operands_p      = operands;
+    d_numInstructions = header.d_numInstructions;
+    return e_Success;
+}
+
+int ProgramImage::mapFile(const char *path)
+{
+    BSLS_ASSERT(0 != path);
+
+    reset();
+    const char  *data;
+    bsl::size_t  size;
+    if (0 != ImageUtil::mapFile(&data, &size, path)) {
+        return e_FileError;                                           // RETURN
+    }
+    const int rc = load(data, size);
+    d_mapping_p   = data;
+    d_mappingSize = size;
+    if (e_Success != rc) {
+        reset();
+    }
+    return rc;
+}
+
+void ProgramImage::reset()
+{
+    for (bsl::size_t i = 0; i < d_constants.size(); ++i) {
+        Datum::destroy(d_constants[i], d_allocator_p);
+    }
+    d_constants.clear();
+    d_opcodes_p       = 0;
+    d_operands_p      = 0;
+    d_numInstructions = 0;
+    if (0 != d_mapping_p) {
+        ImageUtil::unmapFile(d_mapping_p, d_mappingSize);
+    }
+    d_mapping_p   = 0;
+    d_mappingSize = 0;
+}
+
+// ACCESSORS
+Bytecode ProgramImage::instruction(bsl::size_t index) const
+{
+    const Bytecode::Opcode code = opcode(index);
+    if (Bytecode::hasData(code)) {
+        return Bytecode::create(code, d_constants[d_operands_p[index]]);
+                                                                      // RETURN
+    }
+    return Bytecode::createOpcode(code);
+}
+}
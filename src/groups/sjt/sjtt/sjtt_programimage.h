@@ -0,0 +1,255 @@
+// sjtt_programimage.h
+
+#ifndef INCLUDED_SJTT_PROGRAMIMAGE
+#define INCLUDED_SJTT_PROGRAMIMAGE
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+#ifndef INCLUDED_SJTT_PROGRAM
+#include <sjtt_program.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                            // ==================
+                            // class ProgramImage
+                            // ==================
+
+class ProgramImage {
+    // This class provides read-only access, in place, to a 'Program' stored
+    // in a binary image, e.g., a precompiled file mapped into memory, so
+    // that a program can be executed without being deserialized.  The image
+    // is produced by 'encode' and has the following layout, in which all
+    // offsets are relative to the start of the image, so that it may be
+    // mapped at any address, and all integers are little-endian:
+    //..
+    //  header     magic "SJTB", format version, counts, section offsets,
+    //             total size, and a CRC-32 of the rest of the image
+    //  opcodes    one byte per instruction ('Program::OpcodeType')
+    //  operands   two bytes per instruction ('Program::Operand')
+    //  constants  one 16-byte record per constant: a type tag, a length,
+    //             and a 64-bit payload holding a double, an integer, a
+    //             boolean, or the offset of a string
+    //  strings    the bytes of the string constants
+    //..
+    // The opcodes and operands of a loaded image are used directly from the
+    // image.  The constant pool is rebuilt as one 'Datum' per constant
+    // without copying anything: doubles, integers, and booleans are
+    // immediate values, and strings refer to their bytes in the image.  So,
+    // once 'load' has verified the checksum, the cost of starting a program
+    // is that of touching the pages of its image.  The image must remain
+    // valid, and unmodified, while it is loaded.
+    //
+    // 'load' rejects images that are truncated, have the wrong magic number
+    // or version, fail the checksum, or are malformed, i.e., have sections
+    // out of bounds, invalid opcodes, operands that do not index the
+    // constant pool, data of the wrong type for its opcode, e.g., a global
+    // slot that is not a non-negative integer, branches to an offset outside
+    // of the program, calls to an instruction other than an 'e_Function'
+    // having a non-negative number of arguments, or opcodes that cannot be
+    // run from an image:
+    // 'e_NewObject', 'e_GetProperty', and 'e_SetProperty', which need the
+    // shapes of an engine and a property cache, the integer opcodes, e.g.,
+    // 'e_AddIntegers', which need a 'TypeFeedback', and 'e_LoopHeader' and
+    // 'e_Loop', which need a 'LoopCounter'.
+    // A loaded image can therefore be passed to 'sjtu::VerifyUtil' and
+    // 'sjtu::InterpretUtil' like a 'Program'.  Only programs whose constants
+    // are null, doubles, integers, booleans, or strings can be encoded.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum      Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef Program::OpcodeType           OpcodeType;
+    typedef Program::Operand              Operand;
+
+    enum {
+        k_VERSION   = 1,   // format version written by 'encode'
+        k_ALIGNMENT = 8    // required alignment of an image in memory
+    };
+
+    enum Status {
+        // Enumeration used to describe the result of 'load' and 'mapFile'.
+
+        e_Success = 0,
+        e_Truncated,          // the image is shorter than it claims
+        e_BadMagic,           // the image is not a program image
+        e_BadVersion,         // the format version is not supported
+        e_BadChecksum,        // the contents do not match the checksum
+        e_Malformed,          // sections or instructions are invalid
+        e_Misaligned,         // the image is not suitably aligned
+        e_FileError           // the file cannot be opened or mapped
+    };
+
+  private:
+    // DATA
+    const OpcodeType   *d_opcodes_p;        // opcodes in the image
+    const Operand      *d_operands_p;       // operands in the image
+    bsl::size_t         d_numInstructions;  // number of instructions
+    bsl::vector<Datum>  d_constants;        // pool referring to the image
+    const char         *d_mapping_p;        // mapped file, if any
+    bsl::size_t         d_mappingSize;      // size of 'd_mapping_p'
+    Allocator          *d_allocator_p;      // memory allocator (held)
+
+    // NOT IMPLEMENTED
+    ProgramImage(const ProgramImage&);
+    ProgramImage& operator=(const ProgramImage&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(ProgramImage,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CLASS METHODS
+    static int encode(bsl::vector<char> *result, const Program& program);
+        // Load into the specified 'result' the image of the specified
+        // 'program'.  Return 0 on success, and a non-zero value, with no
+        // effect on 'result', if a constant of 'program' is not null, a
+        // double, an integer, a boolean, or a string.
+
+    // CREATORS
+    explicit ProgramImage(Allocator *basicAllocator = 0);
+        // Create an object holding no image.  Optionally specify a
+        // 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.
+
+    ~ProgramImage();
+        // Destroy this object, unmapping its file, if any.
+
+    // MANIPULATORS
+    int load(const char *image, bsl::size_t size);
+        // Verify the specified 'image' of the specified 'size' bytes and
+        // give access to the program it holds, replacing any image held by
+        // this object.  Return 'e_Success' on success, and a non-zero
+        // 'Status' value, leaving this object empty, otherwise.  The behavior
+        // is undefined unless 'image' remains valid and unmodified until this
+        // object is reset, destroyed, or loads another image.
+
+    int mapFile(const char *path);
+        // Map the file at the specified 'path' into memory, read-only, and
+        // load the image it holds as if by 'load', replacing any image held
+        // by this object.  Return 'e_Success' on success, and a non-zero
+        // 'Status' value, leaving this object empty, otherwise.  The
+        // mapping is released when this object is reset, destroyed, or loads
+        // another image.
+
+    void reset();
+        // Release the image held by this object, if any.
+
+    // ACCESSORS
+    const OpcodeType *opcodes() const;
+        // Return the address of the opcode of the first instruction, or 0 if
+        // this object holds no instructions.
+
+    const Operand *operands() const;
+        // Return the address of the operand of the first instruction, or 0 if
+        // this object holds no instructions.
+
+    const Datum *constants() const;
+        // Return the address of the first constant, or 0 if there are none.
+
+    bsl::size_t numInstructions() const;
+        // Return the number of instructions of the program.
+
+    bsl::size_t numConstants() const;
+        // Return the number of constants of the program.
+
+    Bytecode::Opcode opcode(bsl::size_t index) const;
+        // Return the opcode of the instruction at the specified 'index'.  The
+        // behavior is undefined unless 'index < numInstructions()'.
+
+    Operand operand(bsl::size_t index) const;
+        // Return the operand of the instruction at the specified 'index'.  The
+        // behavior is undefined unless 'index < numInstructions()'.
+
+    const Datum& constant(bsl::size_t index) const;
+        // Return a reference to the constant at the specified 'index'.  The
+        // behavior is undefined unless 'index < numConstants()'.
+
+    Bytecode instruction(bsl::size_t index) const;
+        // Return the 'Bytecode' equivalent to the instruction at the specified
+        // 'index'.  The behavior is undefined unless
+        // 'index < numInstructions()'.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                            // ------------------
+                            // class ProgramImage
+                            // ------------------
+
+// ACCESSORS
+inline
+const ProgramImage::OpcodeType *ProgramImage::opcodes() const {
+    return d_numInstructions ? d_opcodes_p : 0;
+}
+
+inline
+const ProgramImage::Operand *ProgramImage::operands() const {
+    return d_numInstructions ? d_operands_p : 0;
+}
+
+inline
+const BloombergLP::bdld::Datum *ProgramImage::constants() const {
+    return d_constants.empty() ? 0 : d_constants.data();
+}
+
+inline
+bsl::size_t ProgramImage::numInstructions() const {
+    return d_numInstructions;
+}
+
+inline
+bsl::size_t ProgramImage::numConstants() const {
+    return d_constants.size();
+}
+
+inline
+Bytecode::Opcode ProgramImage::opcode(bsl::size_t index) const {
+    BSLS_ASSERT_SAFE(index < d_numInstructions);
+    return static_cast<Bytecode::Opcode>(d_opcodes_p[index]);
+}
+
+inline
+ProgramImage::Operand ProgramImage::operand(bsl::size_t index) const {
+    BSLS_ASSERT_SAFE(index < d_numInstructions);
+    return d_operands_p[index];
+}
+
+inline
+const BloombergLP::bdld::Datum&
+ProgramImage::constant(bsl::size_t index) const {
+    BSLS_ASSERT_SAFE(index < d_constants.size());
+    return d_constants[index];
+}
+}
+
+#endif
@@ -0,0 +1,456 @@
+// sjtt_programimage.t.cpp                                 -*-C++-*-
+
+#include <sjtt_programimage.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_program.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_cstdio.h>
+#include <bsl_cstring.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+const bsl::size_t k_CHECKSUM_OFFSET = 36;  // offset of the checksum field
+const bsl::size_t k_HEADER_SIZE     = 40;  // size of the header
+
+unsigned int crc32(const char *data, bsl::size_t length, unsigned int crc)
+    // Return the CRC-32 of the specified 'length' bytes at the specified
+    // 'data', continuing from the specified 'crc'.  This is a bitwise oracle
+    // for the table-driven implementation in the component.
+{
+    crc = ~crc;
+    for (bsl::size_t i = 0; i < length; ++i) {
+        crc ^= static_cast<unsigned char>(data[i]);
+        for (int k = 0; k < 8; ++k) {
+            crc = crc & 1 ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+void fixChecksum(bsl::vector<char> *image)
+    // Store in the specified 'image' the checksum of its current contents,
+    // so that a deliberately corrupted image passes the checksum test.
+{
+    char *data = image->data();
+    const unsigned int crc = crc32(data + k_HEADER_SIZE,
+                                   image->size() - k_HEADER_SIZE,
+                                   crc32(data, k_CHECKSUM_OFFSET, 0));
+    bsl::memcpy(data + k_CHECKSUM_OFFSET, &crc, sizeof crc);
+}
+
+void setOpcode(bsl::vector<char> *image,
+               bsl::size_t        index,
+               Bytecode::Opcode   opcode)
+    // Replace the opcode of the instruction at the specified 'index' of the
+    // specified 'image' by the specified 'opcode', keeping its operand, and
+    // update the checksum.
+{
+    (*image)[k_HEADER_SIZE + index] = static_cast<char>(opcode);
+    fixChecksum(image);
+}
+
+unsigned int readWord(const bsl::vector<char>& image, bsl::size_t offset)
+    // Return the 32-bit word at the specified 'offset' in the specified
+    // 'image'.
+{
+    unsigned int word;
+    bsl::memcpy(&word, image.data() + offset, sizeof word);
+    return word;
+}
+
+void build(Program *result, const Bytecode *code, bsl::size_t numCodes)
+    // Load into the specified 'result' the program consisting of the
+    // specified 'numCodes' instructions beginning at the specified 'code'.
+{
+    ProgramBuilder builder(result->allocator());
+    ASSERT(0 == builder.append(code, numCodes));
+    builder.build(result);
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    bslma::TestAllocator ca(veryVerbose);  // for the constants of 'code'
+
+    const Bytecode code[] = {
+        Bytecode::createPush(bdld::Datum::createDouble(1.5)),
+        Bytecode::createPush(bdld::Datum::createStringRef("hello", 5, &ca)),
+        Bytecode::createOpcode(Bytecode::e_Pop),
+        Bytecode::create(Bytecode::e_GetGlobalSlot,
+                         bdld::Datum::createInteger(3)),
+        Bytecode::createPush(bdld::Datum::createInteger(-7)),
+        Bytecode::createPush(bdld::Datum::createBoolean(true)),
+        Bytecode::createPush(bdld::Datum::createNull()),
+        Bytecode::createPush(bdld::Datum::createDouble(1.5)),
+        Bytecode::createOpcode(Bytecode::e_Return),
+    };
+    const bsl::size_t NUM_CODES = sizeof code / sizeof *code;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "mapped files" << endl
+                          << "============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            Program program(&ta);
+            build(&program, code, NUM_CODES);
+            bsl::vector<char> buffer(&ta);
+            ASSERT(0 == ProgramImage::encode(&buffer, program));
+
+            const char *const PATH = "sjtt_programimage.t.tmp";
+            FILE *file = bsl::fopen(PATH, "wb");
+            ASSERT(0 != file);
+            ASSERT(buffer.size() ==
+                          bsl::fwrite(buffer.data(), 1, buffer.size(), file));
+            ASSERT(0 == bsl::fclose(file));
+
+            ProgramImage mX(&ta);
+            ASSERT(0 == mX.mapFile(PATH));
+            ASSERT(NUM_CODES == mX.numInstructions());
+            for (bsl::size_t i = 0; i < NUM_CODES; ++i) {
+                ASSERTV(i, program.opcode(i) == mX.opcode(i));
+            }
+            ASSERT("hello" == mX.constant(1).theString());
+            mX.reset();
+            ASSERT(0 == mX.numInstructions());
+
+            ASSERT(ProgramImage::e_FileError ==
+                                     mX.mapFile("sjtt_programimage.t.none"));
+
+            file = bsl::fopen(PATH, "wb");
+            ASSERT(0 != file);
+            ASSERT(0 == bsl::fclose(file));
+            ASSERT(ProgramImage::e_Truncated == mX.mapFile(PATH));
+            ASSERT(0 == bsl::remove(PATH));
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "rejected images" << endl
+                          << "===============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            Program program(&ta);
+            build(&program, code, NUM_CODES);
+            bsl::vector<char> original(&ta);
+            ASSERT(0 == ProgramImage::encode(&original, program));
+            ASSERT(0 == readWord(original, 12) % 2);
+
+            ProgramImage mX(&ta);
+            bsl::vector<char> image(original, &ta);
+
+            ASSERT(ProgramImage::e_Truncated ==
+                                    mX.load(image.data(), image.size() - 1));
+            ASSERT(ProgramImage::e_Truncated ==
+                                    mX.load(image.data(), k_HEADER_SIZE - 1));
+
+            image.push_back(0);
+            bsl::memmove(image.data() + 1, image.data(), original.size());
+            ASSERT(ProgramImage::e_Misaligned ==
+                                 mX.load(image.data() + 1, original.size()));
+
+            image = original;
+            image[0] = 'X';
+            ASSERT(ProgramImage::e_BadMagic ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            image[4] = 2;
+            ASSERT(ProgramImage::e_BadVersion ==
+                                        mX.load(image.data(), image.size()));
+
+            // Any change to the contents is caught by the checksum.
+
+            for (bsl::size_t i = 0; i < original.size(); ++i) {
+                if (4 <= i && i < 6) {
+                    continue;                                     // CONTINUE
+                }
+                image = original;
+                image[i] ^= 0x10;
+                const int rc = mX.load(image.data(), image.size());
+                ASSERTV(i, rc, ProgramImage::e_Success != rc);
+                ASSERTV(i, 0 == mX.numInstructions());
+            }
+
+            // Images with a valid checksum are still checked for sanity.
+
+            image = original;
+            image[k_HEADER_SIZE] = Bytecode::k_NUM_OPCODES;
+            fixChecksum(&image);
+            ASSERT(ProgramImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            image[readWord(original, 20)] = 99;   // operand of the 1st push
+            fixChecksum(&image);
+            ASSERT(ProgramImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            image[16] = 0x7F;                     // opcodes out of bounds
+            fixChecksum(&image);
+            ASSERT(ProgramImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            ASSERT(0 == mX.load(image.data(), image.size()));
+
+            // So is each instruction: its opcode must be runnable from an
+            // image, and its data of the type the opcode requires.  The data
+            // of the instructions of 'code' are, in order: 1.5, "hello",
+            // none, 3, -7, true, null, 1.5, and none.
+
+            const struct {
+                int              d_line;
+                bsl::size_t      d_index;     // of the instruction replaced
+                Bytecode::Opcode d_opcode;
+                int              d_status;
+            } DATA[] = {
+                { L_, 3, Bytecode::e_SetGlobalSlot, ProgramImage::e_Success },
+                { L_, 0, Bytecode::e_GetGlobalSlot,
+                                                  ProgramImage::e_Malformed },
+                { L_, 4, Bytecode::e_SetGlobalSlot,
+                                                  ProgramImage::e_Malformed },
+                { L_, 2, Bytecode::e_NewObject,   ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_GetProperty, ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_SetProperty, ProgramImage::e_Malformed },
+                { L_, 0, Bytecode::e_AddIntegers, ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_SubtractIntegers,
+                                                  ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_MultiplyIntegers,
+                                                  ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_LessIntegers,
+                                                  ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_Jump,        ProgramImage::e_Success },
+                { L_, 3, Bytecode::e_JumpIfFalse, ProgramImage::e_Success },
+                { L_, 4, Bytecode::e_Jump,        ProgramImage::e_Malformed },
+                { L_, 0, Bytecode::e_JumpIfFalse, ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_LoopHeader,  ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_Loop,        ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_Function,    ProgramImage::e_Success },
+                { L_, 4, Bytecode::e_Function,    ProgramImage::e_Malformed },
+                { L_, 4, Bytecode::e_GetLocal,    ProgramImage::e_Success },
+                { L_, 0, Bytecode::e_SetLocal,    ProgramImage::e_Malformed },
+                { L_, 3, Bytecode::e_Call,        ProgramImage::e_Malformed },
+                { L_, 4, Bytecode::e_TailCall,    ProgramImage::e_Malformed },
+            };
+            const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+            for (int ti = 0; ti < NUM_DATA; ++ti) {
+                const int LINE = DATA[ti].d_line;
+                image = original;
+                setOpcode(&image, DATA[ti].d_index, DATA[ti].d_opcode);
+                const int rc = mX.load(image.data(), image.size());
+                ASSERTV(LINE, rc, DATA[ti].d_status == rc);
+                if (ProgramImage::e_Success != rc) {
+                    ASSERTV(LINE, 0 == mX.numInstructions());
+                }
+            }
+
+            // Branches must stay within the program, whose last instruction
+            // is at offset 3 from the 6th one.
+
+            const bsl::size_t operands = readWord(original, 20);
+            for (bsl::size_t i = 5; i < 7; ++i) {
+                image = original;
+                bsl::memcpy(&image[operands + i * sizeof(Program::Operand)],
+                            &image[operands + 3 * sizeof(Program::Operand)],
+                            sizeof(Program::Operand));
+                setOpcode(&image, i, Bytecode::e_Jump);
+                ASSERTV(i, (5 == i ? ProgramImage::e_Success
+                                   : ProgramImage::e_Malformed) ==
+                                        mX.load(image.data(), image.size()));
+            }
+
+            // A call must target an 'e_Function' with a valid number of
+            // arguments.
+
+            for (int valid = 0; valid < 2; ++valid) {
+                image = original;
+                bsl::memcpy(&image[operands + 6 * sizeof(Program::Operand)],
+                            &image[operands + (valid ? 3 : 4) *
+                                                   sizeof(Program::Operand)],
+                            sizeof(Program::Operand));
+                setOpcode(&image, 6, Bytecode::e_Function);
+                setOpcode(&image, 3, Bytecode::e_Call);
+                ASSERTV(valid, (valid ? ProgramImage::e_Success
+                                      : ProgramImage::e_Malformed) ==
+                                        mX.load(image.data(), image.size()));
+            }
+
+            image = original;
+            ASSERT(0 == mX.load(image.data(), image.size()));
+
+            // Constants that cannot be stored are rejected by 'encode'.
+
+            const Bytecode udt[] = {
+                Bytecode::createPush(bdld::Datum::createUdt(0, 1)),
+            };
+            build(&program, udt, 1);
+            ASSERT(0 != ProgramImage::encode(&image, program));
+            ASSERT(original == image);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "checksum" << endl
+                          << "========" << endl;
+
+        // The checksum is the standard CRC-32, whose check value is that of
+        // "123456789".
+
+        ASSERT(0xCBF43926u == crc32("123456789", 9, 0));
+
+        bslma::TestAllocator ta(veryVerbose);
+        Program program(&ta);
+        build(&program, code, NUM_CODES);
+        bsl::vector<char> image(&ta);
+        ASSERT(0 == ProgramImage::encode(&image, program));
+
+        const unsigned int CHECKSUM = readWord(image, k_CHECKSUM_OFFSET);
+        fixChecksum(&image);
+        ASSERT(CHECKSUM == readWord(image, k_CHECKSUM_OFFSET));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            Program program(&ta);
+            build(&program, code, NUM_CODES);
+            ASSERT(6 == program.numConstants());
+
+            bsl::vector<char> image(&ta);
+            ASSERT(0 == ProgramImage::encode(&image, program));
+            if (verbose) { P(image.size()) }
+            ASSERT(0 == bsl::memcmp(image.data(), "SJTB", 4));
+            ASSERT(image.size() == readWord(image, 32));
+
+            ProgramImage mX(&ta);
+            const ProgramImage& X = mX;
+            ASSERT(0 == X.numInstructions());
+            ASSERT(0 == X.opcodes());
+
+            ASSERT(0 == mX.load(image.data(), image.size()));
+            ASSERT(NUM_CODES == X.numInstructions());
+            ASSERT(program.numConstants() == X.numConstants());
+            for (bsl::size_t i = 0; i < NUM_CODES; ++i) {
+                const Bytecode instruction = X.instruction(i);
+                ASSERTV(i, code[i].opcode() == X.opcode(i));
+                ASSERTV(i, program.operand(i) == X.operand(i));
+                if (Bytecode::hasData(code[i].opcode())) {
+                    ASSERTV(i, code[i].data() == instruction.data());
+                }
+            }
+
+            // Instructions and strings are used in place.
+
+            ASSERT(image.data() < reinterpret_cast<const char *>(X.opcodes()));
+            ASSERT(reinterpret_cast<const char *>(X.operands()) <
+                                                image.data() + image.size());
+            const bslstl::StringRef HELLO = X.constant(1).theString();
+            ASSERT("hello" == HELLO);
+            ASSERT(image.data() < HELLO.data());
+            ASSERT(HELLO.data() + 5 <= image.data() + image.size());
+
+            // An empty program has an image, too.
+
+            Program empty(&ta);
+            bsl::vector<char> emptyImage(&ta);
+            ASSERT(0 == ProgramImage::encode(&emptyImage, empty));
+            ASSERT(0 == mX.load(emptyImage.data(), emptyImage.size()));
+            ASSERT(0 == X.numInstructions());
+            ASSERT(0 == X.numConstants());
+            ASSERT(0 == X.constants());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    bdld::Datum::destroy(code[1].data(), &ca);
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
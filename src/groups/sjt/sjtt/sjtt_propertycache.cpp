@@ -0,0 +1,58 @@
+// sjtt_propertycache.cpp
+#include <sjtt_propertycache.h>
+
+namespace sjtt {
+
+                            // -------------------
+                            // class PropertyCache
+                            // -------------------
+
+// CLASS METHODS
+const char *PropertyCache::toAscii(State state) {
+#define CASE(NAME) case e_##NAME: return #NAME;
+
+    switch (state) {
+      CASE(Uninitialized)
+      CASE(Monomorphic)
+      CASE(Polymorphic)
+      CASE(Megamorphic)
+    }
+
+#undef CASE
+
+    return "(* UNKNOWN *)";
+}
+
+// CREATORS
+PropertyCache::PropertyCache(const StringRef&  name,
+                             Allocator        *basicAllocator)
+: d_numEntries(0)
+, d_numMisses(0)
+, d_isMegamorphic(false)
+, d_name(name.data(), name.length(), basicAllocator)
+{
+}
+
+// MANIPULATORS
+void PropertyCache::reset() {
+    d_numEntries    = 0;
+    d_numMisses     = 0;
+    d_isMegamorphic = false;
+}
+
+// ACCESSORS
+PropertyCache::State PropertyCache::state() const {
+    if (d_isMegamorphic) {
+        return e_Megamorphic;                                         // RETURN
+    }
+    switch (d_numEntries) {
+      case 0: {
+        return e_Uninitialized;                                       // RETURN
+      }
+      case 1: {
+        return e_Monomorphic;                                         // RETURN
+      }
+    }
+    return e_Polymorphic;
+}
+}
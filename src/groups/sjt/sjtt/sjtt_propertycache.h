@@ -0,0 +1,209 @@
+// sjtt_propertycache.h
+
+#ifndef INCLUDED_SJTT_PROPERTYCACHE
+#define INCLUDED_SJTT_PROPERTYCACHE
+
+#ifndef INCLUDED_SJTT_SHAPE
+#include <sjtt_shape.h>
+#endif
+
+#ifndef INCLUDED_BSL_STRING
+#include <bsl_string.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                            // ===================
+                            // class PropertyCache
+                            // ===================
+
+class PropertyCache {
+    // This class provides the inline cache of an instruction accessing the
+    // property having a given name: the slot of that property in objects of
+    // each of the last few shapes seen by the instruction.  An instruction
+    // that finds the shape of its object in the cache accesses the slot
+    // directly; otherwise it looks the property up by name in the shape, and
+    // records the result with 'insert'.  A cache seeing a single shape is
+    // monomorphic, and one seeing up to 'k_MAX_ENTRIES' shapes polymorphic;
+    // once more shapes are seen it becomes megamorphic and stops recording
+    // them, as caching would no longer pay for itself.
+    //
+    // An entry for a store may also record a transition: objects of its
+    // shape do not have the property, which is added in the slot of the
+    // entry, moving them to the shape 'd_next_p' of the entry.
+    //
+    // Entries are keyed by shape identifier, which is unique within the
+    // process, so a cache may be used with objects of several 'ShapeTable'
+    // objects, and may outlive them.  A cache is modified by the
+    // instructions using it, and must not be used by several threads at
+    // once.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator  Allocator;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+    struct Entry {
+        // This 'struct' holds the slot of the property for one shape.
+
+        // PUBLIC DATA
+        Shape::Int64  d_shapeId;  // identifier of the shape
+        int           d_slot;     // slot of the property, or -1 if absent
+        const Shape  *d_next_p;   // shape after adding the property, or 0
+    };
+
+    enum State {
+        // Enumeration used to describe the shapes seen by a cache.
+
+        e_Uninitialized,  // no shape has been seen
+        e_Monomorphic,    // a single shape has been seen
+        e_Polymorphic,    // up to 'k_MAX_ENTRIES' shapes have been seen
+        e_Megamorphic     // more shapes have been seen
+    };
+
+    enum {
+        k_MAX_ENTRIES = 4  // shapes recorded before becoming megamorphic
+    };
+
+  private:
+    // DATA
+    Entry       d_entries[k_MAX_ENTRIES];  // recorded shapes
+    int         d_numEntries;              // number of 'd_entries' in use
+    int         d_numMisses;               // lookups not found in entries
+    bool        d_isMegamorphic;           // a shape could not be recorded
+    bsl::string d_name;                    // name of the property
+
+    // NOT IMPLEMENTED
+    PropertyCache(const PropertyCache&);
+    PropertyCache& operator=(const PropertyCache&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(PropertyCache,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CLASS METHODS
+    static const char *toAscii(State state);
+        // Return the non-modifiable string representation of the name of the
+        // specified 'state', without its 'e_' prefix, e.g., "Monomorphic" for
+        // 'e_Monomorphic', or "(* UNKNOWN *)" if 'state' is not a 'State'.
+
+    // CREATORS
+    explicit PropertyCache(const StringRef&  name,
+                           Allocator        *basicAllocator = 0);
+        // Create an empty cache for the property having the specified
+        // 'name'.  Optionally specify a 'basicAllocator' used to supply
+        // memory.  If 'basicAllocator' is 0, the currently installed default
+        // allocator is used.
+
+    // MANIPULATORS
+    void insert(Shape::Int64 shapeId, int slot, const Shape *next = 0);
+        // Record a miss, and, unless this cache is full, record that the
+        // property is held by the specified 'slot' of objects of the shape
+        // having the specified 'shapeId', or is absent from them if 'slot'
+        // is -1.  Optionally specify the 'next' shape of such objects once
+        // the property has been added into 'slot'.  The behavior is
+        // undefined unless 'find(shapeId)' returns 0.
+
+    void reset();
+        // Remove all entries from this cache and reset its number of misses.
+
+    // ACCESSORS
+    const Entry *find(Shape::Int64 shapeId) const;
+        // Return the address of the entry for the shape having the specified
+        // 'shapeId', or 0 if there is none.
+
+    const Entry& entry(int index) const;
+        // Return a reference to the entry at the specified 'index'.  The
+        // behavior is undefined unless '0 <= index < numEntries()'.
+
+    const bsl::string& name() const;
+        // Return the name of the property cached by this object.
+
+    int numEntries() const;
+        // Return the number of shapes recorded by this cache.
+
+    int numMisses() const;
+        // Return the number of calls to 'insert' since this cache was
+        // created or reset.
+
+    State state() const;
+        // Return the state of this cache.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                            // -------------------
+                            // class PropertyCache
+                            // -------------------
+
+// MANIPULATORS
+inline
+void PropertyCache::insert(Shape::Int64  shapeId,
+                           int           slot,
+                           const Shape  *next) {
+    BSLS_ASSERT_SAFE(0 == find(shapeId));
+    ++d_numMisses;
+    if (k_MAX_ENTRIES == d_numEntries) {
+        d_isMegamorphic = true;
+        return;                                                       // RETURN
+    }
+    Entry& entry = d_entries[d_numEntries++];
+    entry.d_shapeId = shapeId;
+    entry.d_slot    = slot;
+    entry.d_next_p  = next;
+}
+
+// ACCESSORS
+inline
+const PropertyCache::Entry *PropertyCache::find(Shape::Int64 shapeId) const {
+    for (int i = 0; i < d_numEntries; ++i) {
+        if (d_entries[i].d_shapeId == shapeId) {
+            return d_entries + i;                                     // RETURN
+        }
+    }
+    return 0;
+}
+
+inline
+const PropertyCache::Entry& PropertyCache::entry(int index) const {
+    BSLS_ASSERT_SAFE(0 <= index);
+    BSLS_ASSERT_SAFE(index < d_numEntries);
+    return d_entries[index];
+}
+
+inline
+const bsl::string& PropertyCache::name() const {
+    return d_name;
+}
+
+inline
+int PropertyCache::numEntries() const {
+    return d_numEntries;
+}
+
+inline
+int PropertyCache::numMisses() const {
+    return d_numMisses;
+}
+}
+
+#endif
@@ -0,0 +1,164 @@
+// sjtt_propertycache.t.cpp                               -*-C++-*-
+
+#include <sjtt_propertycache.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_cstring.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "toAscii" << endl
+                          << "=======" << endl;
+
+        ASSERT(0 == strcmp("Uninitialized",
+                     PropertyCache::toAscii(PropertyCache::e_Uninitialized)));
+        ASSERT(0 == strcmp("Megamorphic",
+                       PropertyCache::toAscii(PropertyCache::e_Megamorphic)));
+        ASSERT(0 == strcmp("(* UNKNOWN *)",
+                           PropertyCache::toAscii(
+                                  static_cast<PropertyCache::State>(-1))));
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "transitions" << endl
+                          << "===========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        ShapeTable    table(&ta);
+        PropertyCache cache("x", &ta);
+        const Shape  *x = table.addProperty(table.root(), "x");
+
+        cache.insert(table.root()->id(), 0, x);
+        cache.insert(x->id(), 0);
+
+        const PropertyCache::Entry *add = cache.find(table.root()->id());
+        ASSERT(0 != add);
+        ASSERT(0 == add->d_slot);
+        ASSERT(x == add->d_next_p);
+
+        const PropertyCache::Entry *store = cache.find(x->id());
+        ASSERT(0 != store);
+        ASSERT(0 == store->d_slot);
+        ASSERT(0 == store->d_next_p);
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        PropertyCache cache("a property name longer than a short string",
+                            &ta);
+        ASSERT("a property name longer than a short string" == cache.name());
+        ASSERT(PropertyCache::e_Uninitialized == cache.state());
+        ASSERT(0 == cache.numEntries());
+        ASSERT(0 == cache.numMisses());
+        ASSERT(0 == cache.find(1));
+
+        cache.insert(1, 3);
+        ASSERT(PropertyCache::e_Monomorphic == cache.state());
+        ASSERT(1 == cache.numMisses());
+        ASSERT(0 != cache.find(1));
+        ASSERT(3 == cache.find(1)->d_slot);
+        ASSERT(0 == cache.find(1)->d_next_p);
+        ASSERT(0 == cache.find(2));
+
+        cache.insert(2, -1);
+        ASSERT(PropertyCache::e_Polymorphic == cache.state());
+        ASSERT(-1 == cache.find(2)->d_slot);
+        ASSERT(3 == cache.find(1)->d_slot);
+
+        for (int i = 3; i <= PropertyCache::k_MAX_ENTRIES; ++i) {
+            cache.insert(i, i);
+        }
+        ASSERT(PropertyCache::e_Polymorphic == cache.state());
+        ASSERT(PropertyCache::k_MAX_ENTRIES == cache.numEntries());
+
+        // Further shapes are not recorded.
+
+        const int ID = PropertyCache::k_MAX_ENTRIES + 1;
+        cache.insert(ID, 0);
+        ASSERT(PropertyCache::e_Megamorphic == cache.state());
+        ASSERT(PropertyCache::k_MAX_ENTRIES == cache.numEntries());
+        ASSERT(0 == cache.find(ID));
+        ASSERT(ID == cache.numMisses());
+        ASSERT(1 == cache.entry(0).d_shapeId);
+
+        cache.reset();
+        ASSERT(PropertyCache::e_Uninitialized == cache.state());
+        ASSERT(0 == cache.numMisses());
+        ASSERT(0 == cache.find(1));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
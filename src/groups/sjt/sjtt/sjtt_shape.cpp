@@ -0,0 +1,92 @@
+// sjtt_shape.cpp
+#include <sjtt_shape.h>
+
+#include <bslma_default.h>
+#include <bsls_atomic.h>
+
+namespace sjtt {
+
+namespace {
+
+BloombergLP::bsls::AtomicInt64 s_lastId(0);  // identifier of the last shape
+
+}  // close unnamed namespace
+
+                                // -----------
+                                // class Shape
+                                // -----------
+
+// PRIVATE CREATORS
+Shape::Shape(const Shape      *parent,
+             const StringRef&  name,
+             Allocator        *basicAllocator)
+: d_id(s_lastId.addRelaxed(1))
+, d_parent_p(parent)
+, d_names(basicAllocator)
+{
+    if (parent) {
+        d_names.reserve(parent->d_names.size() + 1);
+        d_names = parent->d_names;
+        d_names.push_back(bsl::string(name.data(),
+                                      name.length(),
+                                      basicAllocator));
+    }
+}
+
+// ACCESSORS
+int Shape::findSlot(const StringRef& name) const {
+    for (bsl::size_t i = 0; i < d_names.size(); ++i) {
+        if (d_names[i].length() == name.length()
+         && 0 == d_names[i].compare(0, name.length(), name.data(),
+                                    name.length())) {
+            return static_cast<int>(i);                               // RETURN
+        }
+    }
+    return -1;
+}
+
+                              // ----------------
+                              // class ShapeTable
+                              // ----------------
+
+// CREATORS
+ShapeTable::ShapeTable(Allocator *basicAllocator)
+: d_shapes(basicAllocator)
+, d_transitions(basicAllocator)
+, d_allocator_p(BloombergLP::bslma::Default::allocator(basicAllocator))
+{
+    d_shapes.push_back(new (*d_allocator_p) Shape(0,
+                                                  StringRef(),
+                                                  d_allocator_p));
+}
+
+ShapeTable::~ShapeTable()
+{
+    for (bsl::size_t i = 0; i < d_shapes.size(); ++i) {
+        d_allocator_p->deleteObject(d_shapes[i]);
+    }
+}
+
+// MANIPULATORS
+const Shape *ShapeTable::addProperty(const Shape      *shape,
+                                     const StringRef&  name)
+{
+    BSLS_ASSERT(0 != shape);
+    BSLS_ASSERT(0 > shape->findSlot(name));
+
+    const Transitions::key_type key(shape->id(),
+                                    bsl::string(name.data(),
+                                                name.length(),
+                                                d_allocator_p));
+    const Transitions::const_iterator it = d_transitions.find(key);
+    if (d_transitions.end() != it) {
+        return it->second;                                            // RETURN
+    }
+
+    d_shapes.reserve(d_shapes.size() + 1);  // so that 'push_back' cannot throw
+    Shape *child = new (*d_allocator_p) Shape(shape, name, d_allocator_p);
+    d_shapes.push_back(child);
+    d_transitions.insert(bsl::make_pair(key, child));
+    return child;
+}
+}
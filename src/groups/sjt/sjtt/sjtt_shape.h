@@ -0,0 +1,218 @@
+// sjtt_shape.h
+
+#ifndef INCLUDED_SJTT_SHAPE
+#define INCLUDED_SJTT_SHAPE
+
+#ifndef INCLUDED_BSL_MAP
+#include <bsl_map.h>
+#endif
+
+#ifndef INCLUDED_BSL_STRING
+#include <bsl_string.h>
+#endif
+
+#ifndef INCLUDED_BSL_UTILITY
+#include <bsl_utility.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                                // ===========
+                                // class Shape
+                                // ===========
+
+class Shape {
+    // This class describes the layout shared by all objects having the same
+    // properties, added in the same order (a "hidden class"): the name of the
+    // property held by each slot of such an object.  Shapes are created and
+    // owned by a 'ShapeTable', and never change once created.  Each shape has
+    // an identifier that is unique within the process, even across tables,
+    // so that a cache keyed by identifier (see 'PropertyCache') cannot
+    // mistake a shape for another one created at the same address.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator      Allocator;
+    typedef BloombergLP::bslstl::StringRef     StringRef;
+    typedef BloombergLP::bsls::Types::Int64    Int64;
+
+  private:
+    // DATA
+    Int64                    d_id;        // unique identifier
+    const Shape             *d_parent_p;  // shape without the last property
+    bsl::vector<bsl::string> d_names;     // name of the property of each slot
+
+    // FRIENDS
+    friend class ShapeTable;
+
+    // PRIVATE CREATORS
+    Shape(const Shape      *parent,
+          const StringRef&  name,
+          Allocator        *basicAllocator);
+        // Create a shape having the slots of the specified 'parent' followed
+        // by one for the property having the specified 'name', or having no
+        // slots if 'parent' is 0, and a new identifier.  Use the specified
+        // 'basicAllocator' to supply memory.
+
+    // NOT IMPLEMENTED
+    Shape(const Shape&);
+    Shape& operator=(const Shape&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(Shape,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // ACCESSORS
+    int findSlot(const StringRef& name) const;
+        // Return the slot of the property having the specified 'name', or -1
+        // if objects of this shape have no such property.
+
+    Int64 id() const;
+        // Return the identifier of this shape.
+
+    const bsl::string& name(int slot) const;
+        // Return the name of the property held by the specified 'slot'.  The
+        // behavior is undefined unless '0 <= slot < numSlots()'.
+
+    int numSlots() const;
+        // Return the number of properties of objects of this shape.
+
+    const Shape *parent() const;
+        // Return the shape of objects having all the properties of this shape
+        // but the last one, or 0 if this shape has no properties.
+};
+
+                              // ================
+                              // class ShapeTable
+                              // ================
+
+class ShapeTable {
+    // This class owns the shapes of a set of objects, which form a tree
+    // rooted at the shape having no properties: adding a property to an
+    // object moves it from its shape to the child of that shape for the
+    // property, which is created the first time and reused afterwards, so
+    // that objects built alike, e.g., records having a fixed schema, share a
+    // single shape.  Shapes remain valid until the table is destroyed.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator  Allocator;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+  private:
+    // PRIVATE TYPES
+    typedef bsl::map<bsl::pair<Shape::Int64, bsl::string>, const Shape *>
+                                                                  Transitions;
+
+    // DATA
+    bsl::vector<Shape *>  d_shapes;       // owned shapes, root first
+    Transitions           d_transitions;  // child of each shape by property
+    Allocator            *d_allocator_p;  // memory allocator (held)
+
+    // NOT IMPLEMENTED
+    ShapeTable(const ShapeTable&);
+    ShapeTable& operator=(const ShapeTable&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(ShapeTable,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CREATORS
+    explicit ShapeTable(Allocator *basicAllocator = 0);
+        // Create a table holding only the shape having no properties.
+        // Optionally specify a 'basicAllocator' used to supply memory.  If
+        // 'basicAllocator' is 0, the currently installed default allocator
+        // is used.
+
+    ~ShapeTable();
+        // Destroy this object and the shapes it owns.
+
+    // MANIPULATORS
+    const Shape *addProperty(const Shape *shape, const StringRef& name);
+        // Return the shape of objects having the properties of the specified
+        // 'shape' followed by the property having the specified 'name',
+        // creating it if needed.  The behavior is undefined unless 'shape' is
+        // owned by this table and 'name' is not a property of 'shape'.
+
+    // ACCESSORS
+    int numShapes() const;
+        // Return the number of shapes owned by this table.
+
+    const Shape *root() const;
+        // Return the shape having no properties, that of new objects.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                                // -----------
+                                // class Shape
+                                // -----------
+
+// ACCESSORS
+inline
+Shape::Int64 Shape::id() const {
+    return d_id;
+}
+
+inline
+const bsl::string& Shape::name(int slot) const {
+    BSLS_ASSERT_SAFE(0 <= slot);
+    BSLS_ASSERT_SAFE(slot < numSlots());
+    return d_names[slot];
+}
+
+inline
+int Shape::numSlots() const {
+    return static_cast<int>(d_names.size());
+}
+
+inline
+const Shape *Shape::parent() const {
+    return d_parent_p;
+}
+
+                              // ----------------
+                              // class ShapeTable
+                              // ----------------
+
+// ACCESSORS
+inline
+int ShapeTable::numShapes() const {
+    return static_cast<int>(d_shapes.size());
+}
+
+inline
+const Shape *ShapeTable::root() const {
+    return d_shapes.front();
+}
+}
+
+#endif
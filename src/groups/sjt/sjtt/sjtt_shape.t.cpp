@@ -0,0 +1,141 @@
+// sjtt_shape.t.cpp                                       -*-C++-*-
+
+#include <sjtt_shape.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "identifiers are unique across tables" << endl
+                          << "====================================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        Shape::Int64 lastId;
+        {
+            ShapeTable table(&ta);
+            lastId = table.addProperty(table.root(), "x")->id();
+            ASSERT(table.root()->id() < lastId);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+
+        ShapeTable table(&ta);
+        ASSERT(lastId < table.root()->id());
+        ASSERT(lastId < table.addProperty(table.root(), "x")->id());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        ShapeTable table(&ta);
+        ASSERT(1 == table.numShapes());
+
+        const Shape *root = table.root();
+        ASSERT(0 == root->numSlots());
+        ASSERT(0 == root->parent());
+        ASSERT(-1 == root->findSlot("x"));
+
+        const Shape *x = table.addProperty(root, "x");
+        ASSERT(root == x->parent());
+        ASSERT(1 == x->numSlots());
+        ASSERT("x" == x->name(0));
+        ASSERT(0 == x->findSlot("x"));
+        ASSERT(-1 == x->findSlot("y"));
+        ASSERT(root->id() != x->id());
+
+        const Shape *xy = table.addProperty(x, "y");
+        ASSERT(x == xy->parent());
+        ASSERT(2 == xy->numSlots());
+        ASSERT(0 == xy->findSlot("x"));
+        ASSERT(1 == xy->findSlot("y"));
+        ASSERT("y" == xy->name(1));
+        ASSERT(3 == table.numShapes());
+
+        // Transitions are shared, so objects built alike share a shape.
+
+        ASSERT(x  == table.addProperty(root, "x"));
+        ASSERT(xy == table.addProperty(x, "y"));
+        ASSERT(3 == table.numShapes());
+
+        // The order in which properties are added matters.
+
+        const Shape *yx = table.addProperty(table.addProperty(root, "y"),
+                                            "x");
+        ASSERT(xy != yx);
+        ASSERT(1 == yx->findSlot("x"));
+        ASSERT(0 == yx->findSlot("y"));
+        ASSERT(5 == table.numShapes());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
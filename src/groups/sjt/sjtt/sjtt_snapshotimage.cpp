@@ -0,0 +1,502 @@
+// sjtt_snapshotimage.cpp
+#include <sjtt_snapshotimage.h>
+
+#include <sjtt_imageutil.h>
+#include <sjtt_symboltable.h>
+
+#include <bslmf_assert.h>
+#include <bsls_platform.h>
+#include <bsls_types.h>
+
+#include <bsl_cstddef.h>
+#include <bsl_cstring.h>
+
+namespace sjtt {
+using BloombergLP::bdld::Datum;
+using BloombergLP::bsls::Types;
+using BloombergLP::bslstl::StringRef;
+
+namespace {
+
+enum ValueType {
+    // Enumeration used to tag the values of an image.
+
+    e_Null,
+    e_Double,
+    e_Integer,
+    e_Boolean,
+    e_String,
+    e_Array,
+    e_Udt,
+    e_Map
+};
+
+struct Header {
+    // This 'struct' describes the header at the start of an image.
+
+    char           d_magic[4];        // "SJTS"
+    unsigned short d_version;         // 'SnapshotImage::k_VERSION'
+    unsigned short d_reserved;        // 0
+    unsigned int   d_numGlobals;      // number of global records
+    unsigned int   d_numValues;       // number of value records
+    unsigned int   d_globalsOffset;   // offsets from the start of the image
+    unsigned int   d_valuesOffset;
+    unsigned int   d_stringsOffset;
+    unsigned int   d_size;            // size of the whole image
+    unsigned int   d_checksum;        // CRC-32 of all other bytes
+};
+
+struct Global {
+    // This 'struct' describes the record of a global in an image.  The value
+    // of the global at index 'i' is the value record at index 'i'.
+
+    unsigned int d_nameOffset;  // offset of the name in the strings section
+    unsigned int d_nameLength;  // length of the name
+};
+
+struct Value {
+    // This 'struct' describes the record of a value in an image.
+
+    unsigned int  d_type;     // 'ValueType'
+    unsigned int  d_length;   // length of a string, array, or map, and 0
+                              // otherwise
+    Types::Uint64 d_payload;  // value, offset of a string in its section, or
+                              // index of the first element of an array or
+                              // of the first key of a map
+};
+
+struct Item {
+    // This 'struct' describes a value to be stored in an image, or the key
+    // of an entry of a map, which is stored as a string.
+
+    const Datum                    *d_value_p;  // value, or 0 for a key
+    BloombergLP::bslstl::StringRef  d_key;      // key, if 'd_value_p' is 0
+};
+
+BSLMF_ASSERT(36 == sizeof(Header));
+BSLMF_ASSERT( 8 == sizeof(Global));
+BSLMF_ASSERT(16 == sizeof(Value));
+
+const char k_MAGIC[4] = { 'S', 'J', 'T', 'S' };
+
+bsl::size_t alignUp(bsl::size_t offset, bsl::size_t alignment)
+    // Return the smallest multiple of the specified 'alignment' that is not
+    // less than the specified 'offset'.
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+unsigned int checksum(const char *image, bsl::size_t size)
+    // Return the checksum of the specified 'image' of the specified 'size'
+    // bytes, which covers every byte except those of the checksum itself.
+{
+    const bsl::size_t  at  = offsetof(Header, d_checksum);
+    const unsigned int crc = ImageUtil::crc32(image, at);
+    return ImageUtil::crc32(image + sizeof(Header),
+                            size - sizeof(Header),
+                            crc);
+}
+
+bool isStorable(const Datum& value)
+    // Return 'true' if the specified 'value' is of a type that can be stored
+    // in an image, not considering the elements of an array or a map, and
+    // 'false' otherwise.
+{
+    return value.isNull()
+        || value.isDouble()
+        || value.isInteger()
+        || value.isBoolean()
+        || value.isString()
+        || value.isArray()
+        || value.isMap()
+        || (value.isUdt() && 0 == value.theUdt().data());
+}
+
+}  // close unnamed namespace
+
+                            // -------------------
+                            // class SnapshotImage
+                            // -------------------
+
+// CLASS METHODS
+int SnapshotImage::encode(bsl::vector<char>              *result,
+                          const SymbolTable&              names,
+                          const bsl::vector<GlobalValue>& globals)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(globals.size() ==
+                              static_cast<bsl::size_t>(names.numSymbols()));
+
+    // List the values breadth first, so that the globals come first, in
+    // order, and the elements of each array, or the keys and values of each
+    // map, alternately, follow it contiguously.
+
+    const bsl::size_t  numGlobals = globals.size();
+    bsl::vector<Item>  values(result->get_allocator());
+    values.reserve(numGlobals);
+    bsl::size_t stringsLength = 0;
+    for (bsl::size_t i = 0; i < numGlobals; ++i) {
+        const Item item = { &globals[i].datum(), StringRef() };
+        values.push_back(item);
+        stringsLength += names.name(static_cast<int>(i)).length();
+    }
+    for (bsl::size_t i = 0; i < values.size(); ++i) {
+        if (0 == values[i].d_value_p) {
+            stringsLength += values[i].d_key.length();
+            continue;                                             // CONTINUE
+        }
+        const Datum& value = *values[i].d_value_p;
+        if (!isStorable(value)) {
+            return 1;                                                 // RETURN
+        }
+        if (value.isString()) {
+            stringsLength += value.theString().length();
+        }
+        else if (value.isArray()) {
+            const BloombergLP::bdld::DatumArrayRef array = value.theArray();
+            for (bsl::size_t j = 0; j < array.length(); ++j) {
+                const Item item = { &array[j], StringRef() };
+                values.push_back(item);
+            }
+        }
+        else if (value.isMap()) {
+            const BloombergLP::bdld::DatumMapRef map = value.theMap();
+            for (bsl::size_t j = 0; j < map.size(); ++j) {
+                const Item key   = { 0, map[j].key() };
+                const Item entry = { &map[j].value(), StringRef() };
+                values.push_back(key);
+                values.push_back(entry);
+            }
+        }
+    }
+
+    const bsl::size_t numValues = values.size();
+
+    Header header;
+    bsl::memcpy(header.d_magic, k_MAGIC, sizeof k_MAGIC);
+    header.d_version       = k_VERSION;
+    header.d_reserved      = 0;
+    header.d_numGlobals    = static_cast<unsigned int>(numGlobals);
+    header.d_numValues     = static_cast<unsigned int>(numValues);
+
+    bsl::size_t offset = alignUp(sizeof header, k_ALIGNMENT);
+    header.d_globalsOffset = static_cast<unsigned int>(offset);
+    offset = alignUp(offset + numGlobals * sizeof(Global), k_ALIGNMENT);
+    header.d_valuesOffset  = static_cast<unsigned int>(offset);
+    offset += numValues * sizeof(Value);
+    header.d_stringsOffset = static_cast<unsigned int>(offset);
+    offset += stringsLength;
+    header.d_size          = static_cast<unsigned int>(offset);
+    header.d_checksum      = 0;
+
+    bsl::vector<char> image(offset, 0, result->get_allocator());
+    char *data         = image.data();
+    char *strings      = data + header.d_stringsOffset;
+    bsl::size_t stringOffset = 0;
+
+    for (bsl::size_t i = 0; i < numGlobals; ++i) {
+        const bsl::string& name = names.name(static_cast<int>(i));
+        Global             record;
+        record.d_nameOffset = static_cast<unsigned int>(stringOffset);
+        record.d_nameLength = static_cast<unsigned int>(name.length());
+        bsl::memcpy(strings + stringOffset, name.data(), name.length());
+        stringOffset += name.length();
+        bsl::memcpy(data + header.d_globalsOffset + i * sizeof record,
+                    &record,
+                    sizeof record);
+    }
+
+    bsl::size_t nextElement = numGlobals;
+    for (bsl::size_t i = 0; i < numValues; ++i) {
+        Value record = { e_Null, 0, 0 };
+        if (0 == values[i].d_value_p) {
+            const StringRef& key = values[i].d_key;
+            record.d_type    = e_String;
+            record.d_length  = static_cast<unsigned int>(key.length());
+            record.d_payload = stringOffset;
+            bsl::memcpy(strings + stringOffset, key.data(), key.length());
+            stringOffset += key.length();
+            bsl::memcpy(data + header.d_valuesOffset + i * sizeof record,
+                        &record,
+                        sizeof record);
+            continue;                                             // CONTINUE
+        }
+        const Datum& value = *values[i].d_value_p;
+        if (value.isDouble()) {
+            const double d = value.theDouble();
+            record.d_type = e_Double;
+            bsl::memcpy(&record.d_payload, &d, sizeof d);
+        }
+        else if (value.isInteger()) {
+            record.d_type    = e_Integer;
+            record.d_payload = static_cast<unsigned int>(value.theInteger());
+        }
+        else if (value.isBoolean()) {
+            record.d_type    = e_Boolean;
+            record.d_payload = value.theBoolean();
+        }
+        else if (value.isString()) {
+            const BloombergLP::bslstl::StringRef string = value.theString();
+            record.d_type    = e_String;
+            record.d_length  = static_cast<unsigned int>(string.length());
+            record.d_payload = stringOffset;
+            bsl::memcpy(strings + stringOffset,
+                        string.data(),
+                        string.length());
+            stringOffset += string.length();
+        }
+        else if (value.isArray()) {
+            const bsl::size_t length = value.theArray().length();
+            record.d_type    = e_Array;
+            record.d_length  = static_cast<unsigned int>(length);
+            record.d_payload = nextElement;
+            nextElement += length;
+        }
+        else if (value.isMap()) {
+            const bsl::size_t length = value.theMap().size();
+            record.d_type    = e_Map;
+            record.d_length  = static_cast<unsigned int>(length);
+            record.d_payload = nextElement;
+            nextElement += 2 * length;
+        }
+        else if (value.isUdt()) {
+            record.d_type    = e_Udt;
+            record.d_payload = static_cast<unsigned int>(
+                                                     value.theUdt().type());
+        }
+        bsl::memcpy(data + header.d_valuesOffset + i * sizeof record,
+                    &record,
+                    sizeof record);
+    }
+
+    bsl::memcpy(data, &header, sizeof header);
+    header.d_checksum = checksum(data, image.size());
+    bsl::memcpy(data, &header, sizeof header);
+
+    result->swap(image);
+    return 0;
+}
+
+// CREATORS
+SnapshotImage::SnapshotImage(Allocator *basicAllocator)
+: d_names_p(0)
+, d_strings_p(0)
+, d_numGlobals(0)
+, d_values_p(0)
+, d_mapping_p(0)
+, d_mappingSize(0)
+, d_owner(basicAllocator)
+{
+}
+
+SnapshotImage::~SnapshotImage()
+{
+    reset();
+}
+
+// MANIPULATORS
+int SnapshotImage::load(const char *image, bsl::size_t size)
+{
+    BSLS_ASSERT(0 != image || 0 == size);
+
+    reset();
+#ifdef BSLS_PLATFORM_IS_BIG_ENDIAN
+    return e_Malformed;                                               // RETURN
+#endif
+    if (0 != reinterpret_cast<Types::UintPtr>(image) % k_ALIGNMENT) {
+        return e_Misaligned;                                          // RETURN
+    }
+    if (size < sizeof(Header)) {
+        return e_Truncated;                                           // RETURN
+    }
+
+    Header header;
+    bsl::memcpy(&header, image, sizeof header);
+    if (0 != bsl::memcmp(header.d_magic, k_MAGIC, sizeof k_MAGIC)) {
+        return e_BadMagic;                                            // RETURN
+    }
+    if (k_MIN_VERSION > header.d_version || k_VERSION < header.d_version) {
+        return e_BadVersion;                                          // RETURN
+    }
+    if (size < header.d_size || header.d_size < sizeof header) {
+        return e_Truncated;                                           // RETURN
+    }
+    if (checksum(image, header.d_size) != header.d_checksum) {
+        return e_BadChecksum;                                         // RETURN
+    }
+
+    // Check that the sections are in order, aligned, and within the image.
+    // The arithmetic is done on 64 bits so that it cannot overflow.
+
+    const Types::Uint64 numGlobals = header.d_numGlobals;
+    const Types::Uint64 numValues  = header.d_numValues;
+    if (sizeof header > header.d_globalsOffset
+     || 0 != header.d_globalsOffset % k_ALIGNMENT
+     || header.d_globalsOffset + numGlobals * sizeof(Global)
+                                                    > header.d_valuesOffset
+     || 0 != header.d_valuesOffset % k_ALIGNMENT
+     || header.d_valuesOffset + numValues * sizeof(Value)
+                                                   > header.d_stringsOffset
+     || header.d_stringsOffset > header.d_size
+     || numGlobals > numValues) {
+        return e_Malformed;                                           // RETURN
+    }
+
+    const char          *strings       = image + header.d_stringsOffset;
+    const Types::Uint64  stringsLength = header.d_size
+                                                     - header.d_stringsOffset;
+    for (bsl::size_t i = 0; i < numGlobals; ++i) {
+        Global record;
+        bsl::memcpy(&record,
+                    image + header.d_globalsOffset + i * sizeof record,
+                    sizeof record);
+        if (record.d_nameOffset > stringsLength
+         || record.d_nameLength > stringsLength - record.d_nameOffset) {
+            return e_Malformed;                                       // RETURN
+        }
+    }
+
+    // Make all the values in one block.  The elements of an array or a map
+    // must follow it, so that no value can contain itself.  The values are
+    // made last to first, so that the entries of a map, which are copied
+    // into it, are made before the map.
+
+    Datum *values = static_cast<Datum *>(
+                                d_owner.allocate(numValues * sizeof(Datum)));
+    for (bsl::size_t i = numValues; 0 < i--; ) {
+        Value record;
+        bsl::memcpy(&record,
+                    image + header.d_valuesOffset + i * sizeof record,
+                    sizeof record);
+        switch (record.d_type) {
+          case e_Null: {
+            values[i] = Datum::createNull();
+          } break;
+          case e_Double: {
+            double value;
+            bsl::memcpy(&value, &record.d_payload, sizeof value);
+            values[i] = Datum::createDouble(value);
+          } break;
+          case e_Integer: {
+            const unsigned int value =
+                                static_cast<unsigned int>(record.d_payload);
+            values[i] = Datum::createInteger(static_cast<int>(value));
+          } break;
+          case e_Boolean: {
+            values[i] = Datum::createBoolean(0 != record.d_payload);
+          } break;
+          case e_String: {
+            if (record.d_payload > stringsLength
+             || record.d_length > stringsLength - record.d_payload) {
+                reset();
+                return e_Malformed;                                   // RETURN
+            }
+            values[i] = Datum::createStringRef(strings + record.d_payload,
+                                               record.d_length,
+                                               &d_owner);
+          } break;
+          case e_Array: {
+            if (record.d_payload <= i
+             || record.d_payload > numValues
+             || record.d_length > numValues - record.d_payload) {
+                reset();
+                return e_Malformed;                                   // RETURN
+            }
+            values[i] = Datum::createArrayReference(
+                                                 values + record.d_payload,
+                                                 record.d_length,
+                                                 &d_owner);
+          } break;
+          case e_Udt: {
+            const unsigned int type =
+                                static_cast<unsigned int>(record.d_payload);
+            values[i] = Datum::createUdt(0, static_cast<int>(type));
+          } break;
+          case e_Map: {
+            if (k_MAP_VERSION > header.d_version
+             || record.d_payload <= i
+             || record.d_payload > numValues
+             || record.d_length > (numValues - record.d_payload) / 2) {
+                reset();
+                return e_Malformed;                                   // RETURN
+            }
+            const Datum *entries = values + record.d_payload;
+            BloombergLP::bdld::DatumMutableMapRef map;
+            Datum::createUninitializedMap(&map, record.d_length, &d_owner);
+            for (bsl::size_t j = 0; j < record.d_length; ++j) {
+                const Datum& key = entries[2 * j];
+                if (!key.isString()) {
+                    reset();
+                    return e_Malformed;                               // RETURN
+                }
+                map.data()[j] = BloombergLP::bdld::DatumMapEntry(
+                                                      key.theString(),
+                                                      entries[2 * j + 1]);
+            }
+            *map.size() = record.d_length;
+            values[i] = Datum::adoptMap(map);
+          } break;
+          default: {
+            reset();
+            return e_Malformed;                                       // RETURN
+          }
+        }
+    }
+
+    d_names_p    = image + header.d_globalsOffset;
+    d_strings_p  = strings;
+    d_numGlobals = header.d_numGlobals;
+    d_values_p   = values;
+    return e_Success;
+}
+
+int SnapshotImage::mapFile(const char *path)
+{
+    BSLS_ASSERT(0 != path);
+
+    reset();
+    const char  *data;
+    bsl::size_t  size;
+    if (0 != ImageUtil::mapFile(&data, &size, path)) {
+        return e_FileError;                                           // RETURN
+    }
+    const int rc = load(data, size);
+    d_mapping_p   = data;
+    d_mappingSize = size;
+    if (e_Success != rc) {
+        reset();
+    }
+    return rc;
+}
+
+void SnapshotImage::reset()
+{
+    d_owner.release();
+    d_names_p    = 0;
+    d_strings_p  = 0;
+    d_numGlobals = 0;
+    d_values_p   = 0;
+    if (0 != d_mapping_p) {
+        ImageUtil::unmapFile(d_mapping_p, d_mappingSize);
+    }
+    d_mapping_p   = 0;
+    d_mappingSize = 0;
+}
+
+// ACCESSORS
+BloombergLP::bslstl::StringRef SnapshotImage::name(bsl::size_t index) const
+{
+    BSLS_ASSERT_SAFE(index < d_numGlobals);
+
+    Global record;
+    bsl::memcpy(&record, d_names_p + index * sizeof record, sizeof record);
+    return StringRef(d_strings_p + record.d_nameOffset, record.d_nameLength);
+}
+
+const BloombergLP::bdld::Datum& SnapshotImage::value(bsl::size_t index) const
+{
+    BSLS_ASSERT_SAFE(index < d_numGlobals);
+
+    return d_values_p[index];
+}
+}
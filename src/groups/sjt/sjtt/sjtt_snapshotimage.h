@@ -0,0 +1,212 @@
+// sjtt_snapshotimage.h
+
+#ifndef INCLUDED_SJTT_SNAPSHOTIMAGE
+#define INCLUDED_SJTT_SNAPSHOTIMAGE
+
+#ifndef INCLUDED_SJTT_GLOBALVALUE
+#include <sjtt_globalvalue.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BDLMA_SEQUENTIALALLOCATOR
+#include <bdlma_sequentialallocator.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+class SymbolTable;
+
+                            // ===================
+                            // class SnapshotImage
+                            // ===================
+
+class SnapshotImage {
+    // This class provides access to a snapshot of named globals, such as
+    // those of an engine, stored in a relocatable binary image, e.g., a file
+    // mapped into memory.  The image is produced by 'encode' and has the
+    // following layout, in which all offsets are relative to the start of
+    // the image, and all integers are little-endian:
+    //..
+    //  header   magic "SJTS", format version, counts, section offsets,
+    //           total size, and a CRC-32 of the rest of the image
+    //  globals  one 8-byte record per global: the offset and length of its
+    //           name
+    //  values   one 16-byte record per value, those of the globals first and
+    //           in order: a type tag, a length, and a 64-bit payload holding
+    //           a double, an integer, a boolean, the type of a user-defined
+    //           value, the offset of a string, or the index of the first
+    //           element of an array, whose elements are stored contiguously
+    //           after it, or of the first key of a map, whose keys, as
+    //           string records, and values are stored alternately after it
+    //  strings  the bytes of the names, strings, and keys
+    //..
+    // Loading an image performs no per-value allocation or copying: after
+    // verifying the checksum, 'load' makes one block of 'Datum' objects, one
+    // per value record, in which strings refer to their bytes in the image
+    // and arrays to their elements in the block.  Maps are the exception:
+    // each is made with one allocation holding its entries, whose keys refer
+    // to the image.  Values can be null, doubles, integers, booleans,
+    // strings, user-defined values whose data is a null pointer (e.g.,
+    // 'sjtu::DatumUtil::s_Undefined'), and arrays and maps of such values.
+    // The image must remain valid, and unmodified, while it is loaded.
+    // Images of any version from 'k_MIN_VERSION' to 'k_VERSION' are loaded,
+    // but maps are accepted only from 'k_MAP_VERSION' on.
+    //
+    // The values are made with memory from an allocator, 'owner()', whose
+    // 'deallocate' has no effect; memory is released all at once when the
+    // image is reset.  So, a value can be handed to a 'GlobalValue' with
+    // 'adopt(value(i), owner())' without being copied, and destroying it
+    // later is harmless, provided that this object outlives the
+    // 'GlobalValue'.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum       Datum;
+    typedef BloombergLP::bslma::Allocator  Allocator;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+    enum {
+        k_VERSION     = 2,  // format version written by 'encode'
+        k_MIN_VERSION = 1,  // oldest format version 'load' accepts
+        k_MAP_VERSION = 2,  // first format version that can hold maps
+        k_ALIGNMENT   = 8   // required alignment of an image in memory
+    };
+
+    enum Status {
+        // Enumeration used to describe the result of 'load' and 'mapFile'.
+
+        e_Success = 0,
+        e_Truncated,          // the image is shorter than it claims
+        e_BadMagic,           // the image is not a snapshot image
+        e_BadVersion,         // the format version is not supported
+        e_BadChecksum,        // the contents do not match the checksum
+        e_Malformed,          // sections or records are invalid
+        e_Misaligned,         // the image is not suitably aligned
+        e_FileError           // the file cannot be opened or mapped
+    };
+
+  private:
+    // DATA
+    const char       *d_names_p;      // name records in the image
+    const char       *d_strings_p;    // strings section of the image
+    bsl::size_t       d_numGlobals;   // number of globals
+    const Datum      *d_values_p;     // one per value record, in 'd_owner'
+    const char       *d_mapping_p;    // mapped file, if any
+    bsl::size_t       d_mappingSize;  // size of 'd_mapping_p'
+    BloombergLP::bdlma::SequentialAllocator
+                      d_owner;        // supplies the values
+
+    // NOT IMPLEMENTED
+    SnapshotImage(const SnapshotImage&);
+    SnapshotImage& operator=(const SnapshotImage&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(SnapshotImage,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CLASS METHODS
+    static int encode(bsl::vector<char>              *result,
+                      const SymbolTable&              names,
+                      const bsl::vector<GlobalValue>& globals);
+        // Load into the specified 'result' the image of the specified
+        // 'globals', each named by the symbol of 'names' whose identifier is
+        // its index.  Return 0 on success, and a non-zero value, with no
+        // effect on 'result', if a value cannot be stored (see above).  The
+        // behavior is undefined unless 'globals.size() == names.numSymbols()'.
+
+    // CREATORS
+    explicit SnapshotImage(Allocator *basicAllocator = 0);
+        // Create an object holding no image.  Optionally specify a
+        // 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.
+
+    ~SnapshotImage();
+        // Destroy this object, releasing its values and unmapping its file,
+        // if any.
+
+    // MANIPULATORS
+    int load(const char *image, bsl::size_t size);
+        // Verify the specified 'image' of the specified 'size' bytes and
+        // give access to the globals it holds, replacing any image held by
+        // this object.  Return 'e_Success' on success, and a non-zero
+        // 'Status' value, leaving this object empty, otherwise.  The behavior
+        // is undefined unless 'image' remains valid and unmodified until this
+        // object is reset, destroyed, or loads another image.
+
+    int mapFile(const char *path);
+        // Map the file at the specified 'path' into memory, read-only, and
+        // load the image it holds as if by 'load', replacing any image held
+        // by this object.  Return 'e_Success' on success, and a non-zero
+        // 'Status' value, leaving this object empty, otherwise.
+
+    Allocator *owner();
+        // Return the allocator with which the values of this image are made
+        // (see above).
+
+    void reset();
+        // Release the image held by this object, and its values, if any.
+
+    // ACCESSORS
+    bsl::size_t numGlobals() const;
+        // Return the number of globals in the image.
+
+    StringRef name(bsl::size_t index) const;
+        // Return the name of the global at the specified 'index', which
+        // refers to the image.  The behavior is undefined unless
+        // 'index < numGlobals()'.
+
+    const Datum& value(bsl::size_t index) const;
+        // Return a reference to the value of the global at the specified
+        // 'index'.  The behavior is undefined unless 'index < numGlobals()'.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                            // -------------------
+                            // class SnapshotImage
+                            // -------------------
+
+// MANIPULATORS
+inline
+BloombergLP::bslma::Allocator *SnapshotImage::owner() {
+    return &d_owner;
+}
+
+// ACCESSORS
+inline
+bsl::size_t SnapshotImage::numGlobals() const {
+    return d_numGlobals;
+}
+}
+
+#endif
@@ -0,0 +1,412 @@
+// sjtt_snapshotimage.t.cpp                                -*-C++-*-
+
+#include <sjtt_snapshotimage.h>
+
+#include <sjtt_globalvalue.h>
+#include <sjtt_imageutil.h>
+#include <sjtt_symboltable.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_cstdio.h>
+#include <bsl_cstring.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+const bsl::size_t k_CHECKSUM_OFFSET = 32;  // offset of the checksum field
+const bsl::size_t k_HEADER_SIZE     = 36;  // size of the header
+
+void fixChecksum(bsl::vector<char> *image)
+    // Store in the specified 'image' the checksum of its current contents,
+    // so that a deliberately corrupted image passes the checksum test.
+{
+    char *data = image->data();
+    const unsigned int crc = ImageUtil::crc32(
+                                    data + k_HEADER_SIZE,
+                                    image->size() - k_HEADER_SIZE,
+                                    ImageUtil::crc32(data, k_CHECKSUM_OFFSET));
+    bsl::memcpy(data + k_CHECKSUM_OFFSET, &crc, sizeof crc);
+}
+
+unsigned int readWord(const bsl::vector<char>& image, bsl::size_t offset)
+    // Return the 32-bit word at the specified 'offset' in the specified
+    // 'image'.
+{
+    unsigned int word;
+    bsl::memcpy(&word, image.data() + offset, sizeof word);
+    return word;
+}
+
+void writeWord(bsl::vector<char> *image,
+               bsl::size_t        offset,
+               unsigned int       word)
+    // Store the specified 'word' at the specified 'offset' in the specified
+    // 'image'.
+{
+    bsl::memcpy(image->data() + offset, &word, sizeof word);
+}
+
+void populate(SymbolTable *names, bsl::vector<GlobalValue> *globals)
+    // Load into the specified 'names' and 'globals' five globals covering
+    // the types of values that can be stored in an image.
+{
+    bslma::Allocator *alloc = globals->get_allocator().mechanism();
+
+    const bdld::Datum inner[] = {
+        bdld::Datum::createBoolean(true),
+        bdld::Datum::createNull(),
+    };
+    const bdld::Datum outer[] = {
+        bdld::Datum::createInteger(-1),
+        bdld::Datum::createStringRef("hello", 5, alloc),
+        bdld::Datum::createArrayReference(inner, 2, alloc),
+    };
+
+    bdld::DatumMutableMapRef map;
+    bdld::Datum::createUninitializedMap(&map, 2, alloc);
+    map.data()[0] = bdld::DatumMapEntry("size", outer[0]);
+    map.data()[1] = bdld::DatumMapEntry(
+                          "items",
+                          bdld::Datum::createArrayReference(inner, 2, alloc));
+    *map.size() = 2;
+    const bdld::Datum object = bdld::Datum::adoptMap(map);
+
+    globals->resize(5);
+    ASSERT(0 == names->intern("pi"));
+    (*globals)[0].clone(bdld::Datum::createDouble(3.25));
+    ASSERT(1 == names->intern("greeting"));
+    (*globals)[1].clone(outer[1]);
+    ASSERT(2 == names->intern("list"));
+    (*globals)[2].clone(bdld::Datum::createArrayReference(outer, 3, alloc));
+    ASSERT(3 == names->intern("undefined"));
+    (*globals)[3].clone(bdld::Datum::createUdt(0, 7));
+    ASSERT(4 == names->intern("map"));
+    (*globals)[4].clone(object);
+
+    bdld::Datum::destroy(outer[1], alloc);
+    bdld::Datum::destroy(object, alloc);
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "mapped files" << endl
+                          << "============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            SymbolTable              names(&ta);
+            bsl::vector<GlobalValue> globals(&ta);
+            populate(&names, &globals);
+            bsl::vector<char> buffer(&ta);
+            ASSERT(0 == SnapshotImage::encode(&buffer, names, globals));
+
+            const char *const PATH = "sjtt_snapshotimage.t.tmp";
+            FILE *file = bsl::fopen(PATH, "wb");
+            ASSERT(0 != file);
+            ASSERT(buffer.size() ==
+                          bsl::fwrite(buffer.data(), 1, buffer.size(), file));
+            ASSERT(0 == bsl::fclose(file));
+
+            SnapshotImage mX(&ta);  const SnapshotImage& X = mX;
+            ASSERT(0 == mX.mapFile(PATH));
+            ASSERT(5 == X.numGlobals());
+            ASSERT("greeting" == X.name(1));
+            ASSERT(globals[2].datum() == X.value(2));
+            mX.reset();
+            ASSERT(0 == X.numGlobals());
+
+            ASSERT(SnapshotImage::e_FileError ==
+                                    mX.mapFile("sjtt_snapshotimage.t.none"));
+
+            file = bsl::fopen(PATH, "wb");
+            ASSERT(0 != file);
+            ASSERT(0 == bsl::fclose(file));
+            ASSERT(SnapshotImage::e_Truncated == mX.mapFile(PATH));
+            ASSERT(0 == bsl::remove(PATH));
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "rejected images" << endl
+                          << "===============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            SymbolTable              names(&ta);
+            bsl::vector<GlobalValue> globals(&ta);
+            populate(&names, &globals);
+            bsl::vector<char> original(&ta);
+            ASSERT(0 == SnapshotImage::encode(&original, names, globals));
+
+            const bsl::size_t GLOBALS = readWord(original, 16);
+            const bsl::size_t VALUES  = readWord(original, 20);
+
+            SnapshotImage mX(&ta);  const SnapshotImage& X = mX;
+            bsl::vector<char> image(original, &ta);
+
+            ASSERT(SnapshotImage::e_Truncated ==
+                                    mX.load(image.data(), image.size() - 1));
+            ASSERT(SnapshotImage::e_Truncated ==
+                                    mX.load(image.data(), k_HEADER_SIZE - 1));
+
+            image.push_back(0);
+            bsl::memmove(image.data() + 1, image.data(), original.size());
+            ASSERT(SnapshotImage::e_Misaligned ==
+                                 mX.load(image.data() + 1, original.size()));
+
+            image = original;
+            image[0] = 'X';
+            ASSERT(SnapshotImage::e_BadMagic ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            image[4] = SnapshotImage::k_VERSION + 1;
+            ASSERT(SnapshotImage::e_BadVersion ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            image[4] = SnapshotImage::k_MIN_VERSION - 1;
+            ASSERT(SnapshotImage::e_BadVersion ==
+                                        mX.load(image.data(), image.size()));
+
+            // Images of older versions are loaded, unless they hold values
+            // those versions cannot.
+
+            image = original;
+            image[4] = SnapshotImage::k_MAP_VERSION - 1;
+            fixChecksum(&image);
+            ASSERT(SnapshotImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            {
+                bsl::vector<GlobalValue> noMaps(&ta);
+                noMaps.resize(4);
+                SymbolTable noMapNames(&ta);
+                for (int i = 0; i < 4; ++i) {
+                    noMapNames.intern(names.name(i));
+                    noMaps[i].clone(globals[i].datum());
+                }
+                ASSERT(0 == SnapshotImage::encode(&image, noMapNames, noMaps));
+                image[4] = SnapshotImage::k_MIN_VERSION;
+                fixChecksum(&image);
+                ASSERT(SnapshotImage::e_Success ==
+                                        mX.load(image.data(), image.size()));
+                ASSERT(4 == X.numGlobals());
+            }
+
+            // Any change to the contents is caught by the checksum.
+
+            for (bsl::size_t i = 0; i < original.size(); ++i) {
+                if (4 <= i && i < 6) {
+                    continue;                                     // CONTINUE
+                }
+                image = original;
+                image[i] ^= 0x10;
+                const int rc = mX.load(image.data(), image.size());
+                ASSERTV(i, rc, SnapshotImage::e_Success != rc);
+                ASSERTV(i, 0 == X.numGlobals());
+            }
+
+            // Images with a valid checksum are still checked for sanity.
+
+            image = original;
+            writeWord(&image, GLOBALS + 4, 0x10000);   // name out of bounds
+            fixChecksum(&image);
+            ASSERT(SnapshotImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            writeWord(&image, VALUES + 2 * 16 + 8, 2);  // array in itself
+            fixChecksum(&image);
+            ASSERT(SnapshotImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+            ASSERT(0 == X.numGlobals());
+
+            image = original;
+            writeWord(&image, VALUES + 2 * 16 + 4, 99);  // array too long
+            fixChecksum(&image);
+            ASSERT(SnapshotImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            writeWord(&image, VALUES + 4 * 16 + 8, 4);  // map in itself
+            fixChecksum(&image);
+            ASSERT(SnapshotImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            writeWord(&image, VALUES + 4 * 16 + 4, 5);   // map too long
+            fixChecksum(&image);
+            ASSERT(SnapshotImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            writeWord(&image, VALUES + 8 * 16, 1);       // key not a string
+            fixChecksum(&image);
+            ASSERT(SnapshotImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            writeWord(&image, VALUES, 99);               // unknown type
+            fixChecksum(&image);
+            ASSERT(SnapshotImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            writeWord(&image, 12, 3);                    // fewer values than
+            fixChecksum(&image);                         // globals
+            ASSERT(SnapshotImage::e_Malformed ==
+                                        mX.load(image.data(), image.size()));
+
+            image = original;
+            ASSERT(0 == mX.load(image.data(), image.size()));
+
+            // Values that cannot be stored are rejected by 'encode'.
+
+            int object;
+            globals[3].clone(bdld::Datum::createUdt(&object, 7));
+            ASSERT(0 != SnapshotImage::encode(&image, names, globals));
+            ASSERT(original == image);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            SymbolTable              names(&ta);
+            bsl::vector<GlobalValue> globals(&ta);
+            populate(&names, &globals);
+            bsl::vector<char> image(&ta);
+            ASSERT(0 == SnapshotImage::encode(&image, names, globals));
+
+            SnapshotImage mX(&ta);  const SnapshotImage& X = mX;
+            ASSERT(0 == X.numGlobals());
+            ASSERT(0 == mX.load(image.data(), image.size()));
+            ASSERT(5 == X.numGlobals());
+            for (int i = 0; i < 5; ++i) {
+                ASSERTV(i, names.name(i) == X.name(i));
+                ASSERTV(i, globals[i].datum() == X.value(i));
+            }
+
+            // Names, strings, and arrays refer to the image and the block of
+            // values rather than being copied.
+
+            const char *begin = image.data();
+            const char *end   = begin + image.size();
+            ASSERT(begin <= X.name(0).data() && X.name(0).data() < end);
+            const char *hello = X.value(1).theString().data();
+            ASSERT(begin <= hello && hello < end);
+            ASSERT(X.value(2).isExternalReference());
+            ASSERT(7 == X.value(3).theUdt().type());
+            ASSERT(X.value(4).isMap());
+            ASSERT(2 == X.value(4).theMap().size());
+            const char *size = X.value(4).theMap()[0].key().data();
+            ASSERT(begin <= size && size < end);
+            ASSERT(bdld::Datum::createInteger(-1) ==
+                                         *X.value(4).theMap().find("size"));
+
+            // Values can be adopted, and destroyed, harmlessly.
+
+            GlobalValue global(&ta);
+            const bsls::Types::Int64 numAllocations = ta.numAllocations();
+            global.adopt(X.value(2), mX.owner());
+            ASSERT(numAllocations == ta.numAllocations());
+            global.makeNull();
+            ASSERT(globals[2].datum() == X.value(2));
+
+            // An empty image holds no globals.
+
+            SymbolTable              noNames(&ta);
+            bsl::vector<GlobalValue> noGlobals(&ta);
+            ASSERT(0 == SnapshotImage::encode(&image, noNames, noGlobals));
+            ASSERT(0 == mX.load(image.data(), image.size()));
+            ASSERT(0 == X.numGlobals());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,47 @@
+// sjtt_symboltable.cpp
+#include <sjtt_symboltable.h>
+
+namespace sjtt {
+
+                             // -----------------
+                             // class SymbolTable
+                             // -----------------
+
+// CREATORS
+SymbolTable::SymbolTable(Allocator *basicAllocator)
+: d_ids(basicAllocator)
+, d_names(basicAllocator) {
+}
+
+// MANIPULATORS
+int SymbolTable::intern(const StringRef& name) {
+    const int found = find(name);
+    if (0 <= found) {
+        return found;                                                 // RETURN
+    }
+    const int next = numSymbols();
+    d_names.reserve(next + 1);  // so that 'push_back' below cannot throw
+    const bsl::pair<bsl::unordered_map<bsl::string, int>::iterator, bool>
+                        inserted = d_ids.insert(bsl::make_pair(
+                                     bsl::string(name.data(),
+                                                 name.length(),
+                                                 d_names.get_allocator()),
+                                     next));
+    d_names.push_back(&inserted.first->first);
+    return next;
+}
+
+void SymbolTable::clear() {
+    d_names.clear();
+    d_ids.clear();
+}
+
+// ACCESSORS
+int SymbolTable::find(const StringRef& name) const {
+    const bsl::unordered_map<bsl::string, int>::const_iterator it =
+                  d_ids.find(bsl::string(name.data(),
+                                         name.length(),
+                                         d_names.get_allocator()));
+    return d_ids.end() == it ? -1 : it->second;
+}
+}
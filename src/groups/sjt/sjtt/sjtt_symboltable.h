@@ -0,0 +1,117 @@
+// sjtt_symboltable.h
+
+#ifndef INCLUDED_SJTT_SYMBOLTABLE
+#define INCLUDED_SJTT_SYMBOLTABLE
+
+#ifndef INCLUDED_BSL_STRING
+#include <bsl_string.h>
+#endif
+
+#ifndef INCLUDED_BSL_UNORDERED_MAP
+#include <bsl_unordered_map.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                             // =================
+                             // class SymbolTable
+                             // =================
+
+class SymbolTable {
+    // This class provides a mechanism for interning names: each distinct name
+    // is stored once and identified by a small integer, assigned
+    // consecutively from 0 in the order in which names are first interned.
+    // Comparing and indexing by identifier avoids hashing and comparing
+    // strings once names have been resolved.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+  private:
+    // DATA
+    bsl::unordered_map<bsl::string, int> d_ids;    // identifier of each name
+    bsl::vector<const bsl::string *>     d_names;  // name of each identifier,
+                                                   // owned by 'd_ids'
+
+    // NOT IMPLEMENTED
+    SymbolTable(const SymbolTable&);
+    SymbolTable& operator=(const SymbolTable&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(SymbolTable,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CREATORS
+    explicit SymbolTable(Allocator *basicAllocator = 0);
+        // Create an empty symbol table.  Optionally specify a
+        // 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.
+
+    // MANIPULATORS
+    int intern(const StringRef& name);
+        // Return the identifier of the specified 'name', assigning the next
+        // identifier to it if it has not been interned before.
+
+    void clear();
+        // Remove all names from this table, so that identifiers are assigned
+        // from 0 again.
+
+    // ACCESSORS
+    int find(const StringRef& name) const;
+        // Return the identifier of the specified 'name', or -1 if it has not
+        // been interned.
+
+    const bsl::string& name(int id) const;
+        // Return a reference to the name having the specified 'id'.  The
+        // behavior is undefined unless '0 <= id < numSymbols()'.
+
+    int numSymbols() const;
+        // Return the number of names in this table.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // -----------------
+                             // class SymbolTable
+                             // -----------------
+
+// ACCESSORS
+inline
+const bsl::string& SymbolTable::name(int id) const {
+    BSLS_ASSERT_SAFE(0 <= id);
+    BSLS_ASSERT_SAFE(id < numSymbols());
+    return *d_names[id];
+}
+
+inline
+int SymbolTable::numSymbols() const {
+    return static_cast<int>(d_names.size());
+}
+}
+
+#endif
@@ -0,0 +1,127 @@
+// sjtt_symboltable.t.cpp                                  -*-C++-*-
+
+#include <sjtt_symboltable.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_string.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "names stay valid" << endl
+                          << "================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        SymbolTable table(&ta);
+        const int first = table.intern("a name longer than the short buffer");
+        const bsl::string *address = &table.name(first);
+        for (int i = 0; i < 1000; ++i) {
+            bsl::string name(&ta);
+            name.append(1, static_cast<char>('a' + i % 26));
+            name.append(i / 26 + 1, 'x');
+            ASSERTV(i, i + 1 == table.intern(name));
+        }
+        ASSERT(1001 == table.numSymbols());
+        ASSERT(address == &table.name(first));
+        ASSERT("a name longer than the short buffer" == table.name(first));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        SymbolTable table(&ta);
+        ASSERT(0 == table.numSymbols());
+        ASSERT(-1 == table.find("foo"));
+
+        ASSERT(0 == table.intern("foo"));
+        ASSERT(1 == table.intern("bar"));
+        ASSERT(0 == table.intern("foo"));
+        ASSERT(2 == table.numSymbols());
+
+        ASSERT(0 == table.find("foo"));
+        ASSERT(1 == table.find("bar"));
+        ASSERT(-1 == table.find("baz"));
+        ASSERT("foo" == table.name(0));
+        ASSERT("bar" == table.name(1));
+
+        table.clear();
+        ASSERT(0 == table.numSymbols());
+        ASSERT(-1 == table.find("foo"));
+        ASSERT(0 == table.intern("bar"));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
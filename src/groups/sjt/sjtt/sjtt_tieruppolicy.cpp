@@ -0,0 +1,14 @@
+// sjtt_tieruppolicy.cpp
+#include <sjtt_tieruppolicy.h>
+
+namespace sjtt {
+
+                             // ------------------
+                             // class TierUpPolicy
+                             // ------------------
+
+// CREATORS
+TierUpPolicy::~TierUpPolicy()
+{
+}
+}
@@ -0,0 +1,53 @@
+// sjtt_tieruppolicy.h
+
+#ifndef INCLUDED_SJTT_TIERUPPOLICY
+#define INCLUDED_SJTT_TIERUPPOLICY
+
+namespace sjtt {
+
+class Bytecode;
+class ExecutionContext;
+class LoopCounter;
+
+                             // ==================
+                             // class TierUpPolicy
+                             // ==================
+
+class TierUpPolicy {
+    // This protocol is notified when code becomes hot, so that it can decide,
+    // from actual execution counts, whether to move that code to a faster
+    // tier, e.g., to optimize it with 'sjtu::OptimizeUtil' or compile it to
+    // native code, or to stop a loop that runs for too long.  The
+    // interpreter notifies the policy installed in its context (see
+    // 'ExecutionContext::setTierUpPolicy') when the 'LoopCounter' of a loop
+    // reaches the loop threshold of the context, and an 'sjtm::Engine'
+    // notifies the policy installed in it when one of its programs has been
+    // executed its JIT threshold number of times.  Each event is notified
+    // once, when the count reaches the threshold; resetting a 'LoopCounter'
+    // makes its loop notified again when it next reaches the threshold.  A
+    // loop run by several threads at once may be notified once per thread
+    // reaching the threshold (see 'LoopCounter'), so a policy shared by
+    // threads must tolerate repeated notifications.
+
+  public:
+    // CREATORS
+    virtual ~TierUpPolicy();
+        // Destroy this object.
+
+    // MANIPULATORS
+    virtual void onHotLoop(ExecutionContext *context, LoopCounter *loop) = 0;
+        // Handle the loop counted by the specified 'loop' having become hot
+        // in the program run with the specified 'context'.  The program
+        // continues with the next iteration once this method returns, unless
+        // it sets the status of 'context' (see 'ExecutionContext::setStatus')
+        // to a non-zero value, in which case the program stops with that
+        // status, as if an external function had failed.  The behavior is
+        // undefined if that status is 'sjtu::InterpretUtil::e_Suspended'.
+
+    virtual void onHotProgram(const Bytecode *code) = 0;
+        // Handle the program beginning at the specified 'code' having become
+        // hot.
+};
+}
+
+#endif
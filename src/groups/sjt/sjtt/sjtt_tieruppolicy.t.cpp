@@ -0,0 +1,153 @@
+// sjtt_tieruppolicy.t.cpp                                -*-C++-*-
+
+#include <sjtt_tieruppolicy.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_executioncontext.h>
+#include <sjtt_loopcounter.h>
+
+#include <bdlma_localsequentialallocator.h>
+#include <bdls_testutil.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+// ============================================================================
+//                       GLOBAL TEST CLASSES AND FUNCTIONS
+// ----------------------------------------------------------------------------
+
+namespace {
+
+class TestPolicy : public TierUpPolicy {
+    // This class records the events it is notified of, and sets the status of
+    // the context of a hot loop to its stop status.
+
+  public:
+    // DATA
+    int             d_numHotLoops;
+    int             d_numHotPrograms;
+    LoopCounter    *d_lastLoop_p;
+    const Bytecode *d_lastProgram_p;
+    int             d_stopStatus;
+
+    // CREATORS
+    TestPolicy()
+    : d_numHotLoops(0)
+    , d_numHotPrograms(0)
+    , d_lastLoop_p(0)
+    , d_lastProgram_p(0)
+    , d_stopStatus(0)
+    {
+    }
+
+    // MANIPULATORS
+    void onHotLoop(ExecutionContext *context, LoopCounter *loop)
+    {
+        ++d_numHotLoops;
+        d_lastLoop_p = loop;
+        context->setStatus(d_stopStatus);
+    }
+
+    void onHotProgram(const Bytecode *code)
+    {
+        ++d_numHotPrograms;
+        d_lastProgram_p = code;
+    }
+};
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        TestPolicy    mX;
+        TierUpPolicy& policy = mX;
+
+        bdlma::LocalSequentialAllocator<256> alloc;
+        bsl::vector<bdld::Datum>             stack;
+        ExecutionContext                     context(&alloc, &stack);
+        LoopCounter      loop;
+
+        policy.onHotLoop(&context, &loop);
+        ASSERT(1     == mX.d_numHotLoops);
+        ASSERT(&loop == mX.d_lastLoop_p);
+        ASSERT(0     == context.status());
+
+        mX.d_stopStatus = 3;
+        policy.onHotLoop(&context, &loop);
+        ASSERT(2 == mX.d_numHotLoops);
+        ASSERT(3 == context.status());
+
+        const Bytecode code = Bytecode::createOpcode(Bytecode::e_Return);
+        policy.onHotProgram(&code);
+        ASSERT(1     == mX.d_numHotPrograms);
+        ASSERT(&code == mX.d_lastProgram_p);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
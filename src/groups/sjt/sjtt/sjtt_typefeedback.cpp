@@ -0,0 +1,25 @@
+// sjtt_typefeedback.cpp
+#include <sjtt_typefeedback.h>
+
+namespace sjtt {
+
+                             // ------------------
+                             // class TypeFeedback
+                             // ------------------
+
+// CLASS METHODS
+const char *TypeFeedback::toAscii(Kind kind) {
+#define CASE(NAME) case e_##NAME: return #NAME;
+
+    switch (kind) {
+      CASE(Integer)
+      CASE(Overflow)
+      CASE(Double)
+      CASE(Other)
+    }
+
+#undef CASE
+
+    return "(* UNKNOWN *)";
+}
+}
@@ -0,0 +1,136 @@
+// sjtt_typefeedback.h
+
+#ifndef INCLUDED_SJTT_TYPEFEEDBACK
+#define INCLUDED_SJTT_TYPEFEEDBACK
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ATOMIC
+#include <bsls_atomic.h>
+#endif
+
+namespace sjtt {
+
+                             // ==================
+                             // class TypeFeedback
+                             // ==================
+
+class TypeFeedback {
+    // This class provides the type-feedback slot of an arithmetic
+    // instruction: the set of the kinds of operands it has seen, e.g.,
+    // whether its operands were always integers whose result fitted in an
+    // 'int'.  The instruction records the kind of each operation it
+    // performs, so that a later tier can pick the form of the instruction
+    // specialized for the kinds it has seen.  A slot may be used by
+    // several threads at once, e.g., by the workers of an 'sjtm::Executor'
+    // running the same program: its kinds are held in an atomic integer,
+    // which 'record' only loads, with relaxed ordering, once the kind is
+    // recorded, so that recording costs a plain load in the steady state.
+
+  public:
+    // TYPES
+    enum Kind {
+        // Enumeration used to describe the operands of an arithmetic
+        // operation.  Each enumerator is a distinct bit of 'kinds()'.
+
+        e_Integer  = 1 << 0,  // integers, with an integer result
+        e_Overflow = 1 << 1,  // integers, with a result promoted to double
+        e_Double   = 1 << 2,  // numbers, at least one of them a double
+        e_Other    = 1 << 3   // an operand that is not a number
+    };
+
+  private:
+    // DATA
+    BloombergLP::bsls::AtomicInt d_kinds;  // bitwise or of the 'Kind'
+                                           // values recorded
+
+    // NOT IMPLEMENTED
+    TypeFeedback(const TypeFeedback&);
+    TypeFeedback& operator=(const TypeFeedback&);
+
+  public:
+    // CLASS METHODS
+    static const char *toAscii(Kind kind);
+        // Return the non-modifiable string representation of the name of the
+        // specified 'kind', without its 'e_' prefix, e.g., "Overflow" for
+        // 'e_Overflow', or "(* UNKNOWN *)" if 'kind' is not a 'Kind'.
+
+    // CREATORS
+    TypeFeedback();
+        // Create a slot having seen no operation.
+
+    // MANIPULATORS
+    void record(Kind kind);
+        // Record that an operation on operands of the specified 'kind' was
+        // performed.
+
+    void reset();
+        // Forget every operation recorded.
+
+    // ACCESSORS
+    bool hasOnly(Kind kind) const;
+        // Return 'true' if the operations recorded were all of the specified
+        // 'kind', and at least one was, and 'false' otherwise.
+
+    bool hasSeen(Kind kind) const;
+        // Return 'true' if an operation of the specified 'kind' was
+        // recorded, and 'false' otherwise.
+
+    int kinds() const;
+        // Return the bitwise or of the kinds of the operations recorded, or
+        // 0 if none was.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // ------------------
+                             // class TypeFeedback
+                             // ------------------
+
+// CREATORS
+inline
+TypeFeedback::TypeFeedback()
+: d_kinds(0)
+{
+}
+
+// MANIPULATORS
+inline
+void TypeFeedback::record(Kind kind) {
+    int kinds = d_kinds.loadRelaxed();
+    while (0 == (kinds & kind)) {
+        const int previous = d_kinds.testAndSwap(kinds, kinds | kind);
+        if (previous == kinds) {
+            return;                                                   // RETURN
+        }
+        kinds = previous;
+    }
+}
+
+inline
+void TypeFeedback::reset() {
+    d_kinds.storeRelaxed(0);
+}
+
+// ACCESSORS
+inline
+bool TypeFeedback::hasOnly(Kind kind) const {
+    return kind == d_kinds.loadRelaxed();
+}
+
+inline
+bool TypeFeedback::hasSeen(Kind kind) const {
+    return 0 != (d_kinds.loadRelaxed() & kind);
+}
+
+inline
+int TypeFeedback::kinds() const {
+    return d_kinds.loadRelaxed();
+}
+}
+
+#endif
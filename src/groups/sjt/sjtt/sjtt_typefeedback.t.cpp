@@ -0,0 +1,180 @@
+// sjtt_typefeedback.t.cpp                                -*-C++-*-
+
+#include <sjtt_typefeedback.h>
+
+#include <bdls_testutil.h>
+#include <bslmt_threadutil.h>
+
+#include <bsl_cstring.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+struct Recorder {
+    // This 'struct' records one kind into a slot many times, as one of
+    // several threads running the same instruction.
+
+    // DATA
+    TypeFeedback       *d_feedback_p;  // slot to record into
+    TypeFeedback::Kind  d_kind;        // kind to record
+
+    // MANIPULATORS
+    void operator()() {
+        for (int i = 0; i < 10000; ++i) {
+            d_feedback_p->record(d_kind);
+        }
+    }
+};
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "concurrent recording" << endl
+                          << "====================" << endl;
+
+        // Every kind recorded by threads sharing a slot is kept.
+
+        const TypeFeedback::Kind KINDS[] = {
+            TypeFeedback::e_Integer,
+            TypeFeedback::e_Overflow,
+            TypeFeedback::e_Double,
+            TypeFeedback::e_Other,
+        };
+        enum { k_NUM_THREADS = sizeof KINDS / sizeof *KINDS };
+
+        for (int round = 0; round < 20; ++round) {
+            TypeFeedback              feedback;
+            bslmt::ThreadUtil::Handle handles[k_NUM_THREADS];
+            for (int i = 0; i < k_NUM_THREADS; ++i) {
+                const Recorder recorder = { &feedback, KINDS[i] };
+                ASSERT(0 == bslmt::ThreadUtil::create(&handles[i],
+                                                      recorder));
+            }
+            for (int i = 0; i < k_NUM_THREADS; ++i) {
+                ASSERT(0 == bslmt::ThreadUtil::join(handles[i]));
+            }
+            ASSERTV(round, feedback.kinds(), 0xF == feedback.kinds());
+        }
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "toAscii" << endl
+                          << "=======" << endl;
+
+        ASSERT(0 == strcmp("Integer",
+                           TypeFeedback::toAscii(TypeFeedback::e_Integer)));
+        ASSERT(0 == strcmp("Overflow",
+                           TypeFeedback::toAscii(TypeFeedback::e_Overflow)));
+        ASSERT(0 == strcmp("Other",
+                           TypeFeedback::toAscii(TypeFeedback::e_Other)));
+        ASSERT(0 == strcmp("(* UNKNOWN *)",
+                           TypeFeedback::toAscii(
+                                   static_cast<TypeFeedback::Kind>(0))));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        TypeFeedback feedback;
+        ASSERT(0 == feedback.kinds());
+        ASSERT(!feedback.hasSeen(TypeFeedback::e_Integer));
+        ASSERT(!feedback.hasOnly(TypeFeedback::e_Integer));
+
+        feedback.record(TypeFeedback::e_Integer);
+        feedback.record(TypeFeedback::e_Integer);
+        ASSERT(TypeFeedback::e_Integer == feedback.kinds());
+        ASSERT( feedback.hasSeen(TypeFeedback::e_Integer));
+        ASSERT( feedback.hasOnly(TypeFeedback::e_Integer));
+        ASSERT(!feedback.hasSeen(TypeFeedback::e_Overflow));
+
+        feedback.record(TypeFeedback::e_Overflow);
+        ASSERT( feedback.hasSeen(TypeFeedback::e_Integer));
+        ASSERT( feedback.hasSeen(TypeFeedback::e_Overflow));
+        ASSERT(!feedback.hasOnly(TypeFeedback::e_Integer));
+        ASSERT(!feedback.hasSeen(TypeFeedback::e_Double));
+        ASSERT((TypeFeedback::e_Integer | TypeFeedback::e_Overflow) ==
+                                                          feedback.kinds());
+
+        feedback.reset();
+        ASSERT(0 == feedback.kinds());
+
+        feedback.record(TypeFeedback::e_Double);
+        ASSERT( feedback.hasOnly(TypeFeedback::e_Double));
+        feedback.record(TypeFeedback::e_Other);
+        ASSERT(!feedback.hasOnly(TypeFeedback::e_Double));
+        ASSERT( feedback.hasSeen(TypeFeedback::e_Other));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,4 @@
+// sjtt_workdeque.cpp
+#include <sjtt_workdeque.h>
+
+// This component is implemented entirely in its header.
@@ -0,0 +1,248 @@
+// sjtt_workdeque.h
+
+#ifndef INCLUDED_SJTT_WORKDEQUE
+#define INCLUDED_SJTT_WORKDEQUE
+
+#ifndef INCLUDED_BSLMA_DEFAULT
+#include <bslma_default.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ATOMIC
+#include <bsls_atomic.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_NEW
+#include <bsl_new.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                              // ===============
+                              // class WorkDeque
+                              // ===============
+
+template <class TYPE>
+class WorkDeque {
+    // This class provides a bounded, lock-free, work-stealing deque of
+    // pointers to 'TYPE' (Chase and Lev, "Dynamic Circular Work-Stealing
+    // Deque", 2005).  The deque has one owner thread, which pushes and pops
+    // items at the bottom, in LIFO order, without contention, and any number
+    // of thief threads, which steal items from the top, in FIFO order, with
+    // one compare-and-swap each.  The capacity is fixed at construction, so
+    // that the deque never allocates once created; 'push' fails when it is
+    // full, and the owner is expected to put the item elsewhere, e.g., on a
+    // shared queue.
+    //
+    // 'push' and 'pop' may be called only by the owner thread; 'steal',
+    // 'isEmpty', and 'size' may be called by any thread.
+
+    // PRIVATE TYPES
+    typedef BloombergLP::bsls::AtomicPointer<TYPE> Slot;
+    typedef BloombergLP::bsls::Types::Int64        Int64;
+
+    // DATA
+    BloombergLP::bsls::AtomicInt64  d_top;          // next item to steal
+    BloombergLP::bsls::AtomicInt64  d_bottom;       // next slot to push to
+    Slot                           *d_slots_p;      // circular buffer
+    Int64                           d_mask;         // capacity - 1
+    BloombergLP::bslma::Allocator  *d_allocator_p;  // memory allocator (held)
+
+    // NOT IMPLEMENTED
+    WorkDeque(const WorkDeque&);
+    WorkDeque& operator=(const WorkDeque&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(WorkDeque,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CREATORS
+    explicit WorkDeque(bsl::size_t                    capacity,
+                       BloombergLP::bslma::Allocator *basicAllocator = 0);
+        // Create an empty deque able to hold at least the specified
+        // 'capacity' items; the capacity is rounded up to a power of two.
+        // Optionally specify a 'basicAllocator' used to supply memory.  If
+        // 'basicAllocator' is 0, the currently installed default allocator is
+        // used.  The behavior is undefined unless '0 < capacity'.
+
+    ~WorkDeque();
+        // Destroy this deque.  Items still in it are not affected.
+
+    // MANIPULATORS
+    int push(TYPE *item);
+        // Add the specified 'item' to the bottom of this deque.  Return 0 on
+        // success, and a non-zero value, with no effect, if the deque is
+        // full.  The behavior is undefined unless this method is called by
+        // the owner thread and '0 != item'.
+
+    TYPE *pop();
+        // Remove the item at the bottom of this deque, i.e., the one most
+        // recently pushed, and return it, or return 0 if the deque is empty
+        // or its last item was stolen concurrently.  The behavior is
+        // undefined unless this method is called by the owner thread.
+
+    TYPE *steal();
+        // Remove the item at the top of this deque, i.e., the one least
+        // recently pushed, and return it, or return 0 if the deque is empty
+        // or the item was taken concurrently by another thread, in which case
+        // the caller may retry.
+
+    // ACCESSORS
+    bsl::size_t capacity() const;
+        // Return the number of items this deque can hold.
+
+    bool isEmpty() const;
+        // Return 'true' if this deque held no items at some point during the
+        // call, and 'false' otherwise.
+
+    bsl::size_t size() const;
+        // Return the number of items in this deque at some point during the
+        // call.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                              // ---------------
+                              // class WorkDeque
+                              // ---------------
+
+// CREATORS
+template <class TYPE>
+WorkDeque<TYPE>::WorkDeque(bsl::size_t                    capacity,
+                           BloombergLP::bslma::Allocator *basicAllocator)
+: d_top(0)
+, d_bottom(0)
+, d_slots_p(0)
+, d_mask(0)
+, d_allocator_p(BloombergLP::bslma::Default::allocator(basicAllocator))
+{
+    BSLS_ASSERT(0 < capacity);
+
+    bsl::size_t size = 1;
+    while (size < capacity) {
+        size *= 2;
+    }
+    d_slots_p = static_cast<Slot *>(
+                                 d_allocator_p->allocate(size * sizeof(Slot)));
+    for (bsl::size_t i = 0; i < size; ++i) {
+        new (d_slots_p + i) Slot(0);
+    }
+    d_mask = static_cast<Int64>(size) - 1;
+}
+
+template <class TYPE>
+WorkDeque<TYPE>::~WorkDeque()
+{
+    // 'Slot' is trivially destructible.
+
+    d_allocator_p->deallocate(d_slots_p);
+}
+
+// MANIPULATORS
+template <class TYPE>
+inline
+int WorkDeque<TYPE>::push(TYPE *item)
+{
+    BSLS_ASSERT_SAFE(0 != item);
+
+    const Int64 bottom = d_bottom.loadRelaxed();
+    const Int64 top    = d_top.loadAcquire();
+    if (bottom - top > d_mask) {
+        return 1;                                                     // RETURN
+    }
+    d_slots_p[bottom & d_mask].storeRelaxed(item);
+    d_bottom.storeRelease(bottom + 1);
+    return 0;
+}
+
+template <class TYPE>
+inline
+TYPE *WorkDeque<TYPE>::pop()
+{
+    // Claim the bottom item before looking at the top, so that a thief
+    // either sees the claim or is seen by the owner; both accesses are
+    // sequentially consistent for this reason.
+
+    const Int64 bottom = d_bottom.loadRelaxed() - 1;
+    d_bottom.store(bottom);
+    const Int64 top = d_top.load();
+    if (top > bottom) {
+        d_bottom.storeRelaxed(bottom + 1);
+        return 0;                                                     // RETURN
+    }
+    TYPE *item = d_slots_p[bottom & d_mask].loadRelaxed();
+    if (top == bottom) {
+        // This is the last item, which thieves may be stealing too.
+
+        if (top != d_top.testAndSwap(top, top + 1)) {
+            item = 0;
+        }
+        d_bottom.storeRelaxed(bottom + 1);
+    }
+    return item;
+}
+
+template <class TYPE>
+inline
+TYPE *WorkDeque<TYPE>::steal()
+{
+    const Int64 top    = d_top.load();
+    const Int64 bottom = d_bottom.load();
+    if (top >= bottom) {
+        return 0;                                                     // RETURN
+    }
+    TYPE *item = d_slots_p[top & d_mask].loadRelaxed();
+    if (top != d_top.testAndSwap(top, top + 1)) {
+        return 0;                                                     // RETURN
+    }
+    return item;
+}
+
+// ACCESSORS
+template <class TYPE>
+inline
+bsl::size_t WorkDeque<TYPE>::capacity() const
+{
+    return static_cast<bsl::size_t>(d_mask + 1);
+}
+
+template <class TYPE>
+inline
+bool WorkDeque<TYPE>::isEmpty() const
+{
+    return 0 == size();
+}
+
+template <class TYPE>
+inline
+bsl::size_t WorkDeque<TYPE>::size() const
+{
+    const Int64 bottom = d_bottom.load();
+    const Int64 top    = d_top.load();
+    return bottom > top ? static_cast<bsl::size_t>(bottom - top) : 0;
+}
+}
+
+#endif
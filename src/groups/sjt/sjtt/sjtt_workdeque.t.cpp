@@ -0,0 +1,253 @@
+// sjtt_workdeque.t.cpp                                    -*-C++-*-
+
+#include <sjtt_workdeque.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+#include <bslmt_threadutil.h>
+#include <bsls_atomic.h>
+
+#include <bsl_functional.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef WorkDeque<int> Obj;
+
+struct Thief {
+    // This 'struct' steals items from a deque until told to stop, counting
+    // how many times it took each item.
+
+    // DATA
+    Obj                     *d_deque_p;    // deque to steal from
+    bsls::AtomicInt         *d_counts_p;   // times each item was taken
+    int                     *d_items_p;    // address of item 0
+    const bsls::AtomicBool  *d_done_p;     // set when the owner is done
+    int                      d_numStolen;  // items stolen
+
+    // MANIPULATORS
+    void operator()() {
+        while (true) {
+            const bool done = d_done_p->load();
+            int *item = d_deque_p->steal();
+            if (item) {
+                d_counts_p[item - d_items_p].add(1);
+                ++d_numStolen;
+            }
+            else if (done && d_deque_p->isEmpty()) {
+                return;                                               // RETURN
+            }
+        }
+    }
+};
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "concurrent stealing" << endl
+                          << "===================" << endl;
+
+        // The owner pushes and pops while thieves steal; every item must be
+        // taken exactly once, in particular the last item of the deque,
+        // which the owner and the thieves race for.
+
+        enum { k_NUM_ITEMS = 200000, k_NUM_THIEVES = 3 };
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            bsl::vector<int> items(k_NUM_ITEMS, 0, &ta);
+            bsls::AtomicInt *counts = new bsls::AtomicInt[k_NUM_ITEMS];
+            bsls::AtomicBool done(false);
+
+            Obj mX(64, &ta);
+            Thief thieves[k_NUM_THIEVES];
+            bslmt::ThreadUtil::Handle handles[k_NUM_THIEVES];
+            for (int i = 0; i < k_NUM_THIEVES; ++i) {
+                Thief thief = { &mX, counts, items.data(), &done, 0 };
+                thieves[i] = thief;
+                ASSERT(0 == bslmt::ThreadUtil::create(&handles[i],
+                                                      bsl::ref(thieves[i])));
+            }
+
+            int numPopped = 0;
+            for (int i = 0; i < k_NUM_ITEMS; ++i) {
+                while (0 != mX.push(&items[i])) {
+                    int *item = mX.pop();
+                    if (item) {
+                        counts[item - items.data()].add(1);
+                        ++numPopped;
+                    }
+                }
+                if (0 == i % 3) {
+                    int *item = mX.pop();
+                    if (item) {
+                        counts[item - items.data()].add(1);
+                        ++numPopped;
+                    }
+                }
+            }
+            done.store(true);
+            for (int i = 0; i < k_NUM_THIEVES; ++i) {
+                ASSERT(0 == bslmt::ThreadUtil::join(handles[i]));
+            }
+
+            int numTaken = numPopped;
+            for (int i = 0; i < k_NUM_THIEVES; ++i) {
+                numTaken += thieves[i].d_numStolen;
+            }
+            ASSERTV(numTaken, k_NUM_ITEMS == numTaken);
+            for (int i = 0; i < k_NUM_ITEMS; ++i) {
+                ASSERTV(i, counts[i].load(), 1 == counts[i].load());
+            }
+            if (verbose) {
+                P(numPopped);
+            }
+            delete [] counts;
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "capacity" << endl
+                          << "========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            Obj mX(5, &ta);  const Obj& X = mX;
+            ASSERT(8 == X.capacity());
+
+            int items[9];
+            for (int i = 0; i < 8; ++i) {
+                ASSERTV(i, 0 == mX.push(&items[i]));
+            }
+            ASSERT(0 != mX.push(&items[8]));
+            ASSERT(8 == X.size());
+
+            // Stealing makes room, and the buffer wraps around.
+
+            for (int round = 0; round < 20; ++round) {
+                ASSERTV(round, &items[round % 9] == mX.steal());
+                ASSERTV(round, 0 == mX.push(&items[(round + 8) % 9]));
+                ASSERTV(round, 0 != mX.push(&items[0]));
+            }
+            ASSERT(8 == X.size());
+            for (int i = 0; i < 8; ++i) {
+                ASSERTV(i, 0 != mX.pop());
+            }
+            ASSERT(X.isEmpty());
+
+            Obj mY(1, &ta);
+            ASSERT(1 == mY.capacity());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            Obj mX(16, &ta);  const Obj& X = mX;
+            ASSERT(16 == X.capacity());
+            ASSERT(X.isEmpty());
+            ASSERT(0 == mX.pop());
+            ASSERT(0 == mX.steal());
+
+            int items[4];
+            for (int i = 0; i < 4; ++i) {
+                ASSERTV(i, 0 == mX.push(&items[i]));
+            }
+            ASSERT(4 == X.size());
+
+            // The owner takes the newest item, and thieves the oldest.
+
+            ASSERT(&items[3] == mX.pop());
+            ASSERT(&items[0] == mX.steal());
+            ASSERT(&items[1] == mX.steal());
+            ASSERT(&items[2] == mX.pop());
+            ASSERT(X.isEmpty());
+            ASSERT(0 == mX.pop());
+            ASSERT(0 == mX.steal());
+            ASSERT(X.isEmpty());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,627 @@
+// sjtu_arrayutil.cpp
+#include <sjtu_arrayutil.h>
+
+#include <bslma_allocator.h>
+#include <bsls_assert.h>
+#include <bsls_atomic.h>
+#include <bsls_performancehint.h>
+#include <bsls_platform.h>
+
+#include <bsl_algorithm.h>
+
+#if defined(BSLS_PLATFORM_CPU_X86_64)                                         \
+ && (defined(BSLS_PLATFORM_CMP_GNU) || defined(BSLS_PLATFORM_CMP_CLANG))
+#define SJTU_ARRAYUTIL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sjtu {
+using BloombergLP::bdld::Datum;
+using BloombergLP::bdld::DatumArrayRef;
+using BloombergLP::bdld::DatumMutableArrayRef;
+
+namespace {
+
+enum {
+    k_CHUNK_LENGTH = 128,  // doubles unboxed at a time
+    k_MAX_OPERANDS = 3,
+    k_NUM_LANES    = 4     // partial sums of 'sum' and 'dot'
+};
+
+struct Kernels {
+    // This 'struct' holds one implementation of the kernels.
+
+    ArrayUtil::Isa   d_isa;
+    void           (*d_add)(double *, const double *, const double *,
+                            bsl::size_t);
+    void           (*d_multiply)(double *, const double *, const double *,
+                                 bsl::size_t);
+    void           (*d_multiplyAdd)(double *, const double *, const double *,
+                                    const double *, bsl::size_t);
+    double         (*d_sum)(const double *, bsl::size_t);
+    double         (*d_dot)(const double *, const double *, bsl::size_t);
+};
+
+                              // --------------
+                              // scalar kernels
+                              // --------------
+
+void addScalar(double       *result,
+               const double *lhs,
+               const double *rhs,
+               bsl::size_t   length)
+{
+    for (bsl::size_t i = 0; i < length; ++i) {
+        result[i] = lhs[i] + rhs[i];
+    }
+}
+
+void multiplyScalar(double       *result,
+                    const double *lhs,
+                    const double *rhs,
+                    bsl::size_t   length)
+{
+    for (bsl::size_t i = 0; i < length; ++i) {
+        result[i] = lhs[i] * rhs[i];
+    }
+}
+
+void multiplyAddScalar(double       *result,
+                       const double *lhs,
+                       const double *rhs,
+                       const double *addend,
+                       bsl::size_t   length)
+{
+    for (bsl::size_t i = 0; i < length; ++i) {
+        result[i] = lhs[i] * rhs[i] + addend[i];
+    }
+}
+
+// 'sum' and 'dot' accumulate element 'i' into partial sum 'i % 4', for as
+// many whole groups of 4 elements as there are, add the partial sums
+// pairwise, and then add the remaining elements in order.  Every
+// implementation follows this order, so that all return the same bits.
+
+double finishSum(const double *lanes, const double *values, bsl::size_t length)
+    // Return the sum of the 'k_NUM_LANES' specified 'lanes' and of the
+    // specified 'length' remaining 'values', in the order described above.
+{
+    double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (bsl::size_t i = 0; i < length; ++i) {
+        result += values[i];
+    }
+    return result;
+}
+
+double finishDot(const double *lanes,
+                 const double *lhs,
+                 const double *rhs,
+                 bsl::size_t   length)
+    // Return the sum of the 'k_NUM_LANES' specified 'lanes' and of the
+    // products of the specified 'length' remaining elements of the specified
+    // 'lhs' and 'rhs', in the order described above.
+{
+    double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (bsl::size_t i = 0; i < length; ++i) {
+        result += lhs[i] * rhs[i];
+    }
+    return result;
+}
+
+double sumScalar(const double *values, bsl::size_t length)
+{
+    double      lanes[k_NUM_LANES] = { 0, 0, 0, 0 };
+    bsl::size_t i                  = 0;
+    for (; i + k_NUM_LANES <= length; i += k_NUM_LANES) {
+        for (int j = 0; j < k_NUM_LANES; ++j) {
+            lanes[j] += values[i + j];
+        }
+    }
+    return finishSum(lanes, values + i, length - i);
+}
+
+double dotScalar(const double *lhs, const double *rhs, bsl::size_t length)
+{
+    double      lanes[k_NUM_LANES] = { 0, 0, 0, 0 };
+    bsl::size_t i                  = 0;
+    for (; i + k_NUM_LANES <= length; i += k_NUM_LANES) {
+        for (int j = 0; j < k_NUM_LANES; ++j) {
+            lanes[j] += lhs[i + j] * rhs[i + j];
+        }
+    }
+    return finishDot(lanes, lhs + i, rhs + i, length - i);
+}
+
+const Kernels k_SCALAR = {
+    ArrayUtil::e_Scalar,
+    &addScalar,
+    &multiplyScalar,
+    &multiplyAddScalar,
+    &sumScalar,
+    &dotScalar
+};
+
+#ifdef SJTU_ARRAYUTIL_X86
+
+                               // ------------
+                               // SSE2 kernels
+                               // ------------
+
+void addSse2(double       *result,
+             const double *lhs,
+             const double *rhs,
+             bsl::size_t   length)
+{
+    bsl::size_t i = 0;
+    for (; i + 2 <= length; i += 2) {
+        _mm_storeu_pd(result + i, _mm_add_pd(_mm_loadu_pd(lhs + i),
+                                             _mm_loadu_pd(rhs + i)));
+    }
+    addScalar(result + i, lhs + i, rhs + i, length - i);
+}
+
+void multiplySse2(double       *result,
+                  const double *lhs,
+                  const double *rhs,
+                  bsl::size_t   length)
+{
+    bsl::size_t i = 0;
+    for (; i + 2 <= length; i += 2) {
+        _mm_storeu_pd(result + i, _mm_mul_pd(_mm_loadu_pd(lhs + i),
+                                             _mm_loadu_pd(rhs + i)));
+    }
+    multiplyScalar(result + i, lhs + i, rhs + i, length - i);
+}
+
+void multiplyAddSse2(double       *result,
+                     const double *lhs,
+                     const double *rhs,
+                     const double *addend,
+                     bsl::size_t   length)
+{
+    bsl::size_t i = 0;
+    for (; i + 2 <= length; i += 2) {
+        const __m128d product = _mm_mul_pd(_mm_loadu_pd(lhs + i),
+                                           _mm_loadu_pd(rhs + i));
+        _mm_storeu_pd(result + i,
+                      _mm_add_pd(product, _mm_loadu_pd(addend + i)));
+    }
+    multiplyAddScalar(result + i, lhs + i, rhs + i, addend + i, length - i);
+}
+
+double sumSse2(const double *values, bsl::size_t length)
+{
+    __m128d     low  = _mm_setzero_pd();  // lanes 0 and 1
+    __m128d     high = _mm_setzero_pd();  // lanes 2 and 3
+    bsl::size_t i    = 0;
+    for (; i + k_NUM_LANES <= length; i += k_NUM_LANES) {
+        low  = _mm_add_pd(low,  _mm_loadu_pd(values + i));
+        high = _mm_add_pd(high, _mm_loadu_pd(values + i + 2));
+    }
+    double lanes[k_NUM_LANES];
+    _mm_storeu_pd(lanes,     low);
+    _mm_storeu_pd(lanes + 2, high);
+    return finishSum(lanes, values + i, length - i);
+}
+
+double dotSse2(const double *lhs, const double *rhs, bsl::size_t length)
+{
+    __m128d     low  = _mm_setzero_pd();  // lanes 0 and 1
+    __m128d     high = _mm_setzero_pd();  // lanes 2 and 3
+    bsl::size_t i    = 0;
+    for (; i + k_NUM_LANES <= length; i += k_NUM_LANES) {
+        low  = _mm_add_pd(low,  _mm_mul_pd(_mm_loadu_pd(lhs + i),
+                                           _mm_loadu_pd(rhs + i)));
+        high = _mm_add_pd(high, _mm_mul_pd(_mm_loadu_pd(lhs + i + 2),
+                                           _mm_loadu_pd(rhs + i + 2)));
+    }
+    double lanes[k_NUM_LANES];
+    _mm_storeu_pd(lanes,     low);
+    _mm_storeu_pd(lanes + 2, high);
+    return finishDot(lanes, lhs + i, rhs + i, length - i);
+}
+
+const Kernels k_SSE2 = {
+    ArrayUtil::e_Sse2,
+    &addSse2,
+    &multiplySse2,
+    &multiplyAddSse2,
+    &sumSse2,
+    &dotSse2
+};
+
+                               // ------------
+                               // AVX2 kernels
+                               // ------------
+
+// These kernels are compiled for AVX2 regardless of the flags of the build,
+// and are only called once the CPU is known to support it.  They do not use
+// fused multiply-add, which would round differently from the other kernels.
+
+#define SJTU_ARRAYUTIL_AVX2 __attribute__((target("avx2")))
+
+SJTU_ARRAYUTIL_AVX2
+void addAvx2(double       *result,
+             const double *lhs,
+             const double *rhs,
+             bsl::size_t   length)
+{
+    bsl::size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        _mm256_storeu_pd(result + i, _mm256_add_pd(_mm256_loadu_pd(lhs + i),
+                                                   _mm256_loadu_pd(rhs + i)));
+    }
+    addScalar(result + i, lhs + i, rhs + i, length - i);
+}
+
+SJTU_ARRAYUTIL_AVX2
+void multiplyAvx2(double       *result,
+                  const double *lhs,
+                  const double *rhs,
+                  bsl::size_t   length)
+{
+    bsl::size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        _mm256_storeu_pd(result + i, _mm256_mul_pd(_mm256_loadu_pd(lhs + i),
+                                                   _mm256_loadu_pd(rhs + i)));
+    }
+    multiplyScalar(result + i, lhs + i, rhs + i, length - i);
+}
+
+SJTU_ARRAYUTIL_AVX2
+void multiplyAddAvx2(double       *result,
+                     const double *lhs,
+                     const double *rhs,
+                     const double *addend,
+                     bsl::size_t   length)
+{
+    bsl::size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        const __m256d product = _mm256_mul_pd(_mm256_loadu_pd(lhs + i),
+                                              _mm256_loadu_pd(rhs + i));
+        _mm256_storeu_pd(result + i,
+                         _mm256_add_pd(product, _mm256_loadu_pd(addend + i)));
+    }
+    multiplyAddScalar(result + i, lhs + i, rhs + i, addend + i, length - i);
+}
+
+SJTU_ARRAYUTIL_AVX2
+double sumAvx2(const double *values, bsl::size_t length)
+{
+    __m256d     total = _mm256_setzero_pd();
+    bsl::size_t i     = 0;
+    for (; i + k_NUM_LANES <= length; i += k_NUM_LANES) {
+        total = _mm256_add_pd(total, _mm256_loadu_pd(values + i));
+    }
+    double lanes[k_NUM_LANES];
+    _mm256_storeu_pd(lanes, total);
+    return finishSum(lanes, values + i, length - i);
+}
+
+SJTU_ARRAYUTIL_AVX2
+double dotAvx2(const double *lhs, const double *rhs, bsl::size_t length)
+{
+    __m256d     total = _mm256_setzero_pd();
+    bsl::size_t i     = 0;
+    for (; i + k_NUM_LANES <= length; i += k_NUM_LANES) {
+        total = _mm256_add_pd(total, _mm256_mul_pd(_mm256_loadu_pd(lhs + i),
+                                                   _mm256_loadu_pd(rhs + i)));
+    }
+    double lanes[k_NUM_LANES];
+    _mm256_storeu_pd(lanes, total);
+    return finishDot(lanes, lhs + i, rhs + i, length - i);
+}
+
+#undef SJTU_ARRAYUTIL_AVX2
+
+const Kernels k_AVX2 = {
+    ArrayUtil::e_Avx2,
+    &addAvx2,
+    &multiplyAvx2,
+    &multiplyAddAvx2,
+    &sumAvx2,
+    &dotAvx2
+};
+
+#endif  // SJTU_ARRAYUTIL_X86
+
+                             // ----------------
+                             // kernel selection
+                             // ----------------
+
+const Kernels *select(ArrayUtil::Isa isa)
+    // Return the widest implementation of the kernels, no wider than the
+    // specified 'isa', supported by the CPU.
+{
+#ifdef SJTU_ARRAYUTIL_X86
+    if (ArrayUtil::e_Avx2 <= isa && __builtin_cpu_supports("avx2")) {
+        return &k_AVX2;                                               // RETURN
+    }
+    if (ArrayUtil::e_Sse2 <= isa) {
+        // SSE2 is part of the x86-64 baseline.
+
+        return &k_SSE2;                                               // RETURN
+    }
+#else
+    (void)isa;
+#endif
+    return &k_SCALAR;
+}
+
+BloombergLP::bsls::AtomicPointer<const Kernels>& kernels()
+    // Return a reference to the pointer to the implementation of the kernels
+    // in use, which is selected on the first call.
+{
+    static BloombergLP::bsls::AtomicPointer<const Kernels> kernels(
+                                                 select(ArrayUtil::e_Avx2));
+    return kernels;
+}
+
+const Kernels *current()
+    // Return the implementation of the kernels in use.  Note that the
+    // implementations are constant, so the pointer can be loaded relaxed.
+{
+    return kernels().loadRelaxed();
+}
+
+                             // ----------------
+                             // Datum operations
+                             // ----------------
+
+int unbox(double *result, const Datum *values, bsl::size_t length)
+    // Load into the specified 'result' the specified 'length' doubles held
+    // by the specified 'values'.  Return 0 on success, and a non-zero value
+    // if any of 'values' is not a double.
+{
+    for (bsl::size_t i = 0; i < length; ++i) {
+        if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(!values[i].isDouble())) {
+            return 1;                                                 // RETURN
+        }
+        result[i] = values[i].theDouble();
+    }
+    return 0;
+}
+
+int getOperands(const Datum **data,
+                bsl::size_t  *length,
+                const Datum  *operands,
+                int           numOperands)
+    // Load into the specified 'data' the elements of each of the specified
+    // 'numOperands' 'operands', and into the specified 'length' their
+    // length.  Return 0 on success, and a non-zero value unless all of
+    // 'operands' are arrays of the same length.
+{
+    for (int j = 0; j < numOperands; ++j) {
+        if (!operands[j].isArray()) {
+            return 1;                                                 // RETURN
+        }
+        const DatumArrayRef array = operands[j].theArray();
+        if (0 < j && array.length() != *length) {
+            return 1;                                                 // RETURN
+        }
+        data[j] = array.data();
+        *length = array.length();
+    }
+    return 0;
+}
+
+typedef void MapFunction(double              *result,
+                         const double *const *operands,
+                         bsl::size_t          length);
+    // Load into each of the specified 'length' elements of the specified
+    // 'result' the result of an operation on the corresponding elements of
+    // the specified 'operands'.
+
+void mapAdd(double *result, const double *const *operands, bsl::size_t length)
+{
+    current()->d_add(result, operands[0], operands[1], length);
+}
+
+void mapMultiply(double              *result,
+                 const double *const *operands,
+                 bsl::size_t          length)
+{
+    current()->d_multiply(result, operands[0], operands[1], length);
+}
+
+void mapMultiplyAdd(double              *result,
+                    const double *const *operands,
+                    bsl::size_t          length)
+{
+    current()->d_multiplyAdd(result,
+                             operands[0],
+                             operands[1],
+                             operands[2],
+                             length);
+}
+
+int map(Datum                         *result,
+        const Datum                   *operands,
+        int                            numOperands,
+        MapFunction                   *function,
+        BloombergLP::bslma::Allocator *allocator)
+    // Load into the specified 'result' an array, allocated from the
+    // specified 'allocator', holding the results of the specified 'function'
+    // for the elements of the specified 'numOperands' 'operands'.  Return 0
+    // on success, and a non-zero value, with no effect on 'result', unless
+    // 'operands' are arrays of doubles of the same length.
+{
+    BSLS_ASSERT(numOperands <= k_MAX_OPERANDS);
+    BSLS_ASSERT(0 != allocator);
+
+    const Datum *data[k_MAX_OPERANDS];
+    bsl::size_t  length = 0;
+    if (0 != getOperands(data, &length, operands, numOperands)) {
+        return 1;                                                     // RETURN
+    }
+
+    DatumMutableArrayRef output;
+    Datum::createUninitializedArray(&output, length, allocator);
+
+    double        input[k_MAX_OPERANDS][k_CHUNK_LENGTH];
+    const double *chunks[k_MAX_OPERANDS];
+    double        chunk[k_CHUNK_LENGTH];
+    for (int j = 0; j < numOperands; ++j) {
+        chunks[j] = input[j];
+    }
+
+    for (bsl::size_t start = 0; start < length; start += k_CHUNK_LENGTH) {
+        const bsl::size_t n = bsl::min<bsl::size_t>(k_CHUNK_LENGTH,
+                                                    length - start);
+        for (int j = 0; j < numOperands; ++j) {
+            if (0 != unbox(input[j], data[j] + start, n)) {
+                *output.length() = start;
+                Datum::destroy(Datum::adoptArray(output), allocator);
+                return 1;                                             // RETURN
+            }
+        }
+        function(chunk, chunks, n);
+        Datum *elements = output.data() + start;
+        for (bsl::size_t i = 0; i < n; ++i) {
+            elements[i] = Datum::createDouble(chunk[i]);
+        }
+    }
+    *output.length() = length;
+    *result = Datum::adoptArray(output);
+    return 0;
+}
+
+}  // close unnamed namespace
+
+                              // ----------------
+                              // struct ArrayUtil
+                              // ----------------
+
+// CLASS METHODS
+void ArrayUtil::add(double       *result,
+                    const double *lhs,
+                    const double *rhs,
+                    bsl::size_t   length)
+{
+    current()->d_add(result, lhs, rhs, length);
+}
+
+void ArrayUtil::multiply(double       *result,
+                         const double *lhs,
+                         const double *rhs,
+                         bsl::size_t   length)
+{
+    current()->d_multiply(result, lhs, rhs, length);
+}
+
+void ArrayUtil::multiplyAdd(double       *result,
+                            const double *lhs,
+                            const double *rhs,
+                            const double *addend,
+                            bsl::size_t   length)
+{
+    current()->d_multiplyAdd(result, lhs, rhs, addend, length);
+}
+
+double ArrayUtil::sum(const double *values, bsl::size_t length)
+{
+    return current()->d_sum(values, length);
+}
+
+double ArrayUtil::dot(const double *lhs, const double *rhs, bsl::size_t length)
+{
+    return current()->d_dot(lhs, rhs, length);
+}
+
+int ArrayUtil::add(Datum       *result,
+                   const Datum& lhs,
+                   const Datum& rhs,
+                   Allocator   *allocator)
+{
+    BSLS_ASSERT(0 != result);
+
+    const Datum operands[] = { lhs, rhs };
+    return map(result, operands, 2, &mapAdd, allocator);
+}
+
+int ArrayUtil::multiply(Datum       *result,
+                        const Datum& lhs,
+                        const Datum& rhs,
+                        Allocator   *allocator)
+{
+    BSLS_ASSERT(0 != result);
+
+    const Datum operands[] = { lhs, rhs };
+    return map(result, operands, 2, &mapMultiply, allocator);
+}
+
+int ArrayUtil::multiplyAdd(Datum       *result,
+                           const Datum& lhs,
+                           const Datum& rhs,
+                           const Datum& addend,
+                           Allocator   *allocator)
+{
+    BSLS_ASSERT(0 != result);
+
+    const Datum operands[] = { lhs, rhs, addend };
+    return map(result, operands, 3, &mapMultiplyAdd, allocator);
+}
+
+int ArrayUtil::sum(Datum *result, const Datum& values)
+{
+    BSLS_ASSERT(0 != result);
+
+    const Datum *data;
+    bsl::size_t  length = 0;
+    if (0 != getOperands(&data, &length, &values, 1)) {
+        return 1;                                                     // RETURN
+    }
+
+    double chunk[k_CHUNK_LENGTH];
+    double total = 0;
+    for (bsl::size_t start = 0; start < length; start += k_CHUNK_LENGTH) {
+        const bsl::size_t n = bsl::min<bsl::size_t>(k_CHUNK_LENGTH,
+                                                    length - start);
+        if (0 != unbox(chunk, data + start, n)) {
+            return 1;                                                 // RETURN
+        }
+        total += current()->d_sum(chunk, n);
+    }
+    *result = Datum::createDouble(total);
+    return 0;
+}
+
+int ArrayUtil::dot(Datum *result, const Datum& lhs, const Datum& rhs)
+{
+    BSLS_ASSERT(0 != result);
+
+    const Datum  operands[] = { lhs, rhs };
+    const Datum *data[2];
+    bsl::size_t  length = 0;
+    if (0 != getOperands(data, &length, operands, 2)) {
+        return 1;                                                     // RETURN
+    }
+
+    double lhsChunk[k_CHUNK_LENGTH];
+    double rhsChunk[k_CHUNK_LENGTH];
+    double total = 0;
+    for (bsl::size_t start = 0; start < length; start += k_CHUNK_LENGTH) {
+        const bsl::size_t n = bsl::min<bsl::size_t>(k_CHUNK_LENGTH,
+                                                    length - start);
+        if (0 != unbox(lhsChunk, data[0] + start, n)
+         || 0 != unbox(rhsChunk, data[1] + start, n)) {
+            return 1;                                                 // RETURN
+        }
+        total += current()->d_dot(lhsChunk, rhsChunk, n);
+    }
+    *result = Datum::createDouble(total);
+    return 0;
+}
+
+ArrayUtil::Isa ArrayUtil::isa()
+{
+    return current()->d_isa;
+}
+
+ArrayUtil::Isa ArrayUtil::setIsa(Isa isa)
+{
+    const Kernels *selected = select(isa);
+    kernels().storeRelaxed(selected);
+    return selected->d_isa;
+}
+}
@@ -0,0 +1,142 @@
+// sjtu_arrayutil.h
+
+#ifndef INCLUDED_SJTU_ARRAYUTIL
+#define INCLUDED_SJTU_ARRAYUTIL
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtu {
+
+                              // ================
+                              // struct ArrayUtil
+                              // ================
+
+struct ArrayUtil {
+    // This class provides a namespace for the element-wise arithmetic on
+    // arrays of doubles used by the array opcodes of the interpreter.
+    //
+    // The kernels operate on contiguous buffers of doubles.  The first call
+    // to any function selects, by detecting the features of the CPU, the
+    // widest implementation available: AVX2 or SSE2 on x86-64 when compiled
+    // with GCC or Clang, and a scalar loop otherwise.  All implementations
+    // return the same bits: none uses fused multiply-add, and 'sum' and
+    // 'dot' accumulate element 'i' into partial sum 'i % 4' in every
+    // implementation, adding the partial sums, and then any remaining
+    // elements, in a fixed order.  This holds provided that the compiler does
+    // not contract multiplications and additions itself, which GCC does by
+    // default when the target of the build has FMA; such builds should use
+    // '-ffp-contract=off'.
+    //
+    // The 'Datum' functions apply a kernel to 'Datum' arrays of doubles,
+    // unboxing the operands in chunks held on the program stack, so that
+    // only the array holding the result, if any, is allocated.
+
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    enum Isa {
+        // Enumeration used to identify an implementation of the kernels.
+
+        e_Scalar,
+        e_Sse2,
+        e_Avx2
+    };
+
+    // CLASS METHODS
+    static void add(double       *result,
+                    const double *lhs,
+                    const double *rhs,
+                    bsl::size_t   length);
+        // Load into each of the specified 'length' elements of the specified
+        // 'result' the sum of the corresponding elements of the specified
+        // 'lhs' and 'rhs'.
+
+    static void multiply(double       *result,
+                         const double *lhs,
+                         const double *rhs,
+                         bsl::size_t   length);
+        // Load into each of the specified 'length' elements of the specified
+        // 'result' the product of the corresponding elements of the specified
+        // 'lhs' and 'rhs'.
+
+    static void multiplyAdd(double       *result,
+                            const double *lhs,
+                            const double *rhs,
+                            const double *addend,
+                            bsl::size_t   length);
+        // Load into each of the specified 'length' elements of the specified
+        // 'result' the product of the corresponding elements of the specified
+        // 'lhs' and 'rhs' plus the corresponding element of the specified
+        // 'addend', rounding the product before the addition.
+
+    static double sum(const double *values, bsl::size_t length);
+        // Return the sum of the specified 'length' 'values'.
+
+    static double dot(const double *lhs,
+                      const double *rhs,
+                      bsl::size_t   length);
+        // Return the dot product of the specified 'length' elements of the
+        // specified 'lhs' and 'rhs'.
+
+    static int add(Datum       *result,
+                   const Datum& lhs,
+                   const Datum& rhs,
+                   Allocator   *allocator);
+    static int multiply(Datum       *result,
+                        const Datum& lhs,
+                        const Datum& rhs,
+                        Allocator   *allocator);
+        // Load into the specified 'result' an array, allocated from the
+        // specified 'allocator', holding the element-wise sum or product of
+        // the specified 'lhs' and 'rhs' arrays.  Return 0 on success, and a
+        // non-zero value, with no effect on 'result', unless 'lhs' and 'rhs'
+        // are arrays of doubles of the same length.
+
+    static int multiplyAdd(Datum       *result,
+                           const Datum& lhs,
+                           const Datum& rhs,
+                           const Datum& addend,
+                           Allocator   *allocator);
+        // Load into the specified 'result' an array, allocated from the
+        // specified 'allocator', holding the element-wise product of the
+        // specified 'lhs' and 'rhs' arrays plus the specified 'addend' array.
+        // Return 0 on success, and a non-zero value, with no effect on
+        // 'result', unless 'lhs', 'rhs', and 'addend' are arrays of doubles
+        // of the same length.
+
+    static int sum(Datum *result, const Datum& values);
+        // Load into the specified 'result' the sum of the specified 'values'
+        // as a double.  Return 0 on success, and a non-zero value, with no
+        // effect on 'result', unless 'values' is an array of doubles.
+
+    static int dot(Datum *result, const Datum& lhs, const Datum& rhs);
+        // Load into the specified 'result' the dot product of the specified
+        // 'lhs' and 'rhs' as a double.  Return 0 on success, and a non-zero
+        // value, with no effect on 'result', unless 'lhs' and 'rhs' are
+        // arrays of doubles of the same length.
+
+    static Isa isa();
+        // Return the implementation of the kernels in use.
+
+    static Isa setIsa(Isa isa);
+        // Use the implementation of the kernels identified by the specified
+        // 'isa', or, if the CPU does not support it, the widest supported one
+        // narrower than 'isa', and return the implementation now in use.
+        // This function is intended for testing.  It may be called while
+        // other threads use the kernels, since all implementations return
+        // the same results.
+};
+}
+
+#endif
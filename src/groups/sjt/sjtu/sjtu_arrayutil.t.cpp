@@ -0,0 +1,322 @@
+// sjtu_arrayutil.t.cpp                                     -*-C++-*-
+
+#include <sjtu_arrayutil.h>
+
+#include <bdls_testutil.h>
+#include <bslma_testallocator.h>
+#include <bsls_platform.h>
+#include <bsls_types.h>
+
+#include <bsl_cstring.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+bdld::Datum makeArray(int               length,
+                      double            scale,
+                      bslma::Allocator *allocator)
+    // Return an array of the specified 'length' holding the doubles 0 to
+    // 'length - 1' multiplied by the specified 'scale', allocated from the
+    // specified 'allocator'.
+{
+    bdld::DatumMutableArrayRef array;
+    bdld::Datum::createUninitializedArray(&array, length, allocator);
+    for (int i = 0; i < length; ++i) {
+        array.data()[i] = bdld::Datum::createDouble(i * scale);
+    }
+    *array.length() = length;
+    return bdld::Datum::adoptArray(array);
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "identical results across implementations"
+                          << endl
+                          << "========================================"
+                          << endl;
+
+        // Values whose sums and products are inexact, so that any
+        // difference in rounding or in the order of accumulation shows.
+
+        const int           LENGTH = 1000;
+        bsl::vector<double> a(LENGTH), b(LENGTH), c(LENGTH);
+        for (int i = 0; i < LENGTH; ++i) {
+            a[i] = 1.0 / (i + 3);
+            b[i] = (i % 7 - 3) * 0.1 + 1e-9 * i;
+            c[i] = 1e16 / (i + 1) - 1;
+        }
+
+        const ArrayUtil::Isa ISAS[] = {
+            ArrayUtil::e_Scalar, ArrayUtil::e_Sse2, ArrayUtil::e_Avx2
+        };
+        const int            NUM_ISAS = sizeof ISAS / sizeof *ISAS;
+        const ArrayUtil::Isa DEFAULT  = ArrayUtil::isa();
+
+        for (int length = 0; length <= LENGTH; length += length < 40
+                                                          ? 1
+                                                          : 241) {
+            double              sums[NUM_ISAS], dots[NUM_ISAS];
+            bsl::vector<double> results[NUM_ISAS];
+            for (int k = 0; k < NUM_ISAS; ++k) {
+                const ArrayUtil::Isa ISA = ArrayUtil::setIsa(ISAS[k]);
+                if (veryVerbose) { T_ P_(length) P(ISA) }
+
+                sums[k] = ArrayUtil::sum(c.data(), length);
+                dots[k] = ArrayUtil::dot(a.data(), b.data(), length);
+                results[k].resize(length);
+                ArrayUtil::multiplyAdd(results[k].data(), a.data(), b.data(),
+                                       c.data(), length);
+            }
+            for (int k = 1; k < NUM_ISAS; ++k) {
+                ASSERTV(length, k, 0 == bsl::memcmp(&sums[0],
+                                                    &sums[k],
+                                                    sizeof *sums));
+                ASSERTV(length, k, 0 == bsl::memcmp(&dots[0],
+                                                    &dots[k],
+                                                    sizeof *dots));
+                ASSERTV(length, k, results[0] == results[k]);
+            }
+            for (int i = 0; i < length; ++i) {
+                ASSERTV(length, i, a[i] * b[i] + c[i] == results[0][i]);
+            }
+        }
+        ArrayUtil::setIsa(DEFAULT);
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "Datum operations" << endl
+                          << "================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+
+        const int LENGTHS[] = { 0, 1, 5, 128, 129, 1000 };
+        for (bsl::size_t i = 0; i < sizeof LENGTHS / sizeof *LENGTHS; ++i) {
+            const int LENGTH = LENGTHS[i];
+            if (veryVerbose) { T_ P(LENGTH) }
+
+            const bdld::Datum A = makeArray(LENGTH, 1, &ta);
+            const bdld::Datum B = makeArray(LENGTH, 2, &ta);
+            bdld::Datum       result;
+
+            ASSERTV(LENGTH, 0 == ArrayUtil::add(&result, A, B, &ta));
+            ASSERTV(LENGTH, LENGTH == static_cast<int>(
+                                                  result.theArray().length()));
+            for (int j = 0; j < LENGTH; ++j) {
+                ASSERTV(LENGTH, j, bdld::Datum::createDouble(3 * j) ==
+                                                        result.theArray()[j]);
+            }
+            bdld::Datum::destroy(result, &ta);
+
+            ASSERTV(LENGTH, 0 == ArrayUtil::multiply(&result, A, B, &ta));
+            for (int j = 0; j < LENGTH; ++j) {
+                ASSERTV(LENGTH, j, bdld::Datum::createDouble(2.0 * j * j) ==
+                                                        result.theArray()[j]);
+            }
+            bdld::Datum::destroy(result, &ta);
+
+            ASSERTV(LENGTH, 0 == ArrayUtil::multiplyAdd(&result, A, B, A,
+                                                        &ta));
+            for (int j = 0; j < LENGTH; ++j) {
+                ASSERTV(LENGTH, j,
+                        bdld::Datum::createDouble(2.0 * j * j + j) ==
+                                                        result.theArray()[j]);
+            }
+            bdld::Datum::destroy(result, &ta);
+
+            const double N = LENGTH;
+            ASSERTV(LENGTH, 0 == ArrayUtil::sum(&result, A));
+            ASSERTV(LENGTH, result,
+                   bdld::Datum::createDouble(N * (N - 1) / 2) == result);
+
+            ASSERTV(LENGTH, 0 == ArrayUtil::dot(&result, A, B));
+            ASSERTV(LENGTH, result,
+                    bdld::Datum::createDouble(
+                                 (N - 1) * N * (2 * N - 1) / 3) == result);
+
+            bdld::Datum::destroy(A, &ta);
+            bdld::Datum::destroy(B, &ta);
+            ASSERTV(LENGTH, 0 == ta.numBytesInUse());
+        }
+
+        // Operands that are not arrays of doubles of the same length.
+
+        const bdld::Datum SHORT = makeArray(3, 1, &ta);
+        const bdld::Datum LONG  = makeArray(300, 1, &ta);
+        const bdld::Datum BAD   = makeArray(300, 1, &ta);
+        const_cast<bdld::Datum *>(BAD.theArray().data())[200] =
+                                            bdld::Datum::createInteger(200);
+        const bdld::Datum SCALAR = bdld::Datum::createDouble(1);
+
+        const bsls::Types::Int64 bytesInUse = ta.numBytesInUse();
+        const bdld::Datum        UNCHANGED  = bdld::Datum::createNull();
+        bdld::Datum              result     = UNCHANGED;
+
+        ASSERT(0 != ArrayUtil::add(&result, SHORT, LONG, &ta));
+        ASSERT(0 != ArrayUtil::add(&result, LONG, BAD, &ta));
+        ASSERT(0 != ArrayUtil::add(&result, SCALAR, SCALAR, &ta));
+        ASSERT(0 != ArrayUtil::multiply(&result, BAD, LONG, &ta));
+        ASSERT(0 != ArrayUtil::multiplyAdd(&result, LONG, LONG, SHORT, &ta));
+        ASSERT(0 != ArrayUtil::multiplyAdd(&result, LONG, LONG, BAD, &ta));
+        ASSERT(0 != ArrayUtil::sum(&result, BAD));
+        ASSERT(0 != ArrayUtil::sum(&result, SCALAR));
+        ASSERT(0 != ArrayUtil::dot(&result, SHORT, LONG));
+        ASSERT(0 != ArrayUtil::dot(&result, LONG, BAD));
+        ASSERT(UNCHANGED == result);
+        ASSERT(bytesInUse == ta.numBytesInUse());
+
+        bdld::Datum::destroy(SHORT, &ta);
+        bdld::Datum::destroy(LONG, &ta);
+        bdld::Datum::destroy(BAD, &ta);
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "kernels" << endl
+                          << "=======" << endl;
+
+        const ArrayUtil::Isa ISAS[] = {
+            ArrayUtil::e_Scalar, ArrayUtil::e_Sse2, ArrayUtil::e_Avx2
+        };
+        const ArrayUtil::Isa DEFAULT = ArrayUtil::isa();
+
+        for (bsl::size_t k = 0; k < sizeof ISAS / sizeof *ISAS; ++k) {
+            const ArrayUtil::Isa ISA = ArrayUtil::setIsa(ISAS[k]);
+            if (veryVerbose) { T_ P_(ISAS[k]) P(ISA) }
+
+            for (int length = 0; length < 40; ++length) {
+                bsl::vector<double> a(length), b(length), c(length);
+                bsl::vector<double> result(length + 1, -1.0);
+                double              sum = 0, dot = 0;
+                for (int i = 0; i < length; ++i) {
+                    a[i] = i;
+                    b[i] = 3 - i;
+                    c[i] = 2 * i;
+                    sum += a[i];
+                    dot += a[i] * b[i];
+                }
+
+                ArrayUtil::add(result.data(), a.data(), b.data(), length);
+                for (int i = 0; i < length; ++i) {
+                    ASSERTV(ISA, length, i, 3 == result[i]);
+                }
+                ASSERTV(ISA, length, -1 == result[length]);
+
+                ArrayUtil::multiply(result.data(), a.data(), b.data(),
+                                    length);
+                for (int i = 0; i < length; ++i) {
+                    ASSERTV(ISA, length, i, a[i] * b[i] == result[i]);
+                }
+                ASSERTV(ISA, length, -1 == result[length]);
+
+                ArrayUtil::multiplyAdd(result.data(), a.data(), b.data(),
+                                       c.data(), length);
+                for (int i = 0; i < length; ++i) {
+                    ASSERTV(ISA, length, i,
+                            a[i] * b[i] + c[i] == result[i]);
+                }
+                ASSERTV(ISA, length, -1 == result[length]);
+
+                ASSERTV(ISA, length, sum ==
+                                         ArrayUtil::sum(a.data(), length));
+                ASSERTV(ISA, length, dot ==
+                                ArrayUtil::dot(a.data(), b.data(), length));
+            }
+        }
+        ArrayUtil::setIsa(DEFAULT);
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "isa selection" << endl
+                          << "=============" << endl;
+
+        const ArrayUtil::Isa DEFAULT = ArrayUtil::isa();
+        if (verbose) { P(DEFAULT) }
+
+        ASSERT(ArrayUtil::e_Scalar == ArrayUtil::setIsa(ArrayUtil::e_Scalar));
+        ASSERT(ArrayUtil::e_Scalar == ArrayUtil::isa());
+        ASSERT(ArrayUtil::e_Sse2 >= ArrayUtil::setIsa(ArrayUtil::e_Sse2));
+        ASSERT(DEFAULT == ArrayUtil::setIsa(ArrayUtil::e_Avx2));
+        ASSERT(DEFAULT == ArrayUtil::isa());
+#if defined(BSLS_PLATFORM_CPU_X86_64)
+        ASSERT(ArrayUtil::e_Sse2 <= DEFAULT);
+#endif
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,92 @@
+// sjtu_bindutil.cpp
+#include <sjtu_bindutil.h>
+
+#include <bslma_allocator.h>
+
+namespace sjtu {
+using BloombergLP::bdld::Datum;
+using BloombergLP::bdld::DatumArrayRef;
+using BloombergLP::bdld::DatumMutableArrayRef;
+
+namespace {
+
+enum {
+    k_LOCAL_BATCH_LENGTH = 64  // longest array unboxed on the program stack
+};
+
+}  // close unnamed namespace
+
+                               // ---------------
+                               // struct BindUtil
+                               // ---------------
+
+// CLASS METHODS
+void BindUtil::callBatch(sjtt::ExecutionContext *context,
+                         BatchFunction          *function)
+{
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 != function);
+
+    bsl::vector<Datum>& stack    = *context->stack();
+    BSLS_ASSERT_SAFE(!stack.empty());
+    Datum&              argument = stack.back();
+
+    if (argument.isDouble()) {
+        const double input = argument.theDouble();
+        double       output;
+        function(&input, &output, 1);
+        argument = Datum::createDouble(output);
+        return;                                                       // RETURN
+    }
+    if (!argument.isArray()) {
+        argument = DatumUtil::s_Undefined;
+        context->setStatus(InterpretUtil::e_TypeError);
+        return;                                                       // RETURN
+    }
+
+    // Both buffers are carved from one block, which is on the program stack
+    // unless the array is long.
+
+    BloombergLP::bslma::Allocator *allocator = context->allocator();
+    const DatumArrayRef            array     = argument.theArray();
+    const bsl::size_t              length    = array.length();
+    double                         local[2 * k_LOCAL_BATCH_LENGTH];
+    double                        *input     = local;
+    if (k_LOCAL_BATCH_LENGTH < length) {
+        input = static_cast<double *>(
+                           allocator->allocate(2 * length * sizeof(double)));
+    }
+    double *output = input + length;
+
+    bool accepted = true;
+    for (bsl::size_t i = 0; i < length; ++i) {
+        if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(!array[i].isDouble())) {
+            accepted = false;
+            break;
+        }
+        input[i] = array[i].theDouble();
+    }
+
+    if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(accepted)) {
+        if (0 != length) {
+            function(input, output, length);
+        }
+
+        DatumMutableArrayRef result;
+        Datum::createUninitializedArray(&result, length, allocator);
+        for (bsl::size_t i = 0; i < length; ++i) {
+            result.data()[i] = Datum::createDouble(output[i]);
+        }
+        *result.length() = length;
+        argument = Datum::adoptArray(result);
+    }
+    else {
+        argument = DatumUtil::s_Undefined;
+        context->setStatus(InterpretUtil::e_TypeError);
+    }
+
+    if (local != input) {
+        allocator->deallocate(input);
+    }
+}
+}
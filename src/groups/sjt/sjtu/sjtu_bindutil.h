@@ -0,0 +1,388 @@
+// sjtu_bindutil.h
+
+#ifndef INCLUDED_SJTU_BINDUTIL
+#define INCLUDED_SJTU_BINDUTIL
+
+#ifndef INCLUDED_SJTT_EXECUTIONCONTEXT
+#include <sjtt_executioncontext.h>
+#endif
+
+#ifndef INCLUDED_SJTU_DATUMUTIL
+#include <sjtu_datumutil.h>
+#endif
+
+#ifndef INCLUDED_SJTU_INTERPRETUTIL
+#include <sjtu_interpretutil.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLS_PERFORMANCEHINT
+#include <bsls_performancehint.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+namespace sjtu {
+
+                               // ===============
+                               // struct BindUtil
+                               // ===============
+
+struct BindUtil {
+    // This class provides a namespace for functions that make ordinary C++
+    // functions callable by 'e_Execute'.  'bind' generates, at compile time,
+    // an 'ExternalFunction' that checks the types of the arguments on the
+    // stack, unpacks them, calls the bound function, and replaces the
+    // arguments with its boxed result.  Arguments are passed in the order in
+    // which they were pushed, so the last argument is on the top of the
+    // stack.  For example:
+    //..
+    //  double scale(double value, int factor);
+    //
+    //  const bdld::Datum f = BindUtil::bind<double(double, int), &scale>();
+    //..
+    // The supported argument types are 'double', 'int', 'bool',
+    // 'bslstl::StringRef', and 'bdld::Datum' (also as 'const bdld::Datum&'),
+    // which accepts any value.  No conversions are performed: e.g., an 'int'
+    // argument must be an integer 'Datum'.  The result may be of any of the
+    // argument types, in which case it is boxed (copying a string into the
+    // allocator of the context), or 'void', in which case the result is
+    // null.  If any argument has the wrong type, the function is not called;
+    // the arguments are replaced by an undefined value and the status of the
+    // context is set to 'InterpretUtil::e_TypeError', which stops the
+    // interpreter.  The behavior is undefined unless the stack holds at
+    // least as many values as the bound function has arguments.
+    //
+    // 'bindBatch' binds a kernel operating on contiguous buffers of doubles,
+    // so that a script can map it over a whole array with one 'e_Execute'.
+    // Applied to an array of doubles, the bound function unboxes the array
+    // into a buffer (on the program stack if it is small, otherwise from the
+    // allocator of the context), calls the kernel once for all of it (or
+    // not at all if the array is empty), and replaces the argument with a
+    // new array, allocated from the allocator of the context, holding the
+    // results.  Applied to a double, it calls the kernel with buffers of
+    // length 1 and replaces the argument with a double.  Any other argument,
+    // including an array holding a value that is not a double, is a type
+    // error, reported as described above.
+
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+
+    typedef void BatchFunction(const double *input,
+                               double       *output,
+                               bsl::size_t   length);
+        // 'BatchFunction' is the type of a kernel that loads into each of the
+        // specified 'length' elements of the specified 'output' buffer the
+        // result for the corresponding element of the specified 'input'
+        // buffer.
+
+    // CLASS METHODS
+    template <class SIGNATURE, SIGNATURE *FUNCTION>
+    static Datum bind();
+        // Return a 'Datum' having the UDT type 'DatumUtil::e_ExternalFunction'
+        // and referring to 'call<SIGNATURE, FUNCTION>'.
+
+    template <class SIGNATURE, SIGNATURE *FUNCTION>
+    static void call(sjtt::ExecutionContext *context);
+        // Pop the arguments of the specified 'FUNCTION', having the specified
+        // 'SIGNATURE', from the stack of the specified 'context', call it, and
+        // push its result, as described above.
+
+    template <BatchFunction *FUNCTION>
+    static Datum bindBatch();
+        // Return a 'Datum' having the UDT type 'DatumUtil::e_ExternalFunction'
+        // and referring to 'callBatch<FUNCTION>'.
+
+    template <BatchFunction *FUNCTION>
+    static void callBatch(sjtt::ExecutionContext *context);
+        // Replace the array or double on the top of the stack of the
+        // specified 'context' with the results of the specified 'FUNCTION'
+        // for its elements, as described above.
+
+    static void callBatch(sjtt::ExecutionContext *context,
+                          BatchFunction          *function);
+        // Replace the array or double on the top of the stack of the
+        // specified 'context' with the results of the specified 'function'
+        // for its elements, as described above.
+};
+
+                          // =========================
+                          // struct BindUtil_Argument
+                          // =========================
+
+template <class TYPE>
+struct BindUtil_Argument;
+    // This 'struct' provides the type check and the unpacking of an argument
+    // of (template parameter) 'TYPE'.  It is specialized for each supported
+    // type, and left undefined otherwise.
+
+template <>
+struct BindUtil_Argument<double> {
+    static bool accepts(const BloombergLP::bdld::Datum& value) {
+        return value.isDouble();
+    }
+    static double get(const BloombergLP::bdld::Datum& value) {
+        return value.theDouble();
+    }
+};
+
+template <>
+struct BindUtil_Argument<int> {
+    static bool accepts(const BloombergLP::bdld::Datum& value) {
+        return value.isInteger();
+    }
+    static int get(const BloombergLP::bdld::Datum& value) {
+        return value.theInteger();
+    }
+};
+
+template <>
+struct BindUtil_Argument<bool> {
+    static bool accepts(const BloombergLP::bdld::Datum& value) {
+        return value.isBoolean();
+    }
+    static bool get(const BloombergLP::bdld::Datum& value) {
+        return value.theBoolean();
+    }
+};
+
+template <>
+struct BindUtil_Argument<BloombergLP::bslstl::StringRef> {
+    static bool accepts(const BloombergLP::bdld::Datum& value) {
+        return value.isString();
+    }
+    static BloombergLP::bslstl::StringRef get(
+                                       const BloombergLP::bdld::Datum& value) {
+        return value.theString();
+    }
+};
+
+template <>
+struct BindUtil_Argument<BloombergLP::bdld::Datum> {
+    static bool accepts(const BloombergLP::bdld::Datum&) {
+        return true;
+    }
+    static const BloombergLP::bdld::Datum& get(
+                                       const BloombergLP::bdld::Datum& value) {
+        return value;
+    }
+};
+
+template <>
+struct BindUtil_Argument<const BloombergLP::bdld::Datum&>
+: BindUtil_Argument<BloombergLP::bdld::Datum> {
+};
+
+                           // =======================
+                           // struct BindUtil_Result
+                           // =======================
+
+template <class TYPE>
+struct BindUtil_Result;
+    // This 'struct' provides the call of a function returning (template
+    // parameter) 'TYPE' and the boxing of its result.  It is specialized for
+    // each supported type, and left undefined otherwise.
+
+template <>
+struct BindUtil_Result<void> {
+    template <class FUNCTION, class... ARGS>
+    static BloombergLP::bdld::Datum call(sjtt::ExecutionContext *,
+                                         FUNCTION                function,
+                                         ARGS...                 args) {
+        function(args...);
+        return DatumUtil::s_Null;
+    }
+};
+
+template <>
+struct BindUtil_Result<double> {
+    template <class FUNCTION, class... ARGS>
+    static BloombergLP::bdld::Datum call(sjtt::ExecutionContext *,
+                                         FUNCTION                function,
+                                         ARGS...                 args) {
+        return BloombergLP::bdld::Datum::createDouble(function(args...));
+    }
+};
+
+template <>
+struct BindUtil_Result<int> {
+    template <class FUNCTION, class... ARGS>
+    static BloombergLP::bdld::Datum call(sjtt::ExecutionContext *,
+                                         FUNCTION                function,
+                                         ARGS...                 args) {
+        return BloombergLP::bdld::Datum::createInteger(function(args...));
+    }
+};
+
+template <>
+struct BindUtil_Result<bool> {
+    template <class FUNCTION, class... ARGS>
+    static BloombergLP::bdld::Datum call(sjtt::ExecutionContext *,
+                                         FUNCTION                function,
+                                         ARGS...                 args) {
+        return BloombergLP::bdld::Datum::createBoolean(function(args...));
+    }
+};
+
+template <>
+struct BindUtil_Result<BloombergLP::bslstl::StringRef> {
+    template <class FUNCTION, class... ARGS>
+    static BloombergLP::bdld::Datum call(sjtt::ExecutionContext *context,
+                                         FUNCTION                function,
+                                         ARGS...                 args) {
+        return BloombergLP::bdld::Datum::copyString(function(args...),
+                                                    context->allocator());
+    }
+};
+
+template <>
+struct BindUtil_Result<BloombergLP::bdld::Datum> {
+    template <class FUNCTION, class... ARGS>
+    static BloombergLP::bdld::Datum call(sjtt::ExecutionContext *,
+                                         FUNCTION                function,
+                                         ARGS...                 args) {
+        return function(args...);
+    }
+};
+
+                          // ========================
+                          // struct BindUtil_Indices
+                          // ========================
+
+template <bsl::size_t... INDICES>
+struct BindUtil_Indices {
+    // This 'struct' carries the indices of the arguments of a function.
+};
+
+template <bsl::size_t NUM_INDICES, bsl::size_t... INDICES>
+struct BindUtil_MakeIndices
+: BindUtil_MakeIndices<NUM_INDICES - 1, NUM_INDICES - 1, INDICES...> {
+    // This 'struct' provides, as 'Type', 'BindUtil_Indices' holding the
+    // indices '0' to '(template parameter) NUM_INDICES - 1'.
+};
+
+template <bsl::size_t... INDICES>
+struct BindUtil_MakeIndices<0, INDICES...> {
+    typedef BindUtil_Indices<INDICES...> Type;
+};
+
+                         // =========================
+                         // struct BindUtil_Function
+                         // =========================
+
+template <class SIGNATURE, SIGNATURE *FUNCTION>
+struct BindUtil_Function;
+    // This 'struct' provides the 'ExternalFunction' calling the (template
+    // parameter) 'FUNCTION', of the (template parameter) 'SIGNATURE'.
+
+template <class RESULT, class... ARGS, RESULT (*FUNCTION)(ARGS...)>
+struct BindUtil_Function<RESULT(ARGS...), FUNCTION> {
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef typename BindUtil_MakeIndices<sizeof...(ARGS)>::Type Indices;
+
+    enum { k_ARITY = sizeof...(ARGS) };
+
+    // CLASS METHODS
+    template <bsl::size_t... INDICES>
+    static bool accepts(const Datum *args, BindUtil_Indices<INDICES...>) {
+        // Return 'true' if each of the specified 'args' has the type of the
+        // corresponding parameter of 'FUNCTION', and 'false' otherwise.
+
+        bool       result    = true;
+        const bool checked[] = {
+            true, (result &= BindUtil_Argument<ARGS>::accepts(args[INDICES]))...
+        };
+        (void)checked;
+        return result;
+    }
+
+    template <bsl::size_t... INDICES>
+    static Datum invoke(sjtt::ExecutionContext *context,
+                        const Datum            *args,
+                        BindUtil_Indices<INDICES...>) {
+        // Call 'FUNCTION' with the specified 'args', unpacked, and return its
+        // result, boxed, using the specified 'context'.
+
+        return BindUtil_Result<RESULT>::call(
+                               context,
+                               FUNCTION,
+                               BindUtil_Argument<ARGS>::get(args[INDICES])...);
+    }
+
+    static void call(sjtt::ExecutionContext *context) {
+        bsl::vector<Datum>& stack = *context->stack();
+        BSLS_ASSERT_SAFE(k_ARITY <= stack.size());
+
+        Datum *args = stack.data() + (stack.size() - k_ARITY);
+        Datum  result;
+        if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(accepts(args, Indices()))) {
+            result = invoke(context, args, Indices());
+        }
+        else {
+            result = DatumUtil::s_Undefined;
+            context->setStatus(InterpretUtil::e_TypeError);
+        }
+        if (0 == k_ARITY) {
+            stack.push_back(result);
+        }
+        else {
+            args[0] = result;
+            stack.resize(stack.size() - k_ARITY + 1);
+        }
+    }
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                               // ---------------
+                               // struct BindUtil
+                               // ---------------
+
+// CLASS METHODS
+template <class SIGNATURE, SIGNATURE *FUNCTION>
+inline
+BloombergLP::bdld::Datum BindUtil::bind() {
+    return DatumUtil::createExternalFunction(&call<SIGNATURE, FUNCTION>);
+}
+
+template <class SIGNATURE, SIGNATURE *FUNCTION>
+inline
+void BindUtil::call(sjtt::ExecutionContext *context) {
+    BSLS_ASSERT_SAFE(0 != context);
+    BindUtil_Function<SIGNATURE, FUNCTION>::call(context);
+}
+
+template <BindUtil::BatchFunction *FUNCTION>
+inline
+BloombergLP::bdld::Datum BindUtil::bindBatch() {
+    return DatumUtil::createExternalFunction(&callBatch<FUNCTION>);
+}
+
+template <BindUtil::BatchFunction *FUNCTION>
+inline
+void BindUtil::callBatch(sjtt::ExecutionContext *context) {
+    callBatch(context, FUNCTION);
+}
+}
+
+#endif
@@ -0,0 +1,397 @@
+// sjtu_bindutil.t.cpp                                      -*-C++-*-
+
+#include <sjtu_bindutil.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_executioncontext.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_interpretutil.h>
+#include <sjtu_verifyutil.h>
+
+#include <bdls_testutil.h>
+#include <bdlma_localsequentialallocator.h>
+#include <bslma_testallocator.h>
+#include <bslstl_stringref.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+typedef sjtt::Bytecode Bytecode;
+
+namespace {
+
+double scale(double value, int factor)
+    // Return the specified 'value' multiplied by the specified 'factor'.
+{
+    return value * factor;
+}
+
+double subtract(double lhs, double rhs)
+    // Return the specified 'rhs' subtracted from the specified 'lhs'.
+{
+    return lhs - rhs;
+}
+
+int answer()
+    // Return 42.
+{
+    return 42;
+}
+
+bool negate(bool value)
+    // Return the negation of the specified 'value'.
+{
+    return !value;
+}
+
+bslstl::StringRef tail(bslstl::StringRef value)
+    // Return the specified 'value' without its first character.
+{
+    return bslstl::StringRef(value.data() + 1, value.length() - 1);
+}
+
+bdld::Datum identity(const bdld::Datum& value)
+    // Return the specified 'value'.
+{
+    return value;
+}
+
+int s_numCalls = 0;  // incremented by 'count'
+
+void count(bdld::Datum)
+    // Increment 's_numCalls'.
+{
+    ++s_numCalls;
+}
+
+int s_numBatches = 0;  // incremented by 'twice'
+
+void twice(const double *input, double *output, bsl::size_t length)
+    // Load into each of the specified 'length' elements of the specified
+    // 'output' twice the corresponding element of the specified 'input', and
+    // increment 's_numBatches'.
+{
+    ++s_numBatches;
+    for (bsl::size_t i = 0; i < length; ++i) {
+        output[i] = 2 * input[i];
+    }
+}
+
+bdld::Datum makeArray(int length, bslma::Allocator *allocator)
+    // Return an array of the specified 'length' holding the doubles 0 to
+    // 'length - 1', allocated from the specified 'allocator'.
+{
+    bdld::DatumMutableArrayRef array;
+    bdld::Datum::createUninitializedArray(&array, length, allocator);
+    for (int i = 0; i < length; ++i) {
+        array.data()[i] = bdld::Datum::createDouble(i);
+    }
+    *array.length() = length;
+    return bdld::Datum::adoptArray(array);
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 5: {
+        if (verbose) cout << endl
+                          << "batch calls" << endl
+                          << "===========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        bsl::vector<bdld::Datum> stack;
+        sjtt::ExecutionContext context(&ta, &stack);
+
+        const int LENGTHS[] = { 0, 1, 3, 64, 65, 10000 };
+        for (bsl::size_t i = 0; i < sizeof LENGTHS / sizeof *LENGTHS; ++i) {
+            const int LENGTH = LENGTHS[i];
+            if (veryVerbose) { T_ P(LENGTH) }
+
+            const bdld::Datum array = makeArray(LENGTH, &ta);
+            const Bytecode code[] = {
+                Bytecode::createPush(array),
+                Bytecode::createPush(BindUtil::bindBatch<&twice>()),
+                Bytecode::createOpcode(Bytecode::e_Execute),
+                Bytecode::createOpcode(Bytecode::e_Return),
+            };
+
+            s_numBatches = 0;
+            bdld::Datum result;
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, code));
+            ASSERTV(LENGTH, (0 != LENGTH) == s_numBatches);
+            ASSERT(result.isArray());
+            ASSERTV(LENGTH, LENGTH == static_cast<int>(
+                                                   result.theArray().length()));
+            for (int j = 0; j < LENGTH; ++j) {
+                ASSERTV(LENGTH, j, bdld::Datum::createDouble(2 * j) ==
+                                                        result.theArray()[j]);
+            }
+            bdld::Datum::destroy(result, &ta);
+            bdld::Datum::destroy(array, &ta);
+            ASSERTV(LENGTH, 0 == ta.numBytesInUse());
+        }
+
+        stack.push_back(bdld::Datum::createDouble(4));
+        BindUtil::callBatch<&twice>(&context);
+        ASSERT(bdld::Datum::createDouble(8) == stack.back());
+        ASSERT(0 == context.status());
+        stack.clear();
+
+        stack.push_back(bdld::Datum::createInteger(4));
+        BindUtil::callBatch<&twice>(&context);
+        ASSERT(InterpretUtil::e_TypeError == context.status());
+        ASSERT(DatumUtil::s_Undefined == stack.back());
+        context.setStatus(0);
+        stack.clear();
+
+        for (bsl::size_t i = 0; i < sizeof LENGTHS / sizeof *LENGTHS; ++i) {
+            const int LENGTH = LENGTHS[i];
+            if (0 == LENGTH) {
+                continue;
+            }
+            const bdld::Datum array = makeArray(LENGTH, &ta);
+            bdld::DatumMutableArrayRef mutableArray(
+                             const_cast<bdld::Datum *>(array.theArray().data()),
+                             0);
+            mutableArray.data()[LENGTH - 1] = bdld::Datum::createBoolean(true);
+
+            s_numBatches = 0;
+            stack.push_back(array);
+            BindUtil::callBatch<&twice>(&context);
+            ASSERTV(LENGTH, 0 == s_numBatches);
+            ASSERTV(LENGTH, InterpretUtil::e_TypeError == context.status());
+            ASSERTV(LENGTH, DatumUtil::s_Undefined == stack.back());
+            context.setStatus(0);
+            stack.clear();
+            bdld::Datum::destroy(array, &ta);
+            ASSERTV(LENGTH, 0 == ta.numBytesInUse());
+        }
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "interpret" << endl
+                          << "=========" << endl;
+
+        bdlma::LocalSequentialAllocator<1024> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+
+        // 'subtract(scale(1.5, 4), 2) + 1'
+
+        const Bytecode code[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(1.5)),
+            Bytecode::createPush(bdld::Datum::createInteger(4)),
+            Bytecode::createPush(
+                            BindUtil::bind<double(double, int), &scale>()),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createPush(bdld::Datum::createDouble(2)),
+            Bytecode::createPush(
+                       BindUtil::bind<double(double, double), &subtract>()),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        const bsl::size_t NUM_CODES = sizeof code / sizeof *code;
+
+        bdld::Datum result;
+        ASSERT(0 == InterpretUtil::interpret(&result, &context, code));
+        ASSERTV(result, bdld::Datum::createDouble(5) == result);
+        ASSERT(0 == stack.size());
+
+        bsl::size_t maxDepth   = 0;
+        bsl::size_t errorIndex = 0;
+        ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, code,
+                                       NUM_CODES));
+        result = bdld::Datum::createNull();
+        ASSERT(0 == InterpretUtil::interpret(&result,
+                                             &context,
+                                             code,
+                                             maxDepth));
+        ASSERTV(result, bdld::Datum::createDouble(5) == result);
+        ASSERT(0 == stack.size());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "type errors" << endl
+                          << "===========" << endl;
+
+        bdlma::LocalSequentialAllocator<1024> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+
+        stack.push_back(bdld::Datum::createDouble(1));
+        stack.push_back(bdld::Datum::createDouble(2));  // not an 'int'
+        BindUtil::call<double(double, int), &scale>(&context);
+        ASSERT(InterpretUtil::e_TypeError == context.status());
+        ASSERT(1 == stack.size());
+        ASSERT(DatumUtil::s_Undefined == stack.back());
+        context.setStatus(0);
+        stack.clear();
+
+        const Bytecode code[] = {
+            Bytecode::createPush(bdld::Datum::createInteger(3)),
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createPush(
+                            BindUtil::bind<double(double, int), &scale>()),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        const bsl::size_t NUM_CODES = sizeof code / sizeof *code;
+
+        bdld::Datum result = bdld::Datum::createNull();
+        ASSERT(InterpretUtil::e_TypeError ==
+                           InterpretUtil::interpret(&result, &context, code));
+        ASSERT(result.isNull());
+        ASSERT(0 == stack.size());
+        ASSERT(0 == context.status());
+
+        bsl::size_t maxDepth   = 0;
+        bsl::size_t errorIndex = 0;
+        ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, code,
+                                       NUM_CODES));
+        ASSERT(InterpretUtil::e_TypeError ==
+                 InterpretUtil::interpret(&result, &context, code, maxDepth));
+        ASSERT(result.isNull());
+        ASSERT(0 == stack.size());
+        ASSERT(0 == context.status());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "argument and result types" << endl
+                          << "=========================" << endl;
+
+        bdlma::LocalSequentialAllocator<1024> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+        stack.push_back(bdld::Datum::createInteger(7));  // not an argument
+
+        BindUtil::call<int(), &answer>(&context);
+        ASSERT(2 == stack.size());
+        ASSERT(bdld::Datum::createInteger(42) == stack.back());
+        stack.pop_back();
+
+        stack.push_back(bdld::Datum::createBoolean(true));
+        BindUtil::call<bool(bool), &negate>(&context);
+        ASSERT(2 == stack.size());
+        ASSERT(bdld::Datum::createBoolean(false) == stack.back());
+        stack.pop_back();
+
+        stack.push_back(bdld::Datum::copyString("hello", &alloc));
+        BindUtil::call<bslstl::StringRef(bslstl::StringRef), &tail>(&context);
+        ASSERT(2 == stack.size());
+        ASSERT(stack.back().isString());
+        ASSERT("ello" == stack.back().theString());
+        stack.pop_back();
+
+        const bdld::Datum UDT = bdld::Datum::createUdt(0, DatumUtil::e_User);
+        stack.push_back(UDT);
+        BindUtil::call<bdld::Datum(const bdld::Datum&), &identity>(&context);
+        ASSERT(2 == stack.size());
+        ASSERT(UDT == stack.back());
+        stack.pop_back();
+
+        s_numCalls = 0;
+        stack.push_back(UDT);
+        BindUtil::call<void(bdld::Datum), &count>(&context);
+        ASSERT(1 == s_numCalls);
+        ASSERT(2 == stack.size());
+        ASSERT(stack.back().isNull());
+        stack.pop_back();
+
+        ASSERT(bdld::Datum::createInteger(7) == stack.back());
+        ASSERT(0 == context.status());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        const bdld::Datum f = BindUtil::bind<double(double, int), &scale>();
+        ASSERT(DatumUtil::isExternalFunction(f));
+        ASSERT((&BindUtil::call<double(double, int), &scale>) ==
+                                             DatumUtil::theExternalFunction(f));
+
+        bdlma::LocalSequentialAllocator<256> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+        stack.push_back(bdld::Datum::createDouble(1.5));
+        stack.push_back(bdld::Datum::createInteger(4));
+        DatumUtil::theExternalFunction(f)(&context);
+        ASSERT(1 == stack.size());
+        ASSERTV(stack.back(), bdld::Datum::createDouble(6) == stack.back());
+        ASSERT(0 == context.status());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
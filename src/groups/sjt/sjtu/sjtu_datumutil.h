@@ -8,6 +8,10 @@
 #endif
 
 namespace sjtt { class ExecutionContext; }
+namespace sjtt { class LoopCounter; }
+namespace sjtt { class Object; }
+namespace sjtt { class PropertyCache; }
+namespace sjtt { class TypeFeedback; }
 
 namespace sjtu {
 
@@ -29,6 +33,18 @@ struct DatumUtil {
         e_ExternalFunction,
             // the data of the datum will be of type 'ExternalFunction'
 
+        e_Object,
+            // the data of the datum will be of type 'sjtt::Object *'
+
+        e_PropertyCache,
+            // the data of the datum will be of type 'sjtt::PropertyCache *'
+
+        e_TypeFeedback,
+            // the data of the datum will be of type 'sjtt::TypeFeedback *'
+
+        e_LoopCounter,
+            // the data of the datum will be of type 'sjtt::LoopCounter *'
+
         e_User,
             // Values >= 'e_User' are available for use by clients of Scramjet
     };
@@ -36,7 +52,181 @@ struct DatumUtil {
     // CLASS DATA
     static const Datum s_Null;         // 'Datum::creaetNull'
     static const Datum s_Undefined;    // 'Datum::createUdt(0, d_Undefined)`
+
+    // CLASS METHODS
+    static Datum createExternalFunction(ExternalFunction function);
+        // Return a 'Datum' having the UDT type 'e_ExternalFunction' and
+        // referring to the specified 'function'.
+
+    static bool isExternalFunction(const Datum& value);
+        // Return 'true' if the specified 'value' was created by
+        // 'createExternalFunction', and 'false' otherwise.
+
+    static ExternalFunction theExternalFunction(const Datum& value);
+        // Return the function referred to by the specified 'value'.  The
+        // behavior is undefined unless 'isExternalFunction(value)'.
+
+    static Datum createObject(sjtt::Object *object);
+        // Return a 'Datum' having the UDT type 'e_Object' and referring to
+        // the specified 'object'.
+
+    static bool isObject(const Datum& value);
+        // Return 'true' if the specified 'value' was created by
+        // 'createObject', and 'false' otherwise.
+
+    static sjtt::Object *theObject(const Datum& value);
+        // Return the object referred to by the specified 'value'.  The
+        // behavior is undefined unless 'isObject(value)'.
+
+    static Datum createPropertyCache(sjtt::PropertyCache *cache);
+        // Return a 'Datum' having the UDT type 'e_PropertyCache' and
+        // referring to the specified 'cache', e.g., the data of an
+        // 'e_GetProperty' opcode.
+
+    static bool isPropertyCache(const Datum& value);
+        // Return 'true' if the specified 'value' was created by
+        // 'createPropertyCache', and 'false' otherwise.
+
+    static sjtt::PropertyCache *thePropertyCache(const Datum& value);
+        // Return the cache referred to by the specified 'value'.  The
+        // behavior is undefined unless 'isPropertyCache(value)'.
+
+    static Datum createTypeFeedback(sjtt::TypeFeedback *feedback);
+        // Return a 'Datum' having the UDT type 'e_TypeFeedback' and referring
+        // to the specified 'feedback', e.g., the data of an 'e_AddIntegers'
+        // opcode.
+
+    static bool isTypeFeedback(const Datum& value);
+        // Return 'true' if the specified 'value' was created by
+        // 'createTypeFeedback', and 'false' otherwise.
+
+    static sjtt::TypeFeedback *theTypeFeedback(const Datum& value);
+        // Return the type-feedback slot referred to by the specified
+        // 'value'.  The behavior is undefined unless 'isTypeFeedback(value)'.
+
+    static Datum createLoopCounter(sjtt::LoopCounter *counter);
+        // Return a 'Datum' having the UDT type 'e_LoopCounter' and referring
+        // to the specified 'counter', e.g., the data of an 'e_LoopHeader'
+        // opcode.
+
+    static bool isLoopCounter(const Datum& value);
+        // Return 'true' if the specified 'value' was created by
+        // 'createLoopCounter', and 'false' otherwise.
+
+    static sjtt::LoopCounter *theLoopCounter(const Datum& value);
+        // Return the loop counter referred to by the specified 'value'.  The
+        // behavior is undefined unless 'isLoopCounter(value)'.
 };
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                              // ----------------
+                              // struct DatumUtil
+                              // ----------------
+
+// CLASS METHODS
+inline
+DatumUtil::Datum DatumUtil::createExternalFunction(ExternalFunction function)
+{
+    BSLS_ASSERT(0 != function);
+    return Datum::createUdt(reinterpret_cast<void *>(function),
+                            e_ExternalFunction);
+}
+
+inline
+bool DatumUtil::isExternalFunction(const Datum& value)
+{
+    return value.isUdt() && e_ExternalFunction == value.theUdt().type();
+}
+
+inline
+DatumUtil::ExternalFunction DatumUtil::theExternalFunction(const Datum& value)
+{
+    BSLS_ASSERT_SAFE(isExternalFunction(value));
+    return reinterpret_cast<ExternalFunction>(value.theUdt().data());
+}
+
+inline
+DatumUtil::Datum DatumUtil::createObject(sjtt::Object *object)
+{
+    BSLS_ASSERT(0 != object);
+    return Datum::createUdt(object, e_Object);
+}
+
+inline
+bool DatumUtil::isObject(const Datum& value)
+{
+    return value.isUdt() && e_Object == value.theUdt().type();
+}
+
+inline
+sjtt::Object *DatumUtil::theObject(const Datum& value)
+{
+    BSLS_ASSERT_SAFE(isObject(value));
+    return static_cast<sjtt::Object *>(value.theUdt().data());
+}
+
+inline
+DatumUtil::Datum DatumUtil::createPropertyCache(sjtt::PropertyCache *cache)
+{
+    BSLS_ASSERT(0 != cache);
+    return Datum::createUdt(cache, e_PropertyCache);
+}
+
+inline
+bool DatumUtil::isPropertyCache(const Datum& value)
+{
+    return value.isUdt() && e_PropertyCache == value.theUdt().type();
+}
+
+inline
+sjtt::PropertyCache *DatumUtil::thePropertyCache(const Datum& value)
+{
+    BSLS_ASSERT_SAFE(isPropertyCache(value));
+    return static_cast<sjtt::PropertyCache *>(value.theUdt().data());
+}
+
+inline
+DatumUtil::Datum DatumUtil::createTypeFeedback(sjtt::TypeFeedback *feedback)
+{
+    BSLS_ASSERT(0 != feedback);
+    return Datum::createUdt(feedback, e_TypeFeedback);
+}
+
+inline
+bool DatumUtil::isTypeFeedback(const Datum& value)
+{
+    return value.isUdt() && e_TypeFeedback == value.theUdt().type();
+}
+
+inline
+sjtt::TypeFeedback *DatumUtil::theTypeFeedback(const Datum& value)
+{
+    BSLS_ASSERT_SAFE(isTypeFeedback(value));
+    return static_cast<sjtt::TypeFeedback *>(value.theUdt().data());
+}
+
+inline
+DatumUtil::Datum DatumUtil::createLoopCounter(sjtt::LoopCounter *counter)
+{
+    BSLS_ASSERT(0 != counter);
+    return Datum::createUdt(counter, e_LoopCounter);
+}
+
+inline
+bool DatumUtil::isLoopCounter(const Datum& value)
+{
+    return value.isUdt() && e_LoopCounter == value.theUdt().type();
+}
+
+inline
+sjtt::LoopCounter *DatumUtil::theLoopCounter(const Datum& value)
+{
+    BSLS_ASSERT_SAFE(isLoopCounter(value));
+    return static_cast<sjtt::LoopCounter *>(value.theUdt().data());
+}
 }
 
 #endif
@@ -2,8 +2,15 @@
 
 #include <sjtu_datumutil.h>
 
+#include <sjtt_loopcounter.h>
+#include <sjtt_object.h>
+#include <sjtt_propertycache.h>
+#include <sjtt_shape.h>
+#include <sjtt_typefeedback.h>
+
 #include <bdls_testutil.h>
 #include <bdlma_localsequentialallocator.h>
+#include <bslma_testallocator.h>
 
 using namespace BloombergLP;
 using namespace bsl;
@@ -67,6 +74,79 @@ int main(int argc, char *argv[])
     cout << "TEST " << __FILE__ << " CASE " << test << endl;
 
     switch (test) { case 0:
+      case 6: {
+        if (verbose) cout << endl
+                          << "createLoopCounter" << endl
+                          << "=================" << endl;
+
+        sjtt::LoopCounter counter;
+
+        const bdld::Datum c = DatumUtil::createLoopCounter(&counter);
+        ASSERT(c.isUdt());
+        ASSERT(DatumUtil::e_LoopCounter == c.theUdt().type());
+        ASSERT(DatumUtil::isLoopCounter(c));
+        ASSERT(&counter == DatumUtil::theLoopCounter(c));
+        ASSERT(!DatumUtil::isTypeFeedback(c));
+        ASSERT(!DatumUtil::isLoopCounter(DatumUtil::s_Undefined));
+        ASSERT(!DatumUtil::isLoopCounter(bdld::Datum::createInteger(1)));
+      } break;
+      case 5: {
+        if (verbose) cout << endl
+                          << "createTypeFeedback" << endl
+                          << "==================" << endl;
+
+        sjtt::TypeFeedback feedback;
+
+        const bdld::Datum f = DatumUtil::createTypeFeedback(&feedback);
+        ASSERT(f.isUdt());
+        ASSERT(DatumUtil::e_TypeFeedback == f.theUdt().type());
+        ASSERT(DatumUtil::isTypeFeedback(f));
+        ASSERT(&feedback == DatumUtil::theTypeFeedback(f));
+        ASSERT(!DatumUtil::isPropertyCache(f));
+        ASSERT(!DatumUtil::isTypeFeedback(DatumUtil::s_Undefined));
+        ASSERT(!DatumUtil::isTypeFeedback(bdld::Datum::createInteger(1)));
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "createObject, createPropertyCache" << endl
+                          << "=================================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        sjtt::ShapeTable     shapes(&ta);
+        sjtt::Object        *object = sjtt::Object::create(shapes.root(), &ta);
+        sjtt::PropertyCache  cache("x", &ta);
+
+        const bdld::Datum o = DatumUtil::createObject(object);
+        ASSERT(o.isUdt());
+        ASSERT(DatumUtil::e_Object == o.theUdt().type());
+        ASSERT(DatumUtil::isObject(o));
+        ASSERT(object == DatumUtil::theObject(o));
+        ASSERT(!DatumUtil::isPropertyCache(o));
+
+        const bdld::Datum c = DatumUtil::createPropertyCache(&cache);
+        ASSERT(DatumUtil::e_PropertyCache == c.theUdt().type());
+        ASSERT(DatumUtil::isPropertyCache(c));
+        ASSERT(&cache == DatumUtil::thePropertyCache(c));
+        ASSERT(!DatumUtil::isObject(c));
+        ASSERT(!DatumUtil::isObject(DatumUtil::s_Undefined));
+
+        sjtt::Object::destroy(object, &ta);
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "createExternalFunction" << endl
+                          << "======================" << endl;
+        struct Local {
+            static void noop(sjtt::ExecutionContext *) {}
+        };
+        const bdld::Datum f = DatumUtil::createExternalFunction(&Local::noop);
+        ASSERT(f.isUdt());
+        ASSERT(DatumUtil::e_ExternalFunction == f.theUdt().type());
+        ASSERT(DatumUtil::isExternalFunction(f));
+        ASSERT(&Local::noop == DatumUtil::theExternalFunction(f));
+        ASSERT(!DatumUtil::isExternalFunction(DatumUtil::s_Undefined));
+        ASSERT(!DatumUtil::isExternalFunction(DatumUtil::s_Null));
+      } break;
       case 2: {
         if (verbose) cout << endl
                           << "s_Undefined" << endl
@@ -1,2 +1,1431 @@
 // sjtu_interpretutil.cpp
 #include <sjtu_interpretutil.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_continuation.h>
+#include <sjtt_executioncontext.h>
+#include <sjtt_heap.h>
+#include <sjtt_loopcounter.h>
+#include <sjtt_object.h>
+#include <sjtt_program.h>
+#include <sjtt_programimage.h>
+#include <sjtt_propertycache.h>
+#include <sjtt_shape.h>
+#include <sjtt_tieruppolicy.h>
+#include <sjtt_typefeedback.h>
+#include <sjtu_arrayutil.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_numericutil.h>
+#include <sjtu_profile.h>
+#include <sjtu_value.h>
+
+#include <bslmf_assert.h>
+#include <bsls_performancehint.h>
+#include <bsls_platform.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_vector.h>
+
+#if (defined(BSLS_PLATFORM_CMP_GNU) || defined(BSLS_PLATFORM_CMP_CLANG))     \
+ && !defined(SJTU_INTERPRETUTIL_SWITCH_DISPATCH)
+#define SJTU_INTERPRETUTIL_THREADED 1
+#endif
+
+// Each opcode handler is written once, between 'SJTU_OPCODE' and
+// 'SJTU_NEXT'.  With threaded dispatch, the first opcode is dispatched
+// through the 'switch' and every subsequent one by jumping directly to the
+// label of its handler, giving each handler its own (separately predicted)
+// indirect branch.  Each handler starts by notifying the profiler, which
+// compiles to nothing unless the interpreter is instantiated with
+// 'CycleProfiler'.
+
+#ifdef SJTU_INTERPRETUTIL_THREADED
+#define SJTU_OPCODE(NAME) case Bytecode::e_##NAME: op_##NAME:                \
+                              profiler.beginOpcode(Bytecode::e_##NAME);
+#define SJTU_NEXT() goto *k_LABELS[ip.opcode()]
+#else
+#define SJTU_OPCODE(NAME) case Bytecode::e_##NAME:                           \
+                              profiler.beginOpcode(Bytecode::e_##NAME);
+#define SJTU_NEXT() continue
+#endif
+
+namespace sjtu {
+using BloombergLP::bdld::Datum;
+using BloombergLP::bslma::Allocator;
+using sjtt::Bytecode;
+using sjtt::Continuation;
+using sjtt::ExecutionContext;
+using sjtt::Program;
+using sjtt::ProgramImage;
+
+namespace {
+
+                           // ====================
+                           // class BytecodeCursor
+                           // ====================
+
+class BytecodeCursor {
+    // This class provides the position of the interpreter within an array of
+    // 'Bytecode' objects.
+
+    // DATA
+    const Bytecode *d_code;  // first instruction of the program
+    const Bytecode *d_ip;
+
+  public:
+    // CREATORS
+    explicit BytecodeCursor(const Bytecode *code, bsl::size_t pc = 0)
+    : d_code(code)
+    , d_ip(code + pc) {
+    }
+
+    // MANIPULATORS
+    void next() {
+        ++d_ip;
+    }
+
+    void jump(int offset) {
+        d_ip += offset;
+    }
+
+    void moveTo(int position) {
+        d_ip = d_code + position;
+    }
+
+    // ACCESSORS
+    Bytecode::Opcode opcode() const {
+        return d_ip->opcode();
+    }
+
+    const Datum& data() const {
+        return d_ip->data();
+    }
+
+    int position() const {
+        return static_cast<int>(d_ip - d_code);
+    }
+
+    void save(Continuation *continuation) const {
+        continuation->setPosition(d_code, d_ip - d_code);
+    }
+};
+
+                            // ===================
+                            // class ProgramCursor
+                            // ===================
+
+class ProgramCursor {
+    // This class provides the position of the interpreter within a 'Program'
+    // or a 'ProgramImage'.
+
+    // DATA
+    const Program::OpcodeType *d_opcodes;
+    const Program::Operand    *d_operands;
+    const Datum               *d_constants;
+    bsl::size_t                d_pc;
+    const Program             *d_program_p;  // program, or 0 for an image
+    const ProgramImage        *d_image_p;    // image, or 0 for a program
+
+  public:
+    // CREATORS
+    explicit ProgramCursor(const Program& program, bsl::size_t pc = 0)
+    : d_opcodes(program.opcodes())
+    , d_operands(program.operands())
+    , d_constants(program.constants())
+    , d_pc(pc)
+    , d_program_p(&program)
+    , d_image_p(0) {
+    }
+
+    explicit ProgramCursor(const ProgramImage& image, bsl::size_t pc = 0)
+    : d_opcodes(image.opcodes())
+    , d_operands(image.operands())
+    , d_constants(image.constants())
+    , d_pc(pc)
+    , d_program_p(0)
+    , d_image_p(&image) {
+    }
+
+    // MANIPULATORS
+    void next() {
+        ++d_pc;
+    }
+
+    void jump(int offset) {
+        d_pc = static_cast<bsl::size_t>(static_cast<bsl::ptrdiff_t>(d_pc) +
+                                        offset);
+    }
+
+    void moveTo(int position) {
+        d_pc = position;
+    }
+
+    // ACCESSORS
+    Bytecode::Opcode opcode() const {
+        return static_cast<Bytecode::Opcode>(d_opcodes[d_pc]);
+    }
+
+    const Datum& data() const {
+        return d_constants[d_operands[d_pc]];
+    }
+
+    int position() const {
+        return static_cast<int>(d_pc);
+    }
+
+    void save(Continuation *continuation) const {
+        if (d_program_p) {
+            continuation->setPosition(d_program_p, d_pc);
+        }
+        else {
+            continuation->setPosition(d_image_p, d_pc);
+        }
+    }
+};
+
+                              // ================
+                              // class ValueStack
+                              // ================
+
+class ValueStack {
+    // This class provides the operations shared by the stack policies of the
+    // interpreter on the part of its value stack below the cached top value.
+    // Values are held as 'Value' objects, in a buffer supplied by the
+    // interpreter (see 'attach') or in memory from the allocator of the
+    // context, and are copied to the 'Datum' stack of the context only
+    // before external calls and when the program is suspended.  The copies
+    // made for a call are kept on the stack of the context after it, as
+    // long as the values they mirror are not popped, so that a call only
+    // copies the values pushed since the previous one, and only its result
+    // is read back, unless the callee collected the heap of the context,
+    // which moves the values on that stack.
+    //
+    // A value that must refer to a 'Datum' not owned by the program, e.g.,
+    // one read from a global or returned by an external function, refers to
+    // a copy held in a box: 'box' makes such a value for the top of the stack
+    // when 'n' values are stored below it, and uses the box 'n'.  Since
+    // values only move by being pushed and popped, no value refers to box
+    // 'n' any more once the stack is popped down to 'n' values and the top is
+    // replaced, which is when the box is reused; and every box is refilled
+    // when all values are read back after a collection.  Values copied
+    // elsewhere in the stack, by 'load' and 'store', are given a box of their
+    // own for the same reason.
+
+  protected:
+    // DATA
+    bsl::vector<Datum>&  d_datums;       // stack of the context
+    const bsl::size_t    d_base;         // size of 'd_datums' on entry
+    Allocator           *d_allocator_p;  // allocator of the context (held)
+    const sjtt::Heap    *d_heap_p;       // heap of the context, or 0
+    sjtt::HeapStats::Int64
+                         d_numCollections;
+                                         // minor collections of the heap
+                                         // before the current call
+    bsl::vector<Value>   d_spill;        // values outgrowing the buffer
+    bsl::vector<Datum>   d_spillBoxes;   // boxes outgrowing the buffer
+    Value               *d_begin;        // bottom of the stack
+    Value               *d_sp;           // one past the last stored value
+    Value               *d_mirrored;     // one past the last value copied
+                                         // to 'd_datums'
+    Value               *d_end;          // end of the storage of the stack
+    Datum               *d_boxes;        // box of each position
+
+    // PROTECTED MANIPULATORS
+    void grow(Value *value) {
+        // Move the values and their boxes to storage twice as large, and
+        // make the values, and the specified 'value', refer to the moved
+        // boxes.
+
+        const bsl::size_t  capacity = d_end - d_begin;
+        const bsl::size_t  depth    = d_sp - d_begin;
+        const Datum       *oldBoxes = d_boxes;
+        bsl::vector<Value> values(d_allocator_p);
+        bsl::vector<Datum> boxes(d_allocator_p);
+        values.resize(2 * capacity);
+        boxes.resize(2 * capacity + 1);
+        bsl::copy(oldBoxes, oldBoxes + capacity + 1, boxes.begin());
+
+        for (bsl::size_t i = 0; i <= depth; ++i) {
+            Value& moved = i < depth ? values[i] : *value;
+            moved = i < depth ? d_begin[i] : *value;
+            if (moved.isReference()) {
+                const Datum *box = &moved.theReference();
+                if (oldBoxes <= box && box <= oldBoxes + capacity) {
+                    moved = Value::createReference(boxes.data() +
+                                                   (box - oldBoxes));
+                }
+            }
+        }
+        const bsl::size_t numMirrored = d_mirrored - d_begin;
+        d_spill.swap(values);
+        d_spillBoxes.swap(boxes);
+        d_begin    = d_spill.data();
+        d_sp       = d_begin + depth;
+        d_mirrored = d_begin + numMirrored;
+        d_end      = d_begin + d_spill.size();
+        d_boxes    = d_spillBoxes.data();
+    }
+
+    void setBuffer(Value *buffer, Datum *boxes, bsl::size_t size) {
+        // Hold the values, none yet, in the specified 'buffer' of the
+        // specified 'size', and their boxes in the specified 'boxes'.
+
+        d_begin    = buffer;
+        d_sp       = buffer;
+        d_mirrored = buffer;
+        d_end      = buffer + size;
+        d_boxes    = boxes;
+    }
+
+  public:
+    // CREATORS
+    explicit ValueStack(ExecutionContext *context)
+    : d_datums(*context->stack())
+    , d_base(context->stack()->size())
+    , d_allocator_p(context->allocator())
+    , d_heap_p(context->heap())
+    , d_numCollections(0)
+    , d_spill(context->allocator())
+    , d_spillBoxes(context->allocator())
+    , d_begin(0)
+    , d_sp(0)
+    , d_mirrored(0)
+    , d_end(0)
+    , d_boxes(0) {
+    }
+
+    // MANIPULATORS
+    void pop() {
+        --d_sp;
+    }
+
+    void truncate(bsl::size_t depth) {
+        d_sp = d_begin + depth;
+        if (d_sp < d_mirrored) {
+            d_mirrored = d_sp;
+        }
+    }
+
+    Value back() const {
+        return d_sp[-1];
+    }
+
+    Value box(const Datum& datum) {
+        const Value value = Value::fromDatum(datum);
+        if (!value.isReference()) {
+            return value;                                             // RETURN
+        }
+        Datum *box = d_boxes + (d_sp - d_begin);
+        *box = datum;
+        return Value::createReference(box);
+    }
+
+    Value load(bsl::size_t index) {
+        // Return the value at 'index', as the value for the top of the stack.
+
+        const Value value = d_begin[index];
+        return value.isReference() ? box(value.theReference()) : value;
+    }
+
+    void store(bsl::size_t index, Value value) {
+        if (value.isReference()) {
+            d_boxes[index] = value.theReference();
+            value          = Value::createReference(d_boxes + index);
+        }
+        d_begin[index] = value;
+        if (d_begin + index < d_mirrored) {
+            d_mirrored = d_begin + index;
+        }
+    }
+
+    void beforeCall() {
+        // Copy the values not copied since they were pushed onto the stack of
+        // the context, where the callee finds its arguments.
+
+        if (d_sp < d_mirrored) {
+            d_mirrored = d_sp;
+        }
+        d_datums.resize(d_base + (d_mirrored - d_begin));
+        for (const Value *value = d_mirrored; value != d_sp; ++value) {
+            d_datums.push_back(value->toDatum());
+        }
+        d_mirrored = d_sp;
+        if (d_heap_p) {
+            d_numCollections = d_heap_p->stats().d_numMinorCollections;
+        }
+    }
+
+    int afterCall(Value *result) {
+        // The callee popped its arguments and pushed its result, leaving the
+        // values below them alone: load the result into the specified
+        // 'result', and read back every other value only if the callee
+        // collected the heap, which moves the values on the stack of the
+        // context.  Return 0 on success, and a non-zero value if the callee
+        // left no result, or more values than the stack held before the
+        // call.
+
+        // The bottom value is the placeholder the program started with (see
+        // 'run'), which the callee must leave below its result: if it did
+        // not, or popped values below 'd_base', the unsigned subtraction
+        // wraps, so one comparison checks both bounds.
+
+        const bsl::size_t numValues = d_datums.size() - d_base;
+        if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+              numValues - 2 > static_cast<bsl::size_t>(d_sp - d_begin) - 1)) {
+            return 1;                                                 // RETURN
+        }
+        const Datum *datum = d_datums.data() + d_base;
+        const Datum *last  = d_datums.data() + d_datums.size() - 1;
+        if (d_heap_p && d_numCollections !=
+                                   d_heap_p->stats().d_numMinorCollections) {
+            d_sp = d_begin;
+            for (; datum != last; ++datum) {
+                const Value value = box(*datum);
+                *d_sp++ = value;
+            }
+        }
+        else {
+            d_sp = d_begin + (last - datum);
+        }
+        *result = box(*last);
+        d_datums.pop_back();
+        d_mirrored = d_sp;
+        return 0;
+    }
+
+    void restore() {
+        d_datums.resize(d_base);
+    }
+
+    // ACCESSORS
+    Value at(bsl::size_t index) const {
+        return d_begin[index];
+    }
+
+    bsl::size_t depth() const {
+        return d_sp - d_begin;
+    }
+
+    void saveValues(Continuation *continuation) const {
+        bsl::vector<Datum>& saved = *continuation->stack();
+        saved.clear();
+        for (const Value *value = d_begin; value != d_sp; ++value) {
+            saved.push_back(value->toDatum());
+        }
+    }
+};
+
+                            // ===================
+                            // class GrowableStack
+                            // ===================
+
+class GrowableStack : public ValueStack {
+    // This class provides the operations used by the interpreter on the part
+    // of its value stack below the cached top value, growing the stack as
+    // needed.  Since the program may not be verified, and may therefore pop
+    // values below the result of the latest call, each push checks whether
+    // it overwrites a value copied to the stack of the context for that
+    // call.
+
+  public:
+    // CREATORS
+    explicit GrowableStack(ExecutionContext *context)
+    : ValueStack(context) {
+    }
+
+    // MANIPULATORS
+    void attach(Value *buffer, Datum *boxes, bsl::size_t size) {
+        setBuffer(buffer, boxes, size);
+    }
+
+    void push(Value value) {
+        // Store 'value' on the stack, growing it if it is full, and
+        // dropping the copies of the values from this position up if it is
+        // below 'd_mirrored', with a single comparison in the common case.
+
+        if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                           static_cast<bsl::size_t>(d_sp - d_mirrored) >=
+                           static_cast<bsl::size_t>(d_end - d_mirrored))) {
+            if (d_sp == d_end) {
+                grow(&value);
+            }
+            else {
+                d_mirrored = d_sp;
+            }
+        }
+        *d_sp++ = value;
+    }
+
+    void reserve(Value *, bsl::size_t) {
+        // Every push grows the stack as needed.
+    }
+
+    // ACCESSORS
+    void save(Continuation *continuation) const {
+        saveValues(continuation);
+        continuation->setMaxDepth(0);
+    }
+};
+
+                            // ===================
+                            // class ReservedStack
+                            // ===================
+
+class ReservedStack : public ValueStack {
+    // This class provides the operations used by the interpreter on the part
+    // of its value stack below the cached top value, for a verified program
+    // whose maximum depth, that of its deepest frame, is known.  Storage for
+    // that depth is reserved up front, for the values and on the stack of
+    // the context, so pushes and pops are plain pointer updates, with no
+    // bounds or capacity checks, and external calls never grow the stack of
+    // the context.  Since calls of script functions may nest without bound,
+    // each call reserves room for one more frame of the maximum depth.  Nor
+    // do pushes check whether they overwrite values copied to the stack of
+    // the context for the latest external call: a verified program pops no
+    // value below the result of that call, other than by returning from a
+    // script function (see 'truncate').
+
+    // DATA
+    const bsl::size_t d_maxDepth;
+
+  public:
+    // CREATORS
+    ReservedStack(ExecutionContext *context, bsl::size_t maxDepth)
+    : ValueStack(context)
+    , d_maxDepth(maxDepth) {
+        d_datums.reserve(d_base + d_maxDepth);
+    }
+
+    // MANIPULATORS
+    void attach(Value *buffer, Datum *boxes, bsl::size_t size) {
+        if (d_maxDepth > size) {
+            d_spill.resize(d_maxDepth);
+            d_spillBoxes.resize(d_maxDepth + 1);
+            buffer = d_spill.data();
+            boxes  = d_spillBoxes.data();
+            size   = d_maxDepth;
+        }
+        setBuffer(buffer, boxes, size);
+    }
+
+    void push(Value value) {
+        *d_sp++ = value;
+    }
+
+    void reserve(Value *top, bsl::size_t numValues) {
+        // Make room for 'numValues' values followed by a frame of the
+        // maximum depth, moving the values, and 'top', if needed.
+
+        if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                 static_cast<bsl::size_t>(d_end - d_sp) <=
+                                                   numValues + d_maxDepth)) {
+            do {
+                grow(top);
+            } while (static_cast<bsl::size_t>(d_end - d_sp) <=
+                                                     numValues + d_maxDepth);
+            d_datums.reserve(d_base + (d_end - d_begin));
+        }
+    }
+
+    // ACCESSORS
+    void save(Continuation *continuation) const {
+        saveValues(continuation);
+        continuation->setMaxDepth(d_maxDepth);
+    }
+};
+
+                            // ==================
+                            // class NullProfiler
+                            // ==================
+
+class NullProfiler {
+    // This class provides the operations used by the interpreter to profile
+    // the program being interpreted, doing nothing, so that the interpreter
+    // has no instrumentation unless it is instantiated with 'CycleProfiler'.
+
+  public:
+    // MANIPULATORS
+    void beginOpcode(Bytecode::Opcode) {
+    }
+
+    void beginCall() {
+    }
+
+    void endCall(DatumUtil::ExternalFunction) {
+    }
+
+    void finish() {
+    }
+};
+
+                            // ===================
+                            // class CycleProfiler
+                            // ===================
+
+class CycleProfiler {
+    // This class provides the operations used by the interpreter to profile
+    // the program being interpreted, recording the cycles between the start
+    // of consecutive handlers as the cost of the earlier one, and the cycles
+    // spent in each external function, in a 'Profile'.
+
+    // DATA
+    Profile          *d_profile_p;   // receives the statistics (held)
+    Bytecode::Opcode  d_opcode;      // opcode being executed
+    Profile::Uint64   d_start;       // when 'd_opcode' started
+    Profile::Uint64   d_callStart;   // when the current call started
+    bool              d_isRunning;   // 'd_opcode' is valid
+
+  public:
+    // CREATORS
+    explicit CycleProfiler(Profile *profile)
+    : d_profile_p(profile)
+    , d_opcode(Bytecode::e_Return)
+    , d_start(0)
+    , d_callStart(0)
+    , d_isRunning(false) {
+    }
+
+    // MANIPULATORS
+    void beginOpcode(Bytecode::Opcode opcode) {
+        const Profile::Uint64 now = Profile::readCycles();
+        if (d_isRunning) {
+            d_profile_p->recordOpcode(d_opcode, now - d_start);
+        }
+        d_opcode    = opcode;
+        d_start     = now;
+        d_isRunning = true;
+    }
+
+    void beginCall() {
+        d_callStart = Profile::readCycles();
+    }
+
+    void endCall(DatumUtil::ExternalFunction function) {
+        // The time spent in 'function' is not charged to 'e_Execute'.
+
+        const Profile::Uint64 cycles = Profile::readCycles() - d_callStart;
+        d_profile_p->recordCall(function, cycles);
+        d_start += cycles;
+    }
+
+    void finish() {
+        if (d_isRunning) {
+            d_profile_p->recordOpcode(d_opcode,
+                                      Profile::readCycles() - d_start);
+            d_isRunning = false;
+        }
+    }
+};
+
+enum {
+    k_BUFFER_DEPTH = 64  // values held on the program stack by 'run'
+};
+
+bsl::size_t slotIndex(int frame, int slot)
+    // Return the index, in the value stack, of the specified 'slot' of the
+    // frame whose linkage is at the specified 'frame' index.
+{
+    return frame + (slot < 0 ? slot : InterpretUtil::k_FRAME_LINKAGE + slot);
+}
+
+template <class CURSOR, class STACK, class PROFILER>
+int run(Datum            *result,
+        ExecutionContext *context,
+        Continuation     *continuation,
+        CURSOR            ip,
+        STACK             stack,
+        Value             top,
+        PROFILER          profiler)
+    // Interpret the program at the specified 'ip' as described for
+    // 'InterpretUtil::interpret', using the specified 'context', whose value
+    // stack is manipulated through the specified 'stack', with the specified
+    // 'top' as the value on the top of the stack, and loading the returned
+    // value into the specified 'result'.  If the specified 'continuation' is
+    // suspended, the program is resumed from it: the values saved in it are
+    // pushed below 'top', the frame saved in it is made current, and it is
+    // emptied.  If an external function
+    // suspends the program, save its state into 'continuation', unless it is
+    // 0.  Report the opcodes executed and the external functions called to
+    // the specified 'profiler'.
+{
+#ifdef SJTU_INTERPRETUTIL_THREADED
+    static const void *const k_LABELS[] = {
+        &&op_Push,
+        &&op_AddDoubles,
+        &&op_Execute,
+        &&op_Return,
+        &&op_Pop,
+        &&op_PushAddDoubles,
+        &&op_GetGlobalSlot,
+        &&op_SetGlobalSlot,
+        &&op_AddArrays,
+        &&op_MultiplyArrays,
+        &&op_MultiplyAddArrays,
+        &&op_SumArray,
+        &&op_DotArrays,
+        &&op_NewObject,
+        &&op_GetProperty,
+        &&op_SetProperty,
+        &&op_AddIntegers,
+        &&op_SubtractIntegers,
+        &&op_MultiplyIntegers,
+        &&op_LessIntegers,
+        &&op_Jump,
+        &&op_JumpIfFalse,
+        &&op_LoopHeader,
+        &&op_Loop,
+        &&op_Function,
+        &&op_Call,
+        &&op_TailCall,
+        &&op_GetLocal,
+        &&op_SetLocal,
+    };
+    BSLMF_ASSERT(Bytecode::k_NUM_OPCODES ==
+                                      sizeof(k_LABELS) / sizeof(*k_LABELS));
+#endif
+
+    ExecutionContext::Globals *globals = context->globals();
+    sjtt::Heap                *heap    = context->heap();
+    sjtt::TierUpPolicy        *policy  = context->tierUpPolicy();
+    const sjtt::LoopCounter::Int64
+                               hotLoop = context->loopThreshold();
+    Value                      buffer[k_BUFFER_DEPTH];
+    Datum                      boxes[k_BUFFER_DEPTH + 1];
+    Datum                      datum;
+    int                        frame = -1;
+    int                        rc;
+
+    stack.attach(buffer, boxes, k_BUFFER_DEPTH);
+    if (continuation && continuation->isSuspended()) {
+        const bsl::vector<Datum>& saved = *continuation->stack();
+        frame = continuation->frame();
+        if (0 <= frame) {
+            stack.reserve(&top, saved.size());
+        }
+        for (bsl::size_t i = 0; i < saved.size(); ++i) {
+            stack.push(stack.box(saved[i]));
+        }
+        continuation->reset();
+    }
+
+    // 'top' holds the value on the top of the stack, which is not stored in
+    // 'stack'.  A program is started with a placeholder in 'top' that is
+    // pushed by the first 'e_Push', so that 'top' is always valid.  'datum'
+    // receives the results of the array kernels.  'hotLoop' is 0 unless a
+    // policy is set, so that no counter ever reaches it.  'frame' is the
+    // index of the linkage of the frame of the script function being run,
+    // or -1 outside of any function: the frame holds the arguments below the
+    // linkage, and the values pushed by the function above it.  The linkage
+    // is the position to return to, the frame of the caller, and the number
+    // of arguments, the last of which is held in 'top' until the function
+    // pushes a value.  Every value of a frame, but the top one, is stored in
+    // 'stack' whenever 'top' has just been pushed.
+
+    for (;;) {
+        switch (ip.opcode()) {
+          SJTU_OPCODE(Push) {
+            stack.push(top);
+            top = Value::fromDatum(ip.data());
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(AddDoubles) {
+            const Value lhs = stack.back();
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(!lhs.isDouble()
+                                                   || !top.isDouble())) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            top = Value::createRawDouble(lhs.theDouble() + top.theDouble());
+            stack.pop();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(Execute) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                                 !top.isExternalFunction())) {
+                rc = InterpretUtil::e_NotCallable;
+                goto done;
+            }
+            const DatumUtil::ExternalFunction function =
+                                                   top.theExternalFunction();
+            stack.beforeCall();
+            profiler.beginCall();
+            function(context);
+            profiler.endCall(function);
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                                 0 != stack.afterCall(&top))) {
+                context->setStatus(0);
+                rc = InterpretUtil::e_BadCall;
+                goto done;
+            }
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                                  0 != context->status())) {
+                rc = context->status();
+                context->setStatus(0);
+                if (InterpretUtil::e_Suspended == rc && continuation) {
+                    // The placeholder result is replaced on resumption.
+
+                    ip.next();
+                    ip.save(continuation);
+                    stack.save(continuation);
+                    continuation->setFrame(frame);
+                }
+                goto done;
+            }
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(Pop) {
+            top = stack.back();
+            stack.pop();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(PushAddDoubles) {
+            const Datum& rhs = ip.data();
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(!top.isDouble()
+                                                   || !rhs.isDouble())) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            top = Value::createDouble(top.theDouble() + rhs.theDouble());
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(GetGlobalSlot) {
+            BSLS_ASSERT_SAFE(0 != globals);
+            BSLS_ASSERT_SAFE(ip.data().theInteger() <
+                                           static_cast<int>(globals->size()));
+            stack.push(top);
+            top = stack.box((*globals)[ip.data().theInteger()].datum());
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(SetGlobalSlot) {
+            BSLS_ASSERT_SAFE(0 != globals);
+            BSLS_ASSERT_SAFE(ip.data().theInteger() <
+                                           static_cast<int>(globals->size()));
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(top.isObject())) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            sjtt::GlobalValue& global = (*globals)[ip.data().theInteger()];
+            datum = top.toDatum();
+            if (heap) {
+                heap->recordWrite(datum);
+                global.refer(datum);
+            }
+            else {
+                global.clone(datum);
+            }
+            top = stack.back();
+            stack.pop();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(AddArrays) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        0 != ArrayUtil::add(&datum,
+                                            stack.back().toDatum(),
+                                            top.toDatum(),
+                                            context->allocator()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            stack.pop();
+            top = stack.box(datum);
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(MultiplyArrays) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        0 != ArrayUtil::multiply(&datum,
+                                                 stack.back().toDatum(),
+                                                 top.toDatum(),
+                                                 context->allocator()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            stack.pop();
+            top = stack.box(datum);
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(MultiplyAddArrays) {
+            const Value rhs = stack.back();
+            stack.pop();
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        0 != ArrayUtil::multiplyAdd(&datum,
+                                                    stack.back().toDatum(),
+                                                    rhs.toDatum(),
+                                                    top.toDatum(),
+                                                    context->allocator()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            stack.pop();
+            top = stack.box(datum);
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(SumArray) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                0 != ArrayUtil::sum(&datum, top.toDatum()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            top = Value::createDouble(datum.theDouble());
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(DotArrays) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        0 != ArrayUtil::dot(&datum,
+                                            stack.back().toDatum(),
+                                            top.toDatum()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            stack.pop();
+            top = Value::createDouble(datum.theDouble());
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(NewObject) {
+            BSLS_ASSERT_SAFE(0 != context->shapes());
+            stack.push(top);
+            top = Value::createObject(sjtt::Object::create(
+                                                   context->shapes()->root(),
+                                                   context->allocator()));
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(GetProperty) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(!top.isObject())) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            const sjtt::Object               *object = top.theObject();
+            sjtt::PropertyCache              *cache  =
+                                       DatumUtil::thePropertyCache(ip.data());
+            const sjtt::PropertyCache::Entry *entry  =
+                                              cache->find(object->shapeId());
+            int slot;
+            if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(0 != entry)) {
+                slot = entry->d_slot;
+            }
+            else {
+                slot = object->shape()->findSlot(cache->name());
+                cache->insert(object->shapeId(), slot);
+            }
+            top = 0 <= slot ? stack.box(object->slot(slot))
+                            : Value::createUndefined();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(SetProperty) {
+            const Value target = stack.back();
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(!target.isObject())) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            sjtt::Object                     *object = target.theObject();
+            sjtt::PropertyCache              *cache  =
+                                       DatumUtil::thePropertyCache(ip.data());
+            const sjtt::PropertyCache::Entry *entry  =
+                                              cache->find(object->shapeId());
+            datum = top.toDatum();
+            if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(0 != entry)) {
+                if (entry->d_next_p) {
+                    object->addProperty(entry->d_next_p,
+                                        datum,
+                                        context->allocator());
+                }
+                else {
+                    object->setSlot(entry->d_slot, datum);
+                }
+            }
+            else {
+                const sjtt::Shape::Int64 id   = object->shapeId();
+                const int                slot = object->shape()->findSlot(
+                                                               cache->name());
+                if (0 <= slot) {
+                    object->setSlot(slot, datum);
+                    cache->insert(id, slot);
+                }
+                else {
+                    BSLS_ASSERT_SAFE(0 != context->shapes());
+                    const sjtt::Shape *next = context->shapes()->addProperty(
+                                                              object->shape(),
+                                                              cache->name());
+                    cache->insert(id, object->numSlots(), next);
+                    object->addProperty(next, datum, context->allocator());
+                }
+            }
+            top = target;
+            stack.pop();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(AddIntegers) {
+            const NumericUtil::Kind kind = NumericUtil::add(&top,
+                                                            stack.back(),
+                                                            top);
+            DatumUtil::theTypeFeedback(ip.data())->record(kind);
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                      sjtt::TypeFeedback::e_Other == kind)) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            stack.pop();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(SubtractIntegers) {
+            const NumericUtil::Kind kind = NumericUtil::subtract(&top,
+                                                                 stack.back(),
+                                                                 top);
+            DatumUtil::theTypeFeedback(ip.data())->record(kind);
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                      sjtt::TypeFeedback::e_Other == kind)) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            stack.pop();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(MultiplyIntegers) {
+            const NumericUtil::Kind kind = NumericUtil::multiply(&top,
+                                                                 stack.back(),
+                                                                 top);
+            DatumUtil::theTypeFeedback(ip.data())->record(kind);
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                      sjtt::TypeFeedback::e_Other == kind)) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            stack.pop();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(LessIntegers) {
+            const NumericUtil::Kind kind = NumericUtil::less(&top,
+                                                             stack.back(),
+                                                             top);
+            DatumUtil::theTypeFeedback(ip.data())->record(kind);
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                      sjtt::TypeFeedback::e_Other == kind)) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            stack.pop();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(Jump) {
+            ip.jump(ip.data().theInteger());
+          } SJTU_NEXT();
+          SJTU_OPCODE(JumpIfFalse) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(!top.isBoolean())) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            const bool condition = top.theBoolean();
+            top = stack.back();
+            stack.pop();
+            if (condition) {
+                ip.next();
+            }
+            else {
+                ip.jump(ip.data().theInteger());
+            }
+          } SJTU_NEXT();
+          SJTU_OPCODE(LoopHeader) {
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(Loop) {
+            ip.jump(ip.data().theInteger());
+            sjtt::LoopCounter *loop = DatumUtil::theLoopCounter(ip.data());
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                            hotLoop == loop->increment())) {
+                policy->onHotLoop(context, loop);
+                if (0 != context->status()) {
+                    rc = context->status();
+                    context->setStatus(0);
+                    goto done;
+                }
+            }
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(Function) {
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(Call) {
+            stack.reserve(&top, 0);
+            stack.push(top);
+            const int position = ip.position() + 1;
+            ip.jump(ip.data().theInteger());
+            const int numArguments = ip.data().theInteger();
+            const int callee       = static_cast<int>(stack.depth());
+            stack.push(Value::createInteger(position));
+            stack.push(Value::createInteger(frame));
+            top   = Value::createInteger(numArguments);
+            frame = callee;
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(TailCall) {
+            // The arguments replace those of the function being run, whose
+            // linkage is moved above them.
+
+            stack.push(top);
+            const Value       position = stack.at(frame);
+            const Value       caller   = stack.at(frame + 1);
+            const bsl::size_t base     = frame -
+                                              stack.at(frame + 2).theInteger();
+            ip.jump(ip.data().theInteger());
+            const int         numArguments = ip.data().theInteger();
+            const bsl::size_t first        = stack.depth() - numArguments;
+            for (int i = 0; i < numArguments; ++i) {
+                stack.store(base + i, stack.at(first + i));
+            }
+            stack.truncate(base + numArguments);
+            frame = static_cast<int>(stack.depth());
+            stack.push(position);
+            stack.push(caller);
+            top = Value::createInteger(numArguments);
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(GetLocal) {
+            stack.push(top);
+            top = stack.load(slotIndex(frame, ip.data().theInteger()));
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(SetLocal) {
+            stack.store(slotIndex(frame, ip.data().theInteger()), top);
+            top = stack.back();
+            stack.pop();
+            ip.next();
+          } SJTU_NEXT();
+          SJTU_OPCODE(Return) {
+            if (0 > frame) {
+                *result = top.toDatum();
+                rc      = InterpretUtil::e_Success;
+                goto done;
+            }
+
+            // The result, which may refer to a box of the frame, takes the
+            // place of the arguments.
+
+            const int position     = stack.at(frame).theInteger();
+            const int caller       = stack.at(frame + 1).theInteger();
+            const int numArguments = stack.at(frame + 2).theInteger();
+            stack.truncate(frame - numArguments);
+            if (top.isReference()) {
+                top = stack.box(top.theReference());
+            }
+            frame = caller;
+            ip.moveTo(position);
+          } SJTU_NEXT();
+        }
+    }
+
+  done:
+    profiler.finish();
+    stack.restore();
+    return rc;
+}
+
+template <class CURSOR>
+int proceed(Datum            *result,
+            ExecutionContext *context,
+            Continuation     *continuation,
+            CURSOR            ip,
+            bsl::size_t       maxDepth,
+            Value             top)
+    // Interpret the program at the specified 'ip' as described for 'run',
+    // using the specified 'context' and 'continuation', with the specified
+    // 'top' on the top of the stack, on a stack of the specified 'maxDepth'
+    // reserved values, or on a growable stack if 'maxDepth' is 0.
+{
+    if (0 == maxDepth) {
+        return run(result,
+                   context,
+                   continuation,
+                   ip,
+                   GrowableStack(context),
+                   top,
+                   NullProfiler());                                   // RETURN
+    }
+    return run(result,
+               context,
+               continuation,
+               ip,
+               ReservedStack(context, maxDepth),
+               top,
+               NullProfiler());
+}
+
+}  // close unnamed namespace
+
+                            // --------------------
+                            // struct InterpretUtil
+                            // --------------------
+
+// CLASS METHODS
+int InterpretUtil::interpret(Datum            *result,
+                             ExecutionContext *context,
+                             const Bytecode   *code)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 != code);
+
+    return run(result,
+               context,
+               0,
+               BytecodeCursor(code),
+               GrowableStack(context),
+               Value::createUndefined(),
+               NullProfiler());
+}
+
+int InterpretUtil::interpret(Datum            *result,
+                             ExecutionContext *context,
+                             const Bytecode   *code,
+                             bsl::size_t       maxDepth)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 != code);
+    BSLS_ASSERT(0 < maxDepth);
+
+    return run(result,
+               context,
+               0,
+               BytecodeCursor(code),
+               ReservedStack(context, maxDepth),
+               Value::createUndefined(),
+               NullProfiler());
+}
+
+int InterpretUtil::interpret(Datum            *result,
+                             ExecutionContext *context,
+                             const Program&    program)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 < program.numInstructions());
+
+    return run(result,
+               context,
+               0,
+               ProgramCursor(program),
+               GrowableStack(context),
+               Value::createUndefined(),
+               NullProfiler());
+}
+
+int InterpretUtil::interpret(Datum            *result,
+                             ExecutionContext *context,
+                             const Program&    program,
+                             bsl::size_t       maxDepth)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 < program.numInstructions());
+    BSLS_ASSERT(0 < maxDepth);
+
+    return run(result,
+               context,
+               0,
+               ProgramCursor(program),
+               ReservedStack(context, maxDepth),
+               Value::createUndefined(),
+               NullProfiler());
+}
+
+int InterpretUtil::interpret(Datum               *result,
+                             ExecutionContext    *context,
+                             const ProgramImage&  image)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 < image.numInstructions());
+
+    return run(result,
+               context,
+               0,
+               ProgramCursor(image),
+               GrowableStack(context),
+               Value::createUndefined(),
+               NullProfiler());
+}
+
+int InterpretUtil::interpret(Datum               *result,
+                             ExecutionContext    *context,
+                             const ProgramImage&  image,
+                             bsl::size_t          maxDepth)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 < image.numInstructions());
+    BSLS_ASSERT(0 < maxDepth);
+
+    return run(result,
+               context,
+               0,
+               ProgramCursor(image),
+               ReservedStack(context, maxDepth),
+               Value::createUndefined(),
+               NullProfiler());
+}
+
+int InterpretUtil::interpretProfiled(Datum            *result,
+                                     ExecutionContext *context,
+                                     const Bytecode   *code,
+                                     Profile          *profile)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 != code);
+    BSLS_ASSERT(0 != profile);
+
+    profile->recordInvocation(code);
+    return run(result,
+               context,
+               0,
+               BytecodeCursor(code),
+               GrowableStack(context),
+               Value::createUndefined(),
+               CycleProfiler(profile));
+}
+
+int InterpretUtil::interpretProfiled(Datum            *result,
+                                     ExecutionContext *context,
+                                     const Program&    program,
+                                     Profile          *profile)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 < program.numInstructions());
+    BSLS_ASSERT(0 != profile);
+
+    profile->recordInvocation(&program);
+    return run(result,
+               context,
+               0,
+               ProgramCursor(program),
+               GrowableStack(context),
+               Value::createUndefined(),
+               CycleProfiler(profile));
+}
+
+int InterpretUtil::interpretProfiled(Datum               *result,
+                                     ExecutionContext    *context,
+                                     const ProgramImage&  image,
+                                     Profile             *profile)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 < image.numInstructions());
+    BSLS_ASSERT(0 != profile);
+
+    profile->recordInvocation(&image);
+    return run(result,
+               context,
+               0,
+               ProgramCursor(image),
+               GrowableStack(context),
+               Value::createUndefined(),
+               CycleProfiler(profile));
+}
+
+int InterpretUtil::start(Datum            *result,
+                         ExecutionContext *context,
+                         Continuation     *continuation,
+                         const Bytecode   *code,
+                         bsl::size_t       maxDepth)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 != continuation);
+    BSLS_ASSERT(!continuation->isSuspended());
+    BSLS_ASSERT(0 != code);
+
+    return proceed(result,
+                   context,
+                   continuation,
+                   BytecodeCursor(code),
+                   maxDepth,
+                   Value::createUndefined());
+}
+
+int InterpretUtil::start(Datum            *result,
+                         ExecutionContext *context,
+                         Continuation     *continuation,
+                         const Program&    program,
+                         bsl::size_t       maxDepth)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 != continuation);
+    BSLS_ASSERT(!continuation->isSuspended());
+    BSLS_ASSERT(0 < program.numInstructions());
+
+    return proceed(result,
+                   context,
+                   continuation,
+                   ProgramCursor(program),
+                   maxDepth,
+                   Value::createUndefined());
+}
+
+int InterpretUtil::start(Datum               *result,
+                         ExecutionContext    *context,
+                         Continuation        *continuation,
+                         const ProgramImage&  image,
+                         bsl::size_t          maxDepth)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 != continuation);
+    BSLS_ASSERT(!continuation->isSuspended());
+    BSLS_ASSERT(0 < image.numInstructions());
+
+    return proceed(result,
+                   context,
+                   continuation,
+                   ProgramCursor(image),
+                   maxDepth,
+                   Value::createUndefined());
+}
+
+int InterpretUtil::resume(Datum            *result,
+                          ExecutionContext *context,
+                          Continuation     *continuation,
+                          const Datum&      value)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(0 != continuation);
+    BSLS_ASSERT(continuation->isSuspended());
+
+    const bsl::size_t maxDepth = continuation->maxDepth();
+    const Value       top      = Value::fromDatum(value);
+    switch (continuation->kind()) {
+      case Continuation::e_Bytecode: {
+        return proceed(result,
+                       context,
+                       continuation,
+                       BytecodeCursor(continuation->code(),
+                                      continuation->pc()),
+                       maxDepth,
+                       top);                                          // RETURN
+      }
+      case Continuation::e_Program: {
+        return proceed(result,
+                       context,
+                       continuation,
+                       ProgramCursor(*continuation->program(),
+                                     continuation->pc()),
+                       maxDepth,
+                       top);                                          // RETURN
+      }
+      default: {
+        BSLS_ASSERT(Continuation::e_ProgramImage == continuation->kind());
+      } break;
+    }
+    return proceed(result,
+                   context,
+                   continuation,
+                   ProgramCursor(*continuation->image(), continuation->pc()),
+                   maxDepth,
+                   top);
+}
+}
+
+#undef SJTU_NEXT
+#undef SJTU_OPCODE
@@ -3,13 +3,248 @@
 #ifndef INCLUDED_SJTU_INTERPRETUTIL
 #define INCLUDED_SJTU_INTERPRETUTIL
 
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+namespace sjtt { class Bytecode; }
+namespace sjtt { class Continuation; }
 namespace sjtt { class ExecutionContext; }
+namespace sjtt { class Program; }
+namespace sjtt { class ProgramImage; }
 
 namespace sjtu {
 
+class Profile;
+
 struct InterpretUtil {
     // This is class provides a namespace for function to interpret Scramjet
     // bytecode.
+    //
+    // The interpreter is a stack machine.  While it runs, it holds the values
+    // of the program as 8-byte 'Value' objects in a buffer on the program
+    // stack (or, for deep programs, in memory from the allocator of the
+    // context), and caches the value on the top of the stack in a local
+    // variable.  Values are converted from and to 'Datum' objects only where
+    // they cross into other code, e.g., onto the value stack of the
+    // 'sjtt::ExecutionContext' before an external function is invoked (each
+    // value once, however many calls it stays on the stack for).  Opcodes
+    // are dispatched through a table of label addresses (computed 'goto')
+    // when compiled with GCC or Clang, and through a 'switch' statement
+    // otherwise, or when 'SJTU_INTERPRETUTIL_SWITCH_DISPATCH' is defined.
+    //
+    // External functions are invoked by 'e_Execute' after the function
+    // itself has been popped from the stack; they pop their arguments from,
+    // and push their result onto, 'context->stack()'.  An external function
+    // that leaves no result, or more values than the program had pushed,
+    // stops interpretation with the status 'e_BadCall'; otherwise, the
+    // behavior is undefined if it pops values not pushed by the program
+    // being interpreted, or collects a heap other than that of the context
+    // (see 'ExecutionContext::setHeap').  An external function that
+    // fails, e.g., 'BindUtil' bindings given arguments of the wrong type,
+    // pushes a placeholder result and reports the failure with
+    // 'ExecutionContext::setStatus', and interpretation stops with that
+    // status.
+    //
+    // An external function that cannot produce its result without waiting,
+    // e.g., for I/O, can instead suspend the program: it pushes a
+    // placeholder result and sets the status 'e_Suspended'.  If the program
+    // was started with 'start', its state is then saved in a
+    // 'sjtt::Continuation', and 'start' returns 'e_Suspended' at once,
+    // leaving the thread free to run other programs; the embedder later
+    // passes the actual result of the call to 'resume', which continues the
+    // program from the instruction following the call, and which may itself
+    // return 'e_Suspended' if the program is suspended again.  The
+    // continuation holds only the values of the program, not the context,
+    // so a program may be resumed with another context, on another thread.
+    // Since neither the continuation nor the heap of a context owns those
+    // values, the behavior is undefined if the memory they refer to is
+    // released, e.g., by resetting the arena of the context or by a
+    // collection of its heap, while the program is suspended.  A program
+    // interpreted by 'interpret' cannot be suspended, and fails with the
+    // status 'e_Suspended' instead.
+    //
+    // The interpreter is instantiated with a profiling policy.  The entry
+    // points other than 'interpretProfiled' use a policy that does nothing,
+    // so they carry no instrumentation at all; 'interpretProfiled' uses one
+    // that records, in a 'Profile', the number of executions and the cycles
+    // of each opcode, the calls and latencies of each external function, and
+    // the invocations of each program.
+    //
+    // Each opcode behaves as documented in 'sjtt::Bytecode'; an operand of
+    // an unsupported type stops interpretation with 'e_TypeError'.  Memory
+    // the interpreter allocates, e.g., for the arrays and objects a program
+    // creates, comes from the allocator of the context, and the memory
+    // referred to by bytecode, e.g., its property caches, type feedback, and
+    // loop counters (see 'DatumUtil'), is owned by the caller.  The behavior
+    // is undefined unless the branches, calls, and script functions of the
+    // program are well formed (see 'VerifyUtil'), and unless the context has
+    // the globals and shape table the program uses (see
+    // 'ExecutionContext::setGlobals' and 'ExecutionContext::setShapes').
+    //
+    // A program may be run by several threads at once, each with its own
+    // context, provided it does not use 'e_GetProperty' or 'e_SetProperty':
+    // the type feedback of the integer opcodes and the loop counters are
+    // updated atomically, but property caches are not, so the behavior is
+    // undefined if a program using them is run by several threads at once
+    // (and 'sjtm::Executor' rejects such programs).
+    //
+    // A call to a script function makes a frame on the value stack itself,
+    // with no allocation: the arguments stay where the caller pushed them,
+    // and are followed by 'k_FRAME_LINKAGE' values recording where to
+    // return, then by the values the function pushes.  A program suspended
+    // within a function is resumed within it.
+
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+
+    enum {
+        k_FRAME_LINKAGE = 3
+            // values between the arguments of a script function and the
+            // values it pushes, in its frame
+    };
+
+    enum Status {
+        // Enumeration used to describe the result of interpretation.
+
+        e_Success = 0,
+            // the program executed 'e_Return'
+
+        e_TypeError,
+            // an operand of an opcode had an unsupported type
+
+        e_NotCallable,
+            // 'e_Execute' was applied to a value that is not a function
+
+        e_Suspended,
+            // an external function suspended the program
+
+        e_OutOfMemory,
+            // memory could not be allocated, e.g., because the program
+            // reached the memory limit of its 'sjtm::Engine'; reported by
+            // 'sjtm::Engine::execute' rather than by this utility
+
+        e_Interrupted,
+            // the program was stopped, e.g., by a 'sjtt::TierUpPolicy'
+            // finding that a loop ran for too long
+
+        e_BadCall
+            // an external function left no result on the stack, or more
+            // values than the program had pushed before the call
+    };
+
+    // CLASS METHODS
+    static int interpret(Datum                  *result,
+                         sjtt::ExecutionContext *context,
+                         const sjtt::Bytecode   *code);
+        // Interpret the program beginning with the specified 'code' using the
+        // specified 'context' until an 'e_Return' opcode is reached, and load
+        // the value on the top of the stack at that point into the specified
+        // 'result'.  Return 'e_Success' on success, and a non-zero 'Status'
+        // value otherwise, in which case 'result' is unchanged.  In either
+        // case the stack of 'context' is restored to the size it had on
+        // entry.  The behavior is undefined unless every path through 'code'
+        // ends with 'e_Return' and no opcode pops more values than the
+        // program has pushed.
+
+    static int interpret(Datum                     *result,
+                         sjtt::ExecutionContext    *context,
+                         const sjtt::Program&       program);
+    static int interpret(Datum                     *result,
+                         sjtt::ExecutionContext    *context,
+                         const sjtt::ProgramImage&  image);
+        // Interpret the specified packed 'program', or the program held by
+        // the specified loaded 'image', using the specified 'context', as
+        // described above, loading the returned value into the specified
+        // 'result'.  Return 'e_Success' on success, and a non-zero 'Status'
+        // value otherwise.
+
+    static int interpret(Datum                  *result,
+                         sjtt::ExecutionContext *context,
+                         const sjtt::Bytecode   *code,
+                         bsl::size_t             maxDepth);
+    static int interpret(Datum                  *result,
+                         sjtt::ExecutionContext *context,
+                         const sjtt::Program&    program,
+                         bsl::size_t             maxDepth);
+    static int interpret(Datum                     *result,
+                         sjtt::ExecutionContext    *context,
+                         const sjtt::ProgramImage&  image,
+                         bsl::size_t                maxDepth);
+        // Interpret the specified 'code', 'program', or 'image', which has
+        // been accepted by 'VerifyUtil::verify' with the specified 'maxDepth',
+        // using the specified 'context' as described above, and load the
+        // returned value into the specified 'result'.  Storage for the stack
+        // is reserved on entry and after each external call, and no further
+        // bounds or capacity checks are performed.  Return 'e_Success' on
+        // success, and a non-zero 'Status' value otherwise.  The behavior is
+        // undefined unless 'maxDepth' is the depth computed by 'verify' for
+        // the program.
+
+    static int interpretProfiled(Datum                     *result,
+                                 sjtt::ExecutionContext    *context,
+                                 const sjtt::Bytecode      *code,
+                                 Profile                   *profile);
+    static int interpretProfiled(Datum                     *result,
+                                 sjtt::ExecutionContext    *context,
+                                 const sjtt::Program&       program,
+                                 Profile                   *profile);
+    static int interpretProfiled(Datum                     *result,
+                                 sjtt::ExecutionContext    *context,
+                                 const sjtt::ProgramImage&  image,
+                                 Profile                   *profile);
+        // Interpret the specified 'code', 'program', or 'image' using the
+        // specified 'context' as described for 'interpret', loading the
+        // returned value into the specified 'result', and record the
+        // invocation, the opcodes executed, and the external functions called
+        // in the specified 'profile'.  The invocation is recorded under the
+        // address of 'code', 'program', or 'image'.  Return 'e_Success' on
+        // success, and a non-zero 'Status' value otherwise.  Note that
+        // profiling adds a read of the cycle counter to every opcode.
+
+    static int start(Datum                     *result,
+                     sjtt::ExecutionContext    *context,
+                     sjtt::Continuation        *continuation,
+                     const sjtt::Bytecode      *code,
+                     bsl::size_t                maxDepth = 0);
+    static int start(Datum                     *result,
+                     sjtt::ExecutionContext    *context,
+                     sjtt::Continuation        *continuation,
+                     const sjtt::Program&       program,
+                     bsl::size_t                maxDepth = 0);
+    static int start(Datum                     *result,
+                     sjtt::ExecutionContext    *context,
+                     sjtt::Continuation        *continuation,
+                     const sjtt::ProgramImage&  image,
+                     bsl::size_t                maxDepth = 0);
+        // Interpret the specified 'code', 'program', or 'image' using the
+        // specified 'context' as described for 'interpret', reserving the
+        // optionally specified 'maxDepth' for the stack if it is not 0.
+        // Return 'e_Success', having loaded the returned value into the
+        // specified 'result', if the program returns; 'e_Suspended', having
+        // saved the state of the program into the specified 'continuation',
+        // if an external function suspends it; and another non-zero 'Status'
+        // value if it fails.  In every case the stack of 'context' is
+        // restored to the size it had on entry.  The behavior is undefined
+        // unless 'continuation' is empty, and unless 'code', 'program', or
+        // 'image' remains valid until the program returns or fails.
+
+    static int resume(Datum                  *result,
+                      sjtt::ExecutionContext *context,
+                      sjtt::Continuation     *continuation,
+                      const Datum&            value);
+        // Continue the program saved in the specified 'continuation', using
+        // the specified 'context', with the specified 'value' as the result
+        // of the external function that suspended it, and empty
+        // 'continuation'.  Return 'e_Success', 'e_Suspended', or another
+        // non-zero 'Status' value, with the same effects on the specified
+        // 'result' and 'continuation' as described for 'start'.  The
+        // behavior is undefined unless 'continuation' holds a suspended
+        // program.
 };
 }
 
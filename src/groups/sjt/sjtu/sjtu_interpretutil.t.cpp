@@ -2,8 +2,28 @@
 
 #include <sjtu_interpretutil.h>
 
+#include <sjtt_bytecode.h>
+#include <sjtt_continuation.h>
+#include <sjtt_executionarena.h>
+#include <sjtt_executioncontext.h>
+#include <sjtt_heap.h>
+#include <sjtt_loopcounter.h>
+#include <sjtt_program.h>
+#include <sjtt_programimage.h>
+#include <sjtt_propertycache.h>
+#include <sjtt_shape.h>
+#include <sjtt_tieruppolicy.h>
+#include <sjtt_typefeedback.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_verifyutil.h>
+
 #include <bdls_testutil.h>
 #include <bdlma_localsequentialallocator.h>
+#include <bslma_testallocator.h>
+#include <bslmt_threadutil.h>
+
+#include <bsl_limits.h>
+#include <bsl_vector.h>
 
 using namespace BloombergLP;
 using namespace bsl;
@@ -29,6 +49,26 @@ void aSsErT(bool condition, const char *message, int line)
     }
 }
 
+const bdld::Datum *s_stackData = 0;   // storage observed by 'recordStack'
+
+void recordStack(sjtt::ExecutionContext *context)
+    // Record the address of the storage of the stack of the specified
+    // 'context' in 's_stackData' and push 'null'.
+{
+    s_stackData = context->stack()->data();
+    context->stack()->push_back(bdld::Datum::createNull());
+}
+
+sjtt::Heap *s_heap_p = 0;  // heap collected by 'collect'
+
+void collect(sjtt::ExecutionContext *context)
+    // Run a minor collection of 's_heap_p' and push 'null' onto the stack of
+    // the specified 'context'.
+{
+    s_heap_p->collectMinor();
+    context->stack()->push_back(bdld::Datum::createNull());
+}
+
 }  // close unnamed namespace
 
 // ============================================================================
@@ -53,6 +93,183 @@ void aSsErT(bool condition, const char *message, int line)
 #define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
 #define L_           BDLS_TESTUTIL_L_  // current Line number
 
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+typedef sjtt::Bytecode Bytecode;
+
+namespace {
+
+void negate(sjtt::ExecutionContext *context)
+    // Pop a double from the stack of the specified 'context' and push its
+    // negation.
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    const double value = stack.back().theDouble();
+    stack.back() = bdld::Datum::createDouble(-value);
+}
+
+void subtract(sjtt::ExecutionContext *context)
+    // Pop two doubles from the stack of the specified 'context' and push the
+    // result of subtracting the top value from the one below it.
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    const double rhs = stack.back().theDouble();
+    stack.pop_back();
+    const double lhs = stack.back().theDouble();
+    stack.back() = bdld::Datum::createDouble(lhs - rhs);
+}
+
+void countStrings(sjtt::ExecutionContext *context)
+    // Pop the strings on the top of the stack of the specified 'context', and
+    // push '1000 * F + S', where 'F' is the number of them equal to "first"
+    // and 'S' the number equal to "second".
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    int                       count = 0;
+    while (!stack.empty() && stack.back().isString()) {
+        count += "first" == stack.back().theString() ? 1000 : 1;
+        stack.pop_back();
+    }
+    stack.push_back(bdld::Datum::createInteger(count));
+}
+
+void identity(sjtt::ExecutionContext *context)
+    // Pop a value from the stack of the specified 'context' and push it
+    // back.
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    const bdld::Datum         value = stack.back();
+    stack.pop_back();
+    stack.push_back(value);
+}
+
+void discard(sjtt::ExecutionContext *context)
+    // Pop a value from the stack of the specified 'context' and push no
+    // result.
+{
+    context->stack()->pop_back();
+}
+
+void pushTwice(sjtt::ExecutionContext *context)
+    // Push two results, both 'null', onto the stack of the specified
+    // 'context'.
+{
+    context->stack()->push_back(bdld::Datum::createNull());
+    context->stack()->push_back(bdld::Datum::createNull());
+}
+
+                             // =================
+                             // class FakeService
+                             // =================
+
+class FakeService {
+    // This class provides a local stand-in for an asynchronous service, e.g.,
+    // a remote key-value store: 'fetch', bound as an external function,
+    // records the key it is given as a request and suspends the calling
+    // program, and the test later answers the requests, in any order, by
+    // resuming the programs with 'answer'.
+
+    // DATA
+    bsl::vector<double> d_requests;  // keys requested and not yet taken
+
+  public:
+    // CLASS DATA
+    static FakeService *s_instance_p;  // service used by 'fetch'
+
+    // CLASS METHODS
+    static double answer(double key)
+        // Return the value the service holds for the specified 'key'.
+    {
+        return key * 10;
+    }
+
+    static void fetch(sjtt::ExecutionContext *context)
+        // Pop a key from the stack of the specified 'context', record it as a
+        // request with 's_instance_p', push a placeholder result, and
+        // suspend the program.
+    {
+        bsl::vector<bdld::Datum>& stack = *context->stack();
+        s_instance_p->d_requests.push_back(stack.back().theDouble());
+        stack.back() = bdld::Datum::createNull();
+        context->setStatus(InterpretUtil::e_Suspended);
+    }
+
+    // MANIPULATORS
+    double takeRequest()
+        // Remove the most recent request and return its key.
+    {
+        const double key = d_requests.back();
+        d_requests.pop_back();
+        return key;
+    }
+
+    // ACCESSORS
+    bsl::size_t numRequests() const
+        // Return the number of requests not yet taken.
+    {
+        return d_requests.size();
+    }
+};
+
+FakeService *FakeService::s_instance_p = 0;
+
+                             // ================
+                             // class LoopPolicy
+                             // ================
+
+class LoopPolicy : public sjtt::TierUpPolicy {
+    // This class counts the hot loops it is notified of, and stops the
+    // program with a configurable status.
+
+  public:
+    // DATA
+    int                d_numHotLoops;
+    sjtt::LoopCounter *d_lastLoop_p;
+    int                d_status;       // status to set, or 0
+
+    // CREATORS
+    LoopPolicy()
+    : d_numHotLoops(0)
+    , d_lastLoop_p(0)
+    , d_status(0)
+    {
+    }
+
+    // MANIPULATORS
+    void onHotLoop(sjtt::ExecutionContext *context, sjtt::LoopCounter *loop)
+    {
+        ++d_numHotLoops;
+        d_lastLoop_p = loop;
+        context->setStatus(d_status);
+    }
+
+    void onHotProgram(const sjtt::Bytecode *)
+    {
+    }
+};
+
+struct Resumer {
+    // This 'struct' resumes a suspended program on another thread.
+
+    // DATA
+    sjtt::ExecutionContext *d_context_p;
+    sjtt::Continuation     *d_continuation_p;
+    bdld::Datum             d_value;
+    bdld::Datum            *d_result_p;
+    int                    *d_rc_p;
+
+    // MANIPULATORS
+    void operator()() {
+        *d_rc_p = InterpretUtil::resume(d_result_p,
+                                        d_context_p,
+                                        d_continuation_p,
+                                        d_value);
+    }
+};
+
+}  // close unnamed namespace
 
 // ============================================================================
 //                               MAIN PROGRAM
@@ -67,7 +284,1488 @@ int main(int argc, char *argv[])
     cout << "TEST " << __FILE__ << " CASE " << test << endl;
 
     switch (test) { case 0:
+      case 14: {
+        if (verbose) cout << endl
+                          << "script functions" << endl
+                          << "================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            bsl::vector<bdld::Datum> stack(&ta);
+            sjtt::ExecutionContext   context(&ta, &stack);
+
+            sjtt::TypeFeedback feedback;
+            const bdld::Datum  FB   = DatumUtil::createTypeFeedback(&feedback);
+            const Bytecode     RET  = Bytecode::createOpcode(
+                                                        Bytecode::e_Return);
+            const Bytecode     I0   = Bytecode::createPush(
+                                              bdld::Datum::createInteger(0));
+            const Bytecode     I1   = Bytecode::createPush(
+                                              bdld::Datum::createInteger(1));
+            const Bytecode     F1   = Bytecode::create(
+                                              Bytecode::e_Function,
+                                              bdld::Datum::createInteger(1));
+            const Bytecode     F2   = Bytecode::create(
+                                              Bytecode::e_Function,
+                                              bdld::Datum::createInteger(2));
+            const Bytecode     CALL2 = Bytecode::create(
+                                              Bytecode::e_Call,
+                                              bdld::Datum::createInteger(2));
+            const Bytecode     ARG1 = Bytecode::create(
+                                             Bytecode::e_GetLocal,
+                                             bdld::Datum::createInteger(-1));
+            const Bytecode     ARG2 = Bytecode::create(
+                                             Bytecode::e_GetLocal,
+                                             bdld::Datum::createInteger(-2));
+            const Bytecode     GET0 = Bytecode::create(
+                                              Bytecode::e_GetLocal,
+                                              bdld::Datum::createInteger(0));
+            const Bytecode     SET0 = Bytecode::create(
+                                              Bytecode::e_SetLocal,
+                                              bdld::Datum::createInteger(0));
+            const Bytecode     IADD = Bytecode::create(Bytecode::e_AddIntegers,
+                                                       FB);
+            const Bytecode     ISUB = Bytecode::create(
+                                                 Bytecode::e_SubtractIntegers,
+                                                 FB);
+            const Bytecode     ILESS = Bytecode::create(
+                                                    Bytecode::e_LessIntegers,
+                                                    FB);
+
+            if (verbose) cout << "\tArguments and locals." << endl;
+
+            // 'f(a, b) { var t = a - b; t = t + t; return t; } f(7, 2)'
+
+            const Bytecode LOCALS[] = {
+                Bytecode::createPush(bdld::Datum::createInteger(7)),
+                Bytecode::createPush(bdld::Datum::createInteger(2)),
+                CALL2, RET,
+                F2, ARG2, ARG1, ISUB, GET0, GET0, IADD, SET0, GET0, RET
+            };
+            bdld::Datum result;
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, LOCALS));
+            ASSERTV(result, bdld::Datum::createInteger(10) == result);
+            ASSERT(0 == stack.size());
+
+            if (verbose) cout << "\tRecursion outgrowing the stack buffer."
+                              << endl;
+
+            // 'sum(n) { if (n < 1) { return 0; } return n + sum(n - 1); }'
+
+            const Bytecode SUM[] = {
+                Bytecode::createPush(bdld::Datum::createInteger(100)),
+                CALL2, RET,
+                F1, ARG1, I1, ILESS,
+                Bytecode::create(Bytecode::e_JumpIfFalse,
+                                 bdld::Datum::createInteger(3)),
+                I0, RET,
+                ARG1, ARG1, I1, ISUB,
+                Bytecode::create(Bytecode::e_Call,
+                                 bdld::Datum::createInteger(-11)),
+                IADD, RET
+            };
+            const bsl::size_t NUM_SUM = sizeof SUM / sizeof *SUM;
+
+            bsl::size_t maxDepth   = 0;
+            bsl::size_t errorIndex = 0;
+            ASSERT(0 == VerifyUtil::verify(&maxDepth,
+                                           &errorIndex,
+                                           SUM,
+                                           NUM_SUM));
+            ASSERTV(maxDepth, 7 == maxDepth);
+
+            sjtt::Program        program(&ta);
+            sjtt::ProgramBuilder builder(&ta);
+            ASSERT(0 == builder.append(SUM, NUM_SUM));
+            builder.build(&program);
+
+            for (int form = 0; form < 4; ++form) {
+                const int rc = 0 == form
+                   ? InterpretUtil::interpret(&result, &context, SUM)
+                   : 1 == form
+                   ? InterpretUtil::interpret(&result, &context, SUM, maxDepth)
+                   : 2 == form
+                   ? InterpretUtil::interpret(&result, &context, program)
+                   : InterpretUtil::interpret(&result,
+                                              &context,
+                                              program,
+                                              maxDepth);
+                ASSERTV(form, rc, 0 == rc);
+                ASSERTV(form, result,
+                        bdld::Datum::createInteger(5050) == result);
+                ASSERTV(form, 0 == stack.size());
+            }
+
+            if (verbose) cout << "\tCalls run from images." << endl;
+            {
+                const Bytecode CODE[] = {
+                    Bytecode::createPush(bdld::Datum::createDouble(1)),
+                    CALL2, RET,
+                    F1, ARG1,
+                    Bytecode::create(Bytecode::e_PushAddDoubles,
+                                     bdld::Datum::createDouble(0.5)),
+                    RET
+                };
+                ASSERT(0 == builder.append(CODE, sizeof CODE / sizeof *CODE));
+                builder.build(&program);
+
+                bsl::vector<char>  buffer(&ta);
+                sjtt::ProgramImage image(&ta);
+                ASSERT(0 == sjtt::ProgramImage::encode(&buffer, program));
+                ASSERT(0 == image.load(buffer.data(), buffer.size()));
+                ASSERT(0 == InterpretUtil::interpret(&result,
+                                                     &context,
+                                                     image));
+                ASSERTV(result, bdld::Datum::createDouble(1.5) == result);
+            }
+
+            if (verbose) cout << "\tTail calls reuse the frame." << endl;
+
+            // 'loop(n, a) { if (n < 1) { return a; } return loop(n - 1,
+            // a + 1); } loop(100000, 0)'
+
+            const Bytecode LOOP[] = {
+                Bytecode::createPush(bdld::Datum::createInteger(100000)),
+                I0, CALL2, RET,
+                F2, ARG2, I1, ILESS,
+                Bytecode::create(Bytecode::e_JumpIfFalse,
+                                 bdld::Datum::createInteger(3)),
+                ARG1, RET,
+                ARG2, I1, ISUB, ARG1, I1, IADD,
+                Bytecode::create(Bytecode::e_TailCall,
+                                 bdld::Datum::createInteger(-13))
+            };
+            const bsl::size_t NUM_LOOP = sizeof LOOP / sizeof *LOOP;
+
+            ASSERT(0 == VerifyUtil::verify(&maxDepth,
+                                           &errorIndex,
+                                           LOOP,
+                                           NUM_LOOP));
+
+            // Calls allocate nothing: the frames of the loop fit in the
+            // buffer of the interpreter.
+
+            const long long numAllocations = ta.numAllocations();
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, LOOP));
+            ASSERTV(result, bdld::Datum::createInteger(100000) == result);
+            ASSERT(numAllocations == ta.numAllocations());
+
+            ASSERT(0 == InterpretUtil::interpret(&result,
+                                                 &context,
+                                                 LOOP,
+                                                 maxDepth));
+            ASSERTV(result, bdld::Datum::createInteger(100000) == result);
+            ASSERT(0 == stack.size());
+
+            if (verbose) cout << "\tStrings and external calls in frames."
+                              << endl;
+
+            const bdld::Datum FIRST = bdld::Datum::copyString("first", &ta);
+            Bytecode          STRINGS[] = {
+                Bytecode::createPush(FIRST),
+                Bytecode::create(Bytecode::e_Call,
+                                 bdld::Datum::createInteger(4)),
+                Bytecode::createPush(
+                        DatumUtil::createExternalFunction(&countStrings)),
+                Bytecode::createOpcode(Bytecode::e_Execute),
+                RET,
+                F1, ARG1, ARG1,
+                Bytecode::createPush(
+                            DatumUtil::createExternalFunction(&identity)),
+                Bytecode::createOpcode(Bytecode::e_Execute),
+                RET
+            };
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, STRINGS));
+            ASSERTV(result, bdld::Datum::createInteger(1000) == result);
+
+            STRINGS[2] = RET;
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, STRINGS));
+            ASSERTV(result, FIRST == result);
+            ASSERT(0 == stack.size());
+            bdld::Datum::destroy(FIRST, &ta);
+
+            if (verbose) cout << "\tSuspension in a function." << endl;
+
+            FakeService service;
+            FakeService::s_instance_p = &service;
+
+            // 'f(k) { return fetch(k) + 0.5; } f(2)'
+
+            const Bytecode FETCH[] = {
+                Bytecode::createPush(bdld::Datum::createDouble(2)),
+                CALL2, RET,
+                F1, ARG1,
+                Bytecode::createPush(
+                      DatumUtil::createExternalFunction(&FakeService::fetch)),
+                Bytecode::createOpcode(Bytecode::e_Execute),
+                Bytecode::create(Bytecode::e_PushAddDoubles,
+                                 bdld::Datum::createDouble(0.5)),
+                RET
+            };
+            const bsl::size_t NUM_FETCH = sizeof FETCH / sizeof *FETCH;
+            ASSERT(0 == builder.append(FETCH, NUM_FETCH));
+            builder.build(&program);
+
+            for (int packed = 0; packed < 2; ++packed) {
+                sjtt::Continuation continuation(&ta);
+                ASSERTV(packed, InterpretUtil::e_Suspended ==
+                             (packed
+                              ? InterpretUtil::start(&result,
+                                                     &context,
+                                                     &continuation,
+                                                     program)
+                              : InterpretUtil::start(&result,
+                                                     &context,
+                                                     &continuation,
+                                                     FETCH)));
+                ASSERTV(packed, 7 == continuation.pc());
+                ASSERTV(packed, continuation.frame(),
+                        0 <= continuation.frame());
+                ASSERT(0 == stack.size());
+                ASSERT(2 == service.takeRequest());
+
+                ASSERTV(packed, 0 == InterpretUtil::resume(
+                                               &result,
+                                               &context,
+                                               &continuation,
+                                               bdld::Datum::createDouble(4)));
+                ASSERTV(packed, result,
+                        bdld::Datum::createDouble(4.5) == result);
+                ASSERT(!continuation.isSuspended());
+                ASSERT(0 == stack.size());
+            }
+            FakeService::s_instance_p = 0;
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 13: {
+        if (verbose) cout << endl
+                          << "branches" << endl
+                          << "========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            bsl::vector<bdld::Datum> stack(&ta);
+            sjtt::ExecutionContext   context(&ta, &stack);
+
+            const Bytecode RET   = Bytecode::createOpcode(Bytecode::e_Return);
+            const Bytecode TRUE  = Bytecode::createPush(
+                                          bdld::Datum::createBoolean(true));
+            const Bytecode FALSE = Bytecode::createPush(
+                                         bdld::Datum::createBoolean(false));
+            const Bytecode I1    = Bytecode::createPush(
+                                              bdld::Datum::createInteger(1));
+            const Bytecode I2    = Bytecode::createPush(
+                                              bdld::Datum::createInteger(2));
+            const Bytecode JMP2  = Bytecode::create(
+                                             Bytecode::e_Jump,
+                                             bdld::Datum::createInteger(2));
+            const Bytecode JIF3  = Bytecode::create(
+                                             Bytecode::e_JumpIfFalse,
+                                             bdld::Datum::createInteger(3));
+
+            const struct {
+                int         d_line;
+                Bytecode    d_code[6];
+                int         d_status;
+                bdld::Datum d_result;
+            } DATA[] = {
+                { L_, { JMP2, I1, I2, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createInteger(2) },
+                { L_, { TRUE, JIF3, I1, RET, I2, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createInteger(1) },
+                { L_, { FALSE, JIF3, I1, RET, I2, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createInteger(2) },
+                { L_, { I1, JIF3, I1, RET, I2, RET },
+                  InterpretUtil::e_TypeError, bdld::Datum() },
+            };
+            const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+            for (int ti = 0; ti < NUM_DATA; ++ti) {
+                const int   LINE = DATA[ti].d_line;
+                bdld::Datum result;
+                const int   rc = InterpretUtil::interpret(&result,
+                                                          &context,
+                                                          DATA[ti].d_code);
+                ASSERTV(LINE, rc, DATA[ti].d_status == rc);
+                if (InterpretUtil::e_Success == rc) {
+                    ASSERTV(LINE, result, DATA[ti].d_result == result);
+                }
+                ASSERTV(LINE, 0 == stack.size());
+            }
+
+            if (verbose) cout << "\tBranches run from images." << endl;
+            {
+                const Bytecode       CODE[] = { FALSE, JIF3, I1, RET, I2,
+                                                RET };
+                sjtt::Program        program(&ta);
+                sjtt::ProgramBuilder builder(&ta);
+                ASSERT(0 == builder.append(CODE, sizeof CODE / sizeof *CODE));
+                builder.build(&program);
+
+                bsl::vector<char>  buffer(&ta);
+                sjtt::ProgramImage image(&ta);
+                ASSERT(0 == sjtt::ProgramImage::encode(&buffer, program));
+                ASSERT(0 == image.load(buffer.data(), buffer.size()));
+
+                bdld::Datum result;
+                ASSERT(0 == InterpretUtil::interpret(&result,
+                                                     &context,
+                                                     image));
+                ASSERTV(result, bdld::Datum::createInteger(2) == result);
+            }
+
+            if (verbose) cout << "\tLoops are counted." << endl;
+
+            // 'i = 0; while (i < 5) { i = i + 1; } return i;'
+
+            sjtt::LoopCounter  counter;
+            sjtt::TypeFeedback feedback;
+            const bdld::Datum  SLOT = bdld::Datum::createInteger(0);
+            const bdld::Datum  FB   = DatumUtil::createTypeFeedback(&feedback);
+            const Bytecode     CODE[] = {
+                Bytecode::createPush(bdld::Datum::createInteger(0)),
+                Bytecode::create(Bytecode::e_SetGlobalSlot, SLOT),
+                Bytecode::create(Bytecode::e_LoopHeader,
+                                 DatumUtil::createLoopCounter(&counter)),
+                Bytecode::create(Bytecode::e_GetGlobalSlot, SLOT),
+                Bytecode::createPush(bdld::Datum::createInteger(5)),
+                Bytecode::create(Bytecode::e_LessIntegers, FB),
+                Bytecode::create(Bytecode::e_JumpIfFalse,
+                                 bdld::Datum::createInteger(6)),
+                Bytecode::create(Bytecode::e_GetGlobalSlot, SLOT),
+                I1,
+                Bytecode::create(Bytecode::e_AddIntegers, FB),
+                Bytecode::create(Bytecode::e_SetGlobalSlot, SLOT),
+                Bytecode::create(Bytecode::e_Loop,
+                                 bdld::Datum::createInteger(-9)),
+                Bytecode::create(Bytecode::e_GetGlobalSlot, SLOT),
+                RET
+            };
+            const bsl::size_t NUM_CODES = sizeof CODE / sizeof *CODE;
+
+            bsl::size_t maxDepth   = 0;
+            bsl::size_t errorIndex = 0;
+            ASSERT(0 == VerifyUtil::verify(&maxDepth,
+                                           &errorIndex,
+                                           CODE,
+                                           NUM_CODES));
+            ASSERT(2 == maxDepth);
+
+            sjtt::ExecutionContext::Globals globals(&ta);
+            globals.resize(1);
+            context.setGlobals(&globals);
+
+            bdld::Datum result;
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, CODE));
+            ASSERT(bdld::Datum::createInteger(5) == result);
+            ASSERT(5 == counter.count());
+
+            sjtt::Program        program(&ta);
+            sjtt::ProgramBuilder builder(&ta);
+            ASSERT(0 == builder.append(CODE, NUM_CODES));
+            builder.build(&program);
+
+            counter.reset();
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, program));
+            ASSERT(bdld::Datum::createInteger(5) == result);
+            ASSERT(5 == counter.count());
+            ASSERT(feedback.hasOnly(sjtt::TypeFeedback::e_Integer));
+
+            if (verbose) cout << "\tA hot loop notifies the policy." << endl;
+
+            LoopPolicy policy;
+            context.setTierUpPolicy(&policy, 3);
+
+            counter.reset();
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, CODE));
+            ASSERT(bdld::Datum::createInteger(5) == result);
+            ASSERT(1        == policy.d_numHotLoops);
+            ASSERT(&counter == policy.d_lastLoop_p);
+
+            // The counter is not reset by the interpreter, so the loop is hot
+            // only once.
+
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, program));
+            ASSERT(1  == policy.d_numHotLoops);
+            ASSERT(10 == counter.count());
+
+            if (verbose) cout << "\tThe policy can stop the program." << endl;
+
+            policy.d_status = InterpretUtil::e_Interrupted;
+            counter.reset();
+            ASSERT(InterpretUtil::e_Interrupted ==
+                           InterpretUtil::interpret(&result, &context, CODE));
+            ASSERT(0 == context.status());
+            ASSERT(bdld::Datum::createInteger(3) == globals[0].datum());
+            ASSERT(0 == stack.size());
+
+            counter.reset();
+            ASSERT(InterpretUtil::e_Interrupted ==
+                        InterpretUtil::interpret(&result, &context, program));
+            ASSERT(3 == policy.d_numHotLoops);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 12: {
+        if (verbose) cout << endl
+                          << "integer arithmetic" << endl
+                          << "==================" << endl;
+
+        typedef sjtt::TypeFeedback Feedback;
+
+        const int MAX = bsl::numeric_limits<int>::max();
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            bsl::vector<bdld::Datum> stack(&ta);
+            sjtt::ExecutionContext   context(&ta, &stack);
+
+            Feedback add;
+            Feedback subtract;
+            Feedback multiply;
+            Feedback less;
+
+            const Bytecode ADD  = Bytecode::create(
+                                        Bytecode::e_AddIntegers,
+                                        DatumUtil::createTypeFeedback(&add));
+            const Bytecode SUB  = Bytecode::create(
+                                   Bytecode::e_SubtractIntegers,
+                                   DatumUtil::createTypeFeedback(&subtract));
+            const Bytecode MUL  = Bytecode::create(
+                                   Bytecode::e_MultiplyIntegers,
+                                   DatumUtil::createTypeFeedback(&multiply));
+            const Bytecode LESS = Bytecode::create(
+                                       Bytecode::e_LessIntegers,
+                                       DatumUtil::createTypeFeedback(&less));
+            const Bytecode RET  = Bytecode::createOpcode(Bytecode::e_Return);
+            const Bytecode I2   = Bytecode::createPush(
+                                              bdld::Datum::createInteger(2));
+            const Bytecode I3   = Bytecode::createPush(
+                                              bdld::Datum::createInteger(3));
+            const Bytecode IMAX = Bytecode::createPush(
+                                            bdld::Datum::createInteger(MAX));
+            const Bytecode HALF = Bytecode::createPush(
+                                             bdld::Datum::createDouble(0.5));
+            const Bytecode NUL  = Bytecode::createPush(DatumUtil::s_Null);
+
+            const struct {
+                int         d_line;
+                Bytecode    d_code[6];
+                int         d_status;
+                bdld::Datum d_result;
+            } DATA[] = {
+                { L_, { I2, I3, ADD, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createInteger(5) },
+                { L_, { I2, I3, SUB, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createInteger(-1) },
+                { L_, { I2, I3, MUL, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createInteger(6) },
+                { L_, { I2, I3, LESS, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createBoolean(true) },
+                { L_, { I2, I3, ADD, I3, MUL, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createInteger(15) },
+                { L_, { IMAX, I2, ADD, RET },
+                  InterpretUtil::e_Success,
+                  bdld::Datum::createDouble(MAX + 2.0) },
+                { L_, { IMAX, I3, MUL, I2, SUB, RET },
+                  InterpretUtil::e_Success,
+                  bdld::Datum::createDouble(MAX * 3.0 - 2) },
+                { L_, { HALF, I3, ADD, RET },
+                  InterpretUtil::e_Success,
+                  bdld::Datum::createDouble(3.5) },
+                { L_, { I3, HALF, LESS, RET },
+                  InterpretUtil::e_Success,
+                  bdld::Datum::createBoolean(false) },
+                { L_, { I2, NUL, ADD, RET },
+                  InterpretUtil::e_TypeError, bdld::Datum() },
+                { L_, { NUL, I2, LESS, RET },
+                  InterpretUtil::e_TypeError, bdld::Datum() },
+            };
+            const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+            for (int ti = 0; ti < NUM_DATA; ++ti) {
+                const int   LINE = DATA[ti].d_line;
+                bdld::Datum result;
+                const int   rc = InterpretUtil::interpret(&result,
+                                                          &context,
+                                                          DATA[ti].d_code);
+                ASSERTV(LINE, rc, DATA[ti].d_status == rc);
+                if (InterpretUtil::e_Success == rc) {
+                    ASSERTV(LINE, result, DATA[ti].d_result == result);
+                }
+                ASSERTV(LINE, 0 == stack.size());
+            }
+
+            if (verbose) cout << "\tEach opcode records its operations."
+                              << endl;
+
+            ASSERT((Feedback::e_Integer | Feedback::e_Overflow |
+                    Feedback::e_Double  | Feedback::e_Other) == add.kinds());
+            ASSERT((Feedback::e_Integer | Feedback::e_Double) ==
+                                                          subtract.kinds());
+            ASSERT((Feedback::e_Integer | Feedback::e_Overflow) ==
+                                                          multiply.kinds());
+            ASSERT((Feedback::e_Integer | Feedback::e_Double |
+                    Feedback::e_Other) == less.kinds());
+
+            if (verbose) cout << "\tA counting loop stays in integers."
+                              << endl;
+
+            add.reset();
+            less.reset();
+            const Bytecode ONE = Bytecode::createPush(
+                                              bdld::Datum::createInteger(1));
+            bsl::vector<Bytecode> code;
+            code.push_back(Bytecode::createPush(
+                                             bdld::Datum::createInteger(0)));
+            for (int i = 0; i < 100; ++i) {
+                code.push_back(ONE);
+                code.push_back(ADD);
+            }
+            code.push_back(RET);
+
+            sjtt::Program        program(&ta);
+            sjtt::ProgramBuilder builder(&ta);
+            ASSERT(0 == builder.append(code.data(), code.size()));
+            builder.build(&program);
+
+            bdld::Datum result;
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, program));
+            ASSERT(bdld::Datum::createInteger(100) == result);
+            ASSERT(add.hasOnly(Feedback::e_Integer));
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 11: {
+        if (verbose) cout << endl
+                          << "property access" << endl
+                          << "===============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            sjtt::ExecutionArena            arena(&ta);
+            sjtt::ExecutionContext          context(&arena);
+            sjtt::ShapeTable                shapes(&ta);
+            sjtt::ExecutionContext::Globals globals(&ta);
+            globals.resize(1);
+            context.setGlobals(&globals);
+            context.setShapes(&shapes);
+
+            sjtt::PropertyCache setX("x", &ta);
+            sjtt::PropertyCache setY("y", &ta);
+            sjtt::PropertyCache getX("x", &ta);
+            sjtt::PropertyCache getY("y", &ta);
+            sjtt::PropertyCache getZ("z", &ta);
+
+            const Bytecode NEW  = Bytecode::createOpcode(
+                                                     Bytecode::e_NewObject);
+            const Bytecode SETX = Bytecode::create(
+                                      Bytecode::e_SetProperty,
+                                      DatumUtil::createPropertyCache(&setX));
+            const Bytecode SETY = Bytecode::create(
+                                      Bytecode::e_SetProperty,
+                                      DatumUtil::createPropertyCache(&setY));
+            const Bytecode GETX = Bytecode::create(
+                                      Bytecode::e_GetProperty,
+                                      DatumUtil::createPropertyCache(&getX));
+            const Bytecode GETY = Bytecode::create(
+                                      Bytecode::e_GetProperty,
+                                      DatumUtil::createPropertyCache(&getY));
+            const Bytecode GETZ = Bytecode::create(
+                                      Bytecode::e_GetProperty,
+                                      DatumUtil::createPropertyCache(&getZ));
+            const Bytecode RET  = Bytecode::createOpcode(Bytecode::e_Return);
+            const Bytecode SETG = Bytecode::create(
+                                             Bytecode::e_SetGlobalSlot,
+                                             bdld::Datum::createInteger(0));
+            const Bytecode CALL = Bytecode::createOpcode(Bytecode::e_Execute);
+            const Bytecode ID   = Bytecode::createPush(
+                                 DatumUtil::createExternalFunction(&identity));
+            const Bytecode ONE  = Bytecode::createPush(
+                                               bdld::Datum::createDouble(1));
+            const Bytecode TWO  = Bytecode::createPush(
+                                               bdld::Datum::createDouble(2));
+
+            if (verbose) cout << "\tCaches warm up on the first run." << endl;
+
+            // '{ x: 1, y: 2 }.y' and '{ y: 1, x: 2 }.y'
+
+            const Bytecode XY[] = { NEW, ONE, SETX, TWO, SETY, GETY, RET };
+            const Bytecode YX[] = { NEW, ONE, SETY, TWO, SETX, GETY, RET };
+            bsl::size_t maxDepth   = 0;
+            bsl::size_t errorIndex = 0;
+            ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, XY, 7));
+            ASSERT(2 == maxDepth);
+
+            for (int i = 0; i < 3; ++i) {
+                bdld::Datum result;
+                ASSERTV(i, 0 == InterpretUtil::interpret(&result,
+                                                         &context,
+                                                         XY,
+                                                         maxDepth));
+                ASSERTV(i, bdld::Datum::createDouble(2) == result);
+                ASSERTV(i, 0 == InterpretUtil::interpret(&result,
+                                                         &context,
+                                                         XY));
+                ASSERTV(i, bdld::Datum::createDouble(2) == result);
+                arena.reset();
+            }
+            ASSERT(3 == shapes.numShapes());
+            ASSERT(1 == setX.numMisses());
+            ASSERT(1 == setY.numMisses());
+            ASSERT(1 == getY.numMisses());
+            ASSERT(sjtt::PropertyCache::e_Monomorphic == getY.state());
+            ASSERT(0 != setX.find(shapes.root()->id()));
+            ASSERT(0 != setX.find(shapes.root()->id())->d_next_p);
+
+            if (verbose) cout << "\tCaches see several shapes." << endl;
+
+            for (int i = 0; i < 2; ++i) {
+                bdld::Datum result;
+                ASSERTV(i, 0 == InterpretUtil::interpret(&result,
+                                                         &context,
+                                                         YX));
+                ASSERTV(i, bdld::Datum::createDouble(1) == result);
+                ASSERTV(i, 0 == InterpretUtil::interpret(&result,
+                                                         &context,
+                                                         XY));
+                ASSERTV(i, bdld::Datum::createDouble(2) == result);
+                arena.reset();
+            }
+            ASSERT(5 == shapes.numShapes());
+            ASSERT(2 == getY.numMisses());
+            ASSERT(sjtt::PropertyCache::e_Polymorphic == getY.state());
+            ASSERT(sjtt::PropertyCache::e_Polymorphic == setX.state());
+
+            if (verbose) cout << "\tStores, absent properties, calls."
+                              << endl;
+
+            const struct {
+                int         d_line;
+                Bytecode    d_code[8];
+                int         d_status;
+                bdld::Datum d_result;
+            } DATA[] = {
+                { L_, { NEW, ONE, SETX, TWO, SETX, GETX, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createDouble(2) },
+                { L_, { NEW, GETZ, RET },
+                  InterpretUtil::e_Success, DatumUtil::s_Undefined },
+                { L_, { NEW, ONE, SETX, GETZ, RET },
+                  InterpretUtil::e_Success, DatumUtil::s_Undefined },
+                { L_, { NEW, TWO, SETX, ID, CALL, GETX, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createDouble(2) },
+                { L_, { NEW, NEW, ONE, SETX, SETY, GETY, GETX, RET },
+                  InterpretUtil::e_Success, bdld::Datum::createDouble(1) },
+                { L_, { ONE, GETX, RET },
+                  InterpretUtil::e_TypeError, bdld::Datum() },
+                { L_, { ONE, TWO, SETX, RET },
+                  InterpretUtil::e_TypeError, bdld::Datum() },
+                { L_, { NEW, SETG, ONE, RET },
+                  InterpretUtil::e_TypeError, bdld::Datum() },
+            };
+            const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+            for (int ti = 0; ti < NUM_DATA; ++ti) {
+                const int   LINE = DATA[ti].d_line;
+                bdld::Datum result;
+                const int   rc = InterpretUtil::interpret(&result,
+                                                          &context,
+                                                          DATA[ti].d_code);
+                ASSERTV(LINE, rc, DATA[ti].d_status == rc);
+                if (InterpretUtil::e_Success == rc) {
+                    ASSERTV(LINE, result, DATA[ti].d_result == result);
+                }
+                ASSERTV(LINE, 0 == arena.stack()->size());
+                arena.reset();
+            }
+            ASSERT(!DatumUtil::isObject(globals[0].datum()));
+
+            if (verbose) cout << "\tMegamorphic caches still work." << endl;
+
+            const char *NAMES[] = { "a", "b", "c", "d", "e", "f" };
+            const int   NUM_NAMES = sizeof NAMES / sizeof *NAMES;
+            for (int i = 0; i < NUM_NAMES; ++i) {
+                sjtt::PropertyCache setName(NAMES[i], &ta);
+                const Bytecode code[] = {
+                    NEW,
+                    ONE,
+                    Bytecode::create(Bytecode::e_SetProperty,
+                                     DatumUtil::createPropertyCache(&setName)),
+                    TWO,
+                    SETX,
+                    GETX,
+                    RET
+                };
+                bdld::Datum result;
+                ASSERTV(i, 0 == InterpretUtil::interpret(&result,
+                                                         &context,
+                                                         code));
+                ASSERTV(i, bdld::Datum::createDouble(2) == result);
+                arena.reset();
+            }
+            ASSERT(sjtt::PropertyCache::e_Megamorphic == getX.state());
+            ASSERT(sjtt::PropertyCache::k_MAX_ENTRIES == getX.numEntries());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 10: {
+        if (verbose) cout << endl
+                          << "compact values" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            bsl::vector<bdld::Datum>        stack(&ta);
+            sjtt::ExecutionContext          context(&ta, &stack);
+            sjtt::ExecutionContext::Globals globals(&ta);
+            globals.resize(2);
+            context.setGlobals(&globals);
+
+            if (verbose) cout << "\tValues of every kind cross calls."
+                              << endl;
+
+            const bdld::Datum FIRST  = bdld::Datum::copyString("first", &ta);
+            const bdld::Datum SECOND = bdld::Datum::copyString("second",
+                                                               &ta);
+            const bdld::Datum VALUES[] = {
+                bdld::Datum::createDouble(1.5),
+                bdld::Datum::createInteger(-3),
+                bdld::Datum::createBoolean(true),
+                DatumUtil::s_Null,
+                DatumUtil::s_Undefined,
+                DatumUtil::createExternalFunction(&identity),
+                FIRST,
+            };
+            const int NUM_VALUES = sizeof VALUES / sizeof *VALUES;
+
+            for (int i = 0; i < NUM_VALUES; ++i) {
+                const Bytecode code[] = {
+                    Bytecode::createPush(VALUES[i]),
+                    Bytecode::createPush(
+                              DatumUtil::createExternalFunction(&identity)),
+                    Bytecode::createOpcode(Bytecode::e_Execute),
+                    Bytecode::createOpcode(Bytecode::e_Return),
+                };
+                bdld::Datum result;
+                ASSERTV(i, 0 == InterpretUtil::interpret(&result,
+                                                         &context,
+                                                         code));
+                ASSERTV(i, VALUES[i] == result);
+            }
+
+            if (verbose) cout << "\tValues read from globals, deep stacks."
+                              << endl;
+
+            // 'k_COUNT' reads of each global, outgrowing the buffer of the
+            // interpreter.
+
+            enum { k_COUNT = 150 };
+            bsl::vector<Bytecode> code(&ta);
+            for (int slot = 0; slot < 2; ++slot) {
+                for (int i = 0; i < k_COUNT; ++i) {
+                    code.push_back(Bytecode::create(
+                                         Bytecode::e_GetGlobalSlot,
+                                         bdld::Datum::createInteger(slot)));
+                }
+            }
+            code.push_back(Bytecode::createPush(
+                          DatumUtil::createExternalFunction(&countStrings)));
+            code.push_back(Bytecode::createOpcode(Bytecode::e_Execute));
+            code.push_back(Bytecode::createOpcode(Bytecode::e_Return));
+
+            bsl::size_t maxDepth   = 0;
+            bsl::size_t errorIndex = 0;
+            ASSERT(0 == VerifyUtil::verify(&maxDepth,
+                                           &errorIndex,
+                                           code.data(),
+                                           code.size()));
+
+            for (int reserved = 0; reserved < 2; ++reserved) {
+                globals[0].clone(FIRST);
+                globals[1].clone(SECOND);
+                bdld::Datum result;
+                const int   rc = reserved
+                               ? InterpretUtil::interpret(&result,
+                                                          &context,
+                                                          code.data(),
+                                                          maxDepth)
+                               : InterpretUtil::interpret(&result,
+                                                          &context,
+                                                          code.data());
+                ASSERTV(reserved, 0 == rc);
+                ASSERTV(reserved, result,
+                        bdld::Datum::createInteger(1001 * k_COUNT) ==
+                                                                     result);
+                ASSERT(0 == stack.size());
+            }
+
+            globals.clear();
+            bdld::Datum::destroy(FIRST, &ta);
+            bdld::Datum::destroy(SECOND, &ta);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 9: {
+        if (verbose) cout << endl
+                          << "suspension" << endl
+                          << "==========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        bsl::vector<bdld::Datum> stack(&ta);
+        sjtt::ExecutionContext context(&ta, &stack);
+        FakeService service;
+        FakeService::s_instance_p = &service;
+
+        const bdld::Datum FETCH =
+                      DatumUtil::createExternalFunction(&FakeService::fetch);
+
+        // Each script is 'fetch(fetch(key) + 1) + 0.5'.
+
+        enum { k_NUM_SCRIPTS = 1000, k_SCRIPT_LENGTH = 8 };
+        bsl::vector<Bytecode> code(&ta);
+        for (int i = 0; i < k_NUM_SCRIPTS; ++i) {
+            code.push_back(Bytecode::createPush(
+                                            bdld::Datum::createDouble(2 * i)));
+            code.push_back(Bytecode::createPush(FETCH));
+            code.push_back(Bytecode::createOpcode(Bytecode::e_Execute));
+            code.push_back(Bytecode::create(Bytecode::e_PushAddDoubles,
+                                            bdld::Datum::createDouble(1)));
+            code.push_back(Bytecode::createPush(FETCH));
+            code.push_back(Bytecode::createOpcode(Bytecode::e_Execute));
+            code.push_back(Bytecode::create(Bytecode::e_PushAddDoubles,
+                                            bdld::Datum::createDouble(0.5)));
+            code.push_back(Bytecode::createOpcode(Bytecode::e_Return));
+        }
+        bsl::size_t maxDepth   = 0;
+        bsl::size_t errorIndex = 0;
+        ASSERT(0 == VerifyUtil::verify(&maxDepth,
+                                       &errorIndex,
+                                       code.data(),
+                                       k_SCRIPT_LENGTH));
+
+        if (verbose) cout << "\tMany scripts in flight on one thread."
+                          << endl;
+
+        for (int depth = 0; depth < 2; ++depth) {
+            const bsl::size_t MAX_DEPTH = depth ? maxDepth : 0;
+
+            bsl::vector<sjtt::Continuation *> continuations(&ta);
+            bsl::vector<double>               keys(&ta);
+            for (int i = 0; i < k_NUM_SCRIPTS; ++i) {
+                continuations.push_back(new (ta) sjtt::Continuation(&ta));
+                bdld::Datum result;
+                ASSERT(InterpretUtil::e_Suspended ==
+                           InterpretUtil::start(&result,
+                                                &context,
+                                                continuations.back(),
+                                                &code[i * k_SCRIPT_LENGTH],
+                                                MAX_DEPTH));
+                ASSERT(continuations.back()->isSuspended());
+                ASSERT(0 == stack.size());
+                keys.push_back(service.takeRequest());
+            }
+            ASSERT(0 == service.numRequests());
+
+            // Answer the requests in reverse order, so that scripts finish in
+            // an order other than the one they were started in.
+
+            int numDone = 0;
+            while (numDone < k_NUM_SCRIPTS) {
+                for (int i = k_NUM_SCRIPTS - 1; i >= 0; --i) {
+                    sjtt::Continuation *continuation = continuations[i];
+                    if (!continuation->isSuspended()) {
+                        continue;                                   // CONTINUE
+                    }
+                    bdld::Datum result;
+                    const int rc = InterpretUtil::resume(
+                             &result,
+                             &context,
+                             continuation,
+                             bdld::Datum::createDouble(
+                                           FakeService::answer(keys[i])));
+                    ASSERT(0 == stack.size());
+                    if (InterpretUtil::e_Suspended == rc) {
+                        ASSERT(continuation->isSuspended());
+                        keys[i] = service.takeRequest();
+                        continue;                                   // CONTINUE
+                    }
+                    ASSERTV(i, rc, 0 == rc);
+                    ASSERT(!continuation->isSuspended());
+                    ASSERTV(i, result,
+                            bdld::Datum::createDouble(200 * i + 10.5) ==
+                                                                      result);
+                    ++numDone;
+                }
+            }
+            for (int i = 0; i < k_NUM_SCRIPTS; ++i) {
+                ta.deleteObject(continuations[i]);
+            }
+        }
+
+        if (verbose) cout << "\tPacked programs." << endl;
+        {
+            sjtt::ProgramBuilder builder(&ta);
+            ASSERT(0 == builder.append(code.data(), k_SCRIPT_LENGTH));
+            sjtt::Program program(&ta);
+            builder.build(&program);
+
+            sjtt::Continuation continuation(&ta);
+            bdld::Datum        result;
+            ASSERT(InterpretUtil::e_Suspended ==
+                   InterpretUtil::start(&result,
+                                        &context,
+                                        &continuation,
+                                        program));
+            ASSERT(sjtt::Continuation::e_Program == continuation.kind());
+            ASSERT(3 == continuation.pc());
+            ASSERT(0 == service.takeRequest());
+            ASSERT(InterpretUtil::e_Suspended ==
+                   InterpretUtil::resume(&result,
+                                         &context,
+                                         &continuation,
+                                         bdld::Datum::createDouble(3)));
+            ASSERT(6 == continuation.pc());
+            ASSERT(4 == service.takeRequest());
+            ASSERT(0 == InterpretUtil::resume(&result,
+                                              &context,
+                                              &continuation,
+                                              bdld::Datum::createDouble(5)));
+            ASSERTV(result, bdld::Datum::createDouble(5.5) == result);
+            ASSERT(!continuation.isSuspended());
+        }
+
+        if (verbose) cout << "\tResuming on another thread." << endl;
+        {
+            sjtt::Continuation continuation(&ta);
+            bdld::Datum        result;
+            ASSERT(InterpretUtil::e_Suspended ==
+                   InterpretUtil::start(&result,
+                                        &context,
+                                        &continuation,
+                                        code.data(),
+                                        maxDepth));
+            ASSERT(0 == service.takeRequest());
+
+            bsl::vector<bdld::Datum> otherStack(&ta);
+            sjtt::ExecutionContext   otherContext(&ta, &otherStack);
+            int                      rc = -1;
+            const Resumer resumer = { &otherContext,
+                                      &continuation,
+                                      bdld::Datum::createDouble(1),
+                                      &result,
+                                      &rc };
+            bslmt::ThreadUtil::Handle handle;
+            ASSERT(0 == bslmt::ThreadUtil::create(&handle, resumer));
+            ASSERT(0 == bslmt::ThreadUtil::join(handle));
+            ASSERT(InterpretUtil::e_Suspended == rc);
+            ASSERT(2 == service.takeRequest());
+            ASSERT(0 == otherStack.size());
+
+            ASSERT(0 == InterpretUtil::resume(&result,
+                                              &context,
+                                              &continuation,
+                                              bdld::Datum::createDouble(2)));
+            ASSERTV(result, bdld::Datum::createDouble(2.5) == result);
+        }
+
+        if (verbose) cout << "\tSuspending without a continuation." << endl;
+        {
+            bdld::Datum result = bdld::Datum::createInteger(7);
+            ASSERT(InterpretUtil::e_Suspended ==
+                        InterpretUtil::interpret(&result, &context, &code[0]));
+            ASSERT(bdld::Datum::createInteger(7) == result);
+            ASSERT(0 == stack.size());
+            ASSERT(0 == context.status());
+            ASSERT(0 == service.takeRequest());
+        }
+        FakeService::s_instance_p = 0;
+      } break;
+      case 8: {
+        if (verbose) cout << endl
+                          << "array opcodes" << endl
+                          << "=============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        bdlma::LocalSequentialAllocator<4096> alloc(&ta);
+        bsl::vector<bdld::Datum> stack(&ta);
+        sjtt::ExecutionContext context(&alloc, &stack);
+
+        bdld::DatumMutableArrayRef a;
+        bdld::DatumMutableArrayRef b;
+        bdld::Datum::createUninitializedArray(&a, 3, &ta);
+        bdld::Datum::createUninitializedArray(&b, 3, &ta);
+        for (int i = 0; i < 3; ++i) {
+            a.data()[i] = bdld::Datum::createDouble(i + 1);  // 1 2 3
+            b.data()[i] = bdld::Datum::createDouble(2);      // 2 2 2
+        }
+        *a.length() = 3;
+        *b.length() = 3;
+        const bdld::Datum A = bdld::Datum::adoptArray(a);
+        const bdld::Datum B = bdld::Datum::adoptArray(b);
+
+        // 'sum(a * b + a) + dot(a + b, b)' == 18 + 24
+
+        const Bytecode code[] = {
+            Bytecode::createPush(A),
+            Bytecode::createPush(B),
+            Bytecode::createPush(A),
+            Bytecode::createOpcode(Bytecode::e_MultiplyAddArrays),
+            Bytecode::createOpcode(Bytecode::e_SumArray),
+            Bytecode::createPush(A),
+            Bytecode::createPush(B),
+            Bytecode::createOpcode(Bytecode::e_AddArrays),
+            Bytecode::createPush(B),
+            Bytecode::createOpcode(Bytecode::e_DotArrays),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        const bsl::size_t NUM_CODES = sizeof code / sizeof *code;
+
+        bdld::Datum result;
+        ASSERT(0 == InterpretUtil::interpret(&result, &context, code));
+        ASSERTV(result, bdld::Datum::createDouble(42) == result);
+        ASSERT(0 == stack.size());
+
+        bsl::size_t maxDepth   = 0;
+        bsl::size_t errorIndex = 0;
+        ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, code,
+                                       NUM_CODES));
+        ASSERT(3 == maxDepth);
+        ASSERT(0 == InterpretUtil::interpret(&result,
+                                             &context,
+                                             code,
+                                             maxDepth));
+        ASSERTV(result, bdld::Datum::createDouble(42) == result);
+        ASSERT(0 == stack.size());
+
+        const Bytecode multiply[] = {
+            Bytecode::createPush(A),
+            Bytecode::createPush(B),
+            Bytecode::createOpcode(Bytecode::e_MultiplyArrays),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        ASSERT(0 == InterpretUtil::interpret(&result, &context, multiply));
+        ASSERT(result.isArray());
+        ASSERT(3 == result.theArray().length());
+        ASSERT(bdld::Datum::createDouble(6) == result.theArray()[2]);
+
+        const Bytecode mismatch[] = {
+            Bytecode::createPush(A),
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createOpcode(Bytecode::e_AddArrays),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        ASSERT(InterpretUtil::e_TypeError ==
+                       InterpretUtil::interpret(&result, &context, mismatch));
+        ASSERT(0 == stack.size());
+
+        bdld::Datum::destroy(A, &ta);
+        bdld::Datum::destroy(B, &ta);
+      } break;
+      case 7: {
+        if (verbose) cout << endl
+                          << "global slots" << endl
+                          << "============" << endl;
+
+        bdlma::LocalSequentialAllocator<1024> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+        sjtt::ExecutionContext::Globals globals(&alloc);
+        globals.resize(2);
+        globals[0].clone(bdld::Datum::createDouble(5));
+        context.setGlobals(&globals);
+
+        // 'x = x + 1; y = x + x; return y;'
+
+        const bdld::Datum X = bdld::Datum::createInteger(0);
+        const bdld::Datum Y = bdld::Datum::createInteger(1);
+        const Bytecode code[] = {
+            Bytecode::create(Bytecode::e_GetGlobalSlot, X),
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::create(Bytecode::e_SetGlobalSlot, X),
+            Bytecode::create(Bytecode::e_GetGlobalSlot, X),
+            Bytecode::create(Bytecode::e_GetGlobalSlot, X),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::create(Bytecode::e_SetGlobalSlot, Y),
+            Bytecode::create(Bytecode::e_GetGlobalSlot, Y),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        const bsl::size_t NUM_CODES = sizeof code / sizeof *code;
+
+        bdld::Datum result;
+        ASSERT(0 == InterpretUtil::interpret(&result, &context, code));
+        ASSERTV(result, bdld::Datum::createDouble(12) == result);
+        ASSERT(bdld::Datum::createDouble(6)  == globals[0].datum());
+        ASSERT(bdld::Datum::createDouble(12) == globals[1].datum());
+        ASSERT(0 == stack.size());
+
+        bsl::size_t maxDepth   = 0;
+        bsl::size_t errorIndex = 0;
+        ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, code,
+                                       NUM_CODES));
+        sjtt::ProgramBuilder builder(&alloc);
+        ASSERT(0 == builder.append(code, NUM_CODES));
+        sjtt::Program program(&alloc);
+        builder.build(&program);
+        ASSERT(0 == InterpretUtil::interpret(&result,
+                                             &context,
+                                             program,
+                                             maxDepth));
+        ASSERTV(result, bdld::Datum::createDouble(14) == result);
+        ASSERT(bdld::Datum::createDouble(7) == globals[0].datum());
+        ASSERT(0 == stack.size());
+
+        // The same program runs in place from its image.
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            bsl::vector<char> buffer(&ta);
+            ASSERT(0 == sjtt::ProgramImage::encode(&buffer, program));
+            sjtt::ProgramImage image(&ta);
+            ASSERT(0 == image.load(buffer.data(), buffer.size()));
+            ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, image));
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, image));
+            ASSERTV(result, bdld::Datum::createDouble(16) == result);
+            ASSERT(0 == InterpretUtil::interpret(&result,
+                                                 &context,
+                                                 image,
+                                                 maxDepth));
+            ASSERTV(result, bdld::Datum::createDouble(18) == result);
+            ASSERT(bdld::Datum::createDouble(9) == globals[0].datum());
+            ASSERT(0 == stack.size());
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 6: {
+        if (verbose) cout << endl
+                          << "verified programs" << endl
+                          << "=================" << endl;
+
+        bdlma::LocalSequentialAllocator<1024> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+        stack.push_back(bdld::Datum::createInteger(42));
+
+        const Bytecode code[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(10)),
+            Bytecode::createPush(bdld::Datum::createDouble(2)),
+            Bytecode::createPush(bdld::Datum::createDouble(3)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createPush(DatumUtil::createExternalFunction(&negate)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createPush(
+                              DatumUtil::createExternalFunction(&subtract)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createPush(bdld::Datum::createDouble(2)),
+            Bytecode::createPush(bdld::Datum::createDouble(3)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        const bsl::size_t NUM_CODES = sizeof code / sizeof *code;
+
+        bsl::size_t maxDepth   = 0;
+        bsl::size_t errorIndex = 0;
+        ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, code,
+                                       NUM_CODES));
+        ASSERT(7 == maxDepth);  // as if 'negate' and 'subtract' popped nothing
+
+        bdld::Datum result;
+        ASSERT(0 == InterpretUtil::interpret(&result,
+                                             &context,
+                                             code,
+                                             maxDepth));
+        ASSERTV(result, bdld::Datum::createDouble(21) == result);
+        ASSERT(1 == stack.size());
+        ASSERT(bdld::Datum::createInteger(42) == stack[0]);
+
+        sjtt::ProgramBuilder builder(&alloc);
+        ASSERT(0 == builder.append(code, NUM_CODES));
+        sjtt::Program program(&alloc);
+        builder.build(&program);
+        result = bdld::Datum::createNull();
+        ASSERT(0 == InterpretUtil::interpret(&result,
+                                             &context,
+                                             program,
+                                             maxDepth));
+        ASSERTV(result, bdld::Datum::createDouble(21) == result);
+        ASSERT(1 == stack.size());
+
+        // Once the stack has grown to the program's depth, it is never
+        // reallocated.
+
+        const Bytecode record[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createPush(
+                           DatumUtil::createExternalFunction(&recordStack)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createPush(bdld::Datum::createDouble(2)),
+            Bytecode::createPush(bdld::Datum::createDouble(3)),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, record, 6));
+        ASSERT(0 == InterpretUtil::interpret(&result,
+                                             &context,
+                                             record,
+                                             maxDepth));
+        const bdld::Datum *data = stack.data();
+        ASSERT(data == s_stackData);
+        ASSERT(bdld::Datum::createDouble(3) == result);
+        ASSERT(0 == InterpretUtil::interpret(&result,
+                                             &context,
+                                             record,
+                                             maxDepth));
+        ASSERT(data == s_stackData);
+        ASSERT(data == stack.data());
+      } break;
+      case 5: {
+        if (verbose) cout << endl
+                          << "packed programs" << endl
+                          << "===============" << endl;
+
+        bdlma::LocalSequentialAllocator<1024> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+
+        const Bytecode code[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(10)),
+            Bytecode::createPush(bdld::Datum::createDouble(2)),
+            Bytecode::createPush(bdld::Datum::createDouble(10)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createPush(DatumUtil::createExternalFunction(&negate)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createPush(
+                              DatumUtil::createExternalFunction(&subtract)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        sjtt::ProgramBuilder builder(&alloc);
+        ASSERT(0 == builder.append(code, sizeof code / sizeof *code));
+        sjtt::Program program(&alloc);
+        builder.build(&program);
+
+        bdld::Datum expected;
+        ASSERT(0 == InterpretUtil::interpret(&expected, &context, code));
+        bdld::Datum result;
+        ASSERT(0 == InterpretUtil::interpret(&result, &context, program));
+        ASSERTV(result, bdld::Datum::createDouble(22) == result);
+        ASSERT(expected == result);
+        ASSERT(0 == stack.size());
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "errors" << endl
+                          << "======" << endl;
+
+        bdlma::LocalSequentialAllocator<256> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+        const bdld::Datum ORIGINAL = bdld::Datum::createInteger(77);
+        bdld::Datum result = ORIGINAL;
+
+        const Bytecode badAdd[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createPush(bdld::Datum::createInteger(1)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        ASSERT(InterpretUtil::e_TypeError ==
+                           InterpretUtil::interpret(&result, &context, badAdd));
+        ASSERT(ORIGINAL == result);
+        ASSERT(0 == stack.size());
+
+        const Bytecode badCall[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createPush(DatumUtil::s_Undefined),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        ASSERT(InterpretUtil::e_NotCallable ==
+                          InterpretUtil::interpret(&result, &context, badCall));
+        ASSERT(ORIGINAL == result);
+        ASSERT(0 == stack.size());
+
+        // An external function leaving no result, or more values than the
+        // program pushed, is reported in every build mode.
+
+        const Bytecode noResult[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createPush(DatumUtil::createExternalFunction(&discard)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        ASSERT(InterpretUtil::e_BadCall ==
+                   InterpretUtil::interpret(&result, &context, noResult));
+        ASSERT(ORIGINAL == result);
+        ASSERT(0 == stack.size());
+
+        const Bytecode twoResults[] = {
+            Bytecode::createPush(
+                           DatumUtil::createExternalFunction(&pushTwice)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        ASSERT(InterpretUtil::e_BadCall ==
+                   InterpretUtil::interpret(&result, &context, twoResults));
+        ASSERT(ORIGINAL == result);
+        ASSERT(0 == stack.size());
+
+        // So is one popping every value of the program, and the values on
+        // the stack below the program are left alone.
+
+        stack.push_back(ORIGINAL);
+        ASSERT(InterpretUtil::e_BadCall ==
+                   InterpretUtil::interpret(&result, &context, noResult + 1));
+        ASSERT(ORIGINAL == result);
+        ASSERT(1 == stack.size());
+        ASSERT(ORIGINAL == stack[0]);
+        ASSERT(0 == context.status());
+        stack.clear();
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "e_Execute" << endl
+                          << "=========" << endl;
+
+        bdlma::LocalSequentialAllocator<256> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+
+        // 10 - -(2 + 3)
+
+        const Bytecode program[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(10)),
+            Bytecode::createPush(bdld::Datum::createDouble(2)),
+            Bytecode::createPush(bdld::Datum::createDouble(3)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createPush(DatumUtil::createExternalFunction(&negate)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createPush(
+                              DatumUtil::createExternalFunction(&subtract)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        bdld::Datum result;
+        ASSERT(0 == InterpretUtil::interpret(&result, &context, program));
+        ASSERTV(result, bdld::Datum::createDouble(15) == result);
+        ASSERT(0 == stack.size());
+
+        if (verbose) cout << "\tValues replaced between calls." << endl;
+        {
+            // The values below the arguments of a call are not copied again
+            // by the next call unless they were popped in between: here, the
+            // 100 left by the first call is replaced by 101.
+
+            const Bytecode SUBTRACT = Bytecode::createPush(
+                                DatumUtil::createExternalFunction(&subtract));
+            const Bytecode code[] = {
+                Bytecode::createPush(bdld::Datum::createDouble(100)),
+                Bytecode::createPush(bdld::Datum::createDouble(10)),
+                Bytecode::createPush(bdld::Datum::createDouble(3)),
+                SUBTRACT,
+                Bytecode::createOpcode(Bytecode::e_Execute),
+                Bytecode::createOpcode(Bytecode::e_Pop),
+                Bytecode::create(Bytecode::e_PushAddDoubles,
+                                 bdld::Datum::createDouble(1)),
+                Bytecode::createPush(bdld::Datum::createDouble(1)),
+                SUBTRACT,
+                Bytecode::createOpcode(Bytecode::e_Execute),
+                Bytecode::createOpcode(Bytecode::e_Return),
+            };
+            ASSERT(0 == InterpretUtil::interpret(&result, &context, code));
+            ASSERTV(result, bdld::Datum::createDouble(100) == result);
+            ASSERT(0 == stack.size());
+        }
+
+        if (verbose) cout << "\tCollection during a call." << endl;
+        {
+            // The values left on the stack by a call are read back if the
+            // callee collected the heap, which promoted them.
+
+            bslma::TestAllocator ta(veryVerbose);
+            {
+                sjtt::ExecutionArena   arena(&ta);
+                sjtt::ExecutionContext heapContext(&arena);
+                sjtt::Heap             heap(&arena, &ta);
+                heap.addRoots(arena.stack());
+                heapContext.setHeap(&heap);
+                s_heap_p = &heap;
+
+                const bdld::Datum TEXT = bdld::Datum::copyString(
+                            "a string too long to be stored inside a Datum",
+                            &ta);
+                const Bytecode code[] = {
+                    Bytecode::createPush(TEXT),
+                    Bytecode::createPush(
+                               DatumUtil::createExternalFunction(&collect)),
+                    Bytecode::createOpcode(Bytecode::e_Execute),
+                    Bytecode::createOpcode(Bytecode::e_Pop),
+                    Bytecode::createOpcode(Bytecode::e_Return),
+                };
+                ASSERT(0 == InterpretUtil::interpret(&result,
+                                                     &heapContext,
+                                                     code));
+                ASSERT(1 == heap.stats().d_numMinorCollections);
+                ASSERTV(result, TEXT == result);
+                ASSERT(heap.isTenured(result));
+                ASSERT(0 == arena.stack()->size());
+
+                s_heap_p = 0;
+                bdld::Datum::destroy(TEXT, &ta);
+            }
+            ASSERT(0 == ta.numBytesInUse());
+        }
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "e_AddDoubles" << endl
+                          << "============" << endl;
+
+        bdlma::LocalSequentialAllocator<256> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+
+        // Values already on the stack must be left alone.
+
+        stack.push_back(bdld::Datum::createInteger(42));
+
+        const Bytecode program[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(1.5)),
+            Bytecode::createPush(bdld::Datum::createDouble(2)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createPush(bdld::Datum::createDouble(4)),
+            Bytecode::createPush(bdld::Datum::createDouble(8)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        bdld::Datum result;
+        ASSERT(0 == InterpretUtil::interpret(&result, &context, program));
+        ASSERTV(result, bdld::Datum::createDouble(15.5) == result);
+        ASSERT(1 == stack.size());
+        ASSERT(bdld::Datum::createInteger(42) == stack[0]);
+      } break;
       case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bdlma::LocalSequentialAllocator<256> alloc;
+        bsl::vector<bdld::Datum> stack(&alloc);
+        sjtt::ExecutionContext context(&alloc, &stack);
+
+        const Bytecode program[] = {
+            Bytecode::createPush(bdld::Datum::createInteger(3)),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        bdld::Datum result;
+        ASSERT(0 == InterpretUtil::interpret(&result, &context, program));
+        ASSERT(bdld::Datum::createInteger(3) == result);
+        ASSERT(0 == stack.size());
       } break;
       default: {
         cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
@@ -0,0 +1,446 @@
+// sjtu_jitcode.cpp
+#include <sjtu_jitcode.h>
+
+#include <sjtt_bytecode.h>
+
+#include <bslma_default.h>
+#include <bsls_assert.h>
+#include <bsls_platform.h>
+#include <bsls_types.h>
+
+#include <bsl_cstring.h>
+
+#if defined(BSLS_PLATFORM_OS_LINUX) && defined(BSLS_PLATFORM_CPU_X86_64)
+#define SJTU_JITCODE_X86_64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace sjtu {
+using BloombergLP::bdld::Datum;
+using sjtt::Bytecode;
+
+namespace {
+
+typedef int (*Entry)(double *result, const JitCode::Globals *globals);
+    // Signature of a compiled program.
+
+int readGlobal(double *value, const JitCode::Globals *globals, int slot)
+    // Load into the specified 'value' the double held by the global in the
+    // specified 'slot' of the specified 'globals'.  Return 0 on success, and
+    // a non-zero value if there is no such global or it is not a double.
+    // This function is called by compiled programs.
+{
+    if (0 == globals || globals->size() <= static_cast<bsl::size_t>(slot)) {
+        return 1;                                                     // RETURN
+    }
+    const Datum& global = (*globals)[slot].datum();
+    if (!global.isDouble()) {
+        return 1;                                                     // RETURN
+    }
+    *value = global.theDouble();
+    return 0;
+}
+
+int check(bsl::size_t *numCodes, const Bytecode *code)
+    // Load into the specified 'numCodes' the number of instructions of the
+    // program beginning at the specified 'code', and return 0 if it can be
+    // compiled, as described in the documentation of 'JitCode'.  Return a
+    // non-zero value, with no effect on 'numCodes', otherwise.
+{
+    int depth = 0;
+    for (bsl::size_t i = 0;; ++i) {
+        const Datum& data = code[i].data();
+        switch (code[i].opcode()) {
+          case Bytecode::e_Push: {
+            if (!data.isDouble() || JitCode::k_MAX_DEPTH <= depth) {
+                return 1;                                             // RETURN
+            }
+            ++depth;
+          } break;
+          case Bytecode::e_AddDoubles: {
+            if (2 > depth) {
+                return 1;                                             // RETURN
+            }
+            --depth;
+          } break;
+          case Bytecode::e_PushAddDoubles: {
+            if (1 > depth || !data.isDouble()) {
+                return 1;                                             // RETURN
+            }
+          } break;
+          case Bytecode::e_Pop: {
+            if (1 > depth) {
+                return 1;                                             // RETURN
+            }
+            --depth;
+          } break;
+          case Bytecode::e_GetGlobalSlot: {
+            if (!data.isInteger()
+             || 0 > data.theInteger()
+             || JitCode::k_MAX_DEPTH <= depth) {
+                return 1;                                             // RETURN
+            }
+            ++depth;
+          } break;
+          case Bytecode::e_Return: {
+            if (1 > depth) {
+                return 1;                                             // RETURN
+            }
+            *numCodes = i + 1;
+            return 0;                                                 // RETURN
+          }
+          default: {
+            return 1;                                                 // RETURN
+          }
+        }
+    }
+}
+
+#ifdef SJTU_JITCODE_X86_64
+
+                              // ===============
+                              // class Assembler
+                              // ===============
+
+class Assembler {
+    // This class emits the x86-64 templates of the compiled opcodes.  Value
+    // 'i' of the stack of the program is held in register 'xmm<i>'; 'xmm15'
+    // is a scratch register.  'rbx' holds the address of the result and
+    // 'r12' the globals.  The frame holds one 8-byte spill slot per register
+    // at '[rsp + 8 * i]', and is sized so that 'rsp' is 16-byte aligned for
+    // calls.
+
+    // DATA
+    bsl::vector<unsigned char>& d_out;
+    bsl::vector<bsl::size_t>    d_bailouts;  // offsets of 'jnz' operands
+
+    // PRIVATE MANIPULATORS
+    void emit(unsigned char value) {
+        d_out.push_back(value);
+    }
+
+    void emit32(unsigned value) {
+        for (int i = 0; i < 4; ++i) {
+            emit(static_cast<unsigned char>(value >> (8 * i)));
+        }
+    }
+
+    void emit64(BloombergLP::bsls::Types::Uint64 value) {
+        for (int i = 0; i < 8; ++i) {
+            emit(static_cast<unsigned char>(value >> (8 * i)));
+        }
+    }
+
+    void emitSse(unsigned char prefix,
+                 unsigned char opcode,
+                 int           reg,
+                 int           rmBase,
+                 unsigned char mod) {
+        // Emit the SSE instruction having the specified 'prefix' and
+        // 'opcode', whose register operand is 'xmm<reg>' and whose other
+        // operand is described by the specified 'mod' and 'rmBase'.
+
+        emit(prefix);
+        const unsigned char rex = static_cast<unsigned char>(
+                                  0x40 | (8 <= reg ? 4 : 0)
+                                       | (0xC0 == mod && 8 <= rmBase ? 1 : 0));
+        if (0x40 != rex) {
+            emit(rex);
+        }
+        emit(0x0F);
+        emit(opcode);
+        emit(static_cast<unsigned char>(mod | (reg & 7) << 3 | (rmBase & 7)));
+    }
+
+    void epilogue() {
+        emit(0x48); emit(0x81); emit(0xC4); emit32(k_FRAME_SIZE);  // add rsp
+        emit(0x41); emit(0x5C);                                    // pop r12
+        emit(0x5B);                                                // pop rbx
+        emit(0xC3);                                                // ret
+    }
+
+  public:
+    // TYPES
+    enum {
+        k_NUM_SPILL_SLOTS = 16,
+        k_FRAME_SIZE      = 8 * k_NUM_SPILL_SLOTS + 8,
+        k_SCRATCH         = 15
+    };
+
+    // CREATORS
+    explicit Assembler(bsl::vector<unsigned char> *out)
+    : d_out(*out) {
+    }
+
+    // MANIPULATORS
+    void prologue() {
+        emit(0x53);                                                // push rbx
+        emit(0x41); emit(0x54);                                    // push r12
+        emit(0x48); emit(0x81); emit(0xEC); emit32(k_FRAME_SIZE);  // sub rsp
+        emit(0x48); emit(0x89); emit(0xFB);                     // mov rbx,rdi
+        emit(0x49); emit(0x89); emit(0xF4);                     // mov r12,rsi
+    }
+
+    void loadImmediate(int reg, double value) {
+        // Load the specified 'value' into 'xmm<reg>'.
+
+        BloombergLP::bsls::Types::Uint64 bits;
+        bsl::memcpy(&bits, &value, sizeof bits);
+        emit(0x48); emit(0xB8); emit64(bits);                   // mov rax,imm
+        emit(0x66);                                             // movq xmm,rax
+        emit(static_cast<unsigned char>(0x48 | (8 <= reg ? 4 : 0)));
+        emit(0x0F); emit(0x6E);
+        emit(static_cast<unsigned char>(0xC0 | (reg & 7) << 3));
+    }
+
+    void add(int dst, int src) {
+        // Add 'xmm<src>' to 'xmm<dst>'.
+
+        emitSse(0xF2, 0x58, dst, src, 0xC0);                        // addsd
+    }
+
+    void loadGlobal(int depth, int slot) {
+        // Load into 'xmm<depth>' the double in the global in the specified
+        // 'slot', preserving 'xmm0' to 'xmm<depth - 1>', or bail out.
+
+        for (int i = 0; i < depth; ++i) {                           // movsd
+            emitSse(0xF2, 0x11, i, 4, 0x80);
+            emit(0x24);
+            emit32(8 * i);
+        }
+        emit(0x48); emit(0x8D); emit(0xBC); emit(0x24);          // lea rdi,
+        emit32(8 * depth);                                       // [rsp+...]
+        emit(0x4C); emit(0x89); emit(0xE6);                     // mov rsi,r12
+        emit(0xBA); emit32(slot);                               // mov edx,imm
+        emit(0x48); emit(0xB8);                                 // mov rax,imm
+        emit64(reinterpret_cast<BloombergLP::bsls::Types::Uint64>(
+                                                              &readGlobal));
+        emit(0xFF); emit(0xD0);                                 // call rax
+        emit(0x85); emit(0xC0);                                 // test eax,eax
+        emit(0x0F); emit(0x85);                                 // jnz bailout
+        d_bailouts.push_back(d_out.size());
+        emit32(0);
+        for (int i = 0; i <= depth; ++i) {                          // movsd
+            emitSse(0xF2, 0x10, i, 4, 0x80);
+            emit(0x24);
+            emit32(8 * i);
+        }
+    }
+
+    void ret(int reg) {
+        // Store 'xmm<reg>' into the result and return 0.
+
+        emitSse(0xF2, 0x11, reg, 3, 0x00);                     // movsd [rbx]
+        emit(0x31); emit(0xC0);                                // xor eax,eax
+        epilogue();
+    }
+
+    void finish() {
+        // Emit the code returning a failed guard, if used, and resolve the
+        // jumps to it.
+
+        if (d_bailouts.empty()) {
+            return;                                                   // RETURN
+        }
+        const bsl::size_t bailout = d_out.size();
+        emit(0xB8); emit32(JitCode::e_GuardFailed);             // mov eax,imm
+        epilogue();
+        for (bsl::size_t i = 0; i < d_bailouts.size(); ++i) {
+            const bsl::size_t at     = d_bailouts[i];
+            const unsigned    offset = static_cast<unsigned>(
+                                                        bailout - (at + 4));
+            for (int j = 0; j < 4; ++j) {
+                d_out[at + j] = static_cast<unsigned char>(offset >> (8 * j));
+            }
+        }
+    }
+};
+
+void translate(bsl::vector<unsigned char> *out,
+               const Bytecode             *code,
+               bsl::size_t                 numCodes)
+    // Load into the specified 'out' the native code of the program
+    // consisting of the specified 'numCodes' instructions beginning at the
+    // specified 'code'.  The behavior is undefined unless 'check' accepts
+    // the program.
+{
+    Assembler assembler(out);
+    int       depth = 0;
+    assembler.prologue();
+    for (bsl::size_t i = 0; i < numCodes; ++i) {
+        const Datum& data = code[i].data();
+        switch (code[i].opcode()) {
+          case Bytecode::e_Push: {
+            assembler.loadImmediate(depth++, data.theDouble());
+          } break;
+          case Bytecode::e_AddDoubles: {
+            --depth;
+            assembler.add(depth - 1, depth);
+          } break;
+          case Bytecode::e_PushAddDoubles: {
+            assembler.loadImmediate(Assembler::k_SCRATCH, data.theDouble());
+            assembler.add(depth - 1, Assembler::k_SCRATCH);
+          } break;
+          case Bytecode::e_Pop: {
+            --depth;
+          } break;
+          case Bytecode::e_GetGlobalSlot: {
+            assembler.loadGlobal(depth++, data.theInteger());
+          } break;
+          case Bytecode::e_Return: {
+            assembler.ret(depth - 1);
+            assembler.finish();
+            return;                                                   // RETURN
+          }
+          default: {
+            BSLS_ASSERT(!"unreachable");
+          }
+        }
+    }
+}
+
+#endif  // SJTU_JITCODE_X86_64
+
+}  // close unnamed namespace
+
+                               // -------------
+                               // class JitCode
+                               // -------------
+
+// CLASS METHODS
+bool JitCode::isSupported()
+{
+#ifdef SJTU_JITCODE_X86_64
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool JitCode::canCompile(const Bytecode *code)
+{
+    BSLS_ASSERT(0 != code);
+
+    bsl::size_t numCodes;
+    return isSupported() && 0 == check(&numCodes, code);
+}
+
+// CREATORS
+JitCode::JitCode(Allocator *basicAllocator)
+: d_program(basicAllocator)
+, d_buffer(basicAllocator)
+, d_code_p(0)
+, d_mappedSize(0)
+, d_codeSize(0)
+{
+}
+
+JitCode::~JitCode()
+{
+    reset();
+}
+
+// MANIPULATORS
+int JitCode::compile(const Bytecode *code)
+{
+    BSLS_ASSERT(0 != code);
+
+    reset();
+    bsl::size_t numCodes;
+    if (!isSupported() || 0 != check(&numCodes, code)) {
+        return 1;                                                     // RETURN
+    }
+#ifdef SJTU_JITCODE_X86_64
+    d_buffer.clear();
+    translate(&d_buffer, code, numCodes);
+
+    const bsl::size_t page =
+                          static_cast<bsl::size_t>(sysconf(_SC_PAGESIZE));
+    const bsl::size_t size = (d_buffer.size() + page - 1) / page * page;
+    void *pages = mmap(0,
+                       size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1,
+                       0);
+    if (MAP_FAILED == pages) {
+        return 1;                                                     // RETURN
+    }
+    bsl::memcpy(pages, d_buffer.data(), d_buffer.size());
+    if (0 != mprotect(pages, size, PROT_READ | PROT_EXEC)) {
+        munmap(pages, size);
+        return 1;                                                     // RETURN
+    }
+    d_program.assign(code, code + numCodes);
+    d_code_p     = pages;
+    d_mappedSize = size;
+    d_codeSize   = d_buffer.size();
+    return 0;
+#else
+    return 1;
+#endif
+}
+
+void JitCode::reset()
+{
+#ifdef SJTU_JITCODE_X86_64
+    if (0 != d_code_p) {
+        munmap(d_code_p, d_mappedSize);
+    }
+#endif
+    d_program.clear();
+    d_code_p     = 0;
+    d_mappedSize = 0;
+    d_codeSize   = 0;
+}
+
+// ACCESSORS
+int JitCode::execute(Datum *result, const Globals *globals) const
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(isCompiled());
+
+    double    value;
+    const int rc = reinterpret_cast<Entry>(d_code_p)(&value, globals);
+    if (e_Success == rc) {
+        *result = Datum::createDouble(value);
+    }
+    return rc;
+}
+
+bool JitCode::matches(const Bytecode *code) const
+{
+    BSLS_ASSERT(0 != code);
+
+    for (bsl::size_t i = 0; i < d_program.size(); ++i) {
+        const Bytecode& compiled = d_program[i];
+        if (compiled.opcode() != code[i].opcode()) {
+            return false;                                             // RETURN
+        }
+        if (!Bytecode::hasData(compiled.opcode())) {
+            continue;                                             // CONTINUE
+        }
+
+        // Compiled programs hold only doubles and integers; doubles are
+        // compared bitwise so that a program pushing a NaN matches itself.
+
+        const Datum& data = code[i].data();
+        if (compiled.data().isDouble()) {
+            if (!data.isDouble()) {
+                return false;                                         // RETURN
+            }
+            const double lhs = compiled.data().theDouble();
+            const double rhs = data.theDouble();
+            if (0 != bsl::memcmp(&lhs, &rhs, sizeof lhs)) {
+                return false;                                         // RETURN
+            }
+        }
+        else if (!data.isInteger()
+              || data.theInteger() != compiled.data().theInteger()) {
+            return false;                                             // RETURN
+        }
+    }
+    return true;
+}
+}
@@ -0,0 +1,173 @@
+// sjtu_jitcode.h
+
+#ifndef INCLUDED_SJTU_JITCODE
+#define INCLUDED_SJTU_JITCODE
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+#ifndef INCLUDED_SJTT_GLOBALVALUE
+#include <sjtt_globalvalue.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtu {
+
+                               // =============
+                               // class JitCode
+                               // =============
+
+class JitCode {
+    // This class holds a program compiled to native code by a baseline,
+    // template compiler: each opcode is translated on its own into a fixed
+    // sequence of machine instructions, with no optimization across opcodes
+    // other than keeping the stack in registers.  Compilation is available
+    // only on x86-64 Linux (see 'isSupported').
+    //
+    // As for 'InterpretUtil', a program is the sequence of instructions
+    // ending with its first 'e_Return'.  Only straight-line programs that
+    // compute a double from double constants and globals can be compiled:
+    // 'e_Push' of a double (which becomes an immediate load),
+    // 'e_PushAddDoubles' of a double, 'e_AddDoubles' (done in XMM
+    // registers), 'e_Pop', 'e_GetGlobalSlot', and 'e_Return', with at most
+    // 'k_MAX_DEPTH' values on the stack.  These opcodes have no side
+    // effects, so when a guard fails at run time, i.e., a global read is not
+    // a double, 'execute' reports it and the caller can simply run the
+    // program again with the interpreter.
+    //
+    // The native code is written to pages obtained with 'mmap' that are
+    // writable while the code is emitted and then made executable, and
+    // never both.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef bsl::vector<sjtt::GlobalValue> Globals;
+
+    enum {
+        k_MAX_DEPTH = 15  // values the stack of a compiled program may hold
+    };
+
+    enum Status {
+        // Enumeration used to describe the result of 'execute'.
+
+        e_Success = 0,
+            // the program returned a value
+
+        e_GuardFailed
+            // a global read by the program is not a double
+    };
+
+  private:
+    // DATA
+    bsl::vector<sjtt::Bytecode> d_program;      // copy of the program
+    bsl::vector<unsigned char>  d_buffer;       // code being emitted
+    void                       *d_code_p;       // executable pages, or 0
+    bsl::size_t                 d_mappedSize;   // size of the pages
+    bsl::size_t                 d_codeSize;     // size of the code
+
+    // NOT IMPLEMENTED
+    JitCode(const JitCode&);
+    JitCode& operator=(const JitCode&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(JitCode,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CLASS METHODS
+    static bool canCompile(const sjtt::Bytecode *code);
+        // Return 'true' if the program beginning at the specified 'code' can
+        // be compiled on this platform, and 'false' otherwise.  Note that,
+        // unlike 'compile', this function does not allocate memory.
+
+    static bool isSupported();
+        // Return 'true' if programs can be compiled on this platform, and
+        // 'false' otherwise.
+
+    // CREATORS
+    explicit JitCode(Allocator *basicAllocator = 0);
+        // Create an object holding no compiled program.  Optionally specify
+        // a 'basicAllocator' used to supply memory while compiling.  If
+        // 'basicAllocator' is 0, the currently installed default allocator is
+        // used.
+
+    ~JitCode();
+        // Destroy this object, releasing its native code.
+
+    // MANIPULATORS
+    int compile(const sjtt::Bytecode *code);
+        // Compile the program beginning at the specified 'code', replacing
+        // any program held by this object.  Return 0 on success, and a
+        // non-zero value, leaving this object holding no program, if the
+        // program cannot be compiled, as described above, or if this
+        // platform is not supported.
+
+    void reset();
+        // Release the program held by this object, if any.
+
+    // ACCESSORS
+    int execute(Datum *result, const Globals *globals) const;
+        // Run the compiled program with the specified 'globals', and load
+        // the returned double into the specified 'result'.  Return
+        // 'e_Success' on success, and 'e_GuardFailed', with no effect on
+        // 'result', if a global read by the program is not a double or does
+        // not exist.  The behavior is undefined unless 'isCompiled()'.
+
+    bool matches(const sjtt::Bytecode *code) const;
+        // Return 'true' if the program beginning at the specified 'code' is
+        // the program compiled by this object, and 'false' otherwise.  This
+        // function compares the instructions themselves, so that a program
+        // can be told from one that replaced it at the same address.
+
+    bool isCompiled() const;
+        // Return 'true' if this object holds a compiled program, and 'false'
+        // otherwise.
+
+    bsl::size_t codeSize() const;
+        // Return the number of bytes of native code of the compiled program,
+        // or 0 if there is none.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                               // -------------
+                               // class JitCode
+                               // -------------
+
+// ACCESSORS
+inline
+bool JitCode::isCompiled() const {
+    return 0 != d_code_p;
+}
+
+inline
+bsl::size_t JitCode::codeSize() const {
+    return d_codeSize;
+}
+}
+
+#endif
@@ -0,0 +1,295 @@
+// sjtu_jitcode.t.cpp                                       -*-C++-*-
+
+#include <sjtu_jitcode.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_globalvalue.h>
+#include <sjtu_datumutil.h>
+
+#include <bdls_testutil.h>
+#include <bslma_testallocator.h>
+
+#include <bsl_algorithm.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+typedef sjtt::Bytecode Bytecode;
+
+namespace {
+
+Bytecode push(double value)
+    // Return an 'e_Push' of the specified 'value'.
+{
+    return Bytecode::createPush(bdld::Datum::createDouble(value));
+}
+
+Bytecode get(int slot)
+    // Return an 'e_GetGlobalSlot' of the specified 'slot'.
+{
+    return Bytecode::create(Bytecode::e_GetGlobalSlot,
+                            bdld::Datum::createInteger(slot));
+}
+
+Bytecode op(Bytecode::Opcode opcode)
+    // Return a 'Bytecode' having the specified 'opcode'.
+{
+    return Bytecode::createOpcode(opcode);
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    const Bytecode ADD = op(Bytecode::e_AddDoubles);
+    const Bytecode POP = op(Bytecode::e_Pop);
+    const Bytecode RET = op(Bytecode::e_Return);
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "full register stack" << endl
+                          << "===================" << endl;
+
+        if (!JitCode::isSupported()) {
+            break;
+        }
+
+        // Fill every register, reading a global into the last one, so that
+        // all live values are spilled around the call, then add them up.
+
+        bslma::TestAllocator ta(veryVerbose);
+        JitCode::Globals globals(&ta);
+        globals.resize(1);
+        globals[0].clone(bdld::Datum::createDouble(1000));
+
+        bsl::vector<Bytecode> code;
+        for (int i = 0; i < JitCode::k_MAX_DEPTH - 1; ++i) {
+            code.push_back(push(i));
+        }
+        code.push_back(get(0));
+        for (int i = 0; i < JitCode::k_MAX_DEPTH - 1; ++i) {
+            code.push_back(ADD);
+        }
+        code.push_back(RET);
+
+        JitCode mX(&ta);
+        ASSERT(0 == mX.compile(code.data()));
+
+        bdld::Datum result;
+        ASSERT(0 == mX.execute(&result, &globals));
+        ASSERTV(result, bdld::Datum::createDouble(1000 + 91) == result);
+
+        // One more value does not fit.
+
+        code.insert(code.begin(), push(0));
+        code.insert(code.end() - 1, ADD);
+        ASSERT(0 != mX.compile(code.data()));
+        ASSERT(!mX.isCompiled());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "globals and guards" << endl
+                          << "==================" << endl;
+
+        if (!JitCode::isSupported()) {
+            break;
+        }
+
+        bslma::TestAllocator ta(veryVerbose);
+        JitCode::Globals globals(&ta);
+        globals.resize(2);
+        globals[0].clone(bdld::Datum::createDouble(10));
+        globals[1].clone(bdld::Datum::createDouble(20));
+
+        // 'x + 1 + y'
+
+        const Bytecode code[] = {
+            get(0),
+            Bytecode::create(Bytecode::e_PushAddDoubles,
+                             bdld::Datum::createDouble(1)),
+            get(1),
+            ADD,
+            RET
+        };
+
+        JitCode mX(&ta);
+        ASSERT(0 == mX.compile(code));
+
+        bdld::Datum result;
+        ASSERT(0 == mX.execute(&result, &globals));
+        ASSERTV(result, bdld::Datum::createDouble(31) == result);
+
+        globals[1].clone(bdld::Datum::createDouble(-1));
+        ASSERT(0 == mX.execute(&result, &globals));
+        ASSERTV(result, bdld::Datum::createDouble(10) == result);
+
+        const bdld::Datum UNCHANGED = result;
+        globals[1].clone(DatumUtil::s_Undefined);
+        ASSERT(JitCode::e_GuardFailed == mX.execute(&result, &globals));
+        ASSERT(UNCHANGED == result);
+
+        globals.resize(1);
+        ASSERT(JitCode::e_GuardFailed == mX.execute(&result, &globals));
+        ASSERT(JitCode::e_GuardFailed == mX.execute(&result, 0));
+        ASSERT(UNCHANGED == result);
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "unsupported programs" << endl
+                          << "====================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        JitCode mX(&ta);
+
+        const Bytecode STR = Bytecode::createPush(
+                                   bdld::Datum::createStringRef("s", 1, &ta));
+        const Bytecode FN  = Bytecode::createPush(DatumUtil::s_Undefined);
+        const Bytecode SET = Bytecode::create(
+                                            Bytecode::e_SetGlobalSlot,
+                                            bdld::Datum::createInteger(0));
+
+        const Bytecode EXE = op(Bytecode::e_Execute);
+
+        const struct {
+            int      d_line;
+            Bytecode d_code[4];
+        } DATA[] = {
+            { L_, { RET                          } },
+            { L_, { push(1), ADD, RET            } },
+            { L_, { POP, push(1), RET            } },
+            { L_, { STR, RET                     } },
+            { L_, { FN, EXE, RET                 } },
+            { L_, { push(1), EXE                 } },
+            { L_, { push(1), SET, push(1), RET   } },
+            { L_, { get(-1), RET                 } },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        for (int ti = 0; ti < NUM_DATA; ++ti) {
+            const int LINE = DATA[ti].d_line;
+            ASSERTV(LINE, !JitCode::canCompile(DATA[ti].d_code));
+            ASSERTV(LINE, 0 != mX.compile(DATA[ti].d_code));
+            ASSERTV(LINE, !mX.isCompiled());
+            ASSERTV(LINE, 0 == mX.codeSize());
+        }
+        bdld::Datum::destroy(STR.data(), &ta);
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        JitCode mX(&ta);
+        ASSERT(!mX.isCompiled());
+
+        // '(1.5 + 2) + (4 + 8)', dropping a value along the way
+
+        const Bytecode code[] = {
+            push(1.5), push(2), ADD, push(100), POP, push(4), push(8), ADD,
+            ADD, RET
+        };
+
+        ASSERT(JitCode::isSupported() == JitCode::canCompile(code));
+
+        const int rc = mX.compile(code);
+        if (!JitCode::isSupported()) {
+            ASSERT(0 != rc);
+            ASSERT(!mX.isCompiled());
+            break;
+        }
+        ASSERT(0 == rc);
+        ASSERT(mX.isCompiled());
+        ASSERT(0 < mX.codeSize());
+        if (verbose) { P(mX.codeSize()) }
+
+        bdld::Datum result;
+        ASSERT(0 == mX.execute(&result, 0));
+        ASSERTV(result, bdld::Datum::createDouble(15.5) == result);
+
+        // The compiled program is told from others by its instructions.
+
+        Bytecode other[sizeof code / sizeof *code];
+        bsl::copy(code, code + sizeof code / sizeof *code, other);
+        ASSERT(mX.matches(other));
+        other[5] = push(5);
+        ASSERT(!mX.matches(other));
+        other[5] = get(0);
+        ASSERT(!mX.matches(other));
+
+        mX.reset();
+        ASSERT(!mX.isCompiled());
+        ASSERT(0 == mX.codeSize());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
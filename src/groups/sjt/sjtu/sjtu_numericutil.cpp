@@ -0,0 +1,11 @@
+// sjtu_numericutil.cpp
+#include <sjtu_numericutil.h>
+
+namespace sjtu {
+
+                             // ------------------
+                             // struct NumericUtil
+                             // ------------------
+
+// All functions of 'NumericUtil' are defined inline.
+}
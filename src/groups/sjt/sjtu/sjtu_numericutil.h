@@ -0,0 +1,226 @@
+// sjtu_numericutil.h
+
+#ifndef INCLUDED_SJTU_NUMERICUTIL
+#define INCLUDED_SJTU_NUMERICUTIL
+
+#ifndef INCLUDED_SJTT_TYPEFEEDBACK
+#include <sjtt_typefeedback.h>
+#endif
+
+#ifndef INCLUDED_SJTU_VALUE
+#include <sjtu_value.h>
+#endif
+
+#ifndef INCLUDED_BSLS_PERFORMANCEHINT
+#include <bsls_performancehint.h>
+#endif
+
+#ifndef INCLUDED_BSLS_PLATFORM
+#include <bsls_platform.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+#if defined(BSLS_PLATFORM_CMP_GNU) || defined(BSLS_PLATFORM_CMP_CLANG)
+#define SJTU_NUMERICUTIL_OVERFLOW_BUILTINS 1
+#endif
+
+namespace sjtu {
+
+                             // ==================
+                             // struct NumericUtil
+                             // ==================
+
+struct NumericUtil {
+    // This 'struct' provides a namespace for the arithmetic of the integer
+    // opcodes, e.g., 'sjtt::Bytecode::e_AddIntegers', on 'Value' objects,
+    // shared by the interpreter and 'RegisterCode'.  An operation on two
+    // integers is performed on 'int' values, its overflow being detected
+    // with the builtins of the compiler where available, and its result is
+    // an integer unless it overflows, in which case the operation is
+    // performed again on doubles.  An operation on two numbers of which one
+    // is a double is performed on doubles.  Each function returns the
+    // 'sjtt::TypeFeedback::Kind' of the operation it performed, which the
+    // caller records in the type-feedback slot of its instruction, and
+    // which is 'e_Other', with no effect on the result, if an operand is not
+    // a number.
+
+    // TYPES
+    typedef sjtt::TypeFeedback::Kind         Kind;
+    typedef BloombergLP::bsls::Types::Int64  Int64;
+
+    // CLASS METHODS
+    static Kind add(Value *result, Value lhs, Value rhs);
+        // Load into the specified 'result' the sum of the specified 'lhs'
+        // and 'rhs', and return the kind of the addition.
+
+    static Kind subtract(Value *result, Value lhs, Value rhs);
+        // Load into the specified 'result' the difference of the specified
+        // 'lhs' and 'rhs', and return the kind of the subtraction.
+
+    static Kind multiply(Value *result, Value lhs, Value rhs);
+        // Load into the specified 'result' the product of the specified
+        // 'lhs' and 'rhs', and return the kind of the multiplication.
+
+    static Kind less(Value *result, Value lhs, Value rhs);
+        // Load into the specified 'result' 'true' if the specified 'lhs' is
+        // less than the specified 'rhs', and 'false' otherwise, and return
+        // the kind of the comparison, which is never 'e_Overflow'.
+
+    static bool toDouble(double *result, Value value);
+        // Load into the specified 'result' the specified 'value' as a double,
+        // and return 'true', if 'value' is a number, and return 'false' with
+        // no effect otherwise.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // ------------------
+                             // struct NumericUtil
+                             // ------------------
+
+// The integer fast path of each operation is written out, rather than
+// shared through a functor, so that it compiles to a tag check, the
+// operation, and a branch on its overflow flag.
+
+// CLASS METHODS
+inline
+NumericUtil::Kind NumericUtil::add(Value *result, Value lhs, Value rhs)
+{
+    if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(lhs.isInteger()
+                                         && rhs.isInteger())) {
+        const int x = lhs.theInteger();
+        const int y = rhs.theInteger();
+#ifdef SJTU_NUMERICUTIL_OVERFLOW_BUILTINS
+        int sum;
+        if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(
+                                       !__builtin_add_overflow(x, y, &sum))) {
+            *result = Value::createInteger(sum);
+            return sjtt::TypeFeedback::e_Integer;                     // RETURN
+        }
+#else
+        const Int64 sum = static_cast<Int64>(x) + y;
+        if (static_cast<int>(sum) == sum) {
+            *result = Value::createInteger(static_cast<int>(sum));
+            return sjtt::TypeFeedback::e_Integer;                     // RETURN
+        }
+#endif
+        *result = Value::createRawDouble(static_cast<double>(x) + y);
+        return sjtt::TypeFeedback::e_Overflow;                        // RETURN
+    }
+    double x;
+    double y;
+    if (!toDouble(&x, lhs) || !toDouble(&y, rhs)) {
+        return sjtt::TypeFeedback::e_Other;                           // RETURN
+    }
+    *result = Value::createDouble(x + y);
+    return sjtt::TypeFeedback::e_Double;
+}
+
+inline
+NumericUtil::Kind NumericUtil::subtract(Value *result, Value lhs, Value rhs)
+{
+    if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(lhs.isInteger()
+                                         && rhs.isInteger())) {
+        const int x = lhs.theInteger();
+        const int y = rhs.theInteger();
+#ifdef SJTU_NUMERICUTIL_OVERFLOW_BUILTINS
+        int difference;
+        if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(
+                                !__builtin_sub_overflow(x, y, &difference))) {
+            *result = Value::createInteger(difference);
+            return sjtt::TypeFeedback::e_Integer;                     // RETURN
+        }
+#else
+        const Int64 difference = static_cast<Int64>(x) - y;
+        if (static_cast<int>(difference) == difference) {
+            *result = Value::createInteger(static_cast<int>(difference));
+            return sjtt::TypeFeedback::e_Integer;                     // RETURN
+        }
+#endif
+        *result = Value::createRawDouble(static_cast<double>(x) - y);
+        return sjtt::TypeFeedback::e_Overflow;                        // RETURN
+    }
+    double x;
+    double y;
+    if (!toDouble(&x, lhs) || !toDouble(&y, rhs)) {
+        return sjtt::TypeFeedback::e_Other;                           // RETURN
+    }
+    *result = Value::createDouble(x - y);
+    return sjtt::TypeFeedback::e_Double;
+}
+
+inline
+NumericUtil::Kind NumericUtil::multiply(Value *result, Value lhs, Value rhs)
+{
+    if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(lhs.isInteger()
+                                         && rhs.isInteger())) {
+        const int x = lhs.theInteger();
+        const int y = rhs.theInteger();
+#ifdef SJTU_NUMERICUTIL_OVERFLOW_BUILTINS
+        int product;
+        if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(
+                                   !__builtin_mul_overflow(x, y, &product))) {
+            *result = Value::createInteger(product);
+            return sjtt::TypeFeedback::e_Integer;                     // RETURN
+        }
+#else
+        const Int64 product = static_cast<Int64>(x) * y;
+        if (static_cast<int>(product) == product) {
+            *result = Value::createInteger(static_cast<int>(product));
+            return sjtt::TypeFeedback::e_Integer;                     // RETURN
+        }
+#endif
+        // The product of two 'int' values may need up to 62 bits, more than
+        // the 53 of a double, and is then rounded, but only once, since the
+        // operands are exact as doubles.
+
+        *result = Value::createRawDouble(static_cast<double>(x) * y);
+        return sjtt::TypeFeedback::e_Overflow;                        // RETURN
+    }
+    double x;
+    double y;
+    if (!toDouble(&x, lhs) || !toDouble(&y, rhs)) {
+        return sjtt::TypeFeedback::e_Other;                           // RETURN
+    }
+    *result = Value::createDouble(x * y);
+    return sjtt::TypeFeedback::e_Double;
+}
+
+inline
+NumericUtil::Kind NumericUtil::less(Value *result, Value lhs, Value rhs)
+{
+    if (BSLS_PERFORMANCEHINT_PREDICT_LIKELY(lhs.isInteger()
+                                         && rhs.isInteger())) {
+        *result = Value::createBoolean(lhs.theInteger() < rhs.theInteger());
+        return sjtt::TypeFeedback::e_Integer;                         // RETURN
+    }
+    double x;
+    double y;
+    if (!toDouble(&x, lhs) || !toDouble(&y, rhs)) {
+        return sjtt::TypeFeedback::e_Other;                           // RETURN
+    }
+    *result = Value::createBoolean(x < y);
+    return sjtt::TypeFeedback::e_Double;
+}
+
+inline
+bool NumericUtil::toDouble(double *result, Value value)
+{
+    if (value.isDouble()) {
+        *result = value.theDouble();
+        return true;                                                  // RETURN
+    }
+    if (value.isInteger()) {
+        *result = value.theInteger();
+        return true;                                                  // RETURN
+    }
+    return false;
+}
+}
+
+#endif
@@ -0,0 +1,261 @@
+// sjtu_numericutil.t.cpp                                   -*-C++-*-
+
+#include <sjtu_numericutil.h>
+
+#include <sjtt_typefeedback.h>
+
+#include <bdls_testutil.h>
+
+#include <bsl_limits.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                    GLOBAL TYPEDEFS FOR TESTING
+// ----------------------------------------------------------------------------
+
+typedef sjtt::TypeFeedback Feedback;
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "less" << endl
+                          << "====" << endl;
+
+        const int MAX = numeric_limits<int>::max();
+        const int MIN = numeric_limits<int>::min();
+
+        Value result = Value::createNull();
+        ASSERT(Feedback::e_Integer == NumericUtil::less(
+                                                   &result,
+                                                   Value::createInteger(MIN),
+                                                   Value::createInteger(MAX)));
+        ASSERT(result.isBoolean());
+        ASSERT(true == result.theBoolean());
+
+        ASSERT(Feedback::e_Integer == NumericUtil::less(
+                                                   &result,
+                                                   Value::createInteger(2),
+                                                   Value::createInteger(2)));
+        ASSERT(false == result.theBoolean());
+
+        ASSERT(Feedback::e_Double == NumericUtil::less(
+                                                 &result,
+                                                 Value::createInteger(2),
+                                                 Value::createDouble(2.5)));
+        ASSERT(true == result.theBoolean());
+
+        ASSERT(Feedback::e_Double == NumericUtil::less(
+                                                 &result,
+                                                 Value::createDouble(3),
+                                                 Value::createInteger(2)));
+        ASSERT(false == result.theBoolean());
+
+        ASSERT(Feedback::e_Other == NumericUtil::less(
+                                                 &result,
+                                                 Value::createNull(),
+                                                 Value::createInteger(2)));
+        ASSERT(false == result.theBoolean());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "overflow" << endl
+                          << "========" << endl;
+
+        const int MAX = numeric_limits<int>::max();
+        const int MIN = numeric_limits<int>::min();
+
+        static const struct {
+            int    d_line;
+            char   d_op;         // '+', '-', or '*'
+            int    d_lhs;
+            int    d_rhs;
+            bool   d_isInteger;  // the result is expected to be an integer
+            double d_expected;
+        } DATA[] = {
+            //LINE  OP   LHS    RHS    INTEGER  EXPECTED
+            //----  ---  -----  -----  -------  ---------------
+            { L_,  '+',   MAX,     0,   true,  MAX             },
+            { L_,  '+',   MAX,     1,  false,  MAX + 1.0       },
+            { L_,  '+',   MIN,    -1,  false,  MIN - 1.0       },
+            { L_,  '+',   MAX,   MAX,  false,  2.0 * MAX       },
+            { L_,  '-',   MIN,     0,   true,  MIN             },
+            { L_,  '-',   MIN,     1,  false,  MIN - 1.0       },
+            { L_,  '-',     0,   MIN,  false,  -1.0 * MIN      },
+            { L_,  '-',    -1,   MIN,   true,  MAX             },
+            { L_,  '*', 65536, 32767,   true,  65536.0 * 32767 },
+            { L_,  '*', 65536, 32768,  false,  65536.0 * 32768 },
+            { L_,  '*',   MIN,    -1,  false,  -1.0 * MIN      },
+            { L_,  '*',   MIN,     1,   true,  MIN             },
+            { L_,  '*',   MAX,   MAX,  false,  1.0 * MAX * MAX },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        for (int ti = 0; ti < NUM_DATA; ++ti) {
+            const int   LINE = DATA[ti].d_line;
+            const Value LHS  = Value::createInteger(DATA[ti].d_lhs);
+            const Value RHS  = Value::createInteger(DATA[ti].d_rhs);
+
+            Value          result = Value::createNull();
+            Feedback::Kind kind;
+            switch (DATA[ti].d_op) {
+              case '+': kind = NumericUtil::add(&result, LHS, RHS); break;
+              case '-': kind = NumericUtil::subtract(&result, LHS, RHS); break;
+              default:  kind = NumericUtil::multiply(&result, LHS, RHS);
+            }
+
+            if (DATA[ti].d_isInteger) {
+                ASSERTV(LINE, Feedback::e_Integer == kind);
+                ASSERTV(LINE, result.isInteger());
+                ASSERTV(LINE, DATA[ti].d_expected == result.theInteger());
+            }
+            else {
+                ASSERTV(LINE, Feedback::e_Overflow == kind);
+                ASSERTV(LINE, result.isDouble());
+                ASSERTV(LINE, DATA[ti].d_expected == result.theDouble());
+            }
+        }
+
+        // A product needing more bits than a double has is rounded once, to
+        // the double nearest the exact product.
+
+        typedef NumericUtil::Int64 Int64;
+
+        const Int64 EXACT = static_cast<Int64>(MAX) * (MAX - 2);
+        Value       result = Value::createNull();
+        ASSERT(Feedback::e_Overflow == NumericUtil::multiply(
+                                               &result,
+                                               Value::createInteger(MAX),
+                                               Value::createInteger(MAX - 2)));
+        ASSERT(static_cast<Int64>(static_cast<double>(EXACT)) != EXACT);
+        ASSERTV(result.theDouble(),
+                static_cast<double>(EXACT) == result.theDouble());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        const Value TWO   = Value::createInteger(2);
+        const Value THREE = Value::createInteger(3);
+        const Value HALF  = Value::createDouble(0.5);
+
+        Value result = Value::createNull();
+        ASSERT(Feedback::e_Integer == NumericUtil::add(&result, TWO, THREE));
+        ASSERT(result.isInteger());
+        ASSERT(5 == result.theInteger());
+
+        ASSERT(Feedback::e_Integer == NumericUtil::subtract(&result,
+                                                            TWO,
+                                                            THREE));
+        ASSERT(-1 == result.theInteger());
+
+        ASSERT(Feedback::e_Integer == NumericUtil::multiply(&result,
+                                                            TWO,
+                                                            THREE));
+        ASSERT(6 == result.theInteger());
+
+        // A double operand makes the operation one on doubles.
+
+        ASSERT(Feedback::e_Double == NumericUtil::add(&result, TWO, HALF));
+        ASSERT(result.isDouble());
+        ASSERT(2.5 == result.theDouble());
+
+        ASSERT(Feedback::e_Double == NumericUtil::subtract(&result,
+                                                           HALF,
+                                                           THREE));
+        ASSERT(-2.5 == result.theDouble());
+
+        ASSERT(Feedback::e_Double == NumericUtil::multiply(&result,
+                                                           HALF,
+                                                           HALF));
+        ASSERT(0.25 == result.theDouble());
+
+        // An operand that is not a number leaves 'result' unchanged.
+
+        result = Value::createNull();
+        ASSERT(Feedback::e_Other == NumericUtil::add(&result,
+                                                     TWO,
+                                                     Value::createBoolean(1)));
+        ASSERT(Feedback::e_Other == NumericUtil::multiply(
+                                                    &result,
+                                                    Value::createUndefined(),
+                                                    THREE));
+        ASSERT(result.isNull());
+
+        double d = 0;
+        ASSERT( NumericUtil::toDouble(&d, THREE));
+        ASSERT(3 == d);
+        ASSERT( NumericUtil::toDouble(&d, HALF));
+        ASSERT(0.5 == d);
+        ASSERT(!NumericUtil::toDouble(&d, Value::createNull()));
+        ASSERT(0.5 == d);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,231 @@
+// sjtu_optimizeutil.cpp
+#include <sjtu_optimizeutil.h>
+
+#include <sjtu_passmanager.h>
+
+namespace sjtu {
+using BloombergLP::bdld::Datum;
+using sjtt::Bytecode;
+
+namespace {
+
+bool isPushDouble(const Bytecode& code)
+    // Return 'true' if the specified 'code' pushes a double, and 'false'
+    // otherwise.
+{
+    return Bytecode::e_Push == code.opcode() && code.data().isDouble();
+}
+
+bool findTarget(bsl::size_t     *target,
+                const Bytecode&  code,
+                bsl::size_t      index,
+                bsl::size_t      numCodes)
+    // Load into the specified 'target' the index of the instruction to which
+    // the specified 'code', at the specified 'index' of a program of the
+    // specified 'numCodes' instructions, branches or calls, and return
+    // 'true'; or return 'false' if 'code' is not a branch or call to an
+    // instruction of the program.
+{
+    const Bytecode::Opcode opcode = code.opcode();
+    if ((!Bytecode::isBranch(opcode) && !Bytecode::isCall(opcode))
+     || !code.data().isInteger()) {
+        return false;                                                 // RETURN
+    }
+    const bsl::ptrdiff_t offset = code.data().theInteger();
+    if (offset < 0 ? static_cast<bsl::size_t>(-offset) > index
+                   : static_cast<bsl::size_t>(offset) >= numCodes - index) {
+        return false;                                                 // RETURN
+    }
+    *target = index + offset;
+    return true;
+}
+
+class Compaction {
+    // This class records where the instructions of a program compacted in
+    // place are moved, so that the offsets of its branches and calls can be
+    // updated afterwards, and which instructions are targets of branches or
+    // calls, which must not be merged with the instructions before them.
+
+    // DATA
+    bsl::vector<char>        d_isTarget;   // by original index
+    bsl::vector<bsl::size_t> d_positions;  // position, by original index
+    bsl::vector<bsl::size_t> d_indices;    // original index, by position
+    bsl::size_t              d_fence;      // position of the last target
+
+  public:
+    // CREATORS
+    explicit Compaction(const bsl::vector<Bytecode>& code)
+    : d_isTarget(code.size(), 0)
+    , d_positions(code.size(), 0)
+    , d_indices(code.size(), 0)
+    , d_fence(0) {
+        for (bsl::size_t i = 0; i < code.size(); ++i) {
+            bsl::size_t target;
+            if (findTarget(&target, code[i], i, code.size())) {
+                d_isTarget[target] = 1;
+            }
+        }
+    }
+
+    // MANIPULATORS
+    void move(bsl::size_t index, bsl::size_t position) {
+        // Record that the instruction at the specified original 'index' is
+        // stored at the specified 'position', or, if it is removed, that
+        // the instruction stored next is.
+
+        d_positions[index]  = position;
+        d_indices[position] = index;
+        if (d_isTarget[index]) {
+            d_fence = position;
+        }
+    }
+
+    void update(bsl::vector<Bytecode> *code) const {
+        // Update the offsets of the branches and calls in the specified
+        // compacted 'code' to the positions to which their targets were
+        // moved.
+
+        bsl::vector<Bytecode>& c = *code;
+        for (bsl::size_t i = 0; i < c.size(); ++i) {
+            bsl::size_t target;
+            if (findTarget(&target, c[i], d_indices[i], d_positions.size())) {
+                const int offset = static_cast<int>(d_positions[target])
+                                 - static_cast<int>(i);
+                c[i] = Bytecode::create(c[i].opcode(),
+                                        Datum::createInteger(offset));
+            }
+        }
+    }
+
+    // ACCESSORS
+    bool canReplace(bsl::size_t position) const {
+        // Return 'true' if the instructions stored from the specified
+        // 'position' onwards may be replaced, i.e., no target of a branch or
+        // call is stored after it, and 'false' otherwise.
+
+        return d_fence <= position;
+    }
+
+    bool isTarget(bsl::size_t index) const {
+        // Return 'true' if the instruction at the specified original 'index'
+        // is the target of a branch or call, and 'false' otherwise.
+
+        return d_isTarget[index];
+    }
+};
+
+}  // close unnamed namespace
+
+                            // -------------------
+                            // struct OptimizeUtil
+                            // -------------------
+
+// CLASS METHODS
+bool OptimizeUtil::foldConstants(bsl::vector<Bytecode> *code) {
+    BSLS_ASSERT(0 != code);
+
+    // Instructions are compacted in place; 'out' is the number kept so far.
+    // Folding the tail of the output as each instruction is appended also
+    // folds chains such as '1 + 2 + 3' in a single pass.
+
+    bsl::vector<Bytecode>& c   = *code;
+    bsl::size_t            out = 0;
+    Compaction             compaction(c);
+    for (bsl::size_t i = 0; i < c.size(); ++i) {
+        compaction.move(i, out);
+        c[out++] = c[i];
+        for (;;) {
+            if (3 <= out
+             && compaction.canReplace(out - 3)
+             && Bytecode::e_AddDoubles == c[out - 1].opcode()
+             && isPushDouble(c[out - 2])
+             && isPushDouble(c[out - 3])) {
+                const double sum = c[out - 3].data().theDouble()
+                                 + c[out - 2].data().theDouble();
+                c[out - 3] = Bytecode::createPush(Datum::createDouble(sum));
+                out -= 2;
+            }
+            else if (2 <= out
+                  && compaction.canReplace(out - 2)
+                  && Bytecode::e_PushAddDoubles == c[out - 1].opcode()
+                  && c[out - 1].data().isDouble()
+                  && isPushDouble(c[out - 2])) {
+                const double sum = c[out - 2].data().theDouble()
+                                 + c[out - 1].data().theDouble();
+                c[out - 2] = Bytecode::createPush(Datum::createDouble(sum));
+                out -= 1;
+            }
+            else {
+                break;
+            }
+        }
+    }
+    const bool changed = out != c.size();
+    c.resize(out);
+    compaction.update(code);
+    return changed;
+}
+
+bool OptimizeUtil::eliminatePushPop(bsl::vector<Bytecode> *code) {
+    BSLS_ASSERT(0 != code);
+
+    // A removed 'e_Push' that is the target of a branch is replaced, as a
+    // target, by the instruction following the removed 'e_Pop'.
+
+    bsl::vector<Bytecode>& c   = *code;
+    bsl::size_t            out = 0;
+    Compaction             compaction(c);
+    for (bsl::size_t i = 0; i < c.size(); ++i) {
+        if (Bytecode::e_Pop == c[i].opcode()
+         && !compaction.isTarget(i)
+         && 0 < out
+         && compaction.canReplace(out - 1)
+         && Bytecode::e_Push == c[out - 1].opcode()) {
+            --out;
+            compaction.move(i, out);
+        }
+        else {
+            compaction.move(i, out);
+            c[out++] = c[i];
+        }
+    }
+    const bool changed = out != c.size();
+    c.resize(out);
+    compaction.update(code);
+    return changed;
+}
+
+bool OptimizeUtil::fuseSuperinstructions(bsl::vector<Bytecode> *code) {
+    BSLS_ASSERT(0 != code);
+
+    bsl::vector<Bytecode>& c   = *code;
+    bsl::size_t            out = 0;
+    Compaction             compaction(c);
+    for (bsl::size_t i = 0; i < c.size(); ++i) {
+        compaction.move(i, out);
+        if (i + 1 < c.size()
+         && !compaction.isTarget(i + 1)
+         && isPushDouble(c[i])
+         && Bytecode::e_AddDoubles == c[i + 1].opcode()) {
+            c[out++] = Bytecode::create(Bytecode::e_PushAddDoubles,
+                                        c[i].data());
+            ++i;
+        }
+        else {
+            c[out++] = c[i];
+        }
+    }
+    const bool changed = out != c.size();
+    c.resize(out);
+    compaction.update(code);
+    return changed;
+}
+
+void OptimizeUtil::addStandardPasses(PassManager *manager) {
+    BSLS_ASSERT(0 != manager);
+
+    manager->addPass(&eliminatePushPop);
+    manager->addPass(&foldConstants);
+    manager->addPass(&fuseSuperinstructions);
+}
+}
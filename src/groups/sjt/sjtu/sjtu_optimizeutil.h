@@ -0,0 +1,53 @@
+// sjtu_optimizeutil.h
+
+#ifndef INCLUDED_SJTU_OPTIMIZEUTIL
+#define INCLUDED_SJTU_OPTIMIZEUTIL
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+namespace sjtu {
+class PassManager;
+
+struct OptimizeUtil {
+    // This class provides a namespace for passes, suitable for use with
+    // 'PassManager', that reduce the number of instructions executed by a
+    // bytecode program without changing its result.  In particular, a
+    // program that fails with a type error before optimization fails in the
+    // same way after it: only operations on constant doubles are folded.
+    // The passes keep the branches and calls of a program valid: their offsets
+    // are updated as instructions are removed, and instructions are merged
+    // only if no branch or call targets any of them but the first.  A branch
+    // or call whose data is not an offset to an instruction of the program is
+    // left as is.
+
+    // CLASS METHODS
+    static bool foldConstants(bsl::vector<sjtt::Bytecode> *code);
+        // Replace each sequence in the specified 'code' that adds two constant
+        // doubles -- 'e_Push', 'e_Push', 'e_AddDoubles', or 'e_Push',
+        // 'e_PushAddDoubles' -- with an 'e_Push' of the sum.  Return 'true' if
+        // 'code' was changed, and 'false' otherwise.
+
+    static bool eliminatePushPop(bsl::vector<sjtt::Bytecode> *code);
+        // Remove each 'e_Push' in the specified 'code' that is immediately
+        // followed by an 'e_Pop', together with the 'e_Pop'.  Return 'true'
+        // if 'code' was changed, and 'false' otherwise.
+
+    static bool fuseSuperinstructions(bsl::vector<sjtt::Bytecode> *code);
+        // Replace each 'e_Push' of a double in the specified 'code' that is
+        // immediately followed by 'e_AddDoubles' with a single
+        // 'e_PushAddDoubles'.  Return 'true' if 'code' was changed, and
+        // 'false' otherwise.
+
+    static void addStandardPasses(PassManager *manager);
+        // Add the passes of this utility to the specified 'manager', in the
+        // order in which they are most effective.
+};
+}
+
+#endif
@@ -0,0 +1,425 @@
+// sjtu_optimizeutil.t.cpp                               -*-C++-*-
+
+#include <sjtu_optimizeutil.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_executioncontext.h>
+#include <sjtt_loopcounter.h>
+#include <sjtt_typefeedback.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_interpretutil.h>
+#include <sjtu_passmanager.h>
+#include <sjtu_verifyutil.h>
+
+#include <bdls_testutil.h>
+#include <bslma_testallocator.h>
+
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+typedef sjtt::Bytecode Bytecode;
+
+namespace {
+
+void half(sjtt::ExecutionContext *context)
+    // Replace the double on the top of the stack of the specified 'context'
+    // with half its value.
+{
+    bdld::Datum& top = context->stack()->back();
+    top = bdld::Datum::createDouble(top.theDouble() / 2);
+}
+
+Bytecode push(double value)
+    // Return an 'e_Push' of the specified 'value'.
+{
+    return Bytecode::createPush(bdld::Datum::createDouble(value));
+}
+
+Bytecode op(Bytecode::Opcode opcode)
+    // Return a 'Bytecode' having the specified 'opcode'.
+{
+    return Bytecode::createOpcode(opcode);
+}
+
+Bytecode branch(Bytecode::Opcode opcode, int offset)
+    // Return a branch having the specified 'opcode' and 'offset'.
+{
+    return Bytecode::create(opcode, bdld::Datum::createInteger(offset));
+}
+
+int run(bdld::Datum *result, const bsl::vector<Bytecode>& code)
+    // Interpret the specified 'code', loading its result into the specified
+    // 'result', and return the status of the interpretation.
+{
+    bslma::TestAllocator     ta;
+    bsl::vector<bdld::Datum> stack(&ta);
+    sjtt::ExecutionContext   context(&ta, &stack);
+    return InterpretUtil::interpret(result, &context, code.data());
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    const Bytecode ADD   = op(Bytecode::e_AddDoubles);
+    const Bytecode EXEC  = op(Bytecode::e_Execute);
+    const Bytecode POP   = op(Bytecode::e_Pop);
+    const Bytecode RET   = op(Bytecode::e_Return);
+    const Bytecode HALF  = Bytecode::createPush(
+                                     DatumUtil::createExternalFunction(&half));
+    const Bytecode INT   = Bytecode::createPush(
+                                            bdld::Datum::createInteger(1));
+
+    switch (test) { case 0:
+      case 5: {
+        if (verbose) cout << endl
+                          << "branches" << endl
+                          << "========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        PassManager          manager(&ta);
+        OptimizeUtil::addStandardPasses(&manager);
+
+        const Bytecode TRUE  = Bytecode::createPush(
+                                             bdld::Datum::createBoolean(true));
+        const Bytecode FALSE = Bytecode::createPush(
+                                            bdld::Datum::createBoolean(false));
+
+        if (verbose) cout << "\tOffsets follow the instructions." << endl;
+        {
+            const struct {
+                int         d_line;
+                Bytecode    d_code[10];
+                bsl::size_t d_numCodes;
+                bsl::size_t d_numOptimized;
+            } DATA[] = {
+                { L_, { FALSE, branch(Bytecode::e_JumpIfFalse, 5),
+                        push(1), push(2), ADD,
+                        branch(Bytecode::e_Jump, 4),
+                        push(3), push(4), ADD, RET },           10, 6 },
+                { L_, { TRUE, branch(Bytecode::e_JumpIfFalse, 5),
+                        push(1), push(2), ADD,
+                        branch(Bytecode::e_Jump, 4),
+                        push(3), push(4), ADD, RET },           10, 6 },
+
+                // The constants on either side of the target are not
+                // folded together.
+
+                { L_, { push(1), FALSE, branch(Bytecode::e_JumpIfFalse, 3),
+                        push(2), ADD, push(3), ADD, RET },       8, 6 },
+                { L_, { push(1), TRUE, branch(Bytecode::e_JumpIfFalse, 3),
+                        push(2), ADD, push(3), ADD, RET },       8, 6 },
+                { L_, { push(1), FALSE, branch(Bytecode::e_JumpIfFalse, 3),
+                        push(2), POP, push(3), ADD, RET },       8, 5 },
+            };
+            const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+            for (int ti = 0; ti < NUM_DATA; ++ti) {
+                const int LINE = DATA[ti].d_line;
+                const bsl::vector<Bytecode> original(
+                                       DATA[ti].d_code,
+                                       DATA[ti].d_code + DATA[ti].d_numCodes,
+                                       &ta);
+                bsl::vector<Bytecode> optimized(original, &ta);
+                manager.run(&optimized);
+                ASSERTV(LINE, optimized.size(),
+                        DATA[ti].d_numOptimized == optimized.size());
+
+                bsl::size_t maxDepth   = 0;
+                bsl::size_t errorIndex = 0;
+                ASSERTV(LINE, 0 == VerifyUtil::verify(&maxDepth,
+                                                      &errorIndex,
+                                                      optimized.data(),
+                                                      optimized.size()));
+
+                bdld::Datum expected = bdld::Datum::createNull();
+                bdld::Datum actual   = bdld::Datum::createNull();
+                const int   rcE      = run(&expected, original);
+                const int   rcA      = run(&actual, optimized);
+                ASSERTV(LINE, rcE, rcA, rcE == rcA);
+                ASSERTV(LINE, expected, actual, expected == actual);
+            }
+        }
+
+        if (verbose) cout << "\tTargets are not merged." << endl;
+        {
+            const Bytecode CODE[] = { push(1), branch(Bytecode::e_Jump, 2),
+                                      push(2), ADD, RET };
+            bsl::vector<Bytecode> code(CODE, CODE + 5, &ta);
+            ASSERT(!OptimizeUtil::fuseSuperinstructions(&code));
+            ASSERT(!OptimizeUtil::foldConstants(&code));
+
+            code[3] = POP;
+            ASSERT(!OptimizeUtil::eliminatePushPop(&code));
+        }
+
+        if (verbose) cout << "\tLoops." << endl;
+        {
+            // 'i = 0; while (i < 3) { 9; i = i + 1; } return i;'
+
+            sjtt::LoopCounter  counter;
+            sjtt::TypeFeedback feedback;
+            const Bytecode     GET = Bytecode::create(
+                                               Bytecode::e_GetGlobalSlot,
+                                               bdld::Datum::createInteger(0));
+            const Bytecode     SET = Bytecode::create(
+                                               Bytecode::e_SetGlobalSlot,
+                                               bdld::Datum::createInteger(0));
+            const Bytecode     FB  = Bytecode::create(
+                                    Bytecode::e_LessIntegers,
+                                    DatumUtil::createTypeFeedback(&feedback));
+            const Bytecode CODE[] = {
+                Bytecode::create(Bytecode::e_LoopHeader,
+                                 DatumUtil::createLoopCounter(&counter)),
+                GET,
+                Bytecode::createPush(bdld::Datum::createInteger(3)),
+                FB,
+                branch(Bytecode::e_JumpIfFalse, 8),
+                push(9),
+                POP,
+                GET,
+                INT,
+                Bytecode::create(Bytecode::e_AddIntegers, FB.data()),
+                SET,
+                branch(Bytecode::e_Loop, -11),
+                GET,
+                RET
+            };
+            bsl::vector<Bytecode> code(CODE, CODE + 14, &ta);
+            ASSERT(OptimizeUtil::eliminatePushPop(&code));
+            ASSERT(12 == code.size());
+            ASSERT(bdld::Datum::createInteger(6)  == code[4].data());
+            ASSERT(bdld::Datum::createInteger(-9) == code[9].data());
+
+            bsl::size_t maxDepth   = 0;
+            bsl::size_t errorIndex = 0;
+            ASSERT(0 == VerifyUtil::verify(&maxDepth,
+                                           &errorIndex,
+                                           code.data(),
+                                           code.size()));
+
+            bsl::vector<bdld::Datum>        stack(&ta);
+            sjtt::ExecutionContext          context(&ta, &stack);
+            sjtt::ExecutionContext::Globals globals(&ta);
+            globals.resize(1);
+            globals[0].clone(bdld::Datum::createInteger(0));
+            context.setGlobals(&globals);
+
+            bdld::Datum result;
+            ASSERT(0 == InterpretUtil::interpret(&result,
+                                                 &context,
+                                                 code.data()));
+            ASSERTV(result, bdld::Datum::createInteger(3) == result);
+            ASSERT(3 == counter.count());
+        }
+
+        if (verbose) cout << "\tCalls." << endl;
+        {
+            const Bytecode CODE[] = {
+                push(1),
+                branch(Bytecode::e_Call, 4),
+                push(9),
+                POP,
+                RET,
+                Bytecode::create(Bytecode::e_Function,
+                                 bdld::Datum::createInteger(1)),
+                Bytecode::create(Bytecode::e_GetLocal,
+                                 bdld::Datum::createInteger(-1)),
+                RET
+            };
+            bsl::vector<Bytecode> code(CODE, CODE + 8, &ta);
+            ASSERT(OptimizeUtil::eliminatePushPop(&code));
+            ASSERT(6 == code.size());
+            ASSERT(bdld::Datum::createInteger(2) == code[1].data());
+
+            bsl::vector<bdld::Datum> stack(&ta);
+            sjtt::ExecutionContext   context(&ta, &stack);
+            bdld::Datum              result;
+            ASSERT(0 == InterpretUtil::interpret(&result,
+                                                 &context,
+                                                 code.data()));
+            ASSERTV(result, bdld::Datum::createDouble(1) == result);
+        }
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "standard passes" << endl
+                          << "===============" << endl;
+
+        // Optimized programs must produce the same result, or fail with the
+        // same status, as the originals.
+
+        const struct {
+            int         d_line;
+            Bytecode    d_code[10];
+            bsl::size_t d_numCodes;
+            bsl::size_t d_numOptimized;
+        } DATA[] = {
+            { L_, { push(1), RET },                                  2, 2 },
+            { L_, { push(1), push(2), ADD, RET },                    4, 2 },
+            { L_, { push(1), push(2), ADD, push(3), ADD, RET },      6, 2 },
+            { L_, { push(1), push(2), push(3), ADD, ADD, RET },      6, 2 },
+            { L_, { push(9), push(1), POP, push(2), ADD, RET },      6, 2 },
+            { L_, { push(8), HALF, EXEC, push(1), ADD, RET },        6, 5 },
+            { L_, { push(8), HALF, EXEC, push(1), push(2), ADD, ADD, RET },
+                                                                     8, 5 },
+            { L_, { push(8), HALF, EXEC, push(1), ADD, push(2), ADD, RET },
+                                                                     8, 6 },
+            { L_, { push(1), INT, ADD, RET },                        4, 4 },
+            { L_, { INT, push(1), ADD, RET },                        4, 3 },
+            { L_, { push(1), push(2), ADD, POP, push(5), RET },      6, 2 },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        bslma::TestAllocator ta(veryVerbose);
+        PassManager          manager(&ta);
+        OptimizeUtil::addStandardPasses(&manager);
+
+        for (int ti = 0; ti < NUM_DATA; ++ti) {
+            const int LINE = DATA[ti].d_line;
+            const bsl::vector<Bytecode> original(
+                                       DATA[ti].d_code,
+                                       DATA[ti].d_code + DATA[ti].d_numCodes,
+                                       &ta);
+            bsl::vector<Bytecode> optimized(original, &ta);
+            manager.run(&optimized);
+            ASSERTV(LINE, optimized.size(),
+                    DATA[ti].d_numOptimized == optimized.size());
+
+            bdld::Datum expected = bdld::Datum::createNull();
+            bdld::Datum actual   = bdld::Datum::createNull();
+            const int   rcE      = run(&expected, original);
+            const int   rcA      = run(&actual, optimized);
+            ASSERTV(LINE, rcE, rcA, rcE == rcA);
+            ASSERTV(LINE, expected, actual, expected == actual);
+        }
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "fuseSuperinstructions" << endl
+                          << "=====================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        const Bytecode CODE[] = { push(8), HALF, EXEC, push(1), ADD,
+                                  INT, ADD, RET };
+        bsl::vector<Bytecode> code(CODE, CODE + 8, &ta);
+        ASSERT(OptimizeUtil::fuseSuperinstructions(&code));
+        ASSERT(7 == code.size());
+        ASSERT(Bytecode::e_PushAddDoubles == code[3].opcode());
+        ASSERT(bdld::Datum::createDouble(1) == code[3].data());
+        ASSERT(Bytecode::e_Push == code[4].opcode());
+        ASSERT(!OptimizeUtil::fuseSuperinstructions(&code));
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "eliminatePushPop" << endl
+                          << "================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        const Bytecode CODE[] = { push(1), push(2), push(3), POP, POP,
+                                  HALF, EXEC, POP, RET };
+        bsl::vector<Bytecode> code(CODE, CODE + 9, &ta);
+        ASSERT(OptimizeUtil::eliminatePushPop(&code));
+        ASSERT(5 == code.size());
+        ASSERT(push(1).data() == code[0].data());
+        ASSERT(Bytecode::e_Pop == code[3].opcode());
+        ASSERT(!OptimizeUtil::eliminatePushPop(&code));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "foldConstants" << endl
+                          << "=============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        const Bytecode CODE[] = {
+            push(1),
+            push(2),
+            push(4),
+            ADD,
+            ADD,
+            push(8),
+            Bytecode::create(Bytecode::e_PushAddDoubles,
+                             bdld::Datum::createDouble(16)),
+            ADD,
+            RET
+        };
+        bsl::vector<Bytecode> code(CODE, CODE + 9, &ta);
+        ASSERT(OptimizeUtil::foldConstants(&code));
+        ASSERT(2 == code.size());
+        ASSERT(Bytecode::e_Push == code[0].opcode());
+        ASSERT(bdld::Datum::createDouble(31) == code[0].data());
+        ASSERT(Bytecode::e_Return == code[1].opcode());
+        ASSERT(!OptimizeUtil::foldConstants(&code));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
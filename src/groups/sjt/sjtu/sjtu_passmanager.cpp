@@ -0,0 +1,29 @@
+// sjtu_passmanager.cpp
+#include <sjtu_passmanager.h>
+
+namespace sjtu {
+
+                             // -----------------
+                             // class PassManager
+                             // -----------------
+
+// ACCESSORS
+bool PassManager::run(bsl::vector<sjtt::Bytecode> *program) const {
+    BSLS_ASSERT(0 != program);
+
+    bool changed = false;
+    for (int round = 0; round < d_maxRounds; ++round) {
+        bool roundChanged = false;
+        for (bsl::size_t i = 0; i < d_passes.size(); ++i) {
+            if (d_passes[i](program)) {
+                roundChanged = true;
+            }
+        }
+        if (!roundChanged) {
+            break;
+        }
+        changed = true;
+    }
+    return changed;
+}
+}
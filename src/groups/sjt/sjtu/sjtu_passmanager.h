@@ -0,0 +1,136 @@
+// sjtu_passmanager.h
+
+#ifndef INCLUDED_SJTU_PASSMANAGER
+#define INCLUDED_SJTU_PASSMANAGER
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+#ifndef INCLUDED_BSL_FUNCTIONAL
+#include <bsl_functional.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtu {
+
+                             // =================
+                             // class PassManager
+                             // =================
+
+class PassManager {
+    // This class provides a mechanism for running an ordered sequence of
+    // transformations ("passes") over a bytecode program before it is
+    // executed.  A pass rewrites the program in place, preserving its
+    // observable behavior, and returns 'true' if it changed the program.
+    // Because one pass can expose opportunities for another, 'run' repeats
+    // the whole sequence until no pass reports a change, up to a configurable
+    // number of rounds.
+
+  public:
+    // TYPES
+    typedef bsl::function<bool(bsl::vector<sjtt::Bytecode> *)> Pass;
+        // Signature of a transformation of a program.
+
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    enum {
+        k_DEFAULT_MAX_ROUNDS = 8  // default bound on repetitions of 'run'
+    };
+
+  private:
+    // DATA
+    bsl::vector<Pass> d_passes;     // passes, in the order they are run
+    int               d_maxRounds;  // maximum repetitions of the sequence
+
+    // NOT IMPLEMENTED
+    PassManager(const PassManager&);
+    PassManager& operator=(const PassManager&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(PassManager,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CREATORS
+    explicit PassManager(Allocator *basicAllocator = 0);
+        // Create a pass manager having no passes.  Optionally specify a
+        // 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.
+
+    // MANIPULATORS
+    void addPass(const Pass& pass);
+        // Append the specified 'pass' to the sequence run by this object.
+
+    void setMaxRounds(int maxRounds);
+        // Set the maximum number of times 'run' repeats the sequence of
+        // passes to the specified 'maxRounds'.  The behavior is undefined
+        // unless '0 < maxRounds'.
+
+    // ACCESSORS
+    int maxRounds() const;
+        // Return the maximum number of times 'run' repeats the sequence of
+        // passes.
+
+    bsl::size_t numPasses() const;
+        // Return the number of passes run by this object.
+
+    bool run(bsl::vector<sjtt::Bytecode> *program) const;
+        // Apply each pass, in order, to the specified 'program', repeating
+        // the sequence until a round makes no change or 'maxRounds()' rounds
+        // have been run.  Return 'true' if any pass changed 'program', and
+        // 'false' otherwise.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // -----------------
+                             // class PassManager
+                             // -----------------
+
+// CREATORS
+inline
+PassManager::PassManager(Allocator *basicAllocator)
+: d_passes(basicAllocator)
+, d_maxRounds(k_DEFAULT_MAX_ROUNDS) {
+}
+
+// MANIPULATORS
+inline
+void PassManager::addPass(const Pass& pass) {
+    BSLS_ASSERT(pass);
+    d_passes.push_back(pass);
+}
+
+inline
+void PassManager::setMaxRounds(int maxRounds) {
+    BSLS_ASSERT(0 < maxRounds);
+    d_maxRounds = maxRounds;
+}
+
+// ACCESSORS
+inline
+int PassManager::maxRounds() const {
+    return d_maxRounds;
+}
+
+inline
+bsl::size_t PassManager::numPasses() const {
+    return d_passes.size();
+}
+}
+
+#endif
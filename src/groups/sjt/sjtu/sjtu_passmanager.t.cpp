@@ -0,0 +1,168 @@
+// sjtu_passmanager.t.cpp                                -*-C++-*-
+
+#include <sjtu_passmanager.h>
+
+#include <sjtt_bytecode.h>
+
+#include <bdls_testutil.h>
+#include <bslma_testallocator.h>
+
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+typedef sjtt::Bytecode Bytecode;
+
+namespace {
+
+bool dropFirst(bsl::vector<Bytecode> *code)
+    // Remove the first instruction of the specified 'code', if any.  Return
+    // 'true' if 'code' was changed, and 'false' otherwise.
+{
+    if (code->empty()) {
+        return false;                                                 // RETURN
+    }
+    code->erase(code->begin());
+    return true;
+}
+
+struct CountingPass {
+    // This 'struct' provides a pass that records how often it is run.
+
+    int *d_count_p;
+
+    bool operator()(bsl::vector<Bytecode> *) const {
+        ++*d_count_p;
+        return false;
+    }
+};
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "rounds" << endl
+                          << "======" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        PassManager manager(&ta);
+        ASSERT(PassManager::k_DEFAULT_MAX_ROUNDS == manager.maxRounds());
+
+        int              count = 0;
+        const CountingPass counter = { &count };
+        manager.addPass(&dropFirst);
+        manager.addPass(counter);
+        ASSERT(2 == manager.numPasses());
+
+        // Rounds repeat until nothing changes...
+
+        bsl::vector<Bytecode> code(3,
+                                   Bytecode::createOpcode(Bytecode::e_Return),
+                                   &ta);
+        ASSERT(manager.run(&code));
+        ASSERT(code.empty());
+        ASSERT(4 == count);
+
+        // ...or the maximum number of rounds is reached.
+
+        manager.setMaxRounds(2);
+        code.resize(5, Bytecode::createOpcode(Bytecode::e_Return));
+        count = 0;
+        ASSERT(manager.run(&code));
+        ASSERT(3 == code.size());
+        ASSERT(2 == count);
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        PassManager manager(&ta);
+        ASSERT(0 == manager.numPasses());
+
+        bsl::vector<Bytecode> code(&ta);
+        code.push_back(Bytecode::createOpcode(Bytecode::e_Return));
+        ASSERT(!manager.run(&code));
+        ASSERT(1 == code.size());
+
+        int                count = 0;
+        const CountingPass counter = { &count };
+        manager.addPass(counter);
+        ASSERT(!manager.run(&code));
+        ASSERT(1 == count);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,261 @@
+// sjtu_profile.cpp
+#include <sjtu_profile.h>
+
+#include <bsl_cstdio.h>
+#include <bsl_cstring.h>
+#include <bsl_iomanip.h>
+#include <bsl_sstream.h>
+
+namespace sjtu {
+using sjtt::Bytecode;
+
+namespace {
+
+bsl::string addressName(const void *address)
+    // Return the name of the specified 'address' in a report.
+{
+    bsl::ostringstream stream;
+    stream << address;
+    return stream.str();
+}
+
+const void *functionAddress(Profile::ExternalFunction function)
+    // Return the address of the specified external 'function' as a data
+    // pointer, for reporting only.
+{
+    return reinterpret_cast<const void *>(function);
+}
+
+void printJsonString(bsl::ostream& stream, const bsl::string& value)
+    // Write the specified 'value' to the specified 'stream' as a JSON
+    // string.
+{
+    stream << '"';
+    for (bsl::size_t i = 0; i < value.size(); ++i) {
+        const unsigned char c = value[i];
+        if ('"' == c || '\\' == c) {
+            stream << '\\' << c;
+        }
+        else if (c < 0x20) {
+            char escape[8];
+            bsl::snprintf(escape, sizeof escape, "\\u%04x", c);
+            stream << escape;
+        }
+        else {
+            stream << c;
+        }
+    }
+    stream << '"';
+}
+
+double average(Profile::Uint64 total, Profile::Uint64 count)
+    // Return the specified 'total' divided by the specified 'count', or 0 if
+    // 'count' is 0.
+{
+    return count ? static_cast<double>(total) / count : 0;
+}
+
+}  // close unnamed namespace
+
+                               // -------------
+                               // class Profile
+                               // -------------
+
+// CREATORS
+Profile::Profile(Allocator *basicAllocator)
+: d_calls(basicAllocator)
+, d_numInvocations(basicAllocator)
+, d_functionNames(basicAllocator)
+, d_programNames(basicAllocator)
+{
+    bsl::memset(d_numExecutions, 0, sizeof d_numExecutions);
+    bsl::memset(d_numCycles, 0, sizeof d_numCycles);
+}
+
+// MANIPULATORS
+void Profile::recordCall(ExternalFunction function, Uint64 cycles)
+{
+    bsl::map<ExternalFunction, CallStats>::iterator it =
+                                                       d_calls.find(function);
+    if (d_calls.end() == it) {
+        CallStats stats;
+        bsl::memset(&stats, 0, sizeof stats);
+        it = d_calls.insert(bsl::make_pair(function, stats)).first;
+    }
+    CallStats& stats = it->second;
+    ++stats.d_numCalls;
+    stats.d_numCycles += cycles;
+    ++stats.d_histogram[bucket(cycles)];
+}
+
+void Profile::nameFunction(ExternalFunction                      function,
+                           const BloombergLP::bslstl::StringRef& name)
+{
+    d_functionNames[function].assign(name.data(), name.length());
+}
+
+void Profile::nameProgram(const void                            *program,
+                          const BloombergLP::bslstl::StringRef&  name)
+{
+    d_programNames[program].assign(name.data(), name.length());
+}
+
+void Profile::reset()
+{
+    bsl::memset(d_numExecutions, 0, sizeof d_numExecutions);
+    bsl::memset(d_numCycles, 0, sizeof d_numCycles);
+    d_calls.clear();
+    d_numInvocations.clear();
+}
+
+// ACCESSORS
+const Profile::CallStats *Profile::callStats(ExternalFunction function) const
+{
+    const bsl::map<ExternalFunction, CallStats>::const_iterator it =
+                                                       d_calls.find(function);
+    return d_calls.end() == it ? 0 : &it->second;
+}
+
+Profile::Uint64 Profile::numInvocations(const void *program) const
+{
+    const bsl::map<const void *, Uint64>::const_iterator it =
+                                              d_numInvocations.find(program);
+    return d_numInvocations.end() == it ? 0 : it->second;
+}
+
+bsl::ostream& Profile::print(bsl::ostream& stream) const
+{
+    const bsl::ios::fmtflags flags     = stream.flags();
+    const bsl::streamsize    precision = stream.precision();
+
+    stream << bsl::left << bsl::setw(24) << "opcode"
+           << bsl::right << bsl::setw(14) << "executions"
+           << bsl::setw(16) << "cycles"
+           << bsl::setw(14) << "cycles/exec" << '\n';
+    for (int i = 0; i < k_NUM_OPCODES; ++i) {
+        if (0 == d_numExecutions[i]) {
+            continue;                                               // CONTINUE
+        }
+        stream << bsl::left << bsl::setw(24)
+               << Bytecode::toAscii(static_cast<Bytecode::Opcode>(i))
+               << bsl::right << bsl::setw(14) << d_numExecutions[i]
+               << bsl::setw(16) << d_numCycles[i]
+               << bsl::setw(14) << bsl::fixed << bsl::setprecision(1)
+               << average(d_numCycles[i], d_numExecutions[i]) << '\n';
+    }
+
+    stream << '\n'
+           << bsl::left << bsl::setw(24) << "function"
+           << bsl::right << bsl::setw(14) << "calls"
+           << bsl::setw(16) << "cycles"
+           << bsl::setw(14) << "cycles/call" << '\n';
+    for (bsl::map<ExternalFunction, CallStats>::const_iterator it =
+                                                              d_calls.begin();
+         it != d_calls.end();
+         ++it) {
+        const bsl::map<ExternalFunction, bsl::string>::const_iterator name =
+                                            d_functionNames.find(it->first);
+        const CallStats& stats = it->second;
+        stream << bsl::left << bsl::setw(24)
+               << (d_functionNames.end() == name
+                   ? addressName(functionAddress(it->first))
+                   : name->second)
+               << bsl::right << bsl::setw(14) << stats.d_numCalls
+               << bsl::setw(16) << stats.d_numCycles
+               << bsl::setw(14) << bsl::fixed << bsl::setprecision(1)
+               << average(stats.d_numCycles, stats.d_numCalls) << '\n';
+        for (int i = 0; i < k_NUM_BUCKETS; ++i) {
+            if (0 == stats.d_histogram[i]) {
+                continue;                                           // CONTINUE
+            }
+            if (k_NUM_BUCKETS - 1 == i) {
+                stream << "    >= 2^" << bsl::left << bsl::setw(15) << i;
+            }
+            else {
+                stream << "    < 2^" << bsl::left << bsl::setw(16) << i + 1;
+            }
+            stream << bsl::right << bsl::setw(14) << stats.d_histogram[i]
+                   << '\n';
+        }
+    }
+
+    stream << '\n'
+           << bsl::left << bsl::setw(24) << "program"
+           << bsl::right << bsl::setw(14) << "invocations" << '\n';
+    for (bsl::map<const void *, Uint64>::const_iterator it =
+                                                     d_numInvocations.begin();
+         it != d_numInvocations.end();
+         ++it) {
+        const bsl::map<const void *, bsl::string>::const_iterator name =
+                                             d_programNames.find(it->first);
+        stream << bsl::left << bsl::setw(24)
+               << (d_programNames.end() == name ? addressName(it->first)
+                                                 : name->second)
+               << bsl::right << bsl::setw(14) << it->second << '\n';
+    }
+    stream.flags(flags);
+    stream.precision(precision);
+    return stream;
+}
+
+bsl::ostream& Profile::printJson(bsl::ostream& stream) const
+{
+    stream << "{\"opcodes\":[";
+    const char *separator = "";
+    for (int i = 0; i < k_NUM_OPCODES; ++i) {
+        if (0 == d_numExecutions[i]) {
+            continue;                                               // CONTINUE
+        }
+        stream << separator << "{\"opcode\":\""
+               << Bytecode::toAscii(static_cast<Bytecode::Opcode>(i))
+               << "\",\"executions\":" << d_numExecutions[i]
+               << ",\"cycles\":" << d_numCycles[i] << '}';
+        separator = ",";
+    }
+
+    stream << "],\"functions\":[";
+    separator = "";
+    for (bsl::map<ExternalFunction, CallStats>::const_iterator it =
+                                                              d_calls.begin();
+         it != d_calls.end();
+         ++it) {
+        const bsl::map<ExternalFunction, bsl::string>::const_iterator name =
+                                            d_functionNames.find(it->first);
+        const bsl::string address = addressName(functionAddress(it->first));
+        const CallStats&  stats   = it->second;
+        stream << separator << "{\"name\":";
+        printJsonString(stream,
+                        d_functionNames.end() == name ? address
+                                                      : name->second);
+        stream << ",\"address\":\"" << address
+               << "\",\"calls\":" << stats.d_numCalls
+               << ",\"cycles\":" << stats.d_numCycles
+               << ",\"histogram\":[";
+        for (int i = 0; i < k_NUM_BUCKETS; ++i) {
+            stream << (i ? "," : "") << stats.d_histogram[i];
+        }
+        stream << "]}";
+        separator = ",";
+    }
+
+    stream << "],\"programs\":[";
+    separator = "";
+    for (bsl::map<const void *, Uint64>::const_iterator it =
+                                                     d_numInvocations.begin();
+         it != d_numInvocations.end();
+         ++it) {
+        const bsl::map<const void *, bsl::string>::const_iterator name =
+                                             d_programNames.find(it->first);
+        const bsl::string address = addressName(it->first);
+        stream << separator << "{\"name\":";
+        printJsonString(stream,
+                        d_programNames.end() == name ? address
+                                                     : name->second);
+        stream << ",\"address\":\"" << address
+               << "\",\"invocations\":" << it->second << '}';
+        separator = ",";
+    }
+    stream << "]}";
+    return stream;
+}
+}
@@ -0,0 +1,252 @@
+// sjtu_profile.h
+
+#ifndef INCLUDED_SJTU_PROFILE
+#define INCLUDED_SJTU_PROFILE
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+#ifndef INCLUDED_SJTU_DATUMUTIL
+#include <sjtu_datumutil.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLS_PLATFORM
+#include <bsls_platform.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TIMEUTIL
+#include <bsls_timeutil.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+#ifndef INCLUDED_BSL_MAP
+#include <bsl_map.h>
+#endif
+
+#ifndef INCLUDED_BSL_OSTREAM
+#include <bsl_ostream.h>
+#endif
+
+#ifndef INCLUDED_BSL_STRING
+#include <bsl_string.h>
+#endif
+
+#if defined(BSLS_PLATFORM_CPU_X86_64)                                         \
+ && (defined(BSLS_PLATFORM_CMP_GNU) || defined(BSLS_PLATFORM_CMP_CLANG))
+#define SJTU_PROFILE_RDTSC 1
+#include <x86intrin.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtu {
+
+                               // =============
+                               // class Profile
+                               // =============
+
+class Profile {
+    // This class provides a mechanism accumulating where the time of
+    // interpreted programs goes: for each opcode, the number of times it was
+    // executed and the cycles spent in its handler; for each external
+    // function, the number of calls, the cycles spent in them, and a
+    // histogram of their latencies; and for each program, the number of
+    // times it was invoked.  A profile is filled by
+    // 'InterpretUtil::interpretProfiled', and the report can be written as
+    // text ('print') or as JSON ('printJson').
+    //
+    // Cycles are read with 'readCycles', i.e., the time-stamp counter where
+    // it is available, so they are comparable with each other but not
+    // necessarily with wall-clock time.  The cycles of 'e_Execute' exclude
+    // the time spent in the external function it calls, which is counted
+    // for that function instead.  External functions and programs are
+    // identified by address, and may be given names for the report.
+    //
+    // A profile is not thread-safe; programs interpreted concurrently must
+    // use different profiles.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bsls::Types::Uint64 Uint64;
+    typedef BloombergLP::bslma::Allocator    Allocator;
+    typedef DatumUtil::ExternalFunction      ExternalFunction;
+
+    enum {
+        k_NUM_BUCKETS = 32
+            // buckets in a latency histogram; bucket 'i' counts the calls
+            // taking less than '2^(i + 1)' and, unless 'i' is 0, at least
+            // '2^i' cycles, except the last one, which has no upper bound
+    };
+
+    struct CallStats {
+        // This 'struct' holds the statistics of calls to one external
+        // function.
+
+        Uint64 d_numCalls;                  // calls made
+        Uint64 d_numCycles;                 // cycles spent in the calls
+        Uint64 d_histogram[k_NUM_BUCKETS];  // calls by latency
+    };
+
+  private:
+    // PRIVATE CONSTANTS
+    enum { k_NUM_OPCODES = sjtt::Bytecode::k_NUM_OPCODES };
+
+    // DATA
+    Uint64                                  d_numExecutions[k_NUM_OPCODES];
+    Uint64                                  d_numCycles[k_NUM_OPCODES];
+    bsl::map<ExternalFunction, CallStats>   d_calls;           // by function
+    bsl::map<const void *, Uint64>          d_numInvocations;  // by program
+    bsl::map<ExternalFunction, bsl::string> d_functionNames;
+    bsl::map<const void *, bsl::string>     d_programNames;
+
+    // NOT IMPLEMENTED
+    Profile(const Profile&);
+    Profile& operator=(const Profile&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(Profile,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CLASS METHODS
+    static Uint64 readCycles();
+        // Return the current value of a monotonic counter of cycles: the
+        // time-stamp counter on x86-64, and nanoseconds elsewhere.
+
+    static int bucket(Uint64 cycles);
+        // Return the index of the bucket of a latency histogram counting a
+        // call that took the specified 'cycles'.
+
+    // CREATORS
+    explicit Profile(Allocator *basicAllocator = 0);
+        // Create an empty profile.  Optionally specify a 'basicAllocator'
+        // used to supply memory.  If 'basicAllocator' is 0, the currently
+        // installed default allocator is used.
+
+    // MANIPULATORS
+    void recordOpcode(sjtt::Bytecode::Opcode opcode, Uint64 cycles);
+        // Record an execution of the specified 'opcode' that took the
+        // specified 'cycles'.
+
+    void recordCall(ExternalFunction function, Uint64 cycles);
+        // Record a call of the specified external 'function' that took the
+        // specified 'cycles'.
+
+    void recordInvocation(const void *program);
+        // Record an invocation of the specified 'program'.
+
+    void nameFunction(ExternalFunction                      function,
+                      const BloombergLP::bslstl::StringRef& name);
+        // Report the specified external 'function' as the specified 'name'.
+
+    void nameProgram(const void                            *program,
+                     const BloombergLP::bslstl::StringRef&  name);
+        // Report the specified 'program', e.g., the address of its first
+        // 'Bytecode', as the specified 'name'.
+
+    void reset();
+        // Discard the statistics recorded so far, keeping the names.
+
+    // ACCESSORS
+    Uint64 numExecutions(sjtt::Bytecode::Opcode opcode) const;
+        // Return the number of times the specified 'opcode' was executed.
+
+    Uint64 numCycles(sjtt::Bytecode::Opcode opcode) const;
+        // Return the cycles spent executing the specified 'opcode'.
+
+    const CallStats *callStats(ExternalFunction function) const;
+        // Return the statistics of calls to the specified external
+        // 'function', or 0 if none was recorded.
+
+    Uint64 numInvocations(const void *program) const;
+        // Return the number of invocations of the specified 'program'.
+
+    bsl::ostream& print(bsl::ostream& stream) const;
+        // Write a human-readable report of this profile to the specified
+        // 'stream', and return a reference to 'stream'.  Opcodes that were
+        // not executed are omitted.
+
+    bsl::ostream& printJson(bsl::ostream& stream) const;
+        // Write this profile to the specified 'stream' as a JSON object
+        // having the members "opcodes", "functions", and "programs", each an
+        // array of objects, and return a reference to 'stream'.  Opcodes
+        // that were not executed are omitted.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                               // -------------
+                               // class Profile
+                               // -------------
+
+// CLASS METHODS
+inline
+Profile::Uint64 Profile::readCycles() {
+#ifdef SJTU_PROFILE_RDTSC
+    return __rdtsc();
+#else
+    return BloombergLP::bsls::TimeUtil::getTimer();
+#endif
+}
+
+inline
+int Profile::bucket(Uint64 cycles) {
+    int result = 0;
+    while (cycles > 1 && result < k_NUM_BUCKETS - 1) {
+        cycles >>= 1;
+        ++result;
+    }
+    return result;
+}
+
+// MANIPULATORS
+inline
+void Profile::recordOpcode(sjtt::Bytecode::Opcode opcode, Uint64 cycles) {
+    BSLS_ASSERT_SAFE(0 <= opcode);
+    BSLS_ASSERT_SAFE(static_cast<int>(opcode) < k_NUM_OPCODES);
+    ++d_numExecutions[opcode];
+    d_numCycles[opcode] += cycles;
+}
+
+inline
+void Profile::recordInvocation(const void *program) {
+    ++d_numInvocations[program];
+}
+
+// ACCESSORS
+inline
+Profile::Uint64 Profile::numExecutions(sjtt::Bytecode::Opcode opcode) const {
+    BSLS_ASSERT_SAFE(0 <= opcode);
+    BSLS_ASSERT_SAFE(static_cast<int>(opcode) < k_NUM_OPCODES);
+    return d_numExecutions[opcode];
+}
+
+inline
+Profile::Uint64 Profile::numCycles(sjtt::Bytecode::Opcode opcode) const {
+    BSLS_ASSERT_SAFE(0 <= opcode);
+    BSLS_ASSERT_SAFE(static_cast<int>(opcode) < k_NUM_OPCODES);
+    return d_numCycles[opcode];
+}
+}
+
+#endif
@@ -0,0 +1,289 @@
+// sjtu_profile.t.cpp                                              -*-C++-*-
+
+#include <sjtu_profile.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_executioncontext.h>
+#include <sjtt_program.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_interpretutil.h>
+
+#include <bdls_testutil.h>
+#include <bslma_testallocator.h>
+
+#include <bsl_sstream.h>
+#include <bsl_string.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+typedef sjtt::Bytecode Bytecode;
+
+namespace {
+
+void negate(sjtt::ExecutionContext *context)
+    // Pop a double from the stack of the specified 'context' and push its
+    // negation.
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    stack.back() = bdld::Datum::createDouble(-stack.back().theDouble());
+}
+
+void identity(sjtt::ExecutionContext *)
+    // Leave the argument on the stack as the result.
+{
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "interpretProfiled" << endl
+                          << "=================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        bsl::vector<bdld::Datum> stack(&ta);
+        sjtt::ExecutionContext context(&ta, &stack);
+        Profile profile(&ta);
+
+        // '-(-1 + 2) + 3'
+
+        const Bytecode code[] = {
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createPush(DatumUtil::createExternalFunction(&negate)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::create(Bytecode::e_PushAddDoubles,
+                             bdld::Datum::createDouble(2)),
+            Bytecode::createPush(DatumUtil::createExternalFunction(&negate)),
+            Bytecode::createOpcode(Bytecode::e_Execute),
+            Bytecode::createPush(bdld::Datum::createDouble(3)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        const bsl::size_t NUM_CODES = sizeof code / sizeof *code;
+
+        bdld::Datum result;
+        for (int i = 0; i < 3; ++i) {
+            ASSERT(0 == InterpretUtil::interpretProfiled(&result,
+                                                         &context,
+                                                         code,
+                                                         &profile));
+            ASSERTV(result, bdld::Datum::createDouble(2) == result);
+            ASSERT(0 == stack.size());
+        }
+        ASSERT(3 == profile.numInvocations(code));
+        ASSERT(12 == profile.numExecutions(Bytecode::e_Push));
+        ASSERT( 6 == profile.numExecutions(Bytecode::e_Execute));
+        ASSERT( 3 == profile.numExecutions(Bytecode::e_PushAddDoubles));
+        ASSERT( 3 == profile.numExecutions(Bytecode::e_AddDoubles));
+        ASSERT( 3 == profile.numExecutions(Bytecode::e_Return));
+        ASSERT( 0 == profile.numExecutions(Bytecode::e_Pop));
+
+        const Profile::CallStats *stats = profile.callStats(&negate);
+        ASSERT(0 != stats);
+        ASSERT(6 == stats->d_numCalls);
+        Profile::Uint64 numBucketed = 0;
+        for (int i = 0; i < Profile::k_NUM_BUCKETS; ++i) {
+            numBucketed += stats->d_histogram[i];
+        }
+        ASSERT(6 == numBucketed);
+        ASSERT(0 == profile.callStats(&identity));
+
+        if (verbose) cout << "\tPacked programs and failures." << endl;
+
+        sjtt::ProgramBuilder builder(&ta);
+        ASSERT(0 == builder.append(code, NUM_CODES));
+        sjtt::Program program(&ta);
+        builder.build(&program);
+        ASSERT(0 == InterpretUtil::interpretProfiled(&result,
+                                                     &context,
+                                                     program,
+                                                     &profile));
+        ASSERTV(result, bdld::Datum::createDouble(2) == result);
+        ASSERT(1 == profile.numInvocations(&program));
+        ASSERT(8 == profile.callStats(&negate)->d_numCalls);
+
+        const Bytecode badAdd[] = {
+            Bytecode::createPush(bdld::Datum::createInteger(1)),
+            Bytecode::createPush(bdld::Datum::createDouble(1)),
+            Bytecode::createOpcode(Bytecode::e_AddDoubles),
+            Bytecode::createOpcode(Bytecode::e_Return),
+        };
+        ASSERT(InterpretUtil::e_TypeError ==
+               InterpretUtil::interpretProfiled(&result,
+                                                &context,
+                                                badAdd,
+                                                &profile));
+        ASSERT(0 == stack.size());
+        ASSERT(5 == profile.numExecutions(Bytecode::e_AddDoubles));
+        ASSERT(4 == profile.numExecutions(Bytecode::e_Return));
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "print and printJson" << endl
+                          << "===================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        Profile profile(&ta);
+        const int program = 0;
+
+        profile.recordOpcode(Bytecode::e_Push, 40);
+        profile.recordOpcode(Bytecode::e_Push, 60);
+        profile.recordCall(&negate, 5);
+        profile.recordCall(&identity, 1);
+        profile.recordInvocation(&program);
+        profile.nameFunction(&negate, "negate");
+        profile.nameProgram(&program, "my \"script\"");
+
+        bsl::ostringstream text;
+        profile.print(text);
+        if (veryVerbose) cout << text.str();
+        ASSERT(bsl::string::npos != text.str().find("Push"));
+        ASSERT(bsl::string::npos != text.str().find("50.0"));
+        ASSERT(bsl::string::npos != text.str().find("negate"));
+        ASSERT(bsl::string::npos != text.str().find("< 2^3"));
+        ASSERT(bsl::string::npos != text.str().find("my \"script\""));
+        ASSERT(bsl::string::npos == text.str().find("Return"));
+
+        bsl::ostringstream json;
+        profile.printJson(json);
+        if (veryVerbose) cout << json.str() << endl;
+        const bsl::string& J = json.str();
+        ASSERT(0 == J.find("{\"opcodes\":[{\"opcode\":\"Push\","
+                           "\"executions\":2,\"cycles\":100}],"
+                           "\"functions\":["));
+        ASSERT(bsl::string::npos != J.find("\"name\":\"negate\""));
+        ASSERT(bsl::string::npos != J.find("\"calls\":1,\"cycles\":5,"
+                                           "\"histogram\":[0,0,1,0,"));
+        ASSERT(bsl::string::npos !=
+                               J.find("\"name\":\"my \\\"script\\\"\""));
+        ASSERT(bsl::string::npos != J.find("\"invocations\":1}]}"));
+        ASSERT('}' == J[J.size() - 1]);
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "recordCall and reset" << endl
+                          << "====================" << endl;
+
+        ASSERT( 0 == Profile::bucket(0));
+        ASSERT( 0 == Profile::bucket(1));
+        ASSERT( 1 == Profile::bucket(2));
+        ASSERT( 1 == Profile::bucket(3));
+        ASSERT( 2 == Profile::bucket(4));
+        ASSERT(10 == Profile::bucket(1024));
+        ASSERT(Profile::k_NUM_BUCKETS - 1 == Profile::bucket(~0ULL));
+
+        bslma::TestAllocator ta(veryVerbose);
+        Profile profile(&ta);
+        profile.recordCall(&negate, 3);
+        profile.recordCall(&negate, 1000);
+        profile.recordCall(&negate, 1001);
+
+        const Profile::CallStats *stats = profile.callStats(&negate);
+        ASSERT(0 != stats);
+        ASSERT(3 == stats->d_numCalls);
+        ASSERT(2004 == stats->d_numCycles);
+        ASSERT(1 == stats->d_histogram[1]);
+        ASSERT(2 == stats->d_histogram[9]);
+
+        profile.recordOpcode(Bytecode::e_Pop, 7);
+        profile.recordInvocation(stats);
+        profile.reset();
+        ASSERT(0 == profile.callStats(&negate));
+        ASSERT(0 == profile.numExecutions(Bytecode::e_Pop));
+        ASSERT(0 == profile.numInvocations(stats));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        Profile profile(&ta);
+        for (int i = 0; i < Bytecode::k_NUM_OPCODES; ++i) {
+            const Bytecode::Opcode OP = static_cast<Bytecode::Opcode>(i);
+            ASSERTV(i, 0 == profile.numExecutions(OP));
+            ASSERTV(i, 0 == profile.numCycles(OP));
+        }
+        profile.recordOpcode(Bytecode::e_Return, 12);
+        ASSERT( 1 == profile.numExecutions(Bytecode::e_Return));
+        ASSERT(12 == profile.numCycles(Bytecode::e_Return));
+
+        const Profile::Uint64 before = Profile::readCycles();
+        const Profile::Uint64 after  = Profile::readCycles();
+        ASSERT(before <= after);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,841 @@
+// sjtu_registercode.cpp
+#include <sjtu_registercode.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_executioncontext.h>
+#include <sjtt_globalvalue.h>
+#include <sjtt_heap.h>
+#include <sjtu_arrayutil.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_interpretutil.h>
+#include <sjtu_numericutil.h>
+
+#include <bslmf_assert.h>
+#include <bsls_performancehint.h>
+#include <bsls_platform.h>
+
+#include <bsl_algorithm.h>
+
+#if (defined(BSLS_PLATFORM_CMP_GNU) || defined(BSLS_PLATFORM_CMP_CLANG))     \
+ && !defined(SJTU_INTERPRETUTIL_SWITCH_DISPATCH)
+#define SJTU_REGISTERCODE_THREADED 1
+#endif
+
+// Instructions are dispatched as by 'InterpretUtil': each handler is written
+// once, between 'SJTU_INSTRUCTION' and 'SJTU_NEXT', and, with threaded
+// dispatch, jumps directly to the handler of the next instruction.
+
+#ifdef SJTU_REGISTERCODE_THREADED
+#define SJTU_INSTRUCTION(NAME) case RegisterCode::e_##NAME: op_##NAME:
+#define SJTU_NEXT() goto *k_LABELS[ip->d_opcode]
+#else
+#define SJTU_INSTRUCTION(NAME) case RegisterCode::e_##NAME:
+#define SJTU_NEXT() continue
+#endif
+
+namespace sjtu {
+using BloombergLP::bdld::Datum;
+using BloombergLP::bslma::Allocator;
+using sjtt::Bytecode;
+using sjtt::ExecutionContext;
+
+namespace {
+
+typedef RegisterCode::Instruction Instruction;
+
+                              // ================
+                              // class Translator
+                              // ================
+
+class Translator {
+    // This class provides a mechanism translating a 'Bytecode' program to
+    // register instructions.  It tracks the values on the stack above the
+    // result of the most recent call, and the largest number of them, which
+    // is the number of registers used until the next call.  A value pushed
+    // by 'e_Push' is not loaded into its register unless an instruction
+    // needs it there.
+
+    // PRIVATE TYPES
+    enum {
+        k_IN_REGISTER = -1  // a value held in its register
+    };
+
+    // DATA
+    bsl::vector<Instruction>&  d_code;          // instructions emitted
+    bsl::vector<Datum>&        d_constants;     // constants of 'd_code'
+    bsl::vector<int>           d_slots;         // constant of each value, or
+                                                // 'k_IN_REGISTER'
+    bsl::size_t                d_maxDepth;      // maximum size of 'd_slots'
+    bsl::size_t                d_call;          // 'e_Call' before the values
+    bool                       d_hasCalled;     // 'd_call' is valid
+    bsl::size_t               *d_numRegisters;  // registers before any call
+
+    // PRIVATE MANIPULATORS
+    void emit(RegisterCode::Opcode opcode,
+              bsl::size_t          a,
+              bsl::size_t          b = 0,
+              bsl::size_t          c = 0) {
+        const Instruction instruction = {
+            static_cast<unsigned char>(opcode),
+            static_cast<unsigned short>(a),
+            static_cast<unsigned short>(b),
+            static_cast<unsigned short>(c)
+        };
+        d_code.push_back(instruction);
+    }
+
+    void closeSegment() {
+        // Record the number of registers used since the last call.
+
+        if (d_hasCalled) {
+            d_code[d_call].d_c = static_cast<unsigned short>(d_maxDepth);
+        }
+        else {
+            *d_numRegisters = d_maxDepth;
+        }
+    }
+
+  public:
+    // CREATORS
+    Translator(bsl::vector<Instruction> *code,
+               bsl::vector<Datum>       *constants,
+               bsl::size_t              *numRegisters,
+               Allocator                *allocator)
+    : d_code(*code)
+    , d_constants(*constants)
+    , d_slots(allocator)
+    , d_maxDepth(0)
+    , d_call(0)
+    , d_hasCalled(false)
+    , d_numRegisters(numRegisters) {
+    }
+
+    // MANIPULATORS
+    int pushConstant(const Datum& value) {
+        // Push the specified 'value', to be loaded when needed.  Return 0 on
+        // success, and a non-zero value if there are too many constants or
+        // registers.
+
+        if (d_constants.size() > RegisterCode::k_MAX_OPERAND) {
+            return 1;                                                 // RETURN
+        }
+        d_constants.push_back(value);
+        return push(static_cast<int>(d_constants.size() - 1));
+    }
+
+    int push(int slot = k_IN_REGISTER) {
+        // Push a value that is the specified 'slot' constant, or is held in
+        // its register if 'slot' is not specified.  Return 0 on success, and
+        // a non-zero value if there are too many registers.
+
+        if (d_slots.size() >= RegisterCode::k_MAX_OPERAND) {
+            return 1;                                                 // RETURN
+        }
+        d_slots.push_back(slot);
+        d_maxDepth = bsl::max(d_maxDepth, d_slots.size());
+        return 0;
+    }
+
+    int pop(int *slot = 0) {
+        // Pop the top value, and load into the optionally specified 'slot'
+        // its constant, or 'k_IN_REGISTER'.  Return 0 on success, and a
+        // non-zero value if no value is known to be on the stack.
+
+        if (d_slots.empty()) {
+            return 1;                                                 // RETURN
+        }
+        if (slot) {
+            *slot = d_slots.back();
+        }
+        d_slots.pop_back();
+        return 0;
+    }
+
+    void load(bsl::size_t index) {
+        // Load the value at the specified 'index' into its register, if it
+        // is a constant.
+
+        BSLS_ASSERT_SAFE(index < d_slots.size());
+        if (k_IN_REGISTER != d_slots[index]) {
+            emit(RegisterCode::e_LoadConstant, index, d_slots[index]);
+            d_slots[index] = k_IN_REGISTER;
+        }
+    }
+
+    int apply(RegisterCode::Opcode opcode, int numOperands) {
+        // Replace the specified 'numOperands' values on the top of the stack
+        // with the result of the specified 'opcode', which reads them from
+        // their registers and writes the result into the register of the
+        // lowest.  Return 0 on success, and a non-zero value if the stack
+        // underflows.
+
+        if (d_slots.size() < static_cast<bsl::size_t>(numOperands)) {
+            return 1;                                                 // RETURN
+        }
+        const bsl::size_t dst = d_slots.size() - numOperands;
+        for (int i = 0; i < numOperands; ++i) {
+            load(dst + i);
+        }
+        if (RegisterCode::e_MultiplyAddArrays == opcode) {
+            emit(opcode, dst, dst + 1, dst + 2);
+        }
+        else {
+            emit(opcode, dst, dst, dst + 1);
+        }
+        d_slots.resize(dst + 1);
+        return 0;
+    }
+
+    int addDoubles(int rhs) {
+        // Replace the value on the top of the stack with its sum with the
+        // specified 'rhs' constant, or with the value above it, which is
+        // popped, if 'rhs' is 'k_IN_REGISTER'.  Return 0 on success, and a
+        // non-zero value if the stack underflows.
+
+        if (d_slots.empty()) {
+            return 1;                                                 // RETURN
+        }
+        const bsl::size_t dst = d_slots.size() - 1;
+        load(dst);
+        if (k_IN_REGISTER == rhs) {
+            emit(RegisterCode::e_AddDoubles, dst, dst, dst + 1);
+        }
+        else {
+            emit(RegisterCode::e_AddDoublesConstant, dst, dst, rhs);
+        }
+        return 0;
+    }
+
+    void getGlobal(int slot) {
+        emit(RegisterCode::e_GetGlobal, d_slots.size() - 1, slot);
+    }
+
+    void setGlobal(int value, int slot) {
+        if (k_IN_REGISTER == value) {
+            emit(RegisterCode::e_SetGlobal, d_slots.size(), slot);
+        }
+        else {
+            emit(RegisterCode::e_SetGlobalConstant, value, slot);
+        }
+    }
+
+    int call() {
+        // Emit a call of the function on the top of the stack, with every
+        // value loaded into its register, and start tracking the values above
+        // its result.  Return 0 on success, and a non-zero value if the stack
+        // underflows.
+
+        int function;
+        if (0 != pop(&function)) {
+            return 1;                                                 // RETURN
+        }
+        for (bsl::size_t i = 0; i < d_slots.size(); ++i) {
+            load(i);
+        }
+        if (k_IN_REGISTER != function) {
+            emit(RegisterCode::e_LoadConstant, d_slots.size(), function);
+        }
+        closeSegment();
+        d_call      = d_code.size();
+        d_hasCalled = true;
+        emit(RegisterCode::e_Call, d_slots.size());
+        d_slots.clear();
+        d_maxDepth = 0;
+        return push();
+    }
+
+    int ret() {
+        // Emit the return of the value on the top of the stack.  Return 0 on
+        // success, and a non-zero value if the stack underflows.
+
+        int value;
+        if (0 != pop(&value)) {
+            return 1;                                                 // RETURN
+        }
+        if (k_IN_REGISTER == value) {
+            emit(RegisterCode::e_Return, d_slots.size());
+        }
+        else {
+            emit(RegisterCode::e_ReturnConstant, value);
+        }
+        closeSegment();
+        return 0;
+    }
+};
+
+bool isSlot(const Datum& value)
+    // Return 'true' if the specified 'value' is a valid global slot index
+    // that fits in an operand, and 'false' otherwise.
+{
+    return value.isInteger()
+        && 0 <= value.theInteger()
+        && RegisterCode::k_MAX_OPERAND >= value.theInteger();
+}
+
+int translateImp(bsl::vector<Instruction> *code,
+                 bsl::vector<Datum>       *constants,
+                 bsl::size_t              *numRegisters,
+                 const Bytecode           *program,
+                 Allocator                *allocator)
+    // Translate the specified 'program' into the specified 'code' and
+    // 'constants', and load into the specified 'numRegisters' the registers
+    // used before the first call, using the specified 'allocator' to supply
+    // temporary memory.  Return 0 on success, and a non-zero value
+    // otherwise.
+{
+    Translator translator(code, constants, numRegisters, allocator);
+    for (const Bytecode *ip = program;; ++ip) {
+        int value;
+        int rc = 0;
+        switch (ip->opcode()) {
+          case Bytecode::e_Push: {
+            rc = translator.pushConstant(ip->data());
+          } break;
+          case Bytecode::e_AddDoubles: {
+            rc = translator.pop(&value) || translator.addDoubles(value);
+          } break;
+          case Bytecode::e_PushAddDoubles: {
+            rc = translator.pushConstant(ip->data())
+              || translator.pop(&value)
+              || translator.addDoubles(value);
+          } break;
+          case Bytecode::e_Pop: {
+            rc = translator.pop();
+          } break;
+          case Bytecode::e_GetGlobalSlot: {
+            if (!isSlot(ip->data())) {
+                return 1;                                             // RETURN
+            }
+            rc = translator.push();
+            if (0 == rc) {
+                translator.getGlobal(ip->data().theInteger());
+            }
+          } break;
+          case Bytecode::e_SetGlobalSlot: {
+            if (!isSlot(ip->data())) {
+                return 1;                                             // RETURN
+            }
+            rc = translator.pop(&value);
+            if (0 == rc) {
+                translator.setGlobal(value, ip->data().theInteger());
+            }
+          } break;
+          case Bytecode::e_AddArrays: {
+            rc = translator.apply(RegisterCode::e_AddArrays, 2);
+          } break;
+          case Bytecode::e_MultiplyArrays: {
+            rc = translator.apply(RegisterCode::e_MultiplyArrays, 2);
+          } break;
+          case Bytecode::e_MultiplyAddArrays: {
+            rc = translator.apply(RegisterCode::e_MultiplyAddArrays, 3);
+          } break;
+          case Bytecode::e_SumArray: {
+            rc = translator.apply(RegisterCode::e_SumArray, 1);
+          } break;
+          case Bytecode::e_DotArrays: {
+            rc = translator.apply(RegisterCode::e_DotArrays, 2);
+          } break;
+          case Bytecode::e_AddIntegers: {
+            rc = translator.apply(RegisterCode::e_AddIntegers, 2);
+          } break;
+          case Bytecode::e_SubtractIntegers: {
+            rc = translator.apply(RegisterCode::e_SubtractIntegers, 2);
+          } break;
+          case Bytecode::e_MultiplyIntegers: {
+            rc = translator.apply(RegisterCode::e_MultiplyIntegers, 2);
+          } break;
+          case Bytecode::e_LessIntegers: {
+            rc = translator.apply(RegisterCode::e_LessIntegers, 2);
+          } break;
+          case Bytecode::e_Execute: {
+            rc = translator.call();
+          } break;
+          case Bytecode::e_Return: {
+            return translator.ret();                                  // RETURN
+          }
+          default: {
+            return 1;                                                 // RETURN
+          }
+        }
+        if (0 != rc) {
+            return rc;                                                // RETURN
+        }
+    }
+}
+
+                             // ==================
+                             // class RegisterFile
+                             // ==================
+
+class RegisterFile {
+    // This class provides the registers of a running program: its values,
+    // in a buffer supplied by the interpreter or in memory from the
+    // allocator of the context, and a box for each, as described for
+    // 'InterpretUtil', holding a copy of the 'Datum' referred to by the value
+    // when it was read from a global, or returned by an external function or
+    // an array kernel.  Since a value never moves between registers, the box
+    // of a register is only referred to by the value in that register.  The
+    // registers named by instructions are those from the result of the most
+    // recent call (see 'window'); the values below are those left on the
+    // stack by the callees, which stay on the stack of the context, and are
+    // neither copied again by later calls nor read back.
+
+    // DATA
+    bsl::vector<Datum>&  d_datums;       // stack of the context
+    const bsl::size_t    d_base;         // size of 'd_datums' on entry
+    bsl::vector<Value>   d_spill;        // values outgrowing the buffer
+    bsl::vector<Datum>   d_spillBoxes;   // boxes outgrowing the buffer
+    Value               *d_values;       // every value
+    Datum               *d_boxes;        // box of each value
+    bsl::size_t          d_capacity;     // values that can be held
+    bsl::size_t          d_window;       // index of register 0
+
+    // PRIVATE MANIPULATORS
+    void reserve(bsl::size_t numValues) {
+        // Make room for the specified 'numValues', discarding the values held
+        // if the buffer is outgrown.
+
+        if (numValues > d_capacity) {
+            d_capacity = bsl::max(numValues, 2 * d_capacity);
+            d_spill.resize(d_capacity);
+            d_spillBoxes.resize(d_capacity);
+            d_values = d_spill.data();
+            d_boxes  = d_spillBoxes.data();
+        }
+    }
+
+  public:
+    // CREATORS
+    RegisterFile(ExecutionContext *context,
+                 Value            *buffer,
+                 Datum            *boxes,
+                 bsl::size_t       size,
+                 bsl::size_t       numRegisters)
+    : d_datums(*context->stack())
+    , d_base(context->stack()->size())
+    , d_spill(context->allocator())
+    , d_spillBoxes(context->allocator())
+    , d_values(buffer)
+    , d_boxes(boxes)
+    , d_capacity(size)
+    , d_window(0) {
+        reserve(numRegisters);
+    }
+
+    // MANIPULATORS
+    Value box(bsl::size_t index, const Datum& datum) {
+        // Return a value holding the specified 'datum' for the specified
+        // 'index' register, referring to its box if needed.
+
+        const Value value = Value::fromDatum(datum);
+        if (!value.isReference()) {
+            return value;                                             // RETURN
+        }
+        Datum *box = d_boxes + d_window + index;
+        *box = datum;
+        return Value::createReference(box);
+    }
+
+    int call(ExecutionContext            *context,
+             DatumUtil::ExternalFunction  function,
+             bsl::size_t                  numArguments,
+             bsl::size_t                  numRegisters) {
+        // Invoke the specified 'function' with the specified 'context', on a
+        // stack holding the values below the specified 'numArguments'
+        // register, and move the window to its result, making room for the
+        // specified 'numRegisters'.  Only the registers of the window are
+        // copied, the values below being already on the stack, and only the
+        // result is read back, since no register below the window is read
+        // (so the values the callee leaves there may be moved by a
+        // collection of the heap).  Return 0 on success, and a non-zero
+        // value, leaving the window unchanged, if the callee left no result,
+        // or more values than the stack held before the call.
+
+        d_datums.resize(d_base + d_window);
+        const Value *end = d_values + d_window + numArguments;
+        for (const Value *value = d_values + d_window; value != end; ++value) {
+            d_datums.push_back(value->toDatum());
+        }
+        function(context);
+
+        // If the callee left no result, or popped values below 'd_base', the
+        // unsigned subtraction wraps, so one comparison checks both bounds.
+
+        const bsl::size_t numValues = d_datums.size() - d_base;
+        if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                  numValues - 1 > d_window + numArguments)) {
+            return 1;                                                 // RETURN
+        }
+        reserve(numValues - 1 + numRegisters);
+        d_window           = numValues - 1;
+        d_values[d_window] = box(0, d_datums.back());
+        d_datums.pop_back();
+        return 0;
+    }
+
+    void restore() {
+        d_datums.resize(d_base);
+    }
+
+    // ACCESSORS
+    Value *window() const {
+        // Return the address of register 0.
+
+        return d_values + d_window;
+    }
+};
+
+int assign(sjtt::GlobalValue *global, sjtt::Heap *heap, Value value)
+    // Assign the specified 'value' to the specified 'global' as described
+    // for 'InterpretUtil': the global refers to the value, and the write is
+    // recorded, if the specified 'heap' is not 0, and the value is copied
+    // into the allocator of the global otherwise.  Return 0 on success, and
+    // a non-zero value, with no effect, if 'value' is an object, which
+    // cannot be assigned to a global.
+{
+    if (value.isObject()) {
+        return 1;                                                     // RETURN
+    }
+    const Datum datum = value.toDatum();
+    if (heap) {
+        heap->recordWrite(datum);
+        global->refer(datum);
+    }
+    else {
+        global->clone(datum);
+    }
+    return 0;
+}
+
+enum {
+    k_BUFFER_DEPTH = 64  // registers held on the program stack by 'execute'
+};
+
+}  // close unnamed namespace
+
+                             // ------------------
+                             // class RegisterCode
+                             // ------------------
+
+// CLASS METHODS
+const char *RegisterCode::toAscii(Opcode opcode) {
+#define CASE(NAME) case e_##NAME: return #NAME;
+
+    switch (opcode) {
+      CASE(LoadConstant)
+      CASE(AddDoubles)
+      CASE(AddDoublesConstant)
+      CASE(GetGlobal)
+      CASE(SetGlobal)
+      CASE(SetGlobalConstant)
+      CASE(AddArrays)
+      CASE(MultiplyArrays)
+      CASE(MultiplyAddArrays)
+      CASE(SumArray)
+      CASE(DotArrays)
+      CASE(AddIntegers)
+      CASE(SubtractIntegers)
+      CASE(MultiplyIntegers)
+      CASE(LessIntegers)
+      CASE(Call)
+      CASE(Return)
+      CASE(ReturnConstant)
+    }
+
+#undef CASE
+
+    return "(* UNKNOWN *)";
+}
+
+// CREATORS
+RegisterCode::RegisterCode(Allocator *basicAllocator)
+: d_code(basicAllocator)
+, d_constants(basicAllocator)
+, d_values(basicAllocator)
+, d_numRegisters(0)
+{
+}
+
+// MANIPULATORS
+int RegisterCode::translate(const Bytecode *code)
+{
+    BSLS_ASSERT(0 != code);
+
+    reset();
+    if (0 != translateImp(&d_code,
+                          &d_constants,
+                          &d_numRegisters,
+                          code,
+                          d_code.get_allocator().mechanism())) {
+        reset();
+        return 1;                                                     // RETURN
+    }
+
+    // 'd_constants' is not modified any more, so that the values referring
+    // to its elements remain valid.
+
+    d_values.reserve(d_constants.size());
+    for (bsl::size_t i = 0; i < d_constants.size(); ++i) {
+        d_values.push_back(Value::fromDatum(d_constants[i]));
+    }
+    return 0;
+}
+
+void RegisterCode::reset()
+{
+    d_code.clear();
+    d_constants.clear();
+    d_values.clear();
+    d_numRegisters = 0;
+}
+
+// ACCESSORS
+int RegisterCode::execute(Datum *result, ExecutionContext *context) const
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != context);
+    BSLS_ASSERT(isTranslated());
+
+#ifdef SJTU_REGISTERCODE_THREADED
+    static const void *const k_LABELS[] = {
+        &&op_LoadConstant,
+        &&op_AddDoubles,
+        &&op_AddDoublesConstant,
+        &&op_GetGlobal,
+        &&op_SetGlobal,
+        &&op_SetGlobalConstant,
+        &&op_AddArrays,
+        &&op_MultiplyArrays,
+        &&op_MultiplyAddArrays,
+        &&op_SumArray,
+        &&op_DotArrays,
+        &&op_AddIntegers,
+        &&op_SubtractIntegers,
+        &&op_MultiplyIntegers,
+        &&op_LessIntegers,
+        &&op_Call,
+        &&op_Return,
+        &&op_ReturnConstant,
+    };
+    BSLMF_ASSERT(k_NUM_OPCODES == sizeof(k_LABELS) / sizeof(*k_LABELS));
+#endif
+
+    ExecutionContext::Globals *globals = context->globals();
+    sjtt::Heap                *heap    = context->heap();
+    Value                      buffer[k_BUFFER_DEPTH];
+    Datum                      boxes[k_BUFFER_DEPTH];
+    RegisterFile               file(context,
+                                    buffer,
+                                    boxes,
+                                    k_BUFFER_DEPTH,
+                                    d_numRegisters);
+    Value                     *r  = file.window();
+    const Value               *k  = d_values.data();
+    const Instruction         *ip = d_code.data();
+    Datum                      datum;
+    int                        rc;
+
+    // 'r' and 'k' are the registers and the constants named by the operands
+    // of the instructions.  'datum' receives the results of the array
+    // kernels.
+
+    for (;;) {
+        switch (ip->d_opcode) {
+          SJTU_INSTRUCTION(LoadConstant) {
+            r[ip->d_a] = k[ip->d_b];
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(AddDoubles) {
+            const Value lhs = r[ip->d_b];
+            const Value rhs = r[ip->d_c];
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(!lhs.isDouble()
+                                                   || !rhs.isDouble())) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            r[ip->d_a] = Value::createRawDouble(lhs.theDouble() +
+                                                rhs.theDouble());
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(AddDoublesConstant) {
+            const Value lhs = r[ip->d_b];
+            const Value rhs = k[ip->d_c];
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(!lhs.isDouble()
+                                                   || !rhs.isDouble())) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            r[ip->d_a] = Value::createRawDouble(lhs.theDouble() +
+                                                rhs.theDouble());
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(GetGlobal) {
+            BSLS_ASSERT_SAFE(0 != globals);
+            BSLS_ASSERT_SAFE(ip->d_b < globals->size());
+            r[ip->d_a] = file.box(ip->d_a, (*globals)[ip->d_b].datum());
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(SetGlobal) {
+            BSLS_ASSERT_SAFE(0 != globals);
+            BSLS_ASSERT_SAFE(ip->d_b < globals->size());
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                       0 != assign(&(*globals)[ip->d_b], heap, r[ip->d_a]))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(SetGlobalConstant) {
+            BSLS_ASSERT_SAFE(0 != globals);
+            BSLS_ASSERT_SAFE(ip->d_b < globals->size());
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                       0 != assign(&(*globals)[ip->d_b], heap, k[ip->d_a]))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(AddArrays) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        0 != ArrayUtil::add(&datum,
+                                            r[ip->d_b].toDatum(),
+                                            r[ip->d_c].toDatum(),
+                                            context->allocator()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            r[ip->d_a] = file.box(ip->d_a, datum);
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(MultiplyArrays) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        0 != ArrayUtil::multiply(&datum,
+                                                 r[ip->d_b].toDatum(),
+                                                 r[ip->d_c].toDatum(),
+                                                 context->allocator()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            r[ip->d_a] = file.box(ip->d_a, datum);
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(MultiplyAddArrays) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        0 != ArrayUtil::multiplyAdd(&datum,
+                                                    r[ip->d_a].toDatum(),
+                                                    r[ip->d_b].toDatum(),
+                                                    r[ip->d_c].toDatum(),
+                                                    context->allocator()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            r[ip->d_a] = file.box(ip->d_a, datum);
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(SumArray) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        0 != ArrayUtil::sum(&datum, r[ip->d_b].toDatum()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            r[ip->d_a] = Value::createDouble(datum.theDouble());
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(DotArrays) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        0 != ArrayUtil::dot(&datum,
+                                            r[ip->d_b].toDatum(),
+                                            r[ip->d_c].toDatum()))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            r[ip->d_a] = Value::createDouble(datum.theDouble());
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(AddIntegers) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        sjtt::TypeFeedback::e_Other ==
+                                NumericUtil::add(&r[ip->d_a],
+                                                 r[ip->d_b],
+                                                 r[ip->d_c]))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(SubtractIntegers) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        sjtt::TypeFeedback::e_Other ==
+                                NumericUtil::subtract(&r[ip->d_a],
+                                                      r[ip->d_b],
+                                                      r[ip->d_c]))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(MultiplyIntegers) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        sjtt::TypeFeedback::e_Other ==
+                                NumericUtil::multiply(&r[ip->d_a],
+                                                      r[ip->d_b],
+                                                      r[ip->d_c]))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(LessIntegers) {
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                        sjtt::TypeFeedback::e_Other ==
+                                NumericUtil::less(&r[ip->d_a],
+                                                  r[ip->d_b],
+                                                  r[ip->d_c]))) {
+                rc = InterpretUtil::e_TypeError;
+                goto done;
+            }
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(Call) {
+            const Value callee = r[ip->d_a];
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                              !callee.isExternalFunction())) {
+                rc = InterpretUtil::e_NotCallable;
+                goto done;
+            }
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                0 != file.call(context,
+                                               callee.theExternalFunction(),
+                                               ip->d_a,
+                                               ip->d_c))) {
+                context->setStatus(0);
+                rc = InterpretUtil::e_BadCall;
+                goto done;
+            }
+            r = file.window();
+            if (BSLS_PERFORMANCEHINT_PREDICT_UNLIKELY(
+                                                  0 != context->status())) {
+                rc = context->status();
+                context->setStatus(0);
+                goto done;
+            }
+            ++ip;
+          } SJTU_NEXT();
+          SJTU_INSTRUCTION(Return) {
+            *result = r[ip->d_a].toDatum();
+            rc      = InterpretUtil::e_Success;
+            goto done;
+          }
+          SJTU_INSTRUCTION(ReturnConstant) {
+            *result = k[ip->d_a].toDatum();
+            rc      = InterpretUtil::e_Success;
+            goto done;
+          }
+        }
+    }
+
+  done:
+    file.restore();
+    return rc;
+}
+}
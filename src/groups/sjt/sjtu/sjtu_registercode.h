@@ -0,0 +1,250 @@
+// sjtu_registercode.h
+
+#ifndef INCLUDED_SJTU_REGISTERCODE
+#define INCLUDED_SJTU_REGISTERCODE
+
+#ifndef INCLUDED_SJTU_VALUE
+#include <sjtu_value.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMA_USESBSLMAALLOCATOR
+#include <bslma_usesbslmaallocator.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt { class Bytecode; }
+namespace sjtt { class ExecutionContext; }
+
+namespace sjtu {
+
+                             // ==================
+                             // class RegisterCode
+                             // ==================
+
+class RegisterCode {
+    // This class holds a program translated from stack-based 'Bytecode' to
+    // a register-based, three-address form, and interprets it.  Each
+    // instruction names its destination and source registers, so a value is
+    // not pushed before it is used: the constants pushed by 'e_Push' become
+    // operands of the instructions consuming them, and 'e_Pop' disappears,
+    // e.g., 'Push 1, Push 2, AddDoubles, Return' becomes
+    // 'LoadConstant r0 k0, AddDoublesConstant r0 r0 k1, Return r0'.
+    //
+    // The registers are the slots of the stack of the original program: the
+    // translator tracks the depth of the stack at each instruction, as
+    // 'VerifyUtil' does, and assigns the value at depth 'n' to register 'n',
+    // so that a value never moves between registers once computed.  An
+    // external function invoked by 'e_Call' pops any number of values, so
+    // the positions of the values below its result are not known until run
+    // time; registers are therefore numbered from the result of the most
+    // recent call (or from the bottom of the stack, before the first call),
+    // and a program that pops values below that result is not translated.
+    //
+    // As for 'InterpretUtil', a program is the sequence of instructions
+    // ending with its first 'e_Return', and values are held as 'Value'
+    // objects that are converted from and to 'Datum' objects only where they
+    // cross into other code; 'execute' behaves as 'InterpretUtil::interpret'
+    // for every program that is translated, and reports the same
+    // 'InterpretUtil::Status' values.  A program cannot be suspended in this
+    // form: an external function that suspends it makes it fail with the
+    // status 'InterpretUtil::e_Suspended'.  Instructions are dispatched as
+    // by 'InterpretUtil', through a table of label addresses when compiled
+    // with GCC or Clang, unless 'SJTU_INTERPRETUTIL_SWITCH_DISPATCH' is
+    // defined.  The integer instructions, e.g., 'e_AddIntegers', compute
+    // as their opcodes do, but do not record the kinds of their operations
+    // in the 'sjtt::TypeFeedback' of those opcodes, which is left to the
+    // interpreter.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum      Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    enum Opcode {
+        // Enumeration of the register instructions.  'A', 'B', and 'C' are
+        // the operands of an instruction, 'r[X]' the register numbered by
+        // operand 'X', and 'k[X]' the constant it indexes.
+
+        e_LoadConstant,        // 'r[A] = k[B]'
+        e_AddDoubles,          // 'r[A] = r[B] + r[C]'
+        e_AddDoublesConstant,  // 'r[A] = r[B] + k[C]'
+        e_GetGlobal,           // 'r[A] =' the global in slot 'B'
+        e_SetGlobal,           // the global in slot 'B' '= r[A]'
+        e_SetGlobalConstant,   // the global in slot 'B' '= k[A]'
+        e_AddArrays,           // 'r[A] = r[B] + r[C]', elementwise
+        e_MultiplyArrays,      // 'r[A] = r[B] * r[C]', elementwise
+        e_MultiplyAddArrays,   // 'r[A] = r[A] * r[B] + r[C]', elementwise
+        e_SumArray,            // 'r[A] =' the sum of the elements of 'r[B]'
+        e_DotArrays,           // 'r[A] =' the dot product of 'r[B]', 'r[C]'
+        e_AddIntegers,         // 'r[A] = r[B] + r[C]', see 'NumericUtil'
+        e_SubtractIntegers,    // 'r[A] = r[B] - r[C]', see 'NumericUtil'
+        e_MultiplyIntegers,    // 'r[A] = r[B] * r[C]', see 'NumericUtil'
+        e_LessIntegers,        // 'r[A] = r[B] < r[C]', see 'NumericUtil'
+        e_Call,                // call 'r[A]' with the values below it on
+                               // the stack; its result becomes 'r[0]', and
+                               // 'C' registers are used until the next call
+        e_Return,              // return 'r[A]'
+        e_ReturnConstant       // return 'k[A]'
+    };
+
+    enum {
+        k_NUM_OPCODES = e_ReturnConstant + 1,
+                                       // number of enumerators in 'Opcode'
+
+        k_MAX_OPERAND = 65535          // largest register, constant, or slot
+    };
+
+    struct Instruction {
+        // This 'struct' holds one register instruction in eight bytes.
+
+        // PUBLIC DATA
+        unsigned char  d_opcode;  // 'Opcode' of the instruction
+        unsigned short d_a;       // first operand
+        unsigned short d_b;       // second operand
+        unsigned short d_c;       // third operand
+    };
+
+  private:
+    // DATA
+    bsl::vector<Instruction> d_code;          // translated program
+    bsl::vector<Datum>       d_constants;     // operands of 'e_Push'
+    bsl::vector<Value>       d_values;        // 'd_constants' as values
+    bsl::size_t              d_numRegisters;  // registers before any call
+
+    // NOT IMPLEMENTED
+    RegisterCode(const RegisterCode&);
+    RegisterCode& operator=(const RegisterCode&);
+
+  public:
+    // TRAITS
+    BSLMF_NESTED_TRAIT_DECLARATION(RegisterCode,
+                                   BloombergLP::bslma::UsesBslmaAllocator);
+
+    // CLASS METHODS
+    static const char *toAscii(Opcode opcode);
+        // Return the non-modifiable string representation of the name of the
+        // specified 'opcode', without its 'e_' prefix, e.g., "Call" for
+        // 'e_Call', or "(* UNKNOWN *)" if 'opcode' is not an 'Opcode'.
+
+    // CREATORS
+    explicit RegisterCode(Allocator *basicAllocator = 0);
+        // Create an object holding no program.  Optionally specify a
+        // 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.
+
+    //! ~RegisterCode() = default;
+        // Destroy this object.
+
+    // MANIPULATORS
+    int translate(const sjtt::Bytecode *code);
+        // Translate the program beginning at the specified 'code', replacing
+        // any program held by this object.  Return 0 on success, and a
+        // non-zero value, leaving this object holding no program, if an
+        // instruction pops more values than are known to be on the stack, if
+        // the slot of a global or the number of registers or constants
+        // exceeds 'k_MAX_OPERAND', or if an opcode is not valid or has no
+        // register form, e.g., 'e_GetProperty' or a branch.  Note that, like
+        // 'Bytecode', the translated program does not own memory referred to
+        // by its constants.
+
+    void reset();
+        // Release the program held by this object, if any.
+
+    // ACCESSORS
+    int execute(Datum *result, sjtt::ExecutionContext *context) const;
+        // Interpret the translated program using the specified 'context' as
+        // described for 'InterpretUtil::interpret', and load the returned
+        // value into the specified 'result'.  Return 'e_Success' on success,
+        // and a non-zero 'InterpretUtil::Status' value otherwise, in which
+        // case 'result' is unchanged.  In either case the stack of 'context'
+        // is restored to the size it had on entry.  The behavior is
+        // undefined unless 'isTranslated()'.
+
+    bool isTranslated() const;
+        // Return 'true' if this object holds a translated program, and
+        // 'false' otherwise.
+
+    bsl::size_t numInstructions() const;
+        // Return the number of instructions of the translated program, or 0
+        // if there is none.
+
+    const Instruction& instruction(bsl::size_t index) const;
+        // Return a reference to the instruction at the specified 'index'.
+        // The behavior is undefined unless 'index < numInstructions()'.
+
+    bsl::size_t numConstants() const;
+        // Return the number of constants of the translated program.
+
+    const Datum& constant(bsl::size_t index) const;
+        // Return a reference to the constant at the specified 'index'.  The
+        // behavior is undefined unless 'index < numConstants()'.
+
+    bsl::size_t numRegisters() const;
+        // Return the number of registers used by the translated program
+        // before its first call, or 0 if there is no program.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // ------------------
+                             // class RegisterCode
+                             // ------------------
+
+// ACCESSORS
+inline
+bool RegisterCode::isTranslated() const {
+    return !d_code.empty();
+}
+
+inline
+bsl::size_t RegisterCode::numInstructions() const {
+    return d_code.size();
+}
+
+inline
+const RegisterCode::Instruction&
+RegisterCode::instruction(bsl::size_t index) const {
+    BSLS_ASSERT_SAFE(index < d_code.size());
+    return d_code[index];
+}
+
+inline
+bsl::size_t RegisterCode::numConstants() const {
+    return d_constants.size();
+}
+
+inline
+const BloombergLP::bdld::Datum&
+RegisterCode::constant(bsl::size_t index) const {
+    BSLS_ASSERT_SAFE(index < d_constants.size());
+    return d_constants[index];
+}
+
+inline
+bsl::size_t RegisterCode::numRegisters() const {
+    return d_numRegisters;
+}
+}
+
+#endif
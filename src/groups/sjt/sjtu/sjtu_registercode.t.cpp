@@ -0,0 +1,634 @@
+// sjtu_registercode.t.cpp                                      -*-C++-*-
+
+#include <sjtu_registercode.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_executioncontext.h>
+#include <sjtt_typefeedback.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_interpretutil.h>
+
+#include <bdls_testutil.h>
+#include <bdlma_localsequentialallocator.h>
+#include <bslma_testallocator.h>
+
+#include <bsl_cstring.h>
+#include <bsl_sstream.h>
+#include <bsl_string.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+typedef RegisterCode   Obj;
+typedef sjtt::Bytecode Bytecode;
+
+namespace {
+
+bsl::string describe(const Obj& code)
+    // Return the instructions of the specified 'code', separated by "; ",
+    // each as its opcode followed by the operands it uses.
+{
+    bsl::ostringstream out;
+    for (bsl::size_t i = 0; i < code.numInstructions(); ++i) {
+        const Obj::Instruction& instruction = code.instruction(i);
+        const Obj::Opcode       opcode      =
+                            static_cast<Obj::Opcode>(instruction.d_opcode);
+        out << (i ? "; " : "") << Obj::toAscii(opcode) << ' '
+            << instruction.d_a;
+        switch (opcode) {
+          case Obj::e_Call:
+          case Obj::e_Return:
+          case Obj::e_ReturnConstant: {
+          } break;
+          case Obj::e_LoadConstant:
+          case Obj::e_GetGlobal:
+          case Obj::e_SetGlobal:
+          case Obj::e_SetGlobalConstant:
+          case Obj::e_SumArray: {
+            out << ' ' << instruction.d_b;
+          } break;
+          default: {
+            out << ' ' << instruction.d_b << ' ' << instruction.d_c;
+          } break;
+        }
+        if (Obj::e_Call == opcode) {
+            out << " (" << instruction.d_c << ')';
+        }
+    }
+    return out.str();
+}
+
+void subtract(sjtt::ExecutionContext *context)
+    // Pop two doubles from the stack of the specified 'context' and push the
+    // result of subtracting the top value from the one below it.
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    const double rhs = stack.back().theDouble();
+    stack.pop_back();
+    const double lhs = stack.back().theDouble();
+    stack.back() = bdld::Datum::createDouble(lhs - rhs);
+}
+
+void countStrings(sjtt::ExecutionContext *context)
+    // Pop the strings on the top of the stack of the specified 'context', and
+    // push '1000 * F + S', where 'F' is the number of them equal to "first"
+    // and 'S' the number equal to "second".
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    int                       count = 0;
+    while (!stack.empty() && stack.back().isString()) {
+        count += "first" == stack.back().theString() ? 1000 : 1;
+        stack.pop_back();
+    }
+    stack.push_back(bdld::Datum::createInteger(count));
+}
+
+void identity(sjtt::ExecutionContext *context)
+    // Pop a value from the stack of the specified 'context' and push it
+    // back.
+{
+    bsl::vector<bdld::Datum>& stack = *context->stack();
+    const bdld::Datum         value = stack.back();
+    stack.pop_back();
+    stack.push_back(value);
+}
+
+void discard(sjtt::ExecutionContext *context)
+    // Pop a value from the stack of the specified 'context' and push no
+    // result.
+{
+    context->stack()->pop_back();
+}
+
+void pushTwice(sjtt::ExecutionContext *context)
+    // Push two results, both 'null', onto the stack of the specified
+    // 'context'.
+{
+    context->stack()->push_back(bdld::Datum::createNull());
+    context->stack()->push_back(bdld::Datum::createNull());
+}
+
+void suspend(sjtt::ExecutionContext *context)
+    // Push 'null' onto the stack of the specified 'context' and suspend the
+    // program.
+{
+    context->stack()->push_back(bdld::Datum::createNull());
+    context->setStatus(InterpretUtil::e_Suspended);
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "calls and deep stacks" << endl
+                          << "=====================" << endl;
+
+        // The values below the result of a call survive it, on the stack of
+        // the context, while the registers outgrow the buffer of 'execute',
+        // including values referring to 'Datum' objects read from globals.
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            bsl::vector<bdld::Datum>        stack(&ta);
+            sjtt::ExecutionContext          context(&ta, &stack);
+            sjtt::ExecutionContext::Globals globals(&ta);
+            globals.resize(2);
+            context.setGlobals(&globals);
+
+            const bdld::Datum FIRST  = bdld::Datum::copyString("first", &ta);
+            const bdld::Datum SECOND = bdld::Datum::copyString("second",
+                                                               &ta);
+            globals[0].clone(FIRST);
+            globals[1].clone(SECOND);
+
+            const bdld::Datum SLOT0 = bdld::Datum::createInteger(0);
+            const bdld::Datum SLOT1 = bdld::Datum::createInteger(1);
+            const bdld::Datum COUNT =
+                          DatumUtil::createExternalFunction(&countStrings);
+
+            // Count 'depth' "second"s, read 'depth' "first"s, call
+            // 'identity', which leaves all but the last below its result,
+            // and count the "first"s.
+
+            for (int depth = 1; depth <= 150; depth += 149) {
+                bsl::vector<Bytecode> code;
+                code.push_back(Bytecode::createPush(
+                                            bdld::Datum::createDouble(7)));
+                for (int i = 0; i < depth; ++i) {
+                    code.push_back(Bytecode::create(Bytecode::e_GetGlobalSlot,
+                                                    SLOT1));
+                }
+                code.push_back(Bytecode::createPush(COUNT));
+                code.push_back(Bytecode::createOpcode(Bytecode::e_Execute));
+                for (int i = 0; i < depth; ++i) {
+                    code.push_back(Bytecode::create(Bytecode::e_GetGlobalSlot,
+                                                    SLOT0));
+                }
+                code.push_back(Bytecode::createPush(
+                            DatumUtil::createExternalFunction(&identity)));
+                code.push_back(Bytecode::createOpcode(Bytecode::e_Execute));
+                code.push_back(Bytecode::createPush(COUNT));
+                code.push_back(Bytecode::createOpcode(Bytecode::e_Execute));
+                code.push_back(Bytecode::createOpcode(Bytecode::e_Return));
+
+                Obj mX(&ta);  const Obj& X = mX;
+                ASSERTV(depth, 0 == mX.translate(code.data()));
+                ASSERTV(depth, depth + 2 == static_cast<int>(
+                                                         X.numRegisters()));
+
+                bdld::Datum result;
+                ASSERTV(depth, 0 == X.execute(&result, &context));
+                ASSERTV(depth, result,
+                        bdld::Datum::createInteger(1000 * depth) == result);
+                ASSERTV(depth, 0 == stack.size());
+
+                bdld::Datum expected;
+                ASSERTV(depth, 0 == InterpretUtil::interpret(&expected,
+                                                             &context,
+                                                             code.data()));
+                ASSERTV(depth, expected == result);
+            }
+            bdld::Datum::destroy(FIRST, &ta);
+            bdld::Datum::destroy(SECOND, &ta);
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "execution" << endl
+                          << "=========" << endl;
+
+        // Every translated program returns what 'InterpretUtil' returns.
+
+        bslma::TestAllocator ta(veryVerbose);
+        bdlma::LocalSequentialAllocator<4096> alloc(&ta);
+        bsl::vector<bdld::Datum> stack(&ta);
+        sjtt::ExecutionContext   context(&alloc, &stack);
+        sjtt::ExecutionContext::Globals globals(&ta);
+        globals.resize(2);
+        context.setGlobals(&globals);
+
+        bdld::DatumMutableArrayRef a;
+        bdld::DatumMutableArrayRef b;
+        bdld::Datum::createUninitializedArray(&a, 3, &ta);
+        bdld::Datum::createUninitializedArray(&b, 3, &ta);
+        for (int i = 0; i < 3; ++i) {
+            a.data()[i] = bdld::Datum::createDouble(i + 1);  // 1 2 3
+            b.data()[i] = bdld::Datum::createDouble(2);      // 2 2 2
+        }
+        *a.length() = 3;
+        *b.length() = 3;
+        const bdld::Datum A = bdld::Datum::adoptArray(a);
+        const bdld::Datum B = bdld::Datum::adoptArray(b);
+
+        const bdld::Datum ONE   = bdld::Datum::createDouble(1);
+        const bdld::Datum TWO   = bdld::Datum::createDouble(2);
+        const bdld::Datum INT   = bdld::Datum::createInteger(2);
+        const bdld::Datum SLOT0 = bdld::Datum::createInteger(0);
+        const bdld::Datum SUB   =
+                              DatumUtil::createExternalFunction(&subtract);
+
+        const Bytecode ADD = Bytecode::createOpcode(Bytecode::e_AddDoubles);
+        const Bytecode RET = Bytecode::createOpcode(Bytecode::e_Return);
+        const Bytecode POP = Bytecode::createOpcode(Bytecode::e_Pop);
+        const Bytecode EXE = Bytecode::createOpcode(Bytecode::e_Execute);
+
+        const Bytecode ADDS[] = {
+            Bytecode::createPush(ONE), Bytecode::createPush(TWO), ADD,
+            Bytecode::create(Bytecode::e_PushAddDoubles, TWO), RET
+        };
+        const Bytecode GLOBALS[] = {
+            Bytecode::createPush(TWO),
+            Bytecode::create(Bytecode::e_SetGlobalSlot, SLOT0),
+            Bytecode::create(Bytecode::e_GetGlobalSlot, SLOT0),
+            Bytecode::create(Bytecode::e_GetGlobalSlot, SLOT0), ADD,
+            Bytecode::create(Bytecode::e_SetGlobalSlot, SLOT0),
+            Bytecode::create(Bytecode::e_GetGlobalSlot, SLOT0), RET
+        };
+        const Bytecode ARRAYS[] = {  // 'sum(a * b + a) + dot(a + b, b)'
+            Bytecode::createPush(A), Bytecode::createPush(B),
+            Bytecode::createPush(A),
+            Bytecode::createOpcode(Bytecode::e_MultiplyAddArrays),
+            Bytecode::createOpcode(Bytecode::e_SumArray),
+            Bytecode::createPush(A), Bytecode::createPush(B),
+            Bytecode::createOpcode(Bytecode::e_AddArrays),
+            Bytecode::createPush(B),
+            Bytecode::createOpcode(Bytecode::e_DotArrays), ADD, RET
+        };
+        const Bytecode CALLS[] = {  // '10 - (1 + 2) - 2'
+            Bytecode::createPush(bdld::Datum::createDouble(10)),
+            Bytecode::createPush(ONE), Bytecode::createPush(TWO), ADD,
+            Bytecode::createPush(SUB), EXE,
+            Bytecode::createPush(TWO), Bytecode::createPush(SUB), EXE, RET
+        };
+        const Bytecode POPS[] = {
+            Bytecode::createPush(ONE), Bytecode::createPush(TWO), POP,
+            Bytecode::createPush(A), POP, RET
+        };
+        const Bytecode TYPE_ERROR[] = {
+            Bytecode::createPush(TWO), Bytecode::createPush(INT), ADD, RET
+        };
+        const Bytecode CONSTANT_ERROR[] = {
+            Bytecode::createPush(TWO),
+            Bytecode::create(Bytecode::e_PushAddDoubles, INT), RET
+        };
+        const Bytecode ARRAY_ERROR[] = {
+            Bytecode::createPush(A), Bytecode::createPush(ONE),
+            Bytecode::createOpcode(Bytecode::e_AddArrays), RET
+        };
+        const Bytecode NOT_CALLABLE[] = {
+            Bytecode::createPush(ONE), Bytecode::createPush(TWO), EXE, RET
+        };
+        const Bytecode SUSPENDED[] = {
+            Bytecode::createPush(
+                             DatumUtil::createExternalFunction(&suspend)),
+            EXE, RET
+        };
+        const Bytecode NO_RESULT[] = {
+            Bytecode::createPush(ONE),
+            Bytecode::createPush(DatumUtil::createExternalFunction(&discard)),
+            EXE, RET
+        };
+        const Bytecode TWO_RESULTS[] = {
+            Bytecode::createPush(
+                           DatumUtil::createExternalFunction(&pushTwice)),
+            EXE, RET
+        };
+
+        sjtt::TypeFeedback feedback;
+        const bdld::Datum  FEEDBACK = DatumUtil::createTypeFeedback(&feedback);
+        const bdld::Datum  MAX      = bdld::Datum::createInteger(0x7fffffff);
+        const Bytecode IADD = Bytecode::create(Bytecode::e_AddIntegers,
+                                               FEEDBACK);
+        const Bytecode ISUB = Bytecode::create(Bytecode::e_SubtractIntegers,
+                                               FEEDBACK);
+        const Bytecode IMUL = Bytecode::create(Bytecode::e_MultiplyIntegers,
+                                               FEEDBACK);
+        const Bytecode LESS = Bytecode::create(Bytecode::e_LessIntegers,
+                                               FEEDBACK);
+
+        const Bytecode INTEGERS[] = {  // '2 * 2 - 2 + 1.0'
+            Bytecode::createPush(INT), Bytecode::createPush(INT), IMUL,
+            Bytecode::createPush(INT), ISUB,
+            Bytecode::createPush(ONE), IADD, RET
+        };
+        const Bytecode COMPARE[] = {  // '2 < 2 * 2'
+            Bytecode::createPush(INT), Bytecode::createPush(INT),
+            Bytecode::createPush(INT), IMUL, LESS, RET
+        };
+        const Bytecode PROMOTED[] = {
+            Bytecode::createPush(MAX), Bytecode::createPush(INT), IADD, RET
+        };
+        const Bytecode INTEGER_ERROR[] = {
+            Bytecode::createPush(A), Bytecode::createPush(INT), IADD, RET
+        };
+
+        static const struct {
+            int             d_line;      // source line number
+            const Bytecode *d_code_p;    // program
+            int             d_status;    // expected status
+        } DATA[] = {
+            { L_, ADDS,           InterpretUtil::e_Success     },
+            { L_, GLOBALS,        InterpretUtil::e_Success     },
+            { L_, ARRAYS,         InterpretUtil::e_Success     },
+            { L_, CALLS,          InterpretUtil::e_Success     },
+            { L_, POPS,           InterpretUtil::e_Success     },
+            { L_, TYPE_ERROR,     InterpretUtil::e_TypeError   },
+            { L_, CONSTANT_ERROR, InterpretUtil::e_TypeError   },
+            { L_, ARRAY_ERROR,    InterpretUtil::e_TypeError   },
+            { L_, NOT_CALLABLE,   InterpretUtil::e_NotCallable },
+            { L_, SUSPENDED,      InterpretUtil::e_Suspended   },
+            { L_, NO_RESULT,      InterpretUtil::e_BadCall     },
+            { L_, TWO_RESULTS,    InterpretUtil::e_BadCall     },
+            { L_, INTEGERS,       InterpretUtil::e_Success     },
+            { L_, COMPARE,        InterpretUtil::e_Success     },
+            { L_, PROMOTED,       InterpretUtil::e_Success     },
+            { L_, INTEGER_ERROR,  InterpretUtil::e_TypeError   },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        for (int ti = 0; ti < NUM_DATA; ++ti) {
+            const int LINE = DATA[ti].d_line;
+
+            Obj mX(&ta);  const Obj& X = mX;
+            ASSERTV(LINE, 0 == mX.translate(DATA[ti].d_code_p));
+
+            globals[0].clone(ONE);
+            bdld::Datum expected = ONE;
+            const int   rc       = InterpretUtil::interpret(
+                                                         &expected,
+                                                         &context,
+                                                         DATA[ti].d_code_p);
+            ASSERTV(LINE, rc, DATA[ti].d_status == rc);
+
+            globals[0].clone(ONE);
+            bdld::Datum result = ONE;
+            ASSERTV(LINE, rc == X.execute(&result, &context));
+            ASSERTV(LINE, expected, result, expected == result);
+            ASSERTV(LINE, 0 == stack.size());
+            ASSERTV(LINE, 0 == context.status());
+
+            if (veryVerbose) {
+                T_ P_(LINE) P(describe(X))
+            }
+        }
+
+        globals.clear();
+        bdld::Datum::destroy(A, &ta);
+        bdld::Datum::destroy(B, &ta);
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "translation" << endl
+                          << "===========" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+
+        const bdld::Datum ONE   = bdld::Datum::createDouble(1);
+        const bdld::Datum SLOT0 = bdld::Datum::createInteger(0);
+        const bdld::Datum SLOT1 = bdld::Datum::createInteger(1);
+        const bdld::Datum SUB   =
+                              DatumUtil::createExternalFunction(&subtract);
+
+        const Bytecode PUSH = Bytecode::createPush(ONE);
+        const Bytecode ADD  = Bytecode::createOpcode(Bytecode::e_AddDoubles);
+        const Bytecode RET  = Bytecode::createOpcode(Bytecode::e_Return);
+        const Bytecode POP  = Bytecode::createOpcode(Bytecode::e_Pop);
+        const Bytecode EXE  = Bytecode::createOpcode(Bytecode::e_Execute);
+        const Bytecode GET0 = Bytecode::create(Bytecode::e_GetGlobalSlot,
+                                               SLOT0);
+        const Bytecode GET1 = Bytecode::create(Bytecode::e_GetGlobalSlot,
+                                               SLOT1);
+        const Bytecode SET1 = Bytecode::create(Bytecode::e_SetGlobalSlot,
+                                               SLOT1);
+        const Bytecode FUSED = Bytecode::create(Bytecode::e_PushAddDoubles,
+                                                ONE);
+        const Bytecode SUM  = Bytecode::createOpcode(Bytecode::e_SumArray);
+        const Bytecode MADD =
+                     Bytecode::createOpcode(Bytecode::e_MultiplyAddArrays);
+
+        if (verbose) cout << "\tConstants become operands." << endl;
+
+        const Bytecode P1[] = { PUSH, RET };
+        const Bytecode P2[] = { PUSH, PUSH, ADD, FUSED, RET };
+        const Bytecode P3[] = { GET0, GET1, ADD, PUSH, ADD, RET };
+        const Bytecode P4[] = { PUSH, SET1, GET0, SET1, GET0, RET };
+        const Bytecode P5[] = { PUSH, PUSH, POP, POP, GET1, RET };
+        const Bytecode P6[] = { GET0, GET1, GET0, MADD, SUM, RET };
+
+        if (verbose) cout << "\tCalls load their arguments." << endl;
+
+        const Bytecode P7[] = { PUSH, GET0, Bytecode::createPush(SUB), EXE,
+                                PUSH, PUSH, ADD, ADD, RET };
+        const Bytecode P8[] = { GET0, Bytecode::createPush(SUB), EXE,
+                                Bytecode::createPush(SUB), EXE, RET };
+
+        if (verbose) cout << "\tUntranslatable programs." << endl;
+
+        const Bytecode U1[] = { PUSH, ADD, RET };
+        const Bytecode U2[] = { RET };
+        const Bytecode U3[] = { PUSH, PUSH, Bytecode::createPush(SUB), EXE,
+                                ADD, RET };
+        const Bytecode U4[] = { PUSH, POP, POP, RET };
+        const Bytecode U5[] = {
+            Bytecode::create(Bytecode::e_GetGlobalSlot,
+                             bdld::Datum::createInteger(-1)),
+            RET
+        };
+        const Bytecode U6[] = {
+            Bytecode::create(Bytecode::e_GetGlobalSlot,
+                             bdld::Datum::createInteger(65536)),
+            RET
+        };
+        const Bytecode U7[] = {
+            Bytecode::createPush(bdld::Datum::createBoolean(true)),
+            Bytecode::create(Bytecode::e_JumpIfFalse,
+                             bdld::Datum::createInteger(2)),
+            PUSH,
+            PUSH,
+            RET
+        };
+
+        static const struct {
+            int             d_line;          // source line number
+            const Bytecode *d_code_p;        // program
+            const char     *d_expected_p;    // instructions, or 0 if the
+                                             // program is not translated
+            int             d_numRegisters;  // registers before any call
+        } DATA[] = {
+            { L_, P1, "ReturnConstant 0", 1 },
+            { L_, P2, "LoadConstant 0 0; AddDoublesConstant 0 0 1; "
+                      "AddDoublesConstant 0 0 2; Return 0", 2 },
+            { L_, P3, "GetGlobal 0 0; GetGlobal 1 1; AddDoubles 0 0 1; "
+                      "AddDoublesConstant 0 0 0; Return 0", 2 },
+            { L_, P4, "SetGlobalConstant 0 1; GetGlobal 0 0; "
+                      "SetGlobal 0 1; GetGlobal 0 0; Return 0", 1 },
+            { L_, P5, "GetGlobal 0 1; Return 0", 2 },
+            { L_, P6, "GetGlobal 0 0; GetGlobal 1 1; GetGlobal 2 0; "
+                      "MultiplyAddArrays 0 1 2; SumArray 0 0; Return 0", 3 },
+            { L_, P7, "GetGlobal 1 0; LoadConstant 0 0; LoadConstant 2 1; "
+                      "Call 2 (3); LoadConstant 1 2; "
+                      "AddDoublesConstant 1 1 3; AddDoubles 0 0 1; "
+                      "Return 0", 3 },
+            { L_, P8, "GetGlobal 0 0; LoadConstant 1 0; Call 1 (2); "
+                      "LoadConstant 1 1; Call 1 (1); Return 0", 2 },
+            { L_, U1, 0, 0 },
+            { L_, U2, 0, 0 },
+            { L_, U3, 0, 0 },
+            { L_, U4, 0, 0 },
+            { L_, U5, 0, 0 },
+            { L_, U6, 0, 0 },
+            { L_, U7, 0, 0 },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        for (int ti = 0; ti < NUM_DATA; ++ti) {
+            const int   LINE     = DATA[ti].d_line;
+            const char *EXPECTED = DATA[ti].d_expected_p;
+
+            Obj mX(&ta);  const Obj& X = mX;
+            const int rc = mX.translate(DATA[ti].d_code_p);
+            if (veryVerbose) {
+                T_ P_(LINE) P(describe(X))
+            }
+            if (EXPECTED) {
+                ASSERTV(LINE, 0 == rc);
+                ASSERTV(LINE, describe(X), EXPECTED == describe(X));
+                ASSERTV(LINE, X.numRegisters(),
+                        DATA[ti].d_numRegisters ==
+                                     static_cast<int>(X.numRegisters()));
+            }
+            else {
+                ASSERTV(LINE, 0 != rc);
+                ASSERTV(LINE, !X.isTranslated());
+                ASSERTV(LINE, 0 == X.numInstructions());
+                ASSERTV(LINE, 0 == X.numConstants());
+                ASSERTV(LINE, 0 == X.numRegisters());
+            }
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        {
+            bsl::vector<bdld::Datum> stack(&ta);
+            sjtt::ExecutionContext   context(&ta, &stack);
+
+            Obj mX(&ta);  const Obj& X = mX;
+            ASSERT(!X.isTranslated());
+            ASSERT(0 == X.numInstructions());
+            ASSERT(0 == X.numRegisters());
+
+            const Bytecode code[] = {
+                Bytecode::createPush(bdld::Datum::createDouble(1)),
+                Bytecode::createPush(bdld::Datum::createDouble(2)),
+                Bytecode::createOpcode(Bytecode::e_AddDoubles),
+                Bytecode::createOpcode(Bytecode::e_Return),
+            };
+            ASSERT(0 == mX.translate(code));
+            ASSERT(X.isTranslated());
+            ASSERT(3 == X.numInstructions());
+            ASSERT(2 == X.numConstants());
+            ASSERT(bdld::Datum::createDouble(2) == X.constant(1));
+            ASSERT(Obj::e_LoadConstant == X.instruction(0).d_opcode);
+            ASSERT(Obj::e_AddDoublesConstant == X.instruction(1).d_opcode);
+            ASSERT(Obj::e_Return == X.instruction(2).d_opcode);
+
+            bdld::Datum result;
+            ASSERT(0 == X.execute(&result, &context));
+            ASSERTV(result, bdld::Datum::createDouble(3) == result);
+            ASSERT(0 == stack.size());
+
+            mX.reset();
+            ASSERT(!X.isTranslated());
+            ASSERT(0 == X.numConstants());
+
+            ASSERT(0 == bsl::strcmp("LoadConstant",
+                                    Obj::toAscii(Obj::e_LoadConstant)));
+            ASSERT(0 == bsl::strcmp("ReturnConstant",
+                                    Obj::toAscii(Obj::e_ReturnConstant)));
+            ASSERT(0 == bsl::strcmp("(* UNKNOWN *)",
+                                    Obj::toAscii(static_cast<Obj::Opcode>(
+                                                       Obj::k_NUM_OPCODES))));
+            ASSERT(8 == sizeof(Obj::Instruction));
+        }
+        ASSERT(0 == ta.numBytesInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,21 @@
+// sjtu_value.cpp
+#include <sjtu_value.h>
+
+namespace sjtu {
+
+                                // -----------
+                                // class Value
+                                // -----------
+
+// PRIVATE CLASS DATA
+const Value::Uint64 Value::k_INTEGER;
+const Value::Uint64 Value::k_BOOLEAN;
+const Value::Uint64 Value::k_NULL;
+const Value::Uint64 Value::k_UNDEFINED;
+const Value::Uint64 Value::k_FUNCTION;
+const Value::Uint64 Value::k_REFERENCE;
+const Value::Uint64 Value::k_OBJECT;
+const Value::Uint64 Value::k_TAG_MASK;
+const Value::Uint64 Value::k_PAYLOAD_MASK;
+const Value::Uint64 Value::k_CANONICAL_NAN;
+}
@@ -0,0 +1,436 @@
+// sjtu_value.h
+
+#ifndef INCLUDED_SJTU_VALUE
+#define INCLUDED_SJTU_VALUE
+
+#ifndef INCLUDED_SJTU_DATUMUTIL
+#include <sjtu_datumutil.h>
+#endif
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTRING
+#include <bsl_cstring.h>
+#endif
+
+namespace sjtu {
+
+                                // ===========
+                                // class Value
+                                // ===========
+
+class Value {
+    // This class provides the 8-byte representation of the values
+    // manipulated by the interpreter, half the size of a 'bdld::Datum'.  A
+    // double is stored as itself; any other value is stored in the payload of
+    // a quiet NaN that arithmetic never produces ("NaN-boxing"): the 16 high
+    // bits hold a tag, and the 48 low bits an 'int', a 'bool', an external
+    // function, the address of an 'sjtt::Object', or the address of a
+    // 'Datum' holding any other value, e.g., a string or an array.  Null and
+    // undefined, i.e., 'DatumUtil::s_Null' and 'DatumUtil::s_Undefined',
+    // have tags of their own.
+    //
+    // 'createDouble' canonicalizes NaNs, so that no double is mistaken for a
+    // tagged value.  Since the NaNs produced by arithmetic on doubles are
+    // either the default NaN of the processor or one of their operands, the
+    // result of such arithmetic on doubles held by values can be stored with
+    // 'createRawDouble', without being checked.
+    //
+    // A value converted from a 'Datum' that is of none of the types above
+    // refers to that 'Datum' object, which must therefore outlive it; users
+    // needing a value that outlives the 'Datum' copy it somewhere that does.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum          Datum;
+    typedef BloombergLP::bsls::Types::Uint64  Uint64;
+
+  private:
+    // PRIVATE CLASS DATA
+    static const Uint64 k_INTEGER       = 0xFFF9000000000000ULL;
+    static const Uint64 k_BOOLEAN       = 0xFFFA000000000000ULL;
+    static const Uint64 k_NULL          = 0xFFFB000000000000ULL;
+    static const Uint64 k_UNDEFINED     = 0xFFFC000000000000ULL;
+    static const Uint64 k_FUNCTION      = 0xFFFD000000000000ULL;
+    static const Uint64 k_REFERENCE     = 0xFFFE000000000000ULL;
+    static const Uint64 k_OBJECT        = 0xFFFF000000000000ULL;
+    static const Uint64 k_TAG_MASK      = 0xFFFF000000000000ULL;
+    static const Uint64 k_PAYLOAD_MASK  = 0x0000FFFFFFFFFFFFULL;
+    static const Uint64 k_CANONICAL_NAN = 0x7FF8000000000000ULL;
+
+    // DATA
+    Uint64 d_bits;  // a double, or a tag and a payload
+
+    // PRIVATE CLASS METHODS
+    static Value createTagged(Uint64 tag, Uint64 payload);
+        // Return a value having the specified 'tag' and 'payload'.
+
+    static Value createPointer(Uint64 tag, const void *pointer);
+        // Return a value having the specified 'tag' and the specified
+        // 'pointer' as its payload.
+
+    // PRIVATE ACCESSORS
+    const void *thePointer() const;
+        // Return the payload of this value as a pointer.
+
+  public:
+    // CLASS METHODS
+    static Value createDouble(double value);
+        // Return a value holding the specified 'value', canonicalizing it if
+        // it is a NaN.
+
+    static Value createRawDouble(double value);
+        // Return a value holding the specified 'value' as is.  The behavior
+        // is undefined unless 'value' is not a NaN, or is the result of
+        // arithmetic on doubles held by values.
+
+    static Value createInteger(int value);
+        // Return a value holding the specified 'value'.
+
+    static Value createBoolean(bool value);
+        // Return a value holding the specified 'value'.
+
+    static Value createNull();
+        // Return a null value.
+
+    static Value createUndefined();
+        // Return an undefined value.
+
+    static Value createExternalFunction(DatumUtil::ExternalFunction function);
+        // Return a value referring to the specified 'function'.
+
+    static Value createObject(sjtt::Object *object);
+        // Return a value referring to the specified 'object'.
+
+    static Value createReference(const Datum *datum);
+        // Return a value referring to the specified 'datum', which is
+        // converted back by 'toDatum'.  The behavior is undefined unless
+        // 'datum' remains valid while the value is used.
+
+    static Value fromDatum(const Datum& datum);
+        // Return a value holding the specified 'datum', referring to 'datum'
+        // if it is neither a double, an 'int', a 'bool', null, undefined, an
+        // external function, nor an object.  The behavior is undefined
+        // unless 'datum' remains valid while the returned value is used, in
+        // the latter case.
+
+    // CREATORS
+    Value() = default;
+        // Create a value whose representation is unspecified.  The behavior
+        // is undefined unless the value is assigned before it is used.
+
+    // ACCESSORS
+    bool isDouble() const;
+        // Return 'true' if this value holds a double, and 'false' otherwise.
+
+    bool isInteger() const;
+        // Return 'true' if this value holds an 'int', and 'false' otherwise.
+
+    bool isBoolean() const;
+        // Return 'true' if this value holds a 'bool', and 'false' otherwise.
+
+    bool isNull() const;
+        // Return 'true' if this value is null, and 'false' otherwise.
+
+    bool isUndefined() const;
+        // Return 'true' if this value is undefined, and 'false' otherwise.
+
+    bool isExternalFunction() const;
+        // Return 'true' if this value refers to an external function, and
+        // 'false' otherwise.
+
+    bool isObject() const;
+        // Return 'true' if this value refers to an object, and 'false'
+        // otherwise.
+
+    bool isReference() const;
+        // Return 'true' if this value refers to a 'Datum', and 'false'
+        // otherwise.
+
+    double theDouble() const;
+        // Return the double held by this value.  The behavior is undefined
+        // unless 'isDouble()'.
+
+    int theInteger() const;
+        // Return the 'int' held by this value.  The behavior is undefined
+        // unless 'isInteger()'.
+
+    bool theBoolean() const;
+        // Return the 'bool' held by this value.  The behavior is undefined
+        // unless 'isBoolean()'.
+
+    DatumUtil::ExternalFunction theExternalFunction() const;
+        // Return the external function referred to by this value.  The
+        // behavior is undefined unless 'isExternalFunction()'.
+
+    sjtt::Object *theObject() const;
+        // Return the object referred to by this value.  The behavior is
+        // undefined unless 'isObject()'.
+
+    const Datum& theReference() const;
+        // Return the 'Datum' referred to by this value.  The behavior is
+        // undefined unless 'isReference()'.
+
+    Datum toDatum() const;
+        // Return this value as a 'Datum'.  A value referring to a 'Datum'
+        // returns a copy of that 'Datum', which refers to the same memory.
+
+    Uint64 bits() const;
+        // Return the representation of this value.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                                // -----------
+                                // class Value
+                                // -----------
+
+// PRIVATE CLASS METHODS
+inline
+Value Value::createTagged(Uint64 tag, Uint64 payload) {
+    Value result;
+    result.d_bits = tag | payload;
+    return result;
+}
+
+inline
+Value Value::createPointer(Uint64 tag, const void *pointer) {
+    const Uint64 address =
+                  reinterpret_cast<BloombergLP::bsls::Types::UintPtr>(pointer);
+    BSLS_ASSERT_SAFE(0 == (address & k_TAG_MASK));
+    return createTagged(tag, address);
+}
+
+// PRIVATE ACCESSORS
+inline
+const void *Value::thePointer() const {
+    return reinterpret_cast<const void *>(
+              static_cast<BloombergLP::bsls::Types::UintPtr>(
+                                                   d_bits & k_PAYLOAD_MASK));
+}
+
+// CLASS METHODS
+inline
+Value Value::createDouble(double value) {
+    Value result;
+    bsl::memcpy(&result.d_bits, &value, sizeof value);
+    if (result.d_bits >= k_INTEGER) {
+        result.d_bits = k_CANONICAL_NAN;
+    }
+    return result;
+}
+
+inline
+Value Value::createRawDouble(double value) {
+    Value result;
+    bsl::memcpy(&result.d_bits, &value, sizeof value);
+    BSLS_ASSERT_SAFE(result.isDouble());
+    return result;
+}
+
+inline
+Value Value::createInteger(int value) {
+    return createTagged(k_INTEGER,
+                        static_cast<BloombergLP::bsls::Types::Uint64>(
+                                               static_cast<unsigned>(value)));
+}
+
+inline
+Value Value::createBoolean(bool value) {
+    return createTagged(k_BOOLEAN, value ? 1 : 0);
+}
+
+inline
+Value Value::createNull() {
+    return createTagged(k_NULL, 0);
+}
+
+inline
+Value Value::createUndefined() {
+    return createTagged(k_UNDEFINED, 0);
+}
+
+inline
+Value Value::createExternalFunction(DatumUtil::ExternalFunction function) {
+    BSLS_ASSERT_SAFE(0 != function);
+    return createPointer(k_FUNCTION, reinterpret_cast<const void *>(function));
+}
+
+inline
+Value Value::createObject(sjtt::Object *object) {
+    BSLS_ASSERT_SAFE(0 != object);
+    return createPointer(k_OBJECT, object);
+}
+
+inline
+Value Value::createReference(const Datum *datum) {
+    BSLS_ASSERT_SAFE(0 != datum);
+    return createPointer(k_REFERENCE, datum);
+}
+
+inline
+Value Value::fromDatum(const Datum& datum) {
+    switch (datum.type()) {
+      case Datum::e_DOUBLE: {
+        return createDouble(datum.theDouble());                       // RETURN
+      }
+      case Datum::e_INTEGER: {
+        return createInteger(datum.theInteger());                     // RETURN
+      }
+      case Datum::e_BOOLEAN: {
+        return createBoolean(datum.theBoolean());                     // RETURN
+      }
+      case Datum::e_NIL: {
+        return createNull();                                          // RETURN
+      }
+      case Datum::e_USERDEFINED: {
+        const int type = datum.theUdt().type();
+        if (DatumUtil::e_ExternalFunction == type) {
+            return createExternalFunction(
+                                DatumUtil::theExternalFunction(datum));
+                                                                      // RETURN
+        }
+        if (DatumUtil::e_Undefined == type) {
+            return createUndefined();                                 // RETURN
+        }
+        if (DatumUtil::e_Object == type) {
+            return createObject(DatumUtil::theObject(datum));         // RETURN
+        }
+      } break;
+      default: {
+      } break;
+    }
+    return createReference(&datum);
+}
+
+// ACCESSORS
+inline
+bool Value::isDouble() const {
+    return d_bits < k_INTEGER;
+}
+
+inline
+bool Value::isInteger() const {
+    return k_INTEGER == (d_bits & k_TAG_MASK);
+}
+
+inline
+bool Value::isBoolean() const {
+    return k_BOOLEAN == (d_bits & k_TAG_MASK);
+}
+
+inline
+bool Value::isNull() const {
+    return k_NULL == d_bits;
+}
+
+inline
+bool Value::isUndefined() const {
+    return k_UNDEFINED == d_bits;
+}
+
+inline
+bool Value::isExternalFunction() const {
+    return k_FUNCTION == (d_bits & k_TAG_MASK);
+}
+
+inline
+bool Value::isObject() const {
+    return k_OBJECT == (d_bits & k_TAG_MASK);
+}
+
+inline
+bool Value::isReference() const {
+    return k_REFERENCE == (d_bits & k_TAG_MASK);
+}
+
+inline
+double Value::theDouble() const {
+    BSLS_ASSERT_SAFE(isDouble());
+    double result;
+    bsl::memcpy(&result, &d_bits, sizeof result);
+    return result;
+}
+
+inline
+int Value::theInteger() const {
+    BSLS_ASSERT_SAFE(isInteger());
+    return static_cast<int>(static_cast<unsigned>(d_bits));
+}
+
+inline
+bool Value::theBoolean() const {
+    BSLS_ASSERT_SAFE(isBoolean());
+    return 0 != (d_bits & 1);
+}
+
+inline
+DatumUtil::ExternalFunction Value::theExternalFunction() const {
+    BSLS_ASSERT_SAFE(isExternalFunction());
+    return reinterpret_cast<DatumUtil::ExternalFunction>(
+                                            const_cast<void *>(thePointer()));
+}
+
+inline
+sjtt::Object *Value::theObject() const {
+    BSLS_ASSERT_SAFE(isObject());
+    return static_cast<sjtt::Object *>(const_cast<void *>(thePointer()));
+}
+
+inline
+const BloombergLP::bdld::Datum& Value::theReference() const {
+    BSLS_ASSERT_SAFE(isReference());
+    return *static_cast<const Datum *>(thePointer());
+}
+
+inline
+BloombergLP::bdld::Datum Value::toDatum() const {
+    if (isDouble()) {
+        return Datum::createDouble(theDouble());                      // RETURN
+    }
+    switch (d_bits & k_TAG_MASK) {
+      case k_INTEGER: {
+        return Datum::createInteger(theInteger());                    // RETURN
+      }
+      case k_BOOLEAN: {
+        return Datum::createBoolean(theBoolean());                    // RETURN
+      }
+      case k_NULL: {
+        return Datum::createNull();                                   // RETURN
+      }
+      case k_UNDEFINED: {
+        return DatumUtil::s_Undefined;                                // RETURN
+      }
+      case k_FUNCTION: {
+        return DatumUtil::createExternalFunction(theExternalFunction());
+                                                                      // RETURN
+      }
+      case k_OBJECT: {
+        return DatumUtil::createObject(theObject());                  // RETURN
+      }
+      default: {
+        BSLS_ASSERT_SAFE(isReference());
+      } break;
+    }
+    return theReference();
+}
+
+inline
+Value::Uint64 Value::bits() const {
+    return d_bits;
+}
+}
+
+#endif
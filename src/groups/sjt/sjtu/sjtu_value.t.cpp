@@ -0,0 +1,260 @@
+// sjtu_value.t.cpp                                         -*-C++-*-
+
+#include <sjtu_value.h>
+
+#include <sjtu_datumutil.h>
+
+#include <sjtt_object.h>
+#include <sjtt_shape.h>
+
+#include <bdls_testutil.h>
+#include <bslma_testallocator.h>
+
+#include <bsl_limits.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ============================================================================
+//                    GLOBAL HELPER FUNCTIONS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+void noop(sjtt::ExecutionContext *)
+    // Do nothing.
+{
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "conversion from and to Datum" << endl
+                          << "============================" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+
+        const bdld::Datum IMMEDIATES[] = {
+            bdld::Datum::createDouble(2.5),
+            bdld::Datum::createDouble(-0.0),
+            bdld::Datum::createInteger(-7),
+            bdld::Datum::createBoolean(true),
+            bdld::Datum::createBoolean(false),
+            DatumUtil::s_Null,
+            DatumUtil::s_Undefined,
+            DatumUtil::createExternalFunction(&noop),
+        };
+        const int NUM_IMMEDIATES = sizeof IMMEDIATES / sizeof *IMMEDIATES;
+
+        for (int i = 0; i < NUM_IMMEDIATES; ++i) {
+            const bdld::Datum& D = IMMEDIATES[i];
+            const Value        X = Value::fromDatum(D);
+            ASSERTV(i, !X.isReference());
+            ASSERTV(i, D == X.toDatum());
+        }
+        ASSERT(Value::fromDatum(IMMEDIATES[6]).isUndefined());
+        ASSERT(Value::fromDatum(IMMEDIATES[7]).isExternalFunction());
+        ASSERT(&noop == Value::fromDatum(IMMEDIATES[7]).theExternalFunction());
+        ASSERT(0 == ta.numBytesInUse());
+
+        // Objects are held by address, like external functions.
+
+        {
+            bslma::TestAllocator  oa(veryVerbose);
+            sjtt::ShapeTable      shapes(&oa);
+            sjtt::Object         *object = sjtt::Object::create(shapes.root(),
+                                                                &oa);
+            const bdld::Datum     D      = DatumUtil::createObject(object);
+            const Value           X      = Value::fromDatum(D);
+            ASSERT(X.isObject());
+            ASSERT(!X.isReference());
+            ASSERT(!X.isDouble());
+            ASSERT(object == X.theObject());
+            ASSERT(D == X.toDatum());
+            ASSERT(X.bits() == Value::createObject(object).bits());
+            sjtt::Object::destroy(object, &oa);
+        }
+
+        // Any other 'Datum' is referred to in place.
+
+        const bdld::Datum STRING = bdld::Datum::copyString(
+                                   "a string longer than a Datum holds", &ta);
+        const Value X = Value::fromDatum(STRING);
+        ASSERT(X.isReference());
+        ASSERT(&STRING == &X.theReference());
+        ASSERT(STRING == X.toDatum());
+
+        ASSERT(STRING.theString().data() ==
+                                      X.toDatum().theString().data());
+
+        const bdld::Datum COPY = STRING;
+        const Value       Y    = Value::createReference(&COPY);
+        ASSERT(&COPY == &Y.theReference());
+        ASSERT(STRING == Y.toDatum());
+
+        const bdld::Datum ERROR = bdld::Datum::createError(3);
+        ASSERT(Value::fromDatum(ERROR).isReference());
+        ASSERT(ERROR == Value::fromDatum(ERROR).toDatum());
+
+        bdld::Datum::destroy(STRING, &ta);
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "doubles and NaNs" << endl
+                          << "================" << endl;
+
+        const double VALUES[] = {
+            0.0,
+            -0.0,
+            1.5,
+            -1e300,
+            bsl::numeric_limits<double>::infinity(),
+            -bsl::numeric_limits<double>::infinity(),
+            bsl::numeric_limits<double>::denorm_min(),
+        };
+        const int NUM_VALUES = sizeof VALUES / sizeof *VALUES;
+
+        for (int i = 0; i < NUM_VALUES; ++i) {
+            const Value X = Value::createDouble(VALUES[i]);
+            ASSERTV(i, X.isDouble());
+            ASSERTV(i, !X.isInteger() && !X.isReference());
+            ASSERTV(i, VALUES[i] == X.theDouble());
+            ASSERTV(i, X.bits() == Value::createRawDouble(VALUES[i]).bits());
+        }
+
+        // Every NaN is canonicalized, including those whose bits are those
+        // of a tagged value.
+
+        const Value::Uint64 NANS[] = {
+            0x7FF8000000000000ULL,
+            0xFFF8000000000000ULL,
+            0x7FF0000000000001ULL,
+            0xFFF9000000000007ULL,
+            0xFFFE000012345678ULL,
+            0xFFFFFFFFFFFFFFFFULL,
+        };
+        const int NUM_NANS = sizeof NANS / sizeof *NANS;
+
+        for (int i = 0; i < NUM_NANS; ++i) {
+            double nan;
+            bsl::memcpy(&nan, &NANS[i], sizeof nan);
+            const Value X = Value::createDouble(nan);
+            ASSERTV(i, X.isDouble());
+            ASSERTV(i, X.theDouble() != X.theDouble());
+        }
+
+        // Arithmetic on values yields values.
+
+        const double inf = bsl::numeric_limits<double>::infinity();
+        const Value  X   = Value::createRawDouble(
+                                 Value::createDouble(inf).theDouble() - inf);
+        ASSERT(X.isDouble());
+        ASSERT(X.theDouble() != X.theDouble());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        ASSERT(8 == sizeof(Value));
+
+        const Value I = Value::createInteger(-42);
+        ASSERT(I.isInteger());
+        ASSERT(!I.isDouble() && !I.isBoolean() && !I.isReference());
+        ASSERT(-42 == I.theInteger());
+        ASSERT(bdld::Datum::createInteger(-42) == I.toDatum());
+
+        const Value B = Value::createBoolean(true);
+        ASSERT(B.isBoolean());
+        ASSERT(B.theBoolean());
+        ASSERT(!Value::createBoolean(false).theBoolean());
+
+        ASSERT(Value::createNull().isNull());
+        ASSERT(!Value::createNull().isUndefined());
+        ASSERT(DatumUtil::s_Null == Value::createNull().toDatum());
+        ASSERT(Value::createUndefined().isUndefined());
+        ASSERT(DatumUtil::s_Undefined == Value::createUndefined().toDatum());
+
+        const Value F = Value::createExternalFunction(&noop);
+        ASSERT(F.isExternalFunction());
+        ASSERT(&noop == F.theExternalFunction());
+        ASSERT(DatumUtil::createExternalFunction(&noop) == F.toDatum());
+
+        const Value D = Value::createDouble(3.25);
+        ASSERT(D.isDouble());
+        ASSERT(3.25 == D.theDouble());
+        ASSERT(bdld::Datum::createDouble(3.25) == D.toDatum());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,871 @@
+// sjtu_verifyutil.cpp
+#include <sjtu_verifyutil.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_program.h>
+#include <sjtt_programimage.h>
+#include <sjtu_datumutil.h>
+#include <sjtu_interpretutil.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_cstddef.h>
+#include <bsl_vector.h>
+
+namespace sjtu {
+using BloombergLP::bdld::Datum;
+using sjtt::Bytecode;
+using sjtt::Program;
+using sjtt::ProgramImage;
+
+namespace {
+
+enum Kind {
+    // Enumeration used to describe what is known of the type of a value on
+    // the stack.
+
+    e_Unknown,
+    e_Double,
+    e_Integer,
+    e_Number,    // a double or an integer
+    e_Boolean,
+    e_Array,
+    e_Function,
+    e_Object,
+    e_Other
+};
+
+Kind kindOf(const Datum& value)
+    // Return the 'Kind' of the specified 'value'.
+{
+    if (value.isDouble()) {
+        return e_Double;                                              // RETURN
+    }
+    if (value.isInteger()) {
+        return e_Integer;                                             // RETURN
+    }
+    if (value.isBoolean()) {
+        return e_Boolean;                                             // RETURN
+    }
+    if (value.isArray()) {
+        return e_Array;                                               // RETURN
+    }
+    if (DatumUtil::isExternalFunction(value)) {
+        return e_Function;                                            // RETURN
+    }
+    if (DatumUtil::isObject(value)) {
+        return e_Object;                                              // RETURN
+    }
+    return e_Other;
+}
+
+bool isDouble(Kind kind)
+    // Return 'true' if the specified 'kind' may be that of a double, and
+    // 'false' otherwise.
+{
+    return e_Unknown == kind || e_Double == kind || e_Number == kind;
+}
+
+bool isNumber(Kind kind)
+    // Return 'true' if the specified 'kind' may be that of a number, and
+    // 'false' otherwise.
+{
+    return isDouble(kind) || e_Integer == kind;
+}
+
+bool isBoolean(Kind kind)
+    // Return 'true' if the specified 'kind' may be that of a boolean, and
+    // 'false' otherwise.
+{
+    return e_Unknown == kind || e_Boolean == kind;
+}
+
+bool isArray(Kind kind)
+    // Return 'true' if the specified 'kind' may be that of an array, and
+    // 'false' otherwise.
+{
+    return e_Unknown == kind || e_Array == kind;
+}
+
+bool isObject(Kind kind)
+    // Return 'true' if the specified 'kind' may be that of an object, and
+    // 'false' otherwise.
+{
+    return e_Unknown == kind || e_Object == kind;
+}
+
+Kind joinKinds(Kind lhs, Kind rhs)
+    // Return what is known of a value of the specified 'lhs' kind along one
+    // path and of the specified 'rhs' kind along another.
+{
+    if (lhs == rhs) {
+        return lhs;                                                   // RETURN
+    }
+    if (e_Unknown != lhs && isNumber(lhs) && e_Unknown != rhs
+                                                        && isNumber(rhs)) {
+        return e_Number;                                              // RETURN
+    }
+    return e_Unknown;
+}
+
+bool isSlot(const Datum& value)
+    // Return 'true' if the specified 'value' is a valid global slot index,
+    // and 'false' otherwise.
+{
+    return value.isInteger() && 0 <= value.theInteger();
+}
+
+bool isArgumentCount(const Datum& value)
+    // Return 'true' if the specified 'value' is a valid number of arguments
+    // of a script function, and 'false' otherwise.
+{
+    return value.isInteger() && 0 <= value.theInteger();
+}
+
+class BytecodeAccessor {
+    // This class provides access to the instructions in an array of
+    // 'Bytecode' objects.
+
+    // DATA
+    const Bytecode *d_code;
+
+  public:
+    // CREATORS
+    explicit BytecodeAccessor(const Bytecode *code)
+    : d_code(code) {
+    }
+
+    // ACCESSORS
+    int opcode(bsl::size_t index) const {
+        return d_code[index].opcode();
+    }
+
+    const Datum& data(bsl::size_t index) const {
+        return d_code[index].data();
+    }
+
+    bool hasValidOperand(bsl::size_t) const {
+        return true;
+    }
+};
+
+template <class PROGRAM>
+class ProgramAccessor {
+    // This class provides access to the instructions in a 'Program' or a
+    // 'ProgramImage'.
+
+    // DATA
+    const PROGRAM *d_program_p;
+
+  public:
+    // CREATORS
+    explicit ProgramAccessor(const PROGRAM *program)
+    : d_program_p(program) {
+    }
+
+    // ACCESSORS
+    int opcode(bsl::size_t index) const {
+        return d_program_p->opcodes()[index];
+    }
+
+    const Datum& data(bsl::size_t index) const {
+        return d_program_p->constant(d_program_p->operand(index));
+    }
+
+    bool hasValidOperand(bsl::size_t index) const {
+        // Return 'true' if the operand of the instruction at the specified
+        // 'index' is an index into the constant pool, and 'false'
+        // otherwise.
+
+        return d_program_p->operand(index) < d_program_p->numConstants();
+    }
+};
+
+class AbstractStack {
+    // This class models the stack of a program under verification at one
+    // instruction, in the code outside of any script function or in the
+    // frame of one, whose arguments and linkage are never popped.
+
+    // DATA
+    bsl::vector<Kind> d_kinds;         // tracked values, bottom to top
+    bsl::size_t       d_depth;         // most values the stack may hold
+    bsl::size_t       d_minDepth;      // fewest values the stack may hold
+    bsl::size_t       d_floor;         // arguments and linkage of the frame
+    bsl::size_t       d_function;      // index of the 'e_Function', or 0
+    int               d_numArguments;  // of the function, or -1 if none
+    bool              d_open;          // untracked values may be below
+
+  public:
+    // CREATORS
+    AbstractStack()
+    : d_depth(0)
+    , d_minDepth(0)
+    , d_floor(0)
+    , d_function(0)
+    , d_numArguments(-1)
+    , d_open(false) {
+    }
+
+    // MANIPULATORS
+    void enterFunction(bsl::size_t function, int numArguments) {
+        // Make this stack that of the script function whose 'e_Function',
+        // taking 'numArguments', is at the 'function' index, on entry.
+
+        d_kinds.clear();
+        d_floor        = numArguments + InterpretUtil::k_FRAME_LINKAGE;
+        d_depth        = d_floor;
+        d_minDepth     = d_floor;
+        d_function     = function;
+        d_numArguments = numArguments;
+        d_open         = false;
+    }
+
+    void push(Kind kind) {
+        d_kinds.push_back(kind);
+        ++d_depth;
+        ++d_minDepth;
+    }
+
+    int pop(Kind *kind) {
+        // Load into the specified 'kind' what is known of the popped value.
+        // Return 0 on success, and a non-zero value if the stack may
+        // underflow, i.e., if the value may have been popped by an external
+        // function called earlier, or was never pushed.
+
+        if (d_minDepth <= d_floor) {
+            return 1;                                                 // RETURN
+        }
+        if (!d_kinds.empty()) {
+            *kind = d_kinds.back();
+            d_kinds.pop_back();
+        }
+        else {
+            *kind = e_Unknown;
+        }
+        --d_depth;
+        --d_minDepth;
+        return 0;
+    }
+
+    int getLocal(Kind *kind, int slot) const {
+        // Load into the specified 'kind' what is known of the value of the
+        // specified 'slot' of the frame.  Return 0 on success, and a
+        // non-zero value if 'slot' is not in the frame.
+
+        if (slot < 0) {
+            if (-slot > d_numArguments) {
+                return 1;                                             // RETURN
+            }
+            *kind = e_Unknown;
+            return 0;                                                 // RETURN
+        }
+        if (static_cast<bsl::size_t>(slot) >= d_minDepth - d_floor) {
+            return 1;                                                 // RETURN
+        }
+        *kind = d_open ? e_Unknown : d_kinds[slot];
+        return 0;
+    }
+
+    int setLocal(int slot, Kind kind) {
+        // Record that the specified 'slot' of the frame holds a value of the
+        // specified 'kind'.  Return 0 on success, and a non-zero value if
+        // 'slot' is not in the frame.
+
+        Kind old;
+        if (0 != getLocal(&old, slot)) {
+            return 1;                                                 // RETURN
+        }
+        if (0 <= slot && !d_open) {
+            d_kinds[slot] = kind;
+        }
+        return 0;
+    }
+
+    void call() {
+        // Replace the tracked values with the untyped result of a call of an
+        // external function.  The function may pop any of the values of the
+        // frame, as its arguments, but none below it, so only its result is
+        // known to be on the stack afterwards.
+
+        d_kinds.clear();
+        d_minDepth = d_floor;
+        d_open     = true;
+        push(e_Unknown);
+    }
+
+    int join(bool *changed, const AbstractStack& other) {
+        // Merge into this stack the specified 'other' stack of the same
+        // instruction, reached along another path, and load into the
+        // specified 'changed' whether this stack was modified.  Return 0 on
+        // success, and a non-zero value if the stacks have different depths.
+
+        if (d_depth != other.d_depth) {
+            return 1;                                                 // RETURN
+        }
+        *changed = false;
+        if (other.d_minDepth < d_minDepth) {
+            d_minDepth = other.d_minDepth;
+            *changed   = true;
+        }
+        if (other.d_open && !d_open) {
+            d_open   = true;
+            *changed = true;
+        }
+        const bsl::size_t size = bsl::min(d_kinds.size(),
+                                          other.d_kinds.size());
+        if (size < d_kinds.size()) {
+            d_kinds.erase(d_kinds.begin(),
+                          d_kinds.begin() + (d_kinds.size() - size));
+            *changed = true;
+        }
+        const Kind *otherKinds = other.d_kinds.data() +
+                                                  other.d_kinds.size() - size;
+        for (bsl::size_t i = 0; i < size; ++i) {
+            const Kind kind = joinKinds(d_kinds[i], otherKinds[i]);
+            if (kind != d_kinds[i]) {
+                d_kinds[i] = kind;
+                *changed   = true;
+            }
+        }
+        return 0;
+    }
+
+    // ACCESSORS
+    bsl::size_t depth() const {
+        return d_depth;
+    }
+
+    bsl::size_t function() const {
+        return d_function;
+    }
+
+    bool isInFunction() const {
+        return 0 <= d_numArguments;
+    }
+};
+
+class Worklist {
+    // This class records the stack on entry to each target of a branch, as
+    // the join of the stacks of the paths reaching it so far, and the
+    // targets whose stack changed since they were last checked.
+
+    // DATA
+    bsl::vector<AbstractStack> d_entries;    // stacks, indexed by target
+    bsl::vector<char>          d_isReached;  // stack in 'd_entries' is set
+    bsl::vector<char>          d_isPending;  // target must be checked
+    bsl::size_t                d_first;      // no pending target below
+
+  public:
+    // CREATORS
+    explicit Worklist(bsl::size_t numCodes)
+    : d_entries(numCodes)
+    , d_isReached(numCodes, 0)
+    , d_isPending(numCodes, 0)
+    , d_first(numCodes) {
+    }
+
+    // MANIPULATORS
+    int enter(bsl::size_t index, const AbstractStack& stack) {
+        // Record that the target at the specified 'index' is reached with
+        // the specified 'stack'.  Return 0 on success, and a non-zero value
+        // if 'stack' does not have the depth with which 'index' was reached
+        // before.
+
+        bool changed = true;
+        if (!d_isReached[index]) {
+            d_entries[index]   = stack;
+            d_isReached[index] = 1;
+        }
+        else if (0 != d_entries[index].join(&changed, stack)) {
+            return 1;                                                 // RETURN
+        }
+        if (changed) {
+            d_isPending[index] = 1;
+            d_first            = bsl::min(d_first, index);
+        }
+        return 0;
+    }
+
+    bool next(bsl::size_t *index, AbstractStack *stack) {
+        // Load into the specified 'index' and 'stack' the lowest pending
+        // target and its stack, and return 'true', or return 'false' if no
+        // target is pending.
+
+        while (d_first < d_isPending.size() && !d_isPending[d_first]) {
+            ++d_first;
+        }
+        if (d_isPending.size() == d_first) {
+            return false;                                             // RETURN
+        }
+        *index = d_first;
+        *stack = d_entries[d_first];
+        d_isPending[d_first] = 0;
+        return true;
+    }
+};
+
+template <class ACCESSOR>
+int findTarget(bsl::size_t     *target,
+               const ACCESSOR&  code,
+               bsl::size_t      numCodes,
+               bsl::size_t      index)
+    // Load into the specified 'target' the index of the instruction to which
+    // the branch or call at the specified 'index' of the specified 'numCodes'
+    // instructions accessed through the specified 'code' jumps.  Return 0 on
+    // success, and a non-zero value if the data of the branch is not an
+    // offset, in the direction of the branch, to an instruction of the
+    // program, if an 'e_Loop' does not jump to an 'e_LoopHeader', or if a
+    // call does not jump to an 'e_Function' having a valid number of
+    // arguments.
+{
+    const Datum& data = code.data(index);
+    if (!data.isInteger()) {
+        return 1;                                                     // RETURN
+    }
+    const int            opcode = code.opcode(index);
+    const bool           isLoop = Bytecode::e_Loop == opcode;
+    const bool           isCall = Bytecode::e_Call     == opcode
+                               || Bytecode::e_TailCall == opcode;
+    const bsl::ptrdiff_t offset = data.theInteger();
+    if (0 == offset || (!isCall && (isLoop ? 0 < offset : 0 > offset))) {
+        return 1;                                                     // RETURN
+    }
+    if (0 > offset ? static_cast<bsl::size_t>(-offset) > index
+                   : static_cast<bsl::size_t>(offset) >= numCodes - index) {
+        return 1;                                                     // RETURN
+    }
+    *target = index + offset;
+    if (isLoop && Bytecode::e_LoopHeader != code.opcode(*target)) {
+        return 1;                                                     // RETURN
+    }
+    if (isCall && (Bytecode::e_Function != code.opcode(*target)
+                || !code.hasValidOperand(*target)
+                || !isArgumentCount(code.data(*target)))) {
+        return 1;                                                     // RETURN
+    }
+    return 0;
+}
+
+int claim(bsl::vector<bsl::size_t> *owners,
+          bsl::size_t               index,
+          const AbstractStack&      stack)
+    // Record in the specified 'owners' that the instruction at the specified
+    // 'index' is reached with the specified 'stack', and so belongs to its
+    // function.  Return 0 on success, and a non-zero value if the
+    // instruction belongs to another function, or to none if 'stack' is in
+    // one.
+{
+    bsl::size_t& owner = (*owners)[index];
+    if (owners->size() == owner) {
+        owner = stack.function();
+    }
+    return owner == stack.function() ? 0 : 1;
+}
+
+template <class ACCESSOR>
+int verifyImp(bsl::size_t     *maxDepth,
+              bsl::size_t     *errorIndex,
+              const ACCESSOR&  code,
+              bsl::size_t      numCodes)
+    // Verify the specified 'numCodes' instructions accessed through the
+    // specified 'code', loading the results into the specified 'maxDepth' or
+    // 'errorIndex' as described for 'VerifyUtil::verify'.
+{
+    // The instructions are checked along every path from the first one.
+    // Each target of a branch or call (and the first instruction) is
+    // checked, lowest index first, again whenever its stack in 'worklist'
+    // changes, followed by the instructions up to the next target or the end
+    // of the path; every other instruction is checked with the stack left by
+    // the one before it.  A call continues the path of the caller, and makes
+    // the 'e_Function' it targets a target entered with the frame of the
+    // function.  'owners' records the function of each instruction reached,
+    // to keep the code of each function apart.
+
+    if (0 == numCodes) {
+        *errorIndex = 0;
+        return VerifyUtil::e_MissingReturn;                           // RETURN
+    }
+
+    bsl::vector<char> isTarget(numCodes, 0);
+    for (bsl::size_t i = 0; i < numCodes; ++i) {
+        const int   opcode = code.opcode(i);
+        bsl::size_t target;
+        if (0 <= opcode
+         && Bytecode::k_NUM_OPCODES > opcode
+         && (Bytecode::isBranch(static_cast<Bytecode::Opcode>(opcode))
+          || Bytecode::isCall(static_cast<Bytecode::Opcode>(opcode)))
+         && code.hasValidOperand(i)
+         && 0 == findTarget(&target, code, numCodes, i)) {
+            isTarget[target] = 1;
+        }
+    }
+
+    Worklist                 worklist(numCodes);
+    bsl::vector<bsl::size_t> owners(numCodes, numCodes);
+    AbstractStack            stack;
+    AbstractStack            entry;
+    bsl::size_t              depth = 0;
+    bsl::size_t              i;
+    claim(&owners, 0, stack);
+    worklist.enter(0, stack);
+
+    while (worklist.next(&i, &stack)) {
+        for (;;) {
+            const int opcode = code.opcode(i);
+            if (0 != claim(&owners, i, stack)) {
+                *errorIndex = i;
+                return VerifyUtil::e_InvalidFrame;                    // RETURN
+            }
+            if (0 <= opcode
+             && Bytecode::k_NUM_OPCODES > opcode
+             && Bytecode::hasData(static_cast<Bytecode::Opcode>(opcode))
+             && !code.hasValidOperand(i)) {
+                *errorIndex = i;
+                return VerifyUtil::e_InvalidOperand;                  // RETURN
+            }
+
+            Kind        lhs;
+            Kind        rhs;
+            bsl::size_t target        = 0;
+            bool        isBranch      = false;
+            bool        isCall        = false;
+            bool        isFallthrough = true;
+            int         rc            = VerifyUtil::e_Success;
+            switch (opcode) {
+              case Bytecode::e_Push: {
+                stack.push(kindOf(code.data(i)));
+              } break;
+              case Bytecode::e_AddDoubles: {
+                if (0 != stack.pop(&rhs) || 0 != stack.pop(&lhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (!isDouble(lhs) || !isDouble(rhs)) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+                else {
+                    stack.push(e_Double);
+                }
+              } break;
+              case Bytecode::e_PushAddDoubles: {
+                if (0 != stack.pop(&lhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (!isDouble(lhs)
+                      || e_Double != kindOf(code.data(i))) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+                else {
+                    stack.push(e_Double);
+                }
+              } break;
+              case Bytecode::e_Pop: {
+                if (0 != stack.pop(&rhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+              } break;
+              case Bytecode::e_GetGlobalSlot: {
+                if (!isSlot(code.data(i))) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                else {
+                    stack.push(e_Unknown);
+                }
+              } break;
+              case Bytecode::e_SetGlobalSlot: {
+                if (!isSlot(code.data(i))) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                else if (0 != stack.pop(&rhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (e_Object == rhs) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+              } break;
+              case Bytecode::e_NewObject: {
+                stack.push(e_Object);
+              } break;
+              case Bytecode::e_GetProperty: {
+                if (!DatumUtil::isPropertyCache(code.data(i))) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                else if (0 != stack.pop(&lhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (!isObject(lhs)) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+                else {
+                    stack.push(e_Unknown);
+                }
+              } break;
+              case Bytecode::e_SetProperty: {
+                if (!DatumUtil::isPropertyCache(code.data(i))) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                else if (0 != stack.pop(&rhs) || 0 != stack.pop(&lhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (!isObject(lhs)) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+                else {
+                    stack.push(e_Object);
+                }
+              } break;
+              case Bytecode::e_AddIntegers:
+              case Bytecode::e_SubtractIntegers:
+              case Bytecode::e_MultiplyIntegers:
+              case Bytecode::e_LessIntegers: {
+                if (!DatumUtil::isTypeFeedback(code.data(i))) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                else if (0 != stack.pop(&rhs) || 0 != stack.pop(&lhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (!isNumber(lhs) || !isNumber(rhs)) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+                else {
+                    stack.push(Bytecode::e_LessIntegers == opcode
+                               ? e_Boolean
+                               : e_Number);
+                }
+              } break;
+              case Bytecode::e_AddArrays:
+              case Bytecode::e_MultiplyArrays:
+              case Bytecode::e_DotArrays: {
+                if (0 != stack.pop(&rhs) || 0 != stack.pop(&lhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (!isArray(lhs) || !isArray(rhs)) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+                else {
+                    stack.push(Bytecode::e_DotArrays == opcode
+                               ? e_Double
+                               : e_Array);
+                }
+              } break;
+              case Bytecode::e_MultiplyAddArrays: {
+                Kind addend;
+                if (0 != stack.pop(&addend)
+                 || 0 != stack.pop(&rhs)
+                 || 0 != stack.pop(&lhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (!isArray(lhs) || !isArray(rhs) || !isArray(addend)) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+                else {
+                    stack.push(e_Array);
+                }
+              } break;
+              case Bytecode::e_SumArray: {
+                if (0 != stack.pop(&rhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (!isArray(rhs)) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+                else {
+                    stack.push(e_Double);
+                }
+              } break;
+              case Bytecode::e_Execute: {
+                if (0 != stack.pop(&rhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (e_Unknown != rhs && e_Function != rhs) {
+                    rc = VerifyUtil::e_NotCallable;
+                }
+                else {
+                    stack.call();
+                }
+              } break;
+              case Bytecode::e_Jump: {
+                if (0 != findTarget(&target, code, numCodes, i)) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                isBranch      = true;
+                isFallthrough = false;
+              } break;
+              case Bytecode::e_JumpIfFalse: {
+                if (0 != findTarget(&target, code, numCodes, i)) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                else if (0 != stack.pop(&rhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (!isBoolean(rhs)) {
+                    rc = VerifyUtil::e_TypeError;
+                }
+                isBranch = true;
+              } break;
+              case Bytecode::e_LoopHeader: {
+                if (!DatumUtil::isLoopCounter(code.data(i))) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+              } break;
+              case Bytecode::e_Loop: {
+                if (0 != findTarget(&target, code, numCodes, i)) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                isBranch      = true;
+                isFallthrough = false;
+              } break;
+              case Bytecode::e_Function: {
+                if (!stack.isInFunction() || i != stack.function()) {
+                    rc = VerifyUtil::e_InvalidFrame;
+                }
+              } break;
+              case Bytecode::e_Call:
+              case Bytecode::e_TailCall: {
+                const bool isTail = Bytecode::e_TailCall == opcode;
+                if (0 != findTarget(&target, code, numCodes, i)) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                    break;
+                }
+                if (isTail && !stack.isInFunction()) {
+                    rc = VerifyUtil::e_InvalidFrame;
+                    break;
+                }
+                const int numArguments = code.data(target).theInteger();
+                for (int k = 0; k < numArguments; ++k) {
+                    if (0 != stack.pop(&rhs)) {
+                        rc = VerifyUtil::e_StackUnderflow;
+                        break;
+                    }
+                }
+                if (VerifyUtil::e_Success == rc) {
+                    entry.enterFunction(target, numArguments);
+                    isCall        = true;
+                    isFallthrough = !isTail;
+                    if (!isTail) {
+                        stack.push(e_Unknown);
+                    }
+                }
+              } break;
+              case Bytecode::e_GetLocal: {
+                if (!stack.isInFunction()) {
+                    rc = VerifyUtil::e_InvalidFrame;
+                }
+                else if (!code.data(i).isInteger()
+                      || 0 != stack.getLocal(&rhs,
+                                             code.data(i).theInteger())) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                else {
+                    stack.push(rhs);
+                }
+              } break;
+              case Bytecode::e_SetLocal: {
+                if (!stack.isInFunction()) {
+                    rc = VerifyUtil::e_InvalidFrame;
+                }
+                else if (!code.data(i).isInteger()) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+                else if (0 != stack.pop(&rhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                else if (0 != stack.setLocal(code.data(i).theInteger(),
+                                             rhs)) {
+                    rc = VerifyUtil::e_InvalidOperand;
+                }
+              } break;
+              case Bytecode::e_Return: {
+                if (0 != stack.pop(&rhs)) {
+                    rc = VerifyUtil::e_StackUnderflow;
+                }
+                isFallthrough = false;
+              } break;
+              default: {
+                rc = VerifyUtil::e_InvalidOpcode;
+              }
+            }
+            if (VerifyUtil::e_Success != rc) {
+                *errorIndex = i;
+                return rc;                                            // RETURN
+            }
+            depth = bsl::max(depth, stack.depth());
+
+            if (isBranch || isCall) {
+                const AbstractStack& targetStack = isCall ? entry : stack;
+                if (0 != claim(&owners, target, targetStack)) {
+                    *errorIndex = i;
+                    return VerifyUtil::e_InvalidFrame;                // RETURN
+                }
+                if (0 != worklist.enter(target, targetStack)) {
+                    *errorIndex = i;
+                    return VerifyUtil::e_StackMismatch;               // RETURN
+                }
+            }
+            if (!isFallthrough) {
+                break;
+            }
+            if (numCodes == ++i) {
+                *errorIndex = numCodes;
+                return VerifyUtil::e_MissingReturn;                   // RETURN
+            }
+            if (isTarget[i]) {
+                if (0 != claim(&owners, i, stack)) {
+                    *errorIndex = i - 1;
+                    return VerifyUtil::e_InvalidFrame;                // RETURN
+                }
+                if (0 != worklist.enter(i, stack)) {
+                    *errorIndex = i - 1;
+                    return VerifyUtil::e_StackMismatch;               // RETURN
+                }
+                break;
+            }
+        }
+    }
+    *maxDepth = depth;
+    return VerifyUtil::e_Success;
+}
+
+}  // close unnamed namespace
+
+                             // -----------------
+                             // struct VerifyUtil
+                             // -----------------
+
+// CLASS METHODS
+int VerifyUtil::verify(bsl::size_t    *maxDepth,
+                       bsl::size_t    *errorIndex,
+                       const Bytecode *code,
+                       bsl::size_t     numCodes)
+{
+    BSLS_ASSERT(0 != maxDepth);
+    BSLS_ASSERT(0 != errorIndex);
+    BSLS_ASSERT(0 != code || 0 == numCodes);
+
+    return verifyImp(maxDepth, errorIndex, BytecodeAccessor(code), numCodes);
+}
+
+int VerifyUtil::verify(bsl::size_t    *maxDepth,
+                       bsl::size_t    *errorIndex,
+                       const Program&  program)
+{
+    BSLS_ASSERT(0 != maxDepth);
+    BSLS_ASSERT(0 != errorIndex);
+
+    return verifyImp(maxDepth,
+                     errorIndex,
+                     ProgramAccessor<Program>(&program),
+                     program.numInstructions());
+}
+
+int VerifyUtil::verify(bsl::size_t         *maxDepth,
+                       bsl::size_t         *errorIndex,
+                       const ProgramImage&  image)
+{
+    BSLS_ASSERT(0 != maxDepth);
+    BSLS_ASSERT(0 != errorIndex);
+
+    return verifyImp(maxDepth,
+                     errorIndex,
+                     ProgramAccessor<ProgramImage>(&image),
+                     image.numInstructions());
+}
+}
@@ -0,0 +1,129 @@
+// sjtu_verifyutil.h
+
+#ifndef INCLUDED_SJTU_VERIFYUTIL
+#define INCLUDED_SJTU_VERIFYUTIL
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+namespace sjtt { class Bytecode; }
+namespace sjtt { class Program; }
+namespace sjtt { class ProgramImage; }
+
+namespace sjtu {
+
+struct VerifyUtil {
+    // This class provides a namespace for functions that check Scramjet
+    // bytecode before it is executed.  Verification tracks the number of
+    // values on the stack, and what is known of their types, at each
+    // instruction, along every path through the program.  It rejects
+    // programs that provably underflow the stack, add a value that is not a
+    // double, apply an integer opcode to a value that is not a number, an
+    // array opcode to a value that is not an array, or a property opcode to
+    // a value that is not an object, assign an object to a global, apply
+    // 'e_Execute' to a value that is not a function, or 'e_JumpIfFalse' to a
+    // value that is not a boolean, branch outside the program, or can run
+    // past the last instruction, and computes the stack headroom the program
+    // needs, so that it can be run by the unchecked overloads of
+    // 'InterpretUtil::interpret'.
+    //
+    // The stack must have the same depth along every path reaching an
+    // instruction, e.g., each iteration of a loop must leave as many values
+    // as it found; what is known of the values is what the paths agree on.
+    // A forward branch ('e_Jump', 'e_JumpIfFalse') must have a positive
+    // offset, and an 'e_Loop' a negative one, to an 'e_LoopHeader' carrying
+    // an 'sjtt::LoopCounter'.  Instructions that no path reaches are not
+    // checked.
+    //
+    // An external function invoked by 'e_Execute' pops its arguments, which
+    // may be any of the values of the frame, and pushes one result, but must
+    // not pop any value below the frame.  Only the result of a call is
+    // therefore known to be on the stack after it: a program popping, or
+    // reading as a local, any value pushed before the call is rejected.  The
+    // depth tracked after a call is that of the stack if the function pops
+    // nothing, so the maximum depth reported is an upper bound of the number
+    // of values the program holds.
+    //
+    // Each script function, from its 'e_Function' on, is checked separately
+    // from the code calling it, starting with a frame holding its arguments
+    // (see 'InterpretUtil'), which it cannot pop, and every instruction must
+    // belong to only one function, or to none.  An 'e_Call' or 'e_TailCall'
+    // must target an 'e_Function' whose data is its number of arguments,
+    // pops that many values, and, for 'e_Call', pushes the result of the
+    // call; 'e_TailCall', 'e_GetLocal' and 'e_SetLocal' may be used only in
+    // a function, and the slots of the latter two must hold a value of the
+    // frame.  Since calls may nest without bound, the maximum depth reported
+    // for a program with functions is that of its deepest frame, including
+    // the arguments and linkage of the frame of a function, for which the
+    // interpreter reserves room on each call.
+
+    // TYPES
+    enum Status {
+        // Enumeration used to describe the result of verification.
+
+        e_Success = 0,
+            // the program can be interpreted unchecked
+
+        e_StackUnderflow,
+            // an instruction pops more values than have been pushed
+
+        e_TypeError,
+            // 'e_AddDoubles' or 'e_PushAddDoubles' is applied to a value that
+            // is not a double, an integer opcode to a value that is not a
+            // number, an array opcode to a value that is not an array, a
+            // property opcode to a value that is not an object,
+            // 'e_SetGlobalSlot' to an object, or 'e_JumpIfFalse' to a value
+            // that is not a boolean
+
+        e_NotCallable,
+            // 'e_Execute' is applied to a value that is not a function
+
+        e_MissingReturn,
+            // execution can run past the last instruction (the index is the
+            // number of instructions)
+
+        e_InvalidOpcode,
+            // an instruction has an opcode value outside 'Bytecode::Opcode'
+
+        e_InvalidOperand,
+            // the data of an instruction is not valid for its opcode, the
+            // operand of a packed instruction is not an index into the
+            // constant pool, a branch does not target an instruction of the
+            // program in its direction, a call does not target an
+            // 'e_Function', or a slot is not in the frame
+
+        e_StackMismatch,
+            // paths reaching an instruction leave stacks of different depths
+            // (the index is that of the instruction jumping or falling
+            // through to it)
+
+        e_InvalidFrame
+            // an instruction is reached from more than one function, or from
+            // a function and the code outside of any, an 'e_Function' is
+            // reached other than by a call, or an opcode using the frame of a
+            // function is used outside of any
+    };
+
+    // CLASS METHODS
+    static int verify(bsl::size_t          *maxDepth,
+                      bsl::size_t          *errorIndex,
+                      const sjtt::Bytecode *code,
+                      bsl::size_t           numCodes);
+    static int verify(bsl::size_t          *maxDepth,
+                      bsl::size_t          *errorIndex,
+                      const sjtt::Program&  program);
+    static int verify(bsl::size_t               *maxDepth,
+                      bsl::size_t               *errorIndex,
+                      const sjtt::ProgramImage&  image);
+        // Verify the program consisting of the specified 'numCodes'
+        // instructions beginning at the specified 'code', the specified
+        // packed 'program', or the program held by the specified loaded
+        // 'image'.  On success, load into the specified 'maxDepth'
+        // the maximum stack depth of the program and return 'e_Success';
+        // otherwise, load into the specified 'errorIndex' the index of the
+        // offending instruction and return a non-zero 'Status' value.
+};
+}
+
+#endif
@@ -0,0 +1,592 @@
+// sjtu_verifyutil.t.cpp                                   -*-C++-*-
+
+#include <sjtu_verifyutil.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_loopcounter.h>
+#include <sjtt_program.h>
+#include <sjtt_programimage.h>
+#include <sjtt_propertycache.h>
+#include <sjtt_typefeedback.h>
+#include <sjtu_datumutil.h>
+
+#include <bdls_testutil.h>
+#include <bslma_testallocator.h>
+
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+typedef sjtt::Bytecode Bytecode;
+
+namespace {
+
+void identity(sjtt::ExecutionContext *)
+    // Leave the argument on the stack as the result.
+{
+}
+
+Bytecode push(double value)
+    // Return an 'e_Push' of the specified 'value'.
+{
+    return Bytecode::createPush(bdld::Datum::createDouble(value));
+}
+
+Bytecode op(Bytecode::Opcode opcode)
+    // Return a 'Bytecode' having the specified 'opcode'.
+{
+    return Bytecode::createOpcode(opcode);
+}
+
+Bytecode branch(Bytecode::Opcode opcode, int offset)
+    // Return a branch having the specified 'opcode' and 'offset'.
+{
+    return Bytecode::create(opcode, bdld::Datum::createInteger(offset));
+}
+
+Bytecode local(Bytecode::Opcode opcode, int slot)
+    // Return an instruction having the specified 'opcode' and 'slot'.
+{
+    return Bytecode::create(opcode, bdld::Datum::createInteger(slot));
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+    const bool veryVerbose = argc > 3;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    const Bytecode ADD    = op(Bytecode::e_AddDoubles);
+    const Bytecode EXEC   = op(Bytecode::e_Execute);
+    const Bytecode RET    = op(Bytecode::e_Return);
+    const Bytecode FN     = Bytecode::createPush(
+                                 DatumUtil::createExternalFunction(&identity));
+    const Bytecode UNDEF  = Bytecode::createPush(DatumUtil::s_Undefined);
+    const Bytecode POP    = op(Bytecode::e_Pop);
+    const Bytecode PADD   = Bytecode::create(Bytecode::e_PushAddDoubles,
+                                             bdld::Datum::createDouble(1));
+    const Bytecode BADPADD = Bytecode::create(Bytecode::e_PushAddDoubles,
+                                              bdld::Datum::createInteger(1));
+    const Bytecode GET    = Bytecode::create(Bytecode::e_GetGlobalSlot,
+                                             bdld::Datum::createInteger(0));
+    const Bytecode SET    = Bytecode::create(Bytecode::e_SetGlobalSlot,
+                                             bdld::Datum::createInteger(0));
+    const Bytecode BADGET = Bytecode::create(Bytecode::e_GetGlobalSlot,
+                                             bdld::Datum::createDouble(0));
+    const Bytecode BADSET = Bytecode::create(Bytecode::e_SetGlobalSlot,
+                                             bdld::Datum::createInteger(-1));
+    const Bytecode ADDA   = op(Bytecode::e_AddArrays);
+    const Bytecode MULA   = op(Bytecode::e_MultiplyArrays);
+    const Bytecode FMAA   = op(Bytecode::e_MultiplyAddArrays);
+    const Bytecode SUMA   = op(Bytecode::e_SumArray);
+    const Bytecode DOTA   = op(Bytecode::e_DotArrays);
+
+    sjtt::PropertyCache cache("x");
+    const Bytecode NEW    = op(Bytecode::e_NewObject);
+    const Bytecode GETP   = Bytecode::create(
+                                      Bytecode::e_GetProperty,
+                                      DatumUtil::createPropertyCache(&cache));
+    const Bytecode SETP   = Bytecode::create(
+                                      Bytecode::e_SetProperty,
+                                      DatumUtil::createPropertyCache(&cache));
+    const Bytecode BADGETP = Bytecode::create(Bytecode::e_GetProperty,
+                                              bdld::Datum::createInteger(0));
+
+    sjtt::TypeFeedback feedback;
+    const Bytecode INT    = Bytecode::createPush(
+                                              bdld::Datum::createInteger(1));
+    const Bytecode IADD   = Bytecode::create(
+                                   Bytecode::e_AddIntegers,
+                                   DatumUtil::createTypeFeedback(&feedback));
+    const Bytecode IMUL   = Bytecode::create(
+                                   Bytecode::e_MultiplyIntegers,
+                                   DatumUtil::createTypeFeedback(&feedback));
+    const Bytecode ILESS  = Bytecode::create(
+                                   Bytecode::e_LessIntegers,
+                                   DatumUtil::createTypeFeedback(&feedback));
+    const Bytecode BADIADD = Bytecode::create(Bytecode::e_AddIntegers,
+                                              bdld::Datum::createInteger(0));
+
+    switch (test) { case 0:
+      case 5: {
+        if (verbose) cout << endl
+                          << "functions" << endl
+                          << "=========" << endl;
+
+        const Bytecode F0    = local(Bytecode::e_Function, 0);
+        const Bytecode F1    = local(Bytecode::e_Function, 1);
+        const Bytecode ARG   = local(Bytecode::e_GetLocal, -1);
+        const Bytecode GETL  = local(Bytecode::e_GetLocal, 0);
+        const Bytecode SETL  = local(Bytecode::e_SetLocal, 0);
+        const Bytecode CALL1 = branch(Bytecode::e_Call, 1);
+        const Bytecode CALL2 = branch(Bytecode::e_Call, 2);
+        const Bytecode ISUB  = Bytecode::create(
+                                   Bytecode::e_SubtractIntegers,
+                                   DatumUtil::createTypeFeedback(&feedback));
+
+        const struct {
+            int            d_line;
+            Bytecode       d_code[16];
+            bsl::size_t    d_numCodes;
+            int            d_status;
+            bsl::size_t    d_index;     // error index, or maximum depth
+        } DATA[] = {
+            // The depth of a frame counts its argument and linkage.
+
+            { L_, { INT, CALL2, RET, F1, ARG, RET },
+                                             6, VerifyUtil::e_Success,    5 },
+            { L_, { CALL1, F0, INT, RET },
+                                             4, VerifyUtil::e_InvalidFrame,
+                                                                          0 },
+            { L_, { CALL2, RET, F0, INT, INT, SETL, GETL, RET },
+                                             8, VerifyUtil::e_Success,    5 },
+
+            // 'f(n) { if (n < 1) { return 1; } return f(n - 1); }'
+
+            { L_, { INT, CALL2, RET, F1, ARG, INT, ILESS,
+                    branch(Bytecode::e_JumpIfFalse, 3), INT, RET,
+                    ARG, INT, ISUB, branch(Bytecode::e_Call, -10), RET },
+                                            15, VerifyUtil::e_Success,    6 },
+
+            // The same function, calling itself in tail position.
+
+            { L_, { INT, CALL2, RET, F1, ARG, INT, ILESS,
+                    branch(Bytecode::e_JumpIfFalse, 3), INT, RET,
+                    ARG, INT, ISUB, branch(Bytecode::e_TailCall, -10) },
+                                            14, VerifyUtil::e_Success,    6 },
+
+            { L_, { INT, CALL2, RET, INT, RET },
+                                             5, VerifyUtil::e_InvalidOperand,
+                                                                          1 },
+            { L_, { INT, branch(Bytecode::e_Call, 0), RET },
+                                             3, VerifyUtil::e_InvalidOperand,
+                                                                          1 },
+            { L_, { INT, CALL2, RET, local(Bytecode::e_Function, -1), RET },
+                                             5, VerifyUtil::e_InvalidOperand,
+                                                                          1 },
+            { L_, { CALL2, RET, F1, ARG, RET },
+                                             5, VerifyUtil::e_StackUnderflow,
+                                                                          0 },
+            { L_, { INT, CALL2, RET, F1, POP, INT, RET },
+                                             7, VerifyUtil::e_StackUnderflow,
+                                                                          4 },
+            { L_, { INT, CALL2, RET, F1, local(Bytecode::e_GetLocal, -2),
+                    RET },                   6, VerifyUtil::e_InvalidOperand,
+                                                                          4 },
+            { L_, { CALL2, RET, F0, INT, SETL, INT, RET },
+                                             7, VerifyUtil::e_InvalidOperand,
+                                                                          4 },
+            { L_, { INT, GETL, RET },        3, VerifyUtil::e_InvalidFrame,
+                                                                          1 },
+            { L_, { INT, SETL, INT, RET },   4, VerifyUtil::e_InvalidFrame,
+                                                                          1 },
+            { L_, { branch(Bytecode::e_TailCall, 1), F0, INT, RET },
+                                             4, VerifyUtil::e_InvalidFrame,
+                                                                          0 },
+
+            // The code outside of any function jumps into one.
+
+            { L_, { INT, branch(Bytecode::e_Call, 3),
+                    branch(Bytecode::e_Jump, 3), RET, F1, ARG, RET },
+                                             7, VerifyUtil::e_InvalidFrame,
+                                                                          4 },
+            { L_, { F0, INT, RET },          3, VerifyUtil::e_InvalidFrame,
+                                                                          0 },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        for (int ti = 0; ti < NUM_DATA; ++ti) {
+            const int LINE = DATA[ti].d_line;
+            bsl::size_t maxDepth   = 0;
+            bsl::size_t errorIndex = 0;
+            const int   rc = VerifyUtil::verify(&maxDepth,
+                                                &errorIndex,
+                                                DATA[ti].d_code,
+                                                DATA[ti].d_numCodes);
+            ASSERTV(LINE, rc, DATA[ti].d_status == rc);
+            if (VerifyUtil::e_Success != rc) {
+                ASSERTV(LINE, errorIndex, DATA[ti].d_index == errorIndex);
+            }
+            else {
+                ASSERTV(LINE, maxDepth, DATA[ti].d_index == maxDepth);
+            }
+        }
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "branches" << endl
+                          << "========" << endl;
+
+        sjtt::LoopCounter counter;
+        const Bytecode    HEAD    = Bytecode::create(
+                                      Bytecode::e_LoopHeader,
+                                      DatumUtil::createLoopCounter(&counter));
+        const Bytecode    BADHEAD = Bytecode::create(
+                                              Bytecode::e_LoopHeader,
+                                              bdld::Datum::createInteger(0));
+        const Bytecode    TRUE    = Bytecode::createPush(
+                                             bdld::Datum::createBoolean(true));
+        const Bytecode    J2      = branch(Bytecode::e_Jump, 2);
+        const Bytecode    JF2     = branch(Bytecode::e_JumpIfFalse, 2);
+        const Bytecode    JF3     = branch(Bytecode::e_JumpIfFalse, 3);
+        const Bytecode    LOOP1   = branch(Bytecode::e_Loop, -1);
+        const Bytecode    LOOP2   = branch(Bytecode::e_Loop, -2);
+
+        const struct {
+            int            d_line;
+            Bytecode       d_code[12];
+            bsl::size_t    d_numCodes;
+            int            d_status;
+            bsl::size_t    d_index;     // error index, or maximum depth
+        } DATA[] = {
+            // The kinds of the paths joining at 'RET' differ.
+
+            { L_, { TRUE, JF3, INT, J2, push(1), RET },
+                                             6, VerifyUtil::e_Success,    1 },
+
+            // 'i = 0; while (i < 1) { i = i + 1; } return i;'
+
+            { L_, { HEAD, GET, INT, ILESS,
+                    branch(Bytecode::e_JumpIfFalse, 6),
+                    GET, INT, IADD, SET,
+                    branch(Bytecode::e_Loop, -9),
+                    GET, RET },             12, VerifyUtil::e_Success,    2 },
+            { L_, { HEAD, LOOP1 },           2, VerifyUtil::e_Success,    0 },
+            { L_, { HEAD, FN, EXEC, POP, branch(Bytecode::e_Loop, -4) },
+                                             5, VerifyUtil::e_Success,    1 },
+            { L_, { INT, J2, op(static_cast<Bytecode::Opcode>(
+                                           Bytecode::k_NUM_OPCODES)), RET },
+                                             4, VerifyUtil::e_Success,    1 },
+
+            { L_, { INT, JF2, INT, RET },    4, VerifyUtil::e_TypeError,  1 },
+            { L_, { JF2, INT, RET },         3, VerifyUtil::e_StackUnderflow,
+                                                                          0 },
+            { L_, { TRUE, JF2, INT, INT, RET },
+                                             5, VerifyUtil::e_StackMismatch,
+                                                                          2 },
+            { L_, { HEAD, INT, LOOP2 },      3, VerifyUtil::e_StackMismatch,
+                                                                          2 },
+            { L_, { TRUE, JF3, INT, RET, INT },
+                                             5, VerifyUtil::e_MissingReturn,
+                                                                          5 },
+            { L_, { branch(Bytecode::e_Jump, 5), RET },
+                                             2, VerifyUtil::e_InvalidOperand,
+                                                                          0 },
+            { L_, { INT, branch(Bytecode::e_Jump, -1), RET },
+                                             3, VerifyUtil::e_InvalidOperand,
+                                                                          1 },
+            { L_, { INT, LOOP1, RET },       3, VerifyUtil::e_InvalidOperand,
+                                                                          1 },
+            { L_, { HEAD, branch(Bytecode::e_Loop, 1), RET },
+                                             3, VerifyUtil::e_InvalidOperand,
+                                                                          1 },
+            { L_, { INT, Bytecode::create(Bytecode::e_Jump, DatumUtil::s_Null),
+                    RET },                   3, VerifyUtil::e_InvalidOperand,
+                                                                          1 },
+            { L_, { BADHEAD, INT, RET },     3, VerifyUtil::e_InvalidOperand,
+                                                                          0 },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        for (int ti = 0; ti < NUM_DATA; ++ti) {
+            const int LINE = DATA[ti].d_line;
+            bsl::size_t maxDepth   = 0;
+            bsl::size_t errorIndex = 0;
+            const int   rc = VerifyUtil::verify(&maxDepth,
+                                                &errorIndex,
+                                                DATA[ti].d_code,
+                                                DATA[ti].d_numCodes);
+            ASSERTV(LINE, rc, DATA[ti].d_status == rc);
+            if (VerifyUtil::e_Success != rc) {
+                ASSERTV(LINE, errorIndex, DATA[ti].d_index == errorIndex);
+            }
+            else {
+                ASSERTV(LINE, maxDepth, DATA[ti].d_index == maxDepth);
+            }
+        }
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "packed programs" << endl
+                          << "===============" << endl;
+
+        bslma::TestAllocator ta(veryVerbose);
+        const Bytecode good[] = { push(1), push(2), push(3), ADD, ADD, RET };
+        const Bytecode bad[]  = { push(1), UNDEF, ADD, RET };
+
+        sjtt::ProgramBuilder builder(&ta);
+        sjtt::Program        program(&ta);
+        bsl::size_t          maxDepth   = 0;
+        bsl::size_t          errorIndex = 0;
+
+        ASSERT(0 == builder.append(good, sizeof good / sizeof *good));
+        builder.build(&program);
+        ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, program));
+        ASSERT(3 == maxDepth);
+
+        ASSERT(0 == builder.append(bad, sizeof bad / sizeof *bad));
+        builder.build(&program);
+        ASSERT(VerifyUtil::e_TypeError ==
+                       VerifyUtil::verify(&maxDepth, &errorIndex, program));
+        ASSERT(2 == errorIndex);
+
+        // Images are verified like the programs they hold.
+
+        bsl::vector<char>  buffer(&ta);
+        sjtt::ProgramImage image(&ta);
+        ASSERT(0 == builder.append(good, sizeof good / sizeof *good));
+        builder.build(&program);
+        ASSERT(0 == sjtt::ProgramImage::encode(&buffer, program));
+        ASSERT(0 == image.load(buffer.data(), buffer.size()));
+        maxDepth = 0;
+        ASSERT(0 == VerifyUtil::verify(&maxDepth, &errorIndex, image));
+        ASSERT(3 == maxDepth);
+
+        const Bytecode TRUE = Bytecode::createPush(
+                                             bdld::Datum::createBoolean(true));
+        const Bytecode boolean[] = { push(1), TRUE, ADD, RET };
+        ASSERT(0 == builder.append(boolean, sizeof boolean / sizeof *boolean));
+        builder.build(&program);
+        ASSERT(0 == sjtt::ProgramImage::encode(&buffer, program));
+        ASSERT(0 == image.load(buffer.data(), buffer.size()));
+        errorIndex = 0;
+        ASSERT(VerifyUtil::e_TypeError ==
+                         VerifyUtil::verify(&maxDepth, &errorIndex, image));
+        ASSERT(2 == errorIndex);
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "maximum depth" << endl
+                          << "=============" << endl;
+
+        const struct {
+            int            d_line;
+            Bytecode       d_code[8];
+            bsl::size_t    d_numCodes;
+            bsl::size_t    d_maxDepth;
+        } DATA[] = {
+            { L_, { push(1), RET },                               2, 1 },
+            { L_, { push(1), push(2), ADD, RET },                 4, 2 },
+            { L_, { push(1), push(2), ADD, push(3), ADD, RET },   6, 2 },
+            { L_, { push(1), push(2), push(3), ADD, ADD, RET },   6, 3 },
+            { L_, { push(1), push(2), FN, EXEC, PADD, RET },      6, 3 },
+            { L_, { push(1), FN, EXEC, push(2), push(3), RET },   6, 4 },
+            { L_, { FN, EXEC, RET },                              3, 1 },
+            { L_, { push(1), PADD, PADD, RET },                   4, 1 },
+            { L_, { push(1), push(2), POP, push(3), RET },        5, 2 },
+            { L_, { GET, GET, ADD, SET, GET, RET },               6, 2 },
+            { L_, { GET, GET, ADDA, GET, MULA, RET },             6, 2 },
+            { L_, { GET, GET, GET, FMAA, SUMA, RET },             6, 3 },
+            { L_, { GET, GET, DOTA, push(1), ADD, RET },          6, 2 },
+            { L_, { NEW, push(1), SETP, GETP, RET },              5, 2 },
+            { L_, { NEW, NEW, push(1), SETP, SETP, GETP, RET },   7, 3 },
+            { L_, { INT, INT, IADD, push(1), IMUL, RET },         6, 2 },
+            { L_, { INT, INT, INT, IADD, ILESS, RET },            6, 3 },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        for (int ti = 0; ti < NUM_DATA; ++ti) {
+            const int LINE = DATA[ti].d_line;
+            bsl::size_t maxDepth   = 0;
+            bsl::size_t errorIndex = 0;
+            ASSERTV(LINE, 0 == VerifyUtil::verify(&maxDepth,
+                                                  &errorIndex,
+                                                  DATA[ti].d_code,
+                                                  DATA[ti].d_numCodes));
+            ASSERTV(LINE, maxDepth, DATA[ti].d_maxDepth == maxDepth);
+        }
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "rejection" << endl
+                          << "=========" << endl;
+
+        const struct {
+            int            d_line;
+            Bytecode       d_code[9];
+            bsl::size_t    d_numCodes;
+            int            d_status;
+            bsl::size_t    d_errorIndex;
+        } DATA[] = {
+            { L_, { RET },                   1, VerifyUtil::e_StackUnderflow,
+                                                                          0 },
+            { L_, { push(1), ADD, RET },     3, VerifyUtil::e_StackUnderflow,
+                                                                          1 },
+            { L_, { EXEC, RET },             2, VerifyUtil::e_StackUnderflow,
+                                                                          0 },
+            { L_, { push(1), UNDEF, ADD, RET },
+                                             4, VerifyUtil::e_TypeError,  2 },
+            { L_, { FN, push(1), ADD, RET }, 4, VerifyUtil::e_TypeError,  2 },
+            { L_, { push(1), EXEC, RET },    3, VerifyUtil::e_NotCallable,
+                                                                          1 },
+            { L_, { UNDEF, EXEC, RET },      3, VerifyUtil::e_NotCallable,
+                                                                          1 },
+            { L_, { POP, RET },              2, VerifyUtil::e_StackUnderflow,
+                                                                          0 },
+            { L_, { PADD, RET },             2, VerifyUtil::e_StackUnderflow,
+                                                                          0 },
+            { L_, { UNDEF, PADD, RET },      3, VerifyUtil::e_TypeError,  1 },
+            { L_, { push(1), BADPADD, RET }, 3, VerifyUtil::e_TypeError,  1 },
+            { L_, { push(1), push(2), POP, PADD, RET },
+                                             5, VerifyUtil::e_Success,    0 },
+            { L_, { push(1) },               1, VerifyUtil::e_MissingReturn,
+                                                                          1 },
+            { L_, { push(1), push(2), ADD }, 3, VerifyUtil::e_MissingReturn,
+                                                                          3 },
+            { L_, { SET, RET },              2, VerifyUtil::e_StackUnderflow,
+                                                                          0 },
+            { L_, { BADGET, RET },           2, VerifyUtil::e_InvalidOperand,
+                                                                          0 },
+            { L_, { push(1), BADSET, GET, RET },
+                                             4, VerifyUtil::e_InvalidOperand,
+                                                                          1 },
+            { L_, { GET, push(1), ADDA, RET },
+                                             4, VerifyUtil::e_TypeError,  2 },
+            { L_, { push(1), SUMA, RET },    3, VerifyUtil::e_TypeError,  1 },
+            { L_, { GET, SUMA, push(1), DOTA, RET },
+                                             5, VerifyUtil::e_TypeError,  3 },
+            { L_, { GET, GET, FMAA, RET },   4, VerifyUtil::e_StackUnderflow,
+                                                                          2 },
+            { L_, { GET, GET, MULA, MULA, RET },
+                                             5, VerifyUtil::e_StackUnderflow,
+                                                                          3 },
+            { L_, { GETP, RET },             2, VerifyUtil::e_StackUnderflow,
+                                                                          0 },
+            { L_, { NEW, SETP, RET },        3, VerifyUtil::e_StackUnderflow,
+                                                                          1 },
+            { L_, { push(1), GETP, RET },    3, VerifyUtil::e_TypeError,  1 },
+            { L_, { push(1), push(2), SETP, RET },
+                                             4, VerifyUtil::e_TypeError,  2 },
+            { L_, { NEW, BADGETP, RET },     3, VerifyUtil::e_InvalidOperand,
+                                                                          1 },
+            { L_, { NEW, SET, GET, RET },    4, VerifyUtil::e_TypeError,  1 },
+            { L_, { GET, GETP, SET, GET, RET },
+                                             5, VerifyUtil::e_Success,    0 },
+            { L_, { INT, IADD, RET },        3, VerifyUtil::e_StackUnderflow,
+                                                                          1 },
+            { L_, { INT, INT, BADIADD, RET },
+                                             4, VerifyUtil::e_InvalidOperand,
+                                                                          2 },
+            { L_, { INT, UNDEF, IADD, RET }, 4, VerifyUtil::e_TypeError,  2 },
+            { L_, { NEW, INT, ILESS, RET },  4, VerifyUtil::e_TypeError,  2 },
+            { L_, { INT, INT, ILESS, INT, IADD, RET },
+                                             6, VerifyUtil::e_TypeError,  4 },
+            { L_, { INT, push(1), ADD, RET },
+                                             4, VerifyUtil::e_TypeError,  2 },
+            { L_, { INT, INT, IADD, push(1), ADD, RET },
+                                             6, VerifyUtil::e_Success,    0 },
+
+            // A call may pop any of the values below it, so only its result
+            // may be popped afterwards.
+
+            { L_, { FN, EXEC, ADD, ADD, RET },
+                                             5, VerifyUtil::e_StackUnderflow,
+                                                                          2 },
+            { L_, { push(1), push(2), FN, EXEC, ADD, RET },
+                                             6, VerifyUtil::e_StackUnderflow,
+                                                                          4 },
+            { L_, { push(1), FN, EXEC, POP, POP, POP, POP, POP, RET },
+                                             9, VerifyUtil::e_StackUnderflow,
+                                                                          4 },
+            { L_, { push(1), FN, EXEC, GET, ADD, RET },
+                                             6, VerifyUtil::e_Success,    0 },
+            { L_, { FN, EXEC, FN, EXEC, RET },
+                                             5, VerifyUtil::e_Success,    0 },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        for (int ti = 0; ti < NUM_DATA; ++ti) {
+            const int LINE = DATA[ti].d_line;
+            bsl::size_t maxDepth   = 0;
+            bsl::size_t errorIndex = 0;
+            const int   rc = VerifyUtil::verify(&maxDepth,
+                                                &errorIndex,
+                                                DATA[ti].d_code,
+                                                DATA[ti].d_numCodes);
+            ASSERTV(LINE, rc, DATA[ti].d_status == rc);
+            if (VerifyUtil::e_Success != rc) {
+                ASSERTV(LINE, errorIndex,
+                        DATA[ti].d_errorIndex == errorIndex);
+            }
+        }
+
+        // Opcode values outside the enumeration are rejected.
+
+        bsl::size_t maxDepth   = 0;
+        bsl::size_t errorIndex = 0;
+        const Bytecode invalid[] = {
+            push(1), op(static_cast<Bytecode::Opcode>(Bytecode::k_NUM_OPCODES))
+        };
+        ASSERT(VerifyUtil::e_InvalidOpcode ==
+                     VerifyUtil::verify(&maxDepth, &errorIndex, invalid, 2));
+        ASSERT(1 == errorIndex);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}